@@ -60,6 +60,11 @@ typedef pthread_mutex_t wthread_static_mutex_t;
 #define wthread_static_mutex_lock(x)    pthread_mutex_lock((x))
 #define wthread_static_mutex_unlock(x)  pthread_mutex_unlock((x))
 
+/* One time initialisation */
+typedef pthread_once_t wthread_once_t;
+#define WTHREAD_ONCE_INIT               PTHREAD_ONCE_INIT
+#define wthread_once(x, init)           pthread_once((x), (init))
+
 /* Type for handle to dynamically loaded library */
 typedef void*       LIB_HANDLE;
 
@@ -189,6 +194,18 @@ struct wtimespec
 const char* getIpAddress (void);
 const char* getHostName (void);
 
+/* Thread placement. Both return 0 on success, CPU affinity is not
+ * supported on Darwin. */
+#define WTHREAD_SCHED_OTHER 0
+#define WTHREAD_SCHED_FIFO  1
+#define WTHREAD_SCHED_RR    2
+
+int wthread_set_cpu_affinity (wthread_t           thread,
+                              const unsigned int* cpus,
+                              unsigned int        count);
+
+int wthread_set_scheduler (wthread_t thread, int policy, int priority);
+
 #if defined (__cplusplus)
 } /* extern "c" */
 #endif
@@ -19,7 +19,13 @@
  * 02110-1301 USA
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
 #include "wombat/port.h"
+#include <errno.h>
+#include <sched.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -83,3 +89,54 @@ char* getLibError (void)
 {
     return dlerror();
 }
+
+/**
+ * Functions relating to thread placement
+ */
+int wthread_set_cpu_affinity (wthread_t           thread,
+                              const unsigned int* cpus,
+                              unsigned int        count)
+{
+#if defined (__APPLE__)
+    /* Darwin only offers affinity hints through thread_policy_set */
+    return ENOTSUP;
+#else
+    cpu_set_t    set;
+    unsigned int i = 0;
+
+    CPU_ZERO (&set);
+    for (i = 0; i < count; i++)
+    {
+        if (cpus[i] < CPU_SETSIZE)
+            CPU_SET (cpus[i], &set);
+    }
+
+    if (0 == CPU_COUNT (&set))
+        return EINVAL;
+
+    return pthread_setaffinity_np (thread, sizeof (set), &set);
+#endif
+}
+
+int wthread_set_scheduler (wthread_t thread, int policy, int priority)
+{
+    struct sched_param param;
+    int                sched = SCHED_OTHER;
+
+    if (WTHREAD_SCHED_FIFO == policy)
+        sched = SCHED_FIFO;
+    else if (WTHREAD_SCHED_RR == policy)
+        sched = SCHED_RR;
+
+    memset (&param, 0, sizeof (param));
+    if (SCHED_OTHER != sched)
+    {
+        if (priority < sched_get_priority_min (sched))
+            priority = sched_get_priority_min (sched);
+        if (priority > sched_get_priority_max (sched))
+            priority = sched_get_priority_max (sched);
+        param.sched_priority = priority;
+    }
+
+    return pthread_setschedparam (thread, sched, &param);
+}
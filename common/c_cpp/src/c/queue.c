@@ -42,6 +42,7 @@ typedef struct wombatQueueItem_
     wombatQueueCb              mCb;
     void*                      mData;
     void*                      mClosure;
+    uint64_t                   mEnqueueTime; /* 0 unless residency is on */
     struct wombatQueueItem_*   mNext;
     struct wombatQueueItem_*   mPrev;
     struct wombatQueueItem_*   mChunkNext;
@@ -64,8 +65,28 @@ typedef struct
     wombatQueueItem   mTail;
     wombatQueueItem   mFirstFree;
     wombatQueueItem*  mChunks;
+
+    /* Stamps items as they are enqueued, and the callback is given the
+     * residency of each item as it is dispatched */
+    wombatQueueClock        mResidencyClock;
+    wombatQueueResidencyCb  mResidencyCb;
+    void*                   mResidencyClosure;
 } wombatQueueImpl;
 
+/* Report the residency of an item which has been removed from the queue */
+#define WQ_RESIDENCY(impl, enqueueTime)                                     \
+    do                                                                      \
+    {                                                                       \
+        wombatQueueClock       clock_ = (impl)->mResidencyClock;            \
+        wombatQueueResidencyCb cb_    = (impl)->mResidencyCb;               \
+        if ((enqueueTime) && clock_ && cb_)                                 \
+        {                                                                   \
+            uint64_t now_ = clock_ ();                                      \
+            cb_ (now_ > (enqueueTime) ? now_ - (enqueueTime) : 0,           \
+                 (impl)->mResidencyClosure);                                \
+        }                                                                   \
+    } while (0)
+
 static void
 wombatQueueImpl_allocChunk ( wombatQueueImpl* impl, unsigned int items);
 
@@ -213,6 +234,8 @@ wombatQueue_enqueue (wombatQueue queue,
 {
     wombatQueueImpl* impl = (wombatQueueImpl*)queue;
     wombatQueueItem* item = NULL;
+    wombatQueueClock stamp = impl->mResidencyClock;
+    uint64_t         now   = stamp ? stamp () : 0;
 
     wthread_mutex_lock (&impl->mLock);
 
@@ -231,9 +254,10 @@ wombatQueue_enqueue (wombatQueue queue,
 
     impl->mFirstFree.mNext = item->mNext;
     /* Initialize the item. */
-    item->mCb      = cb;
-    item->mData    = data;
-    item->mClosure = closure;
+    item->mCb          = cb;
+    item->mData        = data;
+    item->mClosure     = closure;
+    item->mEnqueueTime = now;
 
     /* Put on queue (insert before dummy tail node */
     item->mNext              = &impl->mTail;
@@ -248,6 +272,23 @@ wombatQueue_enqueue (wombatQueue queue,
     return WOMBAT_QUEUE_OK;
 }
 
+wombatQueueStatus
+wombatQueue_setResidencyCb (wombatQueue            queue,
+                            wombatQueueClock       clock,
+                            wombatQueueResidencyCb cb,
+                            void*                  closure)
+{
+    wombatQueueImpl* impl = (wombatQueueImpl*)queue;
+
+    wthread_mutex_lock (&impl->mLock);
+    impl->mResidencyClosure = closure;
+    impl->mResidencyCb      = cb;
+    impl->mResidencyClock   = cb ? clock : NULL;
+    wthread_mutex_unlock (&impl->mLock);
+
+    return WOMBAT_QUEUE_OK;
+}
+
 wombatQueueStatus
 wombatQueue_getSize (wombatQueue queue, int* size)
 {
@@ -267,6 +308,7 @@ wombatQueue_dispatchInt (wombatQueue queue, void** data, void** closure,
     wombatQueueCb    cb       = NULL;
     void*            closure_ = NULL;
     void*            data_    = NULL;
+    uint64_t         enqueued = 0;
 
     if (isTimed)
     {
@@ -311,9 +353,12 @@ wombatQueue_dispatchInt (wombatQueue queue, void** data, void** closure,
     cb = head->mCb;
     closure_ = head->mClosure;
     data_    = head->mData;
+    enqueued = head->mEnqueueTime;
     
     wthread_mutex_unlock (&impl->mLock);
 
+    WQ_RESIDENCY (impl, enqueued);
+
     if (cb)
     {
         cb (data_, closure_);
@@ -344,6 +389,7 @@ wombatQueue_poll (wombatQueue queue, void** data, void** closure)
     wombatQueueCb    cb       = NULL;
     void*            closure_ = NULL;
     void*            data_    = NULL;
+    uint64_t         enqueued = 0;
 
     if (wsem_trywait (&impl->mSem) != 0)
     {
@@ -365,9 +411,12 @@ wombatQueue_poll (wombatQueue queue, void** data, void** closure)
     cb = head->mCb;
     closure_ = head->mClosure;
     data_    = head->mData;
+    enqueued = head->mEnqueueTime;
 
     wthread_mutex_unlock (&impl->mLock);
 
+    WQ_RESIDENCY (impl, enqueued);
+
     if (cb)
     {
         cb (data_, closure_);
@@ -598,9 +647,10 @@ wombatQueue_insertAfter (wombatQueue   queue,
 
     impl->mFirstFree.mNext = item->mNext;
     /* Initialize the item. */
-    item->mCb      = cb;
-    item->mData    = data;
-    item->mClosure = closure;
+    item->mCb          = cb;
+    item->mData        = data;
+    item->mClosure     = closure;
+    item->mEnqueueTime = 0;
 
     /* Put on queue */
     item->mNext                   = impl->mIterator->mNext;
@@ -645,9 +695,10 @@ wombatQueue_insertBefore (wombatQueue   queue,
 
     impl->mFirstFree.mNext = item->mNext;
     /* Initialize the item. */
-    item->mCb      = cb;
-    item->mData    = data;
-    item->mClosure = closure;
+    item->mCb          = cb;
+    item->mData        = data;
+    item->mClosure     = closure;
+    item->mEnqueueTime = 0;
 
     /* Put on queue */
     item->mNext                   = impl->mIterator;
@@ -47,6 +47,34 @@ int wthread_set_affinity_mask( wthread_t h,
                                         (DWORD_PTR) dwThreadAffinityMask );
 }
 
+int wthread_set_cpu_affinity( wthread_t h, 
+                              const unsigned int* cpus, 
+                              unsigned int count )
+{
+    DWORD_PTR    mask = 0;
+    unsigned int i    = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        if (cpus[i] < sizeof (DWORD_PTR) * 8)
+            mask |= ((DWORD_PTR) 1) << cpus[i];
+    }
+
+    if (0 == mask)
+        return 1;
+
+    return SetThreadAffinityMask( ((threadContext*) h)->mThread, mask ) ? 0 : 1;
+}
+
+int wthread_set_scheduler( wthread_t h, int policy, int priority )
+{
+    /* Windows has no real time policies, map them onto the highest priority */
+    int level = WTHREAD_SCHED_OTHER == policy ? THREAD_PRIORITY_NORMAL 
+                                              : THREAD_PRIORITY_TIME_CRITICAL;
+
+    return SetThreadPriority( ((threadContext*) h)->mThread, level ) ? 0 : 1;
+}
+
 
 int wthread_create( wthread_t *h, void *atts, void *(*startProc)( void * ), void *arg )
 {
@@ -95,6 +123,19 @@ int wthread_join (wthread_t t, void **value_ptr)
     return 0;
 }
 
+static BOOL CALLBACK
+wthread_onceCb (PINIT_ONCE once, PVOID init, PVOID* context)
+{
+    ((void (*)(void))init) ();
+    return TRUE;
+}
+
+int wthread_once (wthread_once_t* once, void (*init)(void))
+{
+    return InitOnceExecuteOnce (once, wthread_onceCb, (PVOID)init, NULL)
+           ? 0 : 1;
+}
+
 void wthread_testcancel( wthread_t h )
 {
      threadContext *ctx = (threadContext*)h;
@@ -245,11 +245,24 @@ wthread_cond_wait( HANDLE *event, LPCRITICAL_SECTION *cs );
 COMMONExpDLL int wthread_create( wthread_t *h, void *atts, void *(*startProc)( void * ), void *arg );             
 COMMONExpDLL void wthread_destroy(wthread_t thread);
 COMMONExpDLL int wthread_join (wthread_t t, void **value_ptr);
+
+/* One time initialisation */
+typedef INIT_ONCE wthread_once_t;
+#define WTHREAD_ONCE_INIT INIT_ONCE_STATIC_INIT
+COMMONExpDLL int wthread_once (wthread_once_t* once, void (*init)(void));
 COMMONExpDLL void wthread_testcancel( wthread_t h );
 COMMONExpDLL void wthread_cancel( wthread_t h );
 COMMONExpDLL struct tm* localtime_r (const time_t* t, struct tm* result);
 COMMONExpDLL int wthread_set_affinity_mask( wthread_t h, CPU_AFFINITY_SET* dwThreadAffinityMask);
 
+/* Thread placement. Both return 0 on success. */
+#define WTHREAD_SCHED_OTHER 0
+#define WTHREAD_SCHED_FIFO  1
+#define WTHREAD_SCHED_RR    2
+
+COMMONExpDLL int wthread_set_cpu_affinity( wthread_t h, const unsigned int* cpus, unsigned int count );
+COMMONExpDLL int wthread_set_scheduler( wthread_t h, int policy, int priority );
+
 typedef int   wthread_attr_t;
 COMMONExpDLL    void wthread_attr_init (int* attr);
 COMMONExpDLL    void wthread_attr_setdetachstate (int* attr, int);
@@ -36,6 +36,13 @@ extern "C"
 /* Callback for dispatching events from a queue. */
 typedef void (MAMACALLTYPE *wombatQueueCb)(void* data, void* closure);
 
+/* Clock used to stamp items for residency, returning nanoseconds. */
+typedef uint64_t (*wombatQueueClock)(void);
+
+/* Callback receiving the time, in nanoseconds, an item spent on the queue. */
+typedef void (MAMACALLTYPE *wombatQueueResidencyCb)(uint64_t residency,
+                                                    void*    closure);
+
 typedef void* wombatQueue;
 
 typedef enum
@@ -109,6 +116,19 @@ wombatQueue_setMaxSize (wombatQueue queue, unsigned int value);
 COMMONExpDLL wombatQueueStatus
 wombatQueue_getMaxSize (wombatQueue queue, unsigned int *value);
 
+/**
+ * Set a callback to be invoked with the residency, the time between enqueue
+ * and dispatch, of each item as it is dispatched. It is invoked on the
+ * dispatching thread before the item's own callback. While a callback is set
+ * every enqueue reads the given monotonic clock; pass NULL to stop. Items
+ * enqueued before the callback was set are not reported.
+ */
+COMMONExpDLL wombatQueueStatus
+wombatQueue_setResidencyCb (wombatQueue            queue,
+                            wombatQueueClock       clock,
+                            wombatQueueResidencyCb cb,
+                            void*                  closure);
+
 /**
  * Get the number of items currently in the queue.
  */
@@ -321,6 +321,12 @@ typedef mama_status (*bridgeMamaQueue_setHighWatermark)
 typedef mama_status (*bridgeMamaQueue_setLowWatermark)
                                     (queueBridge queue, size_t lowWatermark);
 
+/* Start or stop measuring how long events wait on the queue. This is
+ * optional and is not set by INITIALIZE_BRIDGE, a bridge providing it
+ * assigns it after. */
+typedef mama_status (*bridgeMamaQueue_enableResidency)
+                                    (queueBridge queue, int enable);
+
 /*===================================================================
  =               mamaTransport bridge function pointers             =
  ====================================================================*/
@@ -484,6 +490,22 @@ typedef mama_status (*bridgeMamaSubscription_createWildCard)
                                 mamaSubscription    subscription,
                                 void*               closure);
 
+/* Create the bridge subscription structures for a set of symbols sharing a
+ * source, transport, queue and callbacks in one call. This is optional and
+ * is not set by INITIALIZE_BRIDGE, a bridge providing it assigns it after.
+ * On failure nothing must be left created, MAMA then falls back to calling
+ * bridgeMamaSubscription_create for each symbol. */
+typedef mama_status (*bridgeMamaSubscription_createBatch)
+                               (subscriptionBridge* subscs_,
+                                size_t              count,
+                                const char*         source,
+                                const char**        symbols,
+                                mamaTransport       transport,
+                                mamaQueue           queue,
+                                mamaMsgCallbacks    callback,
+                                mamaSubscription*   subscriptions,
+                                void**              closures);
+
 /* Mute the subscriber.  No message callbacks will be sent.  A
  * subscription is deactivated as part of its destruction; however,
  * subscription destruction can be delayed and we don't want to
@@ -744,6 +766,8 @@ typedef struct mamaBridgeImpl_
     bridgeMamaQueue_getNativeHandle         bridgeMamaQueueGetNativeHandle;
     bridgeMamaQueue_setLowWatermark         bridgeMamaQueueSetLowWatermark;
     bridgeMamaQueue_setHighWatermark        bridgeMamaQueueSetHighWatermark;
+    /* Optional, NULL unless the bridge can measure queue residency. */
+    bridgeMamaQueue_enableResidency         bridgeMamaQueueEnableResidency;
 
     /*Transport bridge functions*/
     bridgeMamaTransport_isValid             bridgeMamaTransportIsValid;
@@ -798,6 +822,8 @@ typedef struct mamaBridgeImpl_
     bridgeMamaSubscription_setTopicClosure  bridgeMamaSubscriptionSetTopicClosure;
     bridgeMamaSubscription_muteCurrentTopic bridgeMamaSubscriptionMuteCurrentTopic;
     bridgeMamaSubscription_isTportDisconnected bridgeMamaSubscriptionIsTportDisconnected;
+    /* Optional, NULL unless the bridge registers many topics at once. */
+    bridgeMamaSubscription_createBatch      bridgeMamaSubscriptionCreateBatch;
 
     /*Timer bridge functions*/
     bridgeMamaTimer_create                  bridgeMamaTimerCreate;
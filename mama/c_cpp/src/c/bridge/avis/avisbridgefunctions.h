@@ -111,6 +111,10 @@ avisBridgeMamaQueue_setLowWatermark (queueBridge queue,
 extern mama_status
 avisBridgeMamaQueue_setHighWatermark (queueBridge queue,
                                      size_t      highWatermark);
+
+extern mama_status
+avisBridgeMamaQueue_enableResidency (queueBridge queue,
+                                    int         enable);
 /*=========================================================================
   =                    Functions for the mamaTransport                    =
   =========================================================================*/
@@ -54,6 +54,10 @@ void avisBridge_createImpl (mamaBridge* result)
     /*Populate the bridge impl structure with the function pointers*/
     INITIALIZE_BRIDGE (impl, avis);
 
+    /* Optional functions not covered by INITIALIZE_BRIDGE */
+    impl->bridgeMamaQueueEnableResidency =
+                    avisBridgeMamaQueue_enableResidency;
+
     mamaBridgeImpl_setClosure((mamaBridge) impl, avisBridge);
 
     *result = (mamaBridge)impl;
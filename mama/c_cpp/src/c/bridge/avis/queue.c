@@ -80,6 +80,16 @@ typedef struct avisQueueBridge {
 static void
 avisBridgeMamaQueueImpl_checkWatermarks (avisQueueBridge* impl);
 
+/**
+ * This is the wombatQueue residency callback, installed while residency is
+ * enabled, which hands each event's residency on to the parent mamaQueue.
+ *
+ * @param residency The nanoseconds the event spent queued.
+ * @param closure   The parent mamaQueue.
+ */
+static void MAMACALLTYPE
+avisBridgeMamaQueueImpl_residencyCb (uint64_t residency, void* closure);
+
 
 /*=========================================================================
   =               Public interface implementation functions               =
@@ -493,6 +503,26 @@ avisBridgeMamaQueue_setLowWatermark (queueBridge    queue,
     return MAMA_STATUS_OK;
 }
 
+mama_status
+avisBridgeMamaQueue_enableResidency (queueBridge queue,
+                                     int         enable)
+{
+    avisQueueBridge* impl = (avisQueueBridge*) queue;
+
+    /* Perform null checks and return if null arguments provided */
+    CHECK_QUEUE(impl);
+
+    /* Stamp events on the underlying queue, with the clock used for the
+     * latency stages, only while enabled */
+    wombatQueue_setResidencyCb (impl->mQueue,
+                                mamaLatency_getTimestamp,
+                                enable ? avisBridgeMamaQueueImpl_residencyCb
+                                       : NULL,
+                                impl->mParent);
+
+    return MAMA_STATUS_OK;
+}
+
 
 /*=========================================================================
   =                  Private implementation functions                     =
@@ -520,3 +550,8 @@ avisBridgeMamaQueueImpl_checkWatermarks (avisQueueBridge* impl)
     }
 }
 
+void MAMACALLTYPE
+avisBridgeMamaQueueImpl_residencyCb (uint64_t residency, void* closure)
+{
+    mamaQueueImpl_recordResidency ((mamaQueue) closure, residency);
+}
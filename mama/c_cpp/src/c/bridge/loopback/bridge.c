@@ -0,0 +1,253 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+/*=========================================================================
+  =                             Includes                                  =
+  =========================================================================*/
+
+#include <mama/mama.h>
+#include <timers.h>
+#include "io.h"
+#include "loopbackbridgefunctions.h"
+
+
+/*=========================================================================
+  =                Typedefs, structs, enums and globals                   =
+  =========================================================================*/
+
+/* Global timer heap */
+timerHeap           gLoopbackTimerHeap;
+
+/* Default payload names and IDs to be loaded when this bridge is loaded */
+static char*        PAYLOAD_NAMES[]         =   { "flatmsg", NULL };
+static char         PAYLOAD_IDS[]           =   { MAMA_PAYLOAD_FLAT, '\0' };
+
+
+/*=========================================================================
+  =                              Macros                                   =
+  =========================================================================*/
+
+/* Version identifiers */
+#define             LOOPBACK_BRIDGE_NAME            "loopback"
+#define             LOOPBACK_BRIDGE_VERSION         "1.0"
+
+/* Name to be given to the default queue. Should be bridge-specific. */
+#define             LOOPBACK_DEFAULT_QUEUE_NAME     "LOOPBACK_DEFAULT_MAMA_QUEUE"
+
+/* Timeout for dispatching queues on shutdown in milliseconds */
+#define             LOOPBACK_SHUTDOWN_TIMEOUT       5000
+
+
+/*=========================================================================
+  =               Public interface implementation functions               =
+  =========================================================================*/
+
+void loopbackBridge_createImpl (mamaBridge* result)
+{
+    mamaBridgeImpl* bridge = NULL;
+
+    if (NULL == result)
+    {
+        return;
+    }
+
+    /* Create the wrapping MAMA bridge */
+    bridge = (mamaBridgeImpl*) calloc (1, sizeof (mamaBridgeImpl));
+    if (NULL == bridge)
+    {
+        mama_log (MAMA_LOG_LEVEL_SEVERE, "loopbackBridge_createImpl(): "
+                "Could not allocate memory for MAMA bridge implementation.");
+        *result = NULL;
+        return;
+    }
+
+    /* Populate the bridge impl structure with the function pointers */
+    INITIALIZE_BRIDGE (bridge, loopback);
+
+    /* Optional functions not covered by INITIALIZE_BRIDGE */
+    bridge->bridgeMamaSubscriptionCreateBatch =
+                    loopbackBridgeMamaSubscription_createBatch;
+    bridge->bridgeMamaQueueEnableResidency =
+                    loopbackBridgeMamaQueue_enableResidency;
+
+    /* Return the newly created bridge */
+    *result = (mamaBridge) bridge;
+
+    mamaBridgeImpl_setReadOnlyProperty ((mamaBridge)bridge,
+                                        "mama.loopback.entitlements.deferred",
+                                        "false");
+}
+
+mama_status
+loopbackBridge_open (mamaBridge bridgeImpl)
+{
+    mama_status         status  = MAMA_STATUS_OK;
+    mamaBridgeImpl*     bridge  = (mamaBridgeImpl*) bridgeImpl;
+
+    wsocketstartup();
+
+    if (NULL == bridgeImpl)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Create the default event queue */
+    status = mamaQueue_create (&bridge->mDefaultEventQueue, bridgeImpl);
+    if (MAMA_STATUS_OK != status)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "loopbackBridge_open(): Failed to create loopback queue (%s).",
+                  mamaStatus_stringForStatus (status));
+        return status;
+    }
+
+    /* Set the queue name (used to identify this queue in MAMA stats) */
+    mamaQueue_setQueueName (bridge->mDefaultEventQueue,
+                            LOOPBACK_DEFAULT_QUEUE_NAME);
+
+    /* Create the timer heap */
+    if (0 != createTimerHeap (&gLoopbackTimerHeap))
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "loopbackBridge_open(): Failed to initialize timers.");
+        return MAMA_STATUS_PLATFORM;
+    }
+
+    /* Start the dispatch timer heap which will create a new thread */
+    if (0 != startDispatchTimerHeap (gLoopbackTimerHeap))
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "loopbackBridge_open(): Failed to start timer thread.");
+        return MAMA_STATUS_PLATFORM;
+    }
+
+    /* Start the io thread */
+    loopbackBridgeMamaIoImpl_start ();
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+loopbackBridge_close (mamaBridge bridgeImpl)
+{
+    mama_status      status      = MAMA_STATUS_OK;
+    mamaBridgeImpl*  bridge      = (mamaBridgeImpl*) bridgeImpl;
+    wthread_t        timerThread;
+
+    if (NULL ==  bridgeImpl)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Remove the timer heap */
+    if (NULL != gLoopbackTimerHeap)
+    {
+        /* The timer heap allows us to access it's thread ID for joining */
+        timerThread = timerHeapGetTid (gLoopbackTimerHeap);
+        if (0 != destroyHeap (gLoopbackTimerHeap))
+        {
+            mama_log (MAMA_LOG_LEVEL_ERROR,
+                      "loopbackBridge_close(): "
+                      "Failed to destroy loopback timer heap.");
+            status = MAMA_STATUS_PLATFORM;
+        }
+        /* The timer thread expects us to be responsible for terminating it */
+        wthread_join    (timerThread, NULL);
+    }
+    gLoopbackTimerHeap = NULL;
+
+    /* Destroy once queue has been emptied */
+    mamaQueue_destroyTimedWait (bridge->mDefaultEventQueue,
+                                LOOPBACK_SHUTDOWN_TIMEOUT);
+
+    /* Stop and destroy the io thread */
+    loopbackBridgeMamaIoImpl_stop ();
+
+    /* Wait for loopbackBridge_start to finish before destroying */
+    if (NULL != bridgeImpl)
+    {
+        free (bridgeImpl);
+    }
+
+    return status;
+}
+
+mama_status
+loopbackBridge_start (mamaQueue defaultEventQueue)
+{
+    if (NULL == defaultEventQueue)
+    {
+      mama_log (MAMA_LOG_LEVEL_FINER,
+                "loopbackBridge_start(): defaultEventQueue is NULL");
+      return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Start the default event queue */
+    return mamaQueue_dispatch (defaultEventQueue);;
+}
+
+mama_status
+loopbackBridge_stop (mamaQueue defaultEventQueue)
+{
+    if (NULL == defaultEventQueue)
+    {
+      mama_log (MAMA_LOG_LEVEL_FINER,
+                "loopbackBridge_start(): defaultEventQueue is NULL");
+      return MAMA_STATUS_NULL_ARG;
+    }
+
+    return mamaQueue_stopDispatch (defaultEventQueue);;
+}
+
+const char*
+loopbackBridge_getVersion (void)
+{
+    return LOOPBACK_BRIDGE_VERSION;
+}
+
+const char*
+loopbackBridge_getName (void)
+{
+    return LOOPBACK_BRIDGE_NAME;
+}
+
+mama_status
+loopbackBridge_getDefaultPayloadId (char ***name, char **id)
+{
+    if (NULL == name || NULL == id)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+    /*
+     * Populate name with the value of all supported payload names, the first
+     * being the default
+     */
+    *name   = PAYLOAD_NAMES;
+
+    /*
+     * Populate id with the char keys for all supported payload names, the first
+     * being the default
+     */
+    *id     = PAYLOAD_IDS;
+
+     return MAMA_STATUS_OK;
+}
@@ -0,0 +1,125 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#ifndef MAMA_BRIDGE_LOOPBACK_LOOPBACKDEFS_H__
+#define MAMA_BRIDGE_LOOPBACK_LOOPBACKDEFS_H__
+
+
+/*=========================================================================
+  =                             Includes                                  =
+  =========================================================================*/
+
+#include <wombat/wtable.h>
+#include <wombat/mempool.h>
+#include <timers.h>
+#include <mama/mama.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+
+/*=========================================================================
+  =                              Macros                                   =
+  =========================================================================*/
+
+/* Maximum topic length */
+#define     MAX_SUBJECT_LENGTH              256
+#define     MAMA_ROOT_MARKET_DATA           "_MD"
+
+/* Message types */
+typedef enum loopbackMsgType_
+{
+    LOOPBACK_MSG_PUB_SUB    =               0x00,
+    LOOPBACK_MSG_INBOX_REQUEST,
+    LOOPBACK_MSG_INBOX_RESPONSE
+} loopbackMsgType;
+
+
+/*=========================================================================
+  =                Typedefs, structs, enums and globals                   =
+  =========================================================================*/
+
+typedef struct loopbackSubscription_
+{
+    mamaMsgCallbacks    mMamaCallback;
+    mamaSubscription    mMamaSubscription;
+    mamaQueue           mMamaQueue;
+    void*               mLoopbackQueue;
+    transportBridge     mTransport;
+    const char*         mSubject;
+    void*               mClosure;
+    int                 mIsNotMuted;
+    int                 mIsValid;
+    int                 mIsTportDisconnected;
+    /* Next subscription on the same subject, guarded by the registry lock */
+    struct loopbackSubscription_* mNext;
+} loopbackSubscription;
+
+typedef struct loopbackTransportBridge_
+{
+    int                 mIsValid;
+    mamaTransport       mTransport;
+    const char*         mName;
+    /* Artificial delay added to every delivery, in nanoseconds */
+    mama_u64_t          mLatency;
+    /* Share of deliveries dropped, in parts per million */
+    uint32_t            mLossPpm;
+    /* Pseudo random state deciding drops, guarded by the registry lock */
+    uint32_t            mLossState;
+    uint64_t            mDropped;
+    memoryPool*         mLoopbackMsgPool;
+    /* Deliveries waiting out mLatency, oldest first, guarded by mDelayLock */
+    wthread_mutex_t     mDelayLock;
+    memoryNode*         mDelayedHead;
+    memoryNode*         mDelayedTail;
+    int                 mIsDelayArmed;
+    /* One shot timer releasing the delayed deliveries as they fall due.
+     * Created and re-armed with the registry lock held */
+    timerElement        mDelayTimer;
+} loopbackTransportBridge;
+
+/*
+ * Copied for each matching subscription when a message is published and
+ * enqueued. The payload is stored directly after this structure in the
+ * memory node.
+ */
+typedef struct loopbackMsgNode_
+{
+    loopbackTransportBridge*    mTransport;
+    loopbackSubscription*       mSubscription;
+    loopbackMsgType             mMsgType;
+    mamaPayloadType             mPayloadType;
+    uint32_t                    mPayloadLen;
+    char                        mSubject[MAX_SUBJECT_LENGTH];
+    char                        mInbox[MAX_SUBJECT_LENGTH];
+    /* Monotonic time before which the message may not be enqueued */
+    mama_u64_t                  mDueTime;
+    /* Latency stamps, zero unless mamaLatency_isEnabled */
+    mama_u64_t                  mReceiveTime;
+    mama_u64_t                  mEnqueueTime;
+} loopbackMsgNode;
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* MAMA_BRIDGE_LOOPBACK_LOOPBACKDEFS_H__ */
@@ -0,0 +1,370 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+
+/*=========================================================================
+  =                             Includes                                  =
+  =========================================================================*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <mama/mama.h>
+#include <msgimpl.h>
+#include "loopbackdefs.h"
+#include "loopbackbridgefunctions.h"
+#include "msg.h"
+
+
+/*=========================================================================
+  =                Typedefs, structs, enums and globals                   =
+  =========================================================================*/
+
+typedef struct loopbackBridgeMsgImpl
+{
+    mamaMsg                     mParent;
+    loopbackMsgType             mMsgType;
+    char                        mInboxName[MAX_SUBJECT_LENGTH];
+} loopbackBridgeMsgImpl;
+
+
+/*=========================================================================
+  =              Public interface implementation functions                =
+  =========================================================================*/
+
+/* Bridge specific implementations below here */
+mama_status
+loopbackBridgeMamaMsg_create (msgBridge* msg, mamaMsg parent)
+{
+    loopbackBridgeMsgImpl* impl   = NULL;
+    mama_status            status = MAMA_STATUS_OK;
+
+    if (NULL == msg || NULL == parent)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    status = loopbackBridgeMamaMsgImpl_createMsgOnly (msg);
+    if (MAMA_STATUS_OK != status)
+    {
+        return status;
+    }
+
+    /* Cast back to implementation to set parent */
+    impl = (loopbackBridgeMsgImpl*) *msg;
+    impl->mParent       = parent;
+
+    return MAMA_STATUS_OK;
+}
+
+int
+loopbackBridgeMamaMsg_isFromInbox (msgBridge msg)
+{
+    if (NULL == msg)
+    {
+        return -1;
+    }
+
+    if (LOOPBACK_MSG_INBOX_REQUEST == ((loopbackBridgeMsgImpl*)msg)->mMsgType)
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
+mama_status
+loopbackBridgeMamaMsg_destroy (msgBridge msg, int destroyMsg)
+{
+    if (NULL == msg)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Free the underlying implementation */
+    free (msg);
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+loopbackBridgeMamaMsg_destroyMiddlewareMsg (msgBridge msg)
+{
+    /*
+     * The payload lives in the transport's message pool rather than in the
+     * bridge message, so there is nothing to do here
+     */
+    if (NULL == msg)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+loopbackBridgeMamaMsg_detach (msgBridge msg)
+{
+    /*
+     * The payload lives in the transport's message pool rather than in the
+     * bridge message, so there is nothing to do here
+     */
+    if (NULL == msg)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+loopbackBridgeMamaMsg_getPlatformError (msgBridge msg, void** error)
+{
+    /* Null initialize the error return */
+    if (NULL != error)
+    {
+        *error  = NULL;
+    }
+
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+loopbackBridgeMamaMsg_setSendSubject (msgBridge   msg,
+                                      const char* symbol,
+                                      const char* subject)
+{
+    loopbackBridgeMsgImpl* impl     = (loopbackBridgeMsgImpl*) msg;
+    mama_status            status   = MAMA_STATUS_OK;
+
+    if (NULL == impl || NULL == symbol)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Update the MAMA message with the send subject if it has a parent */
+    if (NULL != impl->mParent)
+    {
+        status = mamaMsg_updateString (impl->mParent,
+                                       MamaFieldSubscSymbol.mName,
+                                       MamaFieldSubscSymbol.mFid,
+                                       symbol);
+    }
+
+    return status;
+}
+
+mama_status
+loopbackBridgeMamaMsg_getNativeHandle (msgBridge msg, void** result)
+{
+    loopbackBridgeMsgImpl* impl = (loopbackBridgeMsgImpl*) msg;
+
+    if (NULL == impl || NULL == result)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    *result = impl;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+loopbackBridgeMamaMsg_duplicateReplyHandle (msgBridge msg, void** result)
+{
+    loopbackBridgeMsgImpl* impl = (loopbackBridgeMsgImpl*) msg;
+
+    if (NULL == impl || NULL == result)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Reply handles are simply the inbox subject to publish replies onto */
+    *result = (void*) strdup (impl->mInboxName);
+    if (NULL == *result)
+    {
+        return MAMA_STATUS_NOMEM;
+    }
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+loopbackBridgeMamaMsg_copyReplyHandle (void* src, void** dest)
+{
+    if (NULL == src || NULL == dest)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    *dest = (void*) strdup ((const char*) src);
+    if (NULL == *dest)
+    {
+        return MAMA_STATUS_NOMEM;
+    }
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+loopbackBridgeMamaMsg_destroyReplyHandle (void* result)
+{
+    if (NULL == result)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    free (result);
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+loopbackBridgeMamaMsgImpl_setReplyHandle (msgBridge msg, void* handle)
+{
+    loopbackBridgeMsgImpl* impl = (loopbackBridgeMsgImpl*) msg;
+
+    if (NULL == impl || NULL == handle)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    return loopbackBridgeMamaMsgImpl_setInboxName (msg, (const char*) handle);
+}
+
+mama_status
+loopbackBridgeMamaMsgImpl_setReplyHandleAndIncrement (msgBridge msg, void* result)
+{
+    /* Reply handles are not reference counted - they are simply strings */
+    return loopbackBridgeMamaMsgImpl_setReplyHandle (msg, result);
+}
+
+
+/*=========================================================================
+  =                  Public implementation functions                      =
+  =========================================================================*/
+
+mama_status
+loopbackBridgeMamaMsgImpl_createMsgOnly (msgBridge* msg)
+{
+    loopbackBridgeMsgImpl* impl = NULL;
+
+    if (NULL == msg)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Allocate memory for the implementation struct */
+    impl = (loopbackBridgeMsgImpl*) calloc (1, sizeof (loopbackBridgeMsgImpl));
+    if (NULL == impl)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "loopbackBridgeMamaMsgImpl_createMsgOnly(): "
+                  "Failed to allocate memory for bridge message.");
+        *msg = NULL;
+        return MAMA_STATUS_NOMEM;
+    }
+
+    impl->mMsgType = LOOPBACK_MSG_PUB_SUB;
+
+    *msg = (msgBridge) impl;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+loopbackBridgeMamaMsgImpl_setMsgType (msgBridge     msg,
+                                      loopbackMsgType    type)
+{
+    loopbackBridgeMsgImpl* impl = (loopbackBridgeMsgImpl*) msg;
+
+    if (NULL == impl)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    impl->mMsgType = type;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+loopbackBridgeMamaMsgImpl_getMsgType (msgBridge     msg,
+                                      loopbackMsgType*   type)
+{
+    loopbackBridgeMsgImpl* impl = (loopbackBridgeMsgImpl*) msg;
+
+    if (NULL == impl || NULL == type)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    *type = impl->mMsgType;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+loopbackBridgeMamaMsgImpl_setInboxName (msgBridge   msg,
+                                        const char* value)
+{
+    loopbackBridgeMsgImpl* impl = (loopbackBridgeMsgImpl*) msg;
+
+    if (NULL == impl)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    if (NULL == value)
+    {
+        impl->mInboxName[0] = '\0';
+        return MAMA_STATUS_OK;
+    }
+
+    if (strlen (value) >= sizeof (impl->mInboxName))
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "loopbackBridgeMamaMsgImpl_setInboxName(): "
+                  "Inbox name exceeds %d characters.",
+                  MAX_SUBJECT_LENGTH - 1);
+        return MAMA_STATUS_INVALID_ARG;
+    }
+
+    strcpy (impl->mInboxName, value);
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+loopbackBridgeMamaMsgImpl_getInboxName (msgBridge    msg,
+                                        const char** value)
+{
+    loopbackBridgeMsgImpl* impl = (loopbackBridgeMsgImpl*) msg;
+
+    if (NULL == impl || NULL == value)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    *value = impl->mInboxName;
+
+    return MAMA_STATUS_OK;
+}
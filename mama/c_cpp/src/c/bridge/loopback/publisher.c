@@ -0,0 +1,337 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+/*=========================================================================
+  =                             Includes                                  =
+  =========================================================================*/
+
+#include <string.h>
+#include <mama/mama.h>
+#include <mama/inbox.h>
+#include <mama/publisher.h>
+#include <bridge.h>
+#include <inboximpl.h>
+#include <msgimpl.h>
+#include "loopbackbridgefunctions.h"
+#include "transport.h"
+#include "loopbackdefs.h"
+#include "msg.h"
+#include "inbox.h"
+
+
+/*=========================================================================
+  =                Typedefs, structs, enums and globals                   =
+  =========================================================================*/
+
+typedef struct loopbackPublisherBridge
+{
+    loopbackTransportBridge*    mTransport;
+    const char*                 mSubject;
+    const char*                 mSource;
+    msgBridge                   mMamaBridgeMsg;
+} loopbackPublisherBridge;
+
+
+/*=========================================================================
+  =               Public interface implementation functions               =
+  =========================================================================*/
+
+mama_status
+loopbackBridgeMamaPublisher_createByIndex (publisherBridge*     result,
+                                           mamaTransport        tport,
+                                           int                  tportIndex,
+                                           const char*          topic,
+                                           const char*          source,
+                                           const char*          root,
+                                           void*                nativeQueueHandle,
+                                           mamaPublisher        parent)
+{
+    loopbackPublisherBridge* impl            = NULL;
+    loopbackTransportBridge* transport       = NULL;
+    mama_status              status          = MAMA_STATUS_OK;
+
+    if (NULL == result
+            || NULL == tport
+            || NULL == parent)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    transport = loopbackBridgeMamaTransportImpl_getTransportBridge (tport);
+    if (NULL == transport)
+    {
+        mama_log (MAMA_LOG_LEVEL_SEVERE,
+                  "loopbackBridgeMamaPublisher_createByIndex(): "
+                  "Could not find transport.");
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    impl = (loopbackPublisherBridge*) calloc (1, sizeof (loopbackPublisherBridge));
+    if (NULL == impl)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "loopbackBridgeMamaPublisher_createByIndex(): "
+                  "Could not allocate mem publisher.");
+        return MAMA_STATUS_NOMEM;
+    }
+
+    /* Initialize the publisher members */
+    impl->mTransport = transport;
+
+    /* Create an underlying bridge message with no parent to be used in sends */
+    status = loopbackBridgeMamaMsgImpl_createMsgOnly (&impl->mMamaBridgeMsg);
+    if (MAMA_STATUS_OK != status)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "loopbackBridgeMamaPublisher_createByIndex(): "
+                  "Could not create loopback bridge message for publisher: %s.",
+                  mamaStatus_stringForStatus (status));
+        free (impl);
+        return MAMA_STATUS_NOMEM;
+    }
+
+    /*
+     * Collapse subject key to single string based on supplied values
+     *
+     * _MD requests do not use the topic on the wire as the responder may not
+     * necessarily be listening for requests on that topic until the first
+     * request comes in.
+     */
+    if (NULL != root && 0 == strcmp (root, MAMA_ROOT_MARKET_DATA))
+    {
+        status = loopbackBridgeMamaTransportImpl_generateSubjectKey (
+                             root, source, NULL, &impl->mSubject);
+    }
+    else
+    {
+        status = loopbackBridgeMamaTransportImpl_generateSubjectKey (
+                             root, source, topic, &impl->mSubject);
+    }
+
+    if (MAMA_STATUS_OK != status)
+    {
+        loopbackBridgeMamaMsg_destroy (impl->mMamaBridgeMsg, 0);
+        free (impl);
+        return status;
+    }
+
+    if (NULL != source)
+    {
+        impl->mSource = strdup (source);
+    }
+
+    /* Populate the publisherBridge pointer with the publisher implementation */
+    *result = (publisherBridge) impl;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+loopbackBridgeMamaPublisher_create (publisherBridge*    result,
+                                    mamaTransport       tport,
+                                    const char*         topic,
+                                    const char*         source,
+                                    const char*         root,
+                                    void*               nativeQueueHandle,
+                                    mamaPublisher       parent)
+{
+    return loopbackBridgeMamaPublisher_createByIndex (result,
+                                                      tport,
+                                                      0,
+                                                      topic,
+                                                      source,
+                                                      root,
+                                                      nativeQueueHandle,
+                                                      parent);
+}
+
+mama_status
+loopbackBridgeMamaPublisher_destroy (publisherBridge publisher)
+{
+    loopbackPublisherBridge* impl = (loopbackPublisherBridge*) publisher;
+
+    if (NULL == impl)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    if (NULL != impl->mSubject)
+    {
+        free ((void*) impl->mSubject);
+    }
+
+    if (NULL != impl->mSource)
+    {
+        free ((void*) impl->mSource);
+    }
+
+    if (NULL != impl->mMamaBridgeMsg)
+    {
+        loopbackBridgeMamaMsg_destroy (impl->mMamaBridgeMsg, 0);
+    }
+
+    free (impl);
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+loopbackBridgeMamaPublisher_send (publisherBridge publisher, mamaMsg msg)
+{
+    loopbackPublisherBridge*     impl    = (loopbackPublisherBridge*) publisher;
+
+    if (NULL == impl)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "loopbackBridgeMamaPublisher_send(): No publisher.");
+        return MAMA_STATUS_NULL_ARG;
+    }
+    else if (NULL == msg)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Use the publisher's default send subject */
+    loopbackBridgeMamaMsg_setSendSubject (impl->mMamaBridgeMsg,
+                                          impl->mSubject,
+                                          impl->mSource);
+
+    return loopbackBridgeMamaTransportImpl_deliver (impl->mSubject,
+                                                    LOOPBACK_MSG_PUB_SUB,
+                                                    NULL,
+                                                    msg);
+}
+
+/* Send reply to inbox. */
+mama_status
+loopbackBridgeMamaPublisher_sendReplyToInbox (publisherBridge   publisher,
+                                              void*             request,
+                                              mamaMsg           reply)
+{
+    mamaMsg                 requestMsg      = (mamaMsg) request;
+    const char*             inboxSubject    = NULL;
+    msgBridge               bridgeMsg       = NULL;
+    mama_status             status          = MAMA_STATUS_OK;
+
+    if (NULL == publisher || NULL == request || NULL == reply)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Get the incoming bridge message from the mamaMsg */
+    status = mamaMsgImpl_getBridgeMsg (requestMsg, &bridgeMsg);
+    if (MAMA_STATUS_OK != status)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "loopbackBridgeMamaPublisher_sendReplyToInbox(): "
+                  "Could not get bridge message from cached"
+                  " queue mamaMsg [%s]",
+                  mamaStatus_stringForStatus (status));
+        return status;
+    }
+
+    /* Get properties from the incoming bridge message */
+    status = loopbackBridgeMamaMsgImpl_getInboxName (bridgeMsg, &inboxSubject);
+    if (MAMA_STATUS_OK != status)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "loopbackBridgeMamaPublisher_sendReplyToInbox(): "
+                  "Could not get inbox name [%s]",
+                  mamaStatus_stringForStatus (status));
+        return status;
+    }
+
+    return loopbackBridgeMamaPublisher_sendReplyToInboxHandle (
+                        publisher,
+                        (void*) inboxSubject,
+                        reply);
+}
+
+mama_status
+loopbackBridgeMamaPublisher_sendReplyToInboxHandle (publisherBridge     publisher,
+                                                    void*               inbox,
+                                                    mamaMsg             reply)
+{
+    const char*              inboxSubject    = (const char*) inbox;
+
+    if (NULL == publisher || NULL == inbox || NULL == reply)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    if ('\0' == inboxSubject[0])
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "loopbackBridgeMamaPublisher_sendReplyToInboxHandle(): "
+                  "No reply address specified - cannot respond to inbox.");
+        return MAMA_STATUS_INVALID_ARG;
+    }
+
+    /* Inboxes are subscriptions, so the reply is delivered to the inbox */
+    return loopbackBridgeMamaTransportImpl_deliver (inboxSubject,
+                                                    LOOPBACK_MSG_INBOX_RESPONSE,
+                                                    NULL,
+                                                    reply);
+}
+
+/* Send a message from the specified inbox using the throttle. */
+mama_status
+loopbackBridgeMamaPublisher_sendFromInboxByIndex (publisherBridge   publisher,
+                                                  int               tportIndex,
+                                                  mamaInbox         inbox,
+                                                  mamaMsg           msg)
+{
+    loopbackPublisherBridge* impl        = (loopbackPublisherBridge*) publisher;
+    const char*              replyAddr   = NULL;
+    inboxBridge              inboxImpl   = NULL;
+
+    if (NULL == impl || NULL == inbox || NULL == msg)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Get the inbox which you want the publisher to respond to */
+    inboxImpl = mamaInboxImpl_getInboxBridge (inbox);
+    replyAddr = loopbackBridgeMamaInboxImpl_getReplySubject (inboxImpl);
+
+    /* Use the publisher's default send subject */
+    loopbackBridgeMamaMsg_setSendSubject (impl->mMamaBridgeMsg,
+                                          impl->mSubject,
+                                          impl->mSource);
+
+    return loopbackBridgeMamaTransportImpl_deliver (impl->mSubject,
+                                                    LOOPBACK_MSG_INBOX_REQUEST,
+                                                    replyAddr,
+                                                    msg);
+}
+
+mama_status
+loopbackBridgeMamaPublisher_sendFromInbox (publisherBridge  publisher,
+                                           mamaInbox        inbox,
+                                           mamaMsg          msg)
+{
+    return loopbackBridgeMamaPublisher_sendFromInboxByIndex (publisher,
+                                                             0,
+                                                             inbox,
+                                                             msg);
+}
+
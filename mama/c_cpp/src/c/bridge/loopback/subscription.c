@@ -0,0 +1,353 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+/*=========================================================================
+  =                             Includes                                  =
+  =========================================================================*/
+
+#include <string.h>
+#include <mama/mama.h>
+#include <subscriptionimpl.h>
+#include <transportimpl.h>
+#include <queueimpl.h>
+#include "loopbackbridgefunctions.h"
+#include "transport.h"
+#include "loopbackdefs.h"
+
+
+/*=========================================================================
+  =               Public interface implementation functions               =
+  =========================================================================*/
+
+mama_status
+loopbackBridgeMamaSubscription_create (subscriptionBridge* subscriber,
+                                       const char*         source,
+                                       const char*         symbol,
+                                       mamaTransport       tport,
+                                       mamaQueue           queue,
+                                       mamaMsgCallbacks    callback,
+                                       mamaSubscription    subscription,
+                                       void*               closure)
+{
+    loopbackSubscription*    impl        = NULL;
+    loopbackTransportBridge* transport   = NULL;
+    mama_status              status      = MAMA_STATUS_OK;
+
+    if (NULL == subscriber || NULL == subscription || NULL == tport)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "loopbackBridgeMamaSubscription_create(): something NULL");
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    status = mamaTransport_getBridgeTransport (tport,
+                                               (transportBridge*) &transport);
+
+    if (MAMA_STATUS_OK != status || NULL == transport)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "loopbackBridgeMamaSubscription_create(): something NULL");
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Allocate memory for loopback subscription implementation */
+    impl = (loopbackSubscription*) calloc (1, sizeof (loopbackSubscription));
+    if (NULL == impl)
+    {
+        return MAMA_STATUS_NOMEM;
+    }
+
+    mamaQueue_getNativeHandle (queue, &impl->mLoopbackQueue);
+    impl->mMamaCallback        = callback;
+    impl->mMamaSubscription    = subscription;
+    impl->mMamaQueue           = queue;
+    impl->mTransport           = (transportBridge) transport;
+    impl->mClosure             = closure;
+    impl->mIsNotMuted          = 1;
+    impl->mIsTportDisconnected = 0;
+    impl->mSubject             = NULL;
+
+    /* Use a standard centralized method to determine a topic key */
+    status = loopbackBridgeMamaTransportImpl_generateSubjectKey (NULL,
+                                                                 source,
+                                                                 symbol,
+                                                                 &impl->mSubject);
+    if (MAMA_STATUS_OK != status)
+    {
+        free (impl);
+        return status;
+    }
+
+    /* Mark this subscription as valid before messages can be routed to it */
+    impl->mIsValid = 1;
+
+    /* Register the interest so that publishers in the process can reach it */
+    status = loopbackBridgeMamaTransportImpl_registerSubscription (impl);
+    if (MAMA_STATUS_OK != status)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "loopbackBridgeMamaSubscription_create(): "
+                  "Could not register interest for %s [%s]",
+                  impl->mSubject,
+                  mamaStatus_stringForStatus (status));
+        free ((void*) impl->mSubject);
+        free (impl);
+        return status;
+    }
+
+    mama_log (MAMA_LOG_LEVEL_FINEST,
+              "loopbackBridgeMamaSubscription_create(): "
+              "created interest for %s.",
+              impl->mSubject);
+
+    *subscriber = (subscriptionBridge) impl;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+loopbackBridgeMamaSubscription_createBatch (subscriptionBridge* subscribers,
+                                            size_t              count,
+                                            const char*         source,
+                                            const char**        symbols,
+                                            mamaTransport       tport,
+                                            mamaQueue           queue,
+                                            mamaMsgCallbacks    callback,
+                                            mamaSubscription*   subscriptions,
+                                            void**              closures)
+{
+    loopbackSubscription**   registry    = NULL;
+    loopbackTransportBridge* transport   = NULL;
+    void*                    nativeQueue = NULL;
+    mama_status              status      = MAMA_STATUS_OK;
+    size_t                   i           = 0;
+
+    if (NULL == subscribers || NULL == symbols || NULL == subscriptions
+        || NULL == tport || 0 == count)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "loopbackBridgeMamaSubscription_createBatch(): something NULL");
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    status = mamaTransport_getBridgeTransport (tport,
+                                               (transportBridge*) &transport);
+
+    if (MAMA_STATUS_OK != status || NULL == transport)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "loopbackBridgeMamaSubscription_createBatch(): something NULL");
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    registry = (loopbackSubscription**) calloc (count,
+                                                sizeof (loopbackSubscription*));
+    if (NULL == registry)
+    {
+        return MAMA_STATUS_NOMEM;
+    }
+
+    mamaQueue_getNativeHandle (queue, &nativeQueue);
+
+    for (i = 0; i < count && MAMA_STATUS_OK == status; i++)
+    {
+        /* Each subscription is freed on its own when it is destroyed */
+        registry[i] = (loopbackSubscription*) calloc (1,
+                                                sizeof (loopbackSubscription));
+        if (NULL == registry[i])
+        {
+            status = MAMA_STATUS_NOMEM;
+            break;
+        }
+
+        registry[i]->mLoopbackQueue       = nativeQueue;
+        registry[i]->mMamaCallback        = callback;
+        registry[i]->mMamaSubscription    = subscriptions[i];
+        registry[i]->mMamaQueue           = queue;
+        registry[i]->mTransport           = (transportBridge) transport;
+        registry[i]->mClosure             = closures ? closures[i] : NULL;
+        registry[i]->mIsNotMuted          = 1;
+        registry[i]->mIsTportDisconnected = 0;
+        registry[i]->mIsValid             = 1;
+
+        status = loopbackBridgeMamaTransportImpl_generateSubjectKey (
+                        NULL, source, symbols[i], &registry[i]->mSubject);
+    }
+
+    if (MAMA_STATUS_OK == status)
+    {
+        status = loopbackBridgeMamaTransportImpl_registerSubscriptions (registry,
+                                                                        count);
+    }
+
+    if (MAMA_STATUS_OK != status)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "loopbackBridgeMamaSubscription_createBatch(): "
+                  "Could not register interest for %lu subscriptions [%s]",
+                  (unsigned long) count,
+                  mamaStatus_stringForStatus (status));
+
+        for (i = 0; i < count && NULL != registry[i]; i++)
+        {
+            free ((void*) registry[i]->mSubject);
+            free (registry[i]);
+        }
+        free (registry);
+        return status;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        subscribers[i] = (subscriptionBridge) registry[i];
+    }
+
+    mama_log (MAMA_LOG_LEVEL_FINEST,
+              "loopbackBridgeMamaSubscription_createBatch(): "
+              "created interest for %lu subjects.",
+              (unsigned long) count);
+
+    free (registry);
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+loopbackBridgeMamaSubscription_createWildCard (subscriptionBridge*     subscriber,
+                                               const char*             source,
+                                               const char*             symbol,
+                                               mamaTransport           transport,
+                                               mamaQueue               queue,
+                                               mamaMsgCallbacks        callback,
+                                               mamaSubscription        subscription,
+                                               void*                   closure)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+loopbackBridgeMamaSubscription_mute (subscriptionBridge subscriber)
+{
+    loopbackSubscription* impl = (loopbackSubscription*) subscriber;
+
+    if (NULL == impl)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    impl->mIsNotMuted = 0;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+loopbackBridgeMamaSubscription_destroy (subscriptionBridge subscriber)
+{
+    loopbackSubscription*        impl            = NULL;
+    loopbackTransportBridge*     transportBridge = NULL;
+    mamaSubscription             parent          = NULL;
+    void*                        closure         = NULL;
+    wombat_subscriptionDestroyCB destroyCb       = NULL;
+
+    if (NULL == subscriber)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    impl            = (loopbackSubscription*) subscriber;
+    parent          = impl->mMamaSubscription;
+    closure         = impl->mClosure;
+    destroyCb       = impl->mMamaCallback.onDestroy;
+    transportBridge = (loopbackTransportBridge*) impl->mTransport;
+
+    /* Stop routing messages to this subscription before it is freed */
+    if (NULL != transportBridge)
+    {
+        loopbackBridgeMamaTransportImpl_unregisterSubscription (impl);
+    }
+
+    if (NULL != impl->mSubject)
+    {
+        free ((void*) impl->mSubject);
+    }
+
+    free (impl);
+
+    /*
+     * Invoke the subscription callback to inform that the bridge has been
+     * destroyed.
+     */
+    if (NULL != destroyCb)
+        (*(wombat_subscriptionDestroyCB)destroyCb)(parent, closure);
+
+    return MAMA_STATUS_OK;
+}
+
+int
+loopbackBridgeMamaSubscription_isValid (subscriptionBridge subscriber)
+{
+    loopbackSubscription* impl = (loopbackSubscription*) subscriber;
+
+    if (NULL != impl)
+    {
+        return impl->mIsValid;
+    }
+    return 0;
+}
+
+int
+loopbackBridgeMamaSubscription_hasWildcards (subscriptionBridge subscriber)
+{
+    return 0;
+}
+
+mama_status
+loopbackBridgeMamaSubscription_getPlatformError (subscriptionBridge subscriber,
+                                                 void** error)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+int
+loopbackBridgeMamaSubscription_isTportDisconnected (subscriptionBridge subscriber)
+{
+    loopbackSubscription* impl = (loopbackSubscription*) subscriber;
+    if (NULL == impl)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+    return impl->mIsTportDisconnected;
+}
+
+mama_status
+loopbackBridgeMamaSubscription_setTopicClosure (subscriptionBridge subscriber,
+                                                void* closure)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+loopbackBridgeMamaSubscription_muteCurrentTopic (subscriptionBridge subscriber)
+{
+    /* As there is one topic per subscription, this can act as an alias */
+    return loopbackBridgeMamaSubscription_mute (subscriber);
+}
@@ -0,0 +1,1250 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+/*=========================================================================
+  =                             Includes                                  =
+  =========================================================================*/
+
+#include <wombat/port.h>
+#include <property.h>
+#include <mama/mama.h>
+#include <queueimpl.h>
+#include <msgimpl.h>
+#include <subscriptionimpl.h>
+#include <transportimpl.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <errno.h>
+
+#include "transport.h"
+#include "loopbackbridgefunctions.h"
+#include "loopbackdefs.h"
+#include "msg.h"
+
+/*=========================================================================
+  =                              Macros                                   =
+  =========================================================================*/
+
+/* Transport configuration parameters */
+#define     TPORT_PARAM_PREFIX              "mama.loopback.transport"
+#define     TPORT_PARAM_LATENCY             "latency_us"
+#define     TPORT_PARAM_LOSS                "loss_ppm"
+#define     TPORT_PARAM_LOSS_SEED           "loss_seed"
+#define     TPORT_PARAM_SUB_POOL_SIZE       "msg_pool_size"
+
+/* Default values for corresponding configuration parameters */
+#define     DEFAULT_LATENCY                 0
+#define     DEFAULT_LOSS                    0
+#define     DEFAULT_LOSS_SEED               1
+#define     DEFAULT_SUB_POOL_SIZE           128
+
+/* Non configurable runtime defaults */
+#define     PARAM_NAME_MAX_LENGTH           1024L
+#define     MIN_LATENCY                     0L
+#define     MAX_LATENCY                     10000000L
+#define     MIN_LOSS                        0L
+#define     MAX_LOSS                        1000000L
+#define     MIN_LOSS_SEED                   1L
+#define     MAX_LOSS_SEED                   2147483647L
+#define     MIN_SUB_POOL_SIZE               1L
+#define     MAX_SUB_POOL_SIZE               30000L
+#define     SUBSCRIPTIONS_WTABLE_SIZE       1024
+
+
+/*=========================================================================
+  =                Typedefs, structs, enums and globals                   =
+  =========================================================================*/
+
+/*
+ * The process is the network: subscriptions of every loopback transport are
+ * registered here, keyed by subject, so any publisher can reach them.
+ */
+static wtable_t                 gLoopbackSubscriptions  = NULL;
+static unsigned int             gLoopbackTransports     = 0;
+static wthread_static_mutex_t   gLoopbackLock           =
+                                    WSTATIC_MUTEX_INITIALIZER;
+
+/* Owned by the bridge, which starts it before any transport is created */
+extern timerHeap                gLoopbackTimerHeap;
+
+
+/*=========================================================================
+  =                  Private implementation prototypes                    =
+  =========================================================================*/
+
+/**
+ * This is the callback enqueued for each message node. It hands the payload
+ * to the subscription's MAMA queue message and processes it.
+ *
+ * @param queue     The MAMA queue dispatching the event.
+ * @param closure   The memoryNode holding the loopbackMsgNode.
+ */
+static void MAMACALLTYPE
+loopbackBridgeMamaTransportImpl_queueCallback (mamaQueue queue, void* closure);
+
+/**
+ * This is fired on the bridge's timer thread when the oldest delayed delivery
+ * of a transport falls due. Every delivery on a transport carries the same
+ * latency, so the delayed list is in due order: all due nodes are enqueued in
+ * order and the timer is re-armed for the next one, if any.
+ *
+ * @param timer     The transport's delay timer.
+ * @param closure   The loopback transport bridge.
+ */
+static void
+loopbackBridgeMamaTransportImpl_delayCallback (timerElement timer,
+                                               void*        closure);
+
+/**
+ * This converts a delay in nanoseconds to a timer timeout, rounding up so
+ * that the timer never fires before the delay has elapsed.
+ *
+ * @param delay     The delay in nanoseconds.
+ * @param timeout   The timeout to populate.
+ */
+static void
+loopbackBridgeMamaTransportImpl_toTimeout (mama_u64_t       delay,
+                                           struct timeval*  timeout);
+
+/**
+ * This checks, with the registry lock held by the caller, whether the
+ * subscription is still registered against the subject.
+ *
+ * @param subject       The subject key.
+ * @param subscription  The subscription to look for.
+ *
+ * @return Non zero if the subscription is registered.
+ */
+static int
+loopbackBridgeMamaTransportImpl_isSubscribed (
+        const char*             subject,
+        loopbackSubscription*   subscription);
+
+/**
+ * This decides, with the registry lock held by the caller, whether the next
+ * delivery to a subscription of this transport should be dropped. A seeded
+ * xorshift generator is used so that the loss pattern is repeatable.
+ *
+ * @param impl      The loopback transport bridge of the subscription.
+ *
+ * @return Non zero if the delivery is to be dropped.
+ */
+static int
+loopbackBridgeMamaTransportImpl_isLost (loopbackTransportBridge* impl);
+
+static long int
+loopbackBridgeMamaTransportImpl_getParameterAsLong (long        defaultVal,
+                                                    long        minimum,
+                                                    long        maximum,
+                                                    const char* format,
+                                                    ...);
+
+static const char*
+loopbackBridgeMamaTransportImpl_getParameterWithVaList (char*       defaultVal,
+                                                        char*       paramName,
+                                                        const char* format,
+                                                        va_list     arguments);
+
+
+/*=========================================================================
+  =               Public interface implementation functions               =
+  =========================================================================*/
+
+int
+loopbackBridgeMamaTransport_isValid (transportBridge transport)
+{
+    loopbackTransportBridge*     impl   = (loopbackTransportBridge*) transport;
+    int                          status = 0;
+
+    if (NULL != impl)
+    {
+        status = impl->mIsValid;
+    }
+    return status;
+}
+
+mama_status
+loopbackBridgeMamaTransport_destroy (transportBridge transport)
+{
+    loopbackTransportBridge*    impl    = NULL;
+
+    if (NULL == transport)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    impl  = (loopbackTransportBridge*) transport;
+
+    if (0 != impl->mDropped)
+    {
+        mama_log (MAMA_LOG_LEVEL_NORMAL,
+                  "loopbackBridgeMamaTransport_destroy(): "
+                  "%llu messages were dropped on transport %s.",
+                  (unsigned long long) impl->mDropped,
+                  impl->mName);
+    }
+
+    /* The registry goes with the last transport */
+    wthread_static_mutex_lock (&gLoopbackLock);
+    if (0 == --gLoopbackTransports)
+    {
+        /* The subscriptions themselves are owned by their bridges */
+        wtable_free_all_xdata (gLoopbackSubscriptions);
+        wtable_destroy (gLoopbackSubscriptions);
+        gLoopbackSubscriptions = NULL;
+    }
+    wthread_static_mutex_unlock (&gLoopbackLock);
+
+    /* Waits out a running delay callback, so no timer can touch the pool */
+    if (NULL != impl->mDelayTimer)
+    {
+        destroyTimer (gLoopbackTimerHeap, impl->mDelayTimer);
+    }
+
+    /* Any deliveries still delayed go back with the pool */
+    memoryPool_destroy (impl->mLoopbackMsgPool, NULL);
+    wthread_mutex_destroy (&impl->mDelayLock);
+
+    free (impl);
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+loopbackBridgeMamaTransport_create (transportBridge*    result,
+                                    const char*         name,
+                                    mamaTransport       parent)
+{
+    loopbackTransportBridge*    impl       = NULL;
+    int                         poolSize   = 0;
+
+    if (NULL == result || NULL == name || NULL == parent)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    impl = (loopbackTransportBridge*) calloc (1,
+                                              sizeof (loopbackTransportBridge));
+    if (NULL == impl)
+    {
+        return MAMA_STATUS_NOMEM;
+    }
+
+    /* Back reference the MAMA transport */
+    impl->mTransport           = parent;
+    impl->mName                = name;
+
+    mama_log (MAMA_LOG_LEVEL_FINE,
+              "loopbackBridgeMamaTransport_create(): Initializing Transport %s",
+              name);
+
+    /* Latency and loss apply to messages received on this transport */
+    impl->mLatency =
+        (mama_u64_t) loopbackBridgeMamaTransportImpl_getParameterAsLong (
+            DEFAULT_LATENCY,
+            MIN_LATENCY,
+            MAX_LATENCY,
+            "%s.%s.%s",
+            TPORT_PARAM_PREFIX,
+            name,
+            TPORT_PARAM_LATENCY) * 1000;
+
+    impl->mLossPpm =
+        (uint32_t) loopbackBridgeMamaTransportImpl_getParameterAsLong (
+            DEFAULT_LOSS,
+            MIN_LOSS,
+            MAX_LOSS,
+            "%s.%s.%s",
+            TPORT_PARAM_PREFIX,
+            name,
+            TPORT_PARAM_LOSS);
+
+    impl->mLossState =
+        (uint32_t) loopbackBridgeMamaTransportImpl_getParameterAsLong (
+            DEFAULT_LOSS_SEED,
+            MIN_LOSS_SEED,
+            MAX_LOSS_SEED,
+            "%s.%s.%s",
+            TPORT_PARAM_PREFIX,
+            name,
+            TPORT_PARAM_LOSS_SEED);
+
+    /* Set the message pool size for pool initialization later */
+    poolSize =
+        (int) loopbackBridgeMamaTransportImpl_getParameterAsLong (
+            DEFAULT_SUB_POOL_SIZE,
+            MIN_SUB_POOL_SIZE,
+            MAX_SUB_POOL_SIZE,
+            "%s.%s",
+            TPORT_PARAM_PREFIX,
+            TPORT_PARAM_SUB_POOL_SIZE);
+
+    /* Nodes are stretched to fit each payload as they are taken */
+    impl->mLoopbackMsgPool = memoryPool_create (poolSize,
+                                                sizeof (loopbackMsgNode));
+    if (NULL == impl->mLoopbackMsgPool)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "loopbackBridgeMamaTransport_create(): "
+                  "Failed to create msgPool (%s). Exiting.", strerror(errno));
+        free (impl);
+        return MAMA_STATUS_PLATFORM;
+    }
+    wthread_mutex_init (&impl->mDelayLock, NULL);
+
+    wthread_static_mutex_lock (&gLoopbackLock);
+    if (NULL == gLoopbackSubscriptions)
+    {
+        gLoopbackSubscriptions = wtable_create ("gLoopbackSubscriptions",
+                                                SUBSCRIPTIONS_WTABLE_SIZE);
+    }
+    if (NULL != gLoopbackSubscriptions)
+    {
+        gLoopbackTransports++;
+    }
+    wthread_static_mutex_unlock (&gLoopbackLock);
+
+    if (NULL == gLoopbackSubscriptions)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "loopbackBridgeMamaTransport_create(): "
+                  "Failed to create subscription registry.");
+        memoryPool_destroy (impl->mLoopbackMsgPool, NULL);
+        wthread_mutex_destroy (&impl->mDelayLock);
+        free (impl);
+        return MAMA_STATUS_NOMEM;
+    }
+
+    impl->mIsValid = 1;
+
+    *result = (transportBridge) impl;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+loopbackBridgeMamaTransport_forceClientDisconnect (transportBridge*   transports,
+                                                   int                numTransports,
+                                                   const char*        ipAddress,
+                                                   uint16_t           port)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+loopbackBridgeMamaTransport_findConnection (transportBridge*    transports,
+                                            int                 numTransports,
+                                            mamaConnection*     result,
+                                            const char*         ipAddress,
+                                            uint16_t            port)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+loopbackBridgeMamaTransport_getAllConnections (transportBridge*    transports,
+                                               int                 numTransports,
+                                               mamaConnection**    result,
+                                               uint32_t*           len)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+loopbackBridgeMamaTransport_getAllConnectionsForTopic (
+                        transportBridge*    transports,
+                        int                 numTransports,
+                        const char*         topic,
+                        mamaConnection**    result,
+                        uint32_t*           len)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+loopbackBridgeMamaTransport_requestConflation (transportBridge*     transports,
+                                               int                  numTransports)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+loopbackBridgeMamaTransport_requestEndConflation (transportBridge*  transports,
+                                                  int               numTransports)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+loopbackBridgeMamaTransport_getAllServerConnections (
+            transportBridge*        transports,
+            int                     numTransports,
+            mamaServerConnection**  result,
+            uint32_t*               len)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+loopbackBridgeMamaTransport_freeAllServerConnections (
+            transportBridge*        transports,
+            int                     numTransports,
+            mamaServerConnection*   result,
+            uint32_t                len)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+loopbackBridgeMamaTransport_freeAllConnections (transportBridge*    transports,
+                                                int                 numTransports,
+                                                mamaConnection*     result,
+                                                uint32_t            len)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+loopbackBridgeMamaTransport_getNumLoadBalanceAttributes (
+            const char*     name,
+            int*            numLoadBalanceAttributes)
+{
+    if (NULL == numLoadBalanceAttributes || NULL == name)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    *numLoadBalanceAttributes = 0;
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+loopbackBridgeMamaTransport_getLoadBalanceSharedObjectName (
+            const char*     name,
+            const char**    loadBalanceSharedObjectName)
+{
+    if (NULL == loadBalanceSharedObjectName)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    *loadBalanceSharedObjectName = NULL;
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+loopbackBridgeMamaTransport_getLoadBalanceScheme (const char*       name,
+                                                  tportLbScheme*    scheme)
+{
+    if (NULL == scheme || NULL == name)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    *scheme = TPORT_LB_SCHEME_STATIC;
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+loopbackBridgeMamaTransport_sendMsgToConnection (transportBridge    tport,
+                                                 mamaConnection     connection,
+                                                 mamaMsg            msg,
+                                                 const char*        topic)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+loopbackBridgeMamaTransport_isConnectionIntercepted (mamaConnection connection,
+                                                     uint8_t*       result)
+{
+    if (NULL == result)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    *result = 0;
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+loopbackBridgeMamaTransport_installConnectConflateMgr (
+            transportBridge         handle,
+            mamaConflationManager   mgr,
+            mamaConnection          connection,
+            conflateProcessCb       processCb,
+            conflateGetMsgCb        msgCb)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+loopbackBridgeMamaTransport_uninstallConnectConflateMgr (
+            transportBridge         handle,
+            mamaConflationManager   mgr,
+            mamaConnection          connection)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+loopbackBridgeMamaTransport_startConnectionConflation (
+            transportBridge         tport,
+            mamaConflationManager   mgr,
+            mamaConnection          connection)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+loopbackBridgeMamaTransport_getNativeTransport (transportBridge     transport,
+                                                void**              result)
+{
+    loopbackTransportBridge* impl = (loopbackTransportBridge*)transport;
+
+    if (NULL == transport || NULL == result)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+    *result = impl;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+loopbackBridgeMamaTransport_getNativeTransportNamingCtx (transportBridge transport,
+                                                         void**          result)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+
+
+/*=========================================================================
+  =                  Public implementation functions                      =
+  =========================================================================*/
+
+loopbackTransportBridge*
+loopbackBridgeMamaTransportImpl_getTransportBridge (mamaTransport transport)
+{
+    loopbackTransportBridge*    impl    = NULL;
+    mama_status                 status  = MAMA_STATUS_OK;
+
+    status = mamaTransport_getBridgeTransport (transport,
+                                               (transportBridge*) &impl);
+
+    if (MAMA_STATUS_OK != status || NULL == impl)
+    {
+        return NULL;
+    }
+
+    return impl;
+}
+
+mama_status
+loopbackBridgeMamaTransportImpl_registerSubscription (
+        loopbackSubscription*   subscription)
+{
+    loopbackSubscription*   head    = NULL;
+    mama_status             status  = MAMA_STATUS_OK;
+
+    if (NULL == subscription || NULL == subscription->mSubject)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    wthread_static_mutex_lock (&gLoopbackLock);
+
+    /* New subscriptions go to the front of the subject's list */
+    head = (loopbackSubscription*) wtable_lookup (gLoopbackSubscriptions,
+                                                  subscription->mSubject);
+    subscription->mNext = head;
+
+    if (wtable_insert (gLoopbackSubscriptions,
+                       subscription->mSubject,
+                       subscription) < 0)
+    {
+        subscription->mNext = NULL;
+        status = MAMA_STATUS_NOMEM;
+    }
+
+    wthread_static_mutex_unlock (&gLoopbackLock);
+
+    return status;
+}
+
+mama_status
+loopbackBridgeMamaTransportImpl_registerSubscriptions (
+        loopbackSubscription**  subscriptions,
+        size_t                  count)
+{
+    loopbackSubscription*   head    = NULL;
+    size_t                  i       = 0;
+
+    if (NULL == subscriptions)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    wthread_static_mutex_lock (&gLoopbackLock);
+
+    for (i = 0; i < count; i++)
+    {
+        head = (loopbackSubscription*) wtable_lookup (gLoopbackSubscriptions,
+                                                      subscriptions[i]->mSubject);
+        subscriptions[i]->mNext = head;
+
+        if (wtable_insert (gLoopbackSubscriptions,
+                           subscriptions[i]->mSubject,
+                           subscriptions[i]) < 0)
+        {
+            subscriptions[i]->mNext = NULL;
+            break;
+        }
+    }
+
+    wthread_static_mutex_unlock (&gLoopbackLock);
+
+    if (i < count)
+    {
+        /* Back out the ones registered so the caller can free them all */
+        while (i-- > 0)
+        {
+            loopbackBridgeMamaTransportImpl_unregisterSubscription (
+                    subscriptions[i]);
+        }
+        return MAMA_STATUS_NOMEM;
+    }
+
+    return MAMA_STATUS_OK;
+}
+
+void
+loopbackBridgeMamaTransportImpl_unregisterSubscription (
+        loopbackSubscription*   subscription)
+{
+    loopbackSubscription*   head    = NULL;
+    loopbackSubscription**  link    = NULL;
+
+    if (NULL == subscription || NULL == subscription->mSubject)
+    {
+        return;
+    }
+
+    wthread_static_mutex_lock (&gLoopbackLock);
+
+    head = (loopbackSubscription*) wtable_lookup (gLoopbackSubscriptions,
+                                                  subscription->mSubject);
+
+    for (link = &head; NULL != *link; link = &(*link)->mNext)
+    {
+        if (*link == subscription)
+        {
+            *link = subscription->mNext;
+            break;
+        }
+    }
+
+    if (NULL == head)
+    {
+        wtable_remove (gLoopbackSubscriptions, subscription->mSubject);
+    }
+    else
+    {
+        wtable_insert (gLoopbackSubscriptions, subscription->mSubject, head);
+    }
+
+    subscription->mNext = NULL;
+
+    wthread_static_mutex_unlock (&gLoopbackLock);
+}
+
+mama_status
+loopbackBridgeMamaTransportImpl_deliver (const char*        subject,
+                                         loopbackMsgType    type,
+                                         const char*        inbox,
+                                         mamaMsg            msg)
+{
+    const void*                 buffer       = NULL;
+    mama_size_t                 bufferLen    = 0;
+    mamaPayloadType             payloadType  = MAMA_PAYLOAD_UNKNOWN;
+    size_t                      subjectLen   = 0;
+    size_t                      inboxLen     = 0;
+    loopbackSubscription*       subscription = NULL;
+    loopbackTransportBridge*    transport    = NULL;
+    memoryNode*                 pending      = NULL;
+    memoryNode*                 node         = NULL;
+    loopbackMsgNode*            msgNode      = NULL;
+    mama_u64_t                  now          = 0;
+    int                         isLatency    = mamaLatency_isEnabled ();
+    int                         isArming     = 0;
+    struct timeval              timeout;
+    mama_status                 status       = MAMA_STATUS_OK;
+
+    if (NULL == subject || NULL == msg)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    subjectLen = strlen (subject) + 1;
+    inboxLen   = (NULL == inbox ? 0 : strlen (inbox)) + 1;
+    if (subjectLen > MAX_SUBJECT_LENGTH || inboxLen > MAX_SUBJECT_LENGTH)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "loopbackBridgeMamaTransportImpl_deliver(): "
+                  "Subject exceeds %d characters.",
+                  MAX_SUBJECT_LENGTH - 1);
+        return MAMA_STATUS_INVALID_ARG;
+    }
+
+    mamaMsg_getPayloadType (msg, &payloadType);
+
+    status = mamaMsg_getByteBuffer (msg, &buffer, &bufferLen);
+    if (MAMA_STATUS_OK != status)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "loopbackBridgeMamaTransportImpl_deliver(): "
+                  "Could not get byte buffer for %s [%s]",
+                  subject,
+                  mamaStatus_stringForStatus (status));
+        return status;
+    }
+
+    wthread_static_mutex_lock (&gLoopbackLock);
+
+    for (subscription = (loopbackSubscription*) wtable_lookup (
+                                gLoopbackSubscriptions, subject);
+         NULL != subscription;
+         subscription = subscription->mNext)
+    {
+        transport = (loopbackTransportBridge*) subscription->mTransport;
+
+        if (1 != subscription->mIsNotMuted)
+        {
+            mama_log (MAMA_LOG_LEVEL_FINEST,
+                      "loopbackBridgeMamaTransportImpl_deliver(): "
+                      "muted - not queueing update for symbol %s",
+                      subject);
+            continue;
+        }
+
+        if (0 != transport->mLossPpm
+            && loopbackBridgeMamaTransportImpl_isLost (transport))
+        {
+            transport->mDropped++;
+            continue;
+        }
+
+        node = memoryPool_getNode (transport->mLoopbackMsgPool,
+                                   sizeof (loopbackMsgNode) + bufferLen);
+        if (NULL == node)
+        {
+            mama_log (MAMA_LOG_LEVEL_ERROR,
+                      "loopbackBridgeMamaTransportImpl_deliver(): "
+                      "Error getting msgNode from msgPool (%s).",
+                      strerror(errno));
+            status = MAMA_STATUS_NOMEM;
+            break;
+        }
+
+        /* The clock is only read when something needs the time */
+        if (0 == now && (0 != transport->mLatency || isLatency))
+        {
+            now = mamaLatency_getTimestamp ();
+        }
+
+        msgNode = (loopbackMsgNode*) node->mNodeBuffer;
+        msgNode->mTransport    = transport;
+        msgNode->mSubscription = subscription;
+        msgNode->mMsgType      = type;
+        msgNode->mPayloadType  = payloadType;
+        msgNode->mPayloadLen   = (uint32_t) bufferLen;
+        msgNode->mDueTime      = transport->mLatency ? now + transport->mLatency
+                                                     : 0;
+        msgNode->mReceiveTime  = isLatency ? now : 0;
+        msgNode->mEnqueueTime  = isLatency ? now : 0;
+        memcpy (msgNode->mSubject, subject, subjectLen);
+        if (NULL == inbox)
+        {
+            msgNode->mInbox[0] = '\0';
+        }
+        else
+        {
+            memcpy (msgNode->mInbox, inbox, inboxLen);
+        }
+        memcpy (msgNode + 1, buffer, bufferLen);
+
+        if (0 == transport->mLatency)
+        {
+            node->mNext = pending;
+            pending     = node;
+            continue;
+        }
+
+        /* Held back, in order, until the transport's timer releases it */
+        node->mNext = NULL;
+        wthread_mutex_lock (&transport->mDelayLock);
+        if (NULL == transport->mDelayedTail)
+        {
+            transport->mDelayedHead = node;
+        }
+        else
+        {
+            transport->mDelayedTail->mNext = node;
+        }
+        transport->mDelayedTail = node;
+        isArming = !transport->mIsDelayArmed;
+        transport->mIsDelayArmed = 1;
+        wthread_mutex_unlock (&transport->mDelayLock);
+
+        if (!isArming)
+        {
+            continue;
+        }
+
+        /* The delay callback never waits on the registry lock, so the timer
+         * heap may be taken here */
+        loopbackBridgeMamaTransportImpl_toTimeout (transport->mLatency,
+                                                   &timeout);
+        if (0 != (NULL == transport->mDelayTimer
+                  ? createTimer (&transport->mDelayTimer,
+                                 gLoopbackTimerHeap,
+                                 loopbackBridgeMamaTransportImpl_delayCallback,
+                                 &timeout,
+                                 transport)
+                  : resetTimer (gLoopbackTimerHeap,
+                                transport->mDelayTimer,
+                                &timeout)))
+        {
+            mama_log (MAMA_LOG_LEVEL_ERROR,
+                      "loopbackBridgeMamaTransportImpl_deliver(): "
+                      "Failed to arm delay timer on transport %s.",
+                      transport->mName);
+            wthread_mutex_lock (&transport->mDelayLock);
+            transport->mIsDelayArmed = 0;
+            wthread_mutex_unlock (&transport->mDelayLock);
+            status = MAMA_STATUS_PLATFORM;
+        }
+    }
+
+    wthread_static_mutex_unlock (&gLoopbackLock);
+
+    /* Within this loop, queue callbacks release the pool messages */
+    while (NULL != pending)
+    {
+        node    = pending;
+        pending = node->mNext;
+        msgNode = (loopbackMsgNode*) node->mNodeBuffer;
+
+        loopbackBridgeMamaQueue_enqueueEvent (
+                (queueBridge) msgNode->mSubscription->mLoopbackQueue,
+                loopbackBridgeMamaTransportImpl_queueCallback,
+                node);
+    }
+
+    return status;
+}
+
+mama_status
+loopbackBridgeMamaTransportImpl_generateSubjectKey (const char*  root,
+                                                    const char*  source,
+                                                    const char*  topic,
+                                                    const char** keyTarget)
+{
+    char        subject[MAX_SUBJECT_LENGTH];
+    const char* parts[3];
+    size_t      written = 0;
+    int         i       = 0;
+
+    if (NULL == keyTarget)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    parts[0] = root;
+    parts[1] = source;
+    parts[2] = topic;
+    subject[0] = '\0';
+
+    /* Join whichever parts are present with periods */
+    for (i = 0; i < 3; i++)
+    {
+        if (NULL == parts[i] || written >= sizeof (subject))
+        {
+            continue;
+        }
+        written += snprintf (subject + written,
+                             sizeof (subject) - written,
+                             0 == written ? "%s" : ".%s",
+                             parts[i]);
+    }
+
+    if (written >= sizeof (subject))
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "loopbackBridgeMamaTransportImpl_generateSubjectKey(): "
+                  "Subject exceeds %d characters.",
+                  MAX_SUBJECT_LENGTH - 1);
+        return MAMA_STATUS_INVALID_ARG;
+    }
+
+    /* Caller is responsible for destroying */
+    *keyTarget = strdup (subject);
+    if (NULL == *keyTarget)
+    {
+        return MAMA_STATUS_NOMEM;
+    }
+
+    return MAMA_STATUS_OK;
+}
+
+
+/*=========================================================================
+  =                  Private implementation functions                     =
+  =========================================================================*/
+
+void MAMACALLTYPE
+loopbackBridgeMamaTransportImpl_queueCallback (mamaQueue queue, void* closure)
+{
+    memoryNode*              node            = (memoryNode*) closure;
+    loopbackMsgNode*         msgNode         = NULL;
+    mama_status              status          = MAMA_STATUS_OK;
+    mamaMsg                  tmpMsg          = NULL;
+    msgBridge                bridgeMsg       = NULL;
+    memoryPool*              pool            = NULL;
+    loopbackSubscription*    subscription    = NULL;
+    int                      isSubscribed    = 0;
+
+    if (NULL == node)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "loopbackBridgeMamaTransportImpl_queueCallback(): "
+                  "Called with NULL msgNode (destroyed?)");
+        return;
+    }
+    msgNode      = (loopbackMsgNode*) node->mNodeBuffer;
+    pool         = node->mPool;
+    subscription = msgNode->mSubscription;
+
+    /* The subscription may have been destroyed since this was enqueued */
+    wthread_static_mutex_lock (&gLoopbackLock);
+    isSubscribed = loopbackBridgeMamaTransportImpl_isSubscribed (
+                       msgNode->mSubject,
+                       subscription);
+    wthread_static_mutex_unlock (&gLoopbackLock);
+
+    if (!isSubscribed)
+    {
+        mama_log (MAMA_LOG_LEVEL_FINE,
+                  "loopbackBridgeMamaTransportImpl_queueCallback(): "
+                  "Subscriber has been unregistered since msg was enqueued.");
+        memoryPool_returnNode (pool, node);
+        return;
+    }
+
+    /* Make sure that the subscription is processing messages */
+    if (1 != subscription->mIsNotMuted)
+    {
+        mama_log (MAMA_LOG_LEVEL_FINEST,
+                  "loopbackBridgeMamaTransportImpl_queueCallback(): "
+                  "Skipping update - subscription %p is muted.", subscription);
+        memoryPool_returnNode (pool, node);
+        return;
+    }
+
+    /* This is the reuseable message stored on the associated MamaQueue */
+    tmpMsg = mamaQueueImpl_getMsg (subscription->mMamaQueue);
+    if (NULL == tmpMsg)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "loopbackBridgeMamaTransportImpl_queueCallback(): "
+                  "Could not get cached mamaMsg from event queue.");
+        memoryPool_returnNode (pool, node);
+        return;
+    }
+
+    /* Get the bridge message from the mamaMsg */
+    status = mamaMsgImpl_getBridgeMsg (tmpMsg, &bridgeMsg);
+    if (MAMA_STATUS_OK != status)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "loopbackBridgeMamaTransportImpl_queueCallback(): "
+                  "Could not get bridge message from cached "
+                  "queue mamaMsg [%s]", mamaStatus_stringForStatus (status));
+        memoryPool_returnNode (pool, node);
+        return;
+    }
+
+    /* The payload was copied directly after the node when published */
+    status = mamaMsgImpl_setMsgBuffer (tmpMsg,
+                                       (const void*) (msgNode + 1),
+                                       msgNode->mPayloadLen,
+                                       (char) msgNode->mPayloadType);
+    if (MAMA_STATUS_OK != status)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "loopbackBridgeMamaTransportImpl_queueCallback(): "
+                  "Could not set msg buffer [%s]",
+                  mamaStatus_stringForStatus (status));
+    }
+    else
+    {
+        loopbackBridgeMamaMsgImpl_setMsgType   (bridgeMsg, msgNode->mMsgType);
+        loopbackBridgeMamaMsgImpl_setInboxName (bridgeMsg, msgNode->mInbox);
+
+        if (0 != msgNode->mReceiveTime)
+        {
+            mamaMsgImpl_setStageTime (tmpMsg, MAMA_LATENCY_STAGE_RECEIVE,
+                                      msgNode->mReceiveTime);
+            mamaMsgImpl_setStageTime (tmpMsg, MAMA_LATENCY_STAGE_ENQUEUE,
+                                      msgNode->mEnqueueTime);
+        }
+
+        /* Process the message as normal */
+        status = mamaSubscription_processMsg (subscription->mMamaSubscription,
+                                              tmpMsg);
+        if (MAMA_STATUS_OK != status)
+        {
+            mama_log (MAMA_LOG_LEVEL_ERROR,
+                      "loopbackBridgeMamaTransportImpl_queueCallback(): "
+                      "mamaSubscription_processMsg() failed. [%d]", status);
+        }
+    }
+
+    /* No matter what happened we need to clean up */
+    memoryPool_returnNode (pool, node);
+}
+
+void
+loopbackBridgeMamaTransportImpl_delayCallback (timerElement timer,
+                                               void*        closure)
+{
+    loopbackTransportBridge*    transport = (loopbackTransportBridge*) closure;
+    memoryNode*                 due       = NULL;
+    memoryNode*                 last      = NULL;
+    memoryNode*                 node      = NULL;
+    loopbackMsgNode*            msgNode   = NULL;
+    mama_u64_t                  now       = mamaLatency_getTimestamp ();
+    mama_u64_t                  next      = 0;
+    struct timeval              timeout;
+
+    wthread_mutex_lock (&transport->mDelayLock);
+    due = transport->mDelayedHead;
+    for (node = due; NULL != node; node = node->mNext)
+    {
+        msgNode = (loopbackMsgNode*) node->mNodeBuffer;
+        if (msgNode->mDueTime > now)
+        {
+            next = msgNode->mDueTime;
+            break;
+        }
+        last = node;
+    }
+
+    /* Detach the due nodes, and stay armed while any remain */
+    if (NULL == last)
+    {
+        due = NULL;
+    }
+    else
+    {
+        transport->mDelayedHead = last->mNext;
+        last->mNext             = NULL;
+    }
+    if (NULL == transport->mDelayedHead)
+    {
+        transport->mDelayedTail  = NULL;
+        transport->mIsDelayArmed = 0;
+    }
+    wthread_mutex_unlock (&transport->mDelayLock);
+
+    /* The heap lock is recursive, so the timer may be re-armed in here */
+    if (0 != next)
+    {
+        loopbackBridgeMamaTransportImpl_toTimeout (next - now, &timeout);
+        if (0 != resetTimer (gLoopbackTimerHeap, timer, &timeout))
+        {
+            mama_log (MAMA_LOG_LEVEL_ERROR,
+                      "loopbackBridgeMamaTransportImpl_delayCallback(): "
+                      "Failed to re-arm delay timer on transport %s.",
+                      transport->mName);
+        }
+    }
+
+    while (NULL != due)
+    {
+        node    = due;
+        due     = node->mNext;
+        msgNode = (loopbackMsgNode*) node->mNodeBuffer;
+
+        if (0 != msgNode->mEnqueueTime)
+        {
+            msgNode->mEnqueueTime = now;
+        }
+
+        loopbackBridgeMamaQueue_enqueueEvent (
+                (queueBridge) msgNode->mSubscription->mLoopbackQueue,
+                loopbackBridgeMamaTransportImpl_queueCallback,
+                node);
+    }
+}
+
+void
+loopbackBridgeMamaTransportImpl_toTimeout (mama_u64_t       delay,
+                                           struct timeval*  timeout)
+{
+    delay = (delay + 999) / 1000;
+
+    timeout->tv_sec  = (time_t) (delay / 1000000);
+    timeout->tv_usec = (long) (delay % 1000000);
+}
+
+int
+loopbackBridgeMamaTransportImpl_isSubscribed (
+        const char*             subject,
+        loopbackSubscription*   subscription)
+{
+    loopbackSubscription* current = NULL;
+
+    if (NULL == gLoopbackSubscriptions)
+    {
+        return 0;
+    }
+
+    for (current = (loopbackSubscription*) wtable_lookup (
+                           gLoopbackSubscriptions, subject);
+         NULL != current;
+         current = current->mNext)
+    {
+        if (current == subscription)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int
+loopbackBridgeMamaTransportImpl_isLost (loopbackTransportBridge* impl)
+{
+    uint32_t x = impl->mLossState;
+
+    /* xorshift32 - cheap, and the same seed gives the same losses */
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    impl->mLossState = x;
+
+    return (x % 1000000) < impl->mLossPpm;
+}
+
+long int loopbackBridgeMamaTransportImpl_getParameterAsLong (
+                                                    long defaultVal,
+                                                    long minimum,
+                                                    long maximum,
+                                                    const char* format, ...)
+{
+    const char* returnVal     = NULL;
+    long        returnLong    = 0;
+    char        paramDefault[PARAM_NAME_MAX_LENGTH];
+    char        paramName[PARAM_NAME_MAX_LENGTH];
+
+    /* Create list for storing the parameters passed in */
+    va_list arguments;
+
+    /* Populate list with arguments passed in */
+    va_start(arguments, format);
+
+    snprintf (paramDefault, PARAM_NAME_MAX_LENGTH, "%ld", defaultVal);
+
+    returnVal = loopbackBridgeMamaTransportImpl_getParameterWithVaList (paramDefault,
+                                                                        paramName,
+                                                                        format,
+                                                                        arguments);
+
+    /* Translate the returned string to a long */
+    returnLong = atol (returnVal);
+
+    if (returnLong < minimum)
+    {
+        mama_log (MAMA_LOG_LEVEL_FINER,
+                "loopbackBridgeMamaTransportImpl_getParameterAsLong: "
+                "Value for %s too small (%ld) - reverting to: [%ld]",
+                paramName,
+                returnLong,
+                minimum);
+        returnLong = minimum;
+    }
+    else if (returnLong > maximum)
+    {
+        mama_log (MAMA_LOG_LEVEL_FINER,
+                "loopbackBridgeMamaTransportImpl_getParameterAsLong: "
+                "Value for %s too large (%ld) - reverting to: [%ld]",
+                paramName,
+                returnLong,
+                maximum);
+        returnLong = maximum;
+    }
+    /* These will be equal if unchanged */
+    else if (returnVal == paramDefault)
+    {
+        mama_log (MAMA_LOG_LEVEL_FINER,
+                  "loopbackBridgeMamaTransportImpl_getParameterAsLong: "
+                  "parameter [%s]: [%ld] (Default)",
+                  paramName, returnLong);
+    }
+    else
+    {
+        mama_log (MAMA_LOG_LEVEL_FINER,
+                  "loopbackBridgeMamaTransportImpl_getParameterAsLong: "
+                  "parameter [%s]: [%ld] (User Defined)",
+                  paramName, returnLong);
+    }
+
+    return returnLong;
+}
+
+const char* loopbackBridgeMamaTransportImpl_getParameterWithVaList (
+                                                char* defaultVal,
+                                                char* paramName,
+                                                const char* format,
+                                                va_list arguments)
+{
+    const char* property = NULL;
+
+    /* Create the complete transport property string */
+    vsnprintf (paramName, PARAM_NAME_MAX_LENGTH,
+               format, arguments);
+
+    /* Get the property out for analysis */
+    property = properties_Get (mamaInternal_getProperties (),
+                               paramName);
+
+    /* Properties will return NULL if parameter is not specified in configs */
+    if (property == NULL)
+    {
+        property = defaultVal;
+    }
+
+    return property;
+}
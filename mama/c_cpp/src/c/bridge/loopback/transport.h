@@ -0,0 +1,131 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#ifndef MAMA_BRIDGE_LOOPBACK_TRANSPORT_H__
+#define MAMA_BRIDGE_LOOPBACK_TRANSPORT_H__
+
+
+/*=========================================================================
+  =                             Includes                                  =
+  =========================================================================*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <mama/mama.h>
+#include <bridge.h>
+#include "loopbackdefs.h"
+
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * This is a simple convenience function to return a loopbackTransportBridge
+ * pointer based on the provided mamaTransport.
+ *
+ * @param transport     The mamaTransport to extract the bridge transport from.
+ *
+ * @return loopbackTransportBridge* associated with the mamaTransport.
+ */
+loopbackTransportBridge*
+loopbackBridgeMamaTransportImpl_getTransportBridge (mamaTransport transport);
+
+/**
+ * This will register the subscription's interest in its subject so that
+ * matching messages published by any loopback transport in the process are
+ * enqueued to it.
+ *
+ * @param subscription  The subscription to register.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+mama_status
+loopbackBridgeMamaTransportImpl_registerSubscription (
+        loopbackSubscription*   subscription);
+
+/**
+ * This will register the interest of several subscriptions at once, taking
+ * the registry lock a single time. Either all of them are registered or, on
+ * failure, none of them are.
+ *
+ * @param subscriptions The subscriptions to register.
+ * @param count         The number of subscriptions.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+mama_status
+loopbackBridgeMamaTransportImpl_registerSubscriptions (
+        loopbackSubscription**  subscriptions,
+        size_t                  count);
+
+/**
+ * This will remove the subscription's interest in its subject. Messages
+ * already enqueued for it are discarded when they are dispatched.
+ *
+ * @param subscription  The subscription to unregister.
+ */
+void
+loopbackBridgeMamaTransportImpl_unregisterSubscription (
+        loopbackSubscription*   subscription);
+
+/**
+ * This hands a copy of the message's encoded payload to the queue of each
+ * subscription registered against the subject. Artificial latency and loss
+ * are applied according to each subscribing transport's configuration.
+ *
+ * @param subject       The subject key to publish on.
+ * @param type          The type of message being published.
+ * @param inbox         The inbox subject for requests, otherwise NULL.
+ * @param msg           The MAMA message to publish.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+mama_status
+loopbackBridgeMamaTransportImpl_deliver (const char*        subject,
+                                         loopbackMsgType    type,
+                                         const char*        inbox,
+                                         mamaMsg            msg);
+
+/**
+ * This is a convenience function to build a subject key from its component
+ * parts in the same way on both the publishing and subscribing side.
+ *
+ * @param root          The root (e.g. _MD) or NULL.
+ * @param source        The source (symbol namespace) or NULL.
+ * @param topic         The topic (symbol) or NULL.
+ * @param keyTarget     Populated with a newly allocated key which the caller
+ *                      is responsible for freeing.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+mama_status
+loopbackBridgeMamaTransportImpl_generateSubjectKey (const char*  root,
+                                                    const char*  source,
+                                                    const char*  topic,
+                                                    const char** keyTarget);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* MAMA_BRIDGE_LOOPBACK_TRANSPORT_H__*/
@@ -83,6 +83,10 @@ void qpidBridge_createImpl (mamaBridge* result)
     /* Populate the bridge impl structure with the function pointers */
     INITIALIZE_BRIDGE (bridge, qpid);
 
+    /* Optional functions not covered by INITIALIZE_BRIDGE */
+    bridge->bridgeMamaQueueEnableResidency =
+                    qpidBridgeMamaQueue_enableResidency;
+
     /* Return the newly created bridge */
     *result = (mamaBridge) bridge;
 
@@ -405,6 +405,23 @@ extern mama_status
 qpidBridgeMamaQueue_setLowWatermark (queueBridge queue,
                                      size_t      lowWatermark);
 
+/**
+ * This will turn on or off residency measurement for the queue, in which
+ * each event is stamped as it is enqueued and the time it spent queued is
+ * passed to mamaQueueImpl_recordResidency as it is dispatched.
+ *
+ *
+ * Requirement:        Optional
+ *
+ * @param queue        The queue bridge implementation structure.
+ * @param enable       Non-zero to measure residency, zero to stop.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+extern mama_status
+qpidBridgeMamaQueue_enableResidency (queueBridge queue,
+                                     int         enable);
+
 
 /*=========================================================================
   =                    Functions for the mamaTransport                    =
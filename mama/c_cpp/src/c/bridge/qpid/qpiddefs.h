@@ -116,6 +116,9 @@ typedef struct qpidSubscription_
     int                 mIsTportDisconnected;
     pn_message_t*       mMsg;
     const char*         mEndpointIdentifier;
+    /* Update still on the queue which further updates are merged into while
+     * the queue is conflating, guarded by the transport's mConflateLock */
+    memoryNode*         mConflatedNode;
 } qpidSubscription;
 
 typedef struct qpidTransportBridge_
@@ -140,6 +143,9 @@ typedef struct qpidTransportBridge_
     endpointPool_t      mPubEndpoints;
     qpidTransportType   mQpidTransportType;
     wtable_t            mKnownSources;
+    /* Conflation of updates for queues above their high watermark */
+    wthread_mutex_t     mConflateLock;
+    mamaMsg             mConflateMsg;
 } qpidTransportBridge;
 
 struct qpidMsgNode_
@@ -148,6 +154,11 @@ struct qpidMsgNode_
   qpidMsgType           mMsgType;
   qpidSubscription*     mQpidSubscription;
   qpidTransportBridge*  mQpidTransportBridge;
+  /* Latency stamps, zero unless mamaLatency_isEnabled */
+  mama_u64_t            mReceiveTime;
+  mama_u64_t            mEnqueueTime;
+  /* Set instead of using mMsg when updates have been conflated into it */
+  mamaMsg               mConflated;
 };
 
 #if defined(__cplusplus)
@@ -80,6 +80,16 @@ typedef struct qpidQueueBridge {
 static void
 qpidBridgeMamaQueueImpl_checkWatermarks (qpidQueueBridge* impl);
 
+/**
+ * This is the wombatQueue residency callback, installed while residency is
+ * enabled, which hands each event's residency on to the parent mamaQueue.
+ *
+ * @param residency The nanoseconds the event spent queued.
+ * @param closure   The parent mamaQueue.
+ */
+static void MAMACALLTYPE
+qpidBridgeMamaQueueImpl_residencyCb (uint64_t residency, void* closure);
+
 
 /*=========================================================================
   =               Public interface implementation functions               =
@@ -493,6 +503,26 @@ qpidBridgeMamaQueue_setLowWatermark (queueBridge    queue,
     return MAMA_STATUS_OK;
 }
 
+mama_status
+qpidBridgeMamaQueue_enableResidency (queueBridge queue,
+                                     int         enable)
+{
+    qpidQueueBridge* impl = (qpidQueueBridge*) queue;
+
+    /* Perform null checks and return if null arguments provided */
+    CHECK_QUEUE(impl);
+
+    /* Stamp events on the underlying queue, with the clock used for the
+     * latency stages, only while enabled */
+    wombatQueue_setResidencyCb (impl->mQueue,
+                                mamaLatency_getTimestamp,
+                                enable ? qpidBridgeMamaQueueImpl_residencyCb
+                                       : NULL,
+                                impl->mParent);
+
+    return MAMA_STATUS_OK;
+}
+
 
 /*=========================================================================
   =                  Private implementation functions                     =
@@ -520,3 +550,8 @@ qpidBridgeMamaQueueImpl_checkWatermarks (qpidQueueBridge* impl)
     }
 }
 
+void MAMACALLTYPE
+qpidBridgeMamaQueueImpl_residencyCb (uint64_t residency, void* closure)
+{
+    mamaQueueImpl_recordResidency ((mamaQueue) closure, residency);
+}
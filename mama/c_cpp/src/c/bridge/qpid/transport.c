@@ -130,6 +130,37 @@ qpidBridgeMamaTransportImpl_stop (qpidTransportBridge* impl);
 static void MAMACALLTYPE
 qpidBridgeMamaTransportImpl_queueCallback (mamaQueue queue, void* closure);
 
+/**
+ * This is a local function called on the dispatch thread before an update is
+ * enqueued for a subscription. While the subscription's queue is conflating,
+ * the update is merged into the one still waiting on the queue for that
+ * subscription, or if there is none, becomes the one later updates are
+ * merged into. Its wConflateCount is kept as the number of updates merged.
+ * Messages of any other type are never merged and end the merging into the
+ * update ahead of them.
+ *
+ * @param impl         The qpid transport bridge receiving the update.
+ * @param subscription The subscription the update is for.
+ * @param node         The memory node holding the update.
+ *
+ * @return Non zero if the update was merged and need not be enqueued.
+ */
+static int
+qpidBridgeMamaTransportImpl_conflate (qpidTransportBridge* impl,
+                                      qpidSubscription*    subscription,
+                                      memoryNode*          node);
+
+/**
+ * Get the number of updates a message stands for, from its wConflateCount
+ * field if it has one and one otherwise.
+ *
+ * @param msg The decoded update.
+ *
+ * @return The conflate count.
+ */
+static mama_u16_t
+qpidBridgeMamaTransportImpl_getConflateCount (mamaMsg msg);
+
 /**
  * This is a local function for parsing long configuration parameters from the
  * MAMA properties object, and supports minimum and maximum limits as well
@@ -303,6 +334,12 @@ qpidBridgeMamaTransport_destroy (transportBridge transport)
     /* Finally, destroy the wtable */
     wtable_destroy (impl->mKnownSources);
 
+    if (NULL != impl->mConflateMsg)
+    {
+        mamaMsg_destroy (impl->mConflateMsg);
+    }
+    wthread_mutex_destroy (&impl->mConflateLock);
+
     if (NULL != impl->mReplyAddress)
     {
         free ((void*) impl->mReplyAddress);
@@ -347,6 +384,8 @@ qpidBridgeMamaTransport_create (transportBridge*    result,
     impl->mName                = name;
     impl->mKnownSources        = wtable_create ("mKnownSources",
                                                 KNOWN_SOURCES_WTABLE_SIZE);
+    impl->mConflateMsg         = NULL;
+    wthread_mutex_init (&impl->mConflateLock, NULL);
 
     mama_log (MAMA_LOG_LEVEL_FINE,
               "qpidBridgeMamaTransport_create(): Initializing Transport %s",
@@ -1039,6 +1078,17 @@ qpidBridgeMamaTransportImpl_queueCallback (mamaQueue queue, void* closure)
         return;
     }
 
+    /* Once dispatching has started no more updates may be merged into it */
+    if (NULL != msgNode->mConflated)
+    {
+        wthread_mutex_lock (&impl->mConflateLock);
+        if (subscription->mConflatedNode == node)
+        {
+            subscription->mConflatedNode = NULL;
+        }
+        wthread_mutex_unlock (&impl->mConflateLock);
+    }
+
     /* Make sure that the subscription is processing messages */
     if (1 != subscription->mIsNotMuted)
     {
@@ -1048,6 +1098,24 @@ qpidBridgeMamaTransportImpl_queueCallback (mamaQueue queue, void* closure)
         return;
     }
 
+    /* Conflated updates have already been decoded and merged */
+    if (NULL != msgNode->mConflated)
+    {
+        status = mamaSubscription_processMsg (subscription->mMamaSubscription,
+                                              msgNode->mConflated);
+        if (MAMA_STATUS_OK != status)
+        {
+            mama_log (MAMA_LOG_LEVEL_ERROR,
+                      "qpidBridgeMamaTransportImpl_queueCallback(): "
+                      "mamaSubscription_processMsg() failed. [%d]", status);
+        }
+
+        mamaMsg_destroy (msgNode->mConflated);
+        msgNode->mConflated = NULL;
+        memoryPool_returnNode (pool, node);
+        return;
+    }
+
     /* This is the reuseable message stored on the associated MamaQueue */
     tmpMsg = mamaQueueImpl_getMsg (subscription->mMamaQueue);
     if (NULL == tmpMsg)
@@ -1080,6 +1148,14 @@ qpidBridgeMamaTransportImpl_queueCallback (mamaQueue queue, void* closure)
     }
     else
     {
+        if (0 != msgNode->mReceiveTime)
+        {
+            mamaMsgImpl_setStageTime (tmpMsg, MAMA_LATENCY_STAGE_RECEIVE,
+                                      msgNode->mReceiveTime);
+            mamaMsgImpl_setStageTime (tmpMsg, MAMA_LATENCY_STAGE_ENQUEUE,
+                                      msgNode->mEnqueueTime);
+        }
+
         /* Process the message as normal */
         status = mamaSubscription_processMsg (subscription->mMamaSubscription,
                                               tmpMsg);
@@ -1313,6 +1389,9 @@ void* qpidBridgeMamaTransportImpl_dispatchThread (void* closure)
                 return NULL;
             }
 
+            msgNode->mReceiveTime = mamaLatency_isEnabled ()
+                                  ? mamaLatency_getTimestamp () : 0;
+
             /* Get the subject which contains the topic */
             subject    = pn_message_get_subject (msgNode->mMsg);
             properties = pn_message_properties  (msgNode->mMsg);
@@ -1457,12 +1536,23 @@ void* qpidBridgeMamaTransportImpl_dispatchThread (void* closure)
                     tmpMsgNode->mMsgType = msgNode->mMsgType;
                     tmpMsgNode->mQpidSubscription = subscription;
                     tmpMsgNode->mQpidTransportBridge = impl;
+                    tmpMsgNode->mReceiveTime = msgNode->mReceiveTime;
+                    tmpMsgNode->mEnqueueTime = msgNode->mReceiveTime
+                                             ? mamaLatency_getTimestamp () : 0;
 
                     pn_data_copy (pn_message_body (tmpMsgNode->mMsg),
                                   pn_message_body (msgNode->mMsg));
                     pn_data_copy (pn_message_properties (tmpMsgNode->mMsg),
                                   pn_message_properties (msgNode->mMsg));
 
+                    if (qpidBridgeMamaTransportImpl_conflate (impl,
+                                                              subscription,
+                                                              tmpNode))
+                    {
+                        memoryPool_returnNode (impl->mQpidMsgPool, tmpNode);
+                        continue;
+                    }
+
                     qpidBridgeMamaQueue_enqueueEvent (
                             (queueBridge) subscription->mQpidQueue,
                             qpidBridgeMamaTransportImpl_queueCallback,
@@ -1476,6 +1566,17 @@ void* qpidBridgeMamaTransportImpl_dispatchThread (void* closure)
                 {
                     msgNode->mQpidSubscription = subscription;
                     msgNode->mQpidTransportBridge = impl;
+                    msgNode->mEnqueueTime = msgNode->mReceiveTime
+                                          ? mamaLatency_getTimestamp () : 0;
+
+                    if (qpidBridgeMamaTransportImpl_conflate (impl,
+                                                              subscription,
+                                                              node))
+                    {
+                        memoryPool_returnNode (impl->mQpidMsgPool, node);
+                        continue;
+                    }
+
                     qpidBridgeMamaQueue_enqueueEvent (
                             (queueBridge) subscription->mQpidQueue,
                             qpidBridgeMamaTransportImpl_queueCallback,
@@ -1498,6 +1599,140 @@ qpidBridgeMamaTransportImpl_msgNodeFree (memoryPool* pool, memoryNode* node)
     {
         pn_message_free (msgNode->mMsg);
     }
+    if (NULL != msgNode->mConflated)
+    {
+        mamaMsg_destroy (msgNode->mConflated);
+    }
+}
+
+int
+qpidBridgeMamaTransportImpl_conflate (qpidTransportBridge* impl,
+                                      qpidSubscription*    subscription,
+                                      memoryNode*          node)
+{
+    qpidMsgNode*    msgNode     = (qpidMsgNode*) node->mNodeBuffer;
+    qpidMsgNode*    pending     = NULL;
+    msgBridge       bridgeMsg   = NULL;
+    mama_status     status      = MAMA_STATUS_OK;
+    int             conflated   = 0;
+    mama_u32_t      count       = 0;
+
+    if (QPID_MSG_PUB_SUB != msgNode->mMsgType
+        || 0 == mamaQueueImpl_isConflating (subscription->mMamaQueue))
+    {
+        return 0;
+    }
+
+    wthread_mutex_lock (&impl->mConflateLock);
+
+    /* The queue's reusable message belongs to the dispatching thread, so
+     * updates are decoded into the transport's own message here */
+    if (NULL == impl->mConflateMsg)
+    {
+        status = mamaMsgImpl_createForPayload (&impl->mConflateMsg,
+                                               NULL, NULL, 0);
+        if (MAMA_STATUS_OK == status)
+        {
+            status = mamaMsgImpl_setBridgeImpl (
+                         impl->mConflateMsg,
+                         mamaQueueImpl_getBridgeImpl (subscription->mMamaQueue));
+        }
+        if (MAMA_STATUS_OK == status)
+        {
+            status = mamaMsgImpl_setMessageOwner (impl->mConflateMsg, 0);
+        }
+    }
+
+    if (MAMA_STATUS_OK == status)
+    {
+        status = mamaMsgImpl_getBridgeMsg (impl->mConflateMsg, &bridgeMsg);
+    }
+    if (MAMA_STATUS_OK == status)
+    {
+        status = qpidBridgeMsgCodec_unpack (bridgeMsg,
+                                            impl->mConflateMsg,
+                                            msgNode->mMsg);
+    }
+
+    if (MAMA_STATUS_OK != status)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "qpidBridgeMamaTransportImpl_conflate(): "
+                  "Could not decode update - delivering it unconflated [%s]",
+                  mamaStatus_stringForStatus (status));
+    }
+    else if (MAMA_MSG_TYPE_UPDATE !=
+                 mamaMsgType_typeForMsg (impl->mConflateMsg))
+    {
+        /* Only updates are merged. Anything else is delivered as it is,
+         * after the pending update which takes no further updates */
+        subscription->mConflatedNode = NULL;
+    }
+    else
+    {
+        if (NULL != subscription->mConflatedNode)
+        {
+            pending = (qpidMsgNode*) subscription->mConflatedNode->mNodeBuffer;
+            count   = qpidBridgeMamaTransportImpl_getConflateCount (
+                          pending->mConflated)
+                    + qpidBridgeMamaTransportImpl_getConflateCount (
+                          impl->mConflateMsg);
+
+            if (count <= 0xFFFF)
+            {
+                status = mamaMsg_applyMsg (pending->mConflated,
+                                           impl->mConflateMsg);
+
+                /* The merged update has the latest sequence number, so it
+                 * has to stand for every update merged or DQ sees a gap */
+                if (MAMA_STATUS_OK == status)
+                {
+                    status = mamaMsg_updateU16 (pending->mConflated,
+                                                MamaFieldConflateCount.mName,
+                                                MamaFieldConflateCount.mFid,
+                                                (mama_u16_t) count);
+                }
+                conflated = (MAMA_STATUS_OK == status);
+            }
+
+            /* Otherwise the pending update is left as it is and this one
+             * takes its place behind it */
+            if (!conflated)
+            {
+                subscription->mConflatedNode = NULL;
+            }
+        }
+
+        /* This update is enqueued as usual and later ones merged into it */
+        if (NULL == subscription->mConflatedNode)
+        {
+            status = mamaMsg_copy (impl->mConflateMsg, &msgNode->mConflated);
+            if (MAMA_STATUS_OK == status)
+            {
+                subscription->mConflatedNode = node;
+            }
+        }
+    }
+
+    wthread_mutex_unlock (&impl->mConflateLock);
+
+    return conflated;
+}
+
+mama_u16_t
+qpidBridgeMamaTransportImpl_getConflateCount (mamaMsg msg)
+{
+    mama_u16_t count = 0;
+
+    if (MAMA_STATUS_OK != mamaMsg_getU16 (msg,
+                                          MamaFieldConflateCount.mName,
+                                          MamaFieldConflateCount.mFid,
+                                          &count)
+        || 0 == count)
+    {
+        count = 1;
+    }
+    return count;
 }
 
 void
@@ -0,0 +1,248 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+/*=========================================================================
+  =                             Includes                                  =
+  =========================================================================*/
+
+#include <mama/mama.h>
+#include <timers.h>
+#include "io.h"
+#include "shmbridgefunctions.h"
+
+
+/*=========================================================================
+  =                Typedefs, structs, enums and globals                   =
+  =========================================================================*/
+
+/* Global timer heap */
+timerHeap           gShmTimerHeap;
+
+/* Default payload names and IDs to be loaded when this bridge is loaded */
+static char*        PAYLOAD_NAMES[]         =   { "flatmsg", NULL };
+static char         PAYLOAD_IDS[]           =   { MAMA_PAYLOAD_FLAT, '\0' };
+
+
+/*=========================================================================
+  =                              Macros                                   =
+  =========================================================================*/
+
+/* Version identifiers */
+#define             SHM_BRIDGE_NAME             "shm"
+#define             SHM_BRIDGE_VERSION          "1.0"
+
+/* Name to be given to the default queue. Should be bridge-specific. */
+#define             SHM_DEFAULT_QUEUE_NAME      "SHM_DEFAULT_MAMA_QUEUE"
+
+/* Timeout for dispatching queues on shutdown in milliseconds */
+#define             SHM_SHUTDOWN_TIMEOUT        5000
+
+
+/*=========================================================================
+  =               Public interface implementation functions               =
+  =========================================================================*/
+
+void shmBridge_createImpl (mamaBridge* result)
+{
+    mamaBridgeImpl* bridge = NULL;
+
+    if (NULL == result)
+    {
+        return;
+    }
+
+    /* Create the wrapping MAMA bridge */
+    bridge = (mamaBridgeImpl*) calloc (1, sizeof (mamaBridgeImpl));
+    if (NULL == bridge)
+    {
+        mama_log (MAMA_LOG_LEVEL_SEVERE, "shmBridge_createImpl(): "
+                "Could not allocate memory for MAMA bridge implementation.");
+        *result = NULL;
+        return;
+    }
+
+    /* Populate the bridge impl structure with the function pointers */
+    INITIALIZE_BRIDGE (bridge, shm);
+
+    /* Optional functions not covered by INITIALIZE_BRIDGE */
+    bridge->bridgeMamaQueueEnableResidency =
+                    shmBridgeMamaQueue_enableResidency;
+
+    /* Return the newly created bridge */
+    *result = (mamaBridge) bridge;
+
+    mamaBridgeImpl_setReadOnlyProperty ((mamaBridge)bridge, "mama.shm.entitlements.deferred", "false");
+}
+
+mama_status
+shmBridge_open (mamaBridge bridgeImpl)
+{
+    mama_status         status  = MAMA_STATUS_OK;
+    mamaBridgeImpl*     bridge  = (mamaBridgeImpl*) bridgeImpl;
+
+    wsocketstartup();
+
+    if (NULL == bridgeImpl)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Create the default event queue */
+    status = mamaQueue_create (&bridge->mDefaultEventQueue, bridgeImpl);
+    if (MAMA_STATUS_OK != status)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmBridge_open(): Failed to create SHM queue (%s).",
+                  mamaStatus_stringForStatus (status));
+        return status;
+    }
+
+    /* Set the queue name (used to identify this queue in MAMA stats) */
+    mamaQueue_setQueueName (bridge->mDefaultEventQueue,
+                            SHM_DEFAULT_QUEUE_NAME);
+
+    /* Create the timer heap */
+    if (0 != createTimerHeap (&gShmTimerHeap))
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmBridge_open(): Failed to initialize timers.");
+        return MAMA_STATUS_PLATFORM;
+    }
+
+    /* Start the dispatch timer heap which will create a new thread */
+    if (0 != startDispatchTimerHeap (gShmTimerHeap))
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmBridge_open(): Failed to start timer thread.");
+        return MAMA_STATUS_PLATFORM;
+    }
+
+    /* Start the io thread */
+    shmBridgeMamaIoImpl_start ();
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+shmBridge_close (mamaBridge bridgeImpl)
+{
+    mama_status      status      = MAMA_STATUS_OK;
+    mamaBridgeImpl*  bridge      = (mamaBridgeImpl*) bridgeImpl;
+    wthread_t        timerThread;
+
+    if (NULL ==  bridgeImpl)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Remove the timer heap */
+    if (NULL != gShmTimerHeap)
+    {
+        /* The timer heap allows us to access it's thread ID for joining */
+        timerThread = timerHeapGetTid (gShmTimerHeap);
+        if (0 != destroyHeap (gShmTimerHeap))
+        {
+            mama_log (MAMA_LOG_LEVEL_ERROR,
+                      "shmBridge_close(): Failed to destroy SHM timer heap.");
+            status = MAMA_STATUS_PLATFORM;
+        }
+        /* The timer thread expects us to be responsible for terminating it */
+        wthread_join    (timerThread, NULL);
+    }
+    gShmTimerHeap = NULL;
+
+    /* Destroy once queue has been emptied */
+    mamaQueue_destroyTimedWait (bridge->mDefaultEventQueue,
+                                SHM_SHUTDOWN_TIMEOUT);
+
+    /* Stop and destroy the io thread */
+    shmBridgeMamaIoImpl_stop ();
+
+    /* Wait for shmBridge_start to finish before destroying implementation */
+    if (NULL != bridgeImpl)
+    {
+        free (bridgeImpl);
+    }
+
+    return status;
+}
+
+mama_status
+shmBridge_start (mamaQueue defaultEventQueue)
+{
+    if (NULL == defaultEventQueue)
+    {
+      mama_log (MAMA_LOG_LEVEL_FINER,
+                "shmBridge_start(): defaultEventQueue is NULL");
+      return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Start the default event queue */
+    return mamaQueue_dispatch (defaultEventQueue);;
+}
+
+mama_status
+shmBridge_stop (mamaQueue defaultEventQueue)
+{
+    if (NULL == defaultEventQueue)
+    {
+      mama_log (MAMA_LOG_LEVEL_FINER,
+                "shmBridge_start(): defaultEventQueue is NULL");
+      return MAMA_STATUS_NULL_ARG;
+    }
+
+    return mamaQueue_stopDispatch (defaultEventQueue);;
+}
+
+const char*
+shmBridge_getVersion (void)
+{
+    return SHM_BRIDGE_VERSION;
+}
+
+const char*
+shmBridge_getName (void)
+{
+    return SHM_BRIDGE_NAME;
+}
+
+mama_status
+shmBridge_getDefaultPayloadId (char ***name, char **id)
+{
+    if (NULL == name || NULL == id)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+    /*
+     * Populate name with the value of all supported payload names, the first
+     * being the default
+     */
+    *name   = PAYLOAD_NAMES;
+
+    /*
+     * Populate id with the char keys for all supported payload names, the first
+     * being the default
+     */
+    *id     = PAYLOAD_IDS;
+
+     return MAMA_STATUS_OK;
+}
@@ -0,0 +1,370 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+
+/*=========================================================================
+  =                             Includes                                  =
+  =========================================================================*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <mama/mama.h>
+#include <msgimpl.h>
+#include "shmdefs.h"
+#include "shmbridgefunctions.h"
+#include "msg.h"
+
+
+/*=========================================================================
+  =                Typedefs, structs, enums and globals                   =
+  =========================================================================*/
+
+typedef struct shmBridgeMsgImpl
+{
+    mamaMsg                     mParent;
+    shmMsgType                  mMsgType;
+    char                        mInboxName[MAX_SUBJECT_LENGTH];
+} shmBridgeMsgImpl;
+
+
+/*=========================================================================
+  =              Public interface implementation functions                =
+  =========================================================================*/
+
+/* Bridge specific implementations below here */
+mama_status
+shmBridgeMamaMsg_create (msgBridge* msg, mamaMsg parent)
+{
+    shmBridgeMsgImpl*  impl   = NULL;
+    mama_status        status = MAMA_STATUS_OK;
+
+    if (NULL == msg || NULL == parent)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    status = shmBridgeMamaMsgImpl_createMsgOnly (msg);
+    if (MAMA_STATUS_OK != status)
+    {
+        return status;
+    }
+
+    /* Cast back to implementation to set parent */
+    impl = (shmBridgeMsgImpl*) *msg;
+    impl->mParent       = parent;
+
+    return MAMA_STATUS_OK;
+}
+
+int
+shmBridgeMamaMsg_isFromInbox (msgBridge msg)
+{
+    if (NULL == msg)
+    {
+        return -1;
+    }
+
+    if (SHM_MSG_INBOX_REQUEST == ((shmBridgeMsgImpl*)msg)->mMsgType)
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
+mama_status
+shmBridgeMamaMsg_destroy (msgBridge msg, int destroyMsg)
+{
+    if (NULL == msg)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Free the underlying implementation */
+    free (msg);
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+shmBridgeMamaMsg_destroyMiddlewareMsg (msgBridge msg)
+{
+    /*
+     * The payload lives in the transport's message pool rather than in the
+     * bridge message, so there is nothing to do here
+     */
+    if (NULL == msg)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+shmBridgeMamaMsg_detach (msgBridge msg)
+{
+    /*
+     * The payload lives in the transport's message pool rather than in the
+     * bridge message, so there is nothing to do here
+     */
+    if (NULL == msg)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+shmBridgeMamaMsg_getPlatformError (msgBridge msg, void** error)
+{
+    /* Null initialize the error return */
+    if (NULL != error)
+    {
+        *error  = NULL;
+    }
+
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+shmBridgeMamaMsg_setSendSubject (msgBridge   msg,
+                                 const char* symbol,
+                                 const char* subject)
+{
+    shmBridgeMsgImpl*  impl     = (shmBridgeMsgImpl*) msg;
+    mama_status        status   = MAMA_STATUS_OK;
+
+    if (NULL == impl || NULL == symbol)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Update the MAMA message with the send subject if it has a parent */
+    if (NULL != impl->mParent)
+    {
+        status = mamaMsg_updateString (impl->mParent,
+                                       MamaFieldSubscSymbol.mName,
+                                       MamaFieldSubscSymbol.mFid,
+                                       symbol);
+    }
+
+    return status;
+}
+
+mama_status
+shmBridgeMamaMsg_getNativeHandle (msgBridge msg, void** result)
+{
+    shmBridgeMsgImpl* impl = (shmBridgeMsgImpl*) msg;
+
+    if (NULL == impl || NULL == result)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    *result = impl;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+shmBridgeMamaMsg_duplicateReplyHandle (msgBridge msg, void** result)
+{
+    shmBridgeMsgImpl* impl = (shmBridgeMsgImpl*) msg;
+
+    if (NULL == impl || NULL == result)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Reply handles are simply the inbox subject to publish replies onto */
+    *result = (void*) strdup (impl->mInboxName);
+    if (NULL == *result)
+    {
+        return MAMA_STATUS_NOMEM;
+    }
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+shmBridgeMamaMsg_copyReplyHandle (void* src, void** dest)
+{
+    if (NULL == src || NULL == dest)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    *dest = (void*) strdup ((const char*) src);
+    if (NULL == *dest)
+    {
+        return MAMA_STATUS_NOMEM;
+    }
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+shmBridgeMamaMsg_destroyReplyHandle (void* result)
+{
+    if (NULL == result)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    free (result);
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+shmBridgeMamaMsgImpl_setReplyHandle (msgBridge msg, void* handle)
+{
+    shmBridgeMsgImpl* impl = (shmBridgeMsgImpl*) msg;
+
+    if (NULL == impl || NULL == handle)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    return shmBridgeMamaMsgImpl_setInboxName (msg, (const char*) handle);
+}
+
+mama_status
+shmBridgeMamaMsgImpl_setReplyHandleAndIncrement (msgBridge msg, void* result)
+{
+    /* Reply handles are not reference counted - they are simply strings */
+    return shmBridgeMamaMsgImpl_setReplyHandle (msg, result);
+}
+
+
+/*=========================================================================
+  =                  Public implementation functions                      =
+  =========================================================================*/
+
+mama_status
+shmBridgeMamaMsgImpl_createMsgOnly (msgBridge* msg)
+{
+    shmBridgeMsgImpl* impl = NULL;
+
+    if (NULL == msg)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Allocate memory for the implementation struct */
+    impl = (shmBridgeMsgImpl*) calloc (1, sizeof (shmBridgeMsgImpl));
+    if (NULL == impl)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmBridgeMamaMsgImpl_createMsgOnly(): "
+                  "Failed to allocate memory for bridge message.");
+        *msg = NULL;
+        return MAMA_STATUS_NOMEM;
+    }
+
+    impl->mMsgType = SHM_MSG_PUB_SUB;
+
+    *msg = (msgBridge) impl;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+shmBridgeMamaMsgImpl_setMsgType (msgBridge     msg,
+                                 shmMsgType    type)
+{
+    shmBridgeMsgImpl* impl = (shmBridgeMsgImpl*) msg;
+
+    if (NULL == impl)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    impl->mMsgType = type;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+shmBridgeMamaMsgImpl_getMsgType (msgBridge     msg,
+                                 shmMsgType*   type)
+{
+    shmBridgeMsgImpl* impl = (shmBridgeMsgImpl*) msg;
+
+    if (NULL == impl || NULL == type)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    *type = impl->mMsgType;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+shmBridgeMamaMsgImpl_setInboxName (msgBridge   msg,
+                                   const char* value)
+{
+    shmBridgeMsgImpl* impl = (shmBridgeMsgImpl*) msg;
+
+    if (NULL == impl)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    if (NULL == value)
+    {
+        impl->mInboxName[0] = '\0';
+        return MAMA_STATUS_OK;
+    }
+
+    if (strlen (value) >= sizeof (impl->mInboxName))
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmBridgeMamaMsgImpl_setInboxName(): "
+                  "Inbox name exceeds %d characters.",
+                  MAX_SUBJECT_LENGTH - 1);
+        return MAMA_STATUS_INVALID_ARG;
+    }
+
+    strcpy (impl->mInboxName, value);
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+shmBridgeMamaMsgImpl_getInboxName (msgBridge    msg,
+                                   const char** value)
+{
+    shmBridgeMsgImpl* impl = (shmBridgeMsgImpl*) msg;
+
+    if (NULL == impl || NULL == value)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    *value = impl->mInboxName;
+
+    return MAMA_STATUS_OK;
+}
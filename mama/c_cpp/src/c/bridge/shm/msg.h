@@ -0,0 +1,108 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#ifndef MAMA_BRIDGE_SHM_MSG_H__
+#define MAMA_BRIDGE_SHM_MSG_H__
+
+
+/*=========================================================================
+  =                             Includes                                  =
+  =========================================================================*/
+
+#include "../../bridge.h"
+#include "shmdefs.h"
+
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+
+/*=========================================================================
+  =                  Public implementation functions                      =
+  =========================================================================*/
+
+/**
+ * This will create a bridge message with no parent MAMA message, as used by
+ * publishers to carry the meta data for the frames they write.
+ *
+ * @param msg       Pointer to populate with the new bridge message.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+mama_status
+shmBridgeMamaMsgImpl_createMsgOnly   (msgBridge*   msg);
+
+/**
+ * This will set the type of message (pub / sub or one of the inbox types).
+ *
+ * @param msg       The bridge message to update.
+ * @param type      The message type.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+mama_status
+shmBridgeMamaMsgImpl_setMsgType      (msgBridge    msg,
+                                      shmMsgType   type);
+
+/**
+ * This will get the type of message (pub / sub or one of the inbox types).
+ *
+ * @param msg       The bridge message to query.
+ * @param type      Populated with the message type.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+mama_status
+shmBridgeMamaMsgImpl_getMsgType      (msgBridge    msg,
+                                      shmMsgType*  type);
+
+/**
+ * This will set the name of the inbox which replies should be published to.
+ *
+ * @param msg       The bridge message to update.
+ * @param value     The inbox subject, or NULL to clear it.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+mama_status
+shmBridgeMamaMsgImpl_setInboxName    (msgBridge    msg,
+                                      const char*  value);
+
+/**
+ * This will get the name of the inbox which replies should be published to.
+ *
+ * @param msg       The bridge message to query.
+ * @param value     Populated with the inbox subject (memory owned by the
+ *                  message), which is empty if there is none.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+mama_status
+shmBridgeMamaMsgImpl_getInboxName    (msgBridge    msg,
+                                      const char** value);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* MAMA_BRIDGE_SHM_MSG_H__ */
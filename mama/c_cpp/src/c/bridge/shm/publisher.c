@@ -0,0 +1,470 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+/*=========================================================================
+  =                             Includes                                  =
+  =========================================================================*/
+
+#include <string.h>
+#include <mama/mama.h>
+#include <mama/inbox.h>
+#include <mama/publisher.h>
+#include <bridge.h>
+#include <inboximpl.h>
+#include <msgimpl.h>
+#include "shmbridgefunctions.h"
+#include "transport.h"
+#include "shmdefs.h"
+#include "msg.h"
+#include "inbox.h"
+#include "ring.h"
+
+
+/*=========================================================================
+  =                Typedefs, structs, enums and globals                   =
+  =========================================================================*/
+
+typedef struct shmPublisherBridge
+{
+    shmTransportBridge*     mTransport;
+    const char*             mSubject;
+    const char*             mSource;
+    shmRing*                mRing;
+    msgBridge               mMamaBridgeMsg;
+} shmPublisherBridge;
+
+
+/*=========================================================================
+  =                  Private implementation prototypes                    =
+  =========================================================================*/
+
+/**
+ * This function takes a MAMA Message and writes it straight into a slot of
+ * the subject's topic group ring, framed with the subject, message type and
+ * the inbox to reply to where applicable.
+ *
+ * @param impl      The related shm publisher bridge.
+ * @param ring      The ring to write to.
+ * @param subject   The subject to publish the message on.
+ * @param type      The type of message being published.
+ * @param inbox     The inbox subject for requests, otherwise NULL.
+ * @param msg       The MAMA message to publish.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+static mama_status
+shmBridgePublisherImpl_writeFrame (shmPublisherBridge*  impl,
+                                   shmRing*             ring,
+                                   const char*          subject,
+                                   shmMsgType           type,
+                                   const char*          inbox,
+                                   mamaMsg              msg);
+
+
+/*=========================================================================
+  =               Public interface implementation functions               =
+  =========================================================================*/
+
+mama_status
+shmBridgeMamaPublisher_createByIndex (publisherBridge*     result,
+                                      mamaTransport        tport,
+                                      int                  tportIndex,
+                                      const char*          topic,
+                                      const char*          source,
+                                      const char*          root,
+                                      void*                nativeQueueHandle,
+                                      mamaPublisher        parent)
+{
+    shmPublisherBridge*     impl            = NULL;
+    shmTransportBridge*     transport       = NULL;
+    mama_status             status          = MAMA_STATUS_OK;
+
+    if (NULL == result
+            || NULL == tport
+            || NULL == parent)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    transport = shmBridgeMamaTransportImpl_getTransportBridge (tport);
+    if (NULL == transport)
+    {
+        mama_log (MAMA_LOG_LEVEL_SEVERE,
+                  "shmBridgeMamaPublisher_createByIndex(): "
+                  "Could not find transport.");
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    impl = (shmPublisherBridge*) calloc (1, sizeof (shmPublisherBridge));
+    if (NULL == impl)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmBridgeMamaPublisher_createByIndex(): "
+                  "Could not allocate mem publisher.");
+        return MAMA_STATUS_NOMEM;
+    }
+
+    /* Initialize the publisher members */
+    impl->mTransport = transport;
+
+    /* Create an underlying bridge message with no parent to be used in sends */
+    status = shmBridgeMamaMsgImpl_createMsgOnly (&impl->mMamaBridgeMsg);
+    if (MAMA_STATUS_OK != status)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmBridgeMamaPublisher_createByIndex(): "
+                  "Could not create shm bridge message for publisher: %s.",
+                  mamaStatus_stringForStatus (status));
+        free (impl);
+        return MAMA_STATUS_NOMEM;
+    }
+
+    /*
+     * Collapse subject key to single string based on supplied values
+     *
+     * _MD requests do not use the topic on the wire as the responder may not
+     * necessarily be listening for requests on that topic until the first
+     * request comes in.
+     */
+    if (NULL != root && 0 == strcmp (root, MAMA_ROOT_MARKET_DATA))
+    {
+        status = shmBridgeMamaTransportImpl_generateSubjectKey (
+                        root, source, NULL, &impl->mSubject);
+    }
+    else
+    {
+        status = shmBridgeMamaTransportImpl_generateSubjectKey (
+                        root, source, topic, &impl->mSubject);
+    }
+
+    if (MAMA_STATUS_OK != status)
+    {
+        shmBridgeMamaMsg_destroy (impl->mMamaBridgeMsg, 0);
+        free (impl);
+        return status;
+    }
+
+    if (NULL != source)
+    {
+        impl->mSource = strdup (source);
+    }
+
+    /* The publisher's subject always maps onto the same topic group */
+    impl->mRing = shmBridgeMamaTransportImpl_getRing (transport,
+                                                      impl->mSubject);
+
+    /* Populate the publisherBridge pointer with the publisher implementation */
+    *result = (publisherBridge) impl;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+shmBridgeMamaPublisher_create (publisherBridge*    result,
+                               mamaTransport       tport,
+                               const char*         topic,
+                               const char*         source,
+                               const char*         root,
+                               void*               nativeQueueHandle,
+                               mamaPublisher       parent)
+{
+    return shmBridgeMamaPublisher_createByIndex (result,
+                                                 tport,
+                                                 0,
+                                                 topic,
+                                                 source,
+                                                 root,
+                                                 nativeQueueHandle,
+                                                 parent);
+}
+
+mama_status
+shmBridgeMamaPublisher_destroy (publisherBridge publisher)
+{
+    shmPublisherBridge* impl = (shmPublisherBridge*) publisher;
+
+    if (NULL == impl)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    if (NULL != impl->mSubject)
+    {
+        free ((void*) impl->mSubject);
+    }
+
+    if (NULL != impl->mSource)
+    {
+        free ((void*) impl->mSource);
+    }
+
+    if (NULL != impl->mMamaBridgeMsg)
+    {
+        shmBridgeMamaMsg_destroy (impl->mMamaBridgeMsg, 0);
+    }
+
+    free (impl);
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+shmBridgeMamaPublisher_send (publisherBridge publisher, mamaMsg msg)
+{
+    shmPublisherBridge*     impl    = (shmPublisherBridge*) publisher;
+
+    if (NULL == impl)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmBridgeMamaPublisher_send(): No publisher.");
+        return MAMA_STATUS_NULL_ARG;
+    }
+    else if (NULL == msg)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Use the publisher's default send subject */
+    shmBridgeMamaMsg_setSendSubject (impl->mMamaBridgeMsg,
+                                     impl->mSubject,
+                                     impl->mSource);
+
+    return shmBridgePublisherImpl_writeFrame (impl,
+                                              impl->mRing,
+                                              impl->mSubject,
+                                              SHM_MSG_PUB_SUB,
+                                              NULL,
+                                              msg);
+}
+
+/* Send reply to inbox. */
+mama_status
+shmBridgeMamaPublisher_sendReplyToInbox (publisherBridge   publisher,
+                                         void*             request,
+                                         mamaMsg           reply)
+{
+    mamaMsg                 requestMsg      = (mamaMsg) request;
+    const char*             inboxSubject    = NULL;
+    msgBridge               bridgeMsg       = NULL;
+    mama_status             status          = MAMA_STATUS_OK;
+
+    if (NULL == publisher || NULL == request || NULL == reply)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Get the incoming bridge message from the mamaMsg */
+    status = mamaMsgImpl_getBridgeMsg (requestMsg, &bridgeMsg);
+    if (MAMA_STATUS_OK != status)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmBridgeMamaPublisher_sendReplyToInbox(): "
+                  "Could not get bridge message from cached"
+                  " queue mamaMsg [%s]",
+                  mamaStatus_stringForStatus (status));
+        return status;
+    }
+
+    /* Get properties from the incoming bridge message */
+    status = shmBridgeMamaMsgImpl_getInboxName (bridgeMsg, &inboxSubject);
+    if (MAMA_STATUS_OK != status)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmBridgeMamaPublisher_sendReplyToInbox(): "
+                  "Could not get inbox name [%s]",
+                  mamaStatus_stringForStatus (status));
+        return status;
+    }
+
+    return shmBridgeMamaPublisher_sendReplyToInboxHandle (
+                   publisher,
+                   (void*) inboxSubject,
+                   reply);
+}
+
+mama_status
+shmBridgeMamaPublisher_sendReplyToInboxHandle (publisherBridge     publisher,
+                                               void*               inbox,
+                                               mamaMsg             reply)
+{
+    shmPublisherBridge*     impl            = (shmPublisherBridge*) publisher;
+    const char*             inboxSubject    = (const char*) inbox;
+
+    if (NULL == publisher || NULL == inbox || NULL == reply)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    if ('\0' == inboxSubject[0])
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmBridgeMamaPublisher_sendReplyToInboxHandle(): "
+                  "No reply address specified - cannot respond to inbox.");
+        return MAMA_STATUS_INVALID_ARG;
+    }
+
+    /* Inboxes are subscriptions, so the reply goes to the inbox's ring */
+    return shmBridgePublisherImpl_writeFrame (
+                   impl,
+                   shmBridgeMamaTransportImpl_getRing (impl->mTransport,
+                                                       inboxSubject),
+                   inboxSubject,
+                   SHM_MSG_INBOX_RESPONSE,
+                   NULL,
+                   reply);
+}
+
+/* Send a message from the specified inbox using the throttle. */
+mama_status
+shmBridgeMamaPublisher_sendFromInboxByIndex (publisherBridge   publisher,
+                                             int               tportIndex,
+                                             mamaInbox         inbox,
+                                             mamaMsg           msg)
+{
+    shmPublisherBridge*     impl        = (shmPublisherBridge*) publisher;
+    const char*             replyAddr   = NULL;
+    inboxBridge             inboxImpl   = NULL;
+
+    if (NULL == impl || NULL == inbox || NULL == msg)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Get the inbox which you want the publisher to respond to */
+    inboxImpl = mamaInboxImpl_getInboxBridge (inbox);
+    replyAddr = shmBridgeMamaInboxImpl_getReplySubject (inboxImpl);
+
+    /* Use the publisher's default send subject */
+    shmBridgeMamaMsg_setSendSubject (impl->mMamaBridgeMsg,
+                                     impl->mSubject,
+                                     impl->mSource);
+
+    return shmBridgePublisherImpl_writeFrame (impl,
+                                              impl->mRing,
+                                              impl->mSubject,
+                                              SHM_MSG_INBOX_REQUEST,
+                                              replyAddr,
+                                              msg);
+}
+
+mama_status
+shmBridgeMamaPublisher_sendFromInbox (publisherBridge  publisher,
+                                      mamaInbox        inbox,
+                                      mamaMsg          msg)
+{
+    return shmBridgeMamaPublisher_sendFromInboxByIndex (publisher,
+                                                        0,
+                                                        inbox,
+                                                        msg);
+}
+
+
+/*=========================================================================
+  =                  Private implementation functions                     =
+  =========================================================================*/
+
+mama_status
+shmBridgePublisherImpl_writeFrame (shmPublisherBridge*  impl,
+                                   shmRing*             ring,
+                                   const char*          subject,
+                                   shmMsgType           type,
+                                   const char*          inbox,
+                                   mamaMsg              msg)
+{
+    shmFrameHeader*     header      = NULL;
+    uint8_t*            position    = NULL;
+    const void*         buffer      = NULL;
+    mama_size_t         bufferLen   = 0;
+    mamaPayloadType     payloadType = MAMA_PAYLOAD_UNKNOWN;
+    size_t              subjectLen  = strlen (subject) + 1;
+    size_t              inboxLen    = (NULL == inbox ? 0 : strlen (inbox)) + 1;
+    size_t              frameLen    = 0;
+    uint64_t            sequence    = 0;
+    void*               frame       = NULL;
+    mama_status         status      = MAMA_STATUS_OK;
+
+    if (subjectLen > MAX_SUBJECT_LENGTH || inboxLen > MAX_SUBJECT_LENGTH)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmBridgePublisherImpl_writeFrame(): "
+                  "Subject exceeds %d characters.",
+                  MAX_SUBJECT_LENGTH - 1);
+        return MAMA_STATUS_INVALID_ARG;
+    }
+
+    mamaMsg_getPayloadType (msg, &payloadType);
+
+    status = mamaMsg_getByteBuffer (msg, &buffer, &bufferLen);
+    if (MAMA_STATUS_OK != status)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmBridgePublisherImpl_writeFrame(): "
+                  "Could not get byte buffer for %s [%s]",
+                  subject,
+                  mamaStatus_stringForStatus (status));
+        return status;
+    }
+
+    frameLen = sizeof (shmFrameHeader) + subjectLen + inboxLen + bufferLen;
+
+    /* The payload is encoded straight into shared memory - no staging copy */
+    status = shmRing_claim (ring, (uint32_t) frameLen, &sequence, &frame);
+    if (MAMA_STATUS_OK != status)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmBridgePublisherImpl_writeFrame(): "
+                  "Message of %lu bytes for %s does not fit into a ring slot "
+                  "of %u bytes.",
+                  (unsigned long) frameLen,
+                  subject,
+                  shmRing_getMaxFrameSize (ring));
+        return status;
+    }
+
+    header               = (shmFrameHeader*) frame;
+    header->mMsgType     = (uint8_t) type;
+    header->mPayloadType = (uint8_t) payloadType;
+    header->mSubjectLen  = (uint16_t) subjectLen;
+    header->mInboxLen    = (uint16_t) inboxLen;
+    header->mReserved    = 0;
+    header->mPayloadLen  = (uint32_t) bufferLen;
+
+    position = (uint8_t*) (header + 1);
+    memcpy (position, subject, subjectLen);
+    position += subjectLen;
+
+    if (NULL == inbox)
+    {
+        *position = '\0';
+    }
+    else
+    {
+        memcpy (position, inbox, inboxLen);
+    }
+    position += inboxLen;
+
+    memcpy (position, buffer, bufferLen);
+
+    shmRing_commit (ring, sequence);
+
+    return MAMA_STATUS_OK;
+}
@@ -0,0 +1,708 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+
+/*=========================================================================
+  =                             Includes                                  =
+  =========================================================================*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include <mama/mama.h>
+#include "ring.h"
+
+
+/*=========================================================================
+  =                              Macros                                   =
+  =========================================================================*/
+
+/* "MAMARING" - written last by the creating process once initialised */
+#define     SHM_RING_MAGIC                  0x4d414d4152494e47ULL
+#define     SHM_RING_VERSION                2
+
+#define     SHM_RING_CACHE_LINE             64
+#define     SHM_RING_MIN_SLOT_COUNT         2
+#define     SHM_RING_MAX_SLOT_COUNT         (1U << 24)
+
+/* How long attaching processes wait for the creator to initialise the ring */
+#define     SHM_RING_ATTACH_RETRIES         1000
+#define     SHM_RING_ATTACH_INTERVAL        1000 /* microseconds */
+
+/* Sleep between checks where futexes are not available */
+#define     SHM_RING_FALLBACK_INTERVAL      50 /* microseconds */
+
+#define     SHM_RING_BARRIER()              __sync_synchronize ()
+#define     SHM_RING_FETCH_AND_ADD(ptr, v)  __sync_fetch_and_add ((ptr), (v))
+#define     SHM_RING_FETCH_AND_SUB(ptr, v)  __sync_fetch_and_sub ((ptr), (v))
+#define     SHM_RING_COMPARE_AND_SWAP(ptr, o, n)                               \
+    __sync_bool_compare_and_swap ((ptr), (o), (n))
+
+#if defined(__i386__) || defined(__x86_64__)
+#define     SHM_RING_PAUSE()                __asm__ __volatile__ ("pause")
+#else
+#define     SHM_RING_PAUSE()                SHM_RING_BARRIER ()
+#endif
+
+#define     SHM_RING_SLOT(ring, seq)                                           \
+    ((shmRingSlot*) ((ring)->mSlots + ((seq) & (ring)->mMask)                  \
+                                      * (ring)->mSlotBytes))
+
+
+/*=========================================================================
+  =                Typedefs, structs, enums and globals                   =
+  =========================================================================*/
+
+/*
+ * Laid out at the start of the shared memory segment. The claim sequence and
+ * the futex word sit on cache lines of their own as every producer writes the
+ * former and readers sleep on the latter.
+ */
+typedef struct shmRingHeader_
+{
+    volatile uint64_t   mMagic;
+    uint32_t            mVersion;
+    uint32_t            mSlotCount;
+    uint32_t            mSlotBytes;
+    /* Processes which have the ring open - the last to close unlinks it */
+    volatile uint32_t   mAttached;
+    uint8_t             mPad0[SHM_RING_CACHE_LINE - 24];
+    /* Next sequence number to be claimed by a producer */
+    volatile uint64_t   mClaim;
+    uint8_t             mPad1[SHM_RING_CACHE_LINE - 8];
+    /* Bumped by producers to wake readers when mWaiters is non zero */
+    volatile uint32_t   mNotify;
+    volatile uint32_t   mWaiters;
+    uint8_t             mPad2[SHM_RING_CACHE_LINE - 8];
+} shmRingHeader;
+
+/* Precedes the frame held in every slot */
+typedef struct shmRingSlot_
+{
+    /* Sequence number + 1 once committed, 0 while a producer is writing */
+    volatile uint64_t   mSequence;
+    uint32_t            mLength;
+    uint32_t            mReserved;
+} shmRingSlot;
+
+struct shmRing_
+{
+    char*               mName;
+    shmRingHeader*      mHeader;
+    uint8_t*            mSlots;
+    size_t              mMapSize;
+    uint64_t            mMask;
+    uint32_t            mSlotBytes;
+    uint32_t            mMaxFrameSize;
+};
+
+
+/*=========================================================================
+  =                  Private implementation prototypes                    =
+  =========================================================================*/
+
+/**
+ * This will map in and initialise a ring which this process has just created.
+ *
+ * @param ring      The ring to populate.
+ * @param fd        The newly created shared memory file descriptor.
+ * @param slotCount Number of slots (already a power of two).
+ * @param slotBytes Size of each slot including its header.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+static mama_status
+shmRingImpl_create (shmRing* ring, int fd, uint32_t slotCount,
+                    uint32_t slotBytes);
+
+/**
+ * This will map in a ring created by another process, waiting for the
+ * creating process to finish initialising it if required.
+ *
+ * @param ring      The ring to populate.
+ * @param fd        The opened shared memory file descriptor.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+static mama_status
+shmRingImpl_attach (shmRing* ring, int fd);
+
+/**
+ * This will create the named ring or map in the existing one, taking a
+ * reference to it on behalf of this process.
+ *
+ * @param ring      The ring to populate.
+ * @param name      The shared memory object name.
+ * @param slotCount Number of slots (already a power of two).
+ * @param slotBytes Size of each slot including its header.
+ *
+ * @return mama_status MAMA_STATUS_NOT_FOUND if the ring is being unlinked by
+ *         the last process to close it, in which case the caller should try
+ *         again, otherwise indicating whether the method succeeded or failed.
+ */
+static mama_status
+shmRingImpl_map (shmRing* ring, const char* name, uint32_t slotCount,
+                 uint32_t slotBytes);
+
+/**
+ * This will check whether the reader at the given cursor has something to do,
+ * either a committed frame or having been lapped by producers.
+ *
+ * @param ring      The ring to check.
+ * @param cursor    The reader's cursor.
+ *
+ * @return Non zero if shmRing_peek would not return SHM_RING_READ_EMPTY.
+ */
+static int
+shmRingImpl_isReady (shmRing* ring, uint64_t cursor);
+
+static void
+shmRingImpl_sleepMicros (long micros);
+
+
+/*=========================================================================
+  =                  Public implementation functions                      =
+  =========================================================================*/
+
+mama_status
+shmRing_open (shmRing**     ring,
+              const char*   name,
+              uint32_t      slotCount,
+              uint32_t      slotSize)
+{
+    shmRing*    impl        = NULL;
+    uint32_t    count       = SHM_RING_MIN_SLOT_COUNT;
+    uint32_t    slotBytes   = 0;
+    mama_status status      = MAMA_STATUS_OK;
+    int         retries     = 0;
+
+    if (NULL == ring || NULL == name)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    if (slotCount > SHM_RING_MAX_SLOT_COUNT || 0 == slotSize)
+    {
+        return MAMA_STATUS_INVALID_ARG;
+    }
+
+    /* Sequences are mapped onto slots with a mask */
+    while (count < slotCount)
+    {
+        count <<= 1;
+    }
+
+    slotBytes = (uint32_t) (sizeof (shmRingSlot) + slotSize
+                            + SHM_RING_CACHE_LINE - 1)
+              & ~(uint32_t) (SHM_RING_CACHE_LINE - 1);
+
+    impl = (shmRing*) calloc (1, sizeof (shmRing));
+    if (NULL == impl)
+    {
+        return MAMA_STATUS_NOMEM;
+    }
+
+    impl->mName = strdup (name);
+    if (NULL == impl->mName)
+    {
+        free (impl);
+        return MAMA_STATUS_NOMEM;
+    }
+
+    /* A ring being unlinked is replaced by a new one once the unlink is done */
+    for (retries = 0; retries < SHM_RING_ATTACH_RETRIES; retries++)
+    {
+        status = shmRingImpl_map (impl, name, count, slotBytes);
+        if (MAMA_STATUS_NOT_FOUND != status)
+        {
+            break;
+        }
+        shmRingImpl_sleepMicros (SHM_RING_ATTACH_INTERVAL);
+    }
+
+    if (MAMA_STATUS_OK != status)
+    {
+        if (MAMA_STATUS_NOT_FOUND == status)
+        {
+            mama_log (MAMA_LOG_LEVEL_ERROR,
+                      "shmRing_open(): Timed out waiting for ring %s to be "
+                      "unlinked.", name);
+            status = MAMA_STATUS_TIMEOUT;
+        }
+        free (impl->mName);
+        free (impl);
+        return status;
+    }
+
+    impl->mSlots        = (uint8_t*) impl->mHeader + sizeof (shmRingHeader);
+    impl->mSlotBytes    = impl->mHeader->mSlotBytes;
+    impl->mMask         = impl->mHeader->mSlotCount - 1;
+    impl->mMaxFrameSize = impl->mSlotBytes - (uint32_t) sizeof (shmRingSlot);
+
+    *ring = impl;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+shmRing_close (shmRing* ring)
+{
+    if (NULL == ring)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    if (NULL != ring->mHeader)
+    {
+        /* Nothing can attach once this reaches zero - see shmRingImpl_map */
+        if (1 == SHM_RING_FETCH_AND_SUB (&ring->mHeader->mAttached, 1))
+        {
+            mama_log (MAMA_LOG_LEVEL_FINE,
+                      "shmRing_close(): Unlinking ring %s.", ring->mName);
+            if (0 != shm_unlink (ring->mName) && ENOENT != errno)
+            {
+                mama_log (MAMA_LOG_LEVEL_WARN,
+                          "shmRing_close(): Could not unlink ring %s (%s).",
+                          ring->mName, strerror (errno));
+            }
+        }
+        munmap ((void*) ring->mHeader, ring->mMapSize);
+    }
+
+    free (ring->mName);
+    free (ring);
+
+    return MAMA_STATUS_OK;
+}
+
+uint32_t
+shmRing_getMaxFrameSize (shmRing* ring)
+{
+    return ring->mMaxFrameSize;
+}
+
+uint64_t
+shmRing_getNextSequence (shmRing* ring)
+{
+    uint64_t sequence = ring->mHeader->mClaim;
+    SHM_RING_BARRIER ();
+    return sequence;
+}
+
+mama_status
+shmRing_claim (shmRing*     ring,
+               uint32_t     length,
+               uint64_t*    sequence,
+               void**       buffer)
+{
+    shmRingSlot*    slot    = NULL;
+    uint64_t        claimed = 0;
+
+    if (NULL == ring || NULL == sequence || NULL == buffer)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    if (length > ring->mMaxFrameSize)
+    {
+        return MAMA_STATUS_INVALID_ARG;
+    }
+
+    claimed = SHM_RING_FETCH_AND_ADD (&ring->mHeader->mClaim, 1);
+    slot    = SHM_RING_SLOT (ring, claimed);
+
+    /* Readers of the previous lap will see this and discard their copy */
+    slot->mSequence = 0;
+    SHM_RING_BARRIER ();
+    slot->mLength   = length;
+
+    *sequence = claimed;
+    *buffer   = (void*) (slot + 1);
+
+    return MAMA_STATUS_OK;
+}
+
+void
+shmRing_commit (shmRing* ring, uint64_t sequence)
+{
+    shmRingHeader*  header  = ring->mHeader;
+    shmRingSlot*    slot    = SHM_RING_SLOT (ring, sequence);
+
+    /* The frame must be visible before the sequence which publishes it */
+    SHM_RING_BARRIER ();
+    slot->mSequence = sequence + 1;
+
+    /* Pairs with the barrier in shmRing_wait after registering as a waiter */
+    SHM_RING_BARRIER ();
+    if (0 != header->mWaiters)
+    {
+        SHM_RING_FETCH_AND_ADD (&header->mNotify, 1);
+#if defined(__linux__)
+        syscall (SYS_futex, &header->mNotify, FUTEX_WAKE, INT_MAX,
+                 NULL, NULL, 0);
+#endif
+    }
+}
+
+shmRingReadStatus
+shmRing_peek (shmRing*          ring,
+              uint64_t*         cursor,
+              const void**      frame,
+              uint32_t*         length,
+              uint64_t*         lost)
+{
+    shmRingSlot*    slot        = SHM_RING_SLOT (ring, *cursor);
+    uint64_t        sequence    = slot->mSequence;
+    uint64_t        claim       = 0;
+
+    SHM_RING_BARRIER ();
+
+    if (sequence == *cursor + 1)
+    {
+        *frame  = (const void*) (slot + 1);
+        *length = slot->mLength;
+        return SHM_RING_READ_OK;
+    }
+
+    /*
+     * Either the slot still holds the previous lap or a producer is writing
+     * to it. The latter is only a problem if it is for a later lap.
+     */
+    claim = ring->mHeader->mClaim;
+    if (sequence > *cursor + 1 || claim > *cursor + ring->mMask + 1)
+    {
+        /* Skip to the head as everything in between is being overwritten */
+        *lost   = claim - *cursor;
+        *cursor = claim;
+        return SHM_RING_READ_OVERRUN;
+    }
+
+    return SHM_RING_READ_EMPTY;
+}
+
+shmRingReadStatus
+shmRing_release (shmRing* ring, uint64_t* cursor)
+{
+    shmRingSlot* slot = SHM_RING_SLOT (ring, *cursor);
+
+    /* Everything copied out of the slot must be read before re-checking */
+    SHM_RING_BARRIER ();
+
+    if (slot->mSequence != *cursor + 1)
+    {
+        /* The next peek will see the later lap and skip forward */
+        return SHM_RING_READ_OVERRUN;
+    }
+
+    (*cursor)++;
+
+    return SHM_RING_READ_OK;
+}
+
+void
+shmRing_wait (shmRing*          ring,
+              uint64_t          cursor,
+              shmRingWaitMode   mode,
+              uint32_t          spinCount,
+              uint32_t          timeout)
+{
+    shmRingHeader*  header  = ring->mHeader;
+    uint32_t        spin    = 0;
+#if defined(__linux__)
+    uint32_t        notify  = 0;
+    struct timespec ts;
+#endif
+
+    for (spin = 0; spin < spinCount; spin++)
+    {
+        if (shmRingImpl_isReady (ring, cursor))
+        {
+            return;
+        }
+        SHM_RING_PAUSE ();
+    }
+
+    if (SHM_RING_WAIT_POLL == mode)
+    {
+        return;
+    }
+
+#if defined(__linux__)
+    /* Taken before registering so that any wake from here on is noticed */
+    notify = header->mNotify;
+    SHM_RING_FETCH_AND_ADD (&header->mWaiters, 1);
+    SHM_RING_BARRIER ();
+
+    if (!shmRingImpl_isReady (ring, cursor))
+    {
+        ts.tv_sec  = timeout / 1000;
+        ts.tv_nsec = (long) (timeout % 1000) * 1000000L;
+
+        /* The ring is shared between processes so no FUTEX_PRIVATE_FLAG */
+        syscall (SYS_futex, &header->mNotify, FUTEX_WAIT, notify,
+                 &ts, NULL, 0);
+    }
+
+    SHM_RING_FETCH_AND_SUB (&header->mWaiters, 1);
+#else
+    (void) header;
+    (void) timeout;
+    shmRingImpl_sleepMicros (SHM_RING_FALLBACK_INTERVAL);
+#endif
+}
+
+
+/*=========================================================================
+  =                  Private implementation functions                     =
+  =========================================================================*/
+
+mama_status
+shmRingImpl_create (shmRing* ring, int fd, uint32_t slotCount,
+                    uint32_t slotBytes)
+{
+    shmRingHeader*  header  = NULL;
+    size_t          size    = sizeof (shmRingHeader)
+                            + (size_t) slotCount * slotBytes;
+
+    /* Newly extended shared memory is zero filled */
+    if (0 != ftruncate (fd, (off_t) size))
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmRingImpl_create(): Could not size ring to %lu "
+                  "bytes (%s).",
+                  (unsigned long) size, strerror (errno));
+        return MAMA_STATUS_PLATFORM;
+    }
+
+    header = (shmRingHeader*) mmap (NULL, size, PROT_READ | PROT_WRITE,
+                                    MAP_SHARED, fd, 0);
+    if (MAP_FAILED == (void*) header)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmRingImpl_create(): Could not map ring (%s).",
+                  strerror (errno));
+        return MAMA_STATUS_PLATFORM;
+    }
+
+    header->mVersion   = SHM_RING_VERSION;
+    header->mSlotCount = slotCount;
+    header->mSlotBytes = slotBytes;
+    header->mAttached  = 1;
+
+    /* Attaching processes wait on this so it goes last */
+    SHM_RING_BARRIER ();
+    header->mMagic     = SHM_RING_MAGIC;
+
+    ring->mHeader  = header;
+    ring->mMapSize = size;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+shmRingImpl_attach (shmRing* ring, int fd)
+{
+    shmRingHeader*  header  = NULL;
+    struct stat     info;
+    size_t          size    = 0;
+    int             retries = 0;
+
+    /* The creator may not have sized the segment yet */
+    for (retries = 0; retries < SHM_RING_ATTACH_RETRIES; retries++)
+    {
+        if (0 != fstat (fd, &info))
+        {
+            mama_log (MAMA_LOG_LEVEL_ERROR,
+                      "shmRingImpl_attach(): Could not stat ring (%s).",
+                      strerror (errno));
+            return MAMA_STATUS_PLATFORM;
+        }
+        if ((size_t) info.st_size >= sizeof (shmRingHeader))
+        {
+            break;
+        }
+        shmRingImpl_sleepMicros (SHM_RING_ATTACH_INTERVAL);
+    }
+
+    if ((size_t) info.st_size < sizeof (shmRingHeader))
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmRingImpl_attach(): Timed out waiting for the ring to "
+                  "be created.");
+        return MAMA_STATUS_TIMEOUT;
+    }
+
+    size   = (size_t) info.st_size;
+    header = (shmRingHeader*) mmap (NULL, size, PROT_READ | PROT_WRITE,
+                                    MAP_SHARED, fd, 0);
+    if (MAP_FAILED == (void*) header)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmRingImpl_attach(): Could not map ring (%s).",
+                  strerror (errno));
+        return MAMA_STATUS_PLATFORM;
+    }
+
+    for (; retries < SHM_RING_ATTACH_RETRIES; retries++)
+    {
+        if (SHM_RING_MAGIC == header->mMagic)
+        {
+            break;
+        }
+        shmRingImpl_sleepMicros (SHM_RING_ATTACH_INTERVAL);
+    }
+    SHM_RING_BARRIER ();
+
+    if (SHM_RING_MAGIC != header->mMagic
+        || SHM_RING_VERSION != header->mVersion
+        || sizeof (shmRingHeader)
+           + (size_t) header->mSlotCount * header->mSlotBytes > size)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmRingImpl_attach(): Shared memory object is not a "
+                  "valid version %d ring.",
+                  SHM_RING_VERSION);
+        munmap ((void*) header, size);
+        return MAMA_STATUS_INVALID_ARG;
+    }
+
+    ring->mHeader  = header;
+    ring->mMapSize = size;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+shmRingImpl_map (shmRing* ring, const char* name, uint32_t slotCount,
+                 uint32_t slotBytes)
+{
+    mama_status status   = MAMA_STATUS_OK;
+    uint32_t    attached = 0;
+    int         fd       = -1;
+
+    /* Only one process can win the exclusive create */
+    fd = shm_open (name, O_RDWR | O_CREAT | O_EXCL, 0660);
+    if (-1 != fd)
+    {
+        mama_log (MAMA_LOG_LEVEL_FINE,
+                  "shmRing_open(): Created ring %s (%u slots of %u bytes).",
+                  name, slotCount, slotBytes);
+        status = shmRingImpl_create (ring, fd, slotCount, slotBytes);
+
+        /* The mapping remains valid once the descriptor is closed */
+        close (fd);
+        if (MAMA_STATUS_OK != status)
+        {
+            shm_unlink (name);
+        }
+        return status;
+    }
+
+    if (EEXIST != errno)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmRing_open(): Could not create ring %s (%s).",
+                  name, strerror (errno));
+        return MAMA_STATUS_PLATFORM;
+    }
+
+    fd = shm_open (name, O_RDWR, 0);
+    if (-1 == fd)
+    {
+        /* Unlinked between the two opens */
+        if (ENOENT == errno)
+        {
+            return MAMA_STATUS_NOT_FOUND;
+        }
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmRing_open(): Could not open ring %s (%s).",
+                  name, strerror (errno));
+        return MAMA_STATUS_PLATFORM;
+    }
+
+    status = shmRingImpl_attach (ring, fd);
+    close (fd);
+    if (MAMA_STATUS_OK != status)
+    {
+        return status;
+    }
+
+    /*
+     * Once the count has dropped to zero the last process to close the ring
+     * is unlinking it, so it must never be raised from zero again.
+     */
+    do
+    {
+        attached = ring->mHeader->mAttached;
+        if (0 == attached)
+        {
+            munmap ((void*) ring->mHeader, ring->mMapSize);
+            ring->mHeader = NULL;
+            return MAMA_STATUS_NOT_FOUND;
+        }
+    } while (!SHM_RING_COMPARE_AND_SWAP (&ring->mHeader->mAttached,
+                                         attached, attached + 1));
+
+    if (ring->mHeader->mSlotCount != slotCount
+        || ring->mHeader->mSlotBytes != slotBytes)
+    {
+        mama_log (MAMA_LOG_LEVEL_WARN,
+                  "shmRing_open(): Ring %s already exists with %u slots "
+                  "of %u bytes - ignoring requested geometry.",
+                  name,
+                  ring->mHeader->mSlotCount,
+                  ring->mHeader->mSlotBytes);
+    }
+
+    return MAMA_STATUS_OK;
+}
+
+int
+shmRingImpl_isReady (shmRing* ring, uint64_t cursor)
+{
+    shmRingSlot* slot = SHM_RING_SLOT (ring, cursor);
+
+    return slot->mSequence >= cursor + 1
+        || ring->mHeader->mClaim > cursor + ring->mMask + 1;
+}
+
+void
+shmRingImpl_sleepMicros (long micros)
+{
+    struct timespec ts;
+
+    ts.tv_sec  = micros / 1000000L;
+    ts.tv_nsec = (micros % 1000000L) * 1000L;
+
+    nanosleep (&ts, NULL);
+}
@@ -0,0 +1,220 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#ifndef MAMA_BRIDGE_SHM_RING_H__
+#define MAMA_BRIDGE_SHM_RING_H__
+
+
+/*=========================================================================
+  =                             Includes                                  =
+  =========================================================================*/
+
+#include <mama/mama.h>
+
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+
+/*=========================================================================
+  =                Typedefs, structs, enums and globals                   =
+  =========================================================================*/
+
+/*
+ * A ring is a fixed number of fixed size slots in a named shared memory
+ * segment. Any number of processes may publish into the same ring: each
+ * producer claims the next sequence number with an atomic increment, writes
+ * its frame directly into the slot and then commits it by storing the
+ * sequence into the slot header. No locks are taken on the publish path.
+ *
+ * Readers are purely local: each one keeps its own cursor and never writes
+ * to the segment apart from registering as a waiter, so a slow reader can
+ * never hold up producers. If a reader falls more than a ring's length
+ * behind, the slots it has not read yet are overwritten and it is moved
+ * forward, losing those frames.
+ */
+typedef struct shmRing_ shmRing;
+
+/* How readers wait for frames when the ring is empty */
+typedef enum shmRingWaitMode_
+{
+    /* Sleep on a futex in the ring header, woken by producers */
+    SHM_RING_WAIT_FUTEX,
+    /* Spin on the next slot without ever sleeping */
+    SHM_RING_WAIT_POLL
+} shmRingWaitMode;
+
+/* Outcome of attempting to read the frame at a reader's cursor */
+typedef enum shmRingReadStatus_
+{
+    SHM_RING_READ_OK,
+    SHM_RING_READ_EMPTY,
+    SHM_RING_READ_OVERRUN
+} shmRingReadStatus;
+
+
+/*=========================================================================
+  =                  Public implementation functions                      =
+  =========================================================================*/
+
+/**
+ * This will open the named shared memory ring, creating and initialising it
+ * if no other process has done so yet. When the ring already exists, its
+ * geometry takes precedence over the one requested here.
+ *
+ * @param ring      Pointer to populate with the newly opened ring.
+ * @param name      The shared memory object name (e.g. "/mama_shm_sub_0").
+ * @param slotCount Number of slots, rounded up to a power of two.
+ * @param slotSize  Maximum frame size in bytes that a single slot can hold.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+mama_status
+shmRing_open (shmRing**     ring,
+              const char*   name,
+              uint32_t      slotCount,
+              uint32_t      slotSize);
+
+/**
+ * This will unmap the ring from this process. The shared memory object itself
+ * is left in place for the other processes still attached to it, and the last
+ * process to close it unlinks it. A process which exits without closing the
+ * ring leaves it in place until it is removed by hand.
+ *
+ * @param ring      The ring to close.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+mama_status
+shmRing_close (shmRing* ring);
+
+/**
+ * This will return the largest frame which fits into one slot of the ring.
+ *
+ * @param ring      The ring to query.
+ *
+ * @return Maximum frame size in bytes.
+ */
+uint32_t
+shmRing_getMaxFrameSize (shmRing* ring);
+
+/**
+ * This will return the sequence number which the next producer will claim,
+ * which is where a reader attaching now should start reading from.
+ *
+ * @param ring      The ring to query.
+ *
+ * @return The next sequence number to be claimed.
+ */
+uint64_t
+shmRing_getNextSequence (shmRing* ring);
+
+/**
+ * This will claim the next slot in the ring for a frame of the given length.
+ * The caller writes the frame into the returned buffer and must then call
+ * shmRing_commit with the same sequence.
+ *
+ * @param ring      The ring to claim a slot from.
+ * @param length    The length of the frame which is to be written.
+ * @param sequence  Populated with the sequence number of the claimed slot.
+ * @param buffer    Populated with the slot's frame buffer.
+ *
+ * @return mama_status MAMA_STATUS_INVALID_ARG if the frame does not fit into
+ *         a slot, otherwise MAMA_STATUS_OK.
+ */
+mama_status
+shmRing_claim (shmRing*     ring,
+               uint32_t     length,
+               uint64_t*    sequence,
+               void**       buffer);
+
+/**
+ * This will make a claimed frame visible to readers and wake any readers
+ * sleeping on the ring.
+ *
+ * @param ring      The ring the slot was claimed from.
+ * @param sequence  The sequence number returned by shmRing_claim.
+ */
+void
+shmRing_commit (shmRing* ring, uint64_t sequence);
+
+/**
+ * This will look at the frame at the reader's cursor without copying it. The
+ * frame may be overwritten by a producer at any time, so once the caller has
+ * copied what it needs it must call shmRing_release to find out whether the
+ * copy can be trusted.
+ *
+ * @param ring      The ring to read from.
+ * @param cursor    The reader's cursor. On SHM_RING_READ_OVERRUN, this is
+ *                  moved forward past the frames which have been lost.
+ * @param frame     Populated with the frame when SHM_RING_READ_OK.
+ * @param length    Populated with the frame length when SHM_RING_READ_OK.
+ * @param lost      Populated with the number of frames skipped over on
+ *                  SHM_RING_READ_OVERRUN.
+ *
+ * @return shmRingReadStatus indicating whether a frame is available.
+ */
+shmRingReadStatus
+shmRing_peek (shmRing*          ring,
+              uint64_t*         cursor,
+              const void**      frame,
+              uint32_t*         length,
+              uint64_t*         lost);
+
+/**
+ * This will finish reading the frame returned from shmRing_peek, advancing the
+ * cursor past it.
+ *
+ * @param ring      The ring which was read from.
+ * @param cursor    The reader's cursor, as passed to shmRing_peek.
+ *
+ * @return SHM_RING_READ_OK if the frame was not overwritten while it was being
+ *         read, otherwise SHM_RING_READ_OVERRUN and the data copied from it
+ *         must be discarded.
+ */
+shmRingReadStatus
+shmRing_release (shmRing* ring, uint64_t* cursor);
+
+/**
+ * This will block until a frame may be available at the reader's cursor, or
+ * until the timeout elapses. In SHM_RING_WAIT_POLL mode, or on platforms
+ * without futex support, this spins rather than sleeping.
+ *
+ * @param ring      The ring to wait on.
+ * @param cursor    The reader's cursor.
+ * @param mode      How to wait.
+ * @param spinCount Number of times to check the slot before sleeping.
+ * @param timeout   Maximum time to sleep in milliseconds.
+ */
+void
+shmRing_wait (shmRing*          ring,
+              uint64_t          cursor,
+              shmRingWaitMode   mode,
+              uint32_t          spinCount,
+              uint32_t          timeout);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* MAMA_BRIDGE_SHM_RING_H__ */
@@ -0,0 +1,147 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#ifndef MAMA_BRIDGE_SHM_SHMDEFS_H__
+#define MAMA_BRIDGE_SHM_SHMDEFS_H__
+
+
+/*=========================================================================
+  =                             Includes                                  =
+  =========================================================================*/
+
+#include <wombat/wtable.h>
+#include <wombat/mempool.h>
+#include <mama/mama.h>
+
+#include "ring.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+
+/*=========================================================================
+  =                              Macros                                   =
+  =========================================================================*/
+
+/* Maximum topic length */
+#define     MAX_SUBJECT_LENGTH              256
+#define     MAMA_ROOT_MARKET_DATA           "_MD"
+
+/* Message types */
+typedef enum shmMsgType_
+{
+    SHM_MSG_PUB_SUB         =               0x00,
+    SHM_MSG_INBOX_REQUEST,
+    SHM_MSG_INBOX_RESPONSE
+} shmMsgType;
+
+
+/*=========================================================================
+  =                Typedefs, structs, enums and globals                   =
+  =========================================================================*/
+
+/*
+ * Written at the start of every frame on the ring, followed by the NUL
+ * terminated subject, the NUL terminated inbox name (empty unless this is an
+ * inbox request) and finally the encoded payload.
+ */
+typedef struct shmFrameHeader_
+{
+    uint8_t             mMsgType;
+    uint8_t             mPayloadType;
+    uint16_t            mSubjectLen;
+    uint16_t            mInboxLen;
+    uint16_t            mReserved;
+    uint32_t            mPayloadLen;
+} shmFrameHeader;
+
+typedef struct shmTransportBridge_ shmTransportBridge;
+
+typedef struct shmSubscription_
+{
+    mamaMsgCallbacks    mMamaCallback;
+    mamaSubscription    mMamaSubscription;
+    mamaQueue           mMamaQueue;
+    void*               mShmQueue;
+    transportBridge     mTransport;
+    const char*         mSubject;
+    void*               mClosure;
+    int                 mIsNotMuted;
+    int                 mIsValid;
+    int                 mIsTportDisconnected;
+    /* Next subscription on the same subject, guarded by mSubscriptionLock */
+    struct shmSubscription_* mNext;
+} shmSubscription;
+
+/* One reader thread per topic group ring */
+typedef struct shmGroupDispatcher_
+{
+    shmTransportBridge* mTransport;
+    shmRing*            mRing;
+    unsigned int        mIndex;
+    wthread_t           mThread;
+    uint64_t            mCursor;
+    uint64_t            mLost;
+} shmGroupDispatcher;
+
+struct shmTransportBridge_
+{
+    int                 mIsValid;
+    mamaTransport       mTransport;
+    const char*         mName;
+    const char*         mRingPrefix;
+    unsigned int        mGroupCount;
+    shmGroupDispatcher* mGroups;
+    shmRingWaitMode     mWaitMode;
+    uint32_t            mSpinCount;
+    uint32_t            mWaitTimeout;
+    volatile int        mIsDispatching;
+    memoryPool*         mShmMsgPool;
+    /* Subject to first shmSubscription, filtered against each frame read */
+    wtable_t            mSubscriptions;
+    wthread_mutex_t     mSubscriptionLock;
+};
+
+/*
+ * Copied out of the ring for each matching subscription and enqueued. The
+ * payload is stored directly after this structure in the memory node.
+ */
+typedef struct shmMsgNode_
+{
+    shmTransportBridge* mTransport;
+    shmSubscription*    mSubscription;
+    shmMsgType          mMsgType;
+    mamaPayloadType     mPayloadType;
+    uint32_t            mPayloadLen;
+    char                mSubject[MAX_SUBJECT_LENGTH];
+    char                mInbox[MAX_SUBJECT_LENGTH];
+    /* Latency stamps, zero unless mamaLatency_isEnabled */
+    mama_u64_t          mReceiveTime;
+    mama_u64_t          mEnqueueTime;
+} shmMsgNode;
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* MAMA_BRIDGE_SHM_SHMDEFS_H__ */
@@ -0,0 +1,247 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+/*=========================================================================
+  =                             Includes                                  =
+  =========================================================================*/
+
+#include <string.h>
+#include <mama/mama.h>
+#include <subscriptionimpl.h>
+#include <transportimpl.h>
+#include <queueimpl.h>
+#include "shmbridgefunctions.h"
+#include "transport.h"
+#include "shmdefs.h"
+
+
+/*=========================================================================
+  =               Public interface implementation functions               =
+  =========================================================================*/
+
+mama_status
+shmBridgeMamaSubscription_create (subscriptionBridge* subscriber,
+                                  const char*         source,
+                                  const char*         symbol,
+                                  mamaTransport       tport,
+                                  mamaQueue           queue,
+                                  mamaMsgCallbacks    callback,
+                                  mamaSubscription    subscription,
+                                  void*               closure)
+{
+    shmSubscription*        impl        = NULL;
+    shmTransportBridge*     transport   = NULL;
+    mama_status             status      = MAMA_STATUS_OK;
+
+    if (NULL == subscriber || NULL == subscription || NULL == tport)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmBridgeMamaSubscription_create(): something NULL");
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    status = mamaTransport_getBridgeTransport (tport,
+                                               (transportBridge*) &transport);
+
+    if (MAMA_STATUS_OK != status || NULL == transport)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmBridgeMamaSubscription_create(): something NULL");
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Allocate memory for shm subscription implementation */
+    impl = (shmSubscription*) calloc (1, sizeof (shmSubscription));
+    if (NULL == impl)
+    {
+        return MAMA_STATUS_NOMEM;
+    }
+
+    mamaQueue_getNativeHandle (queue, &impl->mShmQueue);
+    impl->mMamaCallback        = callback;
+    impl->mMamaSubscription    = subscription;
+    impl->mMamaQueue           = queue;
+    impl->mTransport           = (transportBridge) transport;
+    impl->mClosure             = closure;
+    impl->mIsNotMuted          = 1;
+    impl->mIsTportDisconnected = 0;
+    impl->mSubject             = NULL;
+
+    /* Use a standard centralized method to determine a topic key */
+    status = shmBridgeMamaTransportImpl_generateSubjectKey (NULL,
+                                                            source,
+                                                            symbol,
+                                                            &impl->mSubject);
+    if (MAMA_STATUS_OK != status)
+    {
+        free (impl);
+        return status;
+    }
+
+    /* Mark this subscription as valid before frames can be routed to it */
+    impl->mIsValid = 1;
+
+    /* Register the interest with the transport's dispatch threads */
+    status = shmBridgeMamaTransportImpl_registerSubscription (transport, impl);
+    if (MAMA_STATUS_OK != status)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmBridgeMamaSubscription_create(): "
+                  "Could not register interest for %s [%s]",
+                  impl->mSubject,
+                  mamaStatus_stringForStatus (status));
+        free ((void*) impl->mSubject);
+        free (impl);
+        return status;
+    }
+
+    mama_log (MAMA_LOG_LEVEL_FINEST,
+              "shmBridgeMamaSubscription_create(): "
+              "created interest for %s.",
+              impl->mSubject);
+
+    *subscriber = (subscriptionBridge) impl;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+shmBridgeMamaSubscription_createWildCard (subscriptionBridge*     subscriber,
+                                          const char*             source,
+                                          const char*             symbol,
+                                          mamaTransport           transport,
+                                          mamaQueue               queue,
+                                          mamaMsgCallbacks        callback,
+                                          mamaSubscription        subscription,
+                                          void*                   closure)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+shmBridgeMamaSubscription_mute (subscriptionBridge subscriber)
+{
+    shmSubscription* impl = (shmSubscription*) subscriber;
+
+    if (NULL == impl)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    impl->mIsNotMuted = 0;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+shmBridgeMamaSubscription_destroy (subscriptionBridge subscriber)
+{
+    shmSubscription*             impl            = NULL;
+    shmTransportBridge*          transportBridge = NULL;
+    mamaSubscription             parent          = NULL;
+    void*                        closure         = NULL;
+    wombat_subscriptionDestroyCB destroyCb       = NULL;
+
+    if (NULL == subscriber)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    impl            = (shmSubscription*) subscriber;
+    parent          = impl->mMamaSubscription;
+    closure         = impl->mClosure;
+    destroyCb       = impl->mMamaCallback.onDestroy;
+    transportBridge = (shmTransportBridge*) impl->mTransport;
+
+    /* Stop routing frames to this subscription before it is freed */
+    if (NULL != transportBridge)
+    {
+        shmBridgeMamaTransportImpl_unregisterSubscription (transportBridge,
+                                                           impl);
+    }
+
+    if (NULL != impl->mSubject)
+    {
+        free ((void*) impl->mSubject);
+    }
+
+    free (impl);
+
+    /*
+     * Invoke the subscription callback to inform that the bridge has been
+     * destroyed.
+     */
+    if (NULL != destroyCb)
+        (*(wombat_subscriptionDestroyCB)destroyCb)(parent, closure);
+
+    return MAMA_STATUS_OK;
+}
+
+int
+shmBridgeMamaSubscription_isValid (subscriptionBridge subscriber)
+{
+    shmSubscription* impl = (shmSubscription*) subscriber;
+
+    if (NULL != impl)
+    {
+        return impl->mIsValid;
+    }
+    return 0;
+}
+
+int
+shmBridgeMamaSubscription_hasWildcards (subscriptionBridge subscriber)
+{
+    return 0;
+}
+
+mama_status
+shmBridgeMamaSubscription_getPlatformError (subscriptionBridge subscriber,
+                                            void** error)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+int
+shmBridgeMamaSubscription_isTportDisconnected (subscriptionBridge subscriber)
+{
+    shmSubscription* impl = (shmSubscription*) subscriber;
+    if (NULL == impl)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+    return impl->mIsTportDisconnected;
+}
+
+mama_status
+shmBridgeMamaSubscription_setTopicClosure (subscriptionBridge subscriber,
+                                           void* closure)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+shmBridgeMamaSubscription_muteCurrentTopic (subscriptionBridge subscriber)
+{
+    /* As there is one topic per subscription, this can act as an alias */
+    return shmBridgeMamaSubscription_mute (subscriber);
+}
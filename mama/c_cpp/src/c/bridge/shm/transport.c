@@ -0,0 +1,1311 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+
+/*=========================================================================
+  =                             Includes                                  =
+  =========================================================================*/
+
+#include <wombat/port.h>
+#include <property.h>
+#include <mama/mama.h>
+#include <queueimpl.h>
+#include <msgimpl.h>
+#include <subscriptionimpl.h>
+#include <transportimpl.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <errno.h>
+
+#include "transport.h"
+#include "shmbridgefunctions.h"
+#include "shmdefs.h"
+#include "msg.h"
+#include "ring.h"
+
+/*=========================================================================
+  =                              Macros                                   =
+  =========================================================================*/
+
+/* Transport configuration parameters */
+#define     TPORT_PARAM_PREFIX              "mama.shm.transport"
+#define     TPORT_PARAM_RING_NAME           "ring_name"
+#define     TPORT_PARAM_GROUPS              "groups"
+#define     TPORT_PARAM_SLOT_COUNT          "slot_count"
+#define     TPORT_PARAM_SLOT_SIZE           "slot_size"
+#define     TPORT_PARAM_WAIT_MODE           "wait_mode"
+#define     TPORT_PARAM_SPIN_COUNT          "spin_count"
+#define     TPORT_PARAM_SUB_POOL_SIZE       "msg_pool_size"
+
+/* Default values for corresponding configuration parameters */
+#define     DEFAULT_RING_NAME               "mama"
+#define     DEFAULT_GROUPS                  4
+#define     DEFAULT_SLOT_COUNT              4096
+#define     DEFAULT_SLOT_SIZE               4096
+#define     DEFAULT_WAIT_MODE               "futex"
+#define     DEFAULT_SPIN_COUNT              1000
+#define     DEFAULT_SUB_POOL_SIZE           128
+
+/* Non configurable runtime defaults */
+#define     PARAM_NAME_MAX_LENGTH           1024L
+#define     RING_NAME_MAX_LENGTH            256
+#define     MIN_GROUPS                      1L
+#define     MAX_GROUPS                      64L
+#define     MIN_SLOT_COUNT                  2L
+#define     MAX_SLOT_COUNT                  16777216L
+#define     MIN_SLOT_SIZE                   256L
+#define     MAX_SLOT_SIZE                   1048576L
+#define     MIN_SPIN_COUNT                  0L
+#define     MAX_SPIN_COUNT                  10000000L
+#define     MIN_SUB_POOL_SIZE               1L
+#define     MAX_SUB_POOL_SIZE               30000L
+#define     CONFIG_VALUE_WAIT_MODE_FUTEX    "futex"
+#define     CONFIG_VALUE_WAIT_MODE_POLL     "poll"
+#define     SUBSCRIPTIONS_WTABLE_SIZE       1024
+/* Upper bound on how long a reader sleeps before checking for shutdown */
+#define     SHM_WAIT_TIMEOUT                10 /* milliseconds */
+
+
+/*=========================================================================
+  =                  Private implementation prototypes                    =
+  =========================================================================*/
+
+/**
+ * This function is called in the create function and is responsible for
+ * opening the topic group rings and forking off a reader thread for each.
+ *
+ * @param impl  Shm transport bridge to start
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+static mama_status
+shmBridgeMamaTransportImpl_start (shmTransportBridge* impl);
+
+/**
+ * This function is called in the destroy function and is responsible for
+ * stopping the reader threads and unmapping the rings.
+ *
+ * @param impl  Shm transport bridge to stop
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+static mama_status
+shmBridgeMamaTransportImpl_stop (shmTransportBridge* impl);
+
+/**
+ * This is the function which each topic group's reader thread runs. It reads
+ * frames from the group's ring, filters them by subject and enqueues a copy
+ * for each interested subscription.
+ *
+ * @param closure   The shmGroupDispatcher for the group.
+ */
+static void*
+shmBridgeMamaTransportImpl_dispatchThread (void* closure);
+
+/**
+ * This copies a frame read from a ring into a message node for each
+ * subscription registered against its subject. The nodes are returned as a
+ * list linked through memoryNode::mNext, not yet enqueued, as the frame may
+ * turn out to have been overwritten while it was being copied.
+ *
+ * @param impl      The shm transport bridge.
+ * @param frame     The frame as read from the ring.
+ * @param length    The length of the frame.
+ *
+ * @return The first node of the list, or NULL if nothing is interested.
+ */
+static memoryNode*
+shmBridgeMamaTransportImpl_copyFrame (shmTransportBridge*  impl,
+                                      const uint8_t*       frame,
+                                      uint32_t             length);
+
+/**
+ * This is the callback enqueued for each message node. It hands the payload
+ * to the subscription's MAMA queue message and processes it.
+ *
+ * @param queue     The MAMA queue dispatching the event.
+ * @param closure   The memoryNode holding the shmMsgNode.
+ */
+static void MAMACALLTYPE
+shmBridgeMamaTransportImpl_queueCallback (mamaQueue queue, void* closure);
+
+/**
+ * This checks, with the subscription lock held by the caller, whether the
+ * subscription is still registered against the subject.
+ *
+ * @param impl          The shm transport bridge.
+ * @param subject       The subject key.
+ * @param subscription  The subscription to look for.
+ *
+ * @return Non zero if the subscription is registered.
+ */
+static int
+shmBridgeMamaTransportImpl_isSubscribed (shmTransportBridge*  impl,
+                                         const char*          subject,
+                                         shmSubscription*     subscription);
+
+/* FNV-1a, used to spread subjects over topic groups */
+static uint32_t
+shmBridgeMamaTransportImpl_hashSubject (const char* subject);
+
+static long int
+shmBridgeMamaTransportImpl_getParameterAsLong (long        defaultVal,
+                                               long        minimum,
+                                               long        maximum,
+                                               const char* format,
+                                               ...);
+
+static const char*
+shmBridgeMamaTransportImpl_getParameterWithVaList (char*       defaultVal,
+                                                   char*       paramName,
+                                                   const char* format,
+                                                   va_list     arguments);
+
+static const char*
+shmBridgeMamaTransportImpl_getParameter (const char* defaultVal,
+                                         const char* format,
+                                         ...);
+
+
+/*=========================================================================
+  =               Public interface implementation functions               =
+  =========================================================================*/
+
+int
+shmBridgeMamaTransport_isValid (transportBridge transport)
+{
+    shmTransportBridge*     impl   = (shmTransportBridge*) transport;
+    int                     status = 0;
+
+    if (NULL != impl)
+    {
+        status = impl->mIsValid;
+    }
+    return status;
+}
+
+mama_status
+shmBridgeMamaTransport_destroy (transportBridge transport)
+{
+    shmTransportBridge*     impl    = NULL;
+    mama_status             status  = MAMA_STATUS_OK;
+
+    if (NULL == transport)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    impl  = (shmTransportBridge*) transport;
+
+    status = shmBridgeMamaTransportImpl_stop (impl);
+
+    memoryPool_destroy (impl->mShmMsgPool, NULL);
+
+    /* The subscriptions themselves are owned by their subscription bridges */
+    wtable_free_all_xdata (impl->mSubscriptions);
+    wtable_destroy (impl->mSubscriptions);
+    wthread_mutex_destroy (&impl->mSubscriptionLock);
+
+    free (impl->mGroups);
+    free (impl);
+
+    return status;
+}
+
+mama_status
+shmBridgeMamaTransport_create (transportBridge*    result,
+                               const char*         name,
+                               mamaTransport       parent)
+{
+    shmTransportBridge*     impl       = NULL;
+    int                     poolSize   = 0;
+    const char*             waitMode   = NULL;
+    mama_status             status     = MAMA_STATUS_OK;
+
+    if (NULL == result || NULL == name || NULL == parent)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    impl = (shmTransportBridge*) calloc (1, sizeof (shmTransportBridge));
+    if (NULL == impl)
+    {
+        return MAMA_STATUS_NOMEM;
+    }
+
+    /* Back reference the MAMA transport */
+    impl->mTransport           = parent;
+    impl->mName                = name;
+    impl->mWaitTimeout         = SHM_WAIT_TIMEOUT;
+
+    mama_log (MAMA_LOG_LEVEL_FINE,
+              "shmBridgeMamaTransport_create(): Initializing Transport %s",
+              name);
+
+    /* Transports which name the same ring share data, whatever their name */
+    impl->mRingPrefix =
+        shmBridgeMamaTransportImpl_getParameter (
+            DEFAULT_RING_NAME,
+            "%s.%s.%s",
+            TPORT_PARAM_PREFIX,
+            name,
+            TPORT_PARAM_RING_NAME);
+
+    impl->mGroupCount =
+        (unsigned int) shmBridgeMamaTransportImpl_getParameterAsLong (
+            DEFAULT_GROUPS,
+            MIN_GROUPS,
+            MAX_GROUPS,
+            "%s.%s.%s",
+            TPORT_PARAM_PREFIX,
+            name,
+            TPORT_PARAM_GROUPS);
+
+    impl->mSpinCount =
+        (uint32_t) shmBridgeMamaTransportImpl_getParameterAsLong (
+            DEFAULT_SPIN_COUNT,
+            MIN_SPIN_COUNT,
+            MAX_SPIN_COUNT,
+            "%s.%s.%s",
+            TPORT_PARAM_PREFIX,
+            name,
+            TPORT_PARAM_SPIN_COUNT);
+
+    waitMode =
+        shmBridgeMamaTransportImpl_getParameter (
+            DEFAULT_WAIT_MODE,
+            "%s.%s.%s",
+            TPORT_PARAM_PREFIX,
+            name,
+            TPORT_PARAM_WAIT_MODE);
+
+    if (0 == strcmp (waitMode, CONFIG_VALUE_WAIT_MODE_POLL))
+    {
+        impl->mWaitMode = SHM_RING_WAIT_POLL;
+    }
+    else
+    {
+        if (0 != strcmp (waitMode, CONFIG_VALUE_WAIT_MODE_FUTEX))
+        {
+            mama_log (MAMA_LOG_LEVEL_ERROR,
+                      "Could not parse %s.%s.%s=%s. Using [%s].",
+                      TPORT_PARAM_PREFIX,
+                      name,
+                      TPORT_PARAM_WAIT_MODE,
+                      waitMode,
+                      DEFAULT_WAIT_MODE);
+        }
+        impl->mWaitMode = SHM_RING_WAIT_FUTEX;
+    }
+
+    /* Set the message pool size for pool initialization later */
+    poolSize =
+        (int) shmBridgeMamaTransportImpl_getParameterAsLong (
+            DEFAULT_SUB_POOL_SIZE,
+            MIN_SUB_POOL_SIZE,
+            MAX_SUB_POOL_SIZE,
+            "%s.%s",
+            TPORT_PARAM_PREFIX,
+            TPORT_PARAM_SUB_POOL_SIZE);
+
+    /* Nodes are stretched to fit each payload as they are taken */
+    impl->mShmMsgPool = memoryPool_create (poolSize, sizeof (shmMsgNode));
+    if (NULL == impl->mShmMsgPool)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmBridgeMamaTransport_create(): "
+                  "Failed to create msgPool (%s). Exiting.", strerror(errno));
+        free (impl);
+        return MAMA_STATUS_PLATFORM;
+    }
+
+    impl->mGroups = (shmGroupDispatcher*) calloc (impl->mGroupCount,
+                                                  sizeof (shmGroupDispatcher));
+    impl->mSubscriptions = wtable_create ("mSubscriptions",
+                                          SUBSCRIPTIONS_WTABLE_SIZE);
+    if (NULL == impl->mGroups || NULL == impl->mSubscriptions)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmBridgeMamaTransport_create(): "
+                  "Failed to allocate topic groups.");
+        memoryPool_destroy (impl->mShmMsgPool, NULL);
+        if (NULL != impl->mSubscriptions)
+        {
+            wtable_destroy (impl->mSubscriptions);
+        }
+        free (impl->mGroups);
+        free (impl);
+        return MAMA_STATUS_NOMEM;
+    }
+    wthread_mutex_init (&impl->mSubscriptionLock, NULL);
+
+    status = shmBridgeMamaTransportImpl_start (impl);
+    if (MAMA_STATUS_OK != status)
+    {
+        shmBridgeMamaTransport_destroy ((transportBridge) impl);
+        return status;
+    }
+
+    impl->mIsValid = 1;
+
+    *result = (transportBridge) impl;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+shmBridgeMamaTransport_forceClientDisconnect (transportBridge*   transports,
+                                              int                numTransports,
+                                              const char*        ipAddress,
+                                              uint16_t           port)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+shmBridgeMamaTransport_findConnection (transportBridge*    transports,
+                                       int                 numTransports,
+                                       mamaConnection*     result,
+                                       const char*         ipAddress,
+                                       uint16_t            port)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+shmBridgeMamaTransport_getAllConnections (transportBridge*    transports,
+                                          int                 numTransports,
+                                          mamaConnection**    result,
+                                          uint32_t*           len)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+shmBridgeMamaTransport_getAllConnectionsForTopic (
+                   transportBridge*    transports,
+                   int                 numTransports,
+                   const char*         topic,
+                   mamaConnection**    result,
+                   uint32_t*           len)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+shmBridgeMamaTransport_requestConflation (transportBridge*     transports,
+                                          int                  numTransports)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+shmBridgeMamaTransport_requestEndConflation (transportBridge*  transports,
+                                             int               numTransports)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+shmBridgeMamaTransport_getAllServerConnections (
+       transportBridge*        transports,
+       int                     numTransports,
+       mamaServerConnection**  result,
+       uint32_t*               len)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+shmBridgeMamaTransport_freeAllServerConnections (
+       transportBridge*        transports,
+       int                     numTransports,
+       mamaServerConnection*   result,
+       uint32_t                len)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+shmBridgeMamaTransport_freeAllConnections (transportBridge*    transports,
+                                           int                 numTransports,
+                                           mamaConnection*     result,
+                                           uint32_t            len)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+shmBridgeMamaTransport_getNumLoadBalanceAttributes (
+       const char*     name,
+       int*            numLoadBalanceAttributes)
+{
+    if (NULL == numLoadBalanceAttributes || NULL == name)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    *numLoadBalanceAttributes = 0;
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+shmBridgeMamaTransport_getLoadBalanceSharedObjectName (
+       const char*     name,
+       const char**    loadBalanceSharedObjectName)
+{
+    if (NULL == loadBalanceSharedObjectName)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    *loadBalanceSharedObjectName = NULL;
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+shmBridgeMamaTransport_getLoadBalanceScheme (const char*       name,
+                                             tportLbScheme*    scheme)
+{
+    if (NULL == scheme || NULL == name)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    *scheme = TPORT_LB_SCHEME_STATIC;
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+shmBridgeMamaTransport_sendMsgToConnection (transportBridge    tport,
+                                            mamaConnection     connection,
+                                            mamaMsg            msg,
+                                            const char*        topic)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+shmBridgeMamaTransport_isConnectionIntercepted (mamaConnection connection,
+                                                uint8_t*       result)
+{
+    if (NULL == result)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    *result = 0;
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+shmBridgeMamaTransport_installConnectConflateMgr (
+       transportBridge         handle,
+       mamaConflationManager   mgr,
+       mamaConnection          connection,
+       conflateProcessCb       processCb,
+       conflateGetMsgCb        msgCb)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+shmBridgeMamaTransport_uninstallConnectConflateMgr (
+       transportBridge         handle,
+       mamaConflationManager   mgr,
+       mamaConnection          connection)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+shmBridgeMamaTransport_startConnectionConflation (
+       transportBridge         tport,
+       mamaConflationManager   mgr,
+       mamaConnection          connection)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+shmBridgeMamaTransport_getNativeTransport (transportBridge     transport,
+                                           void**              result)
+{
+    shmTransportBridge* impl = (shmTransportBridge*)transport;
+
+    if (NULL == transport || NULL == result)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+    *result = impl;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+shmBridgeMamaTransport_getNativeTransportNamingCtx (transportBridge transport,
+                                                    void**          result)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+
+
+/*=========================================================================
+  =                  Public implementation functions                      =
+  =========================================================================*/
+
+shmTransportBridge*
+shmBridgeMamaTransportImpl_getTransportBridge (mamaTransport transport)
+{
+    shmTransportBridge* impl    = NULL;
+    mama_status         status  = MAMA_STATUS_OK;
+
+    status = mamaTransport_getBridgeTransport (transport,
+                                               (transportBridge*) &impl);
+
+    if (MAMA_STATUS_OK != status || NULL == impl)
+    {
+        return NULL;
+    }
+
+    return impl;
+}
+
+shmRing*
+shmBridgeMamaTransportImpl_getRing (shmTransportBridge* impl,
+                                    const char*         subject)
+{
+    uint32_t group = shmBridgeMamaTransportImpl_hashSubject (subject)
+                   % impl->mGroupCount;
+
+    return impl->mGroups[group].mRing;
+}
+
+mama_status
+shmBridgeMamaTransportImpl_registerSubscription (
+        shmTransportBridge* impl,
+        shmSubscription*    subscription)
+{
+    shmSubscription*    head    = NULL;
+    mama_status         status  = MAMA_STATUS_OK;
+
+    if (NULL == impl || NULL == subscription || NULL == subscription->mSubject)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    wthread_mutex_lock (&impl->mSubscriptionLock);
+
+    /* New subscriptions go to the front of the subject's list */
+    head = (shmSubscription*) wtable_lookup (impl->mSubscriptions,
+                                             subscription->mSubject);
+    subscription->mNext = head;
+
+    if (wtable_insert (impl->mSubscriptions,
+                       subscription->mSubject,
+                       subscription) < 0)
+    {
+        subscription->mNext = NULL;
+        status = MAMA_STATUS_NOMEM;
+    }
+
+    wthread_mutex_unlock (&impl->mSubscriptionLock);
+
+    return status;
+}
+
+void
+shmBridgeMamaTransportImpl_unregisterSubscription (
+        shmTransportBridge* impl,
+        shmSubscription*    subscription)
+{
+    shmSubscription*    head    = NULL;
+    shmSubscription**   link    = NULL;
+
+    if (NULL == impl || NULL == subscription || NULL == subscription->mSubject)
+    {
+        return;
+    }
+
+    wthread_mutex_lock (&impl->mSubscriptionLock);
+
+    head = (shmSubscription*) wtable_lookup (impl->mSubscriptions,
+                                             subscription->mSubject);
+
+    for (link = &head; NULL != *link; link = &(*link)->mNext)
+    {
+        if (*link == subscription)
+        {
+            *link = subscription->mNext;
+            break;
+        }
+    }
+
+    if (NULL == head)
+    {
+        wtable_remove (impl->mSubscriptions, subscription->mSubject);
+    }
+    else
+    {
+        wtable_insert (impl->mSubscriptions, subscription->mSubject, head);
+    }
+
+    subscription->mNext = NULL;
+
+    wthread_mutex_unlock (&impl->mSubscriptionLock);
+}
+
+mama_status
+shmBridgeMamaTransportImpl_generateSubjectKey (const char*  root,
+                                               const char*  source,
+                                               const char*  topic,
+                                               const char** keyTarget)
+{
+    char        subject[MAX_SUBJECT_LENGTH];
+    const char* parts[3];
+    size_t      written = 0;
+    int         i       = 0;
+
+    if (NULL == keyTarget)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    parts[0] = root;
+    parts[1] = source;
+    parts[2] = topic;
+    subject[0] = '\0';
+
+    /* Join whichever parts are present with periods */
+    for (i = 0; i < 3; i++)
+    {
+        if (NULL == parts[i] || written >= sizeof (subject))
+        {
+            continue;
+        }
+        written += snprintf (subject + written,
+                             sizeof (subject) - written,
+                             0 == written ? "%s" : ".%s",
+                             parts[i]);
+    }
+
+    if (written >= sizeof (subject))
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmBridgeMamaTransportImpl_generateSubjectKey(): "
+                  "Subject exceeds %d characters.",
+                  MAX_SUBJECT_LENGTH - 1);
+        return MAMA_STATUS_INVALID_ARG;
+    }
+
+    /* Caller is responsible for destroying */
+    *keyTarget = strdup (subject);
+    if (NULL == *keyTarget)
+    {
+        return MAMA_STATUS_NOMEM;
+    }
+
+    return MAMA_STATUS_OK;
+}
+
+
+/*=========================================================================
+  =                  Private implementation functions                     =
+  =========================================================================*/
+
+mama_status
+shmBridgeMamaTransportImpl_start (shmTransportBridge* impl)
+{
+    char            ringName[RING_NAME_MAX_LENGTH];
+    long            slotCount   = 0;
+    long            slotSize    = 0;
+    unsigned int    i           = 0;
+    int             rc          = 0;
+    mama_status     status      = MAMA_STATUS_OK;
+
+    slotCount = shmBridgeMamaTransportImpl_getParameterAsLong (
+                    DEFAULT_SLOT_COUNT,
+                    MIN_SLOT_COUNT,
+                    MAX_SLOT_COUNT,
+                    "%s.%s.%s",
+                    TPORT_PARAM_PREFIX,
+                    impl->mName,
+                    TPORT_PARAM_SLOT_COUNT);
+
+    slotSize  = shmBridgeMamaTransportImpl_getParameterAsLong (
+                    DEFAULT_SLOT_SIZE,
+                    MIN_SLOT_SIZE,
+                    MAX_SLOT_SIZE,
+                    "%s.%s.%s",
+                    TPORT_PARAM_PREFIX,
+                    impl->mName,
+                    TPORT_PARAM_SLOT_SIZE);
+
+    for (i = 0; i < impl->mGroupCount; i++)
+    {
+        snprintf (ringName, sizeof (ringName), "/mama_shm_%s_%u",
+                  impl->mRingPrefix, i);
+
+        status = shmRing_open (&impl->mGroups[i].mRing,
+                               ringName,
+                               (uint32_t) slotCount,
+                               (uint32_t) slotSize);
+        if (MAMA_STATUS_OK != status)
+        {
+            mama_log (MAMA_LOG_LEVEL_ERROR,
+                      "shmBridgeMamaTransportImpl_start(): "
+                      "Could not open ring %s (%s).",
+                      ringName,
+                      mamaStatus_stringForStatus (status));
+            return status;
+        }
+
+        /* Only frames published from now on are of interest */
+        impl->mGroups[i].mTransport = impl;
+        impl->mGroups[i].mIndex     = i;
+        impl->mGroups[i].mCursor    =
+            shmRing_getNextSequence (impl->mGroups[i].mRing);
+    }
+
+    /* Set the transport bridge mIsDispatching to true. */
+    impl->mIsDispatching = 1;
+
+    for (i = 0; i < impl->mGroupCount; i++)
+    {
+        rc = wthread_create (&impl->mGroups[i].mThread,
+                             NULL,
+                             shmBridgeMamaTransportImpl_dispatchThread,
+                             &impl->mGroups[i]);
+        if (0 != rc)
+        {
+            mama_log (MAMA_LOG_LEVEL_ERROR, "shmBridgeMamaTransportImpl_start(): "
+                      "wthread_create returned %d", rc);
+            return MAMA_STATUS_PLATFORM;
+        }
+    }
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+shmBridgeMamaTransportImpl_stop (shmTransportBridge* impl)
+{
+    unsigned int    i   = 0;
+
+    /* Readers never sleep for longer than SHM_WAIT_TIMEOUT */
+    impl->mIsDispatching = 0;
+
+    mama_log (MAMA_LOG_LEVEL_FINEST, "shmBridgeMamaTransportImpl_stop(): "
+              "Waiting on dispatch threads to terminate.");
+
+    for (i = 0; i < impl->mGroupCount; i++)
+    {
+        if (0 != impl->mGroups[i].mThread)
+        {
+            wthread_join (impl->mGroups[i].mThread, NULL);
+            impl->mGroups[i].mThread = 0;
+        }
+
+        if (NULL != impl->mGroups[i].mRing)
+        {
+            if (0 != impl->mGroups[i].mLost)
+            {
+                mama_log (MAMA_LOG_LEVEL_NORMAL,
+                          "shmBridgeMamaTransportImpl_stop(): "
+                          "%llu frames were lost on topic group %u.",
+                          (unsigned long long) impl->mGroups[i].mLost, i);
+            }
+            shmRing_close (impl->mGroups[i].mRing);
+            impl->mGroups[i].mRing = NULL;
+        }
+    }
+
+    return MAMA_STATUS_OK;
+}
+
+void*
+shmBridgeMamaTransportImpl_dispatchThread (void* closure)
+{
+    shmGroupDispatcher*     group   = (shmGroupDispatcher*) closure;
+    shmTransportBridge*     impl    = group->mTransport;
+    const void*             frame   = NULL;
+    uint32_t                length  = 0;
+    uint64_t                lost    = 0;
+    memoryNode*             pending = NULL;
+    memoryNode*             node    = NULL;
+    shmMsgNode*             msgNode = NULL;
+
+    /*
+     * Check if we should be still dispatching.
+     * We shouldn't need to lock around this, as we're performing a simple value
+     * read - if it changes in the middle of the read, we don't actually care.
+     */
+    while (1 == impl->mIsDispatching)
+    {
+        switch (shmRing_peek (group->mRing, &group->mCursor,
+                              &frame, &length, &lost))
+        {
+        case SHM_RING_READ_EMPTY:
+            shmRing_wait (group->mRing,
+                          group->mCursor,
+                          impl->mWaitMode,
+                          impl->mSpinCount,
+                          impl->mWaitTimeout);
+            continue;
+
+        case SHM_RING_READ_OVERRUN:
+            group->mLost += lost;
+            mama_log (MAMA_LOG_LEVEL_WARN,
+                      "shmBridgeMamaTransportImpl_dispatchThread(): "
+                      "Reader lapped on topic group %u - %llu frames lost.",
+                      group->mIndex,
+                      (unsigned long long) lost);
+            continue;
+
+        case SHM_RING_READ_OK:
+        default:
+            break;
+        }
+
+        pending = shmBridgeMamaTransportImpl_copyFrame (impl,
+                                                        (const uint8_t*) frame,
+                                                        length);
+
+        /* If a producer lapped us while copying, the copies are garbage */
+        if (SHM_RING_READ_OK != shmRing_release (group->mRing,
+                                                 &group->mCursor))
+        {
+            while (NULL != pending)
+            {
+                node    = pending;
+                pending = node->mNext;
+                memoryPool_returnNode (impl->mShmMsgPool, node);
+            }
+            continue;
+        }
+
+        /* Within this loop, queue callbacks release the pool messages */
+        while (NULL != pending)
+        {
+            node    = pending;
+            pending = node->mNext;
+            msgNode = (shmMsgNode*) node->mNodeBuffer;
+
+            msgNode->mEnqueueTime = msgNode->mReceiveTime
+                                  ? mamaLatency_getTimestamp () : 0;
+
+            shmBridgeMamaQueue_enqueueEvent (
+                    (queueBridge) msgNode->mSubscription->mShmQueue,
+                    shmBridgeMamaTransportImpl_queueCallback,
+                    node);
+        }
+    }
+
+    return NULL;
+}
+
+memoryNode*
+shmBridgeMamaTransportImpl_copyFrame (shmTransportBridge*  impl,
+                                      const uint8_t*       frame,
+                                      uint32_t             length)
+{
+    shmFrameHeader          header;
+    char                    subject[MAX_SUBJECT_LENGTH];
+    char                    inbox[MAX_SUBJECT_LENGTH];
+    const uint8_t*          payload      = NULL;
+    shmSubscription*        subscription = NULL;
+    memoryNode*             pending      = NULL;
+    memoryNode*             node         = NULL;
+    shmMsgNode*             msgNode      = NULL;
+    mama_u64_t              receiveTime  = 0;
+
+    if (length < sizeof (shmFrameHeader))
+    {
+        return NULL;
+    }
+
+    /*
+     * A producer may overwrite the frame at any time, so everything which is
+     * checked is copied out first and only the copies are used afterwards.
+     */
+    memcpy (&header, frame, sizeof (shmFrameHeader));
+
+    /* Anything malformed is dropped - it may be a torn read of a lapped slot */
+    if (0 == header.mSubjectLen
+        || header.mSubjectLen > MAX_SUBJECT_LENGTH
+        || 0 == header.mInboxLen
+        || header.mInboxLen > MAX_SUBJECT_LENGTH
+        || length != sizeof (shmFrameHeader) + header.mSubjectLen
+                     + header.mInboxLen + header.mPayloadLen)
+    {
+        return NULL;
+    }
+
+    memcpy (subject, frame + sizeof (shmFrameHeader), header.mSubjectLen);
+    memcpy (inbox, frame + sizeof (shmFrameHeader) + header.mSubjectLen,
+            header.mInboxLen);
+    payload = frame + sizeof (shmFrameHeader) + header.mSubjectLen
+                    + header.mInboxLen;
+
+    if ('\0' != subject[header.mSubjectLen - 1]
+        || '\0' != inbox[header.mInboxLen - 1])
+    {
+        return NULL;
+    }
+
+    receiveTime = mamaLatency_isEnabled () ? mamaLatency_getTimestamp () : 0;
+
+    wthread_mutex_lock (&impl->mSubscriptionLock);
+
+    for (subscription = (shmSubscription*) wtable_lookup (impl->mSubscriptions,
+                                                          subject);
+         NULL != subscription;
+         subscription = subscription->mNext)
+    {
+        if (1 == subscription->mIsTportDisconnected)
+        {
+            subscription->mIsTportDisconnected = 0;
+        }
+
+        if (1 != subscription->mIsNotMuted)
+        {
+            mama_log (MAMA_LOG_LEVEL_FINEST,
+                      "shmBridgeMamaTransportImpl_copyFrame(): "
+                      "muted - not queueing update for symbol %s",
+                      subject);
+            continue;
+        }
+
+        node = memoryPool_getNode (impl->mShmMsgPool,
+                                   sizeof (shmMsgNode) + header.mPayloadLen);
+        if (NULL == node)
+        {
+            mama_log (MAMA_LOG_LEVEL_ERROR,
+                      "shmBridgeMamaTransportImpl_copyFrame(): "
+                      "Error getting msgNode from msgPool (%s).",
+                      strerror(errno));
+            break;
+        }
+
+        msgNode = (shmMsgNode*) node->mNodeBuffer;
+        msgNode->mTransport    = impl;
+        msgNode->mSubscription = subscription;
+        msgNode->mMsgType      = (shmMsgType) header.mMsgType;
+        msgNode->mPayloadType  = (mamaPayloadType) header.mPayloadType;
+        msgNode->mPayloadLen   = header.mPayloadLen;
+        msgNode->mReceiveTime  = receiveTime;
+        memcpy (msgNode->mSubject, subject, header.mSubjectLen);
+        memcpy (msgNode->mInbox, inbox, header.mInboxLen);
+        memcpy (msgNode + 1, payload, header.mPayloadLen);
+
+        node->mNext = pending;
+        pending     = node;
+    }
+
+    wthread_mutex_unlock (&impl->mSubscriptionLock);
+
+    return pending;
+}
+
+void MAMACALLTYPE
+shmBridgeMamaTransportImpl_queueCallback (mamaQueue queue, void* closure)
+{
+    memoryNode*          node            = (memoryNode*) closure;
+    shmMsgNode*          msgNode         = NULL;
+    mama_status          status          = MAMA_STATUS_OK;
+    mamaMsg              tmpMsg          = NULL;
+    msgBridge            bridgeMsg       = NULL;
+    memoryPool*          pool            = NULL;
+    shmTransportBridge*  impl            = NULL;
+    shmSubscription*     subscription    = NULL;
+    int                  isSubscribed    = 0;
+
+    if (NULL == node)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmBridgeMamaTransportImpl_queueCallback(): "
+                  "Called with NULL msgNode (destroyed?)");
+        return;
+    }
+    msgNode      = (shmMsgNode*) node->mNodeBuffer;
+    pool         = node->mPool;
+    impl         = msgNode->mTransport;
+    subscription = msgNode->mSubscription;
+
+    /* The subscription may have been destroyed since this was enqueued */
+    wthread_mutex_lock (&impl->mSubscriptionLock);
+    isSubscribed = shmBridgeMamaTransportImpl_isSubscribed (impl,
+                                                            msgNode->mSubject,
+                                                            subscription);
+    wthread_mutex_unlock (&impl->mSubscriptionLock);
+
+    if (!isSubscribed)
+    {
+        mama_log (MAMA_LOG_LEVEL_FINE,
+                  "shmBridgeMamaTransportImpl_queueCallback(): "
+                  "Subscriber has been unregistered since msg was enqueued.");
+        memoryPool_returnNode (pool, node);
+        return;
+    }
+
+    /* Make sure that the subscription is processing messages */
+    if (1 != subscription->mIsNotMuted)
+    {
+        mama_log (MAMA_LOG_LEVEL_FINEST,
+                  "shmBridgeMamaTransportImpl_queueCallback(): "
+                  "Skipping update - subscription %p is muted.", subscription);
+        memoryPool_returnNode (pool, node);
+        return;
+    }
+
+    /* This is the reuseable message stored on the associated MamaQueue */
+    tmpMsg = mamaQueueImpl_getMsg (subscription->mMamaQueue);
+    if (NULL == tmpMsg)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmBridgeMamaTransportImpl_queueCallback(): "
+                  "Could not get cached mamaMsg from event queue.");
+        memoryPool_returnNode (pool, node);
+        return;
+    }
+
+    /* Get the bridge message from the mamaMsg */
+    status = mamaMsgImpl_getBridgeMsg (tmpMsg, &bridgeMsg);
+    if (MAMA_STATUS_OK != status)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmBridgeMamaTransportImpl_queueCallback(): "
+                  "Could not get bridge message from cached "
+                  "queue mamaMsg [%s]", mamaStatus_stringForStatus (status));
+        memoryPool_returnNode (pool, node);
+        return;
+    }
+
+    /* The payload was copied out of the ring directly after the node */
+    status = mamaMsgImpl_setMsgBuffer (tmpMsg,
+                                       (const void*) (msgNode + 1),
+                                       msgNode->mPayloadLen,
+                                       (char) msgNode->mPayloadType);
+    if (MAMA_STATUS_OK != status)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "shmBridgeMamaTransportImpl_queueCallback(): "
+                  "Could not set msg buffer [%s]",
+                  mamaStatus_stringForStatus (status));
+    }
+    else
+    {
+        shmBridgeMamaMsgImpl_setMsgType   (bridgeMsg, msgNode->mMsgType);
+        shmBridgeMamaMsgImpl_setInboxName (bridgeMsg, msgNode->mInbox);
+
+        if (0 != msgNode->mReceiveTime)
+        {
+            mamaMsgImpl_setStageTime (tmpMsg, MAMA_LATENCY_STAGE_RECEIVE,
+                                      msgNode->mReceiveTime);
+            mamaMsgImpl_setStageTime (tmpMsg, MAMA_LATENCY_STAGE_ENQUEUE,
+                                      msgNode->mEnqueueTime);
+        }
+
+        /* Process the message as normal */
+        status = mamaSubscription_processMsg (subscription->mMamaSubscription,
+                                              tmpMsg);
+        if (MAMA_STATUS_OK != status)
+        {
+            mama_log (MAMA_LOG_LEVEL_ERROR,
+                      "shmBridgeMamaTransportImpl_queueCallback(): "
+                      "mamaSubscription_processMsg() failed. [%d]", status);
+        }
+    }
+
+    /* No matter what happened we need to clean up */
+    memoryPool_returnNode (pool, node);
+}
+
+int
+shmBridgeMamaTransportImpl_isSubscribed (shmTransportBridge*  impl,
+                                         const char*          subject,
+                                         shmSubscription*     subscription)
+{
+    shmSubscription* current = NULL;
+
+    for (current = (shmSubscription*) wtable_lookup (impl->mSubscriptions,
+                                                     subject);
+         NULL != current;
+         current = current->mNext)
+    {
+        if (current == subscription)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+uint32_t
+shmBridgeMamaTransportImpl_hashSubject (const char* subject)
+{
+    uint32_t hash = 2166136261U;
+
+    while ('\0' != *subject)
+    {
+        hash ^= (uint8_t) *subject++;
+        hash *= 16777619U;
+    }
+
+    return hash;
+}
+
+long int shmBridgeMamaTransportImpl_getParameterAsLong (
+                                               long defaultVal,
+                                               long minimum,
+                                               long maximum,
+                                               const char* format, ...)
+{
+    const char* returnVal     = NULL;
+    long        returnLong    = 0;
+    char        paramDefault[PARAM_NAME_MAX_LENGTH];
+    char        paramName[PARAM_NAME_MAX_LENGTH];
+
+    /* Create list for storing the parameters passed in */
+    va_list arguments;
+
+    /* Populate list with arguments passed in */
+    va_start(arguments, format);
+
+    snprintf (paramDefault, PARAM_NAME_MAX_LENGTH, "%ld", defaultVal);
+
+    returnVal = shmBridgeMamaTransportImpl_getParameterWithVaList (paramDefault,
+                                                                   paramName,
+                                                                   format,
+                                                                   arguments);
+
+    /* Translate the returned string to a long */
+    returnLong = atol (returnVal);
+
+    if (returnLong < minimum)
+    {
+        mama_log (MAMA_LOG_LEVEL_FINER,
+                "shmBridgeMamaTransportImpl_getParameterAsLong: "
+                "Value for %s too small (%ld) - reverting to: [%ld]",
+                paramName,
+                returnLong,
+                minimum);
+        returnLong = minimum;
+    }
+    else if (returnLong > maximum)
+    {
+        mama_log (MAMA_LOG_LEVEL_FINER,
+                "shmBridgeMamaTransportImpl_getParameterAsLong: "
+                "Value for %s too large (%ld) - reverting to: [%ld]",
+                paramName,
+                returnLong,
+                maximum);
+        returnLong = maximum;
+    }
+    /* These will be equal if unchanged */
+    else if (returnVal == paramDefault)
+    {
+        mama_log (MAMA_LOG_LEVEL_FINER,
+                  "shmBridgeMamaTransportImpl_getParameterAsLong: "
+                  "parameter [%s]: [%ld] (Default)",
+                  paramName, returnLong);
+    }
+    else
+    {
+        mama_log (MAMA_LOG_LEVEL_FINER,
+                  "shmBridgeMamaTransportImpl_getParameterAsLong: "
+                  "parameter [%s]: [%ld] (User Defined)",
+                  paramName, returnLong);
+    }
+
+    return returnLong;
+}
+
+const char* shmBridgeMamaTransportImpl_getParameterWithVaList (
+                                           char* defaultVal,
+                                           char* paramName,
+                                           const char* format,
+                                           va_list arguments)
+{
+    const char* property = NULL;
+
+    /* Create the complete transport property string */
+    vsnprintf (paramName, PARAM_NAME_MAX_LENGTH,
+               format, arguments);
+
+    /* Get the property out for analysis */
+    property = properties_Get (mamaInternal_getProperties (),
+                               paramName);
+
+    /* Properties will return NULL if parameter is not specified in configs */
+    if (property == NULL)
+    {
+        property = defaultVal;
+    }
+
+    return property;
+}
+
+const char* shmBridgeMamaTransportImpl_getParameter (
+                                           const char* defaultVal,
+                                           const char* format, ...)
+{
+    char        paramName[PARAM_NAME_MAX_LENGTH];
+    const char* returnVal = NULL;
+    /* Create list for storing the parameters passed in */
+    va_list     arguments;
+
+    /* Populate list with arguments passed in */
+    va_start (arguments, format);
+
+    returnVal = shmBridgeMamaTransportImpl_getParameterWithVaList (
+                       (char*)defaultVal,
+                       paramName,
+                       format,
+                       arguments);
+
+    /* These will be equal if unchanged */
+    if (returnVal == defaultVal)
+    {
+        mama_log (MAMA_LOG_LEVEL_FINER,
+                  "shmBridgeMamaTransportImpl_getParameter: "
+                  "parameter [%s]: [%s] (Default)",
+                  paramName,
+                  returnVal);
+    }
+    else
+    {
+        mama_log (MAMA_LOG_LEVEL_FINER,
+                  "shmBridgeMamaTransportImpl_getParameter: "
+                  "parameter [%s]: [%s] (User Defined)",
+                  paramName,
+                  returnVal);
+    }
+
+    /* Clean up the list */
+    va_end(arguments);
+
+    return returnVal;
+}
+
@@ -0,0 +1,115 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#ifndef MAMA_BRIDGE_SHM_TRANSPORT_H__
+#define MAMA_BRIDGE_SHM_TRANSPORT_H__
+
+
+/*=========================================================================
+  =                             Includes                                  =
+  =========================================================================*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <mama/mama.h>
+#include <bridge.h>
+#include "shmdefs.h"
+
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * This is a simple convenience function to return a shmTransportBridge
+ * pointer based on the provided mamaTransport.
+ *
+ * @param transport     The mamaTransport to extract the bridge transport from.
+ *
+ * @return shmTransportBridge* associated with the mamaTransport.
+ */
+shmTransportBridge*
+shmBridgeMamaTransportImpl_getTransportBridge (mamaTransport transport);
+
+/**
+ * This will return the ring which carries the given subject. Subjects are
+ * spread over the transport's topic groups by hash, so every process sharing
+ * the rings must be configured with the same number of groups.
+ *
+ * @param impl          The shm transport bridge.
+ * @param subject       The subject key to be published or subscribed to.
+ *
+ * @return shmRing* for the subject's topic group.
+ */
+shmRing*
+shmBridgeMamaTransportImpl_getRing (shmTransportBridge* impl,
+                                    const char*         subject);
+
+/**
+ * This will register the subscription's interest in its subject so that
+ * matching frames read from the rings are enqueued to it.
+ *
+ * @param impl          The shm transport bridge.
+ * @param subscription  The subscription to register.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+mama_status
+shmBridgeMamaTransportImpl_registerSubscription (
+        shmTransportBridge* impl,
+        shmSubscription*    subscription);
+
+/**
+ * This will remove the subscription's interest in its subject. Frames already
+ * enqueued for it are discarded when they are dispatched.
+ *
+ * @param impl          The shm transport bridge.
+ * @param subscription  The subscription to unregister.
+ */
+void
+shmBridgeMamaTransportImpl_unregisterSubscription (
+        shmTransportBridge* impl,
+        shmSubscription*    subscription);
+
+/**
+ * This is a convenience function to build a subject key from its component
+ * parts in the same way on both the publishing and subscribing side.
+ *
+ * @param root          The root (e.g. _MD) or NULL.
+ * @param source        The source (symbol namespace) or NULL.
+ * @param topic         The topic (symbol) or NULL.
+ * @param keyTarget     Populated with a newly allocated key which the caller
+ *                      is responsible for freeing.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+mama_status
+shmBridgeMamaTransportImpl_generateSubjectKey (const char*  root,
+                                               const char*  source,
+                                               const char*  topic,
+                                               const char** keyTarget);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* MAMA_BRIDGE_SHM_TRANSPORT_H__*/
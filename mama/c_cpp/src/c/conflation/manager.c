@@ -19,16 +19,36 @@
  * 02110-1301 USA
  */
 
+#include <errno.h>
 #include <string.h>
 #include "wombat/port.h"
 
 #include "mama/mama.h"
 #include "mama/conflation/manager.h"
 #include "mama/conflation/connection.h"
+#include "mama/reservedfields.h"
+#include "conflation/manager_int.h"
 #include "wombat/queue.h"
+#include "wombat/wtable.h"
+#include "wombat/wSemaphore.h"
 #include "transportimpl.h"
 #include <assert.h>
 
+#define CONFLATION_TABLE_SIZE 1024
+
+/*
+ * The message pending on the queue for a symbol, if any. Entries are kept
+ * once created so the table, and the memory used for conflation, is bounded
+ * by the number of distinct symbols seen rather than by the backlog.
+ */
+typedef struct
+{
+    char*       mTopic;
+    mamaMsg     mPending;
+    mama_u64_t  mQueuedAt;
+    mama_u16_t  mConflateCount; /* updates folded into mPending */
+} mamaConflationEntry;
+
 /*
  * Note we need to queue both the topic and the message. The best way to do
  * this is with two parallel queues since the queues provide reasonably
@@ -46,11 +66,51 @@ typedef struct
     mamaConnection                mConnection;
     mamaTransport                 mTransport;
     mamaMsg                       mMsg; /* wraps data */
+
+    /* Per symbol conflation, see mamaConflationManager_setPolicy. Messages
+     * are only taken off mMsgQueue with mEntryLock held, so a message is
+     * never handed out while it may still have updates folded into it. */
+    mamaConflationPolicy          mPolicy;
+    mama_u64_t                    mMaxInterval; /* nanoseconds, 0 unbounded */
+    wtable_t                      mEntries;
+    size_t                        mPendingCount;
+    wthread_mutex_t               mEntryLock;
+
+    /* Posted for each message queued. dequeue waits on this rather than in
+     * wombatQueue_dispatch so that it can poll the queue under mEntryLock. */
+    wsem_t                        mAvailable;
 } mamaConflationMgr;
 
 mamaMsg 
 mamaConflationManagerImpl_getMsg (mamaConflationManager mgr);
 
+static int
+mamaConflationManagerImpl_conflate (mamaConflationMgr*    impl,
+                                    mamaMsg               msg,
+                                    const char*           topic,
+                                    int                   isUpdate,
+                                    mamaConflationEntry** entry,
+                                    mama_status*          status);
+
+static mama_u16_t
+mamaConflationManagerImpl_getConflateCount (mamaMsg msg);
+
+static mama_status
+mamaConflationManagerImpl_queue (mamaConflationMgr* impl,
+                                 mamaMsg            msg,
+                                 const char*        topic);
+
+static void
+mamaConflationManagerImpl_removed (mamaConflationMgr* impl,
+                                   mamaMsg            msg,
+                                   const char*        topic);
+
+static void
+mamaConflationManagerImpl_clearPending (wtable_t    table,
+                                        void*       data,
+                                        const char* key,
+                                        void*       closure);
+
 mama_status
 mamaConflationManager_allocate (mamaConflationManager* mgr)
 {
@@ -85,11 +145,30 @@ mamaConflationManager_create (mamaConflationManager mgr)
         return MAMA_STATUS_CONFLATE_ERROR;
     }
 
+    impl->mEntries = wtable_create ("conflation", CONFLATION_TABLE_SIZE);
+    if (impl->mEntries == NULL)
+        return MAMA_STATUS_NOMEM;
+
+    wthread_mutex_init (&impl->mEntryLock, NULL);
+    wsem_init (&impl->mAvailable, 0, 0);
+
     status = mamaMsg_create (&impl->mMsg);
 
     return status;
 }
 
+static void
+mamaConflationManagerImpl_freeEntry (wtable_t    table,
+                                     void*       data,
+                                     const char* key,
+                                     void*       closure)
+{
+    mamaConflationEntry* entry = (mamaConflationEntry*)data;
+
+    free (entry->mTopic);
+    free (entry);
+}
+
 mama_status
 mamaConflationManager_destroy (mamaConflationManager mgr)
 {
@@ -117,6 +196,16 @@ mamaConflationManager_destroy (mamaConflationManager mgr)
     }
     
     wombatQueue_destroy (impl->mMsgQueue);
+
+    if (impl->mEntries)
+    {
+        wtable_clear_for_each (impl->mEntries,
+                               mamaConflationManagerImpl_freeEntry,
+                               NULL);
+        wtable_destroy (impl->mEntries);
+        wthread_mutex_destroy (&impl->mEntryLock);
+        wsem_destroy (&impl->mAvailable);
+    }
     
     if (impl->mMsg)
         mamaMsg_destroy (impl->mMsg);
@@ -181,12 +270,211 @@ mamaConflationManager_setEnqueueCallback(mamaConflationManager         mgr,
     return MAMA_STATUS_OK;
 }
 
+mama_status
+mamaConflationManager_setPolicy (mamaConflationManager mgr,
+                                 mamaConflationPolicy  policy)
+{
+    mamaConflationMgr* impl = (mamaConflationMgr*)mgr;
+
+    if (impl == NULL)
+        return MAMA_STATUS_INVALID_ARG;
+
+    switch (policy)
+    {
+        case MAMA_CONFLATION_POLICY_NONE:
+        case MAMA_CONFLATION_POLICY_LAST_VALUE:
+        case MAMA_CONFLATION_POLICY_MERGE:
+            break;
+        default:
+            return MAMA_STATUS_INVALID_ARG;
+    }
+
+    /* Messages already queued stay queued but stop absorbing updates, so
+     * nothing is left pending on an entry under a different policy. */
+    wthread_mutex_lock (&impl->mEntryLock);
+    if (impl->mPolicy != policy)
+    {
+        wtable_for_each (impl->mEntries,
+                         mamaConflationManagerImpl_clearPending,
+                         impl);
+        impl->mPolicy = policy;
+    }
+    wthread_mutex_unlock (&impl->mEntryLock);
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+mamaConflationManager_getPolicy (mamaConflationManager mgr,
+                                 mamaConflationPolicy* policy)
+{
+    mamaConflationMgr* impl = (mamaConflationMgr*)mgr;
+
+    if (impl == NULL || policy == NULL)
+        return MAMA_STATUS_INVALID_ARG;
+
+    wthread_mutex_lock (&impl->mEntryLock);
+    *policy = impl->mPolicy;
+    wthread_mutex_unlock (&impl->mEntryLock);
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+mamaConflationManager_setMaxConflationInterval (mamaConflationManager mgr,
+                                                mama_f64_t            interval)
+{
+    mamaConflationMgr* impl = (mamaConflationMgr*)mgr;
+
+    if (impl == NULL || interval < 0.0)
+        return MAMA_STATUS_INVALID_ARG;
+
+    wthread_mutex_lock (&impl->mEntryLock);
+    impl->mMaxInterval = (mama_u64_t)(interval * 1000000000.0);
+    wthread_mutex_unlock (&impl->mEntryLock);
+
+    return MAMA_STATUS_OK;
+}
+
+/*
+ * The number of updates a message already stands for, one unless it was
+ * conflated upstream.
+ */
+static mama_u16_t
+mamaConflationManagerImpl_getConflateCount (mamaMsg msg)
+{
+    mama_u16_t count = 0;
+
+    if (mamaMsg_getU16 (msg,
+                        MamaFieldConflateCount.mName,
+                        MamaFieldConflateCount.mFid,
+                        &count) != MAMA_STATUS_OK || count == 0)
+    {
+        count = 1;
+    }
+    return count;
+}
+
+/*
+ * Fold msg into the message already queued for topic. Returns non zero if
+ * the message was conflated, otherwise the caller queues it and, for an
+ * update, records it as pending on the returned entry. Only updates are
+ * folded into updates; anything else ends the pending message so that it is
+ * delivered in order ahead of msg. Called with mEntryLock held.
+ */
+static int
+mamaConflationManagerImpl_conflate (mamaConflationMgr*    impl,
+                                    mamaMsg               msg,
+                                    const char*           topic,
+                                    int                   isUpdate,
+                                    mamaConflationEntry** entry,
+                                    mama_status*          status)
+{
+    mamaConflationEntry* cur   = NULL;
+    mama_u16_t           count = 0;
+
+    cur = (mamaConflationEntry*)wtable_lookup (impl->mEntries, topic);
+    if (cur == NULL)
+    {
+        cur = (mamaConflationEntry*)calloc (1, sizeof (mamaConflationEntry));
+        if (cur == NULL || (cur->mTopic = strdup (topic)) == NULL)
+        {
+            free (cur);
+            *status = MAMA_STATUS_NOMEM;
+            return 0;
+        }
+
+        if (wtable_insert (impl->mEntries, topic, cur) < 0)
+        {
+            mamaConflationManagerImpl_freeEntry (NULL, cur, topic, NULL);
+            *status = MAMA_STATUS_NOMEM;
+            return 0;
+        }
+    }
+    *entry = cur;
+
+    if (cur->mPending == NULL)
+        return 0;
+
+    /* A message that has been absorbing updates for longer than the maximum
+     * interval, or whose conflate count would overflow, is left to be
+     * delivered as it is and a new one started. */
+    count = isUpdate ? mamaConflationManagerImpl_getConflateCount (msg) : 0;
+    if (!isUpdate ||
+        cur->mConflateCount > (mama_u16_t)(0xFFFF - count) ||
+        (impl->mMaxInterval != 0 &&
+         mamaLatency_getTimestamp () - cur->mQueuedAt >= impl->mMaxInterval))
+    {
+        cur->mPending = NULL;
+        impl->mPendingCount--;
+        return 0;
+    }
+
+    if (impl->mPolicy == MAMA_CONFLATION_POLICY_LAST_VALUE)
+    {
+        *status = mamaMsg_clear (cur->mPending);
+        if (*status != MAMA_STATUS_OK)
+            return 1;
+    }
+
+    *status = mamaMsg_applyMsg (cur->mPending, msg);
+    if (*status != MAMA_STATUS_OK)
+        return 1;
+
+    /* The sequence number is now that of msg, so the count has to cover
+     * every update folded in or the subscriber sees a gap. */
+    cur->mConflateCount += count;
+    *status = mamaMsg_updateU16 (cur->mPending,
+                                 MamaFieldConflateCount.mName,
+                                 MamaFieldConflateCount.mFid,
+                                 cur->mConflateCount);
+    return 1;
+}
+
+/*
+ * The message has left the queue so later updates for its symbol must not be
+ * folded into it. Called with mEntryLock held, in the same critical section
+ * that took the message off the queue.
+ */
+static void
+mamaConflationManagerImpl_removed (mamaConflationMgr* impl,
+                                   mamaMsg            msg,
+                                   const char*        topic)
+{
+    mamaConflationEntry* entry = NULL;
+
+    if (impl->mPendingCount == 0 || topic == NULL)
+        return;
+
+    entry = (mamaConflationEntry*)wtable_lookup (impl->mEntries, topic);
+    if (entry != NULL && entry->mPending == msg)
+    {
+        entry->mPending = NULL;
+        impl->mPendingCount--;
+    }
+}
+
+static void
+mamaConflationManagerImpl_clearPending (wtable_t    table,
+                                        void*       data,
+                                        const char* key,
+                                        void*       closure)
+{
+    mamaConflationMgr*   impl  = (mamaConflationMgr*)closure;
+    mamaConflationEntry* entry = (mamaConflationEntry*)data;
+
+    if (entry->mPending != NULL)
+    {
+        entry->mPending = NULL;
+        impl->mPendingCount--;
+    }
+}
+
 mama_status
 mamaConflationManagerImpl_processData (mamaConflationManager mgr, 
                                        mamaMsg               msg,
                                        const char*           topic)
 {
-    mama_status status = MAMA_STATUS_OK;
     mamaConflationMgr* impl = (mamaConflationMgr*)mgr;
 
     if (impl == NULL)
@@ -210,14 +498,8 @@ mamaConflationManagerImpl_processData (mamaConflationManager mgr,
         /* Don't enqueue if there is a callback. */
         return MAMA_STATUS_OK;
     }
-    if (status == MAMA_STATUS_OK &&
-        wombatQueue_enqueue (impl->mMsgQueue, NULL, msg, (void*)topic) 
-        != WOMBAT_QUEUE_OK)
-    {
-        return MAMA_STATUS_NOMEM;
-    }
 
-    return status;
+    return mamaConflationManagerImpl_enqueue (mgr, msg, topic);
 }
 
 mama_status
@@ -226,7 +508,6 @@ mamaConflationManager_enqueue (mamaConflationManager mgr,
                                const char* topic)
 {
     mamaConflationMgr* impl = (mamaConflationMgr*)mgr;
-    mama_status status = MAMA_STATUS_OK;
 
     if (impl == NULL)
         return MAMA_STATUS_INVALID_ARG;
@@ -234,6 +515,62 @@ mamaConflationManager_enqueue (mamaConflationManager mgr,
     if (!impl->mInstalled)
         return MAMA_STATUS_NOT_INSTALLED;
 
+    return mamaConflationManagerImpl_enqueue (mgr, msg, topic);
+}
+
+mama_status
+mamaConflationManagerImpl_enqueue (mamaConflationManager mgr,
+                                   mamaMsg               msg,
+                                   const char*           topic)
+{
+    mamaConflationMgr* impl = (mamaConflationMgr*)mgr;
+    mama_status status = MAMA_STATUS_OK;
+
+    if (impl == NULL || impl->mMsgQueue == NULL)
+        return MAMA_STATUS_INVALID_ARG;
+
+    wthread_mutex_lock (&impl->mEntryLock);
+
+    if (impl->mPolicy != MAMA_CONFLATION_POLICY_NONE && topic != NULL)
+    {
+        mamaConflationEntry* entry    = NULL;
+        int                  isUpdate =
+            mamaMsgType_typeForMsg (msg) == MAMA_MSG_TYPE_UPDATE;
+
+        if (mamaConflationManagerImpl_conflate (impl, msg, topic, isUpdate,
+                                                &entry, &status) ||
+            status != MAMA_STATUS_OK)
+        {
+            wthread_mutex_unlock (&impl->mEntryLock);
+            return status;
+        }
+
+        status = mamaConflationManagerImpl_queue (impl, msg, entry->mTopic);
+        if (status == MAMA_STATUS_OK && isUpdate)
+        {
+            entry->mPending       = msg;
+            entry->mQueuedAt      = mamaLatency_getTimestamp ();
+            entry->mConflateCount =
+                mamaConflationManagerImpl_getConflateCount (msg);
+            impl->mPendingCount++;
+        }
+    }
+    else
+    {
+        status = mamaConflationManagerImpl_queue (impl, msg, topic);
+    }
+
+    wthread_mutex_unlock (&impl->mEntryLock);
+    return status;
+}
+
+static mama_status
+mamaConflationManagerImpl_queue (mamaConflationMgr* impl,
+                                 mamaMsg            msg,
+                                 const char*        topic)
+{
+    mama_status status = MAMA_STATUS_OK;
+
     /*
      * We need to detach the message to put it on the queue, and make sure
      * that the underlying buffer does not get freed.
@@ -259,6 +596,9 @@ mamaConflationManager_enqueue (mamaConflationManager mgr,
         return MAMA_STATUS_NOMEM;
     }
 
+    if (status == MAMA_STATUS_OK)
+        wsem_post (&impl->mAvailable);
+
     return status;
 }
 
@@ -278,13 +618,35 @@ mamaConflationManager_dequeue(mamaConflationManager mgr,
     if (impl->mMsgQueue == NULL)
         return MAMA_STATUS_NOT_INSTALLED;
 
-    if (wombatQueue_dispatch (impl->mMsgQueue, (void**)msg, (void**)topic) 
-        != WOMBAT_QUEUE_OK)
+    for (;;)
     {
-        return MAMA_STATUS_CONFLATE_ERROR;
+        wombatQueueStatus status;
+
+        while (-1 == wsem_wait (&impl->mAvailable))
+        {
+            if (errno != EINTR)
+                return MAMA_STATUS_CONFLATE_ERROR;
+        }
+
+        /* removeMsg or flush may take the message this wait was posted
+         * for, in which case the poll finds nothing and we wait again. */
+        wthread_mutex_lock (&impl->mEntryLock);
+
+        *msg   = NULL;
+        status = wombatQueue_poll (impl->mMsgQueue, (void**)msg,
+                                   (void**)topic);
+        if (status == WOMBAT_QUEUE_OK && *msg != NULL)
+        {
+            mamaConflationManagerImpl_removed (impl, *msg, *topic);
+            wthread_mutex_unlock (&impl->mEntryLock);
+            return MAMA_STATUS_OK;
+        }
+
+        wthread_mutex_unlock (&impl->mEntryLock);
+
+        if (status != WOMBAT_QUEUE_OK && status != WOMBAT_QUEUE_WOULD_BLOCK)
+            return MAMA_STATUS_CONFLATE_ERROR;
     }
-    
-    return MAMA_STATUS_OK;
 }
 
 
@@ -305,13 +667,23 @@ mamaConflationManager_poll(mamaConflationManager mgr,
     if (impl->mMsgQueue == NULL)
         return MAMA_STATUS_NOT_INSTALLED;
 
+    wthread_mutex_lock (&impl->mEntryLock);
+
     *msg = NULL;
     status = wombatQueue_poll (impl->mMsgQueue, (void**)msg, (void**)topic); 
     if (status != WOMBAT_QUEUE_OK && status != WOMBAT_QUEUE_WOULD_BLOCK)
     {
+        wthread_mutex_unlock (&impl->mEntryLock);
         return MAMA_STATUS_CONFLATE_ERROR;
     }
-    
+
+    if (*msg != NULL)
+    {
+        mamaConflationManagerImpl_removed (impl, *msg, *topic);
+        wsem_trywait (&impl->mAvailable);
+    }
+
+    wthread_mutex_unlock (&impl->mEntryLock);
     return MAMA_STATUS_OK;
 }
 
@@ -353,6 +725,10 @@ flushCallback (wombatQueue queue, void* data, void* itemClosure, void* closure)
     const char* topic         = (const char*) itemClosure;
     mamaMsg     msg           = (mamaMsg)data;
 
+    /* mEntryLock is held by mamaConflationManager_flush */
+    mamaConflationManagerImpl_removed ((mamaConflationMgr*)mgr, msg, topic);
+    wsem_trywait (&((mamaConflationMgr*)mgr)->mAvailable);
+
     if (mamaConflationManager_publish (mgr, msg, topic) != MAMA_STATUS_OK)
     {
         mama_log (MAMA_LOG_LEVEL_FINE, 
@@ -369,13 +745,19 @@ mamaConflationManager_flush (mamaConflationManager mgr)
     if (impl == NULL)
         return MAMA_STATUS_INVALID_ARG;
 
+    /* Taken before the queue lock, which flushCallback runs under, in the
+     * same order as enqueue takes them. */
+    wthread_mutex_lock (&impl->mEntryLock);
+
     if (wombatQueue_flush (impl->mMsgQueue, flushCallback, impl) !=
         WOMBAT_QUEUE_OK)
     {
+        wthread_mutex_unlock (&impl->mEntryLock);
         mama_log (MAMA_LOG_LEVEL_FINE, "Error flushing queue (%p)", impl);
         return MAMA_STATUS_CONFLATE_ERROR;
     }
 
+    wthread_mutex_unlock (&impl->mEntryLock);
     return MAMA_STATUS_OK;
 }
 
@@ -447,12 +829,20 @@ mamaConflationManager_removeMsg (mamaConflationManager mgr,
     if (impl == NULL)
         return MAMA_STATUS_INVALID_ARG;
 
+    wthread_mutex_lock (&impl->mEntryLock);
+
     if (wombatQueue_remove (impl->mMsgQueue, (void**)msg, (void**)topic) !=
         WOMBAT_QUEUE_OK)
     {
+        wthread_mutex_unlock (&impl->mEntryLock);
         return MAMA_STATUS_QUEUE_END;
     }
 
+    mamaConflationManagerImpl_removed (impl, *msg, *topic);
+    wsem_trywait (&impl->mAvailable);
+
+    wthread_mutex_unlock (&impl->mEntryLock);
+
     return MAMA_STATUS_OK;
 }
 
@@ -473,6 +863,8 @@ mamaConflationManager_insertBefore (mamaConflationManager mgr,
         return MAMA_STATUS_QUEUE_FULL;
     }
 
+    wsem_post (&impl->mAvailable);
+
     return MAMA_STATUS_OK;
 }
 
@@ -492,6 +884,8 @@ mamaConflationManager_insertAfter (mamaConflationManager mgr,
         return MAMA_STATUS_QUEUE_FULL;
     }
 
+    wsem_post (&impl->mAvailable);
+
     return MAMA_STATUS_OK;
 }
 
@@ -501,16 +895,28 @@ mamaConflationManager_replaceMsg (mamaConflationManager mgr,
                                   const char*           topic)
 {
     mamaConflationMgr* impl  = (mamaConflationMgr*)mgr;
+    mamaMsg            oldMsg   = NULL;
+    const char*        oldTopic = NULL;
 
     if (impl == NULL)
         return MAMA_STATUS_INVALID_ARG;
 
+    wthread_mutex_lock (&impl->mEntryLock);
+
+    if (wombatQueue_cur (impl->mMsgQueue, (void**)&oldMsg, (void**)&oldTopic)
+        == WOMBAT_QUEUE_OK)
+    {
+        mamaConflationManagerImpl_removed (impl, oldMsg, oldTopic);
+    }
+
     if (wombatQueue_replace (impl->mMsgQueue, NULL, (void*)newMsg,
                                   (void*)topic) != WOMBAT_QUEUE_OK)
     {
+        wthread_mutex_unlock (&impl->mEntryLock);
         return MAMA_STATUS_QUEUE_FULL;
     }
 
+    wthread_mutex_unlock (&impl->mEntryLock);
     return MAMA_STATUS_OK;
 }
 
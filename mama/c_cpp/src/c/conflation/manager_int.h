@@ -43,6 +43,18 @@ typedef mama_status (*conflateProcessCb) (mamaConflationManager mgr,
  */
 typedef mamaMsg (*conflateGetMsgCb) (mamaConflationManager mgr); 
 
+/**
+ * Queue a message, conflating it under the manager's policy, without
+ * requiring the manager to be installed on a transport. This is the body of
+ * mamaConflationManager_enqueue() and is used by processData, which has
+ * already checked the manager is installed.
+ */
+MAMAExpDLL
+extern mama_status
+mamaConflationManagerImpl_enqueue (mamaConflationManager mgr,
+                                   mamaMsg               msg,
+                                   const char*           topic);
+
 #if defined(__cplusplus)
 }
 #endif
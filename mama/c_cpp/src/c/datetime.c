@@ -55,7 +55,66 @@ printSubseconds (char*                  result,
                  mama_size_t*           resLen,
                  mama_size_t            maxLen,
                  mamaDateTimePrecision  precision,
-                 mama_u32_t             microsecs);
+                 mama_u32_t             microsecs,
+                 mama_u32_t             nanosecs);
+
+static void
+civilFromSeconds (mama_u32_t   secSinceEpoch,
+                  mama_u32_t*  year,
+                  mama_u32_t*  month,
+                  mama_u32_t*  day);
+
+/* Calendar fields of a UTC time */
+typedef struct dateTimeFields_
+{
+    mama_u32_t  mYear;
+    mama_u32_t  mMonth;     /* 1-12 */
+    mama_u32_t  mDay;       /* 1-31 */
+    mama_u32_t  mHour;
+    mama_u32_t  mMinute;
+    mama_u32_t  mSecond;
+} dateTimeFields;
+
+/* Fields read from a date/time string */
+typedef struct parsedDateTime_
+{
+    unsigned long  mYear;
+    unsigned long  mMonth;
+    unsigned long  mDay;
+    unsigned long  mHour;
+    unsigned long  mMinute;
+    unsigned long  mSecond;
+    unsigned long  mMicroseconds;
+    mama_u32_t     mNanoseconds;
+    int            mPrecision;
+    int            mHasDate;
+    int            mHasTime;
+} parsedDateTime;
+
+static void
+splitUtc (mama_u32_t       secSinceEpoch,
+          dateTimeFields*  fields);
+
+static char*
+writeDate (char* p, const dateTimeFields* fields);
+
+static char*
+writeTime (char* p, const dateTimeFields* fields);
+
+static char*
+writeSubseconds (char*                  p,
+                 mamaDateTimePrecision  precision,
+                 mama_u32_t             microsecs,
+                 mama_u32_t             nanosecs);
+
+static mama_size_t
+copyString (char* buf, mama_size_t bufMaxLen, const char* str, mama_size_t len);
+
+static int
+parseIsoDateTime (const char* str, parsedDateTime* parsed);
+
+static void
+parseDateTime (const char* str, parsedDateTime* parsed);
 
 static mama_status
 mamaDateTime_addTodayToDateTime (mamaDateTime destination);
@@ -64,20 +123,33 @@ mamaDateTime_addTodayToDateTime (mamaDateTime destination);
 mama_status
 mamaDateTime_create (mamaDateTime* dateTime)
 {
+    mamaDateTimeStorage* storage = NULL;
+
     assert (sizeof(mama_u64_t) == sizeof(mama_time_t));
-    *dateTime = (mamaDateTime) malloc (sizeof(mama_time_t));
+    storage = (mamaDateTimeStorage*) malloc (sizeof(mamaDateTimeStorage));
 
-    if (*dateTime == NULL)
+    if (storage == NULL)
     {
         return MAMA_STATUS_NOMEM;
     }
     else
     {
-        mamaDateTimeImpl_clear(**dateTime);
+        *dateTime = mamaDateTime_initStorage (storage);
         return MAMA_STATUS_OK;
     }
 }
 
+mamaDateTime
+mamaDateTime_initStorage (mamaDateTimeStorage* storage)
+{
+    if (!storage)
+        return NULL;
+
+    storage->mTime        = MAMA_TIME_IMPL_BIT_EXTENDED;
+    storage->mNanoseconds = 0;
+    return &storage->mTime;
+}
+
 mama_status
 mamaDateTime_destroy (mamaDateTime dateTime)
 {
@@ -126,6 +198,7 @@ mamaDateTime_copy (mamaDateTime       dest,
         return MAMA_STATUS_INVALID_ARG;
 
     mamaDateTimeImpl_copy(*dest,*src);
+    mamaDateTimeImpl_setNanoSeconds(dest, mamaDateTimeImpl_getNanoSeconds(src));
     return MAMA_STATUS_OK;
 }
 
@@ -143,7 +216,9 @@ int mamaDateTime_equal (const mamaDateTime lhs,
         return 1;
     if (!lhs || !rhs)
         return 0;
-    return mamaDateTimeImpl_equal (*lhs,*rhs);
+    return mamaDateTimeImpl_equal (*lhs,*rhs) &&
+           mamaDateTimeImpl_getNanoSeconds (lhs) ==
+           mamaDateTimeImpl_getNanoSeconds (rhs);
 }
 
 int mamaDateTime_compare (const mamaDateTime lhs,
@@ -158,6 +233,12 @@ int mamaDateTime_compare (const mamaDateTime lhs,
     lhsTimeOnly = mamaDateTimeImpl_getTimeOnly(*lhs);
     rhsTimeOnly = mamaDateTimeImpl_getTimeOnly(*rhs);
 
+    if (lhsTimeOnly == rhsTimeOnly)
+    {
+        lhsTimeOnly = mamaDateTimeImpl_getNanoSeconds (lhs);
+        rhsTimeOnly = mamaDateTimeImpl_getNanoSeconds (rhs);
+    }
+
     if (lhsTimeOnly > rhsTimeOnly)
         return 1;
     else if (lhsTimeOnly == rhsTimeOnly)
@@ -257,6 +338,42 @@ mamaDateTime_setEpochTimeMicroseconds(mamaDateTime dateTime,
     return MAMA_STATUS_OK;
 }
 
+mama_status
+mamaDateTime_setEpochTimeNanoseconds(mamaDateTime dateTime,
+                                     mama_u64_t   nanoseconds)
+{
+    mama_u64_t seconds = nanoseconds / 1000000000;
+    mama_u32_t fraction = (mama_u32_t)(nanoseconds % 1000000000);
+
+    if (!dateTime)
+        return MAMA_STATUS_INVALID_ARG;
+
+    mamaDateTimeImpl_clear           (*dateTime);
+    mamaDateTimeImpl_setSeconds      (*dateTime, seconds);
+    mamaDateTimeImpl_setMicroSeconds (*dateTime, fraction / 1000);
+    mamaDateTimeImpl_setNanoSeconds  (dateTime,  fraction % 1000);
+    mamaDateTimeImpl_setHasTime      (*dateTime);
+    if (seconds > SECONDS_IN_A_DAY)
+        mamaDateTimeImpl_setHasDate (*dateTime);
+    if (fraction > 0)
+        mamaDateTimeImpl_setPrecision (*dateTime, MAMA_DATE_TIME_PREC_NANOSECONDS);
+    else
+        mamaDateTimeImpl_setPrecision (*dateTime, 0);
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+mamaDateTime_setNanosecond(mamaDateTime dateTime,
+                           mama_u32_t   nanosecond)
+{
+    if (!dateTime || nanosecond >= 1000000000)
+        return MAMA_STATUS_INVALID_ARG;
+
+    mamaDateTimeImpl_setMicroSeconds (*dateTime, nanosecond / 1000);
+    mamaDateTimeImpl_setNanoSeconds  (dateTime,  nanosecond % 1000);
+    return MAMA_STATUS_OK;
+}
+
 mama_status
 mamaDateTime_setWithHints(mamaDateTime           dateTime,
                           mama_u32_t             seconds,
@@ -306,97 +423,41 @@ mamaDateTime_setFromStringWithTz(mamaDateTime        dateTime,
         return mamaDateTime_clear(dateTime);
     else
     {
-        const char* space   = strchr (str, ' ');
-        const char* slash1  = strchr (str, '/');
-        const char* slash2  = NULL;
-        const char* strtime = space  ? space+1 : str;
-        const char* colon1  = strchr (strtime, ':');
-
-        unsigned long year      = 0;
-        unsigned long month     = 0;
-        unsigned long day       = 0;
-        unsigned long hour      = 0;
-        unsigned long minute    = 0;
-        unsigned long second    = 0;
-        unsigned long microsecs = 0;
-        int           precision = 0;
-
-        unsigned long epochSeconds = 0;
-
-        if (slash1)
-        {
-            slash2 = strchr (slash1+1, '/');
-        }
-        else
-        {
-            slash1 = strchr (str, '-');
-            slash2 = slash1 ? strchr (slash1+1, '-') : NULL;
-        }
+        parsedDateTime parsed;
+        unsigned long  epochSeconds = 0;
 
-        mamaDateTimeImpl_clear (*dateTime);
+        memset (&parsed, 0, sizeof (parsed));
 
-        if (slash1)
+        /* Most strings we see are ISO layouts which can be read at fixed
+         * positions; anything else goes through the general parser. */
+        if (!parseIsoDateTime (str, &parsed))
         {
-            if (slash2)
-            {
-                /* year/month/day is present */
-                year  = strtoul (str,  NULL, 10);
-                month = strtoul (slash1+1, NULL, 10);
-                day   = strtoul (slash2+1, NULL, 10);
-            }
-            else
-            {
-                /* month/day is present */
-                month = strtoul (str,  NULL, 10);
-                day   = strtoul (slash1+1, NULL, 10);
-            }
-            mamaDateTimeImpl_setHasDate (*dateTime);
+            memset (&parsed, 0, sizeof (parsed));
+            parseDateTime (str, &parsed);
         }
 
-        if (colon1)
-        {
-            /* hour:minute is present */
-            const char* colon2 = strchr (colon1+1,  ':');
-            hour   = strtoul (strtime,  NULL, 10);
-            minute = strtoul (colon1+1, NULL, 10);
-            if (colon2)
-            {
-                /* :second is present */
-                const char* dot = strchr (colon2+1, '.');
-                second = strtoul (colon2+1, NULL, 10);
-                if (dot)
-                {
-                    /* .subsecond is present */
-                    const char* ch = dot+1;
-                    int i = 0;
-                    for (i = 0; isdigit(*ch); i++,ch++)
-                    {
-                        microsecs = 10 * microsecs + (*ch - '0');
-                    }
-                    precision = i;
-                    while (i++ < 6)
-                    {
-                        microsecs *= 10;
-                    }
-                }
-            }
+        mamaDateTimeImpl_clear (*dateTime);
+        if (parsed.mHasDate)
+            mamaDateTimeImpl_setHasDate (*dateTime);
+        if (parsed.mHasTime)
             mamaDateTimeImpl_setHasTime (*dateTime);
-        }
 
-        epochSeconds = makeTime (year, month, day, hour, minute, second);
+        epochSeconds = makeTime (parsed.mYear, parsed.mMonth, parsed.mDay,
+                                 parsed.mHour, parsed.mMinute, parsed.mSecond);
         if (tz)
         {
             /* adjust to UTC */
             mama_i32_t  offset = 0;
-            mama_status tzStatus = mamaTimeZone_getOffset (tz, &offset);
+            mama_status tzStatus = mamaTimeZone_getLocalOffsetAt (tz, epochSeconds, &offset);
             if (MAMA_STATUS_OK != tzStatus)
                 return tzStatus;
             epochSeconds -= offset;
         }
 
-        mamaDateTimeImpl_setPrecision (*dateTime, precision);
+        mamaDateTimeImpl_setPrecision (*dateTime, parsed.mPrecision);
         mamaDateTimeImpl_setSeconds (*dateTime, epochSeconds);
-        mamaDateTimeImpl_setMicroSeconds (*dateTime, microsecs);
+        mamaDateTimeImpl_setMicroSeconds (*dateTime, parsed.mMicroseconds);
+        mamaDateTimeImpl_setNanoSeconds (dateTime, parsed.mNanoseconds);
 
         return MAMA_STATUS_OK;
     }
@@ -462,7 +523,7 @@ mamaDateTime_setToMidnightToday(mamaDateTime       dateTime,
     if (tz)
     {
         mama_i32_t  offset = 0;
-        mamaTimeZone_getOffset (tz, &offset);
+        mamaTimeZone_getOffsetAt (tz, secondsSinceEpoch, &offset);
         secondsSinceEpoch += offset;
     }
 
@@ -534,11 +595,12 @@ mamaDateTime_setTimeWithPrecisionAndTz(mamaDateTime           dateTime,
     {
         /* Adjust for time zone offset. */
         mama_i32_t  offset = 0;
-        mamaTimeZone_getOffset (tz, &offset);
+        mamaTimeZone_getLocalOffsetAt (tz, tmpSeconds, &offset);
         tmpSeconds -= offset;
     }
     mamaDateTimeImpl_setSeconds      (*dateTime, tmpSeconds);
     mamaDateTimeImpl_setMicroSeconds (*dateTime, microsecond);
+    mamaDateTimeImpl_clearNanoSeconds(*dateTime);
     mamaDateTimeImpl_setPrecision    (*dateTime, precision);
     mamaDateTimeImpl_setHasTime      (*dateTime);
     return MAMA_STATUS_OK;
@@ -578,6 +640,7 @@ mamaDateTime_copyTime(mamaDateTime       dest,
     tmpMicroseconds = mamaDateTimeImpl_getMicroSeconds (*src);
     mamaDateTimeImpl_setSeconds      (*dest, tmpSeconds);
     mamaDateTimeImpl_setMicroSeconds (*dest, tmpMicroseconds);
+    mamaDateTimeImpl_setNanoSeconds  (dest, mamaDateTimeImpl_getNanoSeconds (src));
     mamaDateTimeImpl_setHasTime      (*dest);
     return MAMA_STATUS_OK;
 }
@@ -712,7 +775,7 @@ mamaDateTime_getEpochTimeWithTz(const mamaDateTime     dateTime,
     if (tz)
     {
         mama_i32_t  offset   = 0;
-        mamaTimeZone_getOffset (tz, &offset);
+        mamaTimeZone_getOffsetAt (tz, mamaDateTimeImpl_getSeconds (*dateTime), &offset);
 
         *seconds = mamaDateTimeImpl_getSeconds (*dateTime) + offset;
     }
@@ -747,7 +810,7 @@ mamaDateTime_getEpochTimeMicrosecondsWithTz(const mamaDateTime dateTime,
     if (tz)
     {
         mama_i32_t  offset   = 0;
-        mamaTimeZone_getOffset (tz, &offset);
+        mamaTimeZone_getOffsetAt (tz, mamaDateTimeImpl_getSeconds (*dateTime), &offset);
 
         *microseconds = 1000000 *
                          ((mama_u64_t)mamaDateTimeImpl_getSeconds (*dateTime) + offset) +
@@ -764,6 +827,39 @@ mamaDateTime_getEpochTimeMicrosecondsWithTz(const mamaDateTime dateTime,
     return MAMA_STATUS_OK;
 }
 
+mama_status
+mamaDateTime_getEpochTimeNanoseconds(const mamaDateTime dateTime,
+                                     mama_u64_t*        nanoseconds)
+{
+    return mamaDateTime_getEpochTimeNanosecondsWithTz (dateTime,
+                                                       nanoseconds, NULL);
+}
+
+mama_status
+mamaDateTime_getEpochTimeNanosecondsWithTz(const mamaDateTime dateTime,
+                                           mama_u64_t*        nanoseconds,
+                                           const mamaTimeZone tz)
+{
+    mama_u64_t seconds = 0;
+
+    if (!dateTime || !nanoseconds)
+        return MAMA_STATUS_INVALID_ARG;
+
+    seconds = mamaDateTimeImpl_getSeconds (*dateTime);
+    if (tz)
+    {
+        mama_i32_t  offset   = 0;
+        mamaTimeZone_getOffsetAt (tz, mamaDateTimeImpl_getSeconds (*dateTime), &offset);
+        seconds += offset;
+    }
+
+    *nanoseconds = 1000000000 * seconds +
+                   1000 * (mama_u64_t)mamaDateTimeImpl_getMicroSeconds (*dateTime) +
+                   mamaDateTimeImpl_getNanoSeconds (dateTime);
+
+    return MAMA_STATUS_OK;
+}
+
 mama_status
 mamaDateTime_getEpochTimeMilliseconds(const mamaDateTime dateTime,
                                       mama_u64_t*        milliseconds)
@@ -783,7 +879,7 @@ mamaDateTime_getEpochTimeMillisecondsWithTz(const mamaDateTime dateTime,
     if (tz)
     {
         mama_i32_t  offset   = 0;
-        mamaTimeZone_getOffset (tz, &offset);
+        mamaTimeZone_getOffsetAt (tz, mamaDateTimeImpl_getSeconds (*dateTime), &offset);
 
         *milliseconds = 1000 *
                          ((mama_u64_t)mamaDateTimeImpl_getSeconds (*dateTime) + offset) +
@@ -810,7 +906,7 @@ mama_status mamaDateTime_addTodayToDateTime(mamaDateTime destination)
     mama_status ret = MAMA_STATUS_SYSTEM_ERROR;
 
     /* Create a new date time. */
-    mama_time_t time;
+    mama_time_t time = 0;
     mamaDateTimeImpl_clear(time);
     {
         /* Get the current time of day. */
@@ -888,7 +984,7 @@ mamaDateTime_getEpochTimeSecondsWithTz(const mamaDateTime dateTime,
     if (tz)
     {
         mama_i32_t  offset   = 0;
-        mamaTimeZone_getOffset (tz, &offset);
+        mamaTimeZone_getOffsetAt (tz, mamaDateTimeImpl_getSeconds (*dateTime), &offset);
 
         *seconds = mamaDateTimeImpl_getSeconds (*dateTime) + offset +
             ((double)mamaDateTimeImpl_getMicroSeconds(*dateTime)) / 1000000.0;
@@ -942,8 +1038,8 @@ mamaDateTime_getStructTimeValWithTz(const mamaDateTime dateTime,
     if (tz)
     {
         mama_i32_t  offset   = 0;
-        mamaTimeZone_getOffset (tz, &offset);
-        result->tv_usec += offset;
+        mamaTimeZone_getOffsetAt (tz, result->tv_sec, &offset);
+        result->tv_sec += offset;
     }
 
     return MAMA_STATUS_OK;
@@ -967,7 +1063,7 @@ mamaDateTime_getStructTmWithTz(const mamaDateTime dateTime,
     if (tz)
     {
         mama_i32_t  offset   = 0;
-        mamaTimeZone_getOffset (tz, &offset);
+        mamaTimeZone_getOffsetAt (tz, mamaDateTimeImpl_getSeconds (*dateTime), &offset);
         utcTm (result, mamaDateTimeImpl_getSeconds(*dateTime) + offset);
     }
     else
@@ -982,55 +1078,35 @@ mama_status mamaDateTime_getAsString (const mamaDateTime dateTime,
                                       char*              buf,
                                       mama_size_t        bufMaxLen)
 {
-    time_t    seconds;
-    struct tm tmValue;
+    char            str[MAX_DATE_TIME_STR_LEN + 8];
+    char*           p = str;
+    dateTimeFields  fields;
 
     if (!dateTime || !buf)
         return MAMA_STATUS_INVALID_ARG;
 
-    seconds = (time_t) mamaDateTimeImpl_getSeconds(*dateTime);
-    utcTm (&tmValue, seconds);
-    buf[0] = '\0';
+    splitUtc (mamaDateTimeImpl_getSeconds (*dateTime), &fields);
     if (mamaDateTimeImpl_getHasTime (*dateTime))
     {
-        size_t    bytesUsed = 0;
-        size_t    precision = 0;
-        if (mamaDateTimeImpl_getHasDate(*dateTime))
-        {
-            bytesUsed = strftime (buf, bufMaxLen, "%Y-%m-%d %H:%M:%S", &tmValue);
-        }
-        else
+        if (mamaDateTimeImpl_getHasDate (*dateTime))
         {
-            bytesUsed = strftime (buf, bufMaxLen, "%H:%M:%S", &tmValue);
-        }
-        if (bytesUsed > 0)
-        {
-            buf       += bytesUsed;
-            bufMaxLen -= bytesUsed;
-        }
-        precision = mamaDateTimeImpl_getPrecision(*dateTime);
-        /* for unknown we print all the digits */
-        precision = precision == MAMA_DATE_TIME_PREC_UNKNOWN ? 3 : precision;
-        if (precision > 0)
-        {
-            size_t i;
-            uint32_t digits = mamaDateTimeImpl_getMicroSeconds(*dateTime);
-            for (i = 6; i > precision; i--)
-            {
-                digits /= 10;
-            }
-            if (precision >= bufMaxLen)
-            {
-                precision = bufMaxLen-1;
-                mama_log (MAMA_LOG_LEVEL_WARN,
-                "mamaDateTime_getAsString: percision truncated by buffer");
-            }
-            snprintf (buf, bufMaxLen, ".%0*d", (int)precision, digits);
+            p    = writeDate (p, &fields);
+            *p++ = ' ';
         }
+        p = writeTime (p, &fields);
+        p = writeSubseconds (p, mamaDateTimeImpl_getPrecision (*dateTime),
+                             mamaDateTimeImpl_getMicroSeconds (*dateTime),
+                             mamaDateTimeImpl_getNanoSeconds (dateTime));
     }
-    else if (mamaDateTimeImpl_getHasDate(*dateTime))
+    else if (mamaDateTimeImpl_getHasDate (*dateTime))
     {
-        strftime (buf, bufMaxLen, "%Y-%m-%d", &tmValue);
+        p = writeDate (p, &fields);
+    }
+
+    if (copyString (buf, bufMaxLen, str, p - str) < (mama_size_t) (p - str))
+    {
+        mama_log (MAMA_LOG_LEVEL_WARN,
+                  "mamaDateTime_getAsString: percision truncated by buffer");
     }
     return MAMA_STATUS_OK;
 }
@@ -1039,39 +1115,22 @@ mama_status mamaDateTime_getTimeAsString (const mamaDateTime dateTime,
                                           char*              buf,
                                           mama_size_t        bufMaxLen)
 {
-    time_t    seconds;
-    struct tm tmValue;
-    size_t    bytesUsed;
-    size_t    precision;
+    char            str[MAX_DATE_TIME_STR_LEN + 8];
+    char*           p = str;
+    dateTimeFields  fields;
 
     if (!dateTime || !buf)
         return MAMA_STATUS_INVALID_ARG;
 
-    seconds = (time_t) mamaDateTimeImpl_getSeconds(*dateTime);
-    utcTm (&tmValue, seconds);
-    buf[0] = '\0';
-    if (mamaDateTimeImpl_getHasTime(*dateTime))
+    if (mamaDateTimeImpl_getHasTime (*dateTime))
     {
-        bytesUsed = strftime (buf, bufMaxLen, "%H:%M:%S", &tmValue);
-        if (bytesUsed > 0)
-        {
-            buf       += bytesUsed;
-            bufMaxLen -= bytesUsed;
-        }
-        precision = mamaDateTimeImpl_getPrecision(*dateTime);
-        /* for unknown we print all the digits */
-        precision = precision == MAMA_DATE_TIME_PREC_UNKNOWN ? 3 : precision;
-        if (precision > 0)
-        {
-            size_t i;
-            uint32_t digits = mamaDateTimeImpl_getMicroSeconds(*dateTime);
-            for (i = 6; i > precision; i--)
-            {
-                digits /= 10;
-            }
-            snprintf (buf, bufMaxLen, ".%0*d", (int)precision, digits);
-        }
+        splitUtc (mamaDateTimeImpl_getSeconds (*dateTime), &fields);
+        p = writeTime (p, &fields);
+        p = writeSubseconds (p, mamaDateTimeImpl_getPrecision (*dateTime),
+                             mamaDateTimeImpl_getMicroSeconds (*dateTime),
+                             mamaDateTimeImpl_getNanoSeconds (dateTime));
     }
+    copyString (buf, bufMaxLen, str, p - str);
     return MAMA_STATUS_OK;
 }
 
@@ -1079,19 +1138,19 @@ mama_status mamaDateTime_getDateAsString (const mamaDateTime dateTime,
                                           char*              buf,
                                           mama_size_t        bufMaxLen)
 {
-    time_t    seconds;
-    struct tm tmValue;
+    char            str[MAX_DATE_TIME_STR_LEN];
+    char*           p = str;
+    dateTimeFields  fields;
 
     if (!dateTime || !buf)
         return MAMA_STATUS_INVALID_ARG;
 
-    seconds = (time_t) mamaDateTimeImpl_getSeconds(*dateTime);
-    utcTm (&tmValue, seconds);
-    buf[0] = '\0';
-    if (mamaDateTimeImpl_getHasDate(*dateTime))
+    if (mamaDateTimeImpl_getHasDate (*dateTime))
     {
-        strftime (buf, bufMaxLen, "%Y-%m-%d", &tmValue);
+        splitUtc (mamaDateTimeImpl_getSeconds (*dateTime), &fields);
+        p = writeDate (p, &fields);
     }
+    copyString (buf, bufMaxLen, str, p - str);
     return MAMA_STATUS_OK;
 }
 
@@ -1133,7 +1192,7 @@ mamaDateTime_getAsFormattedStringWithTz (const mamaDateTime dateTime,
                                          const char*        fmt,
                                          const mamaTimeZone tz)
 {
-    struct tm    tmTime;
+    dateTimeFields  fields;
     const char*  fmtChar  = NULL;
     mama_size_t  resLen   = 0;
     mama_i32_t   offset   = 0;
@@ -1143,19 +1202,10 @@ mamaDateTime_getAsFormattedStringWithTz (const mamaDateTime dateTime,
 
     if (tz)
     {
-        mamaTimeZone_getOffset (tz, &offset);
+        mamaTimeZone_getOffsetAt (tz, mamaDateTimeImpl_getSeconds (*dateTime), &offset);
     }
 
-    if (offset != 0)
-    {
-        mama_time_t  tmpDateTime = *dateTime;
-        mamaDateTime_addWholeSeconds (&tmpDateTime, offset);
-        utcTm (&tmTime, mamaDateTimeImpl_getSeconds(tmpDateTime));
-    }
-    else
-    {
-        utcTm (&tmTime, mamaDateTimeImpl_getSeconds(*dateTime));
-    }
+    splitUtc (mamaDateTimeImpl_getSeconds (*dateTime) + offset, &fields);
 
     for (fmtChar = fmt;
          *fmtChar && (resLen < maxLen);
@@ -1180,7 +1230,7 @@ mamaDateTime_getAsFormattedStringWithTz (const mamaDateTime dateTime,
             }
             else
             {
-                mama_u32_t year = tmTime.tm_year+1900;
+                mama_u32_t year = fields.mYear;
                 printDigit (result, &resLen, maxLen, year/1000); year %= 1000;
                 printDigit (result, &resLen, maxLen, year/100);  year %= 100;
                 printDigit (result, &resLen, maxLen, year/10);   year %= 10;
@@ -1198,7 +1248,7 @@ mamaDateTime_getAsFormattedStringWithTz (const mamaDateTime dateTime,
             }
             else
             {
-                mama_u32_t year = tmTime.tm_year % 100;
+                mama_u32_t year = fields.mYear % 100;
                 printDigit (result, &resLen, maxLen, year/10);   year %= 10;
                 printDigit (result, &resLen, maxLen, year);
             }
@@ -1214,7 +1264,7 @@ mamaDateTime_getAsFormattedStringWithTz (const mamaDateTime dateTime,
             }
             else
             {
-                mama_u32_t month = tmTime.tm_mon+1;
+                mama_u32_t month = fields.mMonth;
                 printDigit (result, &resLen, maxLen, month/10);  month %= 10;
                 printDigit (result, &resLen, maxLen, month);
             }
@@ -1230,7 +1280,7 @@ mamaDateTime_getAsFormattedStringWithTz (const mamaDateTime dateTime,
             }
             else
             {
-                mama_u32_t mday = tmTime.tm_mday;
+                mama_u32_t mday = fields.mDay;
                 printDigit (result, &resLen, maxLen, mday/10);   mday %= 10;
                 printDigit (result, &resLen, maxLen, mday);
             }
@@ -1244,11 +1294,15 @@ mamaDateTime_getAsFormattedStringWithTz (const mamaDateTime dateTime,
             {
                 printString (result, &resLen, maxLen, "    -  -  ");
             }
+            else if (resLen + 10 <= maxLen)
+            {
+                resLen = writeDate (result + resLen, &fields) - result;
+            }
             else
             {
-                mama_u32_t year   = tmTime.tm_year + 1900;
-                mama_u32_t month  = tmTime.tm_mon  + 1;
-                mama_u32_t mday   = tmTime.tm_mday;
+                mama_u32_t year   = fields.mYear;
+                mama_u32_t month  = fields.mMonth;
+                mama_u32_t mday   = fields.mDay;
                 printDigit (result, &resLen, maxLen, year/1000); year %= 1000;
                 printDigit (result, &resLen, maxLen, year/100);  year %= 100;
                 printDigit (result, &resLen, maxLen, year/10);   year %= 10;
@@ -1270,11 +1324,15 @@ mamaDateTime_getAsFormattedStringWithTz (const mamaDateTime dateTime,
             {
                 printString (result, &resLen, maxLen, "  :  :  ");
             }
+            else if (resLen + 8 <= maxLen)
+            {
+                resLen = writeTime (result + resLen, &fields) - result;
+            }
             else
             {
-                mama_u32_t hour   = tmTime.tm_hour;
-                mama_u32_t minute = tmTime.tm_min;
-                mama_u32_t second = tmTime.tm_sec;
+                mama_u32_t hour   = fields.mHour;
+                mama_u32_t minute = fields.mMinute;
+                mama_u32_t second = fields.mSecond;
                 printDigit (result, &resLen, maxLen, hour/10);   hour %= 10;
                 printDigit (result, &resLen, maxLen, hour);
                 printChar  (result, &resLen, maxLen, ':');
@@ -1296,9 +1354,9 @@ mamaDateTime_getAsFormattedStringWithTz (const mamaDateTime dateTime,
             }
             else
             {
-                mama_u32_t year   = tmTime.tm_year;
-                mama_u32_t month  = tmTime.tm_mon  + 1;
-                mama_u32_t mday   = tmTime.tm_mday;
+                mama_u32_t year   = fields.mYear % 100;
+                mama_u32_t month  = fields.mMonth;
+                mama_u32_t mday   = fields.mDay;
                 printDigit (result, &resLen, maxLen, month/10);  month %= 10;
                 printDigit (result, &resLen, maxLen, month);
                 printChar  (result, &resLen, maxLen, '/');
@@ -1320,7 +1378,7 @@ mamaDateTime_getAsFormattedStringWithTz (const mamaDateTime dateTime,
             }
             else
             {
-                mama_u32_t hour = tmTime.tm_hour;
+                mama_u32_t hour = fields.mHour;
                 printDigit (result, &resLen, maxLen, hour/10);   hour %= 10;
                 printDigit (result, &resLen, maxLen, hour);
             }
@@ -1336,7 +1394,7 @@ mamaDateTime_getAsFormattedStringWithTz (const mamaDateTime dateTime,
             }
             else
             {
-                mama_u32_t minute = tmTime.tm_min;
+                mama_u32_t minute = fields.mMinute;
                 printDigit (result, &resLen, maxLen, minute/10); minute %= 10;
                 printDigit (result, &resLen, maxLen, minute);
             }
@@ -1352,7 +1410,7 @@ mamaDateTime_getAsFormattedStringWithTz (const mamaDateTime dateTime,
             }
             else
             {
-                mama_u32_t second = tmTime.tm_sec;
+                mama_u32_t second = fields.mSecond;
                 printDigit (result, &resLen, maxLen, second/10); second %= 10;
                 printDigit (result, &resLen, maxLen, second);
             }
@@ -1370,7 +1428,7 @@ mamaDateTime_getAsFormattedStringWithTz (const mamaDateTime dateTime,
             {
                 mama_u32_t us = mamaDateTimeImpl_getMicroSeconds (*dateTime);
                 printSubseconds (result, &resLen, maxLen,
-                                 MAMA_DATE_TIME_PREC_MILLISECONDS, us);
+                                 MAMA_DATE_TIME_PREC_MILLISECONDS, us, 0);
             }
             ++fmtChar; /* skip the extra character in the fmt */
             break;
@@ -1386,7 +1444,7 @@ mamaDateTime_getAsFormattedStringWithTz (const mamaDateTime dateTime,
                     result[resLen++] = '.';
                 }
                 printSubseconds (result, &resLen, maxLen,
-                                 MAMA_DATE_TIME_PREC_MILLISECONDS, us);
+                                 MAMA_DATE_TIME_PREC_MILLISECONDS, us, 0);
             }
             ++fmtChar; /* skip the extra character in the fmt */
             break;
@@ -1402,7 +1460,8 @@ mamaDateTime_getAsFormattedStringWithTz (const mamaDateTime dateTime,
             {
                 mama_u32_t us = mamaDateTimeImpl_getMicroSeconds (*dateTime);
                 printSubseconds (result, &resLen, maxLen,
-                                 mamaDateTimeImpl_getPrecision (*dateTime), us);
+                                 mamaDateTimeImpl_getPrecision (*dateTime), us,
+                                 mamaDateTimeImpl_getNanoSeconds (dateTime));
             }
             ++fmtChar; /* skip the extra character in the fmt */
             break;
@@ -1418,7 +1477,8 @@ mamaDateTime_getAsFormattedStringWithTz (const mamaDateTime dateTime,
                     result[resLen++] = '.';
                 }
                 printSubseconds (result, &resLen, maxLen,
-                                 mamaDateTimeImpl_getPrecision (*dateTime), us);
+                                 mamaDateTimeImpl_getPrecision (*dateTime), us,
+                                 mamaDateTimeImpl_getNanoSeconds (dateTime));
             }
             ++fmtChar; /* skip the extra character in the fmt */
             break;
@@ -1432,7 +1492,7 @@ mamaDateTime_getAsFormattedStringWithTz (const mamaDateTime dateTime,
             }
             else
             {
-                const char* month = gMonthsFull[tmTime.tm_mon];
+                const char* month = gMonthsFull[fields.mMonth - 1];
                 printString (result, &resLen, maxLen, month);
             }
             ++fmtChar; /* skip the extra character in the fmt */
@@ -1447,7 +1507,7 @@ mamaDateTime_getAsFormattedStringWithTz (const mamaDateTime dateTime,
             }
             else
             {
-                const char* month = gMonthsAbbrev[tmTime.tm_mon];
+                const char* month = gMonthsAbbrev[fields.mMonth - 1];
                 printString (result, &resLen, maxLen, month);
             }
             ++fmtChar; /* skip the extra character in the fmt */
@@ -1462,7 +1522,7 @@ mamaDateTime_getAsFormattedStringWithTz (const mamaDateTime dateTime,
             }
             else
             {
-                const char* month = gMonthsAbbrevAllCap[tmTime.tm_mon];
+                const char* month = gMonthsAbbrevAllCap[fields.mMonth - 1];
                 printString (result, &resLen, maxLen, month);
             }
             ++fmtChar; /* skip the extra character in the fmt */
@@ -1493,78 +1553,66 @@ mama_status
 mamaDateTime_getYear(const mamaDateTime dateTime,
                      mama_u32_t*        result)
 {
-    struct tm  stm;
-    mama_status status = mamaDateTime_getStructTm(dateTime,&stm);
-    if (MAMA_STATUS_OK == status)
-    {
-        *result = stm.tm_year + 1900;
-    }
-    return status;
+    mama_u32_t month = 0;
+    mama_u32_t day   = 0;
+    if (!dateTime || !result)
+        return MAMA_STATUS_INVALID_ARG;
+    civilFromSeconds (mamaDateTimeImpl_getSeconds (*dateTime), result, &month, &day);
+    return MAMA_STATUS_OK;
 }
 
 mama_status
 mamaDateTime_getMonth(const mamaDateTime dateTime,
                       mama_u32_t*        result)
 {
-    struct tm  stm;
-    mama_status status = mamaDateTime_getStructTm(dateTime,&stm);
-    if (MAMA_STATUS_OK == status)
-    {
-        *result = stm.tm_mon + 1;
-    }
-    return status;
+    mama_u32_t year = 0;
+    mama_u32_t day  = 0;
+    if (!dateTime || !result)
+        return MAMA_STATUS_INVALID_ARG;
+    civilFromSeconds (mamaDateTimeImpl_getSeconds (*dateTime), &year, result, &day);
+    return MAMA_STATUS_OK;
 }
 
 mama_status
 mamaDateTime_getDay(const mamaDateTime dateTime,
                     mama_u32_t*        result)
 {
-    struct tm  stm;
-    mama_status status = mamaDateTime_getStructTm(dateTime,&stm);
-    if (MAMA_STATUS_OK == status)
-    {
-        *result = stm.tm_mday;
-    }
-    return status;
+    mama_u32_t year  = 0;
+    mama_u32_t month = 0;
+    if (!dateTime || !result)
+        return MAMA_STATUS_INVALID_ARG;
+    civilFromSeconds (mamaDateTimeImpl_getSeconds (*dateTime), &year, &month, result);
+    return MAMA_STATUS_OK;
 }
 
 mama_status
 mamaDateTime_getHour(const mamaDateTime dateTime,
                      mama_u32_t*        result)
 {
-    struct tm  stm;
-    mama_status status = mamaDateTime_getStructTm(dateTime,&stm);
-    if (MAMA_STATUS_OK == status)
-    {
-        *result = stm.tm_hour;
-    }
-    return status;
+    if (!dateTime || !result)
+        return MAMA_STATUS_INVALID_ARG;
+    *result = (mamaDateTimeImpl_getSeconds (*dateTime) % SECONDS_IN_A_DAY) / 3600;
+    return MAMA_STATUS_OK;
 }
 
 mama_status
 mamaDateTime_getMinute(const mamaDateTime dateTime,
                        mama_u32_t*        result)
 {
-    struct tm  stm;
-    mama_status status = mamaDateTime_getStructTm(dateTime,&stm);
-    if (MAMA_STATUS_OK == status)
-    {
-        *result = stm.tm_min;
-    }
-    return status;
+    if (!dateTime || !result)
+        return MAMA_STATUS_INVALID_ARG;
+    *result = (mamaDateTimeImpl_getSeconds (*dateTime) % 3600) / 60;
+    return MAMA_STATUS_OK;
 }
 
 mama_status
 mamaDateTime_getSecond(const mamaDateTime dateTime,
                        mama_u32_t*        result)
 {
-    struct tm  stm;
-    mama_status status = mamaDateTime_getStructTm(dateTime,&stm);
-    if (MAMA_STATUS_OK == status)
-    {
-        *result = stm.tm_sec;
-    }
-    return status;
+    if (!dateTime || !result)
+        return MAMA_STATUS_INVALID_ARG;
+    *result = mamaDateTimeImpl_getSeconds (*dateTime) % 60;
+    return MAMA_STATUS_OK;
 }
 
 mama_status
@@ -1577,17 +1625,27 @@ mamaDateTime_getMicrosecond(const mamaDateTime dateTime,
     return MAMA_STATUS_OK;
 }
 
+mama_status
+mamaDateTime_getNanosecond(const mamaDateTime dateTime,
+                           mama_u32_t*        result)
+{
+    if (!dateTime || !result)
+        return MAMA_STATUS_INVALID_ARG;
+    *result = 1000 * mamaDateTimeImpl_getMicroSeconds (*dateTime) +
+              mamaDateTimeImpl_getNanoSeconds (dateTime);
+    return MAMA_STATUS_OK;
+}
+
 mama_status
 mamaDateTime_getDayOfWeek(const mamaDateTime dateTime,
                           mamaDayOfWeek*     result)
 {
-    struct tm  stm;
-    mama_status status = mamaDateTime_getStructTm(dateTime,&stm);
-    if (MAMA_STATUS_OK == status)
-    {
-        *result = stm.tm_wday;
-    }
-    return status;
+    if (!dateTime || !result)
+        return MAMA_STATUS_INVALID_ARG;
+    /* 1 January 1970 was a Thursday */
+    *result = (mamaDayOfWeek)
+        ((mamaDateTimeImpl_getSeconds (*dateTime) / SECONDS_IN_A_DAY + Thursday) % 7);
+    return MAMA_STATUS_OK;
 }
 
 
@@ -1650,6 +1708,21 @@ mamaDateTime_diffMicroseconds(const mamaDateTime t1,
 }
 
 
+/* Days since the Epoch of a Gregorian date (month 1-12) */
+static mama_u32_t
+daysFromCivil (mama_u32_t year, mama_u32_t month, mama_u32_t day)
+{
+    mama_u32_t era;
+    mama_u32_t yoe;
+    mama_u32_t doy;
+
+    year -= month <= 2 ? 1 : 0;
+    era   = year / 400;
+    yoe   = year - era * 400;
+    doy   = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    return era * 146097 + yoe * 365 + yoe / 4 - yoe / 100 + doy - 719468;
+}
+
 unsigned long  makeTime (
     int year,
     int mon,
@@ -1658,33 +1731,41 @@ unsigned long  makeTime (
     int min,
     int sec)
 {
-    struct tm timeInfo;
+    /* Dates before 1970 are not representable */
+    if (year < 1970)
+        year = 1970;
+    if (mon < 1)
+        mon = 1;
+    if (day < 1)
+        day = 1;
 
-    /* tm_year stores the years since 1900
-     * must not be less than 70 */
-    if (year > 1970)
-        timeInfo.tm_year  = year - 1900;
-    else
-        timeInfo.tm_year  = 70;
-
-    /* tm_mon stores the months since Jan (0 to 11) */
-    if (mon > 0)
-        timeInfo.tm_mon   = mon  - 1;
-    else
-        timeInfo.tm_mon   = 0;
+    /* Carry months past December into the year, as timegm() does */
+    year += (mon - 1) / 12;
+    mon   = (mon - 1) % 12 + 1;
 
-    /* day of the month (1 to 31) */
-    if (day > 0)
-        timeInfo.tm_mday  = day;
-    else
-        timeInfo.tm_mday = 1;
+    return ((unsigned long) daysFromCivil (year, mon, 1) + day - 1) *
+           SECONDS_IN_A_DAY + hour * 3600UL + min * 60UL + sec;
+}
 
-    timeInfo.tm_hour  = hour;
-    timeInfo.tm_min   = min;
-    timeInfo.tm_sec   = sec;
-    timeInfo.tm_isdst = 0;
+/* The Gregorian date of a UTC time without going through struct tm, after
+   Howard Hinnant's days_from_civil algorithms. */
+void civilFromSeconds (
+    mama_u32_t     secSinceEpoch,
+    mama_u32_t*    year,
+    mama_u32_t*    month,
+    mama_u32_t*    day)
+{
+    /* Days since 0000-03-01, so leap days fall at the end of the year */
+    mama_u32_t days = secSinceEpoch / SECONDS_IN_A_DAY + 719468;
+    mama_u32_t era  = days / 146097;
+    mama_u32_t doe  = days - era * 146097;
+    mama_u32_t yoe  = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    mama_u32_t doy  = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    mama_u32_t mp   = (5 * doy + 2) / 153;
 
-    return wtimegm (&timeInfo);
+    *day   = doy - (153 * mp + 2) / 5 + 1;
+    *month = mp < 10 ? mp + 3 : mp - 9;
+    *year  = yoe + era * 400 + (*month <= 2 ? 1 : 0);
 }
 
 void utcTm (
@@ -1695,18 +1776,324 @@ void utcTm (
     gmtime_r (&tmp, result);
 }
 
+/*
+ * The date of the last day formatted, shared by all threads.  Packed into
+ * one 32 bit word so that it is always read and written whole: the low 15
+ * bits of the day number since the Epoch, then the year since 1970 (8
+ * bits), month (4 bits) and day of month (5 bits).  Day numbers sharing
+ * their low 15 bits are some 89 years apart, which the year tells apart.
+ */
+static volatile mama_u32_t gDateCache = 0xFFFFFFFF;
+
+void splitUtc (
+    mama_u32_t       secSinceEpoch,
+    dateTimeFields*  fields)
+{
+    mama_u32_t days      = secSinceEpoch / SECONDS_IN_A_DAY;
+    mama_u32_t dayTime   = secSinceEpoch % SECONDS_IN_A_DAY;
+    mama_u32_t cached    = gDateCache;
+    mama_u32_t yearIndex = (cached >> 9) & 0xFF;
+
+    /* days / 365 is the year since 1970 or one more */
+    if ((cached >> 17) == (days & 0x7FFF) && days / 365 - yearIndex <= 1)
+    {
+        fields->mYear  = 1970 + yearIndex;
+        fields->mMonth = (cached >> 5) & 0x0F;
+        fields->mDay   = cached & 0x1F;
+    }
+    else
+    {
+        civilFromSeconds (secSinceEpoch, &fields->mYear, &fields->mMonth,
+                          &fields->mDay);
+        gDateCache = ((days & 0x7FFF) << 17) | ((fields->mYear - 1970) << 9) |
+                     (fields->mMonth << 5) | fields->mDay;
+    }
+
+    fields->mHour   = dayTime / 3600;
+    fields->mMinute = (dayTime / 60) % 60;
+    fields->mSecond = dayTime % 60;
+}
+
+/* "00", "01", ... "99" for writing two digits at a time */
+static const char gDigitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+#define writeTwoDigits(p,value) \
+    do { memcpy ((p), gDigitPairs + 2 * (value), 2); (p) += 2; } while (0)
+
+char* writeDate (char* p, const dateTimeFields* fields)
+{
+    writeTwoDigits (p, fields->mYear / 100);
+    writeTwoDigits (p, fields->mYear % 100);
+    *p++ = '-';
+    writeTwoDigits (p, fields->mMonth);
+    *p++ = '-';
+    writeTwoDigits (p, fields->mDay);
+    return p;
+}
+
+char* writeTime (char* p, const dateTimeFields* fields)
+{
+    writeTwoDigits (p, fields->mHour);
+    *p++ = ':';
+    writeTwoDigits (p, fields->mMinute);
+    *p++ = ':';
+    writeTwoDigits (p, fields->mSecond);
+    return p;
+}
+
+/* Write ".fff" to the given precision, three digits when it is unknown. */
+char* writeSubseconds (
+    char*                  p,
+    mamaDateTimePrecision  precision,
+    mama_u32_t             microsecs,
+    mama_u32_t             nanosecs)
+{
+    mama_u32_t digits = microsecs;
+    int        width  = precision;
+    int        i;
+
+    if (MAMA_DATE_TIME_PREC_UNKNOWN == precision)
+    {
+        width = MAMA_DATE_TIME_PREC_MILLISECONDS;
+    }
+    else if (MAMA_DATE_TIME_PREC_NANOSECONDS == precision)
+    {
+        digits = 1000 * microsecs + nanosecs;
+    }
+    else if (width > MAMA_DATE_TIME_PREC_MICROSECONDS)
+    {
+        /* Day and minute precisions have always printed the microseconds
+         * padded to their value */
+        return p + sprintf (p, ".%0*u", width, microsecs);
+    }
+
+    if (width <= 0)
+        return p;
+
+    for (i = MAMA_DATE_TIME_PREC_MICROSECONDS; i > width; i--)
+    {
+        digits /= 10;
+    }
+
+    *p++ = '.';
+    for (i = width; i > 0; i--)
+    {
+        p[i - 1] = (char) ('0' + digits % 10);
+        digits  /= 10;
+    }
+    return p + width;
+}
+
+/* Copy as much of a string as fits, always terminating it.  Returns the
+ * number of characters copied. */
+mama_size_t copyString (
+    char*          buf,
+    mama_size_t    bufMaxLen,
+    const char*    str,
+    mama_size_t    len)
+{
+    if (0 == bufMaxLen)
+        return 0;
+    if (len >= bufMaxLen)
+        len = bufMaxLen - 1;
+    memcpy (buf, str, len);
+    buf[len] = '\0';
+    return len;
+}
+
+/* Read exactly count digits, returning -1 if any is not a digit. */
+static long
+readDigits (const char* p, int count)
+{
+    long value = 0;
+    int  i;
+    for (i = 0; i < count; i++)
+    {
+        if (p[i] < '0' || p[i] > '9')
+            return -1;
+        value = 10 * value + (p[i] - '0');
+    }
+    return value;
+}
+
+/*
+ * Read the common ISO 8601 layouts at fixed positions:
+ *
+ *   YYYY-MM-DD or YYYY/MM/DD
+ *   optionally followed by ' ' or 'T' and a time
+ *   HH:MM[:SS[.fffffffff]]
+ *
+ * or a time on its own.  Returns 0 for anything else, which is left to
+ * parseDateTime().
+ */
+int parseIsoDateTime (
+    const char*      str,
+    parsedDateTime*  parsed)
+{
+    const char* p = str;
+    long        value;
+
+    /* Each character is checked before the next is looked at, so a short
+     * string is never read beyond its terminator. */
+    if ((value = readDigits (p, 4)) >= 0 && ('-' == p[4] || '/' == p[4]))
+    {
+        parsed->mYear = value;
+        if ((value = readDigits (p + 5, 2)) < 0 || p[7] != p[4])
+            return 0;
+        parsed->mMonth = value;
+        if ((value = readDigits (p + 8, 2)) < 0)
+            return 0;
+        parsed->mDay     = value;
+        parsed->mHasDate = 1;
+        p += 10;
+
+        if ('\0' == *p)
+            return 1;
+        if (' ' != *p && 'T' != *p)
+            return 0;
+        p++;
+    }
+
+    if ((value = readDigits (p, 2)) < 0 || ':' != p[2])
+        return 0;
+    parsed->mHour = value;
+    if ((value = readDigits (p + 3, 2)) < 0)
+        return 0;
+    parsed->mMinute  = value;
+    parsed->mHasTime = 1;
+    p += 5;
+
+    if (':' == *p)
+    {
+        if ((value = readDigits (p + 1, 2)) < 0)
+            return 0;
+        parsed->mSecond = value;
+        p += 3;
+
+        if ('.' == *p)
+        {
+            mama_u32_t fraction = 0;
+            int        digits   = 0;
+            for (p++; *p >= '0' && *p <= '9' && digits < 9; p++, digits++)
+            {
+                fraction = 10 * fraction + (*p - '0');
+            }
+            if (0 == digits)
+                return 0;
+            for (value = digits; value < 9; value++)
+            {
+                fraction *= 10;
+            }
+            parsed->mMicroseconds = fraction / 1000;
+            parsed->mNanoseconds  = fraction % 1000;
+            parsed->mPrecision    = digits > 6 ? MAMA_DATE_TIME_PREC_NANOSECONDS
+                                               : digits;
+        }
+    }
+    return '\0' == *p;
+}
+
+/* The general parser for date and time strings with separators in any
+ * position. */
+void parseDateTime (
+    const char*      str,
+    parsedDateTime*  parsed)
+{
+    const char* space   = strchr (str, ' ');
+    const char* slash1  = strchr (str, '/');
+    const char* slash2  = NULL;
+    const char* strtime = space  ? space+1 : str;
+    const char* colon1  = strchr (strtime, ':');
+
+    if (slash1)
+    {
+        slash2 = strchr (slash1+1, '/');
+    }
+    else
+    {
+        slash1 = strchr (str, '-');
+        slash2 = slash1 ? strchr (slash1+1, '-') : NULL;
+    }
+
+    if (slash1)
+    {
+        if (slash2)
+        {
+            /* year/month/day is present */
+            parsed->mYear  = strtoul (str,  NULL, 10);
+            parsed->mMonth = strtoul (slash1+1, NULL, 10);
+            parsed->mDay   = strtoul (slash2+1, NULL, 10);
+        }
+        else
+        {
+            /* month/day is present */
+            parsed->mMonth = strtoul (str,  NULL, 10);
+            parsed->mDay   = strtoul (slash1+1, NULL, 10);
+        }
+        parsed->mHasDate = 1;
+    }
+
+    if (colon1)
+    {
+        /* hour:minute is present */
+        const char* colon2 = strchr (colon1+1,  ':');
+        parsed->mHour   = strtoul (strtime,  NULL, 10);
+        parsed->mMinute = strtoul (colon1+1, NULL, 10);
+        if (colon2)
+        {
+            /* :second is present */
+            const char* dot = strchr (colon2+1, '.');
+            parsed->mSecond = strtoul (colon2+1, NULL, 10);
+            if (dot)
+            {
+                /* .subsecond is present */
+                const char* ch = dot+1;
+                int i = 0;
+                for (i = 0; isdigit(*ch); i++,ch++)
+                {
+                    parsed->mMicroseconds = 10 * parsed->mMicroseconds + (*ch - '0');
+                }
+                parsed->mPrecision = i;
+                while (i++ < 6)
+                {
+                    parsed->mMicroseconds *= 10;
+                }
+            }
+        }
+        parsed->mHasTime = 1;
+    }
+}
+
 static void
 printSubseconds (char*                  result,
                  mama_size_t*           resLen,
                  mama_size_t            maxLen,
                  mamaDateTimePrecision  precision,
-                 mama_u32_t             microsecs)
+                 mama_u32_t             microsecs,
+                 mama_u32_t             nanosecs)
 {
     if (precision == MAMA_DATE_TIME_PREC_UNKNOWN)
         precision = MAMA_DATE_TIME_PREC_MILLISECONDS;
 
     switch (precision)
     {
+    case MAMA_DATE_TIME_PREC_NANOSECONDS:
+        printSubseconds (result, resLen, maxLen,
+                         MAMA_DATE_TIME_PREC_MICROSECONDS, microsecs, 0);
+        printDigit (result, resLen, maxLen, nanosecs/100);      nanosecs %= 100;
+        printDigit (result, resLen, maxLen, nanosecs/10);       nanosecs %= 10;
+        printDigit (result, resLen, maxLen, nanosecs);
+        break;
     case MAMA_DATE_TIME_PREC_MICROSECONDS:
         printDigit (result, resLen, maxLen, microsecs/100000);  microsecs %= 100000;
         printDigit (result, resLen, maxLen, microsecs/10000);   microsecs %= 10000;
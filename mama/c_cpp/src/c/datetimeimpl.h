@@ -38,11 +38,25 @@ typedef uint64_t mama_time_t;
 #define MAMA_TIME_IMPL_BIT_HAS_TIME       ((uint64_t)0x0000000002000000ULL)
 #define MAMA_TIME_IMPL_BIT_NO_TIMEZONE    ((uint64_t)0x0000000004000000ULL)
 #define MAMA_TIME_IMPL_MASK_TIME_ONLY     ((uint64_t)0xffffffff000fffffULL)
+/* Set when the storage is a mamaDateTimeStorage, so has room for the
+   nanoseconds within the microsecond. Kept by clear and copy. */
+#define MAMA_TIME_IMPL_BIT_EXTENDED       ((uint64_t)0x0000000000800000ULL)
+/* Set when mNanoseconds of the storage is valid. Every setter which clears
+   the time also clears this, so microsecond setters drop stale nanoseconds
+   without having to know about them. */
+#define MAMA_TIME_IMPL_BIT_HAS_NANOS      ((uint64_t)0x0000000000400000ULL)
+#define MAMA_TIME_IMPL_MASK_STORAGE       (MAMA_TIME_IMPL_BIT_EXTENDED | \
+                                           MAMA_TIME_IMPL_BIT_HAS_NANOS)
 
-#define mamaDateTimeImpl_clear(t)             ((t) =  MAMA_TIME_IMPL_NULL)
-#define mamaDateTimeImpl_copy(d,s)            ((d) =  (s))
-#define mamaDateTimeImpl_empty(t)             ((t) == MAMA_TIME_IMPL_NULL)
-#define mamaDateTimeImpl_equal(l,r)           ((l) == (r))
+#define mamaDateTimeImpl_clear(t)             ((t) &= MAMA_TIME_IMPL_BIT_EXTENDED)
+#define mamaDateTimeImpl_copy(d,s) \
+      ((d) = ((s) & ~MAMA_TIME_IMPL_BIT_EXTENDED) | ((d) & MAMA_TIME_IMPL_BIT_EXTENDED))
+#define mamaDateTimeImpl_empty(t) \
+      (((t) & ~MAMA_TIME_IMPL_BIT_EXTENDED) == MAMA_TIME_IMPL_NULL)
+#define mamaDateTimeImpl_equal(l,r) \
+      (((l) & ~MAMA_TIME_IMPL_BIT_EXTENDED) == ((r) & ~MAMA_TIME_IMPL_BIT_EXTENDED))
+/* The packed value without the storage bits, as sent on the wire. */
+#define mamaDateTimeImpl_getWireValue(t)      ((t) & ~MAMA_TIME_IMPL_MASK_STORAGE)
 
 #define mamaDateTimeImpl_clearSeconds(t) \
       ((t) &= ~MAMA_TIME_IMPL_MASK_SECONDS)
@@ -75,6 +89,24 @@ typedef uint64_t mama_time_t;
       (uint8_t) (((t) & MAMA_TIME_IMPL_NO_TIMEZONE) >> 24)
 #define mamaDateTimeImpl_getTimeOnly(t) \
       ((t) & MAMA_TIME_IMPL_MASK_TIME_ONLY)
+#define mamaDateTimeImpl_isExtended(t) \
+      (0 != ((t) & MAMA_TIME_IMPL_BIT_EXTENDED))
+#define mamaDateTimeImpl_hasNanoSeconds(t) \
+      (0 != ((t) & MAMA_TIME_IMPL_BIT_HAS_NANOS))
+
+/* Nanoseconds within the microsecond (0-999) of a mamaDateTime pointer. */
+#define mamaDateTimeImpl_getNanoSeconds(p) \
+      (mamaDateTimeImpl_hasNanoSeconds(*(p)) ? \
+          ((const mamaDateTimeStorage*)(p))->mNanoseconds : 0)
+/* Only stored where there is room, otherwise the value is truncated to the
+   microsecond. */
+#define mamaDateTimeImpl_setNanoSeconds(p,ns) \
+      (mamaDateTimeImpl_isExtended(*(p)) && (ns) != 0 \
+          ? (((mamaDateTimeStorage*)(p))->mNanoseconds = (ns), \
+             *(p) |= MAMA_TIME_IMPL_BIT_HAS_NANOS) \
+          : (*(p) &= ~MAMA_TIME_IMPL_BIT_HAS_NANOS))
+#define mamaDateTimeImpl_clearNanoSeconds(t) \
+      ((t) &= ~MAMA_TIME_IMPL_BIT_HAS_NANOS)
 
 #define mamaDateTimeImpl_setSeconds(t,s) \
       ((t) = ((t) & ~MAMA_TIME_IMPL_MASK_SECONDS)      | ((uint64_t)(s) << 32))
@@ -99,6 +131,7 @@ typedef uint64_t mama_time_t;
 #define mamaDateTimeImpl_clearTime(t) \
       (mamaDateTimeImpl_setSeconds(t,(mamaDateTimeImpl_getSeconds(t)/MAMA_TIME_IMPL_SECONDS_IN_DAY)*MAMA_TIME_IMPL_SECONDS_IN_DAY), \
        mamaDateTimeImpl_setMicroSeconds(t,0), \
+       mamaDateTimeImpl_clearNanoSeconds(t), \
        mamaDateTimeImpl_clearHasTime(t))
 
 #if defined(__cplusplus)
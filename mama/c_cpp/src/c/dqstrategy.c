@@ -193,8 +193,7 @@ dqStrategy_checkSeqNum (dqStrategy      strategy,
     mamaMsg_getSeqNum (msg, &seqNum);
 
     ctx->mDoNotForward = 0;
-    if (mamaMsg_getU64 (msg, MamaFieldSenderId.mName, MamaFieldSenderId.mFid, 
-                        &senderId) != MAMA_STATUS_OK)
+    if (mamaMsgImpl_getSenderId (msg, &senderId) != MAMA_STATUS_OK)
     {
         /* We just ignore it as we might be running against an older FH */
         senderId = 0;
@@ -0,0 +1,335 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#include "wombat/port.h"
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include "mama/types.h"
+#include "mama/status.h"
+#include "mama/latency.h"
+#include "latencyimpl.h"
+
+/* Values below 2^(SUB_BUCKET_BITS+1) get a bucket each; above that each
+   power of two is split into 2^SUB_BUCKET_BITS buckets. */
+#define MAMA_LATENCY_SUB_BUCKET_BITS    5
+#define MAMA_LATENCY_SUB_BUCKETS        (1 << MAMA_LATENCY_SUB_BUCKET_BITS)
+#define MAMA_LATENCY_MAX_SHIFT          35
+#define MAMA_LATENCY_NUM_BUCKETS \
+    ((MAMA_LATENCY_MAX_SHIFT + 2) * MAMA_LATENCY_SUB_BUCKETS)
+
+#if defined(__GNUC__)
+#define MAMA_LATENCY_ATOMIC_ADD(ptr, value) \
+    __sync_fetch_and_add ((ptr), (value))
+#define MAMA_LATENCY_ATOMIC_CAS(ptr, oldValue, newValue) \
+    __sync_bool_compare_and_swap ((ptr), (oldValue), (newValue))
+#else
+#define MAMA_LATENCY_ATOMIC_ADD(ptr, value) \
+    InterlockedExchangeAdd64 ((volatile LONGLONG*)(ptr), (LONGLONG)(value))
+#define MAMA_LATENCY_ATOMIC_CAS(ptr, oldValue, newValue) \
+    (InterlockedCompareExchange64 ((volatile LONGLONG*)(ptr), \
+        (LONGLONG)(newValue), (LONGLONG)(oldValue)) == (LONGLONG)(oldValue))
+#endif
+
+typedef struct mamaLatencyHistogramImpl_
+{
+    volatile mama_u64_t mCounts[MAMA_LATENCY_NUM_BUCKETS];
+    volatile mama_u64_t mCount;
+    volatile mama_u64_t mSum;
+    volatile mama_u64_t mMax;
+} mamaLatencyHistogramImpl;
+
+static volatile int gLatencyEnabled = 0;
+
+static int
+mamaLatencyImpl_bucketFor (mama_u64_t nanos)
+{
+    int msb   = 0;
+    int shift = 0;
+
+    if (nanos < 2 * MAMA_LATENCY_SUB_BUCKETS)
+        return (int)nanos;
+
+#if defined(__GNUC__)
+    msb = 63 - __builtin_clzll (nanos);
+#else
+    {
+        mama_u64_t value = nanos;
+        while (value >>= 1)
+            msb++;
+    }
+#endif
+
+    shift = msb - MAMA_LATENCY_SUB_BUCKET_BITS;
+    if (shift > MAMA_LATENCY_MAX_SHIFT)
+        return MAMA_LATENCY_NUM_BUCKETS - 1;
+
+    return shift * MAMA_LATENCY_SUB_BUCKETS + (int)(nanos >> shift);
+}
+
+/* The largest value which falls in a bucket. */
+static mama_u64_t
+mamaLatencyImpl_bucketValue (int bucket)
+{
+    int shift = 0;
+
+    if (bucket < 2 * MAMA_LATENCY_SUB_BUCKETS)
+        return (mama_u64_t)bucket;
+
+    shift = bucket / MAMA_LATENCY_SUB_BUCKETS - 1;
+    return (((mama_u64_t)(bucket - shift * MAMA_LATENCY_SUB_BUCKETS) + 1)
+            << shift) - 1;
+}
+
+static void
+mamaLatencyImpl_updateMax (mamaLatencyHistogramImpl* impl, mama_u64_t nanos)
+{
+    mama_u64_t current = impl->mMax;
+
+    while (nanos > current)
+    {
+        if (MAMA_LATENCY_ATOMIC_CAS (&impl->mMax, current, nanos))
+            break;
+        current = impl->mMax;
+    }
+}
+
+void
+mamaLatency_setEnabled (int enable)
+{
+    gLatencyEnabled = enable ? 1 : 0;
+}
+
+int
+mamaLatency_isEnabled (void)
+{
+    return gLatencyEnabled;
+}
+
+mama_u64_t
+mamaLatency_getTimestamp (void)
+{
+#ifdef WIN32
+    static LARGE_INTEGER frequency = {0};
+    LARGE_INTEGER        counter;
+
+    if (0 == frequency.QuadPart)
+        QueryPerformanceFrequency (&frequency);
+
+    QueryPerformanceCounter (&counter);
+    return (mama_u64_t)((counter.QuadPart / frequency.QuadPart) * 1000000000
+            + (counter.QuadPart % frequency.QuadPart) * 1000000000
+              / frequency.QuadPart);
+#else
+    struct timespec now;
+
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    return (mama_u64_t)now.tv_sec * 1000000000 + (mama_u64_t)now.tv_nsec;
+#endif
+}
+
+mama_status
+mamaLatencyHistogram_create (mamaLatencyHistogram* histogram)
+{
+    mamaLatencyHistogramImpl* impl = NULL;
+
+    if (!histogram) return MAMA_STATUS_NULL_ARG;
+
+    impl = (mamaLatencyHistogramImpl*)calloc (1, sizeof (mamaLatencyHistogramImpl));
+    if (!impl) return MAMA_STATUS_NOMEM;
+
+    *histogram = (mamaLatencyHistogram)impl;
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+mamaLatencyHistogram_destroy (mamaLatencyHistogram histogram)
+{
+    if (!histogram) return MAMA_STATUS_NULL_ARG;
+
+    free (histogram);
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+mamaLatencyHistogram_record (mamaLatencyHistogram histogram,
+                             mama_u64_t           nanos)
+{
+    mamaLatencyHistogramImpl* impl = (mamaLatencyHistogramImpl*)histogram;
+
+    if (!impl) return MAMA_STATUS_NULL_ARG;
+
+    MAMA_LATENCY_ATOMIC_ADD (&impl->mCounts[mamaLatencyImpl_bucketFor (nanos)], 1);
+    MAMA_LATENCY_ATOMIC_ADD (&impl->mCount, 1);
+    MAMA_LATENCY_ATOMIC_ADD (&impl->mSum, nanos);
+    mamaLatencyImpl_updateMax (impl, nanos);
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+mamaLatencyHistogram_reset (mamaLatencyHistogram histogram)
+{
+    mamaLatencyHistogramImpl* impl = (mamaLatencyHistogramImpl*)histogram;
+
+    if (!impl) return MAMA_STATUS_NULL_ARG;
+
+    memset ((void*)impl, 0, sizeof (mamaLatencyHistogramImpl));
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+mamaLatencyHistogram_merge (mamaLatencyHistogram histogram,
+                            mamaLatencyHistogram other)
+{
+    mamaLatencyHistogramImpl* impl  = (mamaLatencyHistogramImpl*)histogram;
+    mamaLatencyHistogramImpl* from  = (mamaLatencyHistogramImpl*)other;
+    int                       i     = 0;
+
+    if (!impl || !from) return MAMA_STATUS_NULL_ARG;
+
+    for (i = 0; i < MAMA_LATENCY_NUM_BUCKETS; i++)
+    {
+        if (from->mCounts[i])
+            MAMA_LATENCY_ATOMIC_ADD (&impl->mCounts[i], from->mCounts[i]);
+    }
+    MAMA_LATENCY_ATOMIC_ADD (&impl->mCount, from->mCount);
+    MAMA_LATENCY_ATOMIC_ADD (&impl->mSum, from->mSum);
+    mamaLatencyImpl_updateMax (impl, from->mMax);
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+mamaLatencyHistogram_getCount (mamaLatencyHistogram histogram,
+                               mama_u64_t*          count)
+{
+    mamaLatencyHistogramImpl* impl = (mamaLatencyHistogramImpl*)histogram;
+
+    if (!impl || !count) return MAMA_STATUS_NULL_ARG;
+
+    *count = impl->mCount;
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+mamaLatencyHistogram_getPercentile (mamaLatencyHistogram histogram,
+                                    mama_f64_t           percentile,
+                                    mama_u64_t*          nanos)
+{
+    mamaLatencyHistogramImpl* impl    = (mamaLatencyHistogramImpl*)histogram;
+    mama_u64_t                total   = 0;
+    mama_u64_t                target  = 0;
+    mama_u64_t                seen    = 0;
+    int                       i       = 0;
+
+    if (!impl || !nanos) return MAMA_STATUS_NULL_ARG;
+    if (percentile < 0.0 || percentile > 100.0) return MAMA_STATUS_INVALID_ARG;
+
+    *nanos = 0;
+
+    /* Sum the buckets rather than trusting mCount, which may be a little
+       ahead of them while other threads are recording. */
+    for (i = 0; i < MAMA_LATENCY_NUM_BUCKETS; i++)
+        total += impl->mCounts[i];
+
+    if (0 == total)
+        return MAMA_STATUS_OK;
+
+    target = (mama_u64_t)(percentile / 100.0 * (mama_f64_t)total + 0.5);
+    if (target < 1)     target = 1;
+    if (target > total) target = total;
+
+    for (i = 0; i < MAMA_LATENCY_NUM_BUCKETS; i++)
+    {
+        seen += impl->mCounts[i];
+        if (seen >= target)
+        {
+            *nanos = mamaLatencyImpl_bucketValue (i);
+            break;
+        }
+    }
+
+    /* The top bucket is open ended and no bucket can exceed the max */
+    if (*nanos > impl->mMax || i == MAMA_LATENCY_NUM_BUCKETS - 1)
+        *nanos = impl->mMax;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+mamaLatencyHistogram_getMax (mamaLatencyHistogram histogram,
+                             mama_u64_t*          nanos)
+{
+    mamaLatencyHistogramImpl* impl = (mamaLatencyHistogramImpl*)histogram;
+
+    if (!impl || !nanos) return MAMA_STATUS_NULL_ARG;
+
+    *nanos = impl->mMax;
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+mamaLatencyHistogram_getMean (mamaLatencyHistogram histogram,
+                              mama_f64_t*          nanos)
+{
+    mamaLatencyHistogramImpl* impl  = (mamaLatencyHistogramImpl*)histogram;
+    mama_u64_t                count = 0;
+
+    if (!impl || !nanos) return MAMA_STATUS_NULL_ARG;
+
+    count  = impl->mCount;
+    *nanos = count ? (mama_f64_t)impl->mSum / (mama_f64_t)count : 0.0;
+    return MAMA_STATUS_OK;
+}
+
+void
+mamaLatencyImpl_recordSpans (mamaLatencyHistogram* histograms,
+                             const mama_u64_t*     stageTimes)
+{
+    mama_u64_t start    = 0;
+    mama_u64_t queued   = 0;
+    mama_u64_t dispatch = stageTimes[MAMA_LATENCY_STAGE_DISPATCH];
+    mama_u64_t done     = stageTimes[MAMA_LATENCY_STAGE_CALLBACK_DONE];
+
+    if (!histograms || !dispatch || done < dispatch)
+        return;
+
+    queued = stageTimes[MAMA_LATENCY_STAGE_ENQUEUE]
+           ? stageTimes[MAMA_LATENCY_STAGE_ENQUEUE]
+           : stageTimes[MAMA_LATENCY_STAGE_RECEIVE];
+    start  = stageTimes[MAMA_LATENCY_STAGE_RECEIVE]
+           ? stageTimes[MAMA_LATENCY_STAGE_RECEIVE]
+           : queued;
+
+    if (queued && queued <= dispatch)
+    {
+        mamaLatencyHistogram_record (histograms[MAMA_LATENCY_SPAN_QUEUE],
+                                     dispatch - queued);
+    }
+
+    mamaLatencyHistogram_record (histograms[MAMA_LATENCY_SPAN_CALLBACK],
+                                 done - dispatch);
+
+    mamaLatencyHistogram_record (histograms[MAMA_LATENCY_SPAN_TOTAL],
+                                 done - (start && start <= dispatch ? start : dispatch));
+}
@@ -34,6 +34,8 @@
 #include "msgimpl.h"
 #include "queueimpl.h"
 #include "mama/statscollector.h"
+#include "statscollectorinternal.h"
+#include "latencyimpl.h"
 
 #ifdef WITH_ENTITLEMENTS
 #include <OeaClient.h>
@@ -70,6 +72,8 @@ typedef struct msgCallback_
 } msgCallback;
 
 static int isInitialMessageOrRecap( msgCallback *callback, int msgType );
+static void dispatchMsg (listenerMsgCallback callback, mamaMsg msg,
+                         SubjectContext *ctx);
 static void handleNoSubscribers (msgCallback*       callback,
                                  mamaMsg            msg,
                                  SubjectContext*    ctx,
@@ -256,8 +260,49 @@ void
 listenerMsgCallback_processMsg( listenerMsgCallback callback, mamaMsg msg,
                                 SubjectContext *ctx)
 {
-    int               msgType           = mamaMsgType_typeForMsg (msg);
-    mamaMsgStatus     status            = mamaMsgImpl_getStatusFromMsg (msg);
+    msgCallback*          impl          = (msgCallback*)callback;
+    mamaQueue             queue         = NULL;
+    mamaLatencyHistogram* queueLatency  = NULL;
+    const mama_u64_t*     stageTimes    = NULL;
+
+    if (!mamaLatency_isEnabled ())
+    {
+        dispatchMsg (callback, msg, ctx);
+        return;
+    }
+
+    /* Look the histograms up first, the callback may destroy the
+       subscription. Only the queue records, the transport view is merged
+       from its queues when reported. */
+    mamaSubscription_getQueue (impl->mSubscription, &queue);
+    if (queue)
+    {
+        queueLatency = mamaStatsCollectorImpl_getLatencyHistograms (
+                            mamaQueueImpl_getStatsCollector (queue));
+    }
+
+    mamaMsgImpl_setStageTime (msg, MAMA_LATENCY_STAGE_DISPATCH,
+                              mamaLatency_getTimestamp ());
+
+    dispatchMsg (callback, msg, ctx);
+
+    mamaMsgImpl_setStageTime (msg, MAMA_LATENCY_STAGE_CALLBACK_DONE,
+                              mamaLatency_getTimestamp ());
+
+    stageTimes = mamaMsgImpl_getStageTimes (msg);
+    if (stageTimes)
+    {
+        mamaLatencyImpl_recordSpans (queueLatency, stageTimes);
+    }
+
+    mamaMsgImpl_clearStageTimes (msg);
+}
+
+static void
+dispatchMsg (listenerMsgCallback callback, mamaMsg msg, SubjectContext *ctx)
+{
+    int               msgType           = MAMA_MSG_TYPE_UNKNOWN;
+    mamaMsgStatus     status            = MAMA_MSG_STATUS_UNKNOWN;
     msgCallback*      impl              = (msgCallback*)callback;
     mamaSubscription  subscription      = impl->mSubscription;
     int               expectingInitial  = 0;
@@ -267,6 +312,12 @@ listenerMsgCallback_processMsg( listenerMsgCallback callback, mamaMsg msg,
     mamaStatsCollector tportStatsCollector = NULL;
     const char* userSymbol = NULL;
 	dqState state = DQ_STATE_NOT_ESTABLISHED;
+
+    /* Read the reserved fields once for everything below. */
+    mamaMsgImpl_decodeHeader (msg);
+    msgType = mamaMsgType_typeForMsg (msg);
+    status  = mamaMsgImpl_getStatusFromMsg (msg);
+
     mamaSubscription_getTransport (subscription, &transport);
 
     if (!ctx)
@@ -457,6 +508,7 @@ listenerMsgCallback_processMsg( listenerMsgCallback callback, mamaMsg msg,
              break;
         case MAMA_MSG_TYPE_RECAP :
         case MAMA_MSG_TYPE_BOOK_RECAP :
+             mamaTransportImpl_recapReceived (transport, subscription);
              if (queueStatsCollector)
              {
                 mamaStatsCollector_incrementStat (queueStatsCollector, MamaStatRecaps.mFid);
@@ -31,6 +31,7 @@
 #include "mama/log.h"
 
 #include "wombat/MRSWLock.h"
+#include "wombat/wInterlocked.h"
 #include "property.h"
 #include "mamainternal.h"
 
@@ -53,6 +54,30 @@
 #define FILESIZEPROPERTY    "mama.logging.file.maxsize"
 #define ROLLPROPERTY        "mama.logging.file.maxroll"
 #define APPENDPROPERTY      "mama.logging.file.append"
+#define ASYNCPROPERTY       "mama.logging.async"
+#define ASYNCSIZEPROPERTY   "mama.logging.async.records"
+#define ASYNCINTPROPERTY    "mama.logging.async.interval"
+
+/* Default number of records in each thread's async log ring. */
+#define MAMALOG_ASYNC_DEFAULT_RECORDS   4096
+
+/* Maximum length of a formatted async log message, longer messages are
+ * truncated.
+ */
+#define MAMALOG_ASYNC_RECORD_LENGTH     488
+
+/* Nanoseconds to wait between checks for loggers still queueing records
+ * when async logging is switched off. */
+#define MAMALOG_ASYNC_QUIESCE_WAIT      100000
+
+/* Milliseconds the async writer sleeps when it finds nothing to write. */
+#define MAMALOG_ASYNC_DEFAULT_INTERVAL  10
+
+#if defined(__GNUC__)
+#define MAMALOG_MEMORY_BARRIER()        __sync_synchronize()
+#else
+#define MAMALOG_MEMORY_BARRIER()        MemoryBarrier()
+#endif
 
 
 /* ******************************************************************* */
@@ -89,16 +114,83 @@ static logSizeCbType logSizeCb          = NULL;
 static int           numRolledLogfiles  = 10;
 static int           appendToFile       = 0;
 
+/* ******************************************************************* */
+/* Async Logging */
+/* ******************************************************************* */
+
+/* A log message captured on the calling thread. The message is formatted
+ * when it is enqueued, as the arguments may not outlive the call, but the
+ * timestamp and output are left to the writer thread.
+ */
+typedef struct mamaLogRecord_
+{
+    struct timeval  mTime;
+    unsigned int    mThreadId;
+    MamaLogLevel    mLevel;
+    int             mForce;
+    char            mText[MAMALOG_ASYNC_RECORD_LENGTH];
+} mamaLogRecord;
+
+/* A single producer, single consumer ring owned by one logging thread and
+ * drained by the writer thread. The indices only ever increase, the slot is
+ * the index masked by the (power of two) size.
+ */
+typedef struct mamaLogRing_
+{
+    mamaLogRecord*          mRecords;
+    uint32_t                mSize;
+    volatile uint32_t       mHead;
+    volatile uint32_t       mTail;
+    volatile uint32_t       mDropped;
+    uint32_t                mDroppedSeen;
+    volatile int            mOrphaned;
+    unsigned int            mThreadId;
+    struct mamaLogRing_*    mNext;
+} mamaLogRing;
+
+typedef struct mamaLogAsync_
+{
+    /* Non-zero while records should be queued rather than written. */
+    volatile int            mEnabled;
+    /* The number of threads inside mamaLog_enqueue, the rings are only
+     * drained for the last time, or freed, once this has fallen to zero
+     * with mEnabled clear. */
+    wInterlockedInt         mInFlight;
+    volatile int            mStop;
+    int                     mKeyCreated;
+    int                     mRunning;
+    wthread_key_t           mKey;
+    wthread_t               mWriter;
+    wsem_t                  mWake;
+    uint32_t                mRecords;
+    unsigned int            mInterval;
+    mamaLogRing*            mRings;
+    mama_u64_t              mWritten;
+    mama_u64_t              mDropped;
+} mamaLogAsync;
+
+static mamaLogAsync           g_async;
+
+/* Protects the list of rings and the counters. */
+static wthread_static_mutex_t g_asyncLock = WSTATIC_MUTEX_INITIALIZER;
+
+/* Serialises switching async logging on and off, and the writer thread's
+ * lifecycle. Loggers never take this lock. */
+static wthread_static_mutex_t g_asyncStateLock = WSTATIC_MUTEX_INITIALIZER;
+
 /* ******************************************************************* */
 /* Function Prototypes */
 /* ******************************************************************* */
 
 MRSW_RESULT			mamaLog_acquireLock(int read);
 void				mamaLog_getTime(char *buffer, int bufferLength);
+void				mamaLog_formatTime(const struct timeval *timeNow, char *buffer, int bufferLength);
 void				mamaLog_logLimitReached(void);
 void MAMACALLTYPE	mamaLog_onLogCallback2(MamaLogLevel level, const char *format, va_list argumentList);
 mama_status			mamaLog_openLogFile(const char* fileName, const char* mode, FILE** file);
 mama_status			mamaLog_rollLogFiles(void);
+int					mamaLog_enqueue(MamaLogLevel level, int force, const char *prefix, const char *format, va_list ap);
+void*				mamaLog_asyncWriter(void *closure);
 
 /* ******************************************************************* */
 /* Private Functions */
@@ -144,14 +236,24 @@ mamaLog_getTime(char *buffer,
     struct timeval timeNow;
     memset(&timeNow, 0, sizeof(timeNow));
     gettimeofday(&timeNow, NULL);   
+
+    mamaLog_formatTime(&timeNow, buffer, bufferLength);
+}
+
+/*  Description :   As mamaLog_getTime but for a time captured earlier, used when
+ *                  writing queued records.
+ */
+void
+mamaLog_formatTime(const struct timeval *timeNow,
+                   char                 *buffer,
+                   int                  bufferLength)
+{
     {         
         /* Convert to local time zone */
         struct tm localTime;
-        struct tm timeIn;
+        time_t    timeIn = (time_t)timeNow->tv_sec;
         memset(&localTime, 0, sizeof(localTime));
-        memset(&timeIn, 0, sizeof(timeIn));        
-        timeIn.tm_sec = timeNow.tv_sec;
-        localtime_r ((const time_t*)&timeIn, &localTime);
+        localtime_r (&timeIn, &localTime);
         {
             /* Format the time string */
             size_t ft = strftime(buffer, bufferLength, "%Y-%m-%d %H:%M:%S:", &localTime);
@@ -169,7 +271,7 @@ mamaLog_getTime(char *buffer,
                 {
                     /* Format the number */
                     char milliseconds[7] = "";
-                    snprintf(milliseconds, 6, "%03d: ", (unsigned int)(timeNow.tv_usec / 1000));
+                    snprintf(milliseconds, 6, "%03d: ", (unsigned int)(timeNow->tv_usec / 1000));
 
                     /* Append the string */
                     strcat(buffer, milliseconds);
@@ -342,6 +444,307 @@ mamaLog_rollLogFiles(void)
     return MAMA_STATUS_OK;
 }
 
+/**
+ * Called when a logging thread exits, the writer will free the ring once
+ * it has written whatever is left in it.
+ */
+static void
+mamaLog_onThreadExit(void *closure)
+{
+    mamaLogRing* ring = (mamaLogRing*)closure;
+    mamaLogRing* next = NULL;
+
+    /* The ring may already have been freed by mama_logDestroy. */
+    wthread_static_mutex_lock(&g_asyncLock);
+    for(next = g_async.mRings; NULL != next; next = next->mNext)
+    {
+        if(next == ring)
+        {
+            ring->mOrphaned = 1;
+            break;
+        }
+    }
+    wthread_static_mutex_unlock(&g_asyncLock);
+}
+
+static mamaLogRing*
+mamaLog_getRing(void)
+{
+    mamaLogRing* ring = (mamaLogRing*)wthread_getspecific(g_async.mKey);
+    if(NULL == ring)
+    {
+        ring = (mamaLogRing*)calloc(1, sizeof(mamaLogRing));
+        if(NULL == ring)
+        {
+            return NULL;
+        }
+
+        ring->mRecords = (mamaLogRecord*)calloc(g_async.mRecords, sizeof(mamaLogRecord));
+        if(NULL == ring->mRecords)
+        {
+            free(ring);
+            return NULL;
+        }
+        ring->mSize     = g_async.mRecords;
+        ring->mThreadId = (unsigned int)wGetCurrentThreadId();
+
+        /* The writer only ever removes rings, so new ones go on the front. */
+        wthread_static_mutex_lock(&g_asyncLock);
+        ring->mNext    = g_async.mRings;
+        g_async.mRings = ring;
+        wthread_static_mutex_unlock(&g_asyncLock);
+
+        wthread_setspecific(g_async.mKey, ring);
+    }
+
+    return ring;
+}
+
+/**
+ * This function will queue a log message for the writer thread, it takes no
+ * locks once the calling thread has its ring.
+ * @return Non-zero if the message was queued or dropped, zero if it must be
+ * written synchronously.
+ */
+int
+mamaLog_enqueue(MamaLogLevel level,
+                int          force,
+                const char   *prefix,
+                const char   *format,
+                va_list      ap)
+{
+    mamaLogRing*    ring = NULL;
+    mamaLogRecord*  record;
+    uint32_t        head;
+    uint32_t        used;
+    int             len  = 0;
+
+    if(0 == g_async.mEnabled)
+    {
+        return 0;
+    }
+
+    /* Announce this thread before checking again, so that switching async
+     * logging off either stops it here or waits for it to finish. The
+     * interlocked increment is a full barrier. */
+    wInterlocked_increment(&g_async.mInFlight);
+    if(0 == g_async.mEnabled)
+    {
+        wInterlocked_decrement(&g_async.mInFlight);
+        return 0;
+    }
+
+    ring = mamaLog_getRing();
+    if(NULL == ring)
+    {
+        wInterlocked_decrement(&g_async.mInFlight);
+        return 0;
+    }
+
+    head = ring->mHead;
+    used = head - ring->mTail;
+    if(used >= ring->mSize)
+    {
+        /* Never block the caller, the writer reports the loss. */
+        ring->mDropped++;
+        wInterlocked_decrement(&g_async.mInFlight);
+        return 1;
+    }
+
+    record = &ring->mRecords[head & (ring->mSize - 1)];
+    gettimeofday(&record->mTime, NULL);
+    record->mThreadId = ring->mThreadId;
+    record->mLevel    = level;
+    record->mForce    = force;
+
+    if(NULL != prefix)
+    {
+        len = snprintf(record->mText, MAMALOG_ASYNC_RECORD_LENGTH, "%s: ", prefix);
+        if((len < 0) || (len >= MAMALOG_ASYNC_RECORD_LENGTH))
+        {
+            len = 0;
+        }
+    }
+    vsnprintf(record->mText + len, MAMALOG_ASYNC_RECORD_LENGTH - len, format, ap);
+
+    /* Publish the record. */
+    MAMALOG_MEMORY_BARRIER();
+    ring->mHead = head + 1;
+
+    /* Wake the writer early rather than let the ring fill. */
+    if(used + 1 == ring->mSize / 2)
+    {
+        wsem_post(&g_async.mWake);
+    }
+
+    wInterlocked_decrement(&g_async.mInFlight);
+    return 1;
+}
+
+/**
+ * Queue an already formatted message.
+ */
+static int
+mamaLog_enqueueString(MamaLogLevel level,
+                      const char   *format,
+                      ...)
+{
+    int     ret;
+    va_list ap;
+
+    va_start(ap, format);
+    ret = mamaLog_enqueue(level, 0, NULL, format, ap);
+    va_end(ap);
+
+    return ret;
+}
+
+#define mamaLog_enqueueMessage(level, message) \
+    mamaLog_enqueueString((level), "%s", (message))
+
+/**
+ * Write everything queued in one ring, this must be called under a reader
+ * lock on the writer thread.
+ * @return The number of records written.
+ */
+static uint32_t
+mamaLog_drainRing(mamaLogRing *ring)
+{
+    char        ts[MAMALOG_TIME_BUFFER_LENGTH] = "";
+    uint32_t    tail    = ring->mTail;
+    uint32_t    head    = ring->mHead;
+    uint32_t    dropped = ring->mDropped;
+    uint32_t    count   = 0;
+    FILE*       f       = NULL;
+
+    MAMALOG_MEMORY_BARRIER();
+
+    if((tail == head) && (dropped == ring->mDroppedSeen))
+    {
+        return 0;
+    }
+
+    if(loggingToFile)
+    {
+        mamaLog_logLimitReached();
+        f = gMamaControlledLogFile;
+    }
+    else
+    {
+        f = (gMamaLogFile == NULL) ? stderr : gMamaLogFile;
+    }
+
+    for(; tail != head; ++tail, ++count)
+    {
+        mamaLogRecord* record = &ring->mRecords[tail & (ring->mSize - 1)];
+
+        mamaLog_formatTime(&record->mTime, ts, MAMALOG_TIME_BUFFER_LENGTH);
+        fputs(ts, f);
+        if((record->mForce) || (gMamaLogLevel == MAMA_LOG_LEVEL_FINEST))
+        {
+            fprintf(f, "(%x) : ", record->mThreadId);
+        }
+        fputs(record->mText, f);
+        fputc('\n', f);
+    }
+
+    if(dropped != ring->mDroppedSeen)
+    {
+        mamaLog_getTime(ts, MAMALOG_TIME_BUFFER_LENGTH);
+        fprintf(f, "%s(%x) : Dropped %u log messages, async log buffer full.\n",
+                ts, ring->mThreadId, dropped - ring->mDroppedSeen);
+    }
+    fflush(f);
+
+    /* Hand the slots back to the logging thread. */
+    MAMALOG_MEMORY_BARRIER();
+    ring->mTail = tail;
+
+    wthread_static_mutex_lock(&g_asyncLock);
+    g_async.mWritten    += count;
+    g_async.mDropped    += (dropped - ring->mDroppedSeen);
+    wthread_static_mutex_unlock(&g_asyncLock);
+    ring->mDroppedSeen   = dropped;
+
+    return count;
+}
+
+static void
+mamaLog_freeRing(mamaLogRing *ring)
+{
+    free(ring->mRecords);
+    free(ring);
+}
+
+/**
+ * Write everything queued by all threads and free the rings of threads that
+ * have exited.
+ * @return The number of records written.
+ */
+static uint32_t
+mamaLog_drainRings(void)
+{
+    mamaLogRing*    ring;
+    uint32_t        count = 0;
+
+    wthread_static_mutex_lock(&g_asyncLock);
+    ring = g_async.mRings;
+    wthread_static_mutex_unlock(&g_asyncLock);
+
+    if(NULL == ring)
+    {
+        return 0;
+    }
+
+    if(MRSW_S_OK != mamaLog_acquireLock(1))
+    {
+        return 0;
+    }
+
+    while(NULL != ring)
+    {
+        mamaLogRing* next = ring->mNext;
+        int orphaned      = ring->mOrphaned;
+
+        count += mamaLog_drainRing(ring);
+
+        if(orphaned)
+        {
+            mamaLogRing** prev;
+
+            wthread_static_mutex_lock(&g_asyncLock);
+            for(prev = &g_async.mRings; *prev != ring; prev = &(*prev)->mNext);
+            *prev = ring->mNext;
+            wthread_static_mutex_unlock(&g_asyncLock);
+
+            mamaLog_freeRing(ring);
+        }
+
+        ring = next;
+    }
+
+    MRSWLock_release(g_lock, 1);
+
+    return count;
+}
+
+void*
+mamaLog_asyncWriter(void *closure)
+{
+    while(0 == g_async.mStop)
+    {
+        if(0 == mamaLog_drainRings())
+        {
+            wsem_timedwait(&g_async.mWake, g_async.mInterval);
+        }
+    }
+
+    /* Pick up anything queued before logging was switched back. */
+    mamaLog_drainRings();
+
+    return NULL;
+}
+
 /* ******************************************************************* */
 /* Public Functions */
 /* ******************************************************************* */
@@ -353,6 +756,31 @@ mamaLog_rollLogFiles(void)
 void
 mama_logDestroy(void)
 {
+    mamaLogRing* ring = NULL;
+
+    /* Stop the async writer first, it needs the lock to drain. Once it has
+     * gone no logger is using the rings. */
+    mama_logDisableAsync();
+
+    wthread_static_mutex_lock(&g_asyncStateLock);
+    wthread_static_mutex_lock(&g_asyncLock);
+    ring           = g_async.mRings;
+    g_async.mRings = NULL;
+    if(g_async.mKeyCreated)
+    {
+        wthread_key_delete(g_async.mKey);
+        g_async.mKeyCreated = 0;
+    }
+    wthread_static_mutex_unlock(&g_asyncLock);
+    wthread_static_mutex_unlock(&g_asyncStateLock);
+
+    while(NULL != ring)
+    {
+        mamaLogRing* next = ring->mNext;
+        mamaLog_freeRing(ring);
+        ring = next;
+    }
+
     /* Acquire the write lock. */
 	mamaLog_acquireLock(0);	
 
@@ -384,6 +812,9 @@ mama_logDestroy(void)
 void
 mama_loginit(void)
 {
+	int         async        = 0;
+	mama_size_t asyncRecords = 0;
+
 	/* Acquire the write lock. */
 	MRSW_RESULT al = mamaLog_acquireLock(0);
 	if(MRSW_S_OK == al)
@@ -458,8 +889,31 @@ mama_loginit(void)
 			mama_logToFile (propstring, gMamaLogLevel);
 		}
 
+		propstring = properties_Get(mamaInternal_getProperties(), ASYNCINTPROPERTY);
+		if (propstring)
+		{
+			g_async.mInterval = atoi(propstring);
+		}
+
+		propstring = properties_Get(mamaInternal_getProperties(), ASYNCPROPERTY);
+		if (propstring)
+		{
+			async = properties_GetPropertyValueAsBoolean(propstring);
+		}
+
+		propstring = properties_Get(mamaInternal_getProperties(), ASYNCSIZEPROPERTY);
+		if (propstring)
+		{
+			asyncRecords = atoi(propstring);
+		}
+
 		/* Release the write lock. */
 		MRSWLock_release(g_lock, 0);
+
+		if (async)
+		{
+			mama_logEnableAsync(asyncRecords);
+		}
 	}    
 }
 
@@ -468,6 +922,16 @@ mama_logDefault(MamaLogLevel level,
                 const char   *format,
                 va_list      ap)
 {
+	/* In async mode the message is queued without taking the lock. */
+	if (g_async.mEnabled)
+	{
+		if ((gMamaLogLevel < level) || (gMamaLogLevel == MAMA_LOG_LEVEL_OFF))
+			return;
+
+		if (mamaLog_enqueue(level, 0, NULL, format, ap))
+			return;
+	}
+
 	/* Acquire the read lock. */
 	MRSW_RESULT al = mamaLog_acquireLock(1);
 	if(MRSW_S_OK == al)
@@ -542,6 +1006,9 @@ mama_forceLogDefault (MamaLogLevel level,
                       const char* format,
                       va_list ap)
 {
+	if (mamaLog_enqueue(level, 1, NULL, format, ap))
+		return;
+
 	/* Acquire the read lock. */
 	MRSW_RESULT al = mamaLog_acquireLock(1);
 	if(MRSW_S_OK == al)
@@ -975,6 +1442,15 @@ void MAMACALLTYPE
 mama_logDefault2 (MamaLogLevel level,
                   const char *message)
 {
+	if (g_async.mEnabled)
+	{
+		if ((gMamaLogLevel < level) || (gMamaLogLevel == MAMA_LOG_LEVEL_OFF))
+			return;
+
+		if (mamaLog_enqueueMessage(level, message))
+			return;
+	}
+
 	/* Acquire the read lock. */
 	mamaLog_acquireLock(1);
 
@@ -1064,7 +1540,12 @@ mama_forceLogVaWithPrefix (const char* prefix,
                            const char* format,
                            va_list     args)
 {
-    MRSW_RESULT al = mamaLog_acquireLock(1);
+    MRSW_RESULT al;
+
+    if (mamaLog_enqueue(MAMA_LOG_LEVEL_OFF, 1, prefix, format, args))
+        return;
+
+    al = mamaLog_acquireLock(1);
     if(MRSW_S_OK == al)
     {
         char    ts[MAMALOG_TIME_BUFFER_LENGTH] = "";
@@ -1313,3 +1794,122 @@ mama_status mama_logForceRollLogFiles(void)
 	}
     return ret;
 }
+
+mama_status
+mama_logEnableAsync(mama_size_t recordsPerThread)
+{
+    mama_status ret     = MAMA_STATUS_OK;
+    uint32_t    records = MAMALOG_ASYNC_DEFAULT_RECORDS;
+
+    /* Round up to a power of two so slots can be found with a mask. */
+    if(recordsPerThread > 0)
+    {
+        records = 2;
+        while((records < recordsPerThread) && (records < 0x40000000))
+        {
+            records <<= 1;
+        }
+    }
+
+    wthread_static_mutex_lock(&g_asyncStateLock);
+
+    if(g_async.mRunning)
+    {
+        wthread_static_mutex_unlock(&g_asyncStateLock);
+        return MAMA_STATUS_OK;
+    }
+
+    if(!g_async.mKeyCreated)
+    {
+        if(0 != wthread_key_create(&g_async.mKey, mamaLog_onThreadExit))
+        {
+            wthread_static_mutex_unlock(&g_asyncStateLock);
+            return MAMA_STATUS_PLATFORM;
+        }
+        g_async.mKeyCreated = 1;
+    }
+
+    /* Rings created under an earlier setting keep their size. */
+    g_async.mRecords = records;
+    if(0 == g_async.mInterval)
+    {
+        g_async.mInterval = MAMALOG_ASYNC_DEFAULT_INTERVAL;
+    }
+    g_async.mStop = 0;
+
+    wsem_init(&g_async.mWake, 0, 0);
+    if(0 != wthread_create(&g_async.mWriter, NULL, mamaLog_asyncWriter, NULL))
+    {
+        wsem_destroy(&g_async.mWake);
+        ret = MAMA_STATUS_PLATFORM;
+    }
+    else
+    {
+        g_async.mRunning = 1;
+        g_async.mEnabled = 1;
+    }
+
+    wthread_static_mutex_unlock(&g_asyncStateLock);
+
+    return ret;
+}
+
+mama_status
+mama_logDisableAsync(void)
+{
+    wthread_static_mutex_lock(&g_asyncStateLock);
+
+    if(!g_async.mRunning)
+    {
+        wthread_static_mutex_unlock(&g_asyncStateLock);
+        return MAMA_STATUS_OK;
+    }
+
+    /* Stop new records being queued, then wait for any logger already
+     * queueing one, so that the writer's last drain sees every record
+     * and nothing touches the rings once it has gone. */
+    g_async.mEnabled = 0;
+    MAMALOG_MEMORY_BARRIER();
+    while(0 != wInterlocked_read(&g_async.mInFlight))
+    {
+        struct wtimespec wait;
+        wait.tv_sec  = 0;
+        wait.tv_nsec = MAMALOG_ASYNC_QUIESCE_WAIT;
+        wnanosleep(&wait, NULL);
+    }
+
+    g_async.mStop    = 1;
+    g_async.mRunning = 0;
+
+    /* The writer drains the rings once more before it exits. */
+    wsem_post(&g_async.mWake);
+    wthread_join(g_async.mWriter, NULL);
+    wsem_destroy(&g_async.mWake);
+
+    wthread_static_mutex_unlock(&g_asyncStateLock);
+
+    return MAMA_STATUS_OK;
+}
+
+int
+mama_logIsAsync(void)
+{
+    return g_async.mEnabled;
+}
+
+mama_status
+mama_logGetAsyncStats(mama_u64_t *written,
+                      mama_u64_t *dropped)
+{
+    if((NULL == written) || (NULL == dropped))
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    wthread_static_mutex_lock(&g_asyncLock);
+    *written = g_async.mWritten;
+    *dropped = g_async.mDropped;
+    wthread_static_mutex_unlock(&g_asyncLock);
+
+    return MAMA_STATUS_OK;
+}
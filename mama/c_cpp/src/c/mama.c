@@ -43,6 +43,7 @@
 #include <mama/stat.h>
 #include <mama/statfields.h>
 #include <statsgeneratorinternal.h>
+#include <statinternal.h>
 #include <mama/statscollector.h>
 #include "transportimpl.h"
 
@@ -879,6 +880,16 @@ mama_statsInit (void)
         propVal           = properties_Get (gProperties, "mama.statslogging.user.publishing");
         if ( propVal != NULL)
             gPublishUserStats = strtobool(propVal);
+
+        /* Shard the lockable stats so dispatch threads do not contend */
+        propVal           = properties_Get (gProperties, "mama.statslogging.sharded");
+        if ( propVal != NULL)
+            mamaStat_setShardLockable (strtobool(propVal));
+
+        /* Record latency histograms for queues and transports */
+        propVal           = properties_Get (gProperties, "mama.statslogging.latency");
+        if ( propVal != NULL)
+            mamaLatency_setEnabled (strtobool(propVal));
         
         if (gLogGlobalStats || gPublishGlobalStats) gGenerateGlobalStats=1;
         if (gLogTransportStats || gPublishTransportStats) gGenerateTransportStats=1;
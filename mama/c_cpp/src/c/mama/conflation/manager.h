@@ -36,6 +36,24 @@ typedef void (MAMACALLTYPE *mamaConflationEnqueueCallback)(mamaMsg     msg,
                                                            const char* topic,
                                                            void*       closure);
 
+/**
+ * How messages for the same topic are combined while they wait on the
+ * conflation queue.
+ *
+ * MAMA_CONFLATION_POLICY_NONE       Every message is queued (the default).
+ * MAMA_CONFLATION_POLICY_LAST_VALUE A message replaces the contents of the
+ *                                   one already queued for its topic.
+ * MAMA_CONFLATION_POLICY_MERGE      The fields of a message are applied over
+ *                                   the one already queued for its topic
+ *                                   with mamaMsg_applyMsg().
+ */
+typedef enum mamaConflationPolicy_
+{
+    MAMA_CONFLATION_POLICY_NONE       = 0,
+    MAMA_CONFLATION_POLICY_LAST_VALUE = 1,
+    MAMA_CONFLATION_POLICY_MERGE      = 2
+} mamaConflationPolicy;
+
 /**
  * @brief Allocation of memory for the mama conflation manager 
  *
@@ -126,6 +144,75 @@ mamaConflationManager_setEnqueueCallback (mamaConflationManager         mgr,
                                           mamaConflationEnqueueCallback callback,
                                           void*                         closure);
 
+/**
+ * @brief Set how queued messages for the same topic are conflated.
+ *
+ * @details With a policy other than MAMA_CONFLATION_POLICY_NONE at most one
+ * message per topic waits on the queue: a message for a topic which already
+ * has one queued is folded into it and keeps its place in the queue, and is
+ * not retained by the conflation manager. The memory held for a slow
+ * consumer is then bounded by the number of distinct topics rather than the
+ * size of the backlog.
+ *
+ * @details Only updates are folded, and only into a queued update. The
+ * conflated message carries the latest sequence number with wConflateCount
+ * set to the number of updates it stands for, so the subscriber does not
+ * see a gap. Any other message type is queued as it is and ends conflation
+ * into the update queued ahead of it.
+ *
+ * @details Conflation applies to messages queued with
+ * mamaConflationManager_enqueue(), so it is bypassed while an enqueue
+ * callback is installed unless the callback enqueues them. The topic
+ * returned with a conflated message is a copy held by the conflation manager
+ * and is valid until it is destroyed.
+ *
+ * @details Changing the policy leaves queued messages where they are but
+ * stops them absorbing further updates, so conflation under the new policy
+ * starts with the next message for each topic.
+ *
+ * @param[in] mgr    The mama conflation manager
+ * @param[in] policy The conflation policy
+ *
+ * @return mama_status return code can be one of:
+ *              MAMA_STATUS_INVALID_ARG
+ *              MAMA_STATUS_OK
+ */
+mama_status
+mamaConflationManager_setPolicy (mamaConflationManager mgr,
+                                 mamaConflationPolicy  policy);
+
+/**
+ * @brief Get the conflation policy.
+ *
+ * @param[in]  mgr    The mama conflation manager
+ * @param[out] policy The conflation policy
+ *
+ * @return mama_status return code can be one of:
+ *              MAMA_STATUS_INVALID_ARG
+ *              MAMA_STATUS_OK
+ */
+mama_status
+mamaConflationManager_getPolicy (mamaConflationManager mgr,
+                                 mamaConflationPolicy* policy);
+
+/**
+ * @brief Set the longest time a queued message keeps absorbing updates for
+ * its topic. Once it has been queued for longer the next update for the
+ * topic is queued behind it rather than folded in, so a consumer that is
+ * behind still sees a topic change at least this often. Defaults to 0,
+ * which conflates for as long as the message is queued.
+ *
+ * @param[in] mgr      The mama conflation manager
+ * @param[in] interval The interval in seconds
+ *
+ * @return mama_status return code can be one of:
+ *              MAMA_STATUS_INVALID_ARG
+ *              MAMA_STATUS_OK
+ */
+mama_status
+mamaConflationManager_setMaxConflationInterval (mamaConflationManager mgr,
+                                                mama_f64_t            interval);
+
 /*
  * @brief Enqueue a message to the MamaConflationManager's queue. If there is no
  * MamaConflationEnqueueCallback specified, the conflation manager invokes
@@ -43,6 +43,7 @@ typedef enum mamaDateTimePrecision_
     MAMA_DATE_TIME_PREC_CENTISECONDS = 2,
     MAMA_DATE_TIME_PREC_MILLISECONDS = 3,
     MAMA_DATE_TIME_PREC_MICROSECONDS = 6,
+    MAMA_DATE_TIME_PREC_NANOSECONDS  = 9,
     MAMA_DATE_TIME_PREC_DAYS         = 10,
     MAMA_DATE_TIME_PREC_MINUTES      = 12,
     MAMA_DATE_TIME_PREC_UNKNOWN      = 15
@@ -59,6 +60,19 @@ typedef mama_u8_t  mamaDateTimeHints;
 #define MAMA_DATE_TIME_HAS_TIME    ((mamaDateTimeHints) 0x02)
 #define MAMA_DATE_TIME_NO_TIMEZONE ((mamaDateTimeHints) 0x04)
 
+/**
+ * The storage behind a mamaDateTime, for code which embeds a date/time
+ * rather than calling mamaDateTime_create(). Initialise it with
+ * mamaDateTime_initStorage(). A bare mama_u64_t may still be used as a
+ * mamaDateTime, but only holds microseconds.
+ */
+typedef struct mamaDateTimeStorage_
+{
+    mama_u64_t  mTime;
+    /* Nanoseconds within the microsecond */
+    mama_u32_t  mNanoseconds;
+} mamaDateTimeStorage;
+
 
 /**
  * Create a date/time object.
@@ -69,6 +83,17 @@ MAMAExpDLL
 extern mama_status
 mamaDateTime_create (mamaDateTime* dateTime);
 
+/**
+ * Initialise embedded date/time storage to an empty date/time able to hold
+ * nanoseconds.
+ *
+ * @param storage The storage to initialise.
+ * @return The mamaDateTime for the storage, NULL if storage is NULL.
+ */
+MAMAExpDLL
+extern mamaDateTime
+mamaDateTime_initStorage (mamaDateTimeStorage* storage);
+
 /**
  * Destroy a mamaDateTime object.
  *
@@ -191,6 +216,32 @@ extern mama_status
 mamaDateTime_setEpochTimeMicroseconds(mamaDateTime dateTime,
                                       mama_u64_t   milliseconds);
 
+/**
+ * Set the date and time as nanoseconds. The precision is set to
+ * MAMA_DATE_TIME_PREC_NANOSECONDS if there is a fractional second. A
+ * date/time which is not from mamaDateTime_create(), mamaDateTime_initStorage()
+ * or MamaDateTime keeps only whole microseconds.
+ *
+ * @param dateTime The dateTime to set.
+ * @param nanoseconds  The number of nanoseconds since the Epoch.
+ */
+MAMAExpDLL
+extern mama_status
+mamaDateTime_setEpochTimeNanoseconds(mamaDateTime dateTime,
+                                     mama_u64_t   nanoseconds);
+
+/**
+ * Set the fraction of the second in nanoseconds, leaving the rest of the
+ * date/time and the precision alone.
+ *
+ * @param dateTime      The dateTime to set.
+ * @param nanosecond    The nanosecond (0-999999999).
+ */
+MAMAExpDLL
+extern mama_status
+mamaDateTime_setNanosecond(mamaDateTime dateTime,
+                           mama_u32_t   nanosecond);
+
 /**
  * Set the date and/or time with special, optional hints to indicate
  * whether the date/time includes date information, time information
@@ -545,6 +596,38 @@ mamaDateTime_getEpochTimeMicrosecondsWithTz(const mamaDateTime dateTime,
                                             mama_u64_t*        microseconds,
                                             const mamaTimeZone tz);
     
+/**
+ * Get the date and time as nanoseconds since the Epoch (UTC time zone).
+ * Only arithmetic is involved, no struct tm.
+ *
+ * @param[in] 	dateTime 		The dateTime to obtain the number of nanoseconds from.
+ * @param[out] 	nanoseconds  	The number of nanoseconds since the Epoch.
+ * @return Indicates whether the function succeeded or failed and could be one of:
+ *				- MAMA_STATUS_INVALID_ARG
+ *				- MAMA_STATUS_OK
+ */
+MAMAExpDLL
+extern mama_status
+mamaDateTime_getEpochTimeNanoseconds(const mamaDateTime dateTime,
+                                     mama_u64_t*        nanoseconds);
+
+/**
+ * Get the date and time as nanoseconds since the Epoch in the supplied
+ * time zone.
+ *
+ * @param[in] 	dateTime 		The dateTime to obtain the number of nanoseconds from.
+ * @param[out] 	nanoseconds  	The number of nanoseconds since the Epoch.
+ * @param[in] 	tz 			 	The timezone.
+ * @return Indicates whether the function succeeded or failed and could be one of:
+ *				- MAMA_STATUS_INVALID_ARG
+ *				- MAMA_STATUS_OK
+ */
+MAMAExpDLL
+extern mama_status
+mamaDateTime_getEpochTimeNanosecondsWithTz(const mamaDateTime dateTime,
+                                           mama_u64_t*        nanoseconds,
+                                           const mamaTimeZone tz);
+
 /**
  * Get the date and time as milliseconds since the Epoch (UTC time
  * zone).
@@ -871,6 +954,17 @@ extern mama_status
 mamaDateTime_getMicrosecond(const mamaDateTime dateTime,
                             mama_u32_t*        result);
 
+/**
+ * Get the nanosecond (0-999999999).
+ *
+ * @param dateTime      The dateTime from which to get the result.
+ * @param result        The result of the get method.
+ */
+MAMAExpDLL
+extern mama_status
+mamaDateTime_getNanosecond(const mamaDateTime dateTime,
+                           mama_u32_t*        result);
+
 /**
  * Get the day of week.
  *
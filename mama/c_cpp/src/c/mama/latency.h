@@ -0,0 +1,241 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#ifndef MamaLatencyH__
+#define MamaLatencyH__
+
+#include "mama/types.h"
+#include "mama/status.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ * Points in the delivery pipeline at which a message may be timestamped.
+ * Receive and enqueue are stamped by middleware bridges which support it,
+ * dispatch and callback-done are stamped by MAMA itself.
+ */
+typedef enum mamaLatencyStage
+{
+    MAMA_LATENCY_STAGE_RECEIVE       = 0,
+    MAMA_LATENCY_STAGE_ENQUEUE       = 1,
+    MAMA_LATENCY_STAGE_DISPATCH      = 2,
+    MAMA_LATENCY_STAGE_CALLBACK_DONE = 3,
+    MAMA_LATENCY_STAGE_MAX           = 4
+} mamaLatencyStage;
+
+/**
+ * The intervals recorded in latency histograms.
+ *
+ * MAMA_LATENCY_SPAN_QUEUE    enqueue (or receive) to dispatch.
+ * MAMA_LATENCY_SPAN_CALLBACK dispatch to return of the user callback.
+ * MAMA_LATENCY_SPAN_TOTAL    the earliest stamp to return of the callback.
+ */
+typedef enum mamaLatencySpan
+{
+    MAMA_LATENCY_SPAN_QUEUE    = 0,
+    MAMA_LATENCY_SPAN_CALLBACK = 1,
+    MAMA_LATENCY_SPAN_TOTAL    = 2,
+    MAMA_LATENCY_SPAN_MAX      = 3
+} mamaLatencySpan;
+
+/**
+ * A log-linear histogram of nanosecond latencies. Values are counted in
+ * buckets whose width is 1/32 of their magnitude, so any percentile is
+ * reported to within about 3%, up to roughly 36 minutes. Recording is a
+ * couple of atomic adds and may be done from any thread.
+ */
+typedef struct mamaLatencyHistogramImpl_* mamaLatencyHistogram;
+
+/**
+ * Enable or disable latency measurement. Measurement is off by default and
+ * may also be enabled with the mama.statslogging.latency property. Queues
+ * and transports only get histograms if measurement is enabled when their
+ * stats are created.
+ *
+ * @param enable Non-zero to enable.
+ */
+MAMAExpDLL
+extern void
+mamaLatency_setEnabled (int enable);
+
+/**
+ * @return Non-zero if latency measurement is enabled.
+ */
+MAMAExpDLL
+extern int
+mamaLatency_isEnabled (void);
+
+/**
+ * Return a monotonic timestamp in nanoseconds, for bridges and applications
+ * which stamp messages themselves. Only differences between timestamps are
+ * meaningful.
+ */
+MAMAExpDLL
+extern mama_u64_t
+mamaLatency_getTimestamp (void);
+
+/**
+ * Create an empty histogram.
+ *
+ * @param histogram The location to store the new histogram.
+ */
+MAMAExpDLL
+extern mama_status
+mamaLatencyHistogram_create (mamaLatencyHistogram* histogram);
+
+/**
+ * Destroy a histogram created with mamaLatencyHistogram_create. Histograms
+ * owned by queues and transports must not be destroyed.
+ */
+MAMAExpDLL
+extern mama_status
+mamaLatencyHistogram_destroy (mamaLatencyHistogram histogram);
+
+/**
+ * Record a single latency.
+ *
+ * @param histogram The histogram.
+ * @param nanos     The latency in nanoseconds.
+ */
+MAMAExpDLL
+extern mama_status
+mamaLatencyHistogram_record (mamaLatencyHistogram histogram,
+                             mama_u64_t           nanos);
+
+/**
+ * Discard all recorded values. Values recorded concurrently with a reset
+ * may be lost.
+ */
+MAMAExpDLL
+extern mama_status
+mamaLatencyHistogram_reset (mamaLatencyHistogram histogram);
+
+/**
+ * Add the counts of one histogram into another.
+ *
+ * @param histogram The histogram to add to.
+ * @param other     The histogram to add.
+ */
+MAMAExpDLL
+extern mama_status
+mamaLatencyHistogram_merge (mamaLatencyHistogram histogram,
+                            mamaLatencyHistogram other);
+
+/**
+ * Get the number of values recorded.
+ */
+MAMAExpDLL
+extern mama_status
+mamaLatencyHistogram_getCount (mamaLatencyHistogram histogram,
+                               mama_u64_t*          count);
+
+/**
+ * Get the latency at or below which the given percentage of the recorded
+ * values fall, e.g. 99.9. Zero is returned if nothing has been recorded.
+ *
+ * @param histogram  The histogram.
+ * @param percentile The percentile, from 0 to 100.
+ * @param nanos      The location to store the latency in nanoseconds.
+ */
+MAMAExpDLL
+extern mama_status
+mamaLatencyHistogram_getPercentile (mamaLatencyHistogram histogram,
+                                    mama_f64_t           percentile,
+                                    mama_u64_t*          nanos);
+
+/**
+ * Get the largest latency recorded, exactly.
+ */
+MAMAExpDLL
+extern mama_status
+mamaLatencyHistogram_getMax (mamaLatencyHistogram histogram,
+                             mama_u64_t*          nanos);
+
+/**
+ * Get the mean of the latencies recorded, in nanoseconds.
+ */
+MAMAExpDLL
+extern mama_status
+mamaLatencyHistogram_getMean (mamaLatencyHistogram histogram,
+                              mama_f64_t*          nanos);
+
+/**
+ * Get the latency histogram for one span of a stats collector. Queue and
+ * transport collectors have them when latency measurement is enabled; the
+ * histograms are reset once all collectors' stats have been reported.
+ *
+ * @param statsCollector The stats collector.
+ * @param span           The span.
+ * @param histogram      The location to store the histogram, owned by the
+ *                       collector.
+ * @return MAMA_STATUS_NOT_FOUND if the collector has no histograms.
+ */
+MAMAExpDLL
+extern mama_status
+mamaStatsCollector_getLatencyHistogram (mamaStatsCollector    statsCollector,
+                                        mamaLatencySpan       span,
+                                        mamaLatencyHistogram* histogram);
+
+/**
+ * Get the latency histogram for one span of messages dispatched from a
+ * queue. Requires queue stats and latency measurement to be enabled.
+ */
+MAMAExpDLL
+extern mama_status
+mamaQueue_getLatencyHistogram (mamaQueue             queue,
+                               mamaLatencySpan       span,
+                               mamaLatencyHistogram* histogram);
+
+/**
+ * Get the latency histogram for one span of messages received on a
+ * transport. Requires transport stats and latency measurement to be enabled.
+ * The histogram is rebuilt on each call by merging the histograms of the
+ * queues the transport's subscriptions dispatch on, so those queues need
+ * queue stats enabled too.
+ */
+MAMAExpDLL
+extern mama_status
+mamaTransport_getLatencyHistogram (mamaTransport         transport,
+                                   mamaLatencySpan       span,
+                                   mamaLatencyHistogram* histogram);
+
+/**
+ * Get the time a message passed a stage of the pipeline, as returned by
+ * mamaLatency_getTimestamp. Only valid in the subscription callback.
+ *
+ * @param msg   The message.
+ * @param stage The stage.
+ * @param nanos The location to store the timestamp, zero if not stamped.
+ */
+MAMAExpDLL
+extern mama_status
+mamaMsg_getLatencyStageTime (const mamaMsg    msg,
+                             mamaLatencyStage stage,
+                             mama_u64_t*      nanos);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* MamaLatencyH__ */
@@ -31,6 +31,7 @@ extern "C"
 #endif
 
 #include "mama/status.h"
+#include "mama/types.h"
 
 /**
  * @brief MAMA Log Level
@@ -521,6 +522,60 @@ MAMAExpDLL
 extern mama_status
 mama_logForceRollLogFiles(void);
 
+/**
+ * @brief Write log messages from a background thread.
+ *
+ * @details Once enabled, the default log functions format each message into
+ * a ring owned by the calling thread and return without taking any locks or
+ * doing any I/O. A single writer thread timestamps, writes and flushes the
+ * messages in batches, applying the usual log file policy. If a thread's
+ * ring is full its messages are dropped and the writer logs how many were
+ * lost. Messages longer than the record size are truncated.
+ *
+ * Custom log callbacks are unaffected. This can also be turned on with the
+ * mama.logging.async, mama.logging.async.records and
+ * mama.logging.async.interval (milliseconds) properties.
+ *
+ * @param[in] recordsPerThread The number of messages each thread can have
+ * queued, rounded up to a power of two. 0 uses the default of 4096.
+ *
+ * @return The status of the operation.
+ */
+MAMAExpDLL
+extern mama_status
+mama_logEnableAsync(mama_size_t recordsPerThread);
+
+/**
+ * @brief Write log messages on the calling thread again.
+ *
+ * @details Waits for the writer thread to write any queued messages.
+ *
+ * @return The status of the operation.
+ */
+MAMAExpDLL
+extern mama_status
+mama_logDisableAsync(void);
+
+/**
+ * @brief Return non-zero if log messages are being written asynchronously.
+ */
+MAMAExpDLL
+extern int
+mama_logIsAsync(void);
+
+/**
+ * @brief Get the number of messages written and dropped by the async
+ * log writer since logging was initialised.
+ *
+ * @param[out] written The number of messages written.
+ * @param[out] dropped The number of messages dropped because a ring was full.
+ *
+ * @return The status of the operation.
+ */
+MAMAExpDLL
+extern mama_status
+mama_logGetAsyncStats(mama_u64_t* written, mama_u64_t* dropped);
+
 /**
  * @brief Destroy memory held by the logging.
  */
@@ -50,6 +50,7 @@
 #include <mama/subscriptiontype.h>
 #include <mama/quality.h>
 #include <mama/ft.h>
+#include <mama/latency.h>
 
 #if defined(__cplusplus)
 extern "C"
@@ -46,6 +46,7 @@ typedef enum mamaPayloadType_
     MAMA_PAYLOAD_V5         = '5',
     MAMA_PAYLOAD_AVIS       = 'A',
     MAMA_PAYLOAD_TICK42BLP  = 'B',
+    MAMA_PAYLOAD_FLAT       = 'C',
     MAMA_PAYLOAD_FAST       = 'F',
     MAMA_PAYLOAD_HMS        = 'H',
     MAMA_PAYLOAD_RAI        = 'I',
@@ -64,6 +64,25 @@ typedef struct mamaQueueMonitorCallbacks_
     mamaQueueLowWatermarkCb          onQueueLowWatermark;
 } mamaQueueMonitorCallbacks;
 
+/**
+ * Callback invoked when the average residency of events on a queue, the
+ * time between enqueue and dispatch, crosses a residency watermark. The
+ * residency is in microseconds. It is invoked on the dispatching thread.
+ */
+typedef void (MAMACALLTYPE *mamaQueueResidencyCb) (mamaQueue  queue,
+                                                   mama_u64_t residency,
+                                                   void*      closure);
+
+/**
+ * Callbacks for the residency watermarks, see
+ * mamaQueue_setHighResidencyWatermark.
+ */
+typedef struct mamaQueueResidencyCallbacks_
+{
+    mamaQueueResidencyCb onQueueHighResidency;
+    mamaQueueResidencyCb onQueueLowResidency;
+} mamaQueueResidencyCallbacks;
+
 /**
  * Function invoked when an event is enqueued on the queue for which
  * this function was registered.
@@ -217,6 +236,40 @@ extern mama_status
 mamaQueue_setLowWatermark (mamaQueue queue,
                            size_t lowWatermark);
 
+/**
+ * Switch the queue into conflated delivery while it is above its high
+ * watermark. Successive updates for a subscription are then merged into the
+ * update still waiting on the queue, rather than queued behind it, until the
+ * queue drains to its low watermark. Conflation starts and stops as the
+ * onQueueHighWatermarkExceeded and onQueueLowWatermark monitor callbacks
+ * are invoked, and mamaQueue_isConflating reports the current state.
+ *
+ * Only updates are conflated, and only by bridges which support it (the
+ * qpid bridge does). A merged update carries the latest sequence number and
+ * a wConflateCount of the updates it stands for, so no gap is reported. Any
+ * other message is delivered in order behind the update it follows. The
+ * high watermark must be set for conflation to start.
+ *
+ * @param queue The queue.
+ * @param conflate Non zero to conflate above the high watermark.
+ */
+MAMAExpDLL
+extern mama_status
+mamaQueue_setConflateOnHighWatermark (mamaQueue queue,
+                                      int       conflate);
+
+/**
+ * Whether the queue is currently conflating updates, see
+ * mamaQueue_setConflateOnHighWatermark.
+ *
+ * @param queue The queue.
+ * @param conflating Address to which non zero is written while conflating.
+ */
+MAMAExpDLL
+extern mama_status
+mamaQueue_isConflating (mamaQueue queue,
+                        int*      conflating);
+
 /**
 * Get the value of the low water mark for the specified queue. A value of 1
 * will be returned if no low water mark was previously specified.
@@ -249,6 +302,72 @@ mamaQueue_setQueueMonitorCallbacks (
                         mamaQueueMonitorCallbacks*  queueMonitorCallbacks,
                         void*                       closure);
 
+/**
+ * Set the high residency watermark for the queue, in microseconds.
+ *
+ * Count watermarks say how many events are queued but not how long they
+ * have been waiting: a deep queue of cheap events may be healthy while a
+ * short queue of slow ones is not. When a residency watermark is set each
+ * event is stamped as it is enqueued and a moving average of the time
+ * events spend queued is kept. The onQueueHighResidency callback is invoked
+ * when the average reaches the high watermark, and onQueueLowResidency once
+ * it falls back to the low watermark.
+ *
+ * When queue stats and latency measurement are both enabled the queue
+ * latency span of each interval is also reported as the Queue Residency avg
+ * and max stats, in microseconds.
+ *
+ * Only supported by bridges which implement residency measurement, the
+ * qpid and avis bridges do.
+ *
+ * @param queue The queue.
+ * @param highResidency The watermark in microseconds, 0 disables.
+ * @return MAMA_STATUS_NOT_IMPLEMENTED if the bridge cannot measure residency.
+ */
+MAMAExpDLL
+extern mama_status
+mamaQueue_setHighResidencyWatermark (mamaQueue  queue,
+                                     mama_u64_t highResidency);
+
+/**
+ * Set the low residency watermark for the queue, in microseconds. If it is
+ * not set the low callback is invoked as soon as the average falls below the
+ * high watermark.
+ *
+ * @param queue The queue.
+ * @param lowResidency The watermark in microseconds, which must be less than
+ * the high residency watermark.
+ */
+MAMAExpDLL
+extern mama_status
+mamaQueue_setLowResidencyWatermark (mamaQueue  queue,
+                                    mama_u64_t lowResidency);
+
+/**
+ * Specify the callbacks invoked when the residency watermarks are crossed.
+ *
+ * @param queue The queue.
+ * @param callbacks The callbacks, copied.
+ * @param closure Passed to the callbacks.
+ */
+MAMAExpDLL
+extern mama_status
+mamaQueue_setResidencyCallbacks (mamaQueue                    queue,
+                                 mamaQueueResidencyCallbacks* callbacks,
+                                 void*                        closure);
+
+/**
+ * Get the moving average of the time recent events spent on the queue, in
+ * microseconds. Zero is returned if residency is not being measured.
+ *
+ * @param queue The queue.
+ * @param residency Address to which the residency will be written.
+ */
+MAMAExpDLL
+extern mama_status
+mamaQueue_getResidency (mamaQueue   queue,
+                        mama_u64_t* residency);
+
 /**
  * Writes the number of events currently on the specified queue to
  * the address specified by count.
@@ -422,6 +541,16 @@ mamaQueue_getNativeHandle (mamaQueue queue,
  * message from a single queue with multiple threads results in messages
  * arriving out of order and sequence number gaps for market data subscriptions.
  *
+ * The dispatch thread can be tuned with properties named after the queue,
+ * which must therefore be set with mamaQueue_setQueueName first:
+ *
+ * mama.queue.<name>.spin     Microseconds to busy poll an empty queue before
+ *                            blocking; avoids the wakeup cost on bursts at
+ *                            the expense of a busy core. Default 0.
+ * mama.queue.<name>.cpu      CPUs to pin the thread to, e.g. "3" or "2,4-5".
+ * mama.queue.<name>.sched    Scheduler policy: "other", "fifo" or "rr".
+ * mama.queue.<name>.priority Priority used with the fifo and rr policies.
+ *
  * @param result A pointer to the resulting mamaDispatcher.
  * @param queue The queue.
  * @return MAMA_STATUS_OK if the call is successful.
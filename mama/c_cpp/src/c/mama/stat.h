@@ -30,6 +30,9 @@ extern "C" {
 
 #define MAMA_STAT_NOT_LOCKABLE 0
 #define MAMA_STAT_LOCKABLE     1
+/* Updated with atomic adds to per-thread counters which are only summed
+   when the stat is read, see mamaStat_create. */
+#define MAMA_STAT_SHARDED      2
 
 typedef enum mamaStatType
 {
@@ -66,6 +69,12 @@ typedef enum mamaStatType
 /**
  * Create a mamaStats object
  *
+ * A MAMA_STAT_LOCKABLE stat takes a mutex on every update. A
+ * MAMA_STAT_SHARDED stat can also be updated from any thread, but each
+ * thread adds to its own cache line and the values are summed when the
+ * stat is read, so updates never contend. The maximum value of a sharded
+ * stat is only sampled when it is read.
+ *
  * @param stat  The location of a mamaStats to store the result
  */
 MAMAExpDLL
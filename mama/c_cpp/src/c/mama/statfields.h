@@ -91,6 +91,48 @@ extern const MamaReservedField  MamaStatPublisherInboxSend;             /* FID 1
 MAMAExpDLL
 extern const MamaReservedField  MamaStatPublisherReplySend;             /* FID 131 */
 
+/* Latency percentiles in nanoseconds, see mama/latency.h */
+MAMAExpDLL
+extern const MamaReservedField  MamaStatQueueLatencyP50;               /* FID 132 */
+MAMAExpDLL
+extern const MamaReservedField  MamaStatQueueLatencyP99;               /* FID 133 */
+MAMAExpDLL
+extern const MamaReservedField  MamaStatQueueLatencyP999;              /* FID 134 */
+MAMAExpDLL
+extern const MamaReservedField  MamaStatQueueLatencyMax;               /* FID 135 */
+MAMAExpDLL
+extern const MamaReservedField  MamaStatCallbackLatencyP50;            /* FID 136 */
+MAMAExpDLL
+extern const MamaReservedField  MamaStatCallbackLatencyP99;            /* FID 137 */
+MAMAExpDLL
+extern const MamaReservedField  MamaStatCallbackLatencyP999;           /* FID 138 */
+MAMAExpDLL
+extern const MamaReservedField  MamaStatCallbackLatencyMax;            /* FID 139 */
+MAMAExpDLL
+extern const MamaReservedField  MamaStatTotalLatencyP50;               /* FID 140 */
+MAMAExpDLL
+extern const MamaReservedField  MamaStatTotalLatencyP99;               /* FID 141 */
+MAMAExpDLL
+extern const MamaReservedField  MamaStatTotalLatencyP999;              /* FID 142 */
+MAMAExpDLL
+extern const MamaReservedField  MamaStatTotalLatencyMax;               /* FID 143 */
+
+/* Time events spent queued in microseconds, see mamaQueue_getResidency */
+MAMAExpDLL
+extern const MamaReservedField  MamaStatQueueResidencyAvg;             /* FID 144 */
+MAMAExpDLL
+extern const MamaReservedField  MamaStatQueueResidencyMax;             /* FID 145 */
+
+/* Recap pacing decisions made by the refresh transport */
+MAMAExpDLL
+extern const MamaReservedField  MamaStatRecapPacingRate;               /* FID 146 */
+MAMAExpDLL
+extern const MamaReservedField  MamaStatRecapPacingSent;               /* FID 147 */
+MAMAExpDLL
+extern const MamaReservedField  MamaStatRecapPacingDeferred;           /* FID 148 */
+MAMAExpDLL
+extern const MamaReservedField  MamaStatRecapPacingBackoffs;           /* FID 149 */
+
 #if defined(__cplusplus)
 }
 #endif
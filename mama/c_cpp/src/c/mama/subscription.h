@@ -335,6 +335,30 @@ extern mama_status
 mamaSubscription_allocate(
     mamaSubscription *result);
 
+/**
+ * @brief Allocate memory for a number of new subscriptions in one block.
+ *
+ * @details This is equivalent to calling mamaSubscription_allocate() for
+ * each subscription, but makes a single allocation for all of them. Each
+ * subscription is used and deallocated individually as normal, the memory
+ * is released once all of them have been deallocated.
+ *
+ * @param[out] result Array of at least count entries where the addresses of
+ * the new subscriptions will be written.
+ * @param[in] count The number of subscriptions to allocate.
+ *
+ * @return mama_status value can be one of
+ *          MAMA_STATUS_NOMEM
+ *          MAMA_STATUS_NULL_ARG
+ *          MAMA_STATUS_INVALID_ARG
+ *          MAMA_STATUS_OK
+ */
+MAMAExpDLL
+extern mama_status
+mamaSubscription_allocateBatch(
+    mamaSubscription *result,
+    size_t           count);
+
 /**
  * @brief Return whether the debug level for this subscription equals or
  * exceeds some level.
@@ -381,6 +405,51 @@ mamaSubscription_create (
     const char*               symbol,
     void*                     closure);
 
+/**
+ * @brief Create and activate a number of subscriptions to the same source.
+ *
+ * @details Every subscription is set up as by mamaSubscription_setup()
+ * before this returns. Activation then takes a single action on the
+ * transport throttle for the whole batch rather than one per subscription,
+ * and each time the action runs it activates the next
+ * mama.subscription.batch.chunksize subscriptions (default 100). Bridges
+ * which support it register the topics of each chunk in one call, and the
+ * initial requests of a chunk go out together.
+ *
+ * The onCreate callback is invoked for each subscription once it is
+ * active, and each is destroyed individually with mamaSubscription_destroy().
+ * If any subscription cannot be set up none of them are created.
+ *
+ * @param[in] subscriptions The allocated subscriptions, see
+ * mamaSubscription_allocateBatch().
+ * @param[in] count The number of subscriptions.
+ * @param[in] queue The mama queue.
+ * @param[in] callbacks The mamaMsgCallbacks structure containing the callback functions.
+ * @param[in] source The mamaSource identifying the publisher for the symbols.
+ * @param[in] symbols Array of count symbol names.
+ * @param[in] closures Array of count closures, one for each subscription, or
+ * NULL for no closures.
+ *
+ * @return mama_status return code can be one of:
+ *              MAMA_STATUS_INVALID_ARG
+ *              MAMA_STATUS_INVALID_QUEUE
+ *              MAMA_STATUS_SUBSCRIPTION_INVALID_STATE
+ *              MAMA_STATUS_NO_BRIDGE_IMPL
+ *              MAMA_STATUS_NOMEM
+ *              MAMA_STATUS_NULL_ARG
+ *              MAMA_STATUS_OK
+ */
+MAMAExpDLL
+extern mama_status
+mamaSubscription_createBatch (
+    mamaSubscription*         subscriptions,
+    size_t                    count,
+    mamaQueue                 queue,
+    const mamaMsgCallbacks*   callbacks,
+    mamaSource                source,
+    const char**              symbols,
+    void**                    closures);
+
 /**
  * @brief Create a basic subscription without marketdata semantics.
  *
@@ -53,6 +53,23 @@ typedef mama_status (MAMACALLTYPE *addSymbolCbType) (
   mamaSymbolListMember  symbol, 
   void*                 closure);
 
+/**
+ * @brief The registered add symbols callback is executed once for each
+ * batch of symbols added with mamaSymbolList_addMembers().
+ *
+ * @param[in] symbols    The symbols added to the list
+ * @param[in] numSymbols The number of symbols in the batch
+ * @param[in] closure    The closure associated with the symbol list
+ *
+ * @return mama_status return code can be one of:
+ *           MAMA_STATUS_NULL_ARG
+ *           MAMA_STATUS_OK
+ */
+typedef mama_status (MAMACALLTYPE *addSymbolsCbType) (
+  mamaSymbolListMember* symbols,
+  mama_size_t           numSymbols,
+  void*                 closure);
+
 /**
  * @brief Function invoked when completing the iteration over the symbol list
  * using mamaSymbolList_iterate().
@@ -81,6 +98,20 @@ typedef mama_status (MAMACALLTYPE *removeSymbolCbType) (
   mamaSymbolListMember  symbol, 
   void*                 closure);
 
+/**
+ * @brief The registered remove symbols callback is executed once for each
+ * batch of symbols removed with mamaSymbolList_removeMembersByRef(), after
+ * they have left the list but before they are freed.
+ *
+ * @param[in] symbols    The symbols removed from the list
+ * @param[in] numSymbols The number of symbols in the batch
+ * @param[in] closure    The closure associated with the symbol list
+ */
+typedef mama_status (MAMACALLTYPE *removeSymbolsCbType) (
+  mamaSymbolListMember* symbols,
+  mama_size_t           numSymbols,
+  void*                 closure);
+
 /* *************************************************** */
 /* Public Function Prototypes. */
 /* *************************************************** */
@@ -89,6 +120,10 @@ typedef mama_status (MAMACALLTYPE *removeSymbolCbType) (
  * @brief Add a symbol member to the symbol list, this will cause the add callback to be invoked if it
  * has been installed.
  *
+ * @details Members are indexed on their symbol, source and transport, these
+ * must be set before the member is added and not changed while it remains in
+ * the list.
+ *
  * @param[in] symbolList The symbolList.
  * @param[out] member The symbol member.
  *
@@ -102,6 +137,28 @@ mamaSymbolList_addMember(
     mamaSymbolList symbolList,
     mamaSymbolListMember member);
 
+/**
+ * @brief Add a batch of symbol members to the symbol list.
+ *
+ * @details All members are added before any callback is invoked. The add
+ * symbols callback is invoked once for the batch if it has been installed,
+ * otherwise the add callback is invoked for each member.
+ *
+ * @param[in] symbolList The symbolList.
+ * @param[in] members    The symbol members to add.
+ * @param[in] numMembers The number of members.
+ *
+ * @return mama_status return code can be one of
+ *              MAMA_STATUS_NULL_ARG
+ *              MAMA_STATUS_OK
+ */
+MAMAExpDLL
+extern mama_status
+mamaSymbolList_addMembers(
+    mamaSymbolList         symbolList,
+    mamaSymbolListMember*  members,
+    mama_size_t            numMembers);
+
 /**
  * @brief Allocate and initialize memory for a new symbolList, mamaSymbolList_deallocate should
  * be called on the returned symbol list.
@@ -307,6 +364,29 @@ extern mama_status mamaSymbolList_removeMemberByRef(
   mamaSymbolList symbolList,
   mamaSymbolListMember member);
 
+/**
+ * @brief Remove a batch of symbol members from the symbol list.
+ *
+ * @details All members are removed before any callback is invoked. The remove
+ * symbols callback is invoked once for the batch if it has been installed,
+ * otherwise the remove callback is invoked for each member. The members are
+ * freed once the callbacks return.
+ *
+ * @param[in] symbolList The symbolList.
+ * @param[in] members    The symbol members to remove.
+ * @param[in] numMembers The number of members.
+ *
+ * @return mama_status return code can be one of
+ *              MAMA_STATUS_NULL_ARG
+ *              MAMA_STATUS_OK
+ */
+MAMAExpDLL
+extern mama_status
+mamaSymbolList_removeMembersByRef(
+    mamaSymbolList         symbolList,
+    mamaSymbolListMember*  members,
+    mama_size_t            numMembers);
+
 /**
  * @brief Registers the user defined add symbol callback with the symbolList.
  *
@@ -327,6 +407,26 @@ mamaSymbolList_setAddSymbolHandler(
     mamaSymbolList   symbolList, 
     addSymbolCbType  addCb);
 
+/**
+ * @brief Registers the user defined add symbols callback with the symbolList.
+ *
+ * @details The registered callback will get called once for each batch of
+ * symbols added with mamaSymbolList_addMembers().
+ *
+ * @param[in] symbolList  The symbolList.
+ * @param[in] addCb       Pointer to the user defined callback. Must conform to
+ *                        function prototype <code>addSymbolsCbType</code>.
+ *
+ * @return mama_status return code can be one of
+ *              MAMA_STATUS_NULL_ARG
+ *              MAMA_STATUS_OK
+ */
+MAMAExpDLL
+extern mama_status
+mamaSymbolList_setAddSymbolsHandler(
+    mamaSymbolList    symbolList,
+    addSymbolsCbType  addCb);
+
 /**
  * @brief Set the closure associated with the this symbolList
  *
@@ -363,6 +463,26 @@ mamaSymbolList_setRemoveSymbolHandler(
     mamaSymbolList      symbolList, 
     removeSymbolCbType  removeCb);
 
+/**
+ * @brief Registers the user defined remove symbols callback with the symbolList.
+ *
+ * @details The registered callback will get called once for each batch of
+ * symbols removed with mamaSymbolList_removeMembersByRef().
+ *
+ * @param[in] symbolList  The symbolList.
+ * @param[in] removeCb    Pointer to the user defined callback. Must conform to
+ *                        function prototype <code>removeSymbolsCbType</code>.
+ *
+ * @return mama_status return code can be one of
+ *              MAMA_STATUS_NULL_ARG
+ *              MAMA_STATUS_OK
+ */
+MAMAExpDLL
+extern mama_status
+mamaSymbolList_setRemoveSymbolsHandler(
+    mamaSymbolList       symbolList,
+    removeSymbolsCbType  removeCb);
+
 #if defined(__cplusplus)
 }
 #endif
@@ -100,6 +100,25 @@ extern mama_status
 mamaTimeZone_getOffset (const mamaTimeZone  timeZone,
                         mama_i32_t*         result);
 
+/** Get the offset from UTC (in seconds) in effect at a time given in
+ * seconds since the Epoch (UTC).  This takes no lock when the zone was
+ * loaded from zoneinfo or a POSIX TZ rule; otherwise it returns the same
+ * value as mamaTimeZone_getOffset(). */
+MAMAExpDLL
+extern mama_status
+mamaTimeZone_getOffsetAt (const mamaTimeZone  timeZone,
+                          mama_i64_t          utcSeconds,
+                          mama_i32_t*         result);
+
+/** Get the offset from UTC (in seconds) for a wall clock time in this
+ * zone, given as seconds since the Epoch as if the zone were UTC.
+ * Subtract the result to convert the time to UTC. */
+MAMAExpDLL
+extern mama_status
+mamaTimeZone_getLocalOffsetAt (const mamaTimeZone  timeZone,
+                               mama_i64_t          localSeconds,
+                               mama_i32_t*         result);
+
 /** Check (recalculate) the UTC offset in case it has changed due
  * to daylight savings adjustments. */
 MAMAExpDLL
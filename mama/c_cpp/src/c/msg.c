@@ -29,6 +29,7 @@
 #include "mama/dictionary.h"
 #include "mama/reservedfields.h"
 #include "mama/msgqualifier.h"
+#include "mama/latency.h"
 
 #include "bridge.h"
 #include "payloadbridge.h"
@@ -98,8 +99,18 @@ typedef struct mamaMsgImpl_
     mamaDqContext*          mDqStrategyContext;
     mamaMsgStatus           mStatus;
 
+    /*Reserved fields cached by mamaMsgImpl_decodeHeader*/
+    msgPayloadHeader        mHeader;
+    int                     mHeaderValid;
+
+    /*Latency stage timestamps, zero if not stamped*/
+    mama_u64_t              mStageTimes[MAMA_LATENCY_STAGE_MAX];
+
 } mamaMsgImpl;
 
+/* Cleared by every modification, see CHECK_MODIFY_MSG. */
+#define HEADER_VALID(impl) ((impl)->mHeaderValid)
+
 /*================================================================
   = Static function definition
   ===============================================================*/
@@ -188,6 +199,8 @@ mamaMsg_clear (mamaMsg msg)
 
     if (!impl)return MAMA_STATUS_NULL_ARG;
 
+    impl->mHeaderValid = 0;
+
     if (impl->mLastVectorMsg != NULL || impl->mLastVectorPayloadMsg != NULL)
     {
         mamaMsgImpl_destroyLastVectorMsg(impl);
@@ -376,6 +389,8 @@ mamaPayload_convertToString (mamaPayloadType payloadType)
             return "AVIS";
         case MAMA_PAYLOAD_TICK42BLP:
             return "TICK42BLP";
+        case MAMA_PAYLOAD_FLAT:
+            return "FLAT";
         case MAMA_PAYLOAD_FAST:
             return "FAST";
         case MAMA_PAYLOAD_HMS:
@@ -448,8 +463,9 @@ mamaMsgImpl_setPayload (mamaMsg msg, msgPayload payload, short owner)
         /* Do not destroy the list. We can reuse the memory! */
     }
 
-    impl->mPayload      = payload;
-    impl->mMessageOwner = owner; 
+    impl->mPayload        = payload;
+    impl->mMessageOwner   = owner; 
+    impl->mHeaderValid  = 0;
     impl->mPayloadBridge->msgPayloadSetParent (impl->mPayload, msg);
     
     return MAMA_STATUS_OK;
@@ -505,6 +521,8 @@ mamaMsgImpl_setMsgBuffer(mamaMsg     msg,
         return MAMA_STATUS_NULL_ARG;
     }
 
+    impl->mHeaderValid = 0;
+
     if (impl->mNestedMessages != NULL)
     {
         mamaMsg nested = NULL;
@@ -845,7 +863,12 @@ mamaMsgImpl_getStatusFromMsg (mamaMsg msg)
 {
     mamaMsgImpl* impl = (mamaMsgImpl*)msg;
     int32_t result = MAMA_MSG_STATUS_UNKNOWN;
-    if (mamaMsg_getI32 (msg,
+    if (HEADER_VALID (impl))
+    {
+        if (impl->mHeader.mPresent & MAMA_PAYLOAD_HEADER_STATUS)
+            result = impl->mHeader.mStatus;
+    }
+    else if (mamaMsg_getI32 (msg,
                     MamaFieldMsgStatus.mName,
                     MamaFieldMsgStatus.mFid,
                     &result) != MAMA_STATUS_OK)
@@ -855,6 +878,186 @@ mamaMsgImpl_getStatusFromMsg (mamaMsg msg)
     return (mamaMsgStatus) result;
 }
 
+mama_status
+mamaMsgImpl_decodeHeader (mamaMsg msg)
+{
+    mamaMsgImpl*        impl    = (mamaMsgImpl*)msg;
+    msgPayloadHeader*   header  = NULL;
+
+    if (!impl) return MAMA_STATUS_NULL_ARG;
+
+    header = &impl->mHeader;
+    impl->mHeaderValid = 0;
+    header->mPresent   = 0;
+
+    /* Read all of the reserved fields in one pass where the payload can */
+    if (impl->mPayloadBridge && impl->mPayloadBridge->msgPayloadGetHeader)
+    {
+        if (MAMA_STATUS_OK == impl->mPayloadBridge->msgPayloadGetHeader (
+                                  impl->mPayload, header))
+        {
+            impl->mHeaderValid = 1;
+            return MAMA_STATUS_OK;
+        }
+        header->mPresent = 0;
+    }
+
+    if (MAMA_STATUS_OK == mamaMsg_getI32 (msg,
+                                          MamaFieldMsgType.mName,
+                                          MamaFieldMsgType.mFid,
+                                          &header->mType))
+        header->mPresent |= MAMA_PAYLOAD_HEADER_TYPE;
+
+    if (MAMA_STATUS_OK == mamaMsg_getI32 (msg,
+                                          MamaFieldMsgStatus.mName,
+                                          MamaFieldMsgStatus.mFid,
+                                          &header->mStatus))
+        header->mPresent |= MAMA_PAYLOAD_HEADER_STATUS;
+
+    if (MAMA_STATUS_OK == mamaMsg_getI64 (msg,
+                                          MamaFieldSeqNum.mName,
+                                          MamaFieldSeqNum.mFid,
+                                          &header->mSeqNum))
+        header->mPresent |= MAMA_PAYLOAD_HEADER_SEQNUM;
+
+    if (MAMA_STATUS_OK == mamaMsg_getU64 (msg,
+                                          MamaFieldSenderId.mName,
+                                          MamaFieldSenderId.mFid,
+                                          &header->mSenderId))
+        header->mPresent |= MAMA_PAYLOAD_HEADER_SENDERID;
+
+    if (MAMA_STATUS_OK == mamaMsg_getU16 (msg,
+                                          MamaFieldMsgQual.mName,
+                                          MamaFieldMsgQual.mFid,
+                                          &header->mMsgQual))
+        header->mPresent |= MAMA_PAYLOAD_HEADER_MSGQUAL;
+
+    impl->mHeaderValid = 1;
+    return MAMA_STATUS_OK;
+}
+
+void
+mamaMsgImpl_invalidateHeader (mamaMsg msg)
+{
+    mamaMsgImpl* impl = (mamaMsgImpl*)msg;
+    if (!impl) return;
+
+    impl->mHeaderValid = 0;
+}
+
+mama_status
+mamaMsgImpl_getMsgType (mamaMsg msg, mama_i32_t* msgType)
+{
+    mamaMsgImpl* impl = (mamaMsgImpl*)msg;
+    if (!impl) return MAMA_STATUS_NULL_ARG;
+    if (!msgType) return MAMA_STATUS_INVALID_ARG;
+
+    if (HEADER_VALID (impl))
+    {
+        if (!(impl->mHeader.mPresent & MAMA_PAYLOAD_HEADER_TYPE))
+            return MAMA_STATUS_NOT_FOUND;
+
+        *msgType = impl->mHeader.mType;
+        return MAMA_STATUS_OK;
+    }
+
+    return mamaMsg_getI32 (msg,
+                           MamaFieldMsgType.mName,
+                           MamaFieldMsgType.mFid,
+                           msgType);
+}
+
+mama_status
+mamaMsgImpl_getSenderId (mamaMsg msg, mama_u64_t* senderId)
+{
+    mamaMsgImpl* impl = (mamaMsgImpl*)msg;
+    if (!impl) return MAMA_STATUS_NULL_ARG;
+    if (!senderId) return MAMA_STATUS_INVALID_ARG;
+
+    if (HEADER_VALID (impl))
+    {
+        if (!(impl->mHeader.mPresent & MAMA_PAYLOAD_HEADER_SENDERID))
+            return MAMA_STATUS_NOT_FOUND;
+
+        *senderId = impl->mHeader.mSenderId;
+        return MAMA_STATUS_OK;
+    }
+
+    return mamaMsg_getU64 (msg,
+                           MamaFieldSenderId.mName,
+                           MamaFieldSenderId.mFid,
+                           senderId);
+}
+
+mama_status
+mamaMsgImpl_setStageTime (mamaMsg          msg,
+                          mamaLatencyStage stage,
+                          mama_u64_t       nanos)
+{
+    mamaMsgImpl* impl = (mamaMsgImpl*)msg;
+    if (!impl) return MAMA_STATUS_NULL_ARG;
+    if ((int)stage < 0 || stage >= MAMA_LATENCY_STAGE_MAX)
+        return MAMA_STATUS_INVALID_ARG;
+
+    impl->mStageTimes[stage] = nanos;
+    return MAMA_STATUS_OK;
+}
+
+const mama_u64_t*
+mamaMsgImpl_getStageTimes (mamaMsg msg)
+{
+    mamaMsgImpl* impl = (mamaMsgImpl*)msg;
+    if (!impl) return NULL;
+
+    return impl->mStageTimes;
+}
+
+void
+mamaMsgImpl_clearStageTimes (mamaMsg msg)
+{
+    mamaMsgImpl* impl = (mamaMsgImpl*)msg;
+    if (!impl) return;
+
+    memset (impl->mStageTimes, 0, sizeof (impl->mStageTimes));
+}
+
+mama_status
+mamaMsg_getLatencyStageTime (const mamaMsg    msg,
+                             mamaLatencyStage stage,
+                             mama_u64_t*      nanos)
+{
+    mamaMsgImpl* impl = (mamaMsgImpl*)msg;
+    if (!impl) return MAMA_STATUS_NULL_ARG;
+    if (!nanos) return MAMA_STATUS_INVALID_ARG;
+    if ((int)stage < 0 || stage >= MAMA_LATENCY_STAGE_MAX)
+        return MAMA_STATUS_INVALID_ARG;
+
+    *nanos = impl->mStageTimes[stage];
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+mamaMsgImpl_getMsgQual (mamaMsg msg, mama_u16_t* msgQual)
+{
+    mamaMsgImpl* impl = (mamaMsgImpl*)msg;
+    if (!impl) return MAMA_STATUS_NULL_ARG;
+    if (!msgQual) return MAMA_STATUS_INVALID_ARG;
+
+    if (HEADER_VALID (impl))
+    {
+        if (!(impl->mHeader.mPresent & MAMA_PAYLOAD_HEADER_MSGQUAL))
+            return MAMA_STATUS_NOT_FOUND;
+
+        *msgQual = impl->mHeader.mMsgQual;
+        return MAMA_STATUS_OK;
+    }
+
+    return mamaMsg_getU16 (msg,
+                           MamaFieldMsgQual.mName,
+                           MamaFieldMsgQual.mFid,
+                           msgQual);
+}
+
 mama_status
 mamaMsg_getNumFields (const mamaMsg msg, mama_size_t* result)
 {
@@ -901,7 +1104,7 @@ mamaMsg_addBool(
     mamaMsgImpl*    impl     = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddBool (impl->mPayload,
                                                     name,
@@ -919,7 +1122,7 @@ mamaMsg_addChar(
     mamaMsgImpl*    impl     = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddChar (impl->mPayload,
                                                     name,
@@ -937,7 +1140,7 @@ mamaMsg_addI8(
     mamaMsgImpl*    impl     = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddI8 (impl->mPayload,
                                                   name,
@@ -955,7 +1158,7 @@ mamaMsg_addU8(
     mamaMsgImpl*    impl     = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddU8 (impl->mPayload,
                                                   name,
@@ -973,7 +1176,7 @@ mamaMsg_addI16(
     mamaMsgImpl*    impl     = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddI16 (impl->mPayload,
                                                    name,
@@ -991,7 +1194,7 @@ mamaMsg_addU16(
     mamaMsgImpl*    impl     = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddU16 (impl->mPayload,
                                                    name,
@@ -1011,7 +1214,7 @@ mamaMsg_addI32 (
     mamaMsgImpl*    impl     = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddI32 (impl->mPayload,
                                                    name,
@@ -1029,7 +1232,7 @@ mamaMsg_addU32(
     mamaMsgImpl*    impl     = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddU32 (impl->mPayload,
                                                    name,
@@ -1047,7 +1250,7 @@ mamaMsg_addI64 (
     mamaMsgImpl*    impl     = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddI64 (impl->mPayload,
                                                    name,
@@ -1065,7 +1268,7 @@ mamaMsg_addU64(
     mamaMsgImpl*    impl     = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddU64 (impl->mPayload,
                                                    name,
@@ -1083,7 +1286,7 @@ mamaMsg_addF32(
     mamaMsgImpl*    impl     = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddF32 (impl->mPayload,
                                                    name,
@@ -1101,7 +1304,7 @@ mamaMsg_addF64 (
     mamaMsgImpl*    impl     = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddF64 (impl->mPayload,
                                                    name,
@@ -1119,7 +1322,7 @@ mamaMsg_addString (
     mamaMsgImpl*    impl     = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddString (impl->mPayload,
                                                       name,
@@ -1138,7 +1341,7 @@ mamaMsg_addOpaque(
     mamaMsgImpl*    impl     = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddOpaque (impl->mPayload,
                                                       name,
@@ -1157,7 +1360,7 @@ mamaMsg_addDateTime(
     mamaMsgImpl*    impl     = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddDateTime (impl->mPayload,
                                                         name,
@@ -1175,7 +1378,7 @@ mamaMsg_addPrice(
     mamaMsgImpl*    impl     = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddPrice (impl->mPayload,
                                                      name,
@@ -1194,7 +1397,7 @@ mamaMsg_addMsg(
     mamaMsgImpl*    subMsg   = (mamaMsgImpl*)value;
     if (!impl || !subMsg || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
 
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
    return impl->mPayloadBridge->msgPayloadAddMsg (impl->mPayload,
                                                        name,
@@ -1215,7 +1418,7 @@ mamaMsg_addVectorBool (
     mamaMsgImpl*    impl     = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddVectorBool (impl->mPayload,
                                                           name,
@@ -1235,7 +1438,7 @@ mamaMsg_addVectorChar (
     mamaMsgImpl*    impl     = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddVectorChar (impl->mPayload,
                                                           name,
@@ -1255,7 +1458,7 @@ mamaMsg_addVectorI8 (
     mamaMsgImpl*    impl     = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddVectorI8 (impl->mPayload,
                                                         name,
@@ -1275,7 +1478,7 @@ mamaMsg_addVectorU8 (
     mamaMsgImpl*    impl     = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddVectorU8 (impl->mPayload,
                                                         name,
@@ -1295,7 +1498,7 @@ mamaMsg_addVectorI16 (
     mamaMsgImpl*    impl     = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddVectorI16 (impl->mPayload,
                                                          name,
@@ -1315,7 +1518,7 @@ mamaMsg_addVectorU16 (
     mamaMsgImpl*    impl     = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddVectorU16 (impl->mPayload,
                                                          name,
@@ -1335,7 +1538,7 @@ mamaMsg_addVectorI32 (
     mamaMsgImpl*    impl     = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddVectorI32 (impl->mPayload,
                                                          name,
@@ -1355,7 +1558,7 @@ mamaMsg_addVectorU32 (
     mamaMsgImpl*    impl     = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddVectorU32 (impl->mPayload,
                                                          name,
@@ -1375,7 +1578,7 @@ mamaMsg_addVectorI64 (
     mamaMsgImpl*    impl     = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddVectorI64 (impl->mPayload,
                                                          name,
@@ -1395,7 +1598,7 @@ mamaMsg_addVectorU64 (
     mamaMsgImpl*    impl     = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddVectorU64 (impl->mPayload,
                                                          name,
@@ -1415,7 +1618,7 @@ mamaMsg_addVectorF32 (
     mamaMsgImpl*    impl     = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddVectorF32 (impl->mPayload,
                                                          name,
@@ -1435,7 +1638,7 @@ mamaMsg_addVectorF64 (
     mamaMsgImpl*    impl     = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddVectorF64 (impl->mPayload,
                                                          name,
@@ -1455,7 +1658,7 @@ mamaMsg_addVectorString (
     mamaMsgImpl*    impl     = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddVectorString (impl->mPayload,
                                                             name,
@@ -1475,7 +1678,7 @@ mamaMsg_addVectorDateTime (
     mamaMsgImpl* impl = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddVectorDateTime (
                                                         impl->mPayload,
@@ -1496,7 +1699,7 @@ mamaMsg_addVectorPrice (
     mamaMsgImpl* impl = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddVectorPrice (impl->mPayload,
                                                            name,
@@ -1521,7 +1724,7 @@ mamaMsg_addVectorMsg(
         return MAMA_STATUS_NULL_ARG;
     }
 
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadAddVectorMsg (impl->mPayload,
                                                          name,
@@ -1883,7 +2086,7 @@ mamaMsg_updateBool(
     mamaMsgImpl*    impl    = (mamaMsgImpl*)msg;
 
     if (!impl) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     if (impl->mPayloadBridge)
     {
@@ -1905,7 +2108,7 @@ mamaMsg_updateChar(
     mamaMsgImpl*    impl    = (mamaMsgImpl*)msg;
 
     if (!impl) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     if (impl->mPayloadBridge)
     {
@@ -1927,7 +2130,7 @@ mamaMsg_updateI8(
     mamaMsgImpl*    impl    = (mamaMsgImpl*)msg;
 
     if (!impl) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     if (impl->mPayloadBridge)
     {
@@ -1949,7 +2152,7 @@ mamaMsg_updateU8(
     mamaMsgImpl*    impl    = (mamaMsgImpl*)msg;
 
     if (!impl) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     if (impl->mPayloadBridge)
     {
@@ -1971,7 +2174,7 @@ mamaMsg_updateI16(
     mamaMsgImpl*    impl    = (mamaMsgImpl*)msg;
 
     if (!impl) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     if (impl->mPayloadBridge)
     {
@@ -1993,7 +2196,7 @@ mamaMsg_updateU16(
     mamaMsgImpl*    impl    = (mamaMsgImpl*)msg;
 
     if (!impl) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     if (impl->mPayloadBridge)
     {
@@ -2015,7 +2218,7 @@ mamaMsg_updateI32 (
     mamaMsgImpl*    impl    = (mamaMsgImpl*)msg;
 
     if (!impl) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     if (impl->mPayloadBridge)
     {
@@ -2037,7 +2240,7 @@ mamaMsg_updateU32(
     mamaMsgImpl*    impl    = (mamaMsgImpl*)msg;
 
     if (!impl) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     if (impl->mPayloadBridge)
     {
@@ -2059,7 +2262,7 @@ mamaMsg_updateI64 (
     mamaMsgImpl*    impl    = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadUpdateI64 (impl->mPayload,
                                                       name,
@@ -2077,7 +2280,7 @@ mamaMsg_updateU64(
     mamaMsgImpl*    impl    = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadUpdateU64 (impl->mPayload,
                                                       name,
@@ -2095,7 +2298,7 @@ mamaMsg_updateF32(
     mamaMsgImpl*    impl    = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadUpdateF32 (impl->mPayload,
                                                       name,
@@ -2113,7 +2316,7 @@ mamaMsg_updateF64 (
     mamaMsgImpl*    impl    = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadUpdateF64 (impl->mPayload,
                                                       name,
@@ -2131,7 +2334,7 @@ mamaMsg_updateString (
     mamaMsgImpl*    impl    =  (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadUpdateString (impl->mPayload,
                                                          name,
@@ -2146,7 +2349,7 @@ mamaMsg_applyMsg (mamaMsg msg, mamaMsg src)
     mamaMsgImpl*    source  = (mamaMsgImpl*)src;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadApply (impl->mPayload,
                                                   source->mPayload);
@@ -2172,7 +2375,7 @@ mamaMsg_updateSubMsg (
     mamaMsgImpl*    impl    = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadUpdateSubMsg (impl->mPayload,
                                                          name,
@@ -2191,7 +2394,7 @@ mamaMsg_updateOpaque (
     mamaMsgImpl*    impl    = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadUpdateOpaque (impl->mPayload,
                                                          name,
@@ -2210,7 +2413,7 @@ mamaMsg_updateDateTime(
     mamaMsgImpl*    impl    = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadUpdateDateTime (impl->mPayload,
                                                            name,
@@ -2228,7 +2431,7 @@ mamaMsg_updatePrice(
     mamaMsgImpl*    impl    = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadUpdatePrice (impl->mPayload,
                                                         name,
@@ -2247,7 +2450,7 @@ mamaMsg_updateVectorMsg (
     mamaMsgImpl*    impl        = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadUpdateVectorMsg (impl->mPayload,
                                                             name,
@@ -2267,7 +2470,7 @@ mamaMsg_updateVectorString (
     mamaMsgImpl*    impl    = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadUpdateVectorString (
                                                             impl->mPayload,
@@ -2288,7 +2491,7 @@ mamaMsg_updateVectorBool (
     mamaMsgImpl*    impl    = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadUpdateVectorBool (
                                                             impl->mPayload,
@@ -2309,7 +2512,7 @@ mamaMsg_updateVectorChar (
     mamaMsgImpl*    impl    = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadUpdateVectorChar (
                                                             impl->mPayload,
@@ -2330,7 +2533,7 @@ mamaMsg_updateVectorI8 (
     mamaMsgImpl*    impl    = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadUpdateVectorI8 (impl->mPayload,
                                                            name,
@@ -2350,7 +2553,7 @@ mamaMsg_updateVectorU8 (
     mamaMsgImpl*    impl    = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadUpdateVectorU8 (impl->mPayload,
                                                            name,
@@ -2371,7 +2574,7 @@ mamaMsg_updateVectorI16 (
     mamaMsgImpl*    impl    = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadUpdateVectorI16 (impl->mPayload,
                                                             name,
@@ -2391,7 +2594,7 @@ mamaMsg_updateVectorU16 (
     mamaMsgImpl*    impl    = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadUpdateVectorU16 (impl->mPayload,
                                                             name,
@@ -2411,7 +2614,7 @@ mamaMsg_updateVectorI32 (
     mamaMsgImpl*    impl    = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadUpdateVectorI32 (impl->mPayload,
                                                             name,
@@ -2431,7 +2634,7 @@ mamaMsg_updateVectorU32 (
     mamaMsgImpl*    impl    = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadUpdateVectorU32 (impl->mPayload,
                                                             name,
@@ -2451,7 +2654,7 @@ mamaMsg_updateVectorI64 (
     mamaMsgImpl*    impl    = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadUpdateVectorI64 (impl->mPayload,
                                                             name,
@@ -2471,7 +2674,7 @@ mamaMsg_updateVectorU64 (
     mamaMsgImpl*    impl    = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadUpdateVectorU64 (impl->mPayload,
                                                             name,
@@ -2491,7 +2694,7 @@ mamaMsg_updateVectorF32 (
     mamaMsgImpl*    impl    = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadUpdateVectorF32 (impl->mPayload,
                                                             name,
@@ -2511,7 +2714,7 @@ mamaMsg_updateVectorF64 (
     mamaMsgImpl*    impl    = (mamaMsgImpl*)msg;
 
     if (!impl || !impl->mPayloadBridge) return MAMA_STATUS_NULL_ARG;
-    CHECK_MODIFY (impl->mMessageOwner);
+    CHECK_MODIFY_MSG (impl, impl->mMessageOwner);
 
     return impl->mPayloadBridge->msgPayloadUpdateVectorF64 (impl->mPayload,
                                                             name,
@@ -3200,6 +3403,7 @@ mamaMsg_setNewBuffer (mamaMsg msg, void* buffer,
 
     if (!impl) return MAMA_STATUS_NULL_ARG;
 
+    impl->mHeaderValid = 0;
     impl->mPayloadBridge = mamaInternal_findPayload( (char) ((const char*)buffer) [0]);
 
     if (impl->mPayloadBridge)
@@ -3295,11 +3499,24 @@ mamaMsg_destroyReplyHandle (mamaMsgReply handle)
 mama_status
 mamaMsg_getSeqNum (const mamaMsg msg, mama_seqnum_t* rval)
 {
-    mama_i64_t  seqNum = 0;
-    mama_status status = mamaMsg_getI64 (msg,
-                                         MamaFieldSeqNum.mName,
-                                         MamaFieldSeqNum.mFid,
-                                         &seqNum);
+    mamaMsgImpl* impl   = (mamaMsgImpl*)msg;
+    mama_i64_t   seqNum = 0;
+    mama_status  status = MAMA_STATUS_OK;
+
+    if (impl && HEADER_VALID (impl))
+    {
+        if (impl->mHeader.mPresent & MAMA_PAYLOAD_HEADER_SEQNUM)
+            seqNum = impl->mHeader.mSeqNum;
+        else
+            status = MAMA_STATUS_NOT_FOUND;
+    }
+    else
+    {
+        status = mamaMsg_getI64 (msg,
+                                 MamaFieldSeqNum.mName,
+                                 MamaFieldSeqNum.mFid,
+                                 &seqNum);
+    }
     *rval = seqNum;
     return status;
 }
@@ -3311,10 +3528,7 @@ mamaMsg_getIsDefinitelyDuplicate (mamaMsg msg, int* result)
     mama_status status = MAMA_STATUS_OK;
     *result = 0; /* If we can't find the field the result is false */
 
-    if (MAMA_STATUS_OK!=(status=mamaMsg_getU16 (msg,
-                        MamaFieldMsgQual.mName,
-                        MamaFieldMsgQual.mFid,
-                        &msgQual)))
+    if (MAMA_STATUS_OK!=(status=mamaMsgImpl_getMsgQual (msg, &msgQual)))
     {
         mama_log (MAMA_LOG_LEVEL_ERROR,
                   "mamaMsg_getIsDefinitelyDuplicate() Failed. [%d]",
@@ -3332,10 +3546,7 @@ mamaMsg_getIsPossiblyDuplicate (mamaMsg msg, int* result)
     mama_status status = MAMA_STATUS_OK;
     *result = 0; /* If we can't find the field the result is false */
 
-    if (MAMA_STATUS_OK!=(status=mamaMsg_getU16 (msg,
-                        MamaFieldMsgQual.mName,
-                        MamaFieldMsgQual.mFid,
-                        &msgQual)))
+    if (MAMA_STATUS_OK!=(status=mamaMsgImpl_getMsgQual (msg, &msgQual)))
     {
         mama_log (MAMA_LOG_LEVEL_FINEST,
                   "mamaMsg_getIsPossiblyDuplicate() Failed. [%d]",
@@ -3353,10 +3564,7 @@ mamaMsg_getIsPossiblyDelayed (mamaMsg msg, int* result)
     mama_status status = MAMA_STATUS_OK;
     *result = 0; /* If we can't find the field the result is false */
 
-    if (MAMA_STATUS_OK!=(status=mamaMsg_getU16 (msg,
-                        MamaFieldMsgQual.mName,
-                        MamaFieldMsgQual.mFid,
-                        &msgQual)))
+    if (MAMA_STATUS_OK!=(status=mamaMsgImpl_getMsgQual (msg, &msgQual)))
     {
         mama_log (MAMA_LOG_LEVEL_ERROR,
                   "mamaMsg_getIsPossiblyDelayed() Failed. [%d]",
@@ -3374,10 +3582,7 @@ mamaMsg_getIsDefinitelyDelayed (mamaMsg msg, int* result)
     mama_status status = MAMA_STATUS_OK;
     *result = 0; /* If we can't find the field the result is false */
 
-    if (MAMA_STATUS_OK!=(status=mamaMsg_getU16 (msg,
-                        MamaFieldMsgQual.mName,
-                        MamaFieldMsgQual.mFid,
-                        &msgQual)))
+    if (MAMA_STATUS_OK!=(status=mamaMsgImpl_getMsgQual (msg, &msgQual)))
     {
         mama_log (MAMA_LOG_LEVEL_ERROR,
                   "mamaMsg_getIsDefinitelyDelayed() Failed. [%d]",
@@ -3395,10 +3600,7 @@ mamaMsg_getIsOutOfSequence (mamaMsg msg, int* result)
     mama_status status = MAMA_STATUS_OK;
     *result = 0; /* If we can't find the field the result is false */
 
-    if (MAMA_STATUS_OK!=(status=mamaMsg_getU16 (msg,
-                        MamaFieldMsgQual.mName,
-                        MamaFieldMsgQual.mFid,
-                        &msgQual)))
+    if (MAMA_STATUS_OK!=(status=mamaMsgImpl_getMsgQual (msg, &msgQual)))
     {
         mama_log (MAMA_LOG_LEVEL_ERROR,
                   "mamaMsg_getIsOutOfSequence() Failed. [%d]",
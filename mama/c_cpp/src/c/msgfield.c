@@ -848,7 +848,7 @@ mamaMsgField_updateBool (
     if (!impl) return MAMA_STATUS_NULL_ARG;
 
     mamaMsgImpl_getMessageOwner (impl->myMsg, &owner);
-    CHECK_MODIFY (owner);
+    CHECK_MODIFY_MSG (impl->myMsg, owner);
 
     mamaMsgImpl_getPayload (impl->myMsg, &payload);
 
@@ -875,7 +875,7 @@ mamaMsgField_updateChar (
     if (!impl) return MAMA_STATUS_NULL_ARG;
 
     mamaMsgImpl_getMessageOwner (impl->myMsg, &owner);
-    CHECK_MODIFY (owner);
+    CHECK_MODIFY_MSG (impl->myMsg, owner);
     
     mamaMsgImpl_getPayload (impl->myMsg, &payload);
 
@@ -902,7 +902,7 @@ mamaMsgField_updateI8 (
     if (!impl) return MAMA_STATUS_NULL_ARG;
 
     mamaMsgImpl_getMessageOwner (impl->myMsg, &owner);
-    CHECK_MODIFY (owner);
+    CHECK_MODIFY_MSG (impl->myMsg, owner);
     
     mamaMsgImpl_getPayload (impl->myMsg, &payload);
 
@@ -929,7 +929,7 @@ mamaMsgField_updateU8 (
     if (!impl) return MAMA_STATUS_NULL_ARG;
 
     mamaMsgImpl_getMessageOwner (impl->myMsg, &owner);
-    CHECK_MODIFY (owner);
+    CHECK_MODIFY_MSG (impl->myMsg, owner);
     
     mamaMsgImpl_getPayload (impl->myMsg, &payload);
 
@@ -956,7 +956,7 @@ mamaMsgField_updateI16 (
     if (!impl) return MAMA_STATUS_NULL_ARG;
 
     mamaMsgImpl_getMessageOwner (impl->myMsg, &owner);
-    CHECK_MODIFY (owner);
+    CHECK_MODIFY_MSG (impl->myMsg, owner);
     
     mamaMsgImpl_getPayload (impl->myMsg, &payload);
 
@@ -983,7 +983,7 @@ mamaMsgField_updateU16 (
     if (!impl) return MAMA_STATUS_NULL_ARG;
 
     mamaMsgImpl_getMessageOwner (impl->myMsg, &owner);
-    CHECK_MODIFY (owner);
+    CHECK_MODIFY_MSG (impl->myMsg, owner);
     
     mamaMsgImpl_getPayload (impl->myMsg, &payload);
 
@@ -1010,7 +1010,7 @@ mamaMsgField_updateI32 (
     if (!impl) return MAMA_STATUS_NULL_ARG;
 
     mamaMsgImpl_getMessageOwner (impl->myMsg, &owner);
-    CHECK_MODIFY (owner);
+    CHECK_MODIFY_MSG (impl->myMsg, owner);
     
     mamaMsgImpl_getPayload (impl->myMsg, &payload);
 
@@ -1036,7 +1036,7 @@ mamaMsgField_updateU32 (
     if (!impl) return MAMA_STATUS_NULL_ARG;
 
     mamaMsgImpl_getMessageOwner (impl->myMsg, &owner);
-    CHECK_MODIFY (owner);
+    CHECK_MODIFY_MSG (impl->myMsg, owner);
     
     mamaMsgImpl_getPayload (impl->myMsg, &payload);
 
@@ -1063,7 +1063,7 @@ mamaMsgField_updateI64 (
     if (!impl) return MAMA_STATUS_NULL_ARG;
 
     mamaMsgImpl_getMessageOwner (impl->myMsg, &owner);
-    CHECK_MODIFY (owner);
+    CHECK_MODIFY_MSG (impl->myMsg, owner);
     
     mamaMsgImpl_getPayload (impl->myMsg, &payload);
 
@@ -1090,7 +1090,7 @@ mamaMsgField_updateU64 (
     if (!impl) return MAMA_STATUS_NULL_ARG;
 
     mamaMsgImpl_getMessageOwner (impl->myMsg, &owner);
-    CHECK_MODIFY (owner);
+    CHECK_MODIFY_MSG (impl->myMsg, owner);
     
     mamaMsgImpl_getPayload (impl->myMsg, &payload);
 
@@ -1117,7 +1117,7 @@ mamaMsgField_updateF32 (
     if (!impl) return MAMA_STATUS_NULL_ARG;
 
     mamaMsgImpl_getMessageOwner (impl->myMsg, &owner);
-    CHECK_MODIFY (owner);
+    CHECK_MODIFY_MSG (impl->myMsg, owner);
     
     mamaMsgImpl_getPayload (impl->myMsg, &payload);
 
@@ -1144,7 +1144,7 @@ mamaMsgField_updateF64 (
     if (!impl) return MAMA_STATUS_NULL_ARG;
 
     mamaMsgImpl_getMessageOwner (impl->myMsg, &owner);
-    CHECK_MODIFY (owner);
+    CHECK_MODIFY_MSG (impl->myMsg, owner);
     
     mamaMsgImpl_getPayload (impl->myMsg, &payload);
 
@@ -1171,7 +1171,7 @@ mamaMsgField_updateDateTime (
     if (!impl) return MAMA_STATUS_NULL_ARG;
 
     mamaMsgImpl_getMessageOwner (impl->myMsg, &owner);
-    CHECK_MODIFY (owner);
+    CHECK_MODIFY_MSG (impl->myMsg, owner);
     
     mamaMsgImpl_getPayload (impl->myMsg, &payload);
 
@@ -1197,7 +1197,7 @@ mamaMsgField_updatePrice (
     if (!impl) return MAMA_STATUS_NULL_ARG;
 
     mamaMsgImpl_getMessageOwner (impl->myMsg, &owner);
-    CHECK_MODIFY (owner);
+    CHECK_MODIFY_MSG (impl->myMsg, owner);
     
     mamaMsgImpl_getPayload (impl->myMsg, &payload);
 
@@ -26,6 +26,7 @@
 #include "bridge.h"
 #include "payloadbridge.h"
 #include "dqstrategy.h"
+#include "mama/latency.h"
 
 #define MAX_SUBJECT 256
 
@@ -36,6 +37,16 @@ do
 }                                                                                         \
 while(0);   
 
+/* As CHECK_MODIFY, also discarding the decoded header of msg since the
+ * change may touch one of the reserved fields. */
+#define CHECK_MODIFY_MSG(msg,owner)                                                       \
+do                                                                                        \
+{                                                                                         \
+    CHECK_MODIFY (owner)                                                                  \
+    mamaMsgImpl_invalidateHeader ((mamaMsg)(msg));                                        \
+}                                                                                         \
+while(0);
+
 #if defined(__cplusplus)
 extern "C" {
 #endif
@@ -154,6 +165,77 @@ MAMAExpDLL
 mamaMsgStatus
 mamaMsgImpl_getStatusFromMsg (mamaMsg msg);
 
+/**
+ * Look up the reserved header fields (message type, status, sequence
+ * number, sender id and qualifier) once so that later accessors on the
+ * delivery path do not search the payload again. Payloads providing
+ * msgPayloadGetHeader are read in a single pass, others field by field.
+ * The values are discarded when the message is modified or given a new
+ * payload or buffer.
+ */
+MAMAExpDLL
+mama_status
+mamaMsgImpl_decodeHeader (mamaMsg msg);
+
+/**
+ * Discard the reserved header fields read by mamaMsgImpl_decodeHeader so
+ * that the accessors read the payload again.
+ */
+MAMAExpDLL
+void
+mamaMsgImpl_invalidateHeader (mamaMsg msg);
+
+/**
+ * Get the message type, returning MAMA_STATUS_NOT_FOUND if the message has
+ * none.
+ */
+MAMAExpDLL
+mama_status
+mamaMsgImpl_getMsgType (mamaMsg msg, mama_i32_t* msgType);
+
+/**
+ * Get the sender id, returning MAMA_STATUS_NOT_FOUND if the message has
+ * none.
+ */
+MAMAExpDLL
+mama_status
+mamaMsgImpl_getSenderId (mamaMsg msg, mama_u64_t* senderId);
+
+/**
+ * Get the message qualifier, returning MAMA_STATUS_NOT_FOUND if the message
+ * has none.
+ */
+MAMAExpDLL
+mama_status
+mamaMsgImpl_getMsgQual (mamaMsg msg, mama_u16_t* msgQual);
+
+/**
+ * Stamp the time, from mamaLatency_getTimestamp, at which the message
+ * passed a stage of the delivery pipeline. Bridges which can should stamp
+ * MAMA_LATENCY_STAGE_RECEIVE and MAMA_LATENCY_STAGE_ENQUEUE before calling
+ * mamaSubscription_processMsg when mamaLatency_isEnabled.
+ */
+MAMAExpDLL
+mama_status
+mamaMsgImpl_setStageTime (mamaMsg          msg,
+                          mamaLatencyStage stage,
+                          mama_u64_t       nanos);
+
+/**
+ * Get the MAMA_LATENCY_STAGE_MAX stage timestamps of the message.
+ */
+MAMAExpDLL
+const mama_u64_t*
+mamaMsgImpl_getStageTimes (mamaMsg msg);
+
+/**
+ * Clear the stage timestamps once they have been recorded, as bridges
+ * reuse messages.
+ */
+MAMAExpDLL
+void
+mamaMsgImpl_clearStageTimes (mamaMsg msg);
+
 
 #if defined(__cplusplus)
 }
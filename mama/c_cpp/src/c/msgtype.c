@@ -23,6 +23,7 @@
 #include <mama/msg.h>
 #include <mama/msgtype.h>
 #include <mama/reservedfields.h>
+#include "msgimpl.h"
 
 
 mamaMsgType 
@@ -30,10 +31,7 @@ mamaMsgType_typeForMsg (const mamaMsg msg)
 {
     int32_t result = MAMA_MSG_TYPE_UNKNOWN;
 
-    if (mamaMsg_getI32 (msg,
-                    MamaFieldMsgType.mName,
-                    MamaFieldMsgType.mFid,
-                    &result) != MAMA_STATUS_OK)
+    if (mamaMsgImpl_getMsgType (msg, &result) != MAMA_STATUS_OK)
         result = MAMA_MSG_TYPE_UNKNOWN;
 
     return (mamaMsgType) result;
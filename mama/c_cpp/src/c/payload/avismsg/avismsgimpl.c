@@ -30,6 +30,65 @@
 
 #include <mama/mama.h>
 #include "avismsgimpl.h"
+#include "datetimeimpl.h"
+
+/*
+ * Attribute names for fids, interned for the life of the process. The table
+ * is filled in once, on first use, after which lookups are a table read with
+ * no locking and no formatting.
+ */
+#define AVIS_FID_KEY_LEN        6 /* "65535" */
+
+static char                     gAvisFidKeys[65536][AVIS_FID_KEY_LEN];
+static wthread_once_t           gAvisFidKeysOnce = WTHREAD_ONCE_INIT;
+
+static void
+avisMsgImpl_loadFidKeys (void)
+{
+    unsigned int fid = 0;
+
+    for (fid = 0; fid < 65536; fid++)
+    {
+        char         digits[AVIS_FID_KEY_LEN];
+        char*        key   = gAvisFidKeys[fid];
+        unsigned int value = fid;
+        int          len   = 0;
+
+        /* Formatted by hand as snprintf over the whole table is slow */
+        do
+        {
+            digits[len++] = (char)('0' + value % 10);
+            value /= 10;
+        } while (value);
+
+        while (len)
+            *key++ = digits[--len];
+        *key = '\0';
+    }
+}
+
+const char*
+avisMsg_fidKey (mama_fid_t fid)
+{
+    wthread_once (&gAvisFidKeysOnce, avisMsgImpl_loadFidKeys);
+
+    return gAvisFidKeys[fid];
+}
+
+mama_fid_t
+avisMsg_keyFid (const char* key)
+{
+    unsigned int fid = 0;
+
+    /* As atoi() did: the leading digits, or 0 for a named field */
+    while (*key >= '0' && *key <= '9')
+    {
+        fid = fid * 10 + (*key++ - '0');
+        if (fid > 65535)
+            return 0;
+    }
+    return (mama_fid_t) fid;
+}
 
 short
 avis2MamaType( ValueType valueType )
@@ -52,12 +111,10 @@ avisMsg_setBool(
         mama_fid_t      fid,
         mama_bool_t     value)
 {
-	char tempName[64];
 	char* id = (char*)name;
 	if (fid!=0)
 	{
-		snprintf (tempName, 63, "%d", fid);
-		id=tempName;
+		id = (char*) avisMsg_fidKey (fid);
 	}
     attributes_set_int32(attributes, id, value);
 
@@ -71,13 +128,11 @@ avisMsg_setChar(
         mama_fid_t      fid,
         char            value)
 {
-	char tempName[64];
 	char tempstr[2];
 	char* id = (char*) name;
 	if (fid!=0)
 	{
-		snprintf (tempName, 63, "%d", fid);
-		id=tempName;
+		id = (char*) avisMsg_fidKey (fid);
 	}
 	snprintf (tempstr, 2, "%c", value);
     attributes_set_string(attributes, id, tempstr);
@@ -91,12 +146,10 @@ avisMsg_setI8(
         mama_fid_t      fid,
         int8_t          value)
 {
-	char tempName[64];
 	char* id = (char*) name;
 		if (fid!=0)
 		{
-		snprintf (tempName, 63, "%d", fid);
-		id=tempName;
+		id = (char*) avisMsg_fidKey (fid);
 		}
     attributes_set_int32(attributes, id, value);
     return MAMA_STATUS_OK;
@@ -109,12 +162,10 @@ avisMsg_setU8(
         mama_fid_t      fid,
         uint8_t         value)
 {
-	char tempName[64];
 	char* id = (char*) name;
 	if(fid != 0)
 	{
-		snprintf (tempName, 63, "%d", fid);
-		id=tempName;
+		id = (char*) avisMsg_fidKey (fid);
 	}
     attributes_set_int32(attributes, id, value);
     return MAMA_STATUS_OK;
@@ -127,12 +178,10 @@ avisMsg_setI16(
         mama_fid_t      fid,
         int16_t         value)
 {
-	char tempName[64];
 	char* id = (char*) name;
 	if(fid != 0)
 	{
-		snprintf (tempName, 63, "%d", fid);
-		id=tempName;
+		id = (char*) avisMsg_fidKey (fid);
 	}
     attributes_set_int32(attributes, id, value);
     return MAMA_STATUS_OK;
@@ -145,12 +194,10 @@ avisMsg_setU16(
         mama_fid_t      fid,
         uint16_t        value)
 {
-	char tempName[64];
 	char* id = (char*) name;
 	if(fid != 0)
 	{
-		snprintf (tempName, 63, "%d", fid);
-		id=tempName;
+		id = (char*) avisMsg_fidKey (fid);
 	}
     attributes_set_int32(attributes, id, value);
     return MAMA_STATUS_OK;
@@ -163,12 +210,10 @@ avisMsg_setI32(
     mama_fid_t          fid,
     int32_t             value)
 {
-	char tempName[64];
 	char* id = (char*) name;
 	if(fid != 0)
 	{
-		snprintf (tempName, 63, "%d", fid);
-		id=tempName;
+		id = (char*) avisMsg_fidKey (fid);
 	}
     attributes_set_int32(attributes, id, value);
     return MAMA_STATUS_OK;
@@ -181,12 +226,10 @@ avisMsg_setU32(
         mama_fid_t      fid,
         uint32_t        value)
 {
-	char tempName[64];
 	char* id = (char*) name;
 	if(fid != 0)
 	{
-		snprintf (tempName, 63, "%d", fid);
-		id=tempName;
+		id = (char*) avisMsg_fidKey (fid);
 	}
     attributes_set_int64(attributes, id, (uint64_t)value);
     return MAMA_STATUS_OK;
@@ -199,12 +242,10 @@ avisMsg_setI64(
     mama_fid_t          fid,
     int64_t             value)
 {
-	char tempName[64];
 	char* id = (char*) name;
 	if(fid != 0)
 	{
-		snprintf (tempName, 63, "%d", fid);
-		id=tempName;
+		id = (char*) avisMsg_fidKey (fid);
 	}
 	attributes_set_int64(attributes, id, value);
     return MAMA_STATUS_OK;
@@ -217,12 +258,10 @@ avisMsg_setU64(
         mama_fid_t      fid,
         uint64_t        value)
 {
-	char tempName[64];
 	char* id = (char*) name;
 	if(fid != 0)
 	{
-		snprintf (tempName, 63, "%d", fid);
-		id=tempName;
+		id = (char*) avisMsg_fidKey (fid);
 	}
 	attributes_set_int64(attributes, id, (int64_t)value);
     return MAMA_STATUS_OK;
@@ -235,12 +274,10 @@ avisMsg_setF32(
    mama_fid_t      fid,
    mama_f32_t      value)
 {
-	char tempName[64];
 	char* id = (char*) name;
 	if(fid != 0)
 	{
-		snprintf (tempName, 63, "%d", fid);
-		id=tempName;
+		id = (char*) avisMsg_fidKey (fid);
 	}
     attributes_set_real64(attributes, id, (real64_t)value);
     return MAMA_STATUS_OK;
@@ -253,12 +290,10 @@ avisMsg_setF64(
     mama_fid_t   fid,
     mama_f64_t   value)
 {
-	char tempName[64];
 	char* id = (char*) name;
 	if(fid != 0)
 	{
-		snprintf (tempName, 63, "%d", fid);
-		id=tempName;
+		id = (char*) avisMsg_fidKey (fid);
 	}
     attributes_set_real64(attributes, id, value);
     return MAMA_STATUS_OK;
@@ -271,12 +306,10 @@ avisMsg_setString(
     mama_fid_t   fid,
     const char*  value)
 {
-	char tempName[64];
 	char* id = (char*) name;
 	if(fid != 0)
 	{
-		snprintf (tempName, 63, "%d", fid);
-		id=tempName;
+		id = (char*) avisMsg_fidKey (fid);
 	}
     attributes_set_string(attributes, id, value);
     return MAMA_STATUS_OK;
@@ -291,12 +324,10 @@ avisMsg_setOpaque(
         size_t       size)
 {
     Array* pArray = array_create(int8_t, size);
-	char tempName[64];
 	char* id = (char*) name;
 	if(fid != 0)
 	{
-		snprintf (tempName, 63, "%d", fid);
-		id=tempName;
+		id = (char*) avisMsg_fidKey (fid);
 	}
 
     memcpy (pArray->items, value, size);
@@ -488,12 +519,10 @@ avisMsg_getBool(
         mama_fid_t    fid,
         mama_bool_t*  result)
 {
-	char tempName[64];
 	Value* pValue = NULL;
 	if(fid != 0)
 	{
-		snprintf (tempName, 63, "%d", fid);
-		pValue = attributes_get(attributes, tempName);
+		pValue = attributes_get(attributes, avisMsg_fidKey (fid));
 	}
 
     if ((!pValue) && (name))
@@ -520,12 +549,10 @@ avisMsg_getChar(
         mama_fid_t    fid,
         char*         result)
 {
-	char tempName[64];
 	Value* pValue = NULL;
 	if(fid != 0)
 	{
-		snprintf (tempName, 63, "%d", fid);
-		pValue = attributes_get(attributes, tempName);
+		pValue = attributes_get(attributes, avisMsg_fidKey (fid));
 	}
     if ((!pValue) && (name))
 		pValue = attributes_get(attributes, name);
@@ -552,12 +579,10 @@ avisMsg_getI8(
         mama_fid_t    fid,
         int8_t*       result)
 {
-	char tempName[64];
 	Value* pValue = NULL;
 	if(fid != 0)
 	{
-		snprintf (tempName, 63, "%d", fid);
-		pValue = attributes_get(attributes, tempName);
+		pValue = attributes_get(attributes, avisMsg_fidKey (fid));
 	}
     if ((!pValue) && (name))
 		pValue = attributes_get(attributes, name);
@@ -584,12 +609,10 @@ avisMsg_getU8(
         mama_fid_t    fid,
         uint8_t*      result)
 {
-	char tempName[64];
 	Value* pValue = NULL;
 	if(fid != 0)
 	{
-		snprintf (tempName, 63, "%d", fid);
-		pValue = attributes_get(attributes, tempName);
+		pValue = attributes_get(attributes, avisMsg_fidKey (fid));
 	}
     if ((!pValue) && (name))
 		pValue = attributes_get(attributes, name);
@@ -616,12 +639,10 @@ avisMsg_getI16(
         mama_fid_t      fid,
         int16_t*        result)
 {
-	char tempName[64];
 	Value* pValue = NULL;
 	if(fid != 0)
 	{
-		snprintf (tempName, 63, "%d", fid);
-		pValue = attributes_get(attributes, tempName);
+		pValue = attributes_get(attributes, avisMsg_fidKey (fid));
 	}
     if ((!pValue) && (name))
 		pValue = attributes_get(attributes, name);
@@ -648,12 +669,10 @@ avisMsg_getU16(
         mama_fid_t      fid,
         uint16_t*       result)
 {
-	char tempName[64];
 	Value* pValue = NULL;
 	if(fid != 0)
 	{
-		snprintf (tempName, 63, "%d", fid);
-		pValue = attributes_get(attributes, tempName);
+		pValue = attributes_get(attributes, avisMsg_fidKey (fid));
 	}
     if ((!pValue) && (name))
 		pValue = attributes_get(attributes, name);
@@ -680,12 +699,10 @@ avisMsg_getI32(
     mama_fid_t   fid,
     int32_t*     result)
 {
-	char tempName[64];
 	Value* pValue = NULL;
 	if(fid != 0)
 	{
-		snprintf (tempName, 63, "%d", fid);
-		pValue = attributes_get(attributes, tempName);
+		pValue = attributes_get(attributes, avisMsg_fidKey (fid));
 	}
     if ((!pValue) && (name))
 		pValue = attributes_get(attributes, name);
@@ -712,12 +729,10 @@ avisMsg_getU32(
         mama_fid_t     fid,
         uint32_t*      result)
 {
-	char tempName[64];
 	Value* pValue = NULL;
 	if(fid != 0)
 	{
-		snprintf (tempName, 63, "%d", fid);
-		pValue = attributes_get(attributes, tempName);
+		pValue = attributes_get(attributes, avisMsg_fidKey (fid));
 	}
     if ((!pValue) && (name))
 		pValue = attributes_get(attributes, name);
@@ -748,12 +763,10 @@ avisMsg_getI64(
     mama_fid_t   fid,
     int64_t*     result)
 {
-	char tempName[64];
 	Value* pValue = NULL;
 	if(fid != 0)
 	{
-		snprintf (tempName, 63, "%d", fid);
-		pValue = attributes_get(attributes, tempName);
+		pValue = attributes_get(attributes, avisMsg_fidKey (fid));
 	}
     if ((!pValue) && (name))
 		pValue = attributes_get(attributes, name);
@@ -784,12 +797,10 @@ avisMsg_getU64(
         mama_fid_t     fid,
         uint64_t*      result)
 {
-	char tempName[64];
 	Value* pValue = NULL;
 	if(fid != 0)
 	{
-		snprintf (tempName, 63, "%d", fid);
-		pValue = attributes_get(attributes, tempName);
+		pValue = attributes_get(attributes, avisMsg_fidKey (fid));
 	}
     if ((!pValue) && (name))
 		pValue = attributes_get(attributes, name);
@@ -820,12 +831,10 @@ avisMsg_getF32(
         mama_fid_t     fid,
         mama_f32_t*    result)
 {
-	char tempName[64];
 	Value* pValue = NULL;
 	if(fid != 0)
 	{
-		snprintf (tempName, 63, "%d", fid);
-		pValue = attributes_get(attributes, tempName);
+		pValue = attributes_get(attributes, avisMsg_fidKey (fid));
 	}
     if ((!pValue) && (name))
 		pValue = attributes_get(attributes, name);
@@ -852,12 +861,10 @@ avisMsg_getF64(
     mama_fid_t   fid,
     mama_f64_t*  result)
 {
-	char tempName[64];
 	Value* pValue = NULL;
 	if(fid != 0)
 	{
-		snprintf (tempName, 63, "%d", fid);
-		pValue = attributes_get(attributes, tempName);
+		pValue = attributes_get(attributes, avisMsg_fidKey (fid));
 	}
     if ((!pValue) && (name))
 		pValue = attributes_get(attributes, name);
@@ -884,12 +891,10 @@ avisMsg_getString(
     mama_fid_t   fid,
     const char** result)
 {
-	char tempName[64];
 	Value* pValue = NULL;
 	if(fid != 0)
 	{
-		snprintf (tempName, 63, "%d", fid);
-		pValue = attributes_get(attributes, tempName);
+		pValue = attributes_get(attributes, avisMsg_fidKey (fid));
 	}
     if ((!pValue) && (name))
 		pValue = attributes_get(attributes, name);
@@ -917,12 +922,10 @@ avisMsg_getOpaque(
         const void**   result,
         size_t*        size)
 {
-	char tempName[64];
 	Value* pValue = NULL;
 	if(fid != 0)
 	{
-		snprintf (tempName, 63, "%d", fid);
-		pValue = attributes_get(attributes, tempName);
+		pValue = attributes_get(attributes, avisMsg_fidKey (fid));
 	}
     if ((!pValue) && (name))
 		pValue = attributes_get(attributes, name);
@@ -952,14 +955,12 @@ avisMsg_getDateTime(
         mama_fid_t     fid,
         mamaDateTime   result)
 {
-    char tempName[64];
     Value* pValue = NULL;
     if (NULL == result)
         return MAMA_STATUS_NULL_ARG;
     if(fid != 0)
     {
-        snprintf (tempName, 63, "%d", fid);
-        pValue = attributes_get(attributes, tempName);
+        pValue = attributes_get(attributes, avisMsg_fidKey (fid));
     }
     if ((!pValue) && (name))
         pValue = attributes_get(attributes, name);
@@ -975,7 +976,11 @@ mama_status avisValue_getDateTime(const Value* pValue, mamaDateTime result)
     {
         case TYPE_STRING: mamaDateTime_setFromString (result, pValue->value.str); break;
         case TYPE_REAL64: mamaDateTime_setEpochTimeF64 (result, pValue->value.real64); break;
-        case TYPE_INT64:  *result = pValue->value.int64; break;
+        case TYPE_INT64:
+            /* The packed word only carries microseconds */
+            mamaDateTimeImpl_copy (*result,
+                mamaDateTimeImpl_getWireValue ((mama_u64_t) pValue->value.int64));
+            break;
         default: return MAMA_STATUS_WRONG_FIELD_TYPE; break;
     }
     return MAMA_STATUS_OK;
@@ -988,7 +993,8 @@ avisMsg_setDateTime(
         mama_fid_t          fid,
         const mamaDateTime  value)
 {
-    return avisMsg_setU64(attributes, name, fid, *value);
+    return avisMsg_setU64(attributes, name, fid,
+                          mamaDateTimeImpl_getWireValue (*value));
 }
 
 mama_status
@@ -1043,12 +1049,10 @@ avisMsg_getPrice(
         mama_fid_t     fid,
         mamaPrice      result)
 {
-	char tempName[64];
 	Value* pValue = NULL;
 	if(fid != 0)
 	{
-		snprintf (tempName, 63, "%d", fid);
-		pValue = attributes_get(attributes, tempName);
+		pValue = attributes_get(attributes, avisMsg_fidKey (fid));
 	}
     if ((!pValue) && (name))
 		pValue = attributes_get(attributes, name);
@@ -1246,12 +1250,10 @@ avisMsg_getFieldAsString(
     char*        buf,
     size_t       len)
 {
-	char tempName[64];
 	Value* pValue = NULL;
 	if(fid != 0)
 	{
-		snprintf (tempName, 63, "%d", fid);
-		pValue = attributes_get(attributes, tempName);
+		pValue = attributes_get(attributes, avisMsg_fidKey (fid));
 	}
     if ((!pValue) && (name))
 		pValue = attributes_get(attributes, name);
@@ -48,6 +48,8 @@ typedef struct avisFieldPayload
 {
     const char*           mName;
     const Value*          mValue;
+    /* The fid named by mName, parsed once when the field is positioned */
+    mama_fid_t            mFid;
 } avisFieldPayload;
 
 typedef struct avisIterator
@@ -62,6 +64,15 @@ typedef struct avisIterator
 short
 avis2MamaType( ValueType valueType );
 
+/* The attribute name used for a fid. The string is interned and valid for
+ * the life of the process. */
+const char*
+avisMsg_fidKey (mama_fid_t fid);
+
+/* The fid an attribute name refers to, or 0 if it is not a fid */
+mama_fid_t
+avisMsg_keyFid (const char* key);
+
 mama_status
 avisMsg_setBool(
         Attributes*     attributes,
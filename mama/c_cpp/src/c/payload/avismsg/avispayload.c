@@ -1715,7 +1715,6 @@ avismsgPayload_getField          (const msgPayload    msg,
                                 msgFieldPayload*    result)
 {
 	avisPayloadImpl* impl = (avisPayloadImpl*)msg;
-	char tempName[64];
 	char* id = (char*) name;
 	Value* pValue = NULL;
     CHECK_PAYLOAD(msg);
@@ -1728,8 +1727,7 @@ avismsgPayload_getField          (const msgPayload    msg,
 
 	if (fid!=0)
 	{
-		snprintf (tempName, 63, "%d", fid);
-		id=tempName;
+		id = (char*) avisMsg_fidKey (fid);
 	}
     pValue = attributes_get(avisPayload(msg), id);
     if ((!pValue) &&(name))
@@ -1744,6 +1742,7 @@ avismsgPayload_getField          (const msgPayload    msg,
 
     impl->mAvisField->mName=id;
     impl->mAvisField->mValue=pValue;
+    impl->mAvisField->mFid=avisMsg_keyFid(id);
 
     *result = impl->mAvisField;
     return MAMA_STATUS_OK;
@@ -2035,6 +2034,7 @@ avismsgPayloadIter_get          (msgPayloadIter  iter,
     {
         return NULL;
     }
+    avisField(field)->mFid = avisMsg_keyFid(avisField(field)->mName);
 
     /* If this is a special meta field, do not consider during iteration */
     if ((strcmp(SUBJECT_FIELD_NAME, avisField(field)->mName) == 0) ||
@@ -2169,7 +2169,7 @@ avismsgFieldPayload_getName      (const msgFieldPayload   field,
     CHECK_NULL(result);
     CHECK_FIELD(field);
 
-    fid = atoi(avisField(field)->mName);
+    fid = avisField(field)->mFid;
     if (fid!=0)
     {
     	if (!desc)
@@ -2214,7 +2214,7 @@ avismsgFieldPayload_getFid       (const msgFieldPayload   field,
     CHECK_FIELD(field);
     CHECK_NULL(result);
 
-    fid = atoi(avisField(field)->mName);
+    fid = avisField(field)->mFid;
     if (fid==0)
     {
     	if (!desc)
@@ -2257,7 +2257,7 @@ avismsgFieldPayload_getDescriptor(const msgFieldPayload   field,
     if ((avisField(field)->mName == 0) || (strlen(avisField(field)->mName) == 0))
         return MAMA_STATUS_INVALID_ARG;
 
-    fid = atoi(avisField(field)->mName);
+    fid = avisField(field)->mFid;
 
     if (fid != 0)
         return mamaDictionary_getFieldDescriptorByFid(dict, result, fid);
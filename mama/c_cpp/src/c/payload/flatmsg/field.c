@@ -0,0 +1,788 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+/*=========================================================================
+  =                             Includes                                  =
+  =========================================================================*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <mama/mama.h>
+#include <mama/price.h>
+
+#include "payloadbridge.h"
+#include "msgfieldimpl.h"
+
+#include "flatcommon.h"
+#include "flatpayloadfunctions.h"
+#include "payload.h"
+
+
+/*=========================================================================
+  =                              Macros                                   =
+  =========================================================================*/
+
+#define FIELD_HEADER(IMPL)                                                     \
+    FLATMSG_FIELD ((IMPL)->mParent, (IMPL)->mOffset)
+
+#define GET_SCALAR_FIELD(TYPE)                                                 \
+do                                                                             \
+{                                                                              \
+    flatmsgFieldPayloadImpl* impl   = (flatmsgFieldPayloadImpl*) field;        \
+    mama_status              status = MAMA_STATUS_OK;                          \
+                                                                               \
+    if (NULL == impl || NULL == result) return MAMA_STATUS_NULL_ARG;           \
+                                                                               \
+    if (NULL == impl->mParent)                                                 \
+    {                                                                          \
+        return MAMA_STATUS_INVALID_ARG;                                        \
+    }                                                                          \
+                                                                               \
+    GET_FIELD_AS_MAMA_TYPE (FIELD_HEADER (impl), TYPE, *result);               \
+                                                                               \
+    return status;                                                             \
+} while(0)
+
+
+#define UPDATE_FIELD(MAMATYPE,VALUE,SIZE)                                      \
+do                                                                             \
+{                                                                              \
+    flatmsgFieldPayloadImpl* impl = (flatmsgFieldPayloadImpl*) field;          \
+                                                                               \
+    if (NULL == impl || NULL == impl->mParent) return MAMA_STATUS_NULL_ARG;    \
+                                                                               \
+    /* A field keeps its type - only the payload level may change it */       \
+    if (MAMATYPE != FIELD_HEADER (impl)->mType)                                \
+    {                                                                          \
+        return MAMA_STATUS_WRONG_FIELD_TYPE;                                   \
+    }                                                                          \
+                                                                               \
+    return flatmsgPayloadImpl_setFieldValue (impl->mParent, impl->mOffset,     \
+                                             MAMATYPE, VALUE, SIZE, NULL);     \
+} while(0)
+
+
+#define GET_VECTOR_FIELD(MAMATYPE,CTYPE)                                       \
+do                                                                             \
+{                                                                              \
+    flatmsgFieldPayloadImpl* impl = (flatmsgFieldPayloadImpl*) field;          \
+    flatmsgFieldHeader*      hdr  = NULL;                                      \
+                                                                               \
+    if (NULL == impl || NULL == impl->mParent || NULL == result                \
+            || NULL == size)                                                   \
+    {                                                                          \
+        return MAMA_STATUS_NULL_ARG;                                           \
+    }                                                                          \
+                                                                               \
+    hdr = FIELD_HEADER (impl);                                                 \
+    if (MAMATYPE != hdr->mType)                                                \
+    {                                                                          \
+        return MAMA_STATUS_WRONG_FIELD_TYPE;                                   \
+    }                                                                          \
+                                                                               \
+    *result = (const CTYPE*) FLATMSG_FIELD_VALUE (hdr);                        \
+    *size   = hdr->mSize / sizeof (CTYPE);                                     \
+                                                                               \
+    return MAMA_STATUS_OK;                                                     \
+} while(0)
+
+
+/*=========================================================================
+  =                   Public interface functions                          =
+  =========================================================================*/
+
+mama_status
+flatmsgFieldPayload_create (msgFieldPayload* field)
+{
+    flatmsgFieldPayloadImpl* impl = NULL;
+
+    if (NULL == field)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    impl = (flatmsgFieldPayloadImpl*) calloc (1,
+                                              sizeof (flatmsgFieldPayloadImpl));
+    if (NULL == impl)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "flatmsgFieldPayload_create() failed. Out of memory");
+        return MAMA_STATUS_NOMEM;
+    }
+
+    /* A field only refers to its parent's buffer so there is nothing else */
+    impl->mParent = NULL;
+    impl->mOffset = 0;
+
+    *field = (msgFieldPayload)impl;
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgFieldPayload_destroy (msgFieldPayload field)
+{
+    if (NULL == field)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    free (field);
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgFieldPayload_getType (const msgFieldPayload   field,
+                             mamaFieldType*          result)
+{
+    flatmsgFieldPayloadImpl* impl = (flatmsgFieldPayloadImpl*) field;
+
+    if (NULL == impl || NULL == result)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    if (NULL == impl->mParent)
+    {
+        return MAMA_STATUS_INVALID_ARG;
+    }
+
+    *result = (mamaFieldType) FIELD_HEADER (impl)->mType;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgFieldPayload_getName (msgFieldPayload         field,
+                             mamaDictionary          dict,
+                             mamaFieldDescriptor     desc,
+                             const char**            result)
+{
+    flatmsgFieldPayloadImpl* impl          = (flatmsgFieldPayloadImpl*) field;
+    const char*              fieldDescName = NULL;
+    const char*              name          = NULL;
+
+    if (NULL == impl || NULL == result)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* If a name is part of field and it's not a NULL string */
+    if (NULL != impl->mParent)
+    {
+        name = FLATMSG_FIELD_NAME (FIELD_HEADER (impl));
+        if (NULL != name)
+        {
+            *result = name;
+        }
+    }
+
+    /* If there is a dictionary, but no descriptor */
+    if (NULL != dict && NULL == desc)
+    {
+        flatmsgFieldPayload_getDescriptor (field, dict, &desc);
+    }
+
+    /* If a descriptor was provided, use it to obtain the name */
+    if (NULL != desc)
+    {
+        /* get the name from descriptor. If that fails, move on */
+        fieldDescName = mamaFieldDescriptor_getName (desc);
+        if (NULL != fieldDescName)
+        {
+            *result = fieldDescName;
+        }
+    }
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgFieldPayload_getFid (const msgFieldPayload   field,
+                            mamaDictionary          dict,
+                            mamaFieldDescriptor     desc,
+                            uint16_t*               result)
+{
+    flatmsgFieldPayloadImpl* impl = (flatmsgFieldPayloadImpl*) field;
+
+    if (NULL == impl || NULL == result)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    if (NULL == impl->mParent)
+    {
+        return MAMA_STATUS_INVALID_ARG;
+    }
+
+    *result = FIELD_HEADER (impl)->mFid;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgFieldPayload_getDescriptor (const msgFieldPayload  field,
+                                   mamaDictionary         dict,
+                                   mamaFieldDescriptor*   result)
+{
+    flatmsgFieldPayloadImpl*    impl        = (flatmsgFieldPayloadImpl*) field;
+    flatmsgFieldHeader*         hdr         = NULL;
+    mamaFieldDescriptor         tmpResult   = NULL;
+    mama_status                 status      = MAMA_STATUS_OK;
+
+    if (NULL == impl || NULL == result)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    if (NULL == impl->mParent)
+    {
+        return MAMA_STATUS_INVALID_ARG;
+    }
+
+    hdr = FIELD_HEADER (impl);
+
+    if (0 != hdr->mFid)
+    {
+        status = mamaDictionary_getFieldDescriptorByFid (dict,
+                                                         &tmpResult,
+                                                         hdr->mFid);
+        if (MAMA_STATUS_OK == status)
+        {
+            *result = tmpResult;
+        }
+        return status;
+    }
+
+    if (NULL != FLATMSG_FIELD_NAME (hdr))
+    {
+        status = mamaDictionary_getFieldDescriptorByName (
+                    dict, &tmpResult, FLATMSG_FIELD_NAME (hdr));
+        if (MAMA_STATUS_OK == status)
+        {
+            *result = tmpResult;
+        }
+        return status;
+    }
+    else
+    {
+        return MAMA_STATUS_INVALID_ARG;
+    }
+}
+
+mama_status
+flatmsgFieldPayload_updateBool  (msgFieldPayload         field,
+                                 msgPayload              msg,
+                                 mama_bool_t             value)
+{
+    UPDATE_FIELD (MAMA_FIELD_TYPE_BOOL, &value, sizeof (value));
+}
+
+mama_status
+flatmsgFieldPayload_updateChar  (msgFieldPayload         field,
+                                 msgPayload              msg,
+                                 char                    value)
+{
+    UPDATE_FIELD (MAMA_FIELD_TYPE_CHAR, &value, sizeof (value));
+}
+
+mama_status
+flatmsgFieldPayload_updateI8    (msgFieldPayload         field,
+                                 msgPayload              msg,
+                                 mama_i8_t               value)
+{
+    UPDATE_FIELD (MAMA_FIELD_TYPE_I8, &value, sizeof (value));
+}
+
+mama_status
+flatmsgFieldPayload_updateU8    (msgFieldPayload         field,
+                                 msgPayload              msg,
+                                 mama_u8_t               value)
+{
+    UPDATE_FIELD (MAMA_FIELD_TYPE_U8, &value, sizeof (value));
+}
+
+mama_status
+flatmsgFieldPayload_updateI16   (msgFieldPayload         field,
+                                 msgPayload              msg,
+                                 mama_i16_t              value)
+{
+    UPDATE_FIELD (MAMA_FIELD_TYPE_I16, &value, sizeof (value));
+}
+
+mama_status
+flatmsgFieldPayload_updateU16   (msgFieldPayload         field,
+                                 msgPayload              msg,
+                                 mama_u16_t              value)
+{
+    UPDATE_FIELD (MAMA_FIELD_TYPE_U16, &value, sizeof (value));
+}
+
+mama_status
+flatmsgFieldPayload_updateI32   (msgFieldPayload         field,
+                                 msgPayload              msg,
+                                 mama_i32_t              value)
+{
+    UPDATE_FIELD (MAMA_FIELD_TYPE_I32, &value, sizeof (value));
+}
+
+mama_status
+flatmsgFieldPayload_updateU32   (msgFieldPayload         field,
+                                 msgPayload              msg,
+                                 mama_u32_t              value)
+{
+    UPDATE_FIELD (MAMA_FIELD_TYPE_U32, &value, sizeof (value));
+}
+
+mama_status
+flatmsgFieldPayload_updateI64   (msgFieldPayload         field,
+                                 msgPayload              msg,
+                                 mama_i64_t              value)
+{
+    UPDATE_FIELD (MAMA_FIELD_TYPE_I64, &value, sizeof (value));
+}
+
+mama_status
+flatmsgFieldPayload_updateU64   (msgFieldPayload         field,
+                                 msgPayload              msg,
+                                 mama_u64_t              value)
+{
+    UPDATE_FIELD (MAMA_FIELD_TYPE_U64, &value, sizeof (value));
+}
+
+mama_status
+flatmsgFieldPayload_updateF32   (msgFieldPayload         field,
+                                 msgPayload              msg,
+                                 mama_f32_t              value)
+{
+    UPDATE_FIELD (MAMA_FIELD_TYPE_F32, &value, sizeof (value));
+}
+
+mama_status
+flatmsgFieldPayload_updateF64   (msgFieldPayload         field,
+                                 msgPayload              msg,
+                                 mama_f64_t              value)
+{
+    UPDATE_FIELD (MAMA_FIELD_TYPE_F64, &value, sizeof (value));
+}
+
+mama_status
+flatmsgFieldPayload_updateString (msgFieldPayload         field,
+                                  msgPayload              msg,
+                                  const char*             value)
+{
+    if (NULL == value) return MAMA_STATUS_NULL_ARG;
+
+    UPDATE_FIELD (MAMA_FIELD_TYPE_STRING, value, strlen (value) + 1);
+}
+
+mama_status
+flatmsgFieldPayload_updateDateTime (msgFieldPayload         field,
+                                    msgPayload              msg,
+                                    const mamaDateTime      value)
+{
+    flatmsgDateTime wire;
+
+    if (NULL == value) return MAMA_STATUS_NULL_ARG;
+
+    flatmsgPayloadImpl_encodeDateTime (value, &wire);
+
+    UPDATE_FIELD (MAMA_FIELD_TYPE_TIME, &wire, sizeof (wire));
+}
+
+mama_status
+flatmsgFieldPayload_updatePrice (msgFieldPayload         field,
+                                 msgPayload              msg,
+                                 const mamaPrice         value)
+{
+    flatmsgPrice wire;
+
+    if (NULL == value) return MAMA_STATUS_NULL_ARG;
+
+    flatmsgPayloadImpl_encodePrice (value, &wire);
+
+    UPDATE_FIELD (MAMA_FIELD_TYPE_PRICE, &wire, sizeof (wire));
+}
+
+mama_status
+flatmsgFieldPayload_updateSubMsg (msgFieldPayload         field,
+                                  msgPayload              msg,
+                                  const msgPayload        subMsg)
+{
+    flatmsgPayloadImpl* subImpl = (flatmsgPayloadImpl*) subMsg;
+
+    if (NULL == subImpl) return MAMA_STATUS_NULL_ARG;
+
+    UPDATE_FIELD (MAMA_FIELD_TYPE_MSG,
+                  subImpl->mBuffer,
+                  FLATMSG_ENCODED_SIZE (subImpl));
+}
+
+mama_status
+flatmsgFieldPayload_getBool     (const msgFieldPayload   field,
+                                 mama_bool_t*            result)
+{
+    GET_SCALAR_FIELD (mama_bool_t);
+}
+
+mama_status
+flatmsgFieldPayload_getChar     (const msgFieldPayload   field,
+                                 char*                   result)
+{
+    GET_SCALAR_FIELD (char);
+}
+
+mama_status
+flatmsgFieldPayload_getI8       (const msgFieldPayload   field,
+                                 mama_i8_t*              result)
+{
+    GET_SCALAR_FIELD (mama_i8_t);
+}
+
+mama_status
+flatmsgFieldPayload_getU8       (const msgFieldPayload   field,
+                                 mama_u8_t*              result)
+{
+    GET_SCALAR_FIELD (mama_u8_t);
+}
+
+mama_status
+flatmsgFieldPayload_getI16      (const msgFieldPayload   field,
+                                 mama_i16_t*             result)
+{
+    GET_SCALAR_FIELD (mama_i16_t);
+}
+
+mama_status
+flatmsgFieldPayload_getU16      (const msgFieldPayload   field,
+                                 mama_u16_t*             result)
+{
+    GET_SCALAR_FIELD (mama_u16_t);
+}
+
+mama_status
+flatmsgFieldPayload_getI32      (const msgFieldPayload   field,
+                                 mama_i32_t*             result)
+{
+    GET_SCALAR_FIELD (mama_i32_t);
+}
+
+mama_status
+flatmsgFieldPayload_getU32      (const msgFieldPayload   field,
+                                 mama_u32_t*             result)
+{
+    GET_SCALAR_FIELD (mama_u32_t);
+}
+
+mama_status
+flatmsgFieldPayload_getI64      (const msgFieldPayload   field,
+                                 mama_i64_t*             result)
+{
+    GET_SCALAR_FIELD (mama_i64_t);
+}
+
+mama_status
+flatmsgFieldPayload_getU64      (const msgFieldPayload   field,
+                                 mama_u64_t*             result)
+{
+    GET_SCALAR_FIELD (mama_u64_t);
+}
+
+mama_status
+flatmsgFieldPayload_getF32      (const msgFieldPayload   field,
+                                 mama_f32_t*             result)
+{
+    GET_SCALAR_FIELD (mama_f32_t);
+}
+
+mama_status
+flatmsgFieldPayload_getF64      (const msgFieldPayload   field,
+                                 mama_f64_t*             result)
+{
+    GET_SCALAR_FIELD (mama_f64_t);
+}
+
+mama_status
+flatmsgFieldPayload_getString   (const msgFieldPayload   field,
+                                 const char**            result)
+{
+    flatmsgFieldPayloadImpl* impl = (flatmsgFieldPayloadImpl*) field;
+    flatmsgFieldHeader*      hdr  = NULL;
+
+    if (NULL == impl || NULL == result) return MAMA_STATUS_NULL_ARG;
+
+    if (NULL == impl->mParent) return MAMA_STATUS_INVALID_ARG;
+
+    hdr = FIELD_HEADER (impl);
+    if (MAMA_FIELD_TYPE_STRING != hdr->mType)
+    {
+        return MAMA_STATUS_WRONG_FIELD_TYPE;
+    }
+
+    *result = (const char*) FLATMSG_FIELD_VALUE (hdr);
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgFieldPayload_getOpaque   (const msgFieldPayload   field,
+                                 const void**            result,
+                                 mama_size_t*            size)
+{
+    flatmsgFieldPayloadImpl* impl = (flatmsgFieldPayloadImpl*) field;
+    flatmsgFieldHeader*      hdr  = NULL;
+
+    if (NULL == impl || NULL == result || NULL == size)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    if (NULL == impl->mParent) return MAMA_STATUS_INVALID_ARG;
+
+    hdr = FIELD_HEADER (impl);
+    if (MAMA_FIELD_TYPE_OPAQUE != hdr->mType)
+    {
+        return MAMA_STATUS_WRONG_FIELD_TYPE;
+    }
+
+    *result = FLATMSG_FIELD_VALUE (hdr);
+    *size   = hdr->mSize;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgFieldPayload_getDateTime (const msgFieldPayload   field,
+                                 mamaDateTime            result)
+{
+    flatmsgFieldPayloadImpl* impl = (flatmsgFieldPayloadImpl*) field;
+
+    if (NULL == impl || NULL == result) return MAMA_STATUS_NULL_ARG;
+
+    if (NULL == impl->mParent) return MAMA_STATUS_INVALID_ARG;
+
+    return flatmsgPayloadImpl_getDateTime (FIELD_HEADER (impl), result);
+}
+
+mama_status
+flatmsgFieldPayload_getPrice    (const msgFieldPayload   field,
+                                 mamaPrice               result)
+{
+    flatmsgFieldPayloadImpl* impl = (flatmsgFieldPayloadImpl*) field;
+
+    if (NULL == impl || NULL == result) return MAMA_STATUS_NULL_ARG;
+
+    if (NULL == impl->mParent) return MAMA_STATUS_INVALID_ARG;
+
+    return flatmsgPayloadImpl_getPrice (FIELD_HEADER (impl), result);
+}
+
+mama_status
+flatmsgFieldPayload_getMsg      (const msgFieldPayload   field,
+                                 msgPayload*             result)
+{
+    flatmsgFieldPayloadImpl* impl = (flatmsgFieldPayloadImpl*) field;
+
+    if (NULL == impl || NULL == result) return MAMA_STATUS_NULL_ARG;
+
+    if (NULL == impl->mParent) return MAMA_STATUS_INVALID_ARG;
+
+    return flatmsgPayloadImpl_getMsg (impl->mParent,
+                                      FIELD_HEADER (impl),
+                                      result);
+}
+
+mama_status
+flatmsgFieldPayload_getVectorBool (const msgFieldPayload   field,
+                                   const mama_bool_t**     result,
+                                   mama_size_t*            size)
+{
+    GET_VECTOR_FIELD (MAMA_FIELD_TYPE_VECTOR_BOOL, mama_bool_t);
+}
+
+mama_status
+flatmsgFieldPayload_getVectorChar (const msgFieldPayload   field,
+                                   const char**            result,
+                                   mama_size_t*            size)
+{
+    GET_VECTOR_FIELD (MAMA_FIELD_TYPE_VECTOR_CHAR, char);
+}
+
+mama_status
+flatmsgFieldPayload_getVectorI8   (const msgFieldPayload   field,
+                                   const mama_i8_t**       result,
+                                   mama_size_t*            size)
+{
+    GET_VECTOR_FIELD (MAMA_FIELD_TYPE_VECTOR_I8, mama_i8_t);
+}
+
+mama_status
+flatmsgFieldPayload_getVectorU8   (const msgFieldPayload   field,
+                                   const mama_u8_t**       result,
+                                   mama_size_t*            size)
+{
+    GET_VECTOR_FIELD (MAMA_FIELD_TYPE_VECTOR_U8, mama_u8_t);
+}
+
+mama_status
+flatmsgFieldPayload_getVectorI16  (const msgFieldPayload   field,
+                                   const mama_i16_t**      result,
+                                   mama_size_t*            size)
+{
+    GET_VECTOR_FIELD (MAMA_FIELD_TYPE_VECTOR_I16, mama_i16_t);
+}
+
+mama_status
+flatmsgFieldPayload_getVectorU16  (const msgFieldPayload   field,
+                                   const mama_u16_t**      result,
+                                   mama_size_t*            size)
+{
+    GET_VECTOR_FIELD (MAMA_FIELD_TYPE_VECTOR_U16, mama_u16_t);
+}
+
+mama_status
+flatmsgFieldPayload_getVectorI32  (const msgFieldPayload   field,
+                                   const mama_i32_t**      result,
+                                   mama_size_t*            size)
+{
+    GET_VECTOR_FIELD (MAMA_FIELD_TYPE_VECTOR_I32, mama_i32_t);
+}
+
+mama_status
+flatmsgFieldPayload_getVectorU32  (const msgFieldPayload   field,
+                                   const mama_u32_t**      result,
+                                   mama_size_t*            size)
+{
+    GET_VECTOR_FIELD (MAMA_FIELD_TYPE_VECTOR_U32, mama_u32_t);
+}
+
+mama_status
+flatmsgFieldPayload_getVectorI64  (const msgFieldPayload   field,
+                                   const mama_i64_t**      result,
+                                   mama_size_t*            size)
+{
+    GET_VECTOR_FIELD (MAMA_FIELD_TYPE_VECTOR_I64, mama_i64_t);
+}
+
+mama_status
+flatmsgFieldPayload_getVectorU64  (const msgFieldPayload   field,
+                                   const mama_u64_t**      result,
+                                   mama_size_t*            size)
+{
+    GET_VECTOR_FIELD (MAMA_FIELD_TYPE_VECTOR_U64, mama_u64_t);
+}
+
+mama_status
+flatmsgFieldPayload_getVectorF32  (const msgFieldPayload   field,
+                                   const mama_f32_t**      result,
+                                   mama_size_t*            size)
+{
+    GET_VECTOR_FIELD (MAMA_FIELD_TYPE_VECTOR_F32, mama_f32_t);
+}
+
+mama_status
+flatmsgFieldPayload_getVectorF64  (const msgFieldPayload   field,
+                                   const mama_f64_t**      result,
+                                   mama_size_t*            size)
+{
+    GET_VECTOR_FIELD (MAMA_FIELD_TYPE_VECTOR_F64, mama_f64_t);
+}
+
+mama_status
+flatmsgFieldPayload_getVectorString (const msgFieldPayload   field,
+                                     const char***           result,
+                                     mama_size_t*            size)
+{
+    flatmsgFieldPayloadImpl* impl = (flatmsgFieldPayloadImpl*) field;
+
+    if (NULL == impl || NULL == impl->mParent || NULL == result
+            || NULL == size)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    return flatmsgPayloadImpl_getVectorString (impl->mParent,
+                                               FIELD_HEADER (impl),
+                                               result,
+                                               size);
+}
+
+/*
+ * Postponing implementation until this type of vectors has a standard protocol
+ * or is removed from the implementation
+ */
+mama_status
+flatmsgFieldPayload_getVectorDateTime (const msgFieldPayload   field,
+                                       const mamaDateTime*     result,
+                                       mama_size_t*            size)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+flatmsgFieldPayload_getVectorPrice (const msgFieldPayload   field,
+                                    const mamaPrice*        result,
+                                    mama_size_t*            size)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+flatmsgFieldPayload_getVectorMsg   (const msgFieldPayload   field,
+                                    const msgPayload**      result,
+                                    mama_size_t*            size)
+{
+    flatmsgFieldPayloadImpl* impl = (flatmsgFieldPayloadImpl*) field;
+
+    if (NULL == impl || NULL == impl->mParent || NULL == result
+            || NULL == size)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    return flatmsgPayloadImpl_getVectorMsg (impl->mParent,
+                                            FIELD_HEADER (impl),
+                                            result,
+                                            size);
+}
+
+mama_status
+flatmsgFieldPayload_getAsString (const msgFieldPayload   field,
+                                 const msgPayload        msg,
+                                 char*                   buffer,
+                                 mama_size_t             len)
+{
+    flatmsgFieldPayloadImpl* impl = (flatmsgFieldPayloadImpl*) field;
+
+    if (NULL == impl || NULL == buffer)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    if (0 == len || NULL == impl->mParent)
+    {
+        return MAMA_STATUS_INVALID_ARG;
+    }
+
+    flatmsgPayloadImpl_fieldToString (FIELD_HEADER (impl), buffer, len);
+
+    return MAMA_STATUS_OK;
+}
@@ -0,0 +1,272 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#ifndef MAMA_PAYLOAD_FLATMSG_FLATCOMMON_H__
+#define MAMA_PAYLOAD_FLATMSG_FLATCOMMON_H__
+
+/*=========================================================================
+  =                             Includes                                  =
+  =========================================================================*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <mama/mama.h>
+
+#include "payloadbridge.h"
+#include "msgfieldimpl.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*=========================================================================
+  =                              Macros                                   =
+  =========================================================================*/
+
+#define FLATMSG_VERSION                 1
+#define FLATMSG_BYTE_ORDER_LITTLE       1
+#define FLATMSG_BYTE_ORDER_BIG          2
+#define FLATMSG_INITIAL_BUFFER_SIZE     256
+#define FLATMSG_STRING_BUFFER_SIZE      1024
+/* Field names are stored with their terminator in a single byte length */
+#define FLATMSG_MAX_NAME_LENGTH         255
+
+/* Every field header and value starts on an 8 byte boundary */
+#define FLATMSG_ALIGN(SIZE)             (((SIZE) + 7) & ~((mama_size_t) 7))
+
+/* Values are handed out as direct views so buffers must be 8 byte aligned */
+#define FLATMSG_IS_ALIGNED(PTR)         (0 == ((mama_size_t) (PTR) & 7))
+
+#define FLATMSG_HEADER(IMPL)                                                   \
+    ((flatmsgHeader*) (IMPL)->mBuffer)
+
+#define FLATMSG_DATA(IMPL)                                                     \
+    ((IMPL)->mBuffer + sizeof (flatmsgHeader))
+
+/* Header, data region and index - the length of the serialized message */
+#define FLATMSG_ENCODED_SIZE(IMPL)                                             \
+    (sizeof (flatmsgHeader) + FLATMSG_HEADER (IMPL)->mDataSize                 \
+        + FLATMSG_HEADER (IMPL)->mNumFields * sizeof (flatmsgIndexEntry))
+
+#define FLATMSG_INDEX(IMPL)                                                    \
+    ((flatmsgIndexEntry*) (FLATMSG_DATA (IMPL) + FLATMSG_HEADER (IMPL)->mDataSize))
+
+#define FLATMSG_FIELD(IMPL,OFFSET)                                             \
+    ((flatmsgFieldHeader*) (FLATMSG_DATA (IMPL) + (OFFSET)))
+
+#define FLATMSG_FIELD_NAME(HDR)                                                \
+    (0 == (HDR)->mNameLength ? NULL : (const char*) ((HDR) + 1))
+
+#define FLATMSG_FIELD_VALUE(HDR)                                               \
+    ((mama_u8_t*) ((HDR) + 1) + FLATMSG_ALIGN ((HDR)->mNameLength))
+
+#define FLATMSG_FIELD_SPAN(HDR)                                                \
+    (sizeof (flatmsgFieldHeader) + FLATMSG_ALIGN ((HDR)->mNameLength)          \
+                                 + FLATMSG_ALIGN ((HDR)->mSize))
+
+/*
+ * Scalar values are stored in their native width, so casting between them is
+ * a case of reading the stored type and casting it to the one requested.
+ * Types which cannot be cast directly fall through to the end of the switch.
+ */
+#define GET_FIELD_AS_MAMA_TYPE(HDR,TO_TYPE,TO_RESULT)                          \
+do                                                                             \
+{                                                                              \
+    const void* value = FLATMSG_FIELD_VALUE (HDR);                             \
+    switch ((HDR)->mType){                                                     \
+    case MAMA_FIELD_TYPE_BOOL:                                                 \
+        TO_RESULT = (TO_TYPE) *(const mama_bool_t*) value;                     \
+        break;                                                                 \
+    case MAMA_FIELD_TYPE_CHAR:                                                 \
+        TO_RESULT = (TO_TYPE) *(const char*) value;                            \
+        break;                                                                 \
+    case MAMA_FIELD_TYPE_I8:                                                   \
+        TO_RESULT = (TO_TYPE) *(const mama_i8_t*) value;                       \
+        break;                                                                 \
+    case MAMA_FIELD_TYPE_U8:                                                   \
+        TO_RESULT = (TO_TYPE) *(const mama_u8_t*) value;                       \
+        break;                                                                 \
+    case MAMA_FIELD_TYPE_I16:                                                  \
+        TO_RESULT = (TO_TYPE) *(const mama_i16_t*) value;                      \
+        break;                                                                 \
+    case MAMA_FIELD_TYPE_U16:                                                  \
+        TO_RESULT = (TO_TYPE) *(const mama_u16_t*) value;                      \
+        break;                                                                 \
+    case MAMA_FIELD_TYPE_I32:                                                  \
+        TO_RESULT = (TO_TYPE) *(const mama_i32_t*) value;                      \
+        break;                                                                 \
+    case MAMA_FIELD_TYPE_U32:                                                  \
+        TO_RESULT = (TO_TYPE) *(const mama_u32_t*) value;                      \
+        break;                                                                 \
+    case MAMA_FIELD_TYPE_I64:                                                  \
+        TO_RESULT = (TO_TYPE) *(const mama_i64_t*) value;                      \
+        break;                                                                 \
+    case MAMA_FIELD_TYPE_U64:                                                  \
+        TO_RESULT = (TO_TYPE) *(const mama_u64_t*) value;                      \
+        break;                                                                 \
+    case MAMA_FIELD_TYPE_F32:                                                  \
+        TO_RESULT = (TO_TYPE) *(const mama_f32_t*) value;                      \
+        break;                                                                 \
+    case MAMA_FIELD_TYPE_F64:                                                  \
+        TO_RESULT = (TO_TYPE) *(const mama_f64_t*) value;                      \
+        break;                                                                 \
+    default:                                                                   \
+        status = MAMA_STATUS_WRONG_FIELD_TYPE;                                 \
+        break;                                                                 \
+    }                                                                          \
+} while(0)
+
+/*=========================================================================
+  =                Typedefs, structs, enums and globals                   =
+  =========================================================================*/
+
+/*
+ * The encoded message is a single buffer laid out as:
+ *
+ *     | flatmsgHeader | field data (dataSize bytes) | index (numFields) |
+ *
+ * Each field in the data region is a flatmsgFieldHeader followed by the
+ * terminated name and then the value, both padded to 8 bytes so that values
+ * can be handed out as direct views. The index table at the tail is kept
+ * sorted by fid so lookups are a binary search rather than a walk of the
+ * data. All structures below are naturally aligned and contain no padding.
+ */
+typedef struct flatmsgHeader_
+{
+    /* MAMA_PAYLOAD_FLAT so the buffer identifies itself to the middleware */
+    mama_u8_t       mPayloadType;
+    mama_u8_t       mVersion;
+    mama_u8_t       mByteOrder;
+    mama_u8_t       mReserved;
+    mama_u32_t      mNumFields;
+    /* Length of the field data region, excluding header and index */
+    mama_u32_t      mDataSize;
+    mama_u32_t      mReserved2;
+} flatmsgHeader;
+
+typedef struct flatmsgFieldHeader_
+{
+    mama_u16_t      mFid;
+    mama_u8_t       mType;
+    /* Including the terminator, 0 when the field has no name */
+    mama_u8_t       mNameLength;
+    /* Unpadded length of the value */
+    mama_u32_t      mSize;
+} flatmsgFieldHeader;
+
+typedef struct flatmsgIndexEntry_
+{
+    mama_u16_t      mFid;
+    mama_u8_t       mType;
+    mama_u8_t       mReserved;
+    /* Offset of the field header from the start of the data region */
+    mama_u32_t      mOffset;
+} flatmsgIndexEntry;
+
+typedef struct flatmsgDateTime_
+{
+    mama_u64_t      mTime;
+    mama_u32_t      mNanoseconds;
+    mama_u32_t      mReserved;
+} flatmsgDateTime;
+
+typedef struct flatmsgPrice_
+{
+    mama_f64_t      mValue;
+    mama_u8_t       mHints;
+    mama_u8_t       mReserved[7];
+} flatmsgPrice;
+
+struct flatmsgPayloadImpl_;
+
+typedef struct flatmsgFieldPayloadImpl_
+{
+    /* Message the field lives in - NULL indicates no valid parent */
+    struct flatmsgPayloadImpl_* mParent;
+
+    /* Offset of the field header from the start of the data region */
+    mama_u32_t                  mOffset;
+
+} flatmsgFieldPayloadImpl;
+
+typedef struct flatmsgPayloadImpl_
+{
+    /*
+     * Encoded message - this is also the serialized form. It is either our
+     * own storage or a read only view of a buffer handed to us, which is
+     * copied into the storage before the first modification.
+     */
+    mama_u8_t*                      mBuffer;
+
+    /* Usable size of mBuffer - the encoded size when it is a view */
+    mama_size_t                     mBufferSize;
+
+    /* Buffer owned by the payload */
+    mama_u8_t*                      mStorage;
+    mama_size_t                     mStorageSize;
+
+    /* Reusable field impl */
+    flatmsgFieldPayloadImpl*        mField;
+
+    /* Reusable buffer for toString */
+    char*                           mStringBuffer;
+    mama_size_t                     mStringBufferSize;
+
+    /* Reusable buffer for string and message vector results */
+    void*                           mVectorBuffer;
+    mama_size_t                     mVectorBufferSize;
+
+    /* Sub messages handed out by getMsg, kept until the next clear */
+    struct flatmsgPayloadImpl_**    mNested;
+    mama_u32_t*                     mNestedOffsets;
+    mama_size_t                     mNestedCount;
+    mama_size_t                     mNestedSize;
+
+    /* Sub messages handed out by getVectorMsg, reused on each call */
+    struct flatmsgPayloadImpl_**    mNestedVector;
+    mama_size_t                     mNestedVectorSize;
+
+    /* Parent MAMA message */
+    mamaMsg                         mParent;
+
+} flatmsgPayloadImpl;
+
+typedef struct flatmsgIterImpl_
+{
+    /* Message being iterated */
+    flatmsgPayloadImpl*         mMsg;
+
+    /* Field handed back by next and begin */
+    flatmsgFieldPayloadImpl     mField;
+
+    /* Data region offset of the next field to be returned */
+    mama_u32_t                  mOffset;
+
+} flatmsgIterImpl;
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* MAMA_PAYLOAD_FLATMSG_FLATCOMMON_H__ */
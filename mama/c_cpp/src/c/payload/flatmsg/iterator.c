@@ -0,0 +1,186 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+/*=========================================================================
+  =                             Includes                                  =
+  =========================================================================*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <mama/mama.h>
+
+#include "payloadbridge.h"
+#include "msgfieldimpl.h"
+#include "flatcommon.h"
+#include "flatpayloadfunctions.h"
+#include "payload.h"
+
+
+/*=========================================================================
+  =                   Public implementation functions                     =
+  =========================================================================*/
+
+mama_status
+flatmsgPayloadIter_create (msgPayloadIter* iter,
+                           msgPayload      msg)
+{
+    flatmsgIterImpl*     impl    = NULL;
+    flatmsgPayloadImpl*  msgImpl = (flatmsgPayloadImpl*) msg;
+
+    if (NULL == msg || NULL == iter)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    impl = (flatmsgIterImpl*) calloc (1, sizeof (flatmsgIterImpl));
+    if (NULL == impl)
+    {
+        return MAMA_STATUS_NOMEM;
+    }
+
+    /* The field is embedded as it only ever refers to the message buffer */
+    impl->mMsg            = msgImpl;
+    impl->mField.mParent  = msgImpl;
+    impl->mOffset         = 0;
+
+    *iter = impl;
+
+    return MAMA_STATUS_OK;
+}
+
+msgFieldPayload
+flatmsgPayloadIter_next (msgPayloadIter          iter,
+                         msgFieldPayload         field,
+                         msgPayload              msg)
+{
+    flatmsgIterImpl*     impl    = (flatmsgIterImpl*) iter;
+    flatmsgPayloadImpl*  msgImpl = (flatmsgPayloadImpl*) msg;
+
+    /* Field will be NULL on first call so don't check for it */
+    if (NULL == iter || NULL == msg)
+    {
+        return NULL;
+    }
+
+    /* Fields are visited in the order they were added */
+    if (impl->mOffset >= FLATMSG_HEADER (msgImpl)->mDataSize)
+    {
+        return NULL;
+    }
+
+    impl->mField.mParent = msgImpl;
+    impl->mField.mOffset = impl->mOffset;
+
+    impl->mOffset += (mama_u32_t) FLATMSG_FIELD_SPAN (
+                                    FLATMSG_FIELD (msgImpl, impl->mOffset));
+
+    return (msgFieldPayload) &impl->mField;
+}
+
+mama_bool_t
+flatmsgPayloadIter_hasNext (msgPayloadIter          iter,
+                            msgPayload              msg)
+{
+    flatmsgIterImpl*     impl    = (flatmsgIterImpl*) iter;
+    flatmsgPayloadImpl*  msgImpl = (flatmsgPayloadImpl*) msg;
+
+    if (NULL == iter || NULL == msg)
+    {
+        return 0;
+    }
+
+    return impl->mOffset < FLATMSG_HEADER (msgImpl)->mDataSize;
+}
+
+msgFieldPayload
+flatmsgPayloadIter_begin (msgPayloadIter          iter,
+                          msgFieldPayload         field,
+                          msgPayload              msg)
+{
+    flatmsgIterImpl*     impl    = (flatmsgIterImpl*) iter;
+    flatmsgPayloadImpl*  msgImpl = (flatmsgPayloadImpl*) msg;
+
+    if (NULL == iter || NULL == msg)
+    {
+        return NULL;
+    }
+
+    /* Move to where the message starts */
+    impl->mOffset = 0;
+
+    /* NULL signifies no more data */
+    if (0 == FLATMSG_HEADER (msgImpl)->mDataSize)
+    {
+        return NULL;
+    }
+
+    /* Hand back the first field without stepping past it */
+    impl->mField.mParent = msgImpl;
+    impl->mField.mOffset = 0;
+
+    return (msgFieldPayload) &impl->mField;
+}
+
+/*
+ * Postponing implementation until this method is included or removed from the
+ * implementation
+ */
+msgFieldPayload
+flatmsgPayloadIter_end (msgPayloadIter          iter,
+                        msgPayload              msg)
+{
+    return NULL;
+}
+
+mama_status
+flatmsgPayloadIter_associate (msgPayloadIter          iter,
+                              msgPayload              msg)
+{
+    flatmsgIterImpl*     impl    = (flatmsgIterImpl*) iter;
+    flatmsgPayloadImpl*  msgImpl = (flatmsgPayloadImpl*) msg;
+
+    if (NULL == iter || NULL == msg)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    impl->mMsg           = msgImpl;
+    impl->mField.mParent = msgImpl;
+    impl->mField.mOffset = 0;
+    impl->mOffset        = 0;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgPayloadIter_destroy (msgPayloadIter iter)
+{
+    if (NULL == iter)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    free (iter);
+
+    return MAMA_STATUS_OK;
+}
@@ -0,0 +1,4091 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+/*=========================================================================
+  =                             Includes                                  =
+  =========================================================================*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+#include <mama/mama.h>
+#include <mama/price.h>
+
+#include "payloadbridge.h"
+#include "msgfieldimpl.h"
+#include "msgimpl.h"
+#include "datetimeimpl.h"
+
+#include "flatcommon.h"
+#include "flatpayloadfunctions.h"
+#include "payload.h"
+
+/*=========================================================================
+  =                              Macros                                   =
+  =========================================================================*/
+
+/* Marks a sub message in the nested pool as no longer matching its field */
+#define FLATMSG_NO_OFFSET       0xFFFFFFFF
+
+#define ADD_SCALAR(MAMATYPE)                                                   \
+do                                                                             \
+{                                                                              \
+    flatmsgPayloadImpl* impl = (flatmsgPayloadImpl*) msg;                      \
+                                                                               \
+    if (NULL == impl)                                                          \
+    {                                                                          \
+        return MAMA_STATUS_NULL_ARG;                                           \
+    }                                                                          \
+                                                                               \
+    if (NULL == name && 0 == fid)                                              \
+    {                                                                          \
+        return MAMA_STATUS_NULL_ARG;                                           \
+    }                                                                          \
+                                                                               \
+    return flatmsgPayloadImpl_addField (impl, name, fid, MAMATYPE,             \
+                                        &value, sizeof (value), NULL);         \
+} while(0)                                                                     \
+
+
+#define UPDATE_SCALAR(MAMATYPE)                                                \
+do                                                                             \
+{                                                                              \
+    flatmsgPayloadImpl* impl = (flatmsgPayloadImpl*) msg;                      \
+                                                                               \
+    if (NULL == impl)                                                          \
+    {                                                                          \
+        return MAMA_STATUS_NULL_ARG;                                           \
+    }                                                                          \
+                                                                               \
+    return flatmsgPayloadImpl_updateField (impl, name, fid, MAMATYPE,          \
+                                           &value, sizeof (value), NULL);      \
+} while(0)                                                                     \
+
+
+#define GET_SCALAR(TYPE)                                                       \
+do                                                                             \
+{                                                                              \
+    flatmsgPayloadImpl* impl   = (flatmsgPayloadImpl*) msg;                    \
+    mama_status         status = MAMA_STATUS_OK;                               \
+    mama_u32_t          offset = 0;                                            \
+                                                                               \
+    if (NULL == impl || NULL == result)                                        \
+    {                                                                          \
+        return MAMA_STATUS_NULL_ARG;                                           \
+    }                                                                          \
+                                                                               \
+    if (NULL == name && 0 == fid)                                              \
+    {                                                                          \
+        *result = 0;                                                           \
+        return MAMA_STATUS_NULL_ARG;                                           \
+    }                                                                          \
+                                                                               \
+    /* Find field */                                                           \
+    status = flatmsgPayloadImpl_findField (impl, name, fid, &offset);          \
+    if (MAMA_STATUS_OK != status)                                              \
+    {                                                                          \
+        return status;                                                         \
+    }                                                                          \
+                                                                               \
+    /* Cast the stored value to the required MAMA type */                      \
+    GET_FIELD_AS_MAMA_TYPE (FLATMSG_FIELD (impl, offset), TYPE, *result);      \
+                                                                               \
+    return status;                                                             \
+} while(0)                                                                     \
+
+
+#define ADD_VECTOR(MAMATYPE,CTYPE)                                             \
+do                                                                             \
+{                                                                              \
+    flatmsgPayloadImpl* impl = (flatmsgPayloadImpl*) msg;                      \
+                                                                               \
+    if (NULL == impl || NULL == value || (NULL == name && 0 == fid))           \
+    {                                                                          \
+        return MAMA_STATUS_NULL_ARG;                                           \
+    }                                                                          \
+                                                                               \
+    /* Vectors are stored as the raw array so may be handed out directly */    \
+    return flatmsgPayloadImpl_addField (impl, name, fid, MAMATYPE,             \
+                                        value, size * sizeof (CTYPE), NULL);   \
+} while(0)                                                                     \
+
+
+#define UPDATE_VECTOR(MAMATYPE,CTYPE,VALUE)                                    \
+do                                                                             \
+{                                                                              \
+    flatmsgPayloadImpl* impl = (flatmsgPayloadImpl*) msg;                      \
+                                                                               \
+    if (NULL == impl || NULL == VALUE || (NULL == fname && 0 == fid))          \
+    {                                                                          \
+        return MAMA_STATUS_NULL_ARG;                                           \
+    }                                                                          \
+                                                                               \
+    return flatmsgPayloadImpl_updateField (impl, fname, fid, MAMATYPE,         \
+                                           VALUE, size * sizeof (CTYPE),       \
+                                           NULL);                              \
+} while(0)                                                                     \
+
+
+#define GET_VECTOR(MAMATYPE,CTYPE)                                             \
+do                                                                             \
+{                                                                              \
+    flatmsgPayloadImpl* impl   = (flatmsgPayloadImpl*) msg;                    \
+    flatmsgFieldHeader* hdr    = NULL;                                         \
+    mama_status         status = MAMA_STATUS_OK;                               \
+    mama_u32_t          offset = 0;                                            \
+                                                                               \
+    if (NULL == impl || NULL == result || NULL == size ||                      \
+            (NULL == name && 0 == fid))                                        \
+    {                                                                          \
+        return MAMA_STATUS_NULL_ARG;                                           \
+    }                                                                          \
+                                                                               \
+    /* Find field */                                                           \
+    status = flatmsgPayloadImpl_findField (impl, name, fid, &offset);          \
+    if (MAMA_STATUS_OK != status)                                              \
+    {                                                                          \
+        return status;                                                         \
+    }                                                                          \
+                                                                               \
+    hdr = FLATMSG_FIELD (impl, offset);                                        \
+    if (MAMATYPE != hdr->mType)                                                \
+    {                                                                          \
+        return MAMA_STATUS_WRONG_FIELD_TYPE;                                   \
+    }                                                                          \
+                                                                               \
+    /* Point straight at the array in the buffer - no copy required */         \
+    *result = (const CTYPE*) FLATMSG_FIELD_VALUE (hdr);                        \
+    *size   = hdr->mSize / sizeof (CTYPE);                                     \
+                                                                               \
+    return MAMA_STATUS_OK;                                                     \
+} while(0)                                                                     \
+
+
+#define PRINT_SCALAR(CTYPE,FORMAT,CASTTO)                                      \
+do                                                                             \
+{                                                                              \
+    flatmsgPayloadImpl_append (buffer, len, &written, FORMAT,                  \
+                               (CASTTO) *(const CTYPE*) value);                \
+} while (0)
+
+
+#define PRINT_VECTOR(CTYPE,FORMAT,CASTTO)                                      \
+do                                                                             \
+{                                                                              \
+    const CTYPE* values = (const CTYPE*) value;                                \
+    mama_size_t  count  = hdr->mSize / sizeof (CTYPE);                         \
+    mama_size_t  i      = 0;                                                   \
+                                                                               \
+    flatmsgPayloadImpl_append (buffer, len, &written, "{");                    \
+    for (i = 0; i < count; i++)                                                \
+    {                                                                          \
+        flatmsgPayloadImpl_append (buffer, len, &written,                      \
+                                   0 == i ? FORMAT : "," FORMAT,               \
+                                   (CASTTO) values[i]);                        \
+    }                                                                          \
+    flatmsgPayloadImpl_append (buffer, len, &written, "}");                    \
+} while (0)
+
+
+/* Used when converting messages with another payload type field by field */
+#define ADD_VECTOR_FIELD(MAMATYPE,SUFFIX,CTYPE)                                \
+    case MAMA_FIELD_TYPE_VECTOR_##MAMATYPE:                                    \
+    {                                                                          \
+        const CTYPE* value = NULL;                                             \
+        mama_size_t  size  = 0;                                                \
+        if (MAMA_STATUS_OK == mamaMsgField_getVector##SUFFIX (field, &value,   \
+                                                             &size))           \
+            flatmsgPayload_addVector##SUFFIX (payload, name, fid, value, size);\
+        break;                                                                 \
+    }
+
+
+/*=========================================================================
+  =                  Private implementation prototypes                    =
+  =========================================================================*/
+
+/**
+ * This function will create a payload implementation with an empty message
+ * in its buffer, along with its reusable field.
+ *
+ * @param msg     The payload to create.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+static mama_status
+flatmsgPayloadImpl_createImplementationOnly (flatmsgPayloadImpl**     msg);
+
+/**
+ * This function will write an empty message header into the buffer and
+ * release any sub messages handed out for the previous contents.
+ *
+ * @param impl    The payload to reset.
+ */
+static void
+flatmsgPayloadImpl_reset                    (flatmsgPayloadImpl*      impl);
+
+/**
+ * This function will ensure the buffer can hold at least the number of bytes
+ * requested, doubling its size where it needs to grow. A view of another
+ * buffer is copied into the payload's own storage first so the result can
+ * always be written to.
+ *
+ * @param impl     The payload whose buffer should be checked.
+ * @param required The total number of bytes required.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+static mama_status
+flatmsgPayloadImpl_reserve                  (flatmsgPayloadImpl*      impl,
+                                             mama_size_t              required);
+
+/**
+ * This function will check that the buffer provided starts with a flat
+ * message header for this host's byte order, and that the length of the
+ * message it describes fits in the buffer. The buffer need not be aligned.
+ *
+ * @param buffer  The encoded message.
+ * @param length  The length of the buffer.
+ * @param size    Populated with the encoded length of the message.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+static mama_status
+flatmsgPayloadImpl_validateHeader           (const void*              buffer,
+                                             mama_size_t              length,
+                                             mama_size_t*             size);
+
+/**
+ * This function will check that every field and index entry of an encoded
+ * message lies within its data region, so that the accessors can read it
+ * without further checks. Sub messages are checked when they are decoded.
+ *
+ * @param buffer  The encoded message, which must be 8 byte aligned and have
+ *                passed flatmsgPayloadImpl_validateHeader.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+static mama_status
+flatmsgPayloadImpl_validate                 (const mama_u8_t*         buffer);
+
+/**
+ * This function will check a single field of an encoded message, including
+ * the name terminator and the minimum size of its value for the type.
+ *
+ * @param data     The start of the data region.
+ * @param dataSize The length of the data region.
+ * @param offset   The offset of the field header in the data region.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+static mama_status
+flatmsgPayloadImpl_validateField            (const mama_u8_t*         data,
+                                             mama_u32_t               dataSize,
+                                             mama_u32_t               offset);
+
+/**
+ * This function will replace the contents of the payload with a copy of the
+ * encoded message provided.
+ *
+ * @param impl    The payload to populate.
+ * @param buffer  The encoded message.
+ * @param length  The length of the buffer.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+static mama_status
+flatmsgPayloadImpl_decode                   (flatmsgPayloadImpl*      impl,
+                                             const void*              buffer,
+                                             mama_size_t              length);
+
+/**
+ * This function will replace the contents of the payload with a view of the
+ * encoded message provided, which must outlive the payload or be replaced
+ * first. Buffers which are not 8 byte aligned are copied instead.
+ *
+ * @param impl    The payload to populate.
+ * @param buffer  The encoded message.
+ * @param length  The length of the buffer.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+static mama_status
+flatmsgPayloadImpl_wrap                     (flatmsgPayloadImpl*      impl,
+                                             const void*              buffer,
+                                             mama_size_t              length);
+
+/**
+ * This function will append a new field to the data region and insert it in
+ * the index after any existing fields with the same fid.
+ *
+ * @param impl    The payload to add to.
+ * @param name    The name of the field, may be NULL.
+ * @param fid     The fid of the field.
+ * @param type    The MAMA field type of the value.
+ * @param value   The value to copy in, or NULL if the caller will write it.
+ * @param size    The length of the value in bytes.
+ * @param dest    If not NULL, populated with the location of the value.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+static mama_status
+flatmsgPayloadImpl_addField                 (flatmsgPayloadImpl*      impl,
+                                             const char*              name,
+                                             mama_fid_t               fid,
+                                             mamaFieldType            type,
+                                             const void*              value,
+                                             mama_size_t              size,
+                                             void**                   dest);
+
+/**
+ * This function will update the field matching the name / fid provided, or
+ * add it if it does not exist yet.
+ *
+ * @param impl    The payload to update.
+ * @param name    The name of the field, may be NULL.
+ * @param fid     The fid of the field.
+ * @param type    The MAMA field type of the value.
+ * @param value   The value to copy in, or NULL if the caller will write it.
+ * @param size    The length of the value in bytes.
+ * @param dest    If not NULL, populated with the location of the value.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+static mama_status
+flatmsgPayloadImpl_updateField              (flatmsgPayloadImpl*      impl,
+                                             const char*              name,
+                                             mama_fid_t               fid,
+                                             mamaFieldType            type,
+                                             const void*              value,
+                                             mama_size_t              size,
+                                             void**                   dest);
+
+/**
+ * This function will encode a string vector into a newly allocated buffer
+ * which the caller must free.
+ *
+ * @param value   The strings to encode.
+ * @param size    The number of strings.
+ * @param result  Populated with the encoded buffer.
+ * @param length  Populated with the length of the encoded buffer.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+static mama_status
+flatmsgPayloadImpl_encodeVectorString       (const char*              value[],
+                                             mama_size_t              size,
+                                             void**                   result,
+                                             mama_size_t*             length);
+
+/**
+ * This function will encode a message vector into a newly allocated buffer
+ * which the caller must free. Messages with a different payload type are
+ * converted field by field.
+ *
+ * @param value   The messages to encode.
+ * @param size    The number of messages.
+ * @param result  Populated with the encoded buffer.
+ * @param length  Populated with the length of the encoded buffer.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+static mama_status
+flatmsgPayloadImpl_encodeVectorMsg          (const mamaMsg            value[],
+                                             mama_size_t              size,
+                                             void**                   result,
+                                             mama_size_t*             length);
+
+/**
+ * This function will return the flat payload underlying the MAMA message
+ * provided. Where the message uses another payload, a flat copy is created
+ * which the caller must destroy.
+ *
+ * @param msg     The MAMA message.
+ * @param result  Populated with the flat payload.
+ * @param owned   Populated with whether the caller must destroy the result.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+static mama_status
+flatmsgPayloadImpl_fromMamaMsg              (const mamaMsg            msg,
+                                             flatmsgPayloadImpl**     result,
+                                             mama_bool_t*             owned);
+
+/**
+ * This is a mamaMsgIteratorCb which adds each field of a message with another
+ * payload type to the flat payload passed as the closure.
+ */
+static void MAMACALLTYPE
+flatmsgPayloadImpl_addMsgFieldCb            (const mamaMsg            msg,
+                                             const mamaMsgField       field,
+                                             void*                    closure);
+
+/**
+ * This function will append formatted output to the buffer provided, keeping
+ * it terminated and never writing past its length.
+ */
+static void
+flatmsgPayloadImpl_append                   (char*                    buffer,
+                                             mama_size_t              len,
+                                             mama_size_t*             written,
+                                             const char*              format,
+                                             ...);
+
+
+/*=========================================================================
+  =                   Public interface functions                          =
+  =========================================================================*/
+
+mama_status
+flatmsgPayload_createImpl (mamaPayloadBridge* result, char* identifier)
+{
+    mamaPayloadBridgeImpl* impl = NULL;
+
+    impl = (mamaPayloadBridgeImpl*) calloc (1, sizeof (mamaPayloadBridgeImpl));
+
+    if (NULL == impl)
+    {
+        mama_log (MAMA_LOG_LEVEL_SEVERE, "flatmsgPayload_createImpl(): "
+                  "Could not allocate memory for payload impl.");
+        return MAMA_STATUS_NOMEM;
+    }
+
+    /* Use closure to store global data for payload bridge if required */
+    impl->mClosure = NULL;
+
+    /* Initialize the virtual function table (see payloadbridge.h) */
+    INITIALIZE_PAYLOAD_BRIDGE (impl, flatmsg);
+
+    /* Optional one pass header extraction */
+    impl->msgPayloadGetHeader = flatmsgPayload_getHeader;
+
+    *result     = (mamaPayloadBridge)impl;
+    *identifier = (char)MAMA_PAYLOAD_FLAT;
+
+    return MAMA_STATUS_OK;
+}
+
+mamaPayloadType
+flatmsgPayload_getType (void)
+{
+    return MAMA_PAYLOAD_FLAT;
+}
+
+mama_status
+flatmsgPayload_create (msgPayload* msg)
+{
+    if (NULL == msg)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    return flatmsgPayloadImpl_createImplementationOnly (
+            (flatmsgPayloadImpl**) msg);
+}
+
+mama_status
+flatmsgPayload_createForTemplate (msgPayload*        msg,
+                                  mamaPayloadBridge  bridge,
+                                  mama_u32_t         templateId)
+{
+    mama_log (MAMA_LOG_LEVEL_SEVERE, "flatmsgPayload_createForTemplate(): "
+              "Method not applicable for flat as it is not a template "
+              "based payload.");
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+flatmsgPayload_copy (const msgPayload    msg,
+                     msgPayload*         copy)
+{
+    flatmsgPayloadImpl*  impl    = (flatmsgPayloadImpl*) msg;
+    mama_status          status  = MAMA_STATUS_OK;
+
+    if (NULL == msg || NULL == copy)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /*
+     * Create destination message object if the user hasn't already created
+     * one
+     */
+    if (NULL == *copy)
+    {
+        status = flatmsgPayload_create (copy);
+        if (MAMA_STATUS_OK != status)
+        {
+            return status;
+        }
+    }
+
+    if (*copy == msg)
+    {
+        return MAMA_STATUS_OK;
+    }
+
+    /* The encoded message is self contained so this is a single copy */
+    return flatmsgPayloadImpl_decode ((flatmsgPayloadImpl*) *copy,
+                                      impl->mBuffer,
+                                      FLATMSG_ENCODED_SIZE (impl));
+}
+
+mama_status
+flatmsgPayload_clear (msgPayload msg)
+{
+    flatmsgPayloadImpl* impl = (flatmsgPayloadImpl*) msg;
+
+    if (NULL == impl)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Just reset the header - the buffer and everything else is reused */
+    flatmsgPayloadImpl_reset (impl);
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgPayload_destroy (msgPayload msg)
+{
+    flatmsgPayloadImpl* impl = (flatmsgPayloadImpl*) msg;
+    mama_size_t         i    = 0;
+
+    if (NULL == impl)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Release the underlying field object */
+    if (NULL != impl->mField)
+    {
+        flatmsgFieldPayload_destroy ((msgFieldPayload) impl->mField);
+        impl->mField = NULL;
+    }
+
+    /* Release the sub messages handed out by getMsg */
+    for (i = 0; i < impl->mNestedSize; i++)
+    {
+        if (NULL != impl->mNested[i])
+        {
+            flatmsgPayload_destroy ((msgPayload) impl->mNested[i]);
+        }
+    }
+    free (impl->mNested);
+    free (impl->mNestedOffsets);
+
+    /* Release the sub messages handed out by getVectorMsg */
+    for (i = 0; i < impl->mNestedVectorSize; i++)
+    {
+        if (NULL != impl->mNestedVector[i])
+        {
+            flatmsgPayload_destroy ((msgPayload) impl->mNestedVector[i]);
+        }
+    }
+    free (impl->mNestedVector);
+
+    /* Release the reusable buffers */
+    free (impl->mStringBuffer);
+    free (impl->mVectorBuffer);
+    free (impl->mStorage);
+
+    /* Finally, release the payload implementation object */
+    free (impl);
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgPayload_setParent (msgPayload    msg,
+                          const mamaMsg parent)
+{
+    flatmsgPayloadImpl* impl = (flatmsgPayloadImpl*) msg;
+
+    if (NULL == impl)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+    impl->mParent = (mamaMsg) parent;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgPayload_getByteSize (msgPayload    msg,
+                            mama_size_t*  size)
+{
+    flatmsgPayloadImpl* impl = (flatmsgPayloadImpl*) msg;
+
+    if (NULL == impl || NULL == size)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* The buffer is always in its serialized form */
+    *size = FLATMSG_ENCODED_SIZE (impl);
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgPayload_getNumFields (const msgPayload    msg,
+                             mama_size_t*        numFields)
+{
+    flatmsgPayloadImpl* impl = (flatmsgPayloadImpl*) msg;
+
+    if (NULL == impl || NULL == numFields)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    *numFields = FLATMSG_HEADER (impl)->mNumFields;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgPayload_getSendSubject (const msgPayload    msg,
+                               const char**        subject)
+{
+    /*
+     * Not implemented for now. Used by self describing messages and the flat
+     * payload is not self describing.
+     */
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+const char*
+flatmsgPayload_toString (const msgPayload msg)
+{
+    flatmsgPayloadImpl* impl    = (flatmsgPayloadImpl*) msg;
+    flatmsgFieldHeader* hdr     = NULL;
+    mama_size_t         written = 0;
+    mama_size_t         mark    = 0;
+    mama_u32_t          offset  = 0;
+
+    if (NULL == impl)
+    {
+        return NULL;
+    }
+
+    if (MAMA_STATUS_OK != flatmsgPayloadImpl_allocateBufferMemory (
+                                            (void**) &impl->mStringBuffer,
+                                            &impl->mStringBufferSize,
+                                            FLATMSG_STRING_BUFFER_SIZE))
+    {
+        return NULL;
+    }
+
+    flatmsgPayloadImpl_append (impl->mStringBuffer, impl->mStringBufferSize,
+                               &written, "{");
+
+    while (offset < FLATMSG_HEADER (impl)->mDataSize)
+    {
+        hdr  = FLATMSG_FIELD (impl, offset);
+        mark = written;
+
+        flatmsgPayloadImpl_append (impl->mStringBuffer,
+                                   impl->mStringBufferSize,
+                                   &written,
+                                   "%s%s[%u]=",
+                                   0 == offset ? "" : ",",
+                                   NULL == FLATMSG_FIELD_NAME (hdr)
+                                        ? "" : FLATMSG_FIELD_NAME (hdr),
+                                   (unsigned) hdr->mFid);
+
+        written += flatmsgPayloadImpl_fieldToString (
+                        hdr,
+                        impl->mStringBuffer + written,
+                        impl->mStringBufferSize - written);
+
+        /* Leave room for the closing brace - grow and redo this field if not */
+        if (written + 2 >= impl->mStringBufferSize)
+        {
+            if (MAMA_STATUS_OK != flatmsgPayloadImpl_allocateBufferMemory (
+                                        (void**) &impl->mStringBuffer,
+                                        &impl->mStringBufferSize,
+                                        impl->mStringBufferSize * 2))
+            {
+                break;
+            }
+            written = mark;
+            continue;
+        }
+
+        offset += FLATMSG_FIELD_SPAN (hdr);
+    }
+
+    flatmsgPayloadImpl_append (impl->mStringBuffer, impl->mStringBufferSize,
+                               &written, "}");
+
+    return (const char*) impl->mStringBuffer;
+}
+
+mama_status
+flatmsgPayload_iterateFields (const msgPayload    msg,
+                              const mamaMsg       parent,
+                              mamaMsgField        field,
+                              mamaMsgIteratorCb   cb,
+                              void*               closure)
+{
+    flatmsgPayloadImpl* impl      = (flatmsgPayloadImpl*) msg;
+    mamaMsgFieldImpl*   mamaField = (mamaMsgFieldImpl*) field;
+    mama_u32_t          offset    = 0;
+
+    if (   NULL == impl
+        || NULL == parent
+        || NULL == mamaField
+        || NULL == cb)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Fields are visited in the order they were added */
+    while (offset < FLATMSG_HEADER (impl)->mDataSize)
+    {
+        impl->mField->mParent = impl;
+        impl->mField->mOffset = offset;
+
+        mamaMsgFieldImpl_setPayload (mamaField, (msgFieldPayload) impl->mField);
+        cb (parent, field, closure);
+
+        /* The callback may have updated the field so read its span after */
+        offset += FLATMSG_FIELD_SPAN (FLATMSG_FIELD (impl, offset));
+    }
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgPayload_getHeader (const msgPayload    msg,
+                          msgPayloadHeader*   header)
+{
+    flatmsgPayloadImpl* impl   = (flatmsgPayloadImpl*) msg;
+    flatmsgIndexEntry*  index  = NULL;
+    flatmsgFieldHeader* hdr    = NULL;
+    mama_status         status = MAMA_STATUS_OK;
+    mama_u32_t          i      = 0;
+
+    if (NULL == impl || NULL == header)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    header->mPresent = 0;
+    index            = FLATMSG_INDEX (impl);
+
+    /* The index is sorted by fid so the reserved fields come first */
+    for (i = 0; i < FLATMSG_HEADER (impl)->mNumFields; i++)
+    {
+        if (index[i].mFid > MamaFieldMsgQual.mFid)
+        {
+            break;
+        }
+
+        hdr    = FLATMSG_FIELD (impl, index[i].mOffset);
+        status = MAMA_STATUS_OK;
+
+        if (index[i].mFid == MamaFieldMsgType.mFid)
+        {
+            GET_FIELD_AS_MAMA_TYPE (hdr, mama_i32_t, header->mType);
+            if (MAMA_STATUS_OK == status)
+                header->mPresent |= MAMA_PAYLOAD_HEADER_TYPE;
+        }
+        else if (index[i].mFid == MamaFieldMsgStatus.mFid)
+        {
+            GET_FIELD_AS_MAMA_TYPE (hdr, mama_i32_t, header->mStatus);
+            if (MAMA_STATUS_OK == status)
+                header->mPresent |= MAMA_PAYLOAD_HEADER_STATUS;
+        }
+        else if (index[i].mFid == MamaFieldSeqNum.mFid)
+        {
+            GET_FIELD_AS_MAMA_TYPE (hdr, mama_i64_t, header->mSeqNum);
+            if (MAMA_STATUS_OK == status)
+                header->mPresent |= MAMA_PAYLOAD_HEADER_SEQNUM;
+        }
+        else if (index[i].mFid == MamaFieldSenderId.mFid)
+        {
+            GET_FIELD_AS_MAMA_TYPE (hdr, mama_u64_t, header->mSenderId);
+            if (MAMA_STATUS_OK == status)
+                header->mPresent |= MAMA_PAYLOAD_HEADER_SENDERID;
+        }
+        else if (index[i].mFid == MamaFieldMsgQual.mFid)
+        {
+            GET_FIELD_AS_MAMA_TYPE (hdr, mama_u16_t, header->mMsgQual);
+            if (MAMA_STATUS_OK == status)
+                header->mPresent |= MAMA_PAYLOAD_HEADER_MSGQUAL;
+        }
+    }
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgPayload_serialize (const msgPayload  msg,
+                          const void**      buffer,
+                          mama_size_t*      bufferLength)
+{
+    flatmsgPayloadImpl* impl = (flatmsgPayloadImpl*) msg;
+
+    if (NULL == impl || NULL == buffer || NULL == bufferLength)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* The buffer is maintained in its wire format so there is nothing to do */
+    *buffer       = impl->mBuffer;
+    *bufferLength = FLATMSG_ENCODED_SIZE (impl);
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgPayload_unSerialize (const msgPayload    msg,
+                            const void**        buffer,
+                            mama_size_t         bufferLength)
+{
+    flatmsgPayloadImpl* impl = (flatmsgPayloadImpl*) msg;
+
+    if (NULL == impl || NULL == buffer || 0 == bufferLength)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Despite the signature, this is the buffer itself */
+    return flatmsgPayloadImpl_wrap (impl, (const void*) buffer, bufferLength);
+}
+
+mama_status
+flatmsgPayload_getByteBuffer (const msgPayload  msg,
+                              const void**      buffer,
+                              mama_size_t*      bufferLength)
+{
+    return flatmsgPayload_serialize (msg, buffer, bufferLength);
+}
+
+mama_status
+flatmsgPayload_setByteBuffer (const msgPayload    msg,
+                              mamaPayloadBridge   bridge,
+                              const void*         buffer,
+                              mama_size_t         bufferLength)
+{
+    flatmsgPayloadImpl* impl = (flatmsgPayloadImpl*) msg;
+
+    if (NULL == impl || NULL == bridge || NULL == buffer || 0 == bufferLength)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    return flatmsgPayloadImpl_wrap (impl, buffer, bufferLength);
+}
+
+mama_status
+flatmsgPayload_createFromByteBuffer (msgPayload*         msg,
+                                     mamaPayloadBridge   bridge,
+                                     const void*         buffer,
+                                     mama_size_t         bufferLength)
+{
+    mama_status status = MAMA_STATUS_OK;
+    mama_size_t size   = 0;
+
+    if (NULL == msg || NULL == buffer)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    if (0 == bufferLength)
+    {
+        return MAMA_STATUS_INVALID_ARG;
+    }
+
+    /* Check the buffer before allocating anything for it */
+    status = flatmsgPayloadImpl_validateHeader (buffer, bufferLength, &size);
+    if (MAMA_STATUS_OK != status)
+    {
+        return status;
+    }
+
+    status = flatmsgPayload_create (msg);
+    if (MAMA_STATUS_OK != status)
+    {
+        return status;
+    }
+
+    /* The caller keeps the buffer for the life of the message */
+    status = flatmsgPayloadImpl_wrap ((flatmsgPayloadImpl*) *msg,
+                                      buffer,
+                                      size);
+    if (MAMA_STATUS_OK != status)
+    {
+        flatmsgPayload_destroy (*msg);
+        *msg = NULL;
+    }
+
+    return status;
+}
+
+mama_status
+flatmsgPayload_apply (msgPayload          dest,
+                      const msgPayload    src)
+{
+    flatmsgPayloadImpl* destImpl = (flatmsgPayloadImpl*) dest;
+    flatmsgPayloadImpl* srcImpl  = (flatmsgPayloadImpl*) src;
+    flatmsgFieldHeader* hdr      = NULL;
+    mama_status         status   = MAMA_STATUS_OK;
+    mama_u32_t          offset   = 0;
+
+    if (NULL == destImpl || NULL == srcImpl)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    if (destImpl == srcImpl)
+    {
+        return MAMA_STATUS_OK;
+    }
+
+    /*
+     * Every field is stored as raw bytes with its type, so each field in the
+     * source is copied across as-is with no need to decode the value.
+     */
+    while (offset < FLATMSG_HEADER (srcImpl)->mDataSize)
+    {
+        hdr    = FLATMSG_FIELD (srcImpl, offset);
+        status = flatmsgPayloadImpl_updateField (destImpl,
+                                                 FLATMSG_FIELD_NAME (hdr),
+                                                 hdr->mFid,
+                                                 (mamaFieldType) hdr->mType,
+                                                 FLATMSG_FIELD_VALUE (hdr),
+                                                 hdr->mSize,
+                                                 NULL);
+        if (MAMA_STATUS_OK != status)
+        {
+            return status;
+        }
+        offset += FLATMSG_FIELD_SPAN (hdr);
+    }
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgPayload_getNativeMsg (const msgPayload    msg,
+                             void**              nativeMsg)
+{
+    flatmsgPayloadImpl* impl = (flatmsgPayloadImpl*) msg;
+
+    if (NULL == impl || NULL == nativeMsg)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* The native message is the encoded buffer */
+    *nativeMsg = impl->mBuffer;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgPayload_getFieldAsString (const msgPayload    msg,
+                                 const char*         name,
+                                 mama_fid_t          fid,
+                                 char*               buffer,
+                                 mama_size_t         len)
+{
+    flatmsgPayloadImpl* impl    = (flatmsgPayloadImpl*) msg;
+    mama_status         status  = MAMA_STATUS_OK;
+    mama_u32_t          offset  = 0;
+
+    if (NULL == impl || NULL == buffer)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    if (0 == len)
+    {
+        return MAMA_STATUS_INVALID_ARG;
+    }
+
+    /* Find field */
+    status = flatmsgPayloadImpl_findField (impl, name, fid, &offset);
+    if (MAMA_STATUS_OK != status)
+    {
+        return status;
+    }
+
+    flatmsgPayloadImpl_fieldToString (FLATMSG_FIELD (impl, offset),
+                                      buffer,
+                                      len);
+
+    return MAMA_STATUS_OK;
+}
+
+/*=========================================================================
+  =                   Payload Add Scalar Field Methods                    =
+  =========================================================================*/
+
+mama_status
+flatmsgPayload_addBool (msgPayload  msg,
+                        const char* name,
+                        mama_fid_t  fid,
+                        mama_bool_t value)
+{
+    ADD_SCALAR (MAMA_FIELD_TYPE_BOOL);
+}
+
+mama_status
+flatmsgPayload_addChar (msgPayload  msg,
+                        const char* name,
+                        mama_fid_t  fid,
+                        char        value)
+{
+    ADD_SCALAR (MAMA_FIELD_TYPE_CHAR);
+}
+
+mama_status
+flatmsgPayload_addI8   (msgPayload  msg,
+                        const char* name,
+                        mama_fid_t  fid,
+                        mama_i8_t   value)
+{
+    ADD_SCALAR (MAMA_FIELD_TYPE_I8);
+}
+
+mama_status
+flatmsgPayload_addU8   (msgPayload  msg,
+                        const char* name,
+                        mama_fid_t  fid,
+                        mama_u8_t   value)
+{
+    ADD_SCALAR (MAMA_FIELD_TYPE_U8);
+}
+
+mama_status
+flatmsgPayload_addI16  (msgPayload  msg,
+                        const char* name,
+                        mama_fid_t  fid,
+                        mama_i16_t  value)
+{
+    ADD_SCALAR (MAMA_FIELD_TYPE_I16);
+}
+
+mama_status
+flatmsgPayload_addU16  (msgPayload  msg,
+                        const char* name,
+                        mama_fid_t  fid,
+                        mama_u16_t  value)
+{
+    ADD_SCALAR (MAMA_FIELD_TYPE_U16);
+}
+
+mama_status
+flatmsgPayload_addI32  (msgPayload  msg,
+                        const char* name,
+                        mama_fid_t  fid,
+                        mama_i32_t  value)
+{
+    ADD_SCALAR (MAMA_FIELD_TYPE_I32);
+}
+
+mama_status
+flatmsgPayload_addU32  (msgPayload  msg,
+                        const char* name,
+                        mama_fid_t  fid,
+                        mama_u32_t  value)
+{
+    ADD_SCALAR (MAMA_FIELD_TYPE_U32);
+}
+
+mama_status
+flatmsgPayload_addI64  (msgPayload  msg,
+                        const char* name,
+                        mama_fid_t  fid,
+                        mama_i64_t  value)
+{
+    ADD_SCALAR (MAMA_FIELD_TYPE_I64);
+}
+
+mama_status
+flatmsgPayload_addU64  (msgPayload  msg,
+                        const char* name,
+                        mama_fid_t  fid,
+                        mama_u64_t  value)
+{
+    ADD_SCALAR (MAMA_FIELD_TYPE_U64);
+}
+
+mama_status
+flatmsgPayload_addF32  (msgPayload  msg,
+                        const char* name,
+                        mama_fid_t  fid,
+                        mama_f32_t  value)
+{
+    ADD_SCALAR (MAMA_FIELD_TYPE_F32);
+}
+
+mama_status
+flatmsgPayload_addF64  (msgPayload  msg,
+                        const char* name,
+                        mama_fid_t  fid,
+                        mama_f64_t  value)
+{
+    ADD_SCALAR (MAMA_FIELD_TYPE_F64);
+}
+
+mama_status
+flatmsgPayload_addString (msgPayload  msg,
+                          const char* name,
+                          mama_fid_t  fid,
+                          const char* value)
+{
+    flatmsgPayloadImpl* impl = (flatmsgPayloadImpl*) msg;
+
+    if (NULL == impl || NULL == value || (NULL == name && 0 == fid))
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Stored with the terminator so getString can point into the buffer */
+    return flatmsgPayloadImpl_addField (impl, name, fid,
+                                        MAMA_FIELD_TYPE_STRING,
+                                        value, strlen (value) + 1, NULL);
+}
+
+mama_status
+flatmsgPayload_addOpaque (msgPayload  msg,
+                          const char* name,
+                          mama_fid_t  fid,
+                          const void* value,
+                          mama_size_t size)
+{
+    flatmsgPayloadImpl* impl = (flatmsgPayloadImpl*) msg;
+
+    if (NULL == impl || NULL == value || (NULL == name && 0 == fid))
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    return flatmsgPayloadImpl_addField (impl, name, fid,
+                                        MAMA_FIELD_TYPE_OPAQUE,
+                                        value, size, NULL);
+}
+
+mama_status
+flatmsgPayload_addDateTime (msgPayload          msg,
+                            const char*         name,
+                            mama_fid_t          fid,
+                            const mamaDateTime  value)
+{
+    flatmsgPayloadImpl* impl = (flatmsgPayloadImpl*) msg;
+    flatmsgDateTime     wire;
+
+    if (NULL == impl || NULL == value || (NULL == name && 0 == fid))
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    flatmsgPayloadImpl_encodeDateTime (value, &wire);
+
+    return flatmsgPayloadImpl_addField (impl, name, fid,
+                                        MAMA_FIELD_TYPE_TIME,
+                                        &wire, sizeof (wire), NULL);
+}
+
+mama_status
+flatmsgPayload_addPrice (msgPayload      msg,
+                         const char*     name,
+                         mama_fid_t      fid,
+                         const mamaPrice value)
+{
+    flatmsgPayloadImpl* impl = (flatmsgPayloadImpl*) msg;
+    flatmsgPrice        wire;
+
+    if (NULL == impl || NULL == value || (NULL == name && 0 == fid))
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    flatmsgPayloadImpl_encodePrice (value, &wire);
+
+    return flatmsgPayloadImpl_addField (impl, name, fid,
+                                        MAMA_FIELD_TYPE_PRICE,
+                                        &wire, sizeof (wire), NULL);
+}
+
+mama_status
+flatmsgPayload_addMsg (msgPayload  msg,
+                       const char* name,
+                       mama_fid_t  fid,
+                       msgPayload  value)
+{
+    flatmsgPayloadImpl* impl    = (flatmsgPayloadImpl*) msg;
+    flatmsgPayloadImpl* subImpl = (flatmsgPayloadImpl*) value;
+
+    if (NULL == impl || NULL == subImpl || (NULL == name && 0 == fid))
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* A sub message is simply its encoded buffer */
+    return flatmsgPayloadImpl_addField (impl, name, fid,
+                                        MAMA_FIELD_TYPE_MSG,
+                                        subImpl->mBuffer,
+                                        FLATMSG_ENCODED_SIZE (subImpl),
+                                        NULL);
+}
+
+/*=========================================================================
+  =                   Payload Add Vector Field Methods                    =
+  =========================================================================*/
+
+mama_status
+flatmsgPayload_addVectorBool (msgPayload          msg,
+                              const char*         name,
+                              mama_fid_t          fid,
+                              const mama_bool_t   value[],
+                              mama_size_t         size)
+{
+    ADD_VECTOR (MAMA_FIELD_TYPE_VECTOR_BOOL, mama_bool_t);
+}
+
+mama_status
+flatmsgPayload_addVectorChar (msgPayload          msg,
+                              const char*         name,
+                              mama_fid_t          fid,
+                              const char          value[],
+                              mama_size_t         size)
+{
+    ADD_VECTOR (MAMA_FIELD_TYPE_VECTOR_CHAR, char);
+}
+
+mama_status
+flatmsgPayload_addVectorI8   (msgPayload          msg,
+                              const char*         name,
+                              mama_fid_t          fid,
+                              const mama_i8_t     value[],
+                              mama_size_t         size)
+{
+    ADD_VECTOR (MAMA_FIELD_TYPE_VECTOR_I8, mama_i8_t);
+}
+
+mama_status
+flatmsgPayload_addVectorU8   (msgPayload          msg,
+                              const char*         name,
+                              mama_fid_t          fid,
+                              const mama_u8_t     value[],
+                              mama_size_t         size)
+{
+    ADD_VECTOR (MAMA_FIELD_TYPE_VECTOR_U8, mama_u8_t);
+}
+
+mama_status
+flatmsgPayload_addVectorI16  (msgPayload          msg,
+                              const char*         name,
+                              mama_fid_t          fid,
+                              const mama_i16_t    value[],
+                              mama_size_t         size)
+{
+    ADD_VECTOR (MAMA_FIELD_TYPE_VECTOR_I16, mama_i16_t);
+}
+
+mama_status
+flatmsgPayload_addVectorU16  (msgPayload          msg,
+                              const char*         name,
+                              mama_fid_t          fid,
+                              const mama_u16_t    value[],
+                              mama_size_t         size)
+{
+    ADD_VECTOR (MAMA_FIELD_TYPE_VECTOR_U16, mama_u16_t);
+}
+
+mama_status
+flatmsgPayload_addVectorI32  (msgPayload          msg,
+                              const char*         name,
+                              mama_fid_t          fid,
+                              const mama_i32_t    value[],
+                              mama_size_t         size)
+{
+    ADD_VECTOR (MAMA_FIELD_TYPE_VECTOR_I32, mama_i32_t);
+}
+
+mama_status
+flatmsgPayload_addVectorU32  (msgPayload          msg,
+                              const char*         name,
+                              mama_fid_t          fid,
+                              const mama_u32_t    value[],
+                              mama_size_t         size)
+{
+    ADD_VECTOR (MAMA_FIELD_TYPE_VECTOR_U32, mama_u32_t);
+}
+
+mama_status
+flatmsgPayload_addVectorI64  (msgPayload          msg,
+                              const char*         name,
+                              mama_fid_t          fid,
+                              const mama_i64_t    value[],
+                              mama_size_t         size)
+{
+    ADD_VECTOR (MAMA_FIELD_TYPE_VECTOR_I64, mama_i64_t);
+}
+
+mama_status
+flatmsgPayload_addVectorU64  (msgPayload          msg,
+                              const char*         name,
+                              mama_fid_t          fid,
+                              const mama_u64_t    value[],
+                              mama_size_t         size)
+{
+    ADD_VECTOR (MAMA_FIELD_TYPE_VECTOR_U64, mama_u64_t);
+}
+
+mama_status
+flatmsgPayload_addVectorF32  (msgPayload          msg,
+                              const char*         name,
+                              mama_fid_t          fid,
+                              const mama_f32_t    value[],
+                              mama_size_t         size)
+{
+    ADD_VECTOR (MAMA_FIELD_TYPE_VECTOR_F32, mama_f32_t);
+}
+
+mama_status
+flatmsgPayload_addVectorF64  (msgPayload          msg,
+                              const char*         name,
+                              mama_fid_t          fid,
+                              const mama_f64_t    value[],
+                              mama_size_t         size)
+{
+    ADD_VECTOR (MAMA_FIELD_TYPE_VECTOR_F64, mama_f64_t);
+}
+
+mama_status
+flatmsgPayload_addVectorString (msgPayload          msg,
+                                const char*         name,
+                                mama_fid_t          fid,
+                                const char*         value[],
+                                mama_size_t         size)
+{
+    flatmsgPayloadImpl* impl    = (flatmsgPayloadImpl*) msg;
+    mama_status         status  = MAMA_STATUS_OK;
+    void*               encoded = NULL;
+    mama_size_t         length  = 0;
+
+    if (NULL == impl || NULL == value || (NULL == name && 0 == fid))
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    status = flatmsgPayloadImpl_encodeVectorString (value, size,
+                                                    &encoded, &length);
+    if (MAMA_STATUS_OK != status)
+    {
+        return status;
+    }
+
+    status = flatmsgPayloadImpl_addField (impl, name, fid,
+                                          MAMA_FIELD_TYPE_VECTOR_STRING,
+                                          encoded, length, NULL);
+    free (encoded);
+
+    return status;
+}
+
+mama_status
+flatmsgPayload_addVectorMsg (msgPayload          msg,
+                             const char*         name,
+                             mama_fid_t          fid,
+                             const mamaMsg       value[],
+                             mama_size_t         size)
+{
+    flatmsgPayloadImpl* impl    = (flatmsgPayloadImpl*) msg;
+    mama_status         status  = MAMA_STATUS_OK;
+    void*               encoded = NULL;
+    mama_size_t         length  = 0;
+
+    if (NULL == impl || 0 == size || NULL == value
+            || (NULL == name && 0 == fid))
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    status = flatmsgPayloadImpl_encodeVectorMsg (value, size,
+                                                 &encoded, &length);
+    if (MAMA_STATUS_OK != status)
+    {
+        return status;
+    }
+
+    status = flatmsgPayloadImpl_addField (impl, name, fid,
+                                          MAMA_FIELD_TYPE_VECTOR_MSG,
+                                          encoded, length, NULL);
+    free (encoded);
+
+    return status;
+}
+
+/*
+ * Postponing implementation until this type of vectors has a standard protocol
+ * or is removed from the implementation
+ */
+mama_status
+flatmsgPayload_addVectorDateTime (msgPayload          msg,
+                                  const char*         name,
+                                  mama_fid_t          fid,
+                                  const mamaDateTime  value[],
+                                  mama_size_t         size)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+flatmsgPayload_addVectorPrice (msgPayload      msg,
+                               const char*     name,
+                               mama_fid_t      fid,
+                               const mamaPrice value[],
+                               mama_size_t     size)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+/*=========================================================================
+  =                  Payload Update Scalar Field Methods                  =
+  =========================================================================*/
+
+mama_status
+flatmsgPayload_updateBool   (msgPayload   msg,
+                             const char*  name,
+                             mama_fid_t   fid,
+                             mama_bool_t  value)
+{
+    UPDATE_SCALAR (MAMA_FIELD_TYPE_BOOL);
+}
+
+mama_status
+flatmsgPayload_updateChar   (msgPayload   msg,
+                             const char*  name,
+                             mama_fid_t   fid,
+                             char         value)
+{
+    UPDATE_SCALAR (MAMA_FIELD_TYPE_CHAR);
+}
+
+mama_status
+flatmsgPayload_updateI8     (msgPayload   msg,
+                             const char*  name,
+                             mama_fid_t   fid,
+                             mama_i8_t    value)
+{
+    UPDATE_SCALAR (MAMA_FIELD_TYPE_I8);
+}
+
+mama_status
+flatmsgPayload_updateU8     (msgPayload   msg,
+                             const char*  name,
+                             mama_fid_t   fid,
+                             mama_u8_t    value)
+{
+    UPDATE_SCALAR (MAMA_FIELD_TYPE_U8);
+}
+
+mama_status
+flatmsgPayload_updateI16    (msgPayload   msg,
+                             const char*  name,
+                             mama_fid_t   fid,
+                             mama_i16_t   value)
+{
+    UPDATE_SCALAR (MAMA_FIELD_TYPE_I16);
+}
+
+mama_status
+flatmsgPayload_updateU16    (msgPayload   msg,
+                             const char*  name,
+                             mama_fid_t   fid,
+                             mama_u16_t   value)
+{
+    UPDATE_SCALAR (MAMA_FIELD_TYPE_U16);
+}
+
+mama_status
+flatmsgPayload_updateI32    (msgPayload   msg,
+                             const char*  name,
+                             mama_fid_t   fid,
+                             mama_i32_t   value)
+{
+    UPDATE_SCALAR (MAMA_FIELD_TYPE_I32);
+}
+
+mama_status
+flatmsgPayload_updateU32    (msgPayload   msg,
+                             const char*  name,
+                             mama_fid_t   fid,
+                             mama_u32_t   value)
+{
+    UPDATE_SCALAR (MAMA_FIELD_TYPE_U32);
+}
+
+mama_status
+flatmsgPayload_updateI64    (msgPayload   msg,
+                             const char*  name,
+                             mama_fid_t   fid,
+                             mama_i64_t   value)
+{
+    UPDATE_SCALAR (MAMA_FIELD_TYPE_I64);
+}
+
+mama_status
+flatmsgPayload_updateU64    (msgPayload   msg,
+                             const char*  name,
+                             mama_fid_t   fid,
+                             mama_u64_t   value)
+{
+    UPDATE_SCALAR (MAMA_FIELD_TYPE_U64);
+}
+
+mama_status
+flatmsgPayload_updateF32    (msgPayload   msg,
+                             const char*  name,
+                             mama_fid_t   fid,
+                             mama_f32_t   value)
+{
+    UPDATE_SCALAR (MAMA_FIELD_TYPE_F32);
+}
+
+mama_status
+flatmsgPayload_updateF64    (msgPayload   msg,
+                             const char*  name,
+                             mama_fid_t   fid,
+                             mama_f64_t   value)
+{
+    UPDATE_SCALAR (MAMA_FIELD_TYPE_F64);
+}
+
+mama_status
+flatmsgPayload_updateString (msgPayload   msg,
+                             const char*  name,
+                             mama_fid_t   fid,
+                             const char*  value)
+{
+    flatmsgPayloadImpl* impl = (flatmsgPayloadImpl*) msg;
+
+    if (NULL == impl || NULL == value)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    return flatmsgPayloadImpl_updateField (impl, name, fid,
+                                           MAMA_FIELD_TYPE_STRING,
+                                           value, strlen (value) + 1, NULL);
+}
+
+mama_status
+flatmsgPayload_updateOpaque (msgPayload          msg,
+                             const char*         name,
+                             mama_fid_t          fid,
+                             const void*         value,
+                             mama_size_t         size)
+{
+    flatmsgPayloadImpl* impl = (flatmsgPayloadImpl*) msg;
+
+    if (NULL == impl || NULL == value)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    return flatmsgPayloadImpl_updateField (impl, name, fid,
+                                           MAMA_FIELD_TYPE_OPAQUE,
+                                           value, size, NULL);
+}
+
+mama_status
+flatmsgPayload_updateDateTime (msgPayload          msg,
+                               const char*         name,
+                               mama_fid_t          fid,
+                               const mamaDateTime  value)
+{
+    flatmsgPayloadImpl* impl = (flatmsgPayloadImpl*) msg;
+    flatmsgDateTime     wire;
+
+    if (NULL == impl || NULL == value)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    flatmsgPayloadImpl_encodeDateTime (value, &wire);
+
+    return flatmsgPayloadImpl_updateField (impl, name, fid,
+                                           MAMA_FIELD_TYPE_TIME,
+                                           &wire, sizeof (wire), NULL);
+}
+
+mama_status
+flatmsgPayload_updatePrice (msgPayload          msg,
+                            const char*         name,
+                            mama_fid_t          fid,
+                            const mamaPrice     value)
+{
+    flatmsgPayloadImpl* impl = (flatmsgPayloadImpl*) msg;
+    flatmsgPrice        wire;
+
+    if (NULL == impl || NULL == value)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    flatmsgPayloadImpl_encodePrice (value, &wire);
+
+    return flatmsgPayloadImpl_updateField (impl, name, fid,
+                                           MAMA_FIELD_TYPE_PRICE,
+                                           &wire, sizeof (wire), NULL);
+}
+
+mama_status
+flatmsgPayload_updateSubMsg (msgPayload          msg,
+                             const char*         fname,
+                             mama_fid_t          fid,
+                             const msgPayload    subMsg)
+{
+    flatmsgPayloadImpl* impl    = (flatmsgPayloadImpl*) msg;
+    flatmsgPayloadImpl* subImpl = (flatmsgPayloadImpl*) subMsg;
+
+    if (NULL == impl || NULL == subImpl)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    return flatmsgPayloadImpl_updateField (impl, fname, fid,
+                                           MAMA_FIELD_TYPE_MSG,
+                                           subImpl->mBuffer,
+                                           FLATMSG_ENCODED_SIZE (subImpl),
+                                           NULL);
+}
+
+/*=========================================================================
+  =                  Payload Update Vector Field Methods                  =
+  =========================================================================*/
+
+mama_status
+flatmsgPayload_updateVectorMsg (msgPayload          msg,
+                                const char*         fname,
+                                mama_fid_t          fid,
+                                const mamaMsg       value[],
+                                mama_size_t         size)
+{
+    flatmsgPayloadImpl* impl    = (flatmsgPayloadImpl*) msg;
+    mama_status         status  = MAMA_STATUS_OK;
+    void*               encoded = NULL;
+    mama_size_t         length  = 0;
+
+    if (NULL == impl || 0 == size || NULL == value
+            || (NULL == fname && 0 == fid))
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    status = flatmsgPayloadImpl_encodeVectorMsg (value, size,
+                                                 &encoded, &length);
+    if (MAMA_STATUS_OK != status)
+    {
+        return status;
+    }
+
+    status = flatmsgPayloadImpl_updateField (impl, fname, fid,
+                                             MAMA_FIELD_TYPE_VECTOR_MSG,
+                                             encoded, length, NULL);
+    free (encoded);
+
+    return status;
+}
+
+mama_status
+flatmsgPayload_updateVectorString (msgPayload   msg,
+                                   const char*  fname,
+                                   mama_fid_t   fid,
+                                   const char*  strList[],
+                                   mama_size_t  size)
+{
+    flatmsgPayloadImpl* impl    = (flatmsgPayloadImpl*) msg;
+    mama_status         status  = MAMA_STATUS_OK;
+    void*               encoded = NULL;
+    mama_size_t         length  = 0;
+
+    if (NULL == impl || NULL == strList || (NULL == fname && 0 == fid))
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    status = flatmsgPayloadImpl_encodeVectorString (strList, size,
+                                                    &encoded, &length);
+    if (MAMA_STATUS_OK != status)
+    {
+        return status;
+    }
+
+    status = flatmsgPayloadImpl_updateField (impl, fname, fid,
+                                             MAMA_FIELD_TYPE_VECTOR_STRING,
+                                             encoded, length, NULL);
+    free (encoded);
+
+    return status;
+}
+
+mama_status
+flatmsgPayload_updateVectorBool (msgPayload          msg,
+                                 const char*         fname,
+                                 mama_fid_t          fid,
+                                 const mama_bool_t   boolList[],
+                                 mama_size_t         size)
+{
+    UPDATE_VECTOR (MAMA_FIELD_TYPE_VECTOR_BOOL, mama_bool_t, boolList);
+}
+
+mama_status
+flatmsgPayload_updateVectorChar (msgPayload          msg,
+                                 const char*         fname,
+                                 mama_fid_t          fid,
+                                 const char          charList[],
+                                 mama_size_t         size)
+{
+    UPDATE_VECTOR (MAMA_FIELD_TYPE_VECTOR_CHAR, char, charList);
+}
+
+mama_status
+flatmsgPayload_updateVectorI8   (msgPayload          msg,
+                                 const char*         fname,
+                                 mama_fid_t          fid,
+                                 const mama_i8_t     i8List[],
+                                 mama_size_t         size)
+{
+    UPDATE_VECTOR (MAMA_FIELD_TYPE_VECTOR_I8, mama_i8_t, i8List);
+}
+
+mama_status
+flatmsgPayload_updateVectorU8   (msgPayload          msg,
+                                 const char*         fname,
+                                 mama_fid_t          fid,
+                                 const mama_u8_t     u8List[],
+                                 mama_size_t         size)
+{
+    UPDATE_VECTOR (MAMA_FIELD_TYPE_VECTOR_U8, mama_u8_t, u8List);
+}
+
+mama_status
+flatmsgPayload_updateVectorI16  (msgPayload          msg,
+                                 const char*         fname,
+                                 mama_fid_t          fid,
+                                 const mama_i16_t    i16List[],
+                                 mama_size_t         size)
+{
+    UPDATE_VECTOR (MAMA_FIELD_TYPE_VECTOR_I16, mama_i16_t, i16List);
+}
+
+mama_status
+flatmsgPayload_updateVectorU16  (msgPayload          msg,
+                                 const char*         fname,
+                                 mama_fid_t          fid,
+                                 const mama_u16_t    u16List[],
+                                 mama_size_t         size)
+{
+    UPDATE_VECTOR (MAMA_FIELD_TYPE_VECTOR_U16, mama_u16_t, u16List);
+}
+
+mama_status
+flatmsgPayload_updateVectorI32  (msgPayload          msg,
+                                 const char*         fname,
+                                 mama_fid_t          fid,
+                                 const mama_i32_t    i32List[],
+                                 mama_size_t         size)
+{
+    UPDATE_VECTOR (MAMA_FIELD_TYPE_VECTOR_I32, mama_i32_t, i32List);
+}
+
+mama_status
+flatmsgPayload_updateVectorU32  (msgPayload          msg,
+                                 const char*         fname,
+                                 mama_fid_t          fid,
+                                 const mama_u32_t    u32List[],
+                                 mama_size_t         size)
+{
+    UPDATE_VECTOR (MAMA_FIELD_TYPE_VECTOR_U32, mama_u32_t, u32List);
+}
+
+mama_status
+flatmsgPayload_updateVectorI64  (msgPayload          msg,
+                                 const char*         fname,
+                                 mama_fid_t          fid,
+                                 const mama_i64_t    i64List[],
+                                 mama_size_t         size)
+{
+    UPDATE_VECTOR (MAMA_FIELD_TYPE_VECTOR_I64, mama_i64_t, i64List);
+}
+
+mama_status
+flatmsgPayload_updateVectorU64  (msgPayload          msg,
+                                 const char*         fname,
+                                 mama_fid_t          fid,
+                                 const mama_u64_t    u64List[],
+                                 mama_size_t         size)
+{
+    UPDATE_VECTOR (MAMA_FIELD_TYPE_VECTOR_U64, mama_u64_t, u64List);
+}
+
+mama_status
+flatmsgPayload_updateVectorF32  (msgPayload          msg,
+                                 const char*         fname,
+                                 mama_fid_t          fid,
+                                 const mama_f32_t    f32List[],
+                                 mama_size_t         size)
+{
+    UPDATE_VECTOR (MAMA_FIELD_TYPE_VECTOR_F32, mama_f32_t, f32List);
+}
+
+mama_status
+flatmsgPayload_updateVectorF64  (msgPayload          msg,
+                                 const char*         fname,
+                                 mama_fid_t          fid,
+                                 const mama_f64_t    f64List[],
+                                 mama_size_t         size)
+{
+    UPDATE_VECTOR (MAMA_FIELD_TYPE_VECTOR_F64, mama_f64_t, f64List);
+}
+
+mama_status
+flatmsgPayload_updateVectorPrice (msgPayload          msg,
+                                  const char*         fname,
+                                  mama_fid_t          fid,
+                                  const mamaPrice*    priceList[],
+                                  mama_size_t         size)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+flatmsgPayload_updateVectorTime (msgPayload          msg,
+                                 const char*         fname,
+                                 mama_fid_t          fid,
+                                 const mamaDateTime  timeList[],
+                                 mama_size_t         size)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+/*=========================================================================
+  =                    Payload Get Scalar Field Methods                   =
+  =========================================================================*/
+
+mama_status
+flatmsgPayload_getBool (const msgPayload    msg,
+                        const char*         name,
+                        mama_fid_t          fid,
+                        mama_bool_t*        result)
+{
+    GET_SCALAR (mama_bool_t);
+}
+
+mama_status
+flatmsgPayload_getChar (const msgPayload    msg,
+                        const char*         name,
+                        mama_fid_t          fid,
+                        char*               result)
+{
+    GET_SCALAR (char);
+}
+
+mama_status
+flatmsgPayload_getI8   (const msgPayload    msg,
+                        const char*         name,
+                        mama_fid_t          fid,
+                        mama_i8_t*          result)
+{
+    GET_SCALAR (mama_i8_t);
+}
+
+mama_status
+flatmsgPayload_getU8   (const msgPayload    msg,
+                        const char*         name,
+                        mama_fid_t          fid,
+                        mama_u8_t*          result)
+{
+    GET_SCALAR (mama_u8_t);
+}
+
+mama_status
+flatmsgPayload_getI16  (const msgPayload    msg,
+                        const char*         name,
+                        mama_fid_t          fid,
+                        mama_i16_t*         result)
+{
+    GET_SCALAR (mama_i16_t);
+}
+
+mama_status
+flatmsgPayload_getU16  (const msgPayload    msg,
+                        const char*         name,
+                        mama_fid_t          fid,
+                        mama_u16_t*         result)
+{
+    GET_SCALAR (mama_u16_t);
+}
+
+mama_status
+flatmsgPayload_getI32  (const msgPayload    msg,
+                        const char*         name,
+                        mama_fid_t          fid,
+                        mama_i32_t*         result)
+{
+    GET_SCALAR (mama_i32_t);
+}
+
+mama_status
+flatmsgPayload_getU32  (const msgPayload    msg,
+                        const char*         name,
+                        mama_fid_t          fid,
+                        mama_u32_t*         result)
+{
+    GET_SCALAR (mama_u32_t);
+}
+
+mama_status
+flatmsgPayload_getI64  (const msgPayload    msg,
+                        const char*         name,
+                        mama_fid_t          fid,
+                        mama_i64_t*         result)
+{
+    GET_SCALAR (mama_i64_t);
+}
+
+mama_status
+flatmsgPayload_getU64  (const msgPayload    msg,
+                        const char*         name,
+                        mama_fid_t          fid,
+                        mama_u64_t*         result)
+{
+    GET_SCALAR (mama_u64_t);
+}
+
+mama_status
+flatmsgPayload_getF32  (const msgPayload    msg,
+                        const char*         name,
+                        mama_fid_t          fid,
+                        mama_f32_t*         result)
+{
+    GET_SCALAR (mama_f32_t);
+}
+
+mama_status
+flatmsgPayload_getF64  (const msgPayload    msg,
+                        const char*         name,
+                        mama_fid_t          fid,
+                        mama_f64_t*         result)
+{
+    GET_SCALAR (mama_f64_t);
+}
+
+mama_status
+flatmsgPayload_getString (const msgPayload    msg,
+                          const char*         name,
+                          mama_fid_t          fid,
+                          const char**        result)
+{
+    flatmsgPayloadImpl* impl   = (flatmsgPayloadImpl*) msg;
+    flatmsgFieldHeader* hdr    = NULL;
+    mama_status         status = MAMA_STATUS_OK;
+    mama_u32_t          offset = 0;
+
+    if (NULL == impl || NULL == result)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Find field */
+    status = flatmsgPayloadImpl_findField (impl, name, fid, &offset);
+    if (MAMA_STATUS_OK != status)
+    {
+        return status;
+    }
+
+    hdr = FLATMSG_FIELD (impl, offset);
+    if (MAMA_FIELD_TYPE_STRING != hdr->mType)
+    {
+        return MAMA_STATUS_WRONG_FIELD_TYPE;
+    }
+
+    *result = (const char*) FLATMSG_FIELD_VALUE (hdr);
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgPayload_getOpaque (const msgPayload    msg,
+                          const char*         name,
+                          mama_fid_t          fid,
+                          const void**        result,
+                          mama_size_t*        size)
+{
+    flatmsgPayloadImpl* impl   = (flatmsgPayloadImpl*) msg;
+    flatmsgFieldHeader* hdr    = NULL;
+    mama_status         status = MAMA_STATUS_OK;
+    mama_u32_t          offset = 0;
+
+    if (NULL == impl || NULL == result || NULL == size)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Find field */
+    status = flatmsgPayloadImpl_findField (impl, name, fid, &offset);
+    if (MAMA_STATUS_OK != status)
+    {
+        return status;
+    }
+
+    hdr = FLATMSG_FIELD (impl, offset);
+    if (MAMA_FIELD_TYPE_OPAQUE != hdr->mType)
+    {
+        return MAMA_STATUS_WRONG_FIELD_TYPE;
+    }
+
+    *result = FLATMSG_FIELD_VALUE (hdr);
+    *size   = hdr->mSize;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgPayload_getDateTime (const msgPayload    msg,
+                            const char*         name,
+                            mama_fid_t          fid,
+                            mamaDateTime        result)
+{
+    flatmsgPayloadImpl* impl   = (flatmsgPayloadImpl*) msg;
+    mama_status         status = MAMA_STATUS_OK;
+    mama_u32_t          offset = 0;
+
+    if (NULL == impl || NULL == result)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Find field */
+    status = flatmsgPayloadImpl_findField (impl, name, fid, &offset);
+    if (MAMA_STATUS_OK != status)
+    {
+        return status;
+    }
+
+    return flatmsgPayloadImpl_getDateTime (FLATMSG_FIELD (impl, offset),
+                                           result);
+}
+
+mama_status
+flatmsgPayload_getPrice (const msgPayload    msg,
+                         const char*         name,
+                         mama_fid_t          fid,
+                         mamaPrice           result)
+{
+    flatmsgPayloadImpl* impl   = (flatmsgPayloadImpl*) msg;
+    mama_status         status = MAMA_STATUS_OK;
+    mama_u32_t          offset = 0;
+
+    if (NULL == impl || NULL == result)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Find field */
+    status = flatmsgPayloadImpl_findField (impl, name, fid, &offset);
+    if (MAMA_STATUS_OK != status)
+    {
+        return status;
+    }
+
+    return flatmsgPayloadImpl_getPrice (FLATMSG_FIELD (impl, offset), result);
+}
+
+mama_status
+flatmsgPayload_getMsg (const msgPayload    msg,
+                       const char*         name,
+                       mama_fid_t          fid,
+                       msgPayload*         result)
+{
+    flatmsgPayloadImpl* impl   = (flatmsgPayloadImpl*) msg;
+    mama_status         status = MAMA_STATUS_OK;
+    mama_u32_t          offset = 0;
+
+    if (NULL == impl || NULL == result)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Find field */
+    status = flatmsgPayloadImpl_findField (impl, name, fid, &offset);
+    if (MAMA_STATUS_OK != status)
+    {
+        return status;
+    }
+
+    return flatmsgPayloadImpl_getMsg (impl, FLATMSG_FIELD (impl, offset),
+                                      result);
+}
+
+/*=========================================================================
+  =                    Payload Get Vector Field Methods                   =
+  =========================================================================*/
+
+mama_status
+flatmsgPayload_getVectorBool   (const msgPayload    msg,
+                                const char*         name,
+                                mama_fid_t          fid,
+                                const mama_bool_t** result,
+                                mama_size_t*        size)
+{
+    GET_VECTOR (MAMA_FIELD_TYPE_VECTOR_BOOL, mama_bool_t);
+}
+
+mama_status
+flatmsgPayload_getVectorChar   (const msgPayload    msg,
+                                const char*         name,
+                                mama_fid_t          fid,
+                                const char**        result,
+                                mama_size_t*        size)
+{
+    GET_VECTOR (MAMA_FIELD_TYPE_VECTOR_CHAR, char);
+}
+
+mama_status
+flatmsgPayload_getVectorI8     (const msgPayload    msg,
+                                const char*         name,
+                                mama_fid_t          fid,
+                                const mama_i8_t**   result,
+                                mama_size_t*        size)
+{
+    GET_VECTOR (MAMA_FIELD_TYPE_VECTOR_I8, mama_i8_t);
+}
+
+mama_status
+flatmsgPayload_getVectorU8     (const msgPayload    msg,
+                                const char*         name,
+                                mama_fid_t          fid,
+                                const mama_u8_t**   result,
+                                mama_size_t*        size)
+{
+    GET_VECTOR (MAMA_FIELD_TYPE_VECTOR_U8, mama_u8_t);
+}
+
+mama_status
+flatmsgPayload_getVectorI16    (const msgPayload    msg,
+                                const char*         name,
+                                mama_fid_t          fid,
+                                const mama_i16_t**  result,
+                                mama_size_t*        size)
+{
+    GET_VECTOR (MAMA_FIELD_TYPE_VECTOR_I16, mama_i16_t);
+}
+
+mama_status
+flatmsgPayload_getVectorU16    (const msgPayload    msg,
+                                const char*         name,
+                                mama_fid_t          fid,
+                                const mama_u16_t**  result,
+                                mama_size_t*        size)
+{
+    GET_VECTOR (MAMA_FIELD_TYPE_VECTOR_U16, mama_u16_t);
+}
+
+mama_status
+flatmsgPayload_getVectorI32    (const msgPayload    msg,
+                                const char*         name,
+                                mama_fid_t          fid,
+                                const mama_i32_t**  result,
+                                mama_size_t*        size)
+{
+    GET_VECTOR (MAMA_FIELD_TYPE_VECTOR_I32, mama_i32_t);
+}
+
+mama_status
+flatmsgPayload_getVectorU32    (const msgPayload    msg,
+                                const char*         name,
+                                mama_fid_t          fid,
+                                const mama_u32_t**  result,
+                                mama_size_t*        size)
+{
+    GET_VECTOR (MAMA_FIELD_TYPE_VECTOR_U32, mama_u32_t);
+}
+
+mama_status
+flatmsgPayload_getVectorI64    (const msgPayload    msg,
+                                const char*         name,
+                                mama_fid_t          fid,
+                                const mama_i64_t**  result,
+                                mama_size_t*        size)
+{
+    GET_VECTOR (MAMA_FIELD_TYPE_VECTOR_I64, mama_i64_t);
+}
+
+mama_status
+flatmsgPayload_getVectorU64    (const msgPayload    msg,
+                                const char*         name,
+                                mama_fid_t          fid,
+                                const mama_u64_t**  result,
+                                mama_size_t*        size)
+{
+    GET_VECTOR (MAMA_FIELD_TYPE_VECTOR_U64, mama_u64_t);
+}
+
+mama_status
+flatmsgPayload_getVectorF32    (const msgPayload    msg,
+                                const char*         name,
+                                mama_fid_t          fid,
+                                const mama_f32_t**  result,
+                                mama_size_t*        size)
+{
+    GET_VECTOR (MAMA_FIELD_TYPE_VECTOR_F32, mama_f32_t);
+}
+
+mama_status
+flatmsgPayload_getVectorF64    (const msgPayload    msg,
+                                const char*         name,
+                                mama_fid_t          fid,
+                                const mama_f64_t**  result,
+                                mama_size_t*        size)
+{
+    GET_VECTOR (MAMA_FIELD_TYPE_VECTOR_F64, mama_f64_t);
+}
+
+mama_status
+flatmsgPayload_getVectorString (const msgPayload    msg,
+                                const char*         name,
+                                mama_fid_t          fid,
+                                const char***       result,
+                                mama_size_t*        size)
+{
+    flatmsgPayloadImpl* impl   = (flatmsgPayloadImpl*) msg;
+    mama_status         status = MAMA_STATUS_OK;
+    mama_u32_t          offset = 0;
+
+    if (NULL == impl || NULL == result || NULL == size
+            || (NULL == name && 0 == fid))
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Find field */
+    status = flatmsgPayloadImpl_findField (impl, name, fid, &offset);
+    if (MAMA_STATUS_OK != status)
+    {
+        return status;
+    }
+
+    return flatmsgPayloadImpl_getVectorString (impl,
+                                               FLATMSG_FIELD (impl, offset),
+                                               result,
+                                               size);
+}
+
+mama_status
+flatmsgPayload_getVectorDateTime (const msgPayload    msg,
+                                  const char*         name,
+                                  mama_fid_t          fid,
+                                  const mamaDateTime* result,
+                                  mama_size_t*        size)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+flatmsgPayload_getVectorPrice (const msgPayload    msg,
+                               const char*         name,
+                               mama_fid_t          fid,
+                               const mamaPrice*    result,
+                               mama_size_t*        size)
+{
+    return MAMA_STATUS_NOT_IMPLEMENTED;
+}
+
+mama_status
+flatmsgPayload_getVectorMsg (const msgPayload    msg,
+                             const char*         name,
+                             mama_fid_t          fid,
+                             const msgPayload**  result,
+                             mama_size_t*        size)
+{
+    flatmsgPayloadImpl* impl   = (flatmsgPayloadImpl*) msg;
+    mama_status         status = MAMA_STATUS_OK;
+    mama_u32_t          offset = 0;
+
+    if (NULL == impl || NULL == result || NULL == size
+            || (NULL == name && 0 == fid))
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Find field */
+    status = flatmsgPayloadImpl_findField (impl, name, fid, &offset);
+    if (MAMA_STATUS_OK != status)
+    {
+        return status;
+    }
+
+    return flatmsgPayloadImpl_getVectorMsg (impl,
+                                            FLATMSG_FIELD (impl, offset),
+                                            result,
+                                            size);
+}
+
+mama_status
+flatmsgPayload_getField (const msgPayload    msg,
+                         const char*         name,
+                         mama_fid_t          fid,
+                         msgFieldPayload*    result)
+{
+    flatmsgPayloadImpl* impl   = (flatmsgPayloadImpl*) msg;
+    mama_status         status = MAMA_STATUS_OK;
+    mama_u32_t          offset = 0;
+
+    if (NULL == impl || NULL == result)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Find field */
+    status = flatmsgPayloadImpl_findField (impl, name, fid, &offset);
+    if (MAMA_STATUS_OK != status)
+    {
+        return status;
+    }
+
+    /* The reusable field is just a reference to the field within the buffer */
+    impl->mField->mParent = impl;
+    impl->mField->mOffset = offset;
+
+    *result = (msgFieldPayload) impl->mField;
+
+    return MAMA_STATUS_OK;
+}
+
+
+/*=========================================================================
+  =                   Public implementation functions                     =
+  =========================================================================*/
+
+mama_status
+flatmsgPayloadImpl_allocateBufferMemory (void**       buffer,
+                                         mama_size_t* size,
+                                         mama_size_t  newSize)
+{
+    void* newbuf = NULL;
+
+    if (NULL == buffer || NULL == size)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    if (0 == *size || NULL == *buffer)
+    {
+        newbuf = calloc (newSize, 1);
+
+        if (NULL == newbuf)
+        {
+            mama_log (MAMA_LOG_LEVEL_SEVERE,
+                      "flatmsgPayloadImpl_allocateBufferMemory(): "
+                      "Could not allocate memory for buffer of size [%lu]",
+                      (unsigned long) newSize);
+            return MAMA_STATUS_NOMEM;
+        }
+
+        *buffer = newbuf;
+        *size   = newSize;
+    }
+    else if (newSize > *size)
+    {
+        newbuf = realloc (*buffer, newSize);
+
+        if (NULL == newbuf)
+        {
+            mama_log (MAMA_LOG_LEVEL_SEVERE,
+                      "flatmsgPayloadImpl_allocateBufferMemory(): "
+                      "Could not reallocate memory for buffer of size [%lu] "
+                      "(was: %lu).",
+                      (unsigned long) newSize,
+                      (unsigned long) *size);
+            return MAMA_STATUS_NOMEM;
+        }
+
+        /* set newly added bytes to 0 */
+        memset ((mama_u8_t*) newbuf + *size, 0, newSize - *size);
+
+        *buffer = newbuf;
+        *size   = newSize;
+    }
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgPayloadImpl_findField (flatmsgPayloadImpl* impl,
+                              const char*         name,
+                              mama_fid_t          fid,
+                              mama_u32_t*         offset)
+{
+    flatmsgHeader*      header = FLATMSG_HEADER (impl);
+    flatmsgIndexEntry*  index  = FLATMSG_INDEX (impl);
+    flatmsgFieldHeader* hdr    = NULL;
+    const char*         found  = NULL;
+    mama_u32_t          low    = 0;
+    mama_u32_t          high   = header->mNumFields;
+    mama_u32_t          mid    = 0;
+    mama_u32_t          pos    = 0;
+
+    if (0 != fid)
+    {
+        /* Binary search for the first entry with this fid */
+        while (low < high)
+        {
+            mid = low + (high - low) / 2;
+            if (index[mid].mFid < fid)
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+
+        if (low < header->mNumFields && fid == index[low].mFid)
+        {
+            *offset = index[low].mOffset;
+            return MAMA_STATUS_OK;
+        }
+
+        return MAMA_STATUS_NOT_FOUND;
+    }
+    else if (NULL == name)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Names are not indexed so walk the fields in the order they were added */
+    while (pos < header->mDataSize)
+    {
+        hdr   = FLATMSG_FIELD (impl, pos);
+        found = FLATMSG_FIELD_NAME (hdr);
+
+        if (NULL != found && 0 == strcmp (name, found))
+        {
+            *offset = pos;
+            return MAMA_STATUS_OK;
+        }
+        pos += FLATMSG_FIELD_SPAN (hdr);
+    }
+
+    return MAMA_STATUS_NOT_FOUND;
+}
+
+mama_status
+flatmsgPayloadImpl_setFieldValue (flatmsgPayloadImpl* impl,
+                                  mama_u32_t          offset,
+                                  mamaFieldType       type,
+                                  const void*         value,
+                                  mama_size_t         size,
+                                  void**              dest)
+{
+    flatmsgHeader*      header  = NULL;
+    flatmsgFieldHeader* hdr     = FLATMSG_FIELD (impl, offset);
+    flatmsgIndexEntry*  index   = NULL;
+    mama_u8_t*          target  = NULL;
+    mama_u8_t*          tail    = NULL;
+    void*               copy    = NULL;
+    mama_size_t         oldSpan = FLATMSG_ALIGN (hdr->mSize);
+    mama_size_t         newSpan = FLATMSG_ALIGN (size);
+    mama_size_t         length  = 0;
+    mama_size_t         i       = 0;
+    mama_status         status  = MAMA_STATUS_OK;
+
+    if (size > 0xFFFFFFFF)
+    {
+        return MAMA_STATUS_INVALID_ARG;
+    }
+
+    /* Values are written in place, so a view must become our own copy */
+    status = flatmsgPayloadImpl_reserve (impl, FLATMSG_ENCODED_SIZE (impl));
+    if (MAMA_STATUS_OK != status)
+    {
+        return status;
+    }
+    hdr = FLATMSG_FIELD (impl, offset);
+
+    if (oldSpan != newSpan)
+    {
+        /* The value may be a view into this buffer, which is about to move */
+        if (NULL != value
+            && (const mama_u8_t*) value >= impl->mBuffer
+            && (const mama_u8_t*) value <  impl->mBuffer + impl->mBufferSize)
+        {
+            copy = malloc (size);
+            if (NULL == copy)
+            {
+                return MAMA_STATUS_NOMEM;
+            }
+            memcpy (copy, value, size);
+            value = copy;
+        }
+
+        if (newSpan > oldSpan)
+        {
+            status = flatmsgPayloadImpl_reserve (
+                        impl, FLATMSG_ENCODED_SIZE (impl) + newSpan - oldSpan);
+            if (MAMA_STATUS_OK != status)
+            {
+                free (copy);
+                return status;
+            }
+        }
+
+        header = FLATMSG_HEADER (impl);
+        hdr    = FLATMSG_FIELD (impl, offset);
+
+        /* Slide everything after the value, including the index, to suit */
+        tail   = FLATMSG_FIELD_VALUE (hdr) + oldSpan;
+        length = (impl->mBuffer + FLATMSG_ENCODED_SIZE (impl)) - tail;
+        memmove (FLATMSG_FIELD_VALUE (hdr) + newSpan, tail, length);
+
+        header->mDataSize = (mama_u32_t) (header->mDataSize - oldSpan + newSpan);
+
+        index = FLATMSG_INDEX (impl);
+        for (i = 0; i < header->mNumFields; i++)
+        {
+            if (index[i].mOffset > offset)
+            {
+                index[i].mOffset = (mama_u32_t) (index[i].mOffset - oldSpan
+                                                                  + newSpan);
+            }
+        }
+
+        /* Sub messages handed out may no longer line up with their fields */
+        for (i = 0; i < impl->mNestedCount; i++)
+        {
+            impl->mNestedOffsets[i] = FLATMSG_NO_OFFSET;
+        }
+    }
+
+    if (type != hdr->mType)
+    {
+        header = FLATMSG_HEADER (impl);
+        index  = FLATMSG_INDEX (impl);
+        hdr->mType = (mama_u8_t) type;
+
+        for (i = 0; i < header->mNumFields; i++)
+        {
+            if (index[i].mOffset == offset)
+            {
+                index[i].mType = (mama_u8_t) type;
+                break;
+            }
+        }
+    }
+
+    hdr->mSize = (mama_u32_t) size;
+    target     = FLATMSG_FIELD_VALUE (hdr);
+
+    if (NULL != value && 0 != size)
+    {
+        memmove (target, value, size);
+    }
+    memset (target + size, 0, newSpan - size);
+
+    if (NULL != dest)
+    {
+        *dest = target;
+    }
+
+    free (copy);
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgPayloadImpl_getVectorString (flatmsgPayloadImpl*       impl,
+                                    const flatmsgFieldHeader* hdr,
+                                    const char***             result,
+                                    mama_size_t*              size)
+{
+    const mama_u8_t* value  = FLATMSG_FIELD_VALUE (hdr);
+    const char*      str    = NULL;
+    const char**     temp   = NULL;
+    mama_u32_t       count  = 0;
+    mama_u32_t       i      = 0;
+    mama_status      status = MAMA_STATUS_OK;
+
+    if (MAMA_FIELD_TYPE_VECTOR_STRING != hdr->mType)
+    {
+        return MAMA_STATUS_WRONG_FIELD_TYPE;
+    }
+
+    /* Count, padding, then each terminated string back to back */
+    count = *(const mama_u32_t*) value;
+    str   = (const char*) value + 2 * sizeof (mama_u32_t);
+
+    status = flatmsgPayloadImpl_allocateBufferMemory (
+                &impl->mVectorBuffer,
+                &impl->mVectorBufferSize,
+                (count > 0 ? count : 1) * sizeof (const char*));
+    if (MAMA_STATUS_OK != status)
+    {
+        return status;
+    }
+
+    /* The array is reused but the strings themselves stay in the buffer */
+    temp = (const char**) impl->mVectorBuffer;
+    for (i = 0; i < count; i++)
+    {
+        temp[i] = str;
+        str    += strlen (str) + 1;
+    }
+
+    *result = temp;
+    *size   = count;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgPayloadImpl_getMsg (flatmsgPayloadImpl*       impl,
+                           const flatmsgFieldHeader* hdr,
+                           msgPayload*               result)
+{
+    flatmsgPayloadImpl* nested = NULL;
+    void*               grown  = NULL;
+    mama_u32_t          offset = 0;
+    mama_size_t         i      = 0;
+    mama_size_t         size   = 0;
+    mama_status         status = MAMA_STATUS_OK;
+
+    if (MAMA_FIELD_TYPE_MSG != hdr->mType)
+    {
+        return MAMA_STATUS_WRONG_FIELD_TYPE;
+    }
+
+    offset = (mama_u32_t) ((const mama_u8_t*) hdr - FLATMSG_DATA (impl));
+
+    /*
+     * Sub messages stay valid until the parent is cleared, as MAMA holds on
+     * to them, so reuse one only when it was for this same field.
+     */
+    for (i = 0; i < impl->mNestedCount; i++)
+    {
+        if (offset == impl->mNestedOffsets[i])
+        {
+            nested = impl->mNested[i];
+            break;
+        }
+    }
+
+    if (NULL == nested)
+    {
+        if (impl->mNestedCount == impl->mNestedSize)
+        {
+            size = 0 == impl->mNestedSize ? 4 : impl->mNestedSize * 2;
+
+            grown = realloc (impl->mNested,
+                             size * sizeof (flatmsgPayloadImpl*));
+            if (NULL == grown)
+            {
+                return MAMA_STATUS_NOMEM;
+            }
+            impl->mNested = (flatmsgPayloadImpl**) grown;
+            memset (impl->mNested + impl->mNestedSize, 0,
+                    (size - impl->mNestedSize) * sizeof (flatmsgPayloadImpl*));
+
+            grown = realloc (impl->mNestedOffsets, size * sizeof (mama_u32_t));
+            if (NULL == grown)
+            {
+                return MAMA_STATUS_NOMEM;
+            }
+            impl->mNestedOffsets = (mama_u32_t*) grown;
+            impl->mNestedSize    = size;
+        }
+
+        /* Payloads left from before the last clear are reused */
+        if (NULL == impl->mNested[impl->mNestedCount])
+        {
+            status = flatmsgPayloadImpl_createImplementationOnly (
+                        &impl->mNested[impl->mNestedCount]);
+            if (MAMA_STATUS_OK != status)
+            {
+                return status;
+            }
+        }
+
+        nested = impl->mNested[impl->mNestedCount];
+        impl->mNestedOffsets[impl->mNestedCount] = offset;
+        impl->mNestedCount++;
+    }
+
+    /* A view of the parent, which owns the field until it is changed */
+    status = flatmsgPayloadImpl_wrap (nested,
+                                      FLATMSG_FIELD_VALUE (hdr),
+                                      hdr->mSize);
+    if (MAMA_STATUS_OK != status)
+    {
+        return status;
+    }
+
+    *result = (msgPayload) nested;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgPayloadImpl_getVectorMsg (flatmsgPayloadImpl*       impl,
+                                 const flatmsgFieldHeader* hdr,
+                                 const msgPayload**        result,
+                                 mama_size_t*              size)
+{
+    const mama_u8_t*     value  = FLATMSG_FIELD_VALUE (hdr);
+    flatmsgPayloadImpl** pool   = NULL;
+    mama_u32_t           count  = 0;
+    mama_u32_t           length = 0;
+    mama_u32_t           i      = 0;
+    mama_status          status = MAMA_STATUS_OK;
+
+    if (MAMA_FIELD_TYPE_VECTOR_MSG != hdr->mType)
+    {
+        return MAMA_STATUS_WRONG_FIELD_TYPE;
+    }
+
+    count  = *(const mama_u32_t*) value;
+    value += 2 * sizeof (mama_u32_t);
+
+    if (count > impl->mNestedVectorSize)
+    {
+        pool = (flatmsgPayloadImpl**) realloc (
+                    impl->mNestedVector, count * sizeof (flatmsgPayloadImpl*));
+        if (NULL == pool)
+        {
+            return MAMA_STATUS_NOMEM;
+        }
+        memset (pool + impl->mNestedVectorSize, 0,
+                (count - impl->mNestedVectorSize) * sizeof (flatmsgPayloadImpl*));
+
+        impl->mNestedVector     = pool;
+        impl->mNestedVectorSize = count;
+    }
+
+    /* Each message is its length, padding, then its padded encoded buffer */
+    for (i = 0; i < count; i++)
+    {
+        length = *(const mama_u32_t*) value;
+        value += 2 * sizeof (mama_u32_t);
+
+        if (NULL == impl->mNestedVector[i])
+        {
+            status = flatmsgPayloadImpl_createImplementationOnly (
+                        &impl->mNestedVector[i]);
+            if (MAMA_STATUS_OK != status)
+            {
+                return status;
+            }
+        }
+
+        status = flatmsgPayloadImpl_wrap (impl->mNestedVector[i],
+                                          value,
+                                          length);
+        if (MAMA_STATUS_OK != status)
+        {
+            return status;
+        }
+
+        value += FLATMSG_ALIGN (length);
+    }
+
+    *result = (const msgPayload*) impl->mNestedVector;
+    *size   = count;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgPayloadImpl_getDateTime (const flatmsgFieldHeader* hdr,
+                                mamaDateTime              result)
+{
+    const void* value = FLATMSG_FIELD_VALUE (hdr);
+
+    switch (hdr->mType)
+    {
+    case MAMA_FIELD_TYPE_TIME:
+    {
+        const flatmsgDateTime* wire = (const flatmsgDateTime*) value;
+
+        mamaDateTimeImpl_copy (*result, wire->mTime);
+        mamaDateTimeImpl_setNanoSeconds (result, wire->mNanoseconds);
+        return MAMA_STATUS_OK;
+    }
+    case MAMA_FIELD_TYPE_STRING:
+        return mamaDateTime_setFromString (result, (const char*) value);
+    case MAMA_FIELD_TYPE_F64:
+        return mamaDateTime_setEpochTimeF64 (result,
+                                             *(const mama_f64_t*) value);
+    case MAMA_FIELD_TYPE_I64:
+        return mamaDateTime_setEpochTimeMilliseconds (
+                    result, (mama_u64_t) *(const mama_i64_t*) value);
+    case MAMA_FIELD_TYPE_U64:
+        return mamaDateTime_setEpochTimeMicroseconds (
+                    result, *(const mama_u64_t*) value);
+    default:
+        return MAMA_STATUS_WRONG_FIELD_TYPE;
+    }
+}
+
+mama_status
+flatmsgPayloadImpl_getPrice (const flatmsgFieldHeader* hdr,
+                             mamaPrice                 result)
+{
+    const void* value = FLATMSG_FIELD_VALUE (hdr);
+
+    switch (hdr->mType)
+    {
+    case MAMA_FIELD_TYPE_PRICE:
+    {
+        const flatmsgPrice* wire = (const flatmsgPrice*) value;
+
+        mamaPrice_setValue (result, wire->mValue);
+        mamaPrice_setHints (result, (mamaPriceHints) wire->mHints);
+        return MAMA_STATUS_OK;
+    }
+    case MAMA_FIELD_TYPE_F64:
+        return mamaPrice_setValue (result, *(const mama_f64_t*) value);
+    default:
+        return MAMA_STATUS_WRONG_FIELD_TYPE;
+    }
+}
+
+mama_size_t
+flatmsgPayloadImpl_fieldToString (const flatmsgFieldHeader* hdr,
+                                  char*                     buffer,
+                                  mama_size_t               len)
+{
+    const mama_u8_t* value   = FLATMSG_FIELD_VALUE (hdr);
+    mama_size_t      written = 0;
+
+    if (0 == len)
+    {
+        return 0;
+    }
+    buffer[0] = '\0';
+
+    switch (hdr->mType)
+    {
+    case MAMA_FIELD_TYPE_BOOL:
+        PRINT_SCALAR (mama_bool_t, "%u", unsigned);
+        break;
+    case MAMA_FIELD_TYPE_CHAR:
+        PRINT_SCALAR (char, "%c", char);
+        break;
+    case MAMA_FIELD_TYPE_I8:
+        PRINT_SCALAR (mama_i8_t, "%d", int);
+        break;
+    case MAMA_FIELD_TYPE_U8:
+        PRINT_SCALAR (mama_u8_t, "%u", unsigned);
+        break;
+    case MAMA_FIELD_TYPE_I16:
+        PRINT_SCALAR (mama_i16_t, "%d", int);
+        break;
+    case MAMA_FIELD_TYPE_U16:
+        PRINT_SCALAR (mama_u16_t, "%u", unsigned);
+        break;
+    case MAMA_FIELD_TYPE_I32:
+        PRINT_SCALAR (mama_i32_t, "%d", int);
+        break;
+    case MAMA_FIELD_TYPE_U32:
+        PRINT_SCALAR (mama_u32_t, "%u", unsigned);
+        break;
+    case MAMA_FIELD_TYPE_I64:
+        PRINT_SCALAR (mama_i64_t, "%lld", long long);
+        break;
+    case MAMA_FIELD_TYPE_U64:
+        PRINT_SCALAR (mama_u64_t, "%llu", long long unsigned);
+        break;
+    case MAMA_FIELD_TYPE_F32:
+        PRINT_SCALAR (mama_f32_t, "%f", double);
+        break;
+    case MAMA_FIELD_TYPE_F64:
+        PRINT_SCALAR (mama_f64_t, "%f", double);
+        break;
+    case MAMA_FIELD_TYPE_STRING:
+        flatmsgPayloadImpl_append (buffer, len, &written, "%s",
+                                   (const char*) value);
+        break;
+    case MAMA_FIELD_TYPE_TIME:
+    {
+        mamaDateTime dateTime = NULL;
+        char         dateTimeString[56];
+
+        mamaDateTime_create (&dateTime);
+        flatmsgPayloadImpl_getDateTime (hdr, dateTime);
+        mamaDateTime_getAsString (dateTime, dateTimeString, 56);
+        flatmsgPayloadImpl_append (buffer, len, &written, "%s",
+                                   dateTimeString);
+        mamaDateTime_destroy (dateTime);
+        break;
+    }
+    case MAMA_FIELD_TYPE_PRICE:
+    {
+        mamaPrice price = NULL;
+        char      priceString[56];
+
+        mamaPrice_create (&price);
+        flatmsgPayloadImpl_getPrice (hdr, price);
+        mamaPrice_getAsString (price, priceString, 56);
+        flatmsgPayloadImpl_append (buffer, len, &written, "%s", priceString);
+        mamaPrice_destroy (price);
+        break;
+    }
+    case MAMA_FIELD_TYPE_OPAQUE:
+    {
+        mama_size_t i = 0;
+
+        for (i = 0; i < hdr->mSize; i++)
+        {
+            flatmsgPayloadImpl_append (buffer, len, &written,
+                                       0 == i ? "%#x" : " %#x",
+                                       (unsigned) value[i]);
+        }
+        break;
+    }
+    case MAMA_FIELD_TYPE_VECTOR_BOOL:
+        PRINT_VECTOR (mama_bool_t, "%u", unsigned);
+        break;
+    case MAMA_FIELD_TYPE_VECTOR_CHAR:
+        PRINT_VECTOR (char, "%c", char);
+        break;
+    case MAMA_FIELD_TYPE_VECTOR_I8:
+        PRINT_VECTOR (mama_i8_t, "%d", int);
+        break;
+    case MAMA_FIELD_TYPE_VECTOR_U8:
+        PRINT_VECTOR (mama_u8_t, "%u", unsigned);
+        break;
+    case MAMA_FIELD_TYPE_VECTOR_I16:
+        PRINT_VECTOR (mama_i16_t, "%d", int);
+        break;
+    case MAMA_FIELD_TYPE_VECTOR_U16:
+        PRINT_VECTOR (mama_u16_t, "%u", unsigned);
+        break;
+    case MAMA_FIELD_TYPE_VECTOR_I32:
+        PRINT_VECTOR (mama_i32_t, "%d", int);
+        break;
+    case MAMA_FIELD_TYPE_VECTOR_U32:
+        PRINT_VECTOR (mama_u32_t, "%u", unsigned);
+        break;
+    case MAMA_FIELD_TYPE_VECTOR_I64:
+        PRINT_VECTOR (mama_i64_t, "%lld", long long);
+        break;
+    case MAMA_FIELD_TYPE_VECTOR_U64:
+        PRINT_VECTOR (mama_u64_t, "%llu", long long unsigned);
+        break;
+    case MAMA_FIELD_TYPE_VECTOR_F32:
+        PRINT_VECTOR (mama_f32_t, "%f", double);
+        break;
+    case MAMA_FIELD_TYPE_VECTOR_F64:
+        PRINT_VECTOR (mama_f64_t, "%f", double);
+        break;
+    case MAMA_FIELD_TYPE_VECTOR_STRING:
+    {
+        const char* str   = (const char*) value + 2 * sizeof (mama_u32_t);
+        mama_u32_t  count = *(const mama_u32_t*) value;
+        mama_u32_t  i     = 0;
+
+        flatmsgPayloadImpl_append (buffer, len, &written, "{");
+        for (i = 0; i < count; i++)
+        {
+            flatmsgPayloadImpl_append (buffer, len, &written,
+                                       0 == i ? "%s" : ",%s", str);
+            str += strlen (str) + 1;
+        }
+        flatmsgPayloadImpl_append (buffer, len, &written, "}");
+        break;
+    }
+    case MAMA_FIELD_TYPE_MSG:
+    case MAMA_FIELD_TYPE_VECTOR_MSG:
+    case MAMA_FIELD_TYPE_VECTOR_TIME:
+    case MAMA_FIELD_TYPE_VECTOR_PRICE:
+        flatmsgPayloadImpl_append (buffer, len, &written, "{...}");
+        break;
+    default:
+        flatmsgPayloadImpl_append (buffer, len, &written, "Unknown");
+        break;
+    }
+
+    return written;
+}
+
+void
+flatmsgPayloadImpl_encodeDateTime (const mamaDateTime value,
+                                   flatmsgDateTime*   result)
+{
+    result->mTime        = mamaDateTimeImpl_getWireValue (*value);
+    result->mNanoseconds = mamaDateTimeImpl_getNanoSeconds (value);
+    result->mReserved    = 0;
+}
+
+void
+flatmsgPayloadImpl_encodePrice (const mamaPrice value,
+                                flatmsgPrice*   result)
+{
+    mamaPriceHints hints = 0;
+
+    memset (result, 0, sizeof (flatmsgPrice));
+
+    mamaPrice_getValue (value, &result->mValue);
+    mamaPrice_getHints (value, &hints);
+    result->mHints = (mama_u8_t) hints;
+}
+
+
+/*=========================================================================
+  =                  Private implementation functions                     =
+  =========================================================================*/
+
+static mama_u8_t
+flatmsgPayloadImpl_hostByteOrder (void)
+{
+    const mama_u16_t probe = 1;
+
+    return 1 == *(const mama_u8_t*) &probe ? FLATMSG_BYTE_ORDER_LITTLE
+                                           : FLATMSG_BYTE_ORDER_BIG;
+}
+
+mama_status
+flatmsgPayloadImpl_createImplementationOnly (flatmsgPayloadImpl** msg)
+{
+    flatmsgPayloadImpl* impl   = NULL;
+    mama_status         status = MAMA_STATUS_OK;
+
+    impl = (flatmsgPayloadImpl*) calloc (1, sizeof (flatmsgPayloadImpl));
+    if (NULL == impl)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "flatmsgPayloadImpl_createImplementationOnly(): "
+                  "Could not allocate memory for payload.");
+        return MAMA_STATUS_NOMEM;
+    }
+
+    status = flatmsgPayloadImpl_allocateBufferMemory (
+                (void**) &impl->mStorage,
+                &impl->mStorageSize,
+                FLATMSG_INITIAL_BUFFER_SIZE);
+    if (MAMA_STATUS_OK != status)
+    {
+        free (impl);
+        return status;
+    }
+
+    status = flatmsgFieldPayload_create ((msgFieldPayload*) &impl->mField);
+    if (MAMA_STATUS_OK != status)
+    {
+        free (impl->mStorage);
+        free (impl);
+        return status;
+    }
+
+    flatmsgPayloadImpl_reset (impl);
+
+    *msg = impl;
+
+    return MAMA_STATUS_OK;
+}
+
+void
+flatmsgPayloadImpl_reset (flatmsgPayloadImpl* impl)
+{
+    flatmsgHeader* header = NULL;
+
+    /* Any view is simply dropped as none of it is kept */
+    impl->mBuffer        = impl->mStorage;
+    impl->mBufferSize    = impl->mStorageSize;
+
+    header = FLATMSG_HEADER (impl);
+    memset (header, 0, sizeof (flatmsgHeader));
+    header->mPayloadType = (mama_u8_t) MAMA_PAYLOAD_FLAT;
+    header->mVersion     = FLATMSG_VERSION;
+    header->mByteOrder   = flatmsgPayloadImpl_hostByteOrder ();
+
+    impl->mNestedCount   = 0;
+}
+
+mama_status
+flatmsgPayloadImpl_reserve (flatmsgPayloadImpl* impl,
+                            mama_size_t         required)
+{
+    const mama_u8_t* view    = NULL;
+    mama_size_t      newSize = impl->mStorageSize * 2;
+    mama_status      status  = MAMA_STATUS_OK;
+
+    if (impl->mBuffer == impl->mStorage)
+    {
+        if (required <= impl->mStorageSize)
+        {
+            return MAMA_STATUS_OK;
+        }
+    }
+    else
+    {
+        /* Copy on write - the view must survive growing the storage */
+        view = impl->mBuffer;
+        if (required < impl->mBufferSize)
+        {
+            required = impl->mBufferSize;
+        }
+    }
+
+    if (required > impl->mStorageSize)
+    {
+        if (newSize < required)
+        {
+            newSize = required;
+        }
+
+        status = flatmsgPayloadImpl_allocateBufferMemory (
+                    (void**) &impl->mStorage,
+                    &impl->mStorageSize,
+                    newSize);
+        if (MAMA_STATUS_OK != status)
+        {
+            return status;
+        }
+    }
+
+    if (NULL != view)
+    {
+        memcpy (impl->mStorage, view, impl->mBufferSize);
+    }
+
+    impl->mBuffer     = impl->mStorage;
+    impl->mBufferSize = impl->mStorageSize;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgPayloadImpl_validateHeader (const void*  buffer,
+                                   mama_size_t  length,
+                                   mama_size_t* size)
+{
+    flatmsgHeader header;
+    mama_size_t   remaining = 0;
+
+    if (length < sizeof (flatmsgHeader))
+    {
+        return MAMA_STATUS_INVALID_ARG;
+    }
+
+    /* Middleware buffers need not be aligned so copy the header out */
+    memcpy (&header, buffer, sizeof (flatmsgHeader));
+
+    if ((mama_u8_t) MAMA_PAYLOAD_FLAT != header.mPayloadType
+        || FLATMSG_VERSION != header.mVersion)
+    {
+        mama_log (MAMA_LOG_LEVEL_FINE, "flatmsgPayloadImpl_validateHeader(): "
+                  "Buffer is not a version %d flat message.",
+                  FLATMSG_VERSION);
+        return MAMA_STATUS_INVALID_ARG;
+    }
+
+    /* Values are handed out as direct views so must be in host order */
+    if (flatmsgPayloadImpl_hostByteOrder () != header.mByteOrder)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR, "flatmsgPayloadImpl_validateHeader(): "
+                  "Cannot decode flat message encoded with a different "
+                  "byte order.");
+        return MAMA_STATUS_INVALID_ARG;
+    }
+
+    /* Checked piece by piece so that a corrupt count cannot overflow */
+    remaining = length - sizeof (flatmsgHeader);
+    if (header.mDataSize > remaining
+        || header.mNumFields > (remaining - header.mDataSize)
+                                    / sizeof (flatmsgIndexEntry))
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR, "flatmsgPayloadImpl_validateHeader(): "
+                  "Flat message of %u fields in %u bytes is truncated to %lu "
+                  "bytes.",
+                  header.mNumFields, header.mDataSize, (unsigned long) length);
+        return MAMA_STATUS_INVALID_ARG;
+    }
+
+    *size = sizeof (flatmsgHeader) + (mama_size_t) header.mDataSize
+          + (mama_size_t) header.mNumFields * sizeof (flatmsgIndexEntry);
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgPayloadImpl_validate (const mama_u8_t* buffer)
+{
+    const flatmsgHeader*     header = (const flatmsgHeader*) buffer;
+    const mama_u8_t*         data   = buffer + sizeof (flatmsgHeader);
+    const flatmsgIndexEntry* index  = NULL;
+    const flatmsgFieldHeader* hdr   = NULL;
+    mama_u32_t               pos    = 0;
+    mama_u32_t               count  = 0;
+    mama_u32_t               i      = 0;
+    mama_status              status = MAMA_STATUS_OK;
+
+    /* Keeps every field header, value and the index naturally aligned */
+    if (0 != header->mDataSize % 8)
+    {
+        return MAMA_STATUS_INVALID_ARG;
+    }
+
+    /* The iterator and lookups by name walk the data region in order */
+    while (pos < header->mDataSize)
+    {
+        status = flatmsgPayloadImpl_validateField (data, header->mDataSize,
+                                                   pos);
+        if (MAMA_STATUS_OK != status)
+        {
+            mama_log (MAMA_LOG_LEVEL_ERROR, "flatmsgPayloadImpl_validate(): "
+                      "Flat message field at offset %u is corrupt.", pos);
+            return status;
+        }
+
+        hdr  = (const flatmsgFieldHeader*) (data + pos);
+        pos += (mama_u32_t) FLATMSG_FIELD_SPAN (hdr);
+        count++;
+    }
+
+    if (count != header->mNumFields)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR, "flatmsgPayloadImpl_validate(): "
+                  "Flat message has %u fields but %u index entries.",
+                  count, header->mNumFields);
+        return MAMA_STATUS_INVALID_ARG;
+    }
+
+    /*
+     * Lookups by fid go through the index, so each entry must be in order
+     * and describe a valid field of its own.
+     */
+    index = (const flatmsgIndexEntry*) (data + header->mDataSize);
+    for (i = 0; i < header->mNumFields; i++)
+    {
+        if ((i > 0 && index[i].mFid < index[i - 1].mFid)
+            || 0 != index[i].mOffset % 8
+            || MAMA_STATUS_OK != flatmsgPayloadImpl_validateField (
+                                    data, header->mDataSize, index[i].mOffset))
+        {
+            mama_log (MAMA_LOG_LEVEL_ERROR, "flatmsgPayloadImpl_validate(): "
+                      "Flat message index entry %u is corrupt.", i);
+            return MAMA_STATUS_INVALID_ARG;
+        }
+
+        hdr = (const flatmsgFieldHeader*) (data + index[i].mOffset);
+        if (hdr->mFid != index[i].mFid || hdr->mType != index[i].mType)
+        {
+            mama_log (MAMA_LOG_LEVEL_ERROR, "flatmsgPayloadImpl_validate(): "
+                      "Flat message index entry %u does not match its field.",
+                      i);
+            return MAMA_STATUS_INVALID_ARG;
+        }
+    }
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgPayloadImpl_validateField (const mama_u8_t* data,
+                                  mama_u32_t       dataSize,
+                                  mama_u32_t       offset)
+{
+    const flatmsgFieldHeader* hdr       = NULL;
+    const mama_u8_t*          value     = NULL;
+    mama_size_t               remaining = 0;
+    mama_size_t               minimum   = 0;
+    mama_u32_t                count     = 0;
+    mama_u32_t                length    = 0;
+    mama_u32_t                pos       = 0;
+
+    /* Sizes are checked against what remains before any span is added up */
+    if (offset >= dataSize
+        || dataSize - offset < sizeof (flatmsgFieldHeader))
+    {
+        return MAMA_STATUS_INVALID_ARG;
+    }
+    hdr       = (const flatmsgFieldHeader*) (data + offset);
+    remaining = dataSize - offset - sizeof (flatmsgFieldHeader);
+
+    if (FLATMSG_ALIGN (hdr->mNameLength) > remaining)
+    {
+        return MAMA_STATUS_INVALID_ARG;
+    }
+    remaining -= FLATMSG_ALIGN (hdr->mNameLength);
+
+    if (0 != hdr->mNameLength
+        && '\0' != ((const char*) (hdr + 1))[hdr->mNameLength - 1])
+    {
+        return MAMA_STATUS_INVALID_ARG;
+    }
+
+    if (hdr->mSize > remaining || FLATMSG_ALIGN (hdr->mSize) > remaining)
+    {
+        return MAMA_STATUS_INVALID_ARG;
+    }
+    value = FLATMSG_FIELD_VALUE (hdr);
+
+    switch (hdr->mType)
+    {
+    case MAMA_FIELD_TYPE_BOOL:      minimum = sizeof (mama_bool_t);     break;
+    case MAMA_FIELD_TYPE_CHAR:      minimum = sizeof (char);            break;
+    case MAMA_FIELD_TYPE_I8:        minimum = sizeof (mama_i8_t);       break;
+    case MAMA_FIELD_TYPE_U8:        minimum = sizeof (mama_u8_t);       break;
+    case MAMA_FIELD_TYPE_I16:       minimum = sizeof (mama_i16_t);      break;
+    case MAMA_FIELD_TYPE_U16:       minimum = sizeof (mama_u16_t);      break;
+    case MAMA_FIELD_TYPE_I32:       minimum = sizeof (mama_i32_t);      break;
+    case MAMA_FIELD_TYPE_U32:       minimum = sizeof (mama_u32_t);      break;
+    case MAMA_FIELD_TYPE_I64:       minimum = sizeof (mama_i64_t);      break;
+    case MAMA_FIELD_TYPE_U64:       minimum = sizeof (mama_u64_t);      break;
+    case MAMA_FIELD_TYPE_F32:       minimum = sizeof (mama_f32_t);      break;
+    case MAMA_FIELD_TYPE_F64:       minimum = sizeof (mama_f64_t);      break;
+    case MAMA_FIELD_TYPE_TIME:      minimum = sizeof (flatmsgDateTime); break;
+    case MAMA_FIELD_TYPE_PRICE:     minimum = sizeof (flatmsgPrice);    break;
+    case MAMA_FIELD_TYPE_OPAQUE:
+    case MAMA_FIELD_TYPE_MSG:
+    case MAMA_FIELD_TYPE_VECTOR_BOOL:
+    case MAMA_FIELD_TYPE_VECTOR_CHAR:
+    case MAMA_FIELD_TYPE_VECTOR_I8:
+    case MAMA_FIELD_TYPE_VECTOR_U8:
+    case MAMA_FIELD_TYPE_VECTOR_I16:
+    case MAMA_FIELD_TYPE_VECTOR_U16:
+    case MAMA_FIELD_TYPE_VECTOR_I32:
+    case MAMA_FIELD_TYPE_VECTOR_U32:
+    case MAMA_FIELD_TYPE_VECTOR_I64:
+    case MAMA_FIELD_TYPE_VECTOR_U64:
+    case MAMA_FIELD_TYPE_VECTOR_F32:
+    case MAMA_FIELD_TYPE_VECTOR_F64:
+    case MAMA_FIELD_TYPE_VECTOR_TIME:
+    case MAMA_FIELD_TYPE_VECTOR_PRICE:
+        /* Sub messages are validated when they are decoded */
+        return MAMA_STATUS_OK;
+    case MAMA_FIELD_TYPE_STRING:
+        /* getString hands out the value so it must hold the terminator */
+        if (0 == hdr->mSize || '\0' != value[hdr->mSize - 1])
+        {
+            return MAMA_STATUS_INVALID_ARG;
+        }
+        return MAMA_STATUS_OK;
+    case MAMA_FIELD_TYPE_VECTOR_STRING:
+        /* Count, padding, then each terminated string back to back */
+        if (hdr->mSize < 2 * sizeof (mama_u32_t))
+        {
+            return MAMA_STATUS_INVALID_ARG;
+        }
+        count = *(const mama_u32_t*) value;
+        pos   = 2 * sizeof (mama_u32_t);
+        while (count-- > 0)
+        {
+            const mama_u8_t* end = (const mama_u8_t*) memchr (
+                                        value + pos, '\0', hdr->mSize - pos);
+            if (NULL == end)
+            {
+                return MAMA_STATUS_INVALID_ARG;
+            }
+            pos = (mama_u32_t) (end - value) + 1;
+        }
+        return MAMA_STATUS_OK;
+    case MAMA_FIELD_TYPE_VECTOR_MSG:
+        /* Count, padding, then each length, padding and padded message */
+        if (hdr->mSize < 2 * sizeof (mama_u32_t))
+        {
+            return MAMA_STATUS_INVALID_ARG;
+        }
+        count = *(const mama_u32_t*) value;
+        pos   = 2 * sizeof (mama_u32_t);
+        while (count-- > 0)
+        {
+            if (hdr->mSize - pos < 2 * sizeof (mama_u32_t))
+            {
+                return MAMA_STATUS_INVALID_ARG;
+            }
+            length = *(const mama_u32_t*) (value + pos);
+            pos   += 2 * sizeof (mama_u32_t);
+            if (length > hdr->mSize - pos
+                || FLATMSG_ALIGN (length) > hdr->mSize - pos)
+            {
+                return MAMA_STATUS_INVALID_ARG;
+            }
+            pos   += (mama_u32_t) FLATMSG_ALIGN (length);
+        }
+        return MAMA_STATUS_OK;
+    default:
+        return MAMA_STATUS_INVALID_ARG;
+    }
+
+    return hdr->mSize < minimum ? MAMA_STATUS_INVALID_ARG : MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgPayloadImpl_decode (flatmsgPayloadImpl* impl,
+                           const void*         buffer,
+                           mama_size_t         length)
+{
+    mama_status status = MAMA_STATUS_OK;
+    mama_size_t size   = 0;
+
+    status = flatmsgPayloadImpl_validateHeader (buffer, length, &size);
+    if (MAMA_STATUS_OK != status)
+    {
+        return status;
+    }
+
+    /* Sub messages handed out belong to the previous contents */
+    impl->mNestedCount = 0;
+
+    /* Being handed our own buffer back leaves nothing to do */
+    if ((const mama_u8_t*) buffer == impl->mStorage)
+    {
+        impl->mBuffer     = impl->mStorage;
+        impl->mBufferSize = impl->mStorageSize;
+        return MAMA_STATUS_OK;
+    }
+
+    /* Drop any view first so that reserving does not copy it */
+    impl->mBuffer     = impl->mStorage;
+    impl->mBufferSize = impl->mStorageSize;
+
+    status = flatmsgPayloadImpl_reserve (impl, size);
+    if (MAMA_STATUS_OK != status)
+    {
+        flatmsgPayloadImpl_reset (impl);
+        return status;
+    }
+
+    /* Only our own copy is known to be aligned, so validate that */
+    memcpy (impl->mBuffer, buffer, size);
+
+    status = flatmsgPayloadImpl_validate (impl->mBuffer);
+    if (MAMA_STATUS_OK != status)
+    {
+        flatmsgPayloadImpl_reset (impl);
+    }
+
+    return status;
+}
+
+mama_status
+flatmsgPayloadImpl_wrap (flatmsgPayloadImpl* impl,
+                         const void*         buffer,
+                         mama_size_t         length)
+{
+    mama_status status = MAMA_STATUS_OK;
+    mama_size_t size   = 0;
+
+    if (!FLATMSG_IS_ALIGNED (buffer))
+    {
+        return flatmsgPayloadImpl_decode (impl, buffer, length);
+    }
+
+    status = flatmsgPayloadImpl_validateHeader (buffer, length, &size);
+    if (MAMA_STATUS_OK != status)
+    {
+        return status;
+    }
+
+    if ((const mama_u8_t*) buffer == impl->mStorage)
+    {
+        return flatmsgPayloadImpl_decode (impl, buffer, length);
+    }
+
+    /* A view handed back again is checked again, as it may be reused */
+    status = flatmsgPayloadImpl_validate ((const mama_u8_t*) buffer);
+    if (MAMA_STATUS_OK != status)
+    {
+        return status;
+    }
+
+    /* Never written through - see flatmsgPayloadImpl_reserve */
+    impl->mNestedCount = 0;
+    impl->mBuffer     = (mama_u8_t*) buffer;
+    impl->mBufferSize = size;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgPayloadImpl_addField (flatmsgPayloadImpl* impl,
+                             const char*         name,
+                             mama_fid_t          fid,
+                             mamaFieldType       type,
+                             const void*         value,
+                             mama_size_t         size,
+                             void**              dest)
+{
+    flatmsgHeader*      header     = NULL;
+    flatmsgFieldHeader* hdr        = NULL;
+    flatmsgIndexEntry*  index      = NULL;
+    mama_u8_t*          copy       = NULL;
+    mama_size_t         nameLength = 0;
+    mama_size_t         span       = 0;
+    mama_u32_t          offset     = 0;
+    mama_u32_t          low        = 0;
+    mama_u32_t          high       = 0;
+    mama_u32_t          mid        = 0;
+    mama_status         status     = MAMA_STATUS_OK;
+
+    if (NULL != name && '\0' != name[0])
+    {
+        nameLength = strlen (name) + 1;
+    }
+
+    if (nameLength > FLATMSG_MAX_NAME_LENGTH)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR, "flatmsgPayloadImpl_addField(): "
+                  "Field name [%s] exceeds %d characters.",
+                  name, FLATMSG_MAX_NAME_LENGTH - 1);
+        return MAMA_STATUS_INVALID_ARG;
+    }
+
+    if (size > 0xFFFFFFFF)
+    {
+        return MAMA_STATUS_INVALID_ARG;
+    }
+
+    /*
+     * The name and value may be views into this buffer (copying a field
+     * within the same message), which a resize would invalidate.
+     */
+    if (   ((const mama_u8_t*) value >= impl->mBuffer
+            && (const mama_u8_t*) value < impl->mBuffer + impl->mBufferSize)
+        || ((const mama_u8_t*) name  >= impl->mBuffer
+            && (const mama_u8_t*) name  < impl->mBuffer + impl->mBufferSize))
+    {
+        copy = (mama_u8_t*) malloc (size + nameLength);
+        if (NULL == copy)
+        {
+            return MAMA_STATUS_NOMEM;
+        }
+        if (NULL != value)
+        {
+            memcpy (copy, value, size);
+            value = copy;
+        }
+        if (0 != nameLength)
+        {
+            memcpy (copy + size, name, nameLength);
+            name = (const char*) copy + size;
+        }
+    }
+
+    span   = sizeof (flatmsgFieldHeader) + FLATMSG_ALIGN (nameLength)
+                                         + FLATMSG_ALIGN (size);
+    status = flatmsgPayloadImpl_reserve (impl,
+                                         FLATMSG_ENCODED_SIZE (impl) + span);
+    if (MAMA_STATUS_OK != status)
+    {
+        free (copy);
+        return status;
+    }
+
+    header = FLATMSG_HEADER (impl);
+    index  = FLATMSG_INDEX (impl);
+    offset = header->mDataSize;
+
+    /* Make room at the end of the data region by moving the index along */
+    memmove ((mama_u8_t*) index + span, index,
+             header->mNumFields * sizeof (flatmsgIndexEntry));
+
+    hdr = FLATMSG_FIELD (impl, offset);
+    memset (hdr, 0, span);
+    hdr->mFid        = fid;
+    hdr->mType       = (mama_u8_t) type;
+    hdr->mNameLength = (mama_u8_t) nameLength;
+    hdr->mSize       = (mama_u32_t) size;
+
+    if (0 != nameLength)
+    {
+        memcpy ((char*) (hdr + 1), name, nameLength);
+    }
+    if (NULL != value && 0 != size)
+    {
+        memcpy (FLATMSG_FIELD_VALUE (hdr), value, size);
+    }
+    if (NULL != dest)
+    {
+        *dest = FLATMSG_FIELD_VALUE (hdr);
+    }
+
+    header->mDataSize += (mama_u32_t) span;
+
+    /* Insert after any existing fields with this fid to keep them in order */
+    index = FLATMSG_INDEX (impl);
+    high  = header->mNumFields;
+    while (low < high)
+    {
+        mid = low + (high - low) / 2;
+        if (index[mid].mFid <= fid)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    memmove (&index[low + 1], &index[low],
+             (header->mNumFields - low) * sizeof (flatmsgIndexEntry));
+
+    index[low].mFid      = fid;
+    index[low].mType     = (mama_u8_t) type;
+    index[low].mReserved = 0;
+    index[low].mOffset   = offset;
+
+    header->mNumFields++;
+
+    free (copy);
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgPayloadImpl_updateField (flatmsgPayloadImpl* impl,
+                                const char*         name,
+                                mama_fid_t          fid,
+                                mamaFieldType       type,
+                                const void*         value,
+                                mama_size_t         size,
+                                void**              dest)
+{
+    mama_status status = MAMA_STATUS_OK;
+    mama_u32_t  offset = 0;
+
+    if (NULL == name && 0 == fid)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Find field */
+    status = flatmsgPayloadImpl_findField (impl, name, fid, &offset);
+
+    /* Create if this does not exist */
+    if (MAMA_STATUS_NOT_FOUND == status)
+    {
+        return flatmsgPayloadImpl_addField (impl, name, fid, type,
+                                            value, size, dest);
+    }
+    else if (MAMA_STATUS_OK != status)
+    {
+        return status;
+    }
+
+    return flatmsgPayloadImpl_setFieldValue (impl, offset, type,
+                                             value, size, dest);
+}
+
+mama_status
+flatmsgPayloadImpl_encodeVectorString (const char*  value[],
+                                       mama_size_t  size,
+                                       void**       result,
+                                       mama_size_t* length)
+{
+    mama_u8_t*  buffer = NULL;
+    mama_u8_t*  pos    = NULL;
+    mama_size_t total  = 2 * sizeof (mama_u32_t);
+    mama_size_t i      = 0;
+
+    for (i = 0; i < size; i++)
+    {
+        total += (NULL == value[i] ? 0 : strlen (value[i])) + 1;
+    }
+
+    buffer = (mama_u8_t*) malloc (total);
+    if (NULL == buffer)
+    {
+        return MAMA_STATUS_NOMEM;
+    }
+
+    ((mama_u32_t*) buffer)[0] = (mama_u32_t) size;
+    ((mama_u32_t*) buffer)[1] = 0;
+    pos = buffer + 2 * sizeof (mama_u32_t);
+
+    for (i = 0; i < size; i++)
+    {
+        const char* str = NULL == value[i] ? "" : value[i];
+        mama_size_t len = strlen (str) + 1;
+
+        memcpy (pos, str, len);
+        pos += len;
+    }
+
+    *result = buffer;
+    *length = total;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgPayloadImpl_encodeVectorMsg (const mamaMsg value[],
+                                    mama_size_t   size,
+                                    void**        result,
+                                    mama_size_t*  length)
+{
+    flatmsgPayloadImpl* subImpl    = NULL;
+    mama_bool_t         owned      = 0;
+    void*               buffer     = NULL;
+    mama_size_t         bufferSize = 0;
+    mama_size_t         total      = 2 * sizeof (mama_u32_t);
+    mama_size_t         msgLength  = 0;
+    mama_size_t         required   = 0;
+    mama_size_t         i          = 0;
+    mama_status         status     = MAMA_STATUS_OK;
+
+    status = flatmsgPayloadImpl_allocateBufferMemory (
+                &buffer, &bufferSize, FLATMSG_INITIAL_BUFFER_SIZE);
+    if (MAMA_STATUS_OK != status)
+    {
+        return status;
+    }
+
+    for (i = 0; i < size; i++)
+    {
+        status = flatmsgPayloadImpl_fromMamaMsg (value[i], &subImpl, &owned);
+        if (MAMA_STATUS_OK != status)
+        {
+            free (buffer);
+            return status;
+        }
+
+        msgLength = FLATMSG_ENCODED_SIZE (subImpl);
+        required  = total + 2 * sizeof (mama_u32_t) + FLATMSG_ALIGN (msgLength);
+
+        if (required > bufferSize)
+        {
+            status = flatmsgPayloadImpl_allocateBufferMemory (
+                        &buffer, &bufferSize,
+                        required > bufferSize * 2 ? required : bufferSize * 2);
+        }
+
+        if (MAMA_STATUS_OK == status)
+        {
+            mama_u8_t* pos = (mama_u8_t*) buffer + total;
+
+            ((mama_u32_t*) pos)[0] = (mama_u32_t) msgLength;
+            ((mama_u32_t*) pos)[1] = 0;
+            pos += 2 * sizeof (mama_u32_t);
+
+            memcpy (pos, subImpl->mBuffer, msgLength);
+            memset (pos + msgLength, 0, FLATMSG_ALIGN (msgLength) - msgLength);
+
+            total = required;
+        }
+
+        if (owned)
+        {
+            flatmsgPayload_destroy ((msgPayload) subImpl);
+        }
+
+        if (MAMA_STATUS_OK != status)
+        {
+            free (buffer);
+            return status;
+        }
+    }
+
+    ((mama_u32_t*) buffer)[0] = (mama_u32_t) size;
+    ((mama_u32_t*) buffer)[1] = 0;
+
+    *result = buffer;
+    *length = total;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+flatmsgPayloadImpl_fromMamaMsg (const mamaMsg        msg,
+                                flatmsgPayloadImpl** result,
+                                mama_bool_t*         owned)
+{
+    mamaPayloadType type    = MAMA_PAYLOAD_UNKNOWN;
+    msgPayload      payload = NULL;
+    mama_status     status  = MAMA_STATUS_OK;
+
+    if (NULL == msg)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    /* Messages already using this payload are encoded as they stand */
+    if (   MAMA_STATUS_OK == mamaMsg_getPayloadType (msg, &type)
+        && MAMA_PAYLOAD_FLAT == type
+        && MAMA_STATUS_OK == mamaMsgImpl_getPayload (msg, &payload)
+        && NULL != payload)
+    {
+        *result = (flatmsgPayloadImpl*) payload;
+        *owned  = 0;
+        return MAMA_STATUS_OK;
+    }
+
+    /* Anything else is converted one field at a time */
+    status = flatmsgPayload_create (&payload);
+    if (MAMA_STATUS_OK != status)
+    {
+        return status;
+    }
+
+    status = mamaMsg_iterateFields (msg,
+                                    flatmsgPayloadImpl_addMsgFieldCb,
+                                    NULL,
+                                    payload);
+    if (MAMA_STATUS_OK != status)
+    {
+        flatmsgPayload_destroy (payload);
+        return status;
+    }
+
+    *result = (flatmsgPayloadImpl*) payload;
+    *owned  = 1;
+
+    return MAMA_STATUS_OK;
+}
+
+void MAMACALLTYPE
+flatmsgPayloadImpl_addMsgFieldCb (const mamaMsg      msg,
+                                  const mamaMsgField field,
+                                  void*              closure)
+{
+    msgPayload    payload = (msgPayload) closure;
+    mamaFieldType type    = MAMA_FIELD_TYPE_UNKNOWN;
+    const char*   name    = NULL;
+    mama_fid_t    fid     = 0;
+
+    mamaMsgField_getType (field, &type);
+    mamaMsgField_getName (field, &name);
+    mamaMsgField_getFid  (field, &fid);
+
+    switch (type)
+    {
+    case MAMA_FIELD_TYPE_BOOL:
+    {
+        mama_bool_t value = 0;
+        if (MAMA_STATUS_OK == mamaMsgField_getBool (field, &value))
+            flatmsgPayload_addBool (payload, name, fid, value);
+        break;
+    }
+    case MAMA_FIELD_TYPE_CHAR:
+    {
+        char value = 0;
+        if (MAMA_STATUS_OK == mamaMsgField_getChar (field, &value))
+            flatmsgPayload_addChar (payload, name, fid, value);
+        break;
+    }
+    case MAMA_FIELD_TYPE_I8:
+    {
+        mama_i8_t value = 0;
+        if (MAMA_STATUS_OK == mamaMsgField_getI8 (field, &value))
+            flatmsgPayload_addI8 (payload, name, fid, value);
+        break;
+    }
+    case MAMA_FIELD_TYPE_U8:
+    {
+        mama_u8_t value = 0;
+        if (MAMA_STATUS_OK == mamaMsgField_getU8 (field, &value))
+            flatmsgPayload_addU8 (payload, name, fid, value);
+        break;
+    }
+    case MAMA_FIELD_TYPE_I16:
+    {
+        mama_i16_t value = 0;
+        if (MAMA_STATUS_OK == mamaMsgField_getI16 (field, &value))
+            flatmsgPayload_addI16 (payload, name, fid, value);
+        break;
+    }
+    case MAMA_FIELD_TYPE_U16:
+    {
+        mama_u16_t value = 0;
+        if (MAMA_STATUS_OK == mamaMsgField_getU16 (field, &value))
+            flatmsgPayload_addU16 (payload, name, fid, value);
+        break;
+    }
+    case MAMA_FIELD_TYPE_I32:
+    {
+        mama_i32_t value = 0;
+        if (MAMA_STATUS_OK == mamaMsgField_getI32 (field, &value))
+            flatmsgPayload_addI32 (payload, name, fid, value);
+        break;
+    }
+    case MAMA_FIELD_TYPE_U32:
+    {
+        mama_u32_t value = 0;
+        if (MAMA_STATUS_OK == mamaMsgField_getU32 (field, &value))
+            flatmsgPayload_addU32 (payload, name, fid, value);
+        break;
+    }
+    case MAMA_FIELD_TYPE_I64:
+    {
+        mama_i64_t value = 0;
+        if (MAMA_STATUS_OK == mamaMsgField_getI64 (field, &value))
+            flatmsgPayload_addI64 (payload, name, fid, value);
+        break;
+    }
+    case MAMA_FIELD_TYPE_U64:
+    {
+        mama_u64_t value = 0;
+        if (MAMA_STATUS_OK == mamaMsgField_getU64 (field, &value))
+            flatmsgPayload_addU64 (payload, name, fid, value);
+        break;
+    }
+    case MAMA_FIELD_TYPE_F32:
+    {
+        mama_f32_t value = 0;
+        if (MAMA_STATUS_OK == mamaMsgField_getF32 (field, &value))
+            flatmsgPayload_addF32 (payload, name, fid, value);
+        break;
+    }
+    case MAMA_FIELD_TYPE_F64:
+    {
+        mama_f64_t value = 0;
+        if (MAMA_STATUS_OK == mamaMsgField_getF64 (field, &value))
+            flatmsgPayload_addF64 (payload, name, fid, value);
+        break;
+    }
+    case MAMA_FIELD_TYPE_STRING:
+    {
+        const char* value = NULL;
+        if (MAMA_STATUS_OK == mamaMsgField_getString (field, &value))
+            flatmsgPayload_addString (payload, name, fid, value);
+        break;
+    }
+    case MAMA_FIELD_TYPE_OPAQUE:
+    {
+        const void* value = NULL;
+        mama_size_t size  = 0;
+        if (MAMA_STATUS_OK == mamaMsgField_getOpaque (field, &value, &size))
+            flatmsgPayload_addOpaque (payload, name, fid, value, size);
+        break;
+    }
+    case MAMA_FIELD_TYPE_TIME:
+    {
+        mamaDateTime value = NULL;
+        mamaDateTime_create (&value);
+        if (MAMA_STATUS_OK == mamaMsgField_getDateTime (field, value))
+            flatmsgPayload_addDateTime (payload, name, fid, value);
+        mamaDateTime_destroy (value);
+        break;
+    }
+    case MAMA_FIELD_TYPE_PRICE:
+    {
+        mamaPrice value = NULL;
+        mamaPrice_create (&value);
+        if (MAMA_STATUS_OK == mamaMsgField_getPrice (field, value))
+            flatmsgPayload_addPrice (payload, name, fid, value);
+        mamaPrice_destroy (value);
+        break;
+    }
+    case MAMA_FIELD_TYPE_MSG:
+    {
+        mamaMsg             value   = NULL;
+        flatmsgPayloadImpl* subImpl = NULL;
+        mama_bool_t         owned   = 0;
+        if (MAMA_STATUS_OK == mamaMsgField_getMsg (field, &value)
+            && MAMA_STATUS_OK == flatmsgPayloadImpl_fromMamaMsg (value,
+                                                                 &subImpl,
+                                                                 &owned))
+        {
+            flatmsgPayload_addMsg (payload, name, fid, (msgPayload) subImpl);
+            if (owned)
+            {
+                flatmsgPayload_destroy ((msgPayload) subImpl);
+            }
+        }
+        break;
+    }
+    case MAMA_FIELD_TYPE_VECTOR_MSG:
+    {
+        const mamaMsg* value = NULL;
+        mama_size_t    size  = 0;
+        if (MAMA_STATUS_OK == mamaMsgField_getVectorMsg (field, &value, &size))
+            flatmsgPayload_addVectorMsg (payload, name, fid, value, size);
+        break;
+    }
+    case MAMA_FIELD_TYPE_VECTOR_STRING:
+    {
+        const char** value = NULL;
+        mama_size_t  size  = 0;
+        if (MAMA_STATUS_OK == mamaMsgField_getVectorString (field, &value,
+                                                            &size))
+            flatmsgPayload_addVectorString (payload, name, fid, value, size);
+        break;
+    }
+    ADD_VECTOR_FIELD (BOOL, Bool, mama_bool_t);
+    ADD_VECTOR_FIELD (CHAR, Char, char);
+    ADD_VECTOR_FIELD (I8,   I8,   mama_i8_t);
+    ADD_VECTOR_FIELD (U8,   U8,   mama_u8_t);
+    ADD_VECTOR_FIELD (I16,  I16,  mama_i16_t);
+    ADD_VECTOR_FIELD (U16,  U16,  mama_u16_t);
+    ADD_VECTOR_FIELD (I32,  I32,  mama_i32_t);
+    ADD_VECTOR_FIELD (U32,  U32,  mama_u32_t);
+    ADD_VECTOR_FIELD (I64,  I64,  mama_i64_t);
+    ADD_VECTOR_FIELD (U64,  U64,  mama_u64_t);
+    ADD_VECTOR_FIELD (F32,  F32,  mama_f32_t);
+    ADD_VECTOR_FIELD (F64,  F64,  mama_f64_t);
+    default:
+        break;
+    }
+}
+
+void
+flatmsgPayloadImpl_append (char*        buffer,
+                           mama_size_t  len,
+                           mama_size_t* written,
+                           const char*  format,
+                           ...)
+{
+    va_list     ap;
+    int         result    = 0;
+    mama_size_t remaining = 0;
+
+    if (*written + 1 >= len)
+    {
+        return;
+    }
+
+    remaining = len - *written;
+
+    va_start (ap, format);
+    result = vsnprintf (buffer + *written, remaining, format, ap);
+    va_end (ap);
+
+    if (result < 0)
+    {
+        /* Some runtimes report truncation this way - treat the buffer as full */
+        buffer[len - 1] = '\0';
+        *written        = len - 1;
+    }
+    else if ((mama_size_t) result >= remaining)
+    {
+        *written = len - 1;
+    }
+    else
+    {
+        *written += (mama_size_t) result;
+    }
+}
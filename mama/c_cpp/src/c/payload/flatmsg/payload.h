@@ -0,0 +1,227 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#ifndef MAMA_PAYLOAD_FLATMSG_PAYLOAD_H__
+#define MAMA_PAYLOAD_FLATMSG_PAYLOAD_H__
+
+
+/*=========================================================================
+  =                             Includes                                  =
+  =========================================================================*/
+
+#include "flatcommon.h"
+
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*=========================================================================
+  =                   Public implementation prototypes                    =
+  =========================================================================*/
+
+/**
+ * This function exists to centralize the allocation of buffer memory. When
+ * called for the first time with an empty buffer, it will calloc the requested
+ * memory. When requesting a size smaller than the current size, it will do
+ * nothing. When requesting a size larger than the current size, it will perform
+ * a realloc. On success, MAMA_STATUS_OK will be returned, and if necessary,
+ * the buffer pointer will be written back to reflect the new value. The
+ * currentSize pointer will also be modified to reflect the new size. On
+ * failure, a mama_status will be returned indicating an error and buffer and
+ * currentSize will remain unchanged.
+ *
+ * @param buffer      Pointer to the buffer to examine and resize if necessary.
+ * @param size        Current size of the buffer. Will be updated with the newly
+ *                    requested newSize on success.
+ * @param newSize     The newly requested buffer size.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+mama_status
+flatmsgPayloadImpl_allocateBufferMemory      (void**                   buffer,
+                                              mama_size_t*             size,
+                                              mama_size_t              newSize);
+
+/**
+ * This will search the payload for the field matching the fid or, when the
+ * fid is 0, the name provided. Where the fid is non zero the name is never
+ * examined. Fid lookups use the sorted index so are a binary search, while
+ * name lookups walk the fields in the order they were added.
+ *
+ * @param impl        The payload to search.
+ * @param name        The field name to look for when fid is 0.
+ * @param fid         The field identifier to look for.
+ * @param offset      Populated with the data region offset of the field.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ *         MAMA_STATUS_NOT_FOUND is returned if no such field exists.
+ */
+mama_status
+flatmsgPayloadImpl_findField                 (flatmsgPayloadImpl*      impl,
+                                              const char*              name,
+                                              mama_fid_t               fid,
+                                              mama_u32_t*              offset);
+
+/**
+ * This will replace the value of the field at the offset provided. When the
+ * type matches and the padded size is unchanged, the value is overwritten in
+ * place. Otherwise the data following the field is moved to make room and the
+ * offsets in the index are adjusted to suit. The field keeps its offset so any
+ * field payload referring to it remains valid.
+ *
+ * @param impl        The payload containing the field.
+ * @param offset      The data region offset of the field to update.
+ * @param type        The MAMA field type of the new value.
+ * @param value       The new value, or NULL to leave the value to the caller.
+ * @param size        The length of the new value in bytes.
+ * @param dest        If not NULL, populated with the location of the value
+ *                    within the buffer so the caller may write it directly.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+mama_status
+flatmsgPayloadImpl_setFieldValue             (flatmsgPayloadImpl*      impl,
+                                              mama_u32_t               offset,
+                                              mamaFieldType            type,
+                                              const void*              value,
+                                              mama_size_t              size,
+                                              void**                   dest);
+
+/**
+ * This will return an array of pointers into the payload for each string of
+ * a string vector field. The array is reused on subsequent calls.
+ *
+ * @param impl        The payload containing the field.
+ * @param hdr         The string vector field.
+ * @param result      Populated with the string array.
+ * @param size        Populated with the number of strings.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+mama_status
+flatmsgPayloadImpl_getVectorString           (flatmsgPayloadImpl*      impl,
+                                              const flatmsgFieldHeader* hdr,
+                                              const char***            result,
+                                              mama_size_t*             size);
+
+/**
+ * This will decode the sub message held in the field provided into a payload
+ * owned by impl, which remains valid until impl is next cleared. The sub
+ * message is a view of the field, so its contents are only valid until impl
+ * is next modified.
+ *
+ * @param impl        The payload containing the field.
+ * @param hdr         The sub message field.
+ * @param result      Populated with the sub message payload.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+mama_status
+flatmsgPayloadImpl_getMsg                    (flatmsgPayloadImpl*      impl,
+                                              const flatmsgFieldHeader* hdr,
+                                              msgPayload*              result);
+
+/**
+ * This will decode each message of a message vector field into payloads
+ * owned by impl. The payloads are reused on subsequent calls.
+ *
+ * @param impl        The payload containing the field.
+ * @param hdr         The message vector field.
+ * @param result      Populated with the array of payloads.
+ * @param size        Populated with the number of payloads.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+mama_status
+flatmsgPayloadImpl_getVectorMsg              (flatmsgPayloadImpl*      impl,
+                                              const flatmsgFieldHeader* hdr,
+                                              const msgPayload**       result,
+                                              mama_size_t*             size);
+
+/**
+ * This will populate a MAMA date time from the field provided, converting from
+ * string, floating point and integer representations where necessary.
+ *
+ * @param hdr         The field to read.
+ * @param result      The date time to populate.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+mama_status
+flatmsgPayloadImpl_getDateTime               (const flatmsgFieldHeader* hdr,
+                                              mamaDateTime             result);
+
+/**
+ * This will populate a MAMA price from the field provided, converting from
+ * a floating point representation where necessary.
+ *
+ * @param hdr         The field to read.
+ * @param result      The price to populate.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+mama_status
+flatmsgPayloadImpl_getPrice                  (const flatmsgFieldHeader* hdr,
+                                              mamaPrice                result);
+
+/**
+ * This will write a string representation of the field's value to the buffer
+ * provided, truncating where necessary.
+ *
+ * @param hdr         The field to print.
+ * @param buffer      The location to write the string to.
+ * @param len         The length of the destination buffer.
+ *
+ * @return The number of characters written, excluding the terminator.
+ */
+mama_size_t
+flatmsgPayloadImpl_fieldToString             (const flatmsgFieldHeader* hdr,
+                                              char*                    buffer,
+                                              mama_size_t              len);
+
+/**
+ * This will encode a MAMA date time in its wire representation.
+ *
+ * @param value       The date time to encode.
+ * @param result      The wire representation to populate.
+ */
+void
+flatmsgPayloadImpl_encodeDateTime            (const mamaDateTime       value,
+                                              flatmsgDateTime*         result);
+
+/**
+ * This will encode a MAMA price in its wire representation.
+ *
+ * @param value       The price to encode.
+ * @param result      The wire representation to populate.
+ */
+void
+flatmsgPayloadImpl_encodePrice               (const mamaPrice          value,
+                                              flatmsgPrice*            result);
+
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* MAMA_PAYLOAD_FLATMSG_PAYLOAD_H__ */
@@ -487,6 +487,7 @@ qpidmsgFieldPayload_updateDateTime
     mama_u32_t                  datetime_us  = 0;
     mamaDateTimeHints           dt_hints     = 0;
     mamaDateTimePrecision       dt_precision = MAMA_DATE_TIME_PREC_UNKNOWN;
+    mama_u32_t                  dt_nanos     = 0;
     pn_timestamp_t              dt_stamp     = 0;
     pn_atom_t                   atom;
 
@@ -526,6 +527,7 @@ qpidmsgFieldPayload_updateDateTime
     {
         return MAMA_STATUS_INVALID_ARG;
     }
+    mamaDateTime_getNanosecond (value, &dt_nanos);
 
     /*
      * The timestamp is simply 64 bits of data. Place seconds in leftmost and
@@ -543,6 +545,9 @@ qpidmsgFieldPayload_updateDateTime
     /* add the precision value */
     pn_data_put_ubyte (impl->mParentBody, (mama_u8_t) dt_precision);
 
+    /* always write the nanoseconds so an earlier value is overwritten */
+    pn_data_put_ushort (impl->mParentBody, (mama_u16_t) (dt_nanos % 1000));
+
     /* Exit list */
     pn_data_exit (impl->mParentBody);
 
@@ -815,6 +820,13 @@ qpidmsgFieldPayload_getDateTime (const msgFieldPayload   field,
                                    micros,
                                    (mamaDateTimePrecision) precision,
                                    (mamaDateTimeHints) hints);
+
+        /* Extract the optional nanoseconds within the microsecond */
+        if (impl->mDataArrayCount > 3 && 0 != impl->mDataArray[3].u.as_ushort)
+        {
+            mamaDateTime_setNanosecond (result, micros * 1000 +
+                                        impl->mDataArray[3].u.as_ushort);
+        }
         break;
     }
     case MAMA_FIELD_TYPE_STRING:
@@ -522,6 +522,9 @@ qpidmsgPayload_createImpl (mamaPayloadBridge* result, char* identifier)
     /* Initialize the virtual function table (see payloadbridge.h) */
     INITIALIZE_PAYLOAD_BRIDGE (impl, qpidmsg);
 
+    /* Optional one pass header extraction */
+    impl->msgPayloadGetHeader = qpidmsgPayload_getHeader;
+
     *result     = (mamaPayloadBridge)impl;
     *identifier = (char)MAMA_PAYLOAD_QPID;
 
@@ -851,6 +854,88 @@ qpidmsgPayload_iterateFields (const msgPayload    msg,
     return MAMA_STATUS_OK;
 }
 
+mama_status
+qpidmsgPayload_getHeader (const msgPayload    msg,
+                          msgPayloadHeader*   header)
+{
+    qpidmsgPayloadImpl* impl    = (qpidmsgPayloadImpl*) msg;
+    mama_status         status  = MAMA_STATUS_OK;
+    int                 wanted  = MAMA_PAYLOAD_HEADER_TYPE
+                                | MAMA_PAYLOAD_HEADER_STATUS
+                                | MAMA_PAYLOAD_HEADER_SEQNUM
+                                | MAMA_PAYLOAD_HEADER_SENDERID
+                                | MAMA_PAYLOAD_HEADER_MSGQUAL;
+
+    if (NULL == impl || NULL == header)
+    {
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    header->mPresent = 0;
+
+    /* Go to first field in the message */
+    qpidmsgPayloadImpl_moveDataToContentLocation (impl->mBody);
+
+    while (wanted != header->mPresent && 0 != pn_data_next (impl->mBody))
+    {
+        mama_fid_t  fid;
+        pn_atom_t   atom;
+
+        /* Enter field - stored as a list of Name, FID, data*/
+        pn_data_get_list (impl->mBody);
+        pn_data_enter    (impl->mBody);
+
+        /* Skip over name and onto the FID */
+        pn_data_next     (impl->mBody);
+        pn_data_next     (impl->mBody);
+        fid = pn_data_get_ushort (impl->mBody);
+
+        /* Move onto value */
+        pn_data_next     (impl->mBody);
+        atom   = pn_data_get_atom (impl->mBody);
+        status = MAMA_STATUS_OK;
+
+        if (fid == MamaFieldMsgType.mFid)
+        {
+            GET_ATOM_AS_MAMA_TYPE (atom, mama_i32_t, header->mType);
+            if (MAMA_STATUS_OK == status)
+                header->mPresent |= MAMA_PAYLOAD_HEADER_TYPE;
+        }
+        else if (fid == MamaFieldMsgStatus.mFid)
+        {
+            GET_ATOM_AS_MAMA_TYPE (atom, mama_i32_t, header->mStatus);
+            if (MAMA_STATUS_OK == status)
+                header->mPresent |= MAMA_PAYLOAD_HEADER_STATUS;
+        }
+        else if (fid == MamaFieldSeqNum.mFid)
+        {
+            GET_ATOM_AS_MAMA_TYPE (atom, mama_i64_t, header->mSeqNum);
+            if (MAMA_STATUS_OK == status)
+                header->mPresent |= MAMA_PAYLOAD_HEADER_SEQNUM;
+        }
+        else if (fid == MamaFieldSenderId.mFid)
+        {
+            GET_ATOM_AS_MAMA_TYPE (atom, mama_u64_t, header->mSenderId);
+            if (MAMA_STATUS_OK == status)
+                header->mPresent |= MAMA_PAYLOAD_HEADER_SENDERID;
+        }
+        else if (fid == MamaFieldMsgQual.mFid)
+        {
+            GET_ATOM_AS_MAMA_TYPE (atom, mama_u16_t, header->mMsgQual);
+            if (MAMA_STATUS_OK == status)
+                header->mPresent |= MAMA_PAYLOAD_HEADER_MSGQUAL;
+        }
+
+        /* Exit field and continue searching */
+        pn_data_exit     (impl->mBody);
+    }
+
+    /* Revert to the previous iterator state if applicable */
+    qpidmsgPayloadImpl_resetToIteratorState (impl);
+
+    return MAMA_STATUS_OK;
+}
+
 mama_status
 qpidmsgPayload_serialize (const msgPayload  msg,
                           const void**      buffer,
@@ -1518,6 +1603,7 @@ qpidmsgPayload_addDateTime (msgPayload          msg,
     mama_u32_t              micros       = 0;
     mamaDateTimeHints       hints        = 0;
     mamaDateTimePrecision   precision    = MAMA_DATE_TIME_PREC_UNKNOWN;
+    mama_u32_t              nanos        = 0;
     pn_timestamp_t          stamp        = 0;
 
     if (NULL == value || NULL == impl)
@@ -1550,6 +1636,7 @@ qpidmsgPayload_addDateTime (msgPayload          msg,
                                &micros,
                                &precision,
                                &hints);
+    mamaDateTime_getNanosecond (value, &nanos);
 
     /*
      * The timestamp is simply 64 bits of data. Place seconds in leftmost and
@@ -1567,6 +1654,12 @@ qpidmsgPayload_addDateTime (msgPayload          msg,
     /* add the precision value */
     pn_data_put_ubyte     (impl->mBody, (mama_u8_t) precision);
 
+    /* add the nanoseconds within the microsecond only where there are any */
+    if (0 != nanos % 1000)
+    {
+        pn_data_put_ushort (impl->mBody, (mama_u16_t) (nanos % 1000));
+    }
+
     /* Exit list */
     pn_data_exit          (impl->mBody);
 
@@ -2173,6 +2266,7 @@ qpidmsgPayload_updateDateTime (msgPayload          msg,
     mama_u32_t              micros          = 0;
     mamaDateTimeHints       hints           = 0;
     mamaDateTimePrecision   precision       = MAMA_DATE_TIME_PREC_UNKNOWN;
+    mama_u32_t              nanos           = 0;
     pn_timestamp_t          stamp           = 0;
 
     if (NULL == impl || NULL == value)
@@ -2198,6 +2292,7 @@ qpidmsgPayload_updateDateTime (msgPayload          msg,
                                &micros,
                                &precision,
                                &hints);
+    mamaDateTime_getNanosecond (value, &nanos);
 
     /*
      * The timestamp is simply 64 bits of data. Place seconds in leftmost and
@@ -2215,6 +2310,9 @@ qpidmsgPayload_updateDateTime (msgPayload          msg,
     /* add the precision value */
     pn_data_put_ubyte     (impl->mBody, (mama_u8_t) precision);
 
+    /* always write the nanoseconds so an earlier value is overwritten */
+    pn_data_put_ushort    (impl->mBody, (mama_u16_t) (nanos % 1000));
+
     /* Revert to the previous iterator state if applicable */
     qpidmsgPayloadImpl_resetToIteratorState (impl);
 
@@ -2759,6 +2857,7 @@ qpidmsgPayload_getDateTime (const msgPayload    msg,
     mama_u8_t           precision   = 0;
     mama_u32_t          micros      = 0;
     mama_u32_t          seconds     = 0;
+    mama_u32_t          nanos       = 0;
 
     if (NULL == impl || NULL == result)
     {
@@ -2791,6 +2890,12 @@ qpidmsgPayload_getDateTime (const msgPayload    msg,
     /* Extract the precision */
     precision = pn_data_get_atom (impl->mBody).u.as_ubyte;
 
+    /* Extract the nanoseconds within the microsecond if present */
+    if (pn_data_next (impl->mBody) && PN_USHORT == pn_data_type (impl->mBody))
+    {
+        nanos = pn_data_get_ushort (impl->mBody);
+    }
+
     /* Perform casts / bitwise operators to extract timestamps */
     micros  = (mama_u32_t) stamp;
     seconds   = (mama_u32_t) (stamp >> 32);
@@ -2800,6 +2905,10 @@ qpidmsgPayload_getDateTime (const msgPayload    msg,
                                micros,
                                (mamaDateTimePrecision) precision,
                                hints);
+    if (0 != nanos)
+    {
+        mamaDateTime_setNanosecond (result, micros * 1000 + nanos);
+    }
 
     /* Revert to the previous iterator state if applicable */
     qpidmsgPayloadImpl_resetToIteratorState (impl);
@@ -3452,7 +3561,7 @@ qpidmsgPayloadImpl_getFieldFromBuffer (pn_data_t*               buffer,
     case PN_TIMESTAMP:
     {
         /* allocate memory for storage in field object */
-        qpidmsgFieldPayloadImpl_setDataArraySize (target, 3);
+        qpidmsgFieldPayloadImpl_setDataArraySize (target, 4);
 
         /* Get the timestamp */
         target->mDataArray[0] = pn_data_get_atom (buffer);
@@ -3465,6 +3574,16 @@ qpidmsgPayloadImpl_getFieldFromBuffer (pn_data_t*               buffer,
         pn_data_next (buffer);
         target->mDataArray[2] = pn_data_get_atom (buffer);
 
+        /* Get the optional nanoseconds within the microsecond */
+        if (pn_data_next (buffer) && PN_USHORT == pn_data_type (buffer))
+        {
+            target->mDataArray[3] = pn_data_get_atom (buffer);
+        }
+        else
+        {
+            target->mDataArrayCount = 3;
+        }
+
         /* Set the MAMA Field Type */
         target->mMamaType = MAMA_FIELD_TYPE_TIME;
 
@@ -226,6 +226,22 @@ qpidmsgPayload_iterateFields    (const msgPayload    msg,
                                  mamaMsgIteratorCb   cb,
                                  void*               closure);
 
+/**
+ * Method which walks the fields of the supplied msgPayload once, extracting
+ * the reserved header fields MAMA reads from every inbound message.
+ *
+ * Requirement: Optional.
+ *
+ * @param msg The message payload to be examined.
+ * @param header Populated with each header field found, and the mPresent
+ *               mask of which were found.
+ *
+ * @return mama_status indicating whether the method succeeded or failed.
+ */
+mama_status
+qpidmsgPayload_getHeader        (const msgPayload    msg,
+                                 msgPayloadHeader*   header);
+
 /**
  * Method to return a byte buffer version of the message payload.
  *
@@ -1053,6 +1053,33 @@ typedef mama_status
                                 mama_fid_t          fid,
                                 const msgPayload**  result,
                                 mama_size_t*        size);
+
+/* Bits set in msgPayloadHeader.mPresent for each reserved field found. */
+#define MAMA_PAYLOAD_HEADER_TYPE     0x01
+#define MAMA_PAYLOAD_HEADER_STATUS   0x02
+#define MAMA_PAYLOAD_HEADER_SEQNUM   0x04
+#define MAMA_PAYLOAD_HEADER_SENDERID 0x08
+#define MAMA_PAYLOAD_HEADER_MSGQUAL  0x10
+
+/* The reserved header fields MAMA reads from every inbound message. */
+typedef struct msgPayloadHeader_
+{
+    int         mPresent;
+    mama_i32_t  mType;
+    mama_i32_t  mStatus;
+    mama_i64_t  mSeqNum;
+    mama_u64_t  mSenderId;
+    mama_u16_t  mMsgQual;
+} msgPayloadHeader;
+
+/* Extract MdMsgType, MdMsgStatus, MdSeqNum, MdSenderId and MsgQual in a
+ * single pass over the payload, setting a bit in mPresent for each one
+ * found. This is optional and is not set by INITIALIZE_PAYLOAD_BRIDGE, a
+ * payload providing it assigns it after. Without it MAMA looks each field
+ * up in turn. */
+typedef mama_status
+(*msgPayload_getHeader)        (const msgPayload    msg,
+                                msgPayloadHeader*   header);
 /*===================================================================
  =              msgFieldPayload bridge function pointers             =
  ====================================================================*/
@@ -1424,6 +1451,8 @@ typedef struct mamaPayloadBridgeImpl_
     msgPayload_getVectorDateTime        msgPayloadGetVectorDateTime;
     msgPayload_getVectorPrice           msgPayloadGetVectorPrice;
     msgPayload_getVectorMsg             msgPayloadGetVectorMsg;
+    /* Optional, NULL unless the payload can read the header in one pass. */
+    msgPayload_getHeader                msgPayloadGetHeader;
     msgFieldPayload_create              msgFieldPayloadCreate;
     msgFieldPayload_destroy             msgFieldPayloadDestroy;
     msgFieldPayload_getName             msgFieldPayloadGetName;
@@ -29,16 +29,20 @@
 #include <mama/statscollector.h>
 #include <mama/statfields.h>
 #include "statsgeneratorinternal.h"
+#include "statscollectorinternal.h"
 #include "statinternal.h"
 #include "wlock.h"
 #include "wombat/wInterlocked.h"
 #include <wombat/strutils.h>
+#include <mama/latency.h>
 
 extern int gGenerateQueueStats;
 extern int gLogQueueStats;
 extern int gPublishQueueStats;
 
 int MAMACALLTYPE mamaQueue_pollQueueSizeCb (void* closure);
+int MAMACALLTYPE mamaQueue_pollResidencyAvgCb (void* closure);
+int MAMACALLTYPE mamaQueue_pollResidencyMaxCb (void* closure);
 
 /* *************************************************** */
 /* Definitions. */
@@ -47,6 +51,17 @@ int MAMACALLTYPE mamaQueue_pollQueueSizeCb (void* closure);
 /* property to turn on object locking tracking. */
 #define MAMAQUEUE_PROPERTY_OBJECT_LOCK_TRACKING "mama.queue.object_lock_tracking"
 
+/* Per queue dispatcher properties, read as mama.queue.<name>.<property> when
+ * the dispatcher is created. */
+#define MAMADISPATCHER_PROPERTY_SPIN     "spin"
+#define MAMADISPATCHER_PROPERTY_CPU      "cpu"
+#define MAMADISPATCHER_PROPERTY_SCHED    "sched"
+#define MAMADISPATCHER_PROPERTY_PRIORITY "priority"
+
+/* Maximum number of CPUs a dispatcher may be pinned to. */
+#define MAMADISPATCHER_MAX_CPUS 64
+
+
 /* *************************************************** */
 /* Structures. */
 /* *************************************************** */
@@ -100,8 +115,29 @@ typedef struct mamaQueueImpl_
     /* This flag indicates whether object locking and unlocking will be tracked by the queue. */
     int                         mTrackObjectLocks;
     void*                       mClosure;
+
+    /* Conflate updates while above the high watermark */
+    int                         mConflateOnHighWatermark;
+    volatile int                mConflating;
+
+    /* Residency, the time events spend queued. Measured by the bridge once a
+     * residency watermark has been set or queue stats are enabled, in
+     * nanoseconds. The max is since the stat was last reported. */
+    int                         mResidencyEnabled;
+    volatile mama_u64_t         mResidencyAverage;
+    volatile mama_u64_t         mResidencyMax;
+    mama_u64_t                  mHighResidency;
+    mama_u64_t                  mLowResidency;
+    int                         mHighResidencyFired;
+    mamaQueueResidencyCallbacks mResidencyCallbacks;
+    void*                       mResidencyClosure;
+    mamaStat                    mResidencyAvgStat;
+    mamaStat                    mResidencyMaxStat;
 } mamaQueueImpl;
 
+static mama_status
+mamaQueueImpl_enableResidency (mamaQueueImpl* impl);
+
 /*Main structure for the mamaDispatcher*/
 typedef struct mamaDisptacherImpl_
 {
@@ -113,6 +149,8 @@ typedef struct mamaDisptacherImpl_
     int            mIsDispatching;
     /*Destroy has been called*/
     int            mDestroy;
+    /*Microseconds to busy poll the queue before blocking, 0 never spins*/
+    uint64_t       mSpinMicros;
 } mamaDispatcherImpl;
 
 static wInterlockedInt gQueueNumber = 0;
@@ -392,6 +430,30 @@ mamaQueue_enableStats(mamaQueue queue)
         }
 
         mamaStat_setPollCallback (impl->mQueueSizeStat, mamaQueue_pollQueueSizeCb, queue);
+
+        /* Residency stats report the queue's own moving average and max,
+         * so are available whenever the bridge can measure residency */
+        if (MAMA_STATUS_OK == mamaQueueImpl_enableResidency (impl))
+        {
+            status = mamaStat_create (&impl->mResidencyAvgStat,
+                                      impl->mStatsCollector,
+                                      MAMA_STAT_NOT_LOCKABLE,
+                                      MamaStatQueueResidencyAvg.mName,
+                                      MamaStatQueueResidencyAvg.mFid);
+            if (status != MAMA_STATUS_OK) return status;
+
+            status = mamaStat_create (&impl->mResidencyMaxStat,
+                                      impl->mStatsCollector,
+                                      MAMA_STAT_NOT_LOCKABLE,
+                                      MamaStatQueueResidencyMax.mName,
+                                      MamaStatQueueResidencyMax.mFid);
+            if (status != MAMA_STATUS_OK) return status;
+
+            mamaStat_setPollCallback (impl->mResidencyAvgStat,
+                                      mamaQueue_pollResidencyAvgCb, queue);
+            mamaStat_setPollCallback (impl->mResidencyMaxStat,
+                                      mamaQueue_pollResidencyMaxCb, queue);
+        }
     }
 
     return status;
@@ -743,6 +805,18 @@ mamaQueue_destroy (mamaQueue queue)
             impl->mRvMsgsStat = NULL;
         }
 
+        if (impl->mResidencyAvgStat)
+        {
+            mamaStat_destroy (impl->mResidencyAvgStat);
+            impl->mResidencyAvgStat = NULL;
+        }
+
+        if (impl->mResidencyMaxStat)
+        {
+            mamaStat_destroy (impl->mResidencyMaxStat);
+            impl->mResidencyMaxStat = NULL;
+        }
+
         if (impl->mStatsCollector)
         {
             mamaStatsGenerator_removeStatsCollector  (mamaInternal_getStatsGenerator(), impl->mStatsCollector);
@@ -1147,6 +1221,20 @@ mamaQueueImpl_getStatsCollector (mamaQueue queue)
     return impl->mStatsCollector;
 }
 
+mama_status
+mamaQueue_getLatencyHistogram (mamaQueue             queue,
+                               mamaLatencySpan       span,
+                               mamaLatencyHistogram* histogram)
+{
+    mamaQueueImpl* impl = (mamaQueueImpl*)queue;
+    if (!impl) return MAMA_STATUS_NULL_ARG;
+    if (!impl->mStatsCollector) return MAMA_STATUS_NOT_FOUND;
+
+    return mamaStatsCollector_getLatencyHistogram (impl->mStatsCollector,
+                                                   span,
+                                                   histogram);
+}
+
 mamaBridgeImpl*
 mamaQueueImpl_getBridgeImpl (mamaQueue queue)
 {
@@ -1227,6 +1315,213 @@ mamaQueueImpl_detachMsg (mamaQueue queue,
     return MAMA_STATUS_OK;
 }
 
+static mama_status
+mamaQueueImpl_enableResidency (mamaQueueImpl* impl)
+{
+    mama_status status = MAMA_STATUS_OK;
+
+    if (impl->mResidencyEnabled)
+        return MAMA_STATUS_OK;
+
+    if (NULL == impl->mBridgeImpl->bridgeMamaQueueEnableResidency)
+        return MAMA_STATUS_NOT_IMPLEMENTED;
+
+    status = impl->mBridgeImpl->bridgeMamaQueueEnableResidency (
+                    impl->mMamaQueueBridgeImpl, 1);
+
+    if (MAMA_STATUS_OK == status)
+        impl->mResidencyEnabled = 1;
+
+    return status;
+}
+
+void
+mamaQueueImpl_recordResidency (mamaQueue  queue,
+                               mama_u64_t residency)
+{
+    mamaQueueImpl* impl     = (mamaQueueImpl*)queue;
+    mama_u64_t     average  = impl->mResidencyAverage;
+    mama_u64_t     low      = 0;
+
+    /* Moving average weighted over roughly the last 16 events */
+    average = average - (average >> 4) + (residency >> 4);
+    impl->mResidencyAverage = average;
+
+    if (residency > impl->mResidencyMax)
+        impl->mResidencyMax = residency;
+
+    if (0 == impl->mHighResidency)
+        return;
+
+    low = impl->mLowResidency ? impl->mLowResidency
+                              : impl->mHighResidency - 1;
+
+    if (!impl->mHighResidencyFired && average >= impl->mHighResidency)
+    {
+        impl->mHighResidencyFired = 1;
+
+        mama_log (MAMA_LOG_LEVEL_FINE,
+                  "High residency watermark for queue [%s] exceeded : %lluus",
+                  impl->mQueueName, (unsigned long long)(average / 1000));
+
+        if (impl->mResidencyCallbacks.onQueueHighResidency)
+        {
+            impl->mResidencyCallbacks.onQueueHighResidency (
+                                queue,
+                                average / 1000,
+                                impl->mResidencyClosure);
+        }
+    }
+    else if (impl->mHighResidencyFired && average <= low)
+    {
+        impl->mHighResidencyFired = 0;
+
+        mama_log (MAMA_LOG_LEVEL_FINE,
+                  "Low residency watermark for queue [%s] reached : %lluus",
+                  impl->mQueueName, (unsigned long long)(average / 1000));
+
+        if (impl->mResidencyCallbacks.onQueueLowResidency)
+        {
+            impl->mResidencyCallbacks.onQueueLowResidency (
+                                queue,
+                                average / 1000,
+                                impl->mResidencyClosure);
+        }
+    }
+}
+
+mama_status
+mamaQueue_setHighResidencyWatermark (mamaQueue  queue,
+                                     mama_u64_t highResidency)
+{
+    mamaQueueImpl* impl = (mamaQueueImpl*)queue;
+
+    if (!impl)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "mamaQueue_setHighResidencyWatermark(): NULL queue.");
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    if (highResidency && highResidency * 1000 <= impl->mLowResidency)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "mamaQueue_setHighResidencyWatermark(): "
+                  "high residency watermark [%llu] is not greater "
+                  "than low residency watermark [%llu].",
+                  (unsigned long long)highResidency,
+                  (unsigned long long)(impl->mLowResidency / 1000));
+        return MAMA_STATUS_INVALID_ARG;
+    }
+
+    if (highResidency && MAMA_STATUS_OK != mamaQueueImpl_enableResidency (impl))
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "mamaQueue_setHighResidencyWatermark(): "
+                  "residency is not supported by the [%s] bridge.",
+                  impl->mBridgeImpl->bridgeGetName ());
+        return MAMA_STATUS_NOT_IMPLEMENTED;
+    }
+
+    impl->mHighResidencyFired = 0;
+    impl->mHighResidency      = highResidency * 1000;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+mamaQueue_setLowResidencyWatermark (mamaQueue  queue,
+                                    mama_u64_t lowResidency)
+{
+    mamaQueueImpl* impl = (mamaQueueImpl*)queue;
+
+    if (!impl)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "mamaQueue_setLowResidencyWatermark(): NULL queue.");
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    if (lowResidency * 1000 >= impl->mHighResidency)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "mamaQueue_setLowResidencyWatermark(): "
+                  "low residency watermark [%llu] is not less than "
+                  "high residency watermark [%llu].",
+                  (unsigned long long)lowResidency,
+                  (unsigned long long)(impl->mHighResidency / 1000));
+        return MAMA_STATUS_INVALID_ARG;
+    }
+
+    impl->mLowResidency = lowResidency * 1000;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+mamaQueue_setResidencyCallbacks (mamaQueue                    queue,
+                                 mamaQueueResidencyCallbacks* callbacks,
+                                 void*                        closure)
+{
+    mamaQueueImpl* impl = (mamaQueueImpl*)queue;
+    if (!impl || !callbacks) return MAMA_STATUS_NULL_ARG;
+
+    impl->mResidencyCallbacks = *callbacks; /*Copy*/
+    impl->mResidencyClosure   = closure;
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+mamaQueue_getResidency (mamaQueue   queue,
+                        mama_u64_t* residency)
+{
+    mamaQueueImpl* impl = (mamaQueueImpl*)queue;
+    if (!impl || !residency) return MAMA_STATUS_NULL_ARG;
+
+    *residency = impl->mResidencyAverage / 1000;
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+mamaQueue_setConflateOnHighWatermark (mamaQueue queue,
+                                      int       conflate)
+{
+    mamaQueueImpl* impl = (mamaQueueImpl*)queue;
+
+    if (!impl)
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "mamaQueue_setConflateOnHighWatermark(): NULL queue.");
+        return MAMA_STATUS_NULL_ARG;
+    }
+
+    impl->mConflateOnHighWatermark = conflate ? 1 : 0;
+    if (!conflate)
+        impl->mConflating = 0;
+
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+mamaQueue_isConflating (mamaQueue queue,
+                        int*      conflating)
+{
+    mamaQueueImpl* impl = (mamaQueueImpl*)queue;
+
+    if (!impl || !conflating) return MAMA_STATUS_NULL_ARG;
+
+    *conflating = impl->mConflating;
+    return MAMA_STATUS_OK;
+}
+
+int
+mamaQueueImpl_isConflating (mamaQueue queue)
+{
+    mamaQueueImpl* impl = (mamaQueueImpl*)queue;
+
+    return impl ? impl->mConflating : 0;
+}
+
 mama_status
 mamaQueueImpl_highWatermarkExceeded (mamaQueue queue,
                                      size_t    size)
@@ -1236,6 +1531,14 @@ mamaQueueImpl_highWatermarkExceeded (mamaQueue queue,
     if (!impl)
         return MAMA_STATUS_NULL_ARG;
 
+    if (impl->mConflateOnHighWatermark && !impl->mConflating)
+    {
+        mama_log (MAMA_LOG_LEVEL_FINE,
+                  "Queue [%s] conflating updates above high water mark : %d",
+                  impl->mQueueName, size);
+        impl->mConflating = 1;
+    }
+
     if (impl->mQueueMonitorCallbacks.onQueueHighWatermarkExceeded)
     {
         mama_log (MAMA_LOG_LEVEL_FINE,
@@ -1257,6 +1560,14 @@ mamaQueueImpl_lowWatermarkExceeded (mamaQueue queue,
 
     if (!impl) return MAMA_STATUS_NULL_ARG;
 
+    if (impl->mConflating)
+    {
+        mama_log (MAMA_LOG_LEVEL_FINE,
+                  "Queue [%s] no longer conflating updates : %d",
+                  impl->mQueueName, size);
+        impl->mConflating = 0;
+    }
+
     if (impl->mQueueMonitorCallbacks.onQueueLowWatermark)
     {
         mama_log (MAMA_LOG_LEVEL_FINE,
@@ -1270,6 +1581,54 @@ mamaQueueImpl_lowWatermarkExceeded (mamaQueue queue,
     return MAMA_STATUS_OK;
 }
 
+/*
+ * Dispatch loop used when a spin interval is configured. While events keep
+ * arriving they are dispatched without ever waiting on the queue semaphore.
+ * Once the queue has been empty for the spin interval the thread blocks in
+ * mamaQueue_dispatchEvent until the next event arrives, and only starts
+ * spinning again after dispatching it, so an idle queue does not burn a core.
+ */
+static void
+dispatcherImpl_spin (mamaDispatcherImpl* impl)
+{
+    mamaQueue   queue      = impl->mQueue;
+    mama_status status     = MAMA_STATUS_OK;
+    mama_u64_t  spinNanos  = impl->mSpinMicros * 1000;
+    mama_u64_t  spinStart  = 0;
+    size_t      count      = 0;
+
+    impl->mQueue->mIsDispatching = 1;
+
+    while (impl->mIsDispatching && !impl->mDestroy &&
+           MAMA_STATUS_OK == status)
+    {
+        mamaQueue_getEventCount (queue, &count);
+
+        if (count > 0)
+        {
+            /* A zero timeout never waits but still checks the watermarks */
+            status    = mamaQueue_timedDispatch (queue, 0);
+            spinStart = 0;
+        }
+        else if (0 == spinStart)
+        {
+            spinStart = mamaLatency_getTimestamp ();
+        }
+        else if (mamaLatency_getTimestamp () - spinStart >= spinNanos)
+        {
+            /* Woken by mamaDispatcher_destroy if stopped while blocked */
+            status    = mamaQueue_dispatchEvent (queue);
+            spinStart = 0;
+        }
+    }
+}
+
+/* Enqueued to wake a spinning dispatcher blocked waiting for an event. */
+static void MAMACALLTYPE
+dispatcherImpl_wakeCb (mamaQueue queue, void* closure)
+{
+}
+
 static void
 *dispatchThreadProc( void *closure )
 {
@@ -1277,6 +1636,11 @@ static void
 
     impl->mIsDispatching = 1;
 
+    if (impl->mSpinMicros > 0)
+    {
+        dispatcherImpl_spin (impl);
+    }
+
     while (impl->mIsDispatching && !impl->mDestroy &&
            MAMA_STATUS_OK == mamaQueue_dispatch (impl->mQueue))
         ;
@@ -1289,6 +1653,113 @@ static void
     return NULL;
 }
 
+static const char*
+dispatcherImpl_getProperty (mamaQueueImpl* queue,
+                            const char*    property)
+{
+    char name[256];
+
+    if (NULL == queue->mQueueName)
+        return NULL;
+
+    snprintf (name, sizeof (name), "mama.queue.%s.%s",
+              queue->mQueueName, property);
+
+    return mama_getProperty (name);
+}
+
+/*
+ * Parse a CPU list such as "2", "2,3" or "4-7" into cpus, returning the
+ * number of entries written.
+ */
+static unsigned int
+dispatcherImpl_parseCpus (const char*   value,
+                          unsigned int* cpus,
+                          unsigned int  maxCpus)
+{
+    unsigned int count = 0;
+    char*        end   = NULL;
+
+    while (*value && count < maxCpus)
+    {
+        unsigned long first = strtoul (value, &end, 10);
+        unsigned long last  = first;
+
+        if (end == value)
+            break;
+
+        if ('-' == *end)
+        {
+            value = end + 1;
+            last  = strtoul (value, &end, 10);
+            if (end == value)
+                break;
+        }
+
+        for (; first <= last && count < maxCpus; first++)
+            cpus[count++] = (unsigned int)first;
+
+        if (',' != *end)
+            break;
+        value = end + 1;
+    }
+
+    return count;
+}
+
+/*
+ * Apply the mama.queue.<name>.cpu, .sched and .priority properties to the
+ * dispatch thread. Failures are logged but are not fatal, the dispatcher
+ * still runs where the operating system puts it.
+ */
+static void
+dispatcherImpl_placeThread (mamaDispatcherImpl* impl,
+                            mamaQueueImpl*      queue)
+{
+    const char*  value = NULL;
+    unsigned int cpus[MAMADISPATCHER_MAX_CPUS];
+    unsigned int count = 0;
+
+    if (NULL != (value = dispatcherImpl_getProperty (queue,
+                                        MAMADISPATCHER_PROPERTY_CPU)))
+    {
+        count = dispatcherImpl_parseCpus (value, cpus,
+                                          MAMADISPATCHER_MAX_CPUS);
+
+        if (0 == count ||
+            0 != wthread_set_cpu_affinity (impl->mThread, cpus, count))
+        {
+            mama_log (MAMA_LOG_LEVEL_WARN, "mamaDispatcher_create(): Could "
+                      "not pin queue [%s] to CPUs [%s].",
+                      queue->mQueueName, value);
+        }
+    }
+
+    if (NULL != (value = dispatcherImpl_getProperty (queue,
+                                        MAMADISPATCHER_PROPERTY_SCHED)))
+    {
+        int         policy   = WTHREAD_SCHED_OTHER;
+        int         priority = 0;
+        const char* prio     = dispatcherImpl_getProperty (queue,
+                                        MAMADISPATCHER_PROPERTY_PRIORITY);
+
+        if (0 == strcasecmp (value, "fifo"))
+            policy = WTHREAD_SCHED_FIFO;
+        else if (0 == strcasecmp (value, "rr"))
+            policy = WTHREAD_SCHED_RR;
+
+        if (NULL != prio)
+            priority = atoi (prio);
+
+        if (0 != wthread_set_scheduler (impl->mThread, policy, priority))
+        {
+            mama_log (MAMA_LOG_LEVEL_WARN, "mamaDispatcher_create(): Could "
+                      "not set scheduler [%s] priority [%d] for queue [%s].",
+                      value, priority, queue->mQueueName);
+        }
+    }
+}
+
 mama_status
 mamaDispatcher_create (mamaDispatcher *result,
                        mamaQueue      queue)
@@ -1325,6 +1796,14 @@ mamaDispatcher_create (mamaDispatcher *result,
 
     impl->mQueue = queue;
     impl->mDestroy = 0;
+
+    {
+        const char* spin = dispatcherImpl_getProperty (qImpl,
+                                            MAMADISPATCHER_PROPERTY_SPIN);
+        if (NULL != spin)
+            impl->mSpinMicros = strtoul (spin, NULL, 10);
+    }
+
     if (wthread_create(&impl->mThread, NULL, dispatchThreadProc, impl))
     {
         free (impl);
@@ -1333,6 +1812,8 @@ mamaDispatcher_create (mamaDispatcher *result,
         return MAMA_STATUS_SYSTEM_ERROR;
     }
 
+    dispatcherImpl_placeThread (impl, qImpl);
+
     qImpl->mDispatcher = (mamaDispatcher)impl;
     *result = (mamaDispatcher)impl;
 
@@ -1355,6 +1836,12 @@ mamaDispatcher_destroy (mamaDispatcher dispatcher)
 
     impl->mDestroy = 1;
 
+    /* A spinning dispatcher may be blocked until the next event arrives */
+    if (impl->mQueue && impl->mSpinMicros > 0)
+    {
+        mamaQueue_enqueueEvent (impl->mQueue, dispatcherImpl_wakeCb, NULL);
+    }
+
     /* Wait for the thread to return. */
     wthread_join (impl->mThread, NULL);
 
@@ -1383,3 +1870,25 @@ mamaQueue_pollQueueSizeCb (void* closure)
 
     return count;
 }
+
+/* The residency stats report the moving average kept for the residency
+ * watermarks and the largest residency seen in the interval. */
+int MAMACALLTYPE
+mamaQueue_pollResidencyAvgCb (void* closure)
+{
+    mamaQueueImpl* impl = (mamaQueueImpl*)closure;
+
+    return (int)(impl->mResidencyAverage / 1000);
+}
+
+int MAMACALLTYPE
+mamaQueue_pollResidencyMaxCb (void* closure)
+{
+    mamaQueueImpl* impl = (mamaQueueImpl*)closure;
+    mama_u64_t     max  = impl->mResidencyMax;
+
+    /* Start a new interval, an event recorded in between may be lost */
+    impl->mResidencyMax = 0;
+
+    return (int)(max / 1000);
+}
@@ -103,6 +103,20 @@ MAMAExpDLL
 extern mama_status
 mamaQueueImpl_lowWatermarkExceeded (mamaQueue queue, size_t size);
 
+/* Returns non zero while the queue is above its high watermark and
+ * conflation has been enabled with mamaQueue_setConflateOnHighWatermark.
+ * Bridges which support it then merge successive updates for a subscription
+ * into the one still waiting on the queue. */
+MAMAExpDLL
+extern int
+mamaQueueImpl_isConflating (mamaQueue queue);
+
+/* Called by the middleware bridge layer, once residency has been enabled,
+ * with the time in nanoseconds each event spent queued */
+MAMAExpDLL
+extern void
+mamaQueueImpl_recordResidency (mamaQueue queue, mama_u64_t residency);
+
 MAMAExpDLL
 extern mamaStatsCollector 
 mamaQueueImpl_getStatsCollector (mamaQueue queue);
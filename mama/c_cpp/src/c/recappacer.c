@@ -0,0 +1,154 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#include "recappacer.h"
+
+/* Weight given to the latest update in the smoothed reply rate. */
+#define RECAP_PACER_REPLY_WEIGHT    0.2
+
+void
+recapPacer_init (recapPacer*    pacer,
+                 double         minRate,
+                 double         maxRate,
+                 double         burst,
+                 unsigned long  maxOutstanding,
+                 unsigned long  queueHighWatermark)
+{
+    if (minRate > maxRate)
+        minRate = maxRate;
+
+    pacer->mMinRate            = minRate;
+    pacer->mMaxRate            = maxRate;
+    pacer->mBurst              = burst;
+    pacer->mMaxOutstanding     = maxOutstanding;
+    pacer->mQueueHighWatermark = queueHighWatermark;
+    pacer->mRate               = maxRate;
+    pacer->mTokens             = burst;
+    pacer->mReplyRate          = 0.0;
+    pacer->mLastReplies        = 0;
+
+    wInterlocked_initialize (&pacer->mOutstanding);
+    wInterlocked_set (0, &pacer->mOutstanding);
+    wInterlocked_initialize (&pacer->mReplies);
+    wInterlocked_set (0, &pacer->mReplies);
+}
+
+void
+recapPacer_destroy (recapPacer* pacer)
+{
+    wInterlocked_destroy (&pacer->mOutstanding);
+    wInterlocked_destroy (&pacer->mReplies);
+}
+
+int
+recapPacer_update (recapPacer*      pacer,
+                   unsigned long    depth,
+                   double           elapsed)
+{
+    unsigned int  replies     =
+        (unsigned int)wInterlocked_read (&pacer->mReplies);
+    unsigned long outstanding =
+        (unsigned long)wInterlocked_read (&pacer->mOutstanding);
+    int           backoff     = 0;
+
+    if (elapsed <= 0.0)
+        return 0;
+
+    pacer->mReplyRate   = RECAP_PACER_REPLY_WEIGHT *
+                              ((replies - pacer->mLastReplies) / elapsed) +
+                          (1.0 - RECAP_PACER_REPLY_WEIGHT) * pacer->mReplyRate;
+    pacer->mLastReplies = replies;
+
+    if (depth > pacer->mQueueHighWatermark ||
+        outstanding > pacer->mMaxOutstanding)
+    {
+        /* The source or our own send queue is falling behind. */
+        pacer->mRate *= 0.5;
+        if (pacer->mRate < pacer->mMinRate)
+            pacer->mRate = pacer->mMinRate;
+        backoff = 1;
+    }
+    else if (depth < pacer->mQueueHighWatermark / 2 &&
+             outstanding < pacer->mMaxOutstanding / 2)
+    {
+        /* Grow in steps sized by how quickly the source is answering. */
+        double step = RECAP_PACER_REPLY_WEIGHT * pacer->mReplyRate;
+        if (step < pacer->mMinRate)
+            step = pacer->mMinRate;
+
+        pacer->mRate += step;
+        if (pacer->mRate > pacer->mMaxRate)
+            pacer->mRate = pacer->mMaxRate;
+    }
+
+    pacer->mTokens += pacer->mRate * elapsed;
+    if (pacer->mTokens > pacer->mBurst)
+        pacer->mTokens = pacer->mBurst;
+
+    return backoff;
+}
+
+unsigned long
+recapPacer_getBudget (recapPacer*   pacer,
+                      unsigned long depth)
+{
+    unsigned long tokens = (unsigned long)pacer->mTokens;
+
+    return tokens > depth ? tokens - depth : 0;
+}
+
+void
+recapPacer_consume (recapPacer*     pacer,
+                    unsigned long   sent)
+{
+    pacer->mTokens -= sent;
+    if (pacer->mTokens < 0.0)
+        pacer->mTokens = 0.0;
+}
+
+void
+recapPacer_requested (recapPacer*       pacer,
+                      wInterlockedInt*  pending)
+{
+    if (0 == wInterlocked_set (1, pending))
+        wInterlocked_increment (&pacer->mOutstanding);
+}
+
+int
+recapPacer_replied (recapPacer*         pacer,
+                    wInterlockedInt*    pending)
+{
+    if (0 == wInterlocked_set (0, pending))
+        return 0;
+
+    wInterlocked_decrement (&pacer->mOutstanding);
+    wInterlocked_increment (&pacer->mReplies);
+    return 1;
+}
+
+void
+recapPacer_cancel (recapPacer*      pacer,
+                   wInterlockedInt* pending)
+{
+    if (0 != wInterlocked_set (0, pending))
+        wInterlocked_decrement (&pacer->mOutstanding);
+}
@@ -0,0 +1,145 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#ifndef RecapPacerH__
+#define RecapPacerH__
+
+#include "mama/mama.h"
+#include "wombat/wInterlocked.h"
+
+/**
+ * A token bucket pacing recap and refresh requests against how quickly the
+ * source answers them. The rate backs off when solicited recaps go
+ * unanswered or requests queue up in the throttle they are sent through,
+ * and grows with the measured rate of solicited replies otherwise.
+ *
+ * Requests and replies are matched per subscription through a pending flag
+ * owned by the caller, so replies that were not asked for (initials, recaps
+ * requested for gaps or by the source) never count towards the reply rate.
+ * Only the request, reply and cancel calls are thread safe.
+ */
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef struct recapPacer_
+{
+    /* Requests that may be sent now */
+    double          mTokens;
+    /* Tokens added per second, between mMinRate and mMaxRate */
+    double          mRate;
+    double          mMinRate;
+    double          mMaxRate;
+    /* Most tokens that may be held */
+    double          mBurst;
+    /* Smoothed solicited replies per second */
+    double          mReplyRate;
+    unsigned long   mMaxOutstanding;
+    unsigned long   mQueueHighWatermark;
+    /* Solicited requests not yet answered */
+    wInterlockedInt mOutstanding;
+    /* Solicited replies received, mLastReplies as of the last update */
+    wInterlockedInt mReplies;
+    unsigned int    mLastReplies;
+} recapPacer;
+
+/**
+ * Initialise the pacer at its maximum rate with a full bucket, so recovery
+ * is not delayed until pressure is seen.
+ */
+MAMAExpDLL
+extern void
+recapPacer_init (recapPacer*    pacer,
+                 double         minRate,
+                 double         maxRate,
+                 double         burst,
+                 unsigned long  maxOutstanding,
+                 unsigned long  queueHighWatermark);
+
+MAMAExpDLL
+extern void
+recapPacer_destroy (recapPacer* pacer);
+
+/**
+ * Adapt the rate to the replies received and the requests queued (depth)
+ * since the last update, then refill the bucket for the elapsed seconds.
+ *
+ * @return Non zero if the rate backed off.
+ */
+MAMAExpDLL
+extern int
+recapPacer_update (recapPacer*      pacer,
+                   unsigned long    depth,
+                   double           elapsed);
+
+/**
+ * The number of requests that may be sent now, less any already queued.
+ */
+MAMAExpDLL
+extern unsigned long
+recapPacer_getBudget (recapPacer*   pacer,
+                      unsigned long depth);
+
+/**
+ * Take the tokens for requests that were sent. Requests that could not be
+ * held back empty the bucket rather than overdraw it.
+ */
+MAMAExpDLL
+extern void
+recapPacer_consume (recapPacer*     pacer,
+                    unsigned long   sent);
+
+/**
+ * Mark a subscription as waiting on a solicited recap. This must be called
+ * before the request is sent. A subscription already waiting is not counted
+ * twice.
+ */
+MAMAExpDLL
+extern void
+recapPacer_requested (recapPacer*       pacer,
+                      wInterlockedInt*  pending);
+
+/**
+ * Count a recap received for a subscription.
+ *
+ * @return Non zero if the recap was solicited and so counted as a reply.
+ */
+MAMAExpDLL
+extern int
+recapPacer_replied (recapPacer*         pacer,
+                    wInterlockedInt*    pending);
+
+/**
+ * Stop waiting on a recap that will not arrive, for example because the
+ * request failed or the subscription went away.
+ */
+MAMAExpDLL
+extern void
+recapPacer_cancel (recapPacer*      pacer,
+                   wInterlockedInt* pending);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* RecapPacerH__ */
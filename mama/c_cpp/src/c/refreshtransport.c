@@ -37,15 +37,31 @@
 #include "mama/timer.h"
 #include "mama/msg.h"
 #include "mama/subscmsgtype.h"
+#include "mama/stat.h"
+#include "mama/statfields.h"
+#include "mama/latency.h"
 #include "msgutils.h"
 #include "bridge.h"
 #include "transportimpl.h"
 #include "subscriptionimpl.h"
 #include "list.h"
+#include "throttle.h"
+#include "recappacer.h"
+#include "statinternal.h"
 #include "refreshtransport.h"
 
 #define SYNC_SUBJECTS_PER_MESSAGE  100
 
+/* Stale recaps are released from a token bucket refilled on this interval. */
+#define RECAP_PACING_INTERVAL               0.1 /* Seconds */
+#define RECAP_PACING_DEFAULT_MIN_RATE       10.0
+#define RECAP_PACING_DEFAULT_MAX_RATE       1000.0
+#define RECAP_PACING_DEFAULT_BURST          100.0
+#define RECAP_PACING_DEFAULT_OUTSTANDING    1000
+#define RECAP_PACING_DEFAULT_HIGH_WATERMARK 500
+
+extern int gGenerateTransportStats;
+
 typedef struct refreshTransportImpl_
 {
     mamaTransport      mMamaTransport;
@@ -55,8 +71,32 @@ typedef struct refreshTransportImpl_
     wList              mListeners;
     wList              mNewListeners;
     mamaBridgeImpl*    mBridgeImpl;
+
+    /* Stale recap pacing. Each stale recap timeout starts a new round and
+     * every MAYBE_STALE subscription is recapped once per round, as fast as
+     * the pacer allows. Early refreshes of new subscriptions are sized from
+     * the same pacer, and only get what the stale recaps leave while a
+     * round is active. */
+    int                mPacingEnabled;
+    mamaTimer          mPacingTimer;
+    unsigned int       mRecapRound;
+    recapPacer         mPacer;
+    mama_u64_t         mLastUpdate;
+    unsigned long      mBacklog;
+    mamaStat           mRateStat;
+    mamaStat           mSentStat;
+    mamaStat           mDeferredStat;
+    mamaStat           mBackoffStat;
 } refreshTransportImpl;
 
+typedef struct staleRecapClosure_
+{
+    refreshTransportImpl*   mImpl;
+    long                    mBudget;
+    unsigned long           mSent;
+    unsigned long           mDeferred;
+} staleRecapClosure;
+
 
 static
 void refreshTransportImpl_doRefresh (refreshTransportImpl *impl);
@@ -64,6 +104,12 @@ void refreshTransportImpl_doRefresh (refreshTransportImpl *impl);
 static mama_status
 init (refreshTransportImpl *impl);
 
+static void
+refreshTransportImpl_initPacing (refreshTransportImpl *impl);
+
+static void
+refreshTransportImpl_startPacingTimer (refreshTransportImpl *impl);
+
 
 extern mama_status
 refreshTransport_create (refreshTransport*  result,
@@ -93,6 +139,8 @@ refreshTransport_create (refreshTransport*  result,
         impl->mStaleRecapTimeout = atoi (propstring);
     }
 
+    refreshTransportImpl_initPacing (impl);
+
     *result = impl;
 
     return init (impl);
@@ -130,6 +178,18 @@ refreshTransportImpl_staleRecapTimerCallback (mamaTimer timer, void *closure)
 {
 	refreshTransportImpl *impl = (refreshTransportImpl*)closure;
 	wombatThrottle  throttle = NULL;
+
+    mamaTimer_destroy (timer);
+    impl->mStaleRecapTimer = NULL;
+
+    if (impl->mPacingEnabled)
+    {
+        /* Stale subscriptions are recapped by the pacing timer. */
+        impl->mRecapRound++;
+        refreshTransportImpl_startPacingTimer (impl);
+        return;
+    }
+
 	if (impl->mMamaTransport)
         throttle = mamaTransportImpl_getThrottle (impl->mMamaTransport,
                                                	  MAMA_THROTTLE_RECAP);
@@ -141,8 +201,221 @@ refreshTransportImpl_staleRecapTimerCallback (mamaTimer timer, void *closure)
 
 	if (throttle)
             wombatThrottle_unlock (throttle);
+}
 
-    mamaTimer_destroy (timer);
+static void
+staleRecapIterator (wList list, void* element, void* closure)
+{
+    staleRecapClosure* recap   = (staleRecapClosure*)closure;
+    SubscriptionInfo*  subsc   = (SubscriptionInfo*)element;
+    mamaQuality        quality = MAMA_QUALITY_UNKNOWN;
+
+    if (subsc->mRecapRound == recap->mImpl->mRecapRound)
+        return;
+
+    mamaSubscription_getQuality (subsc->mSubscription, &quality);
+    if (quality != MAMA_QUALITY_MAYBE_STALE)
+        return;
+
+    if (recap->mBudget <= 0)
+    {
+        recap->mDeferred++;
+        return;
+    }
+
+    /* Marked first, the reply may be dispatched on another queue. */
+    subsc->mRecapRound = recap->mImpl->mRecapRound;
+    recapPacer_requested (&recap->mImpl->mPacer, &subsc->mRecapPending);
+    if (MAMA_STATUS_OK != mamaSubscription_requestRecap (subsc->mSubscription))
+    {
+        recapPacer_cancel (&recap->mImpl->mPacer, &subsc->mRecapPending);
+        return;
+    }
+    recap->mBudget--;
+    recap->mSent++;
+}
+
+static void
+refreshTransportImpl_updatePacer (refreshTransportImpl *impl,
+                                  unsigned long         depth)
+{
+    mama_u64_t now     = mamaLatency_getTimestamp ();
+    double     elapsed = (now - impl->mLastUpdate) / 1000000000.0;
+
+    impl->mLastUpdate = now;
+
+    if (recapPacer_update (&impl->mPacer, depth, elapsed))
+    {
+        if (impl->mBackoffStat)
+            mamaStat_increment (impl->mBackoffStat);
+
+        mama_log (MAMA_LOG_LEVEL_FINE,
+                  "refreshTransport: recap pacing backing off to %.1f/s "
+                  "[outstanding=%d queued=%lu replies=%.1f/s]",
+                  impl->mPacer.mRate,
+                  wInterlocked_read (&impl->mPacer.mOutstanding),
+                  depth,
+                  impl->mPacer.mReplyRate);
+    }
+}
+
+static void MAMACALLTYPE
+refreshTransportImpl_pacingTimerCallback (mamaTimer timer, void *closure)
+{
+    refreshTransportImpl *impl     = (refreshTransportImpl*)closure;
+    wombatThrottle        throttle = NULL;
+    unsigned long         depth    = 0;
+    staleRecapClosure     recap;
+
+    if (impl->mMamaTransport)
+        throttle = mamaTransportImpl_getThrottle (impl->mMamaTransport,
+                                                  MAMA_THROTTLE_RECAP);
+    if (throttle)
+        depth = wombatThrottle_getPending (throttle);
+
+    refreshTransportImpl_updatePacer (impl, depth);
+
+    recap.mImpl     = impl;
+    recap.mBudget   = (long)recapPacer_getBudget (&impl->mPacer, depth);
+    recap.mSent     = 0;
+    recap.mDeferred = 0;
+
+    if (throttle)
+        wombatThrottle_lock (throttle);
+
+    refreshTransport_iterateListeners (impl, staleRecapIterator, &recap);
+
+    if (throttle)
+        wombatThrottle_unlock (throttle);
+
+    recapPacer_consume (&impl->mPacer, recap.mSent);
+    impl->mBacklog = recap.mDeferred;
+
+    if (impl->mSentStat && recap.mSent > 0)
+        mamaStat_add (impl->mSentStat, (int)recap.mSent);
+
+    /* The round is over once every stale subscription has been recapped. */
+    if (recap.mDeferred == 0)
+    {
+        mama_log (MAMA_LOG_LEVEL_FINE,
+                  "refreshTransport: stale recap round %u complete",
+                  impl->mRecapRound);
+        mamaTimer_destroy (timer);
+        impl->mPacingTimer = NULL;
+    }
+}
+
+static void
+refreshTransportImpl_startPacingTimer (refreshTransportImpl *impl)
+{
+    mama_status status = MAMA_STATUS_OK;
+
+    if (impl->mPacingTimer != NULL) return;
+
+    if (MAMA_STATUS_OK!=(status=mamaTimer_create (
+                &impl->mPacingTimer,
+                impl->mBridgeImpl->mDefaultEventQueue,
+                refreshTransportImpl_pacingTimerCallback,
+                RECAP_PACING_INTERVAL,
+                impl)))
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "refreshTransport_startPacingTimer (): Failed to create"
+                  " timer. [%s]", mamaStatus_stringForStatus (status));
+    }
+}
+
+static int MAMACALLTYPE
+refreshTransportImpl_pollRateCb (void* closure)
+{
+    return (int)((refreshTransportImpl*)closure)->mPacer.mRate;
+}
+
+static int MAMACALLTYPE
+refreshTransportImpl_pollDeferredCb (void* closure)
+{
+    return (int)((refreshTransportImpl*)closure)->mBacklog;
+}
+
+static double
+refreshTransportImpl_getPacingProperty (const char* name, double defaultValue)
+{
+    const char* propstring = properties_Get (mamaInternal_getProperties (),
+                                             name);
+    double      value      = propstring ? atof (propstring) : 0.0;
+
+    return value > 0.0 ? value : defaultValue;
+}
+
+static void
+refreshTransportImpl_initPacing (refreshTransportImpl *impl)
+{
+    const char*        propstring = NULL;
+    mamaStatsCollector collector  = NULL;
+
+    propstring = properties_Get (mamaInternal_getProperties (),
+            "mama.recap.pacing.enable");
+    impl->mPacingEnabled = propstring ?
+        properties_GetPropertyValueAsBoolean (propstring) : 1;
+
+    recapPacer_init (&impl->mPacer,
+        refreshTransportImpl_getPacingProperty (
+            "mama.recap.pacing.min_rate", RECAP_PACING_DEFAULT_MIN_RATE),
+        refreshTransportImpl_getPacingProperty (
+            "mama.recap.pacing.max_rate", RECAP_PACING_DEFAULT_MAX_RATE),
+        refreshTransportImpl_getPacingProperty (
+            "mama.recap.pacing.burst", RECAP_PACING_DEFAULT_BURST),
+        (unsigned long)refreshTransportImpl_getPacingProperty (
+            "mama.recap.pacing.max_outstanding",
+            RECAP_PACING_DEFAULT_OUTSTANDING),
+        (unsigned long)refreshTransportImpl_getPacingProperty (
+            "mama.recap.pacing.queue_high_watermark",
+            RECAP_PACING_DEFAULT_HIGH_WATERMARK));
+    impl->mLastUpdate = mamaLatency_getTimestamp ();
+
+    if (!impl->mPacingEnabled || !gGenerateTransportStats)
+        return;
+
+    collector = mamaTransport_getStatsCollector (impl->mMamaTransport);
+    if (collector == NULL)
+        return;
+
+    if (MAMA_STATUS_OK == mamaStat_create (&impl->mRateStat, collector,
+                                           MAMA_STAT_NOT_LOCKABLE,
+                                           MamaStatRecapPacingRate.mName,
+                                           MamaStatRecapPacingRate.mFid))
+    {
+        mamaStat_setPollCallback (impl->mRateStat,
+                                  refreshTransportImpl_pollRateCb, impl);
+    }
+
+    if (MAMA_STATUS_OK == mamaStat_create (&impl->mDeferredStat, collector,
+                                           MAMA_STAT_NOT_LOCKABLE,
+                                           MamaStatRecapPacingDeferred.mName,
+                                           MamaStatRecapPacingDeferred.mFid))
+    {
+        mamaStat_setPollCallback (impl->mDeferredStat,
+                                  refreshTransportImpl_pollDeferredCb, impl);
+    }
+
+    mamaStat_create (&impl->mSentStat, collector, MAMA_STAT_LOCKABLE,
+                     MamaStatRecapPacingSent.mName,
+                     MamaStatRecapPacingSent.mFid);
+
+    mamaStat_create (&impl->mBackoffStat, collector, MAMA_STAT_LOCKABLE,
+                     MamaStatRecapPacingBackoffs.mName,
+                     MamaStatRecapPacingBackoffs.mFid);
+}
+
+void
+refreshTransport_recapReceived (refreshTransport transport, void* handle)
+{
+    refreshTransportImpl *impl = (refreshTransportImpl*)transport;
+    SubscriptionInfo     *info = (SubscriptionInfo*)handle;
+
+    /* Only recaps asked for by the pacer count as replies. */
+    if (info)
+        recapPacer_replied (&impl->mPacer, &info->mRecapPending);
 }
 
 static void
@@ -233,6 +506,25 @@ refreshTransport_destroy (refreshTransport transport)
         impl->mRefreshTimer = NULL;
     }
 
+    if (impl->mStaleRecapTimer != NULL)
+    {
+        mamaTimer_destroy (impl->mStaleRecapTimer);
+        impl->mStaleRecapTimer = NULL;
+    }
+
+    if (impl->mPacingTimer != NULL)
+    {
+        mamaTimer_destroy (impl->mPacingTimer);
+        impl->mPacingTimer = NULL;
+    }
+
+    if (impl->mRateStat)     mamaStat_destroy (impl->mRateStat);
+    if (impl->mSentStat)     mamaStat_destroy (impl->mSentStat);
+    if (impl->mDeferredStat) mamaStat_destroy (impl->mDeferredStat);
+    if (impl->mBackoffStat)  mamaStat_destroy (impl->mBackoffStat);
+
+    recapPacer_destroy (&impl->mPacer);
+
     free (impl);
 
     return MAMA_STATUS_OK;
@@ -245,6 +537,9 @@ refreshTransport_addSubscription (refreshTransport transport,
     refreshTransportImpl *impl = (refreshTransportImpl*)transport;
 
     info->mNextRefreshTime = time (NULL) + MAMA_REFRESHINTERVALRAND * 60;
+    info->mRecapRound      = 0;
+    wInterlocked_initialize (&info->mRecapPending);
+    wInterlocked_set (0, &info->mRecapPending);
     list_push_back (impl->mNewListeners, info);
 
     return;
@@ -261,6 +556,7 @@ refreshTransportImpl_processNewSubscriptions (refreshTransportImpl *impl)
     int newListenerCount = 0;
     int messagesPerInterval = 0;
     int maxMessages = 0;
+    unsigned long depth = 0;
     time_t curTime = time (NULL);
     wombatThrottle  throttle = NULL;
 
@@ -274,7 +570,11 @@ refreshTransportImpl_processNewSubscriptions (refreshTransportImpl *impl)
     if (impl->mMamaTransport)
         throttle = mamaTransportImpl_getThrottle (impl->mMamaTransport,
                                                MAMA_THROTTLE_DEFAULT);
-    if (throttle) wombatThrottle_lock (throttle);
+    if (throttle)
+    {
+        wombatThrottle_lock (throttle);
+        depth = wombatThrottle_getPending (throttle);
+    }
 
     list_lock (impl->mNewListeners);/* Always lock new listeners first */
      cur  = (SubscriptionInfo*)list_get_head (impl->mNewListeners);
@@ -293,31 +593,50 @@ refreshTransportImpl_processNewSubscriptions (refreshTransportImpl *impl)
         return;
     }
 
-    /* We also need to introduce a random component. We compute the number of
-     * intervals between now and the time that the last message must go out. We
-     * use this value to compute the number of messages required/interval, and
-     * then choose a random value.
-     */
-    intervals = (last->mNextRefreshTime - curTime)/REFRESH_GRANULARITY;
-
-    /*Just in case the interval is 0 due to truncation when
-     last->mNextRefreshTime - curTime < REFRESH_GRANULARITY*/
-    if (intervals == 0)
+    if (impl->mPacingEnabled)
     {
-        mama_log (MAMA_LOG_LEVEL_FINER,"processNewSubscriptions () interval was 0");
-        mama_log (MAMA_LOG_LEVEL_FINER,"last->mNextRefreshTime [%d] curTime [%d]",
-                                        last->mNextRefreshTime, curTime);
-
-        intervals = 1;
+        /* Size the batch from the measured reply rate, less whatever is
+         * already queued in the throttle. While stale recaps are being paced
+         * the pacing timer refills the bucket and they take priority, so
+         * refreshes only get what is left. Refreshes that are due are always
+         * sent. */
+        if (impl->mPacingTimer == NULL)
+            refreshTransportImpl_updatePacer (impl, depth);
+
+        maxMessages = (int)recapPacer_getBudget (&impl->mPacer, depth);
+
+        mama_log (MAMA_LOG_LEVEL_FINER,
+                  "Refresh budget %d [queued=%lu replies=%.1f/s]",
+                  maxMessages, depth, impl->mPacer.mReplyRate);
     }
+    else
+    {
+        /* We also need to introduce a random component. We compute the number of
+         * intervals between now and the time that the last message must go out. We
+         * use this value to compute the number of messages required/interval, and
+         * then choose a random value.
+         */
+        intervals = (last->mNextRefreshTime - curTime)/REFRESH_GRANULARITY;
 
-    messagesPerInterval = newListenerCount/intervals;
+        /*Just in case the interval is 0 due to truncation when
+         last->mNextRefreshTime - curTime < REFRESH_GRANULARITY*/
+        if (intervals == 0)
+        {
+            mama_log (MAMA_LOG_LEVEL_FINER,"processNewSubscriptions () interval was 0");
+            mama_log (MAMA_LOG_LEVEL_FINER,"last->mNextRefreshTime [%d] curTime [%d]",
+                                            last->mNextRefreshTime, curTime);
 
-     /*
-     * Multiply by 2 so on average we send the correct number of messages.
-     */
-    maxMessages = 2*( 1 + ((double)rand ()/(double)RAND_MAX) *
-                      messagesPerInterval);
+            intervals = 1;
+        }
+
+        messagesPerInterval = newListenerCount/intervals;
+
+         /*
+         * Multiply by 2 so on average we send the correct number of messages.
+         */
+        maxMessages = 2*( 1 + ((double)rand ()/(double)RAND_MAX) *
+                          messagesPerInterval);
+    }
 
     mama_log (MAMA_LOG_LEVEL_FINER, "Sending some refreshes");
 
@@ -333,7 +652,7 @@ refreshTransportImpl_processNewSubscriptions (refreshTransportImpl *impl)
          */
 
         if ((cur->mNextRefreshTime > curTime + REFRESH_GRANULARITY) &&
-            (cur->mNextRefreshTime > dontRefreshBefore ||  sent > maxMessages))
+            (cur->mNextRefreshTime > dontRefreshBefore ||  sent >= maxMessages))
         {
             break;
         }
@@ -358,6 +677,8 @@ refreshTransportImpl_processNewSubscriptions (refreshTransportImpl *impl)
     if (throttle)
             wombatThrottle_unlock (throttle);
 
+    if (impl->mPacingEnabled)
+        recapPacer_consume (&impl->mPacer, sent);
 }
 
 static
@@ -449,6 +770,10 @@ refreshTransport_removeListener (refreshTransportImpl* impl,  void *handle,
     list_lock (impl->mNewListeners); /* Always lock new listeners first */
     list_lock (impl->mListeners);
 
+    /* A recap still awaited will never be answered for this listener. */
+    if (freeElement)
+        recapPacer_cancel (&impl->mPacer, &info->mRecapPending);
+
     if (info->mIsInMainList)
     {
         list_remove_element (impl->mListeners, handle);
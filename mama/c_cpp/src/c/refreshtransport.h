@@ -64,6 +64,12 @@ refreshTransport_allocateSubscInfo (refreshTransport transport);
 extern void
 refreshTransport_startStaleRecapTimer (struct refreshTransportImpl_ *impl);
 
+/* Count a recap received for the listener handle, if it was solicited by
+ * the stale recap pacing. */
+extern void
+refreshTransport_recapReceived (refreshTransport transport,
+                                void*            handle);
+
 
 #if defined(__cplusplus)
 }
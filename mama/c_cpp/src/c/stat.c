@@ -29,6 +29,32 @@
 #include "mama/stat.h"
 #include "statinternal.h"
 
+/* Number of per-thread counters in a sharded stat, a power of two. Threads
+   beyond this share counters, which stays correct but may contend. */
+#define MAMA_STAT_NUM_SHARDS    16
+#define MAMA_STAT_CACHE_LINE    64
+
+#if defined(__GNUC__)
+#define MAMA_STAT_ATOMIC_ADD(ptr, value) \
+    __sync_fetch_and_add ((ptr), (value))
+#else
+#define MAMA_STAT_ATOMIC_ADD(ptr, value) \
+    InterlockedExchangeAdd ((volatile LONG*)(ptr), (LONG)(value))
+#endif
+
+/* One thread's running sum, alone on its cache line. */
+typedef struct mamaStatShard_
+{
+    volatile mama_i32_t mValue;
+    char                mPad[MAMA_STAT_CACHE_LINE - sizeof (mama_i32_t)];
+} mamaStatShard;
+
+static int                    gShardLockable      = 0;
+static int                    gShardKeyCreated    = 0;
+static wthread_key_t          gShardKey;
+static mama_u32_t             gNextShard          = 0;
+static wthread_static_mutex_t gShardMutex         = WSTATIC_MUTEX_INITIALIZER;
+
 typedef struct mamaStatImpl__
 {
     const char*         mName;
@@ -43,8 +69,104 @@ typedef struct mamaStatImpl__
     int                 mPublish;
     int                 mLog;
     wthread_mutex_t     mUpdateMutex;
+
+    /* Sharded stats only: the counters, the allocation they were aligned
+       within, and their sum when last collected */
+    mamaStatShard*      mShards;
+    void*               mShardMemory;
+    mama_i32_t          mShardSum;
 } mamaStatImpl;
 
+void
+mamaStat_setShardLockable (int sharded)
+{
+    gShardLockable = sharded;
+}
+
+/* The calling thread's shard, assigned round robin on first use. */
+static mamaStatShard*
+mamaStatImpl_getShard (mamaStatImpl* impl)
+{
+    size_t index = (size_t)wthread_getspecific (gShardKey);
+
+    if (index == 0)
+    {
+        wthread_static_mutex_lock (&gShardMutex);
+        index = (size_t)(++gNextShard);
+        wthread_static_mutex_unlock (&gShardMutex);
+
+        wthread_setspecific (gShardKey, index);
+    }
+
+    return &impl->mShards[(index - 1) & (MAMA_STAT_NUM_SHARDS - 1)];
+}
+
+static mama_status
+mamaStatImpl_createShards (mamaStatImpl* impl)
+{
+    size_t aligned;
+
+    wthread_static_mutex_lock (&gShardMutex);
+    if (!gShardKeyCreated)
+    {
+        if (wthread_key_create (&gShardKey, NULL) != 0)
+        {
+            wthread_static_mutex_unlock (&gShardMutex);
+            return MAMA_STATUS_PLATFORM;
+        }
+        gShardKeyCreated = 1;
+    }
+    wthread_static_mutex_unlock (&gShardMutex);
+
+    impl->mShardMemory = calloc (1, (MAMA_STAT_NUM_SHARDS + 1) *
+                                    sizeof (mamaStatShard));
+    if (impl->mShardMemory == NULL) return MAMA_STATUS_NOMEM;
+
+    aligned = ((size_t)impl->mShardMemory + MAMA_STAT_CACHE_LINE - 1) &
+              ~((size_t)MAMA_STAT_CACHE_LINE - 1);
+    impl->mShards   = (mamaStatShard*)aligned;
+    impl->mShardSum = 0;
+
+    return MAMA_STATUS_OK;
+}
+
+/* Fold what the threads have added since the last read into the interval,
+   max and total values. Called with mUpdateMutex held. */
+static void
+mamaStatImpl_collectShards (mamaStatImpl* impl)
+{
+    mama_i32_t sum   = 0;
+    mama_i32_t delta = 0;
+    int        i;
+
+    if (impl->mShards == NULL) return;
+
+    for (i = 0; i < MAMA_STAT_NUM_SHARDS; i++)
+    {
+        sum += impl->mShards[i].mValue;
+    }
+
+    delta            = sum - impl->mShardSum;
+    impl->mShardSum  = sum;
+
+    impl->mIntervalValue += delta;
+    impl->mTotalValue    += delta;
+    if (impl->mIntervalValue > (mama_i32_t)impl->mMaxValue)
+    {
+        impl->mMaxValue = impl->mIntervalValue;
+    }
+}
+
+static void
+mamaStatImpl_collect (mamaStatImpl* impl)
+{
+    if (impl->mShards == NULL) return;
+
+    wthread_mutex_lock (&impl->mUpdateMutex);
+    mamaStatImpl_collectShards (impl);
+    wthread_mutex_unlock (&impl->mUpdateMutex);
+}
+
 mama_status
 mamaStat_create (mamaStat* stat, mamaStatsCollector statsCollector, int lockable, const char* name, mama_fid_t fid)
 {
@@ -61,8 +183,28 @@ mamaStat_create (mamaStat* stat, mamaStatsCollector statsCollector, int lockable
     impl->mPublish         = 1;
     impl->mLog             = 1;
     impl->mLockable = lockable;
+    impl->mShards          = NULL;
+    impl->mShardMemory     = NULL;
+    impl->mShardSum        = 0;
 
-    if (lockable)
+    if (lockable == MAMA_STAT_LOCKABLE && gShardLockable)
+        lockable = MAMA_STAT_SHARDED;
+
+    if (lockable == MAMA_STAT_SHARDED)
+    {
+        mama_status status = mamaStatImpl_createShards (impl);
+        if (status != MAMA_STATUS_OK)
+        {
+            free ((char*)impl->mName);
+            free (impl);
+            return status;
+        }
+
+        /* Updates skip the mutex, which now only guards collection */
+        impl->mLockable = 0;
+        wthread_mutex_init (&impl->mUpdateMutex, NULL);
+    }
+    else if (lockable)
         wthread_mutex_init (&impl->mUpdateMutex, NULL);
 
     *stat = (mamaStat)impl;
@@ -82,9 +224,16 @@ mamaStat_destroy (mamaStat stat)
         impl->mName = NULL;
     }
 
-    if (impl->mLockable)
+    if (impl->mLockable || impl->mShards)
         wthread_mutex_destroy (&impl->mUpdateMutex);
 
+    if (impl->mShardMemory)
+    {
+        free (impl->mShardMemory);
+        impl->mShardMemory = NULL;
+        impl->mShards      = NULL;
+    }
+
     impl->mStatsCollector  = NULL;
     free (impl);
 
@@ -97,6 +246,12 @@ mamaStat_increment (mamaStat stat)
     mamaStatImpl* impl = (mamaStatImpl*)stat;
     if (!impl) return MAMA_STATUS_NULL_ARG;
 
+    if (impl->mShards)
+    {
+        MAMA_STAT_ATOMIC_ADD (&mamaStatImpl_getShard (impl)->mValue, 1);
+        return MAMA_STATUS_OK;
+    }
+
     if (impl->mLockable)
         wthread_mutex_lock (&impl->mUpdateMutex);
 
@@ -119,6 +274,12 @@ mamaStat_decrement (mamaStat stat)
     mamaStatImpl* impl = (mamaStatImpl*)stat;
     if (!impl) return MAMA_STATUS_NULL_ARG;
 
+    if (impl->mShards)
+    {
+        MAMA_STAT_ATOMIC_ADD (&mamaStatImpl_getShard (impl)->mValue, -1);
+        return MAMA_STATUS_OK;
+    }
+
     if (impl->mLockable)
     {
         wthread_mutex_lock (&impl->mUpdateMutex);
@@ -141,6 +302,15 @@ mamaStat_reset (mamaStat stat)
     mamaStatImpl* impl = (mamaStatImpl*)stat;
     if (!impl) return MAMA_STATUS_NULL_ARG;
 
+    if (impl->mShards)
+    {
+        wthread_mutex_lock (&impl->mUpdateMutex);
+        mamaStatImpl_collectShards (impl);
+        impl->mIntervalValue = 0;
+        wthread_mutex_unlock (&impl->mUpdateMutex);
+        return MAMA_STATUS_OK;
+    }
+
     if (impl->mLockable)
     {
         wthread_mutex_lock (&impl->mUpdateMutex);
@@ -161,6 +331,12 @@ mamaStat_add (mamaStat stat, int value)
     mamaStatImpl* impl = (mamaStatImpl*)stat;
     if (!impl) return MAMA_STATUS_NULL_ARG;
 
+    if (impl->mShards)
+    {
+        MAMA_STAT_ATOMIC_ADD (&mamaStatImpl_getShard (impl)->mValue, value);
+        return MAMA_STATUS_OK;
+    }
+
     if (impl->mLockable)
         wthread_mutex_lock (&impl->mUpdateMutex);
 
@@ -183,6 +359,12 @@ mamaStat_subtract (mamaStat stat, int value)
     mamaStatImpl* impl = (mamaStatImpl*)stat;
     if (!impl) return MAMA_STATUS_NULL_ARG;
 
+    if (impl->mShards)
+    {
+        MAMA_STAT_ATOMIC_ADD (&mamaStatImpl_getShard (impl)->mValue, -value);
+        return MAMA_STATUS_OK;
+    }
+
     if (impl->mLockable)
     {
         wthread_mutex_lock (&impl->mUpdateMutex);
@@ -206,6 +388,15 @@ mamaStat_setIntervalValue (mamaStat stat, int value)
       mamaStatImpl* impl = (mamaStatImpl*)stat;
     if (!impl) return MAMA_STATUS_NULL_ARG;
 
+    if (impl->mShards)
+    {
+        wthread_mutex_lock (&impl->mUpdateMutex);
+        mamaStatImpl_collectShards (impl);
+        impl->mIntervalValue = value;
+        wthread_mutex_unlock (&impl->mUpdateMutex);
+        return MAMA_STATUS_OK;
+    }
+
     if (impl->mLockable)
     {
         wthread_mutex_lock (&impl->mUpdateMutex);
@@ -260,6 +451,8 @@ mamaStat_getIntervalValue (mamaStat stat)
 {
     mamaStatImpl* impl = (mamaStatImpl*)stat;
 
+    mamaStatImpl_collect (impl);
+
     if (impl->mPollStatCallback != NULL)
     {
         impl->mIntervalValue = impl->mPollStatCallback (impl->mPollStatClosureData);
@@ -275,9 +468,11 @@ mamaStat_getIntervalValue (mamaStat stat)
 int
 mamaStat_getMaxValue (mamaStat stat)
 {
-    mamaStatImpl* impl = (mamaStatImpl*)stat;
+    mamaStatImpl* impl    = (mamaStatImpl*)stat;
+    int           current = 0;
+
+    mamaStatImpl_collect (impl);
 
-    int current = 0;
     if (impl->mPollStatCallback != NULL)
     {
         current = impl->mPollStatCallback (impl->mPollStatClosureData);
@@ -295,6 +490,8 @@ mamaStat_getTotalValue (mamaStat stat)
 {
     mamaStatImpl* impl = (mamaStatImpl*)stat;
 
+    mamaStatImpl_collect (impl);
+
     return impl->mTotalValue;
 }
 
@@ -303,6 +500,8 @@ mamaStat_getStats (mamaStat stat, mama_i32_t* intervalValue, mama_u32_t* maxValu
 {
     mamaStatImpl* impl = (mamaStatImpl*)stat;
 
+    mamaStatImpl_collect (impl);
+
     if (impl->mPollStatCallback != NULL)
     {
         impl->mIntervalValue = impl->mPollStatCallback (impl->mPollStatClosureData);
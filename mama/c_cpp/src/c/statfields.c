@@ -84,3 +84,39 @@ const MamaReservedField  MamaStatPublisherInboxSend
     = {"Publisher Inbox Send Msgs", 130};
 const MamaReservedField  MamaStatPublisherReplySend
     = {"Publisher Reply Send Msgs", 131};
+const MamaReservedField  MamaStatQueueLatencyP50
+    = {"Queue Latency p50", 132};
+const MamaReservedField  MamaStatQueueLatencyP99
+    = {"Queue Latency p99", 133};
+const MamaReservedField  MamaStatQueueLatencyP999
+    = {"Queue Latency p99.9", 134};
+const MamaReservedField  MamaStatQueueLatencyMax
+    = {"Queue Latency max", 135};
+const MamaReservedField  MamaStatCallbackLatencyP50
+    = {"Callback Latency p50", 136};
+const MamaReservedField  MamaStatCallbackLatencyP99
+    = {"Callback Latency p99", 137};
+const MamaReservedField  MamaStatCallbackLatencyP999
+    = {"Callback Latency p99.9", 138};
+const MamaReservedField  MamaStatCallbackLatencyMax
+    = {"Callback Latency max", 139};
+const MamaReservedField  MamaStatTotalLatencyP50
+    = {"Total Latency p50", 140};
+const MamaReservedField  MamaStatTotalLatencyP99
+    = {"Total Latency p99", 141};
+const MamaReservedField  MamaStatTotalLatencyP999
+    = {"Total Latency p99.9", 142};
+const MamaReservedField  MamaStatTotalLatencyMax
+    = {"Total Latency max", 143};
+const MamaReservedField  MamaStatQueueResidencyAvg
+    = {"Queue Residency avg", 144};
+const MamaReservedField  MamaStatQueueResidencyMax
+    = {"Queue Residency max", 145};
+const MamaReservedField  MamaStatRecapPacingRate
+    = {"Recap Pacing Rate", 146};
+const MamaReservedField  MamaStatRecapPacingSent
+    = {"Recap Pacing Sent", 147};
+const MamaReservedField  MamaStatRecapPacingDeferred
+    = {"Recap Pacing Deferred", 148};
+const MamaReservedField  MamaStatRecapPacingBackoffs
+    = {"Recap Pacing Backoffs", 149};
@@ -39,6 +39,11 @@ MAMAExpDLL
 extern mama_status
 mamaStat_setPollCallback (mamaStat stat, pollStatCb callback, void* closure);
 
+/* When set, stats created as MAMA_STAT_LOCKABLE are sharded instead. */
+MAMAExpDLL
+extern void
+mamaStat_setShardLockable (int sharded);
+
 #if defined (__cplusplus)
 }
 #endif
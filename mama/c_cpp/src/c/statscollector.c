@@ -28,6 +28,27 @@
 #include "statscollectorinternal.h"
 #include "mama/statscollector.h"
 #include "mama/statfields.h"
+#include "mama/latency.h"
+
+/* Published percentile fields for each latency span */
+static const MamaReservedField* gLatencyFields[MAMA_LATENCY_SPAN_MAX][4] =
+{
+    { &MamaStatQueueLatencyP50,    &MamaStatQueueLatencyP99,
+      &MamaStatQueueLatencyP999,   &MamaStatQueueLatencyMax },
+    { &MamaStatCallbackLatencyP50, &MamaStatCallbackLatencyP99,
+      &MamaStatCallbackLatencyP999,&MamaStatCallbackLatencyMax },
+    { &MamaStatTotalLatencyP50,    &MamaStatTotalLatencyP99,
+      &MamaStatTotalLatencyP999,   &MamaStatTotalLatencyMax }
+};
+
+static const mama_f64_t gLatencyPercentiles[3] = { 50.0, 99.0, 99.9 };
+
+static void
+mamaStatsCollectorImpl_populateLatency (mamaStatsCollectorImpl* impl,
+                                        mamaMsg                 msg,
+                                        const char*             type,
+                                        int*                    logHeader,
+                                        int*                    wasLogged);
 
 mama_status
 mamaStatsCollector_create (mamaStatsCollector* statsCollector, mamaStatsCollectorType type, const char* name, const char* middleware)
@@ -44,8 +65,27 @@ mamaStatsCollector_create (mamaStatsCollector* statsCollector, mamaStatsCollecto
     impl->mPublishStats = 0;
     impl->mOffset = 0;
     impl->mLogStats     = 1;
+    impl->mHasLatency   = 0;
 
     memset (impl->mMamaStats, 0, MAMA_STAT_MAX_STATS*sizeof(mamaStat));
+    memset (impl->mLatency, 0, sizeof (impl->mLatency));
+
+    if (mamaLatency_isEnabled () &&
+        (type == MAMA_STATS_COLLECTOR_TYPE_QUEUE ||
+         type == MAMA_STATS_COLLECTOR_TYPE_TRANSPORT))
+    {
+        int span;
+
+        impl->mHasLatency = 1;
+        for (span = 0; span < MAMA_LATENCY_SPAN_MAX; span++)
+        {
+            if (MAMA_STATUS_OK != mamaLatencyHistogram_create (&impl->mLatency[span]))
+            {
+                mamaStatsCollector_destroy ((mamaStatsCollector)impl);
+                return MAMA_STATUS_NOMEM;
+            }
+        }
+    }
 
     *statsCollector = (mamaStatsCollector)impl;
     return MAMA_STATUS_OK;
@@ -55,6 +95,7 @@ mama_status
 mamaStatsCollector_destroy (mamaStatsCollector statsCollector)
 {
     mamaStatsCollectorImpl* impl = (mamaStatsCollectorImpl*)statsCollector;
+    int i;
     if (!impl) return MAMA_STATUS_NULL_ARG;
 
     free (impl->mName);
@@ -64,6 +105,12 @@ mamaStatsCollector_destroy (mamaStatsCollector statsCollector)
     impl->mPollCb       = NULL;
     impl->mPollClosure  = NULL;
 
+    for (i = 0; i < MAMA_LATENCY_SPAN_MAX; i++)
+    {
+        if (impl->mLatency[i])
+            mamaLatencyHistogram_destroy (impl->mLatency[i]);
+    }
+
     free (impl);
     return MAMA_STATUS_OK;
 }
@@ -176,6 +223,111 @@ mamaStatsCollector_populateMsg /*And string logging */ (mamaStatsCollector stats
             mamaStat_reset (impl->mMamaStats[i]);
         }
     }
+
+    if (impl->mHasLatency)
+    {
+        mamaStatsCollectorImpl_populateLatency (impl, msg, type, &logHeader, wasLogged);
+    }
+}
+
+/* Publish and log the percentiles of each latency span. The interval is
+   restarted by mamaStatsCollectorImpl_resetLatency once every collector has
+   reported, as transports merge their view from the queue histograms. */
+static void
+mamaStatsCollectorImpl_populateLatency (mamaStatsCollectorImpl* impl,
+                                        mamaMsg                 msg,
+                                        const char*             type,
+                                        int*                    logHeader,
+                                        int*                    wasLogged)
+{
+    static const char* spanNames[MAMA_LATENCY_SPAN_MAX] =
+        { "Queue", "Callback", "Total" };
+    mama_u64_t  count = 0;
+    mama_u64_t  max   = 0;
+    mama_u64_t  value = 0;
+    char        name[32];
+    int         span;
+    int         i;
+
+    for (span = 0; span < MAMA_LATENCY_SPAN_MAX; span++)
+    {
+        mamaLatencyHistogram_getCount (impl->mLatency[span], &count);
+        if (0 == count)
+            continue;
+
+        mamaLatencyHistogram_getMax (impl->mLatency[span], &max);
+
+        for (i = 0; i < 3; i++)
+        {
+            mamaLatencyHistogram_getPercentile (impl->mLatency[span],
+                                                gLatencyPercentiles[i],
+                                                &value);
+            if (impl->mPublishStats)
+            {
+                mamaMsg_addU64 (msg, gLatencyFields[span][i]->mName,
+                                gLatencyFields[span][i]->mFid, value);
+            }
+
+            if (impl->mLogStats)
+            {
+                /* Logged in microseconds, with the max and the count in the
+                   Max and Total columns */
+                snprintf (name, sizeof (name), "%s lat %s us", spanNames[span],
+                          i == 0 ? "p50" : i == 1 ? "p99" : "p99.9");
+                mama_log (MAMA_LOG_LEVEL_WARN, "%24.24s | %9.9s | %10.10s | %15.15s | %10u | %10u | %10u |",
+                                               *logHeader ? impl->mName : "",
+                                               *logHeader ? type : "",
+                                               *logHeader ? impl->mMiddleware : "",
+                                               name,
+                                               (mama_u32_t)(value / 1000),
+                                               (mama_u32_t)(max / 1000),
+                                               (mama_u32_t)count);
+                *logHeader = 0;
+                *wasLogged = 1;
+            }
+        }
+
+        if (impl->mPublishStats)
+        {
+            mamaMsg_addU64 (msg, gLatencyFields[span][3]->mName,
+                            gLatencyFields[span][3]->mFid, max);
+        }
+    }
+}
+
+void
+mamaStatsCollectorImpl_resetLatency (mamaStatsCollector statsCollector)
+{
+    mamaStatsCollectorImpl* impl = (mamaStatsCollectorImpl*)statsCollector;
+    int                     span;
+
+    if (impl == NULL || !impl->mHasLatency) return;
+
+    for (span = 0; span < MAMA_LATENCY_SPAN_MAX; span++)
+        mamaLatencyHistogram_reset (impl->mLatency[span]);
+}
+
+mamaLatencyHistogram*
+mamaStatsCollectorImpl_getLatencyHistograms (mamaStatsCollector statsCollector)
+{
+    mamaStatsCollectorImpl* impl = (mamaStatsCollectorImpl*)statsCollector;
+    if (impl == NULL || !impl->mHasLatency) return NULL;
+
+    return impl->mLatency;
+}
+
+mama_status
+mamaStatsCollector_getLatencyHistogram (mamaStatsCollector    statsCollector,
+                                        mamaLatencySpan       span,
+                                        mamaLatencyHistogram* histogram)
+{
+    mamaStatsCollectorImpl* impl = (mamaStatsCollectorImpl*)statsCollector;
+    if (impl == NULL || histogram == NULL) return MAMA_STATUS_NULL_ARG;
+    if ((int)span < 0 || span >= MAMA_LATENCY_SPAN_MAX) return MAMA_STATUS_INVALID_ARG;
+    if (!impl->mHasLatency) return MAMA_STATUS_NOT_FOUND;
+
+    *histogram = impl->mLatency[span];
+    return MAMA_STATUS_OK;
 }
 
 mama_status
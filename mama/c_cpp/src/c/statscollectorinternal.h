@@ -23,6 +23,7 @@
 #define MamaStatsCollectorInternalH__
 
 #include "mama/statscollector.h"
+#include "mama/latency.h"
 
 #if defined(__cplusplus)
 extern "C" {
@@ -31,7 +32,7 @@ extern "C" {
 typedef void (
 *collectorPollStatCb) (mamaStatsCollector statsCollector, void* closure);
 
-#define MAMA_STAT_MAX_STATS    		35
+#define MAMA_STAT_MAX_STATS    		48
 
 typedef struct mamaStatsCollectorImpl__
 {
@@ -45,6 +46,9 @@ typedef struct mamaStatsCollectorImpl__
     int         			mLogStats;
      int         			mOffset;
     void*          			mHandle;
+    /* Only for queues and transports with latency measurement enabled */
+    mamaLatencyHistogram    mLatency[MAMA_LATENCY_SPAN_MAX];
+    int                     mHasLatency;
 } mamaStatsCollectorImpl;
 
 MAMAExpDLL
@@ -68,6 +72,22 @@ MAMAExpDLL
 extern mama_status
 mamaStatsCollector_setStatIntervalValueFromTotal (mamaStatsCollector statsCollector, mama_fid_t identifier, mama_u32_t value);
 
+/**
+ * Return the collector's MAMA_LATENCY_SPAN_MAX latency histograms, or NULL
+ * if it has none.
+ */
+MAMAExpDLL
+extern mamaLatencyHistogram*
+mamaStatsCollectorImpl_getLatencyHistograms (mamaStatsCollector statsCollector);
+
+/**
+ * Discard the values in the collector's latency histograms to start a new
+ * reporting interval.
+ */
+MAMAExpDLL
+extern void
+mamaStatsCollectorImpl_resetLatency (mamaStatsCollector statsCollector);
+
 #if defined(__cplusplus)
 }
 #endif
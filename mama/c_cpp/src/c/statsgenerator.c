@@ -205,6 +205,15 @@ mamaStatsGenerator_generateStats (mamaStatsGenerator statsGenerator)
         mamaStatsLogger_sendReport (impl->mStatsLogger);
     }
 
+    /* Only start the next latency interval once every collector has
+       reported, transports read the queue histograms for their view */
+    current = (mamaStatsCollector*)list_get_head (impl->mStatsCollectors);
+    while (current != NULL)
+    {
+        mamaStatsCollectorImpl_resetLatency (*current);
+        current = (mamaStatsCollector*)list_get_next (impl->mStatsCollectors, current);
+    }
+
     /* If the last collector didn't give us any stats, still log a separator */
     if (!wasLogged && impl->mLogStats && logLast)
     {
@@ -36,6 +36,7 @@
 #include <dqstrategy.h>
 #include <dictionaryimpl.h>
 #include <listenermsgcallback.h>
+#include <msgimpl.h>
 #include <bridge.h>
 #include <string.h>
 #include "msgutils.h"
@@ -81,6 +82,10 @@ extern int gGenerateTransportStats;
 
 #define PREINITIALCACHESIZEPROPERTY     "mama.subscription.preinitialcachesize"
 #define STATE_MACHINE_TRACE_PROPERTY    "mama.subscription.statetrace"
+#define BATCH_CHUNK_SIZE_PROPERTY       "mama.subscription.batch.chunksize"
+
+/* Number of batch members activated in each slot on the throttle. */
+#define DEFAULT_BATCH_CHUNK_SIZE 100
 
 static SubjectContext *
 mamaSubscription_getSubjectContext (mamaSubscription subscription,
@@ -153,9 +158,52 @@ typedef struct mamaSubscriptionImpl_
 
     /* The queue lock handle. */
     mamaQueueLockHandle mLockHandle;
+
+    /* The batch this subscription is waiting on the throttle with, set by
+     * mamaSubscription_createBatch until the onCreate callback is invoked.
+     */
+    struct mamaSubscriptionBatch_* mBatch;
+    size_t                  mBatchIndex;
+
+    /* The block of memory this subscription was allocated from by
+     * mamaSubscription_allocateBatch, NULL if allocated on its own.
+     */
+    struct mamaSubscriptionBlock_* mBlock;
     
 } mamaSubscriptionImpl;
 
+/* Subscriptions allocated together by mamaSubscription_allocateBatch. The
+ * memory is released when the last of them is deallocated.
+ */
+typedef struct mamaSubscriptionBlock_
+{
+    mamaSubscriptionImpl*   mImpls;
+    wInterlockedInt         mRefs;
+} mamaSubscriptionBlock;
+
+/* Subscriptions activated together by mamaSubscription_createBatch. A single
+ * action sits on the default throttle for the whole batch and activates up
+ * to mChunkSize members each time it is run. Members are only changed under
+ * the throttle lock.
+ */
+typedef struct mamaSubscriptionBatch_
+{
+    mamaTransport           mTransport;
+    mamaSubscriptionImpl**  mMembers;     /* NULL once a member has left */
+    size_t                  mCount;
+    size_t                  mNext;
+    size_t                  mRemaining;
+    size_t                  mChunkSize;
+    int                     mDispatching;
+    wombatThrottleAction    mAction;
+
+    /* Scratch space for the bridge batch create, mChunkSize entries each. */
+    subscriptionBridge*     mBridges;
+    mamaSubscription*       mSubscs;
+    const char**            mSymbols;
+    void**                  mClosures;
+} mamaSubscriptionBatch;
+
 /* *************************************************** */
 /* Private Function Prototypes. */
 /* *************************************************** */
@@ -178,6 +226,32 @@ static mama_status mamaSubscriptionImpl_completeBasicInitialisation(mamaSubscrip
  */
 static mama_status mamaSubscriptionImpl_completeMarketDataInitialisation(mamaSubscription subscription);
 
+/**
+ * This function performs the work of mamaSubscriptionImpl_completeMarketDataInitialisation without invoking
+ * the onCreate callback, allowing a batch to complete all of its members before any user code is run.
+ *
+ * @param[in] impl The subscription impl.
+ * @return mama_status code.
+ */
+static mama_status mamaSubscriptionImpl_initialiseMarketData(mamaSubscriptionImpl *impl);
+
+/**
+ * This function will set the fields of a newly allocated subscription to their defaults and move it into the
+ * MAMA_SUBSCRIPTION_ALLOCATED state. The memory must already have been zeroed.
+ *
+ * @param[in] impl The subscription impl.
+ */
+static void mamaSubscriptionImpl_initialiseFields(mamaSubscriptionImpl *impl);
+
+/**
+ * This function will remove the subscription from the batch it is waiting on the throttle with. The batch is
+ * destroyed when its last member is removed. It should only be called under the throttle lock.
+ *
+ * @param[in] impl The subscription impl.
+ * @param[in] throttle The default throttle of the subscription's transport.
+ */
+static void mamaSubscriptionImpl_removeFromBatch(mamaSubscriptionImpl *impl, wombatThrottle throttle);
+
 /**
  * This function will perform the work required to create a basic subscription and is used internally by the
  * various types of basic subscription. Note that the final setup function will not be placed on the throttle
@@ -269,6 +343,10 @@ static mama_status
 clearSubscInfo (
     mamaSubscription  subscription);
 
+static mama_status
+mamaSubscription_cleanup (
+    mamaSubscription  subscription);
+
 
 static mama_status
 getSubscribeMessage (
@@ -311,6 +389,213 @@ static void createAction (void *subscription, void *closure2)
     
 }
 
+static void
+mamaSubscriptionImpl_destroyBatch (mamaSubscriptionBatch* batch)
+{
+    free (batch->mMembers);
+    free (batch->mBridges);
+    free (batch->mSubscs);
+    free ((void*)batch->mSymbols);
+    free (batch->mClosures);
+    free (batch);
+}
+
+/*
+ * Ask the bridge to create the bridge subscriptions for a chunk of the batch
+ * in one call. Those it creates are skipped by mamaSubscription_initialize,
+ * anything it cannot do is left to be created one at a time.
+ */
+static void
+mamaSubscriptionImpl_createBridgeBatch (mamaSubscriptionBatch* batch,
+                                        size_t                 end)
+{
+    mamaSubscriptionImpl* impl    = NULL;
+    mamaBridgeImpl*       bridge  = NULL;
+    mamaMsgCallbacks      cb;
+    mama_status           status  = MAMA_STATUS_OK;
+    size_t                count   = 0;
+    size_t                i       = 0;
+
+    for (i = batch->mNext; i < end; i++)
+    {
+        impl = batch->mMembers[i];
+        if (NULL == impl ||
+            impl->mSubscMsgType == MAMA_SUBSC_DDICT_SNAPSHOT ||
+            impl->mSubscMsgType == MAMA_SUBSC_SNAPSHOT ||
+            MAMA_SUBSCRIPTION_ACTIVATING != wInterlocked_read (&impl->mState))
+        {
+            continue;
+        }
+
+        if (0 == count)
+        {
+            bridge = impl->mBridgeImpl;
+            if (NULL == bridge->bridgeMamaSubscriptionCreateBatch) return;
+
+            cb.onCreate       = impl->mUserCallbacks.onCreate;
+            cb.onError        = impl->mUserCallbacks.onError;
+            cb.onMsg          = impl->mUserCallbacks.onMsg;
+            cb.onQuality      = impl->mUserCallbacks.onQuality;
+            cb.onGap          = impl->mUserCallbacks.onGap;
+            cb.onRecapRequest = impl->mUserCallbacks.onRecapRequest;
+            cb.onDestroy      = mamaSubscriptionImpl_onSubscriptionDestroyed;
+        }
+
+        batch->mBridges[count]  = NULL;
+        batch->mSubscs[count]   = impl;
+        batch->mSymbols[count]  = impl->mSubscSymbol;
+        batch->mClosures[count] = impl->mClosure;
+        count++;
+    }
+
+    if (0 == count) return;
+
+    impl   = (mamaSubscriptionImpl*)batch->mSubscs[0];
+    status = bridge->bridgeMamaSubscriptionCreateBatch (batch->mBridges,
+                                                        count,
+                                                        impl->mSubscSource,
+                                                        batch->mSymbols,
+                                                        impl->mTransport,
+                                                        impl->mQueue,
+                                                        cb,
+                                                        batch->mSubscs,
+                                                        batch->mClosures);
+    if (MAMA_STATUS_OK != status)
+    {
+        mama_log (MAMA_LOG_LEVEL_WARN,
+                  "mamaSubscription_createBatch(): Bridge could not create "
+                  "%lu subscriptions together, creating them one at a time "
+                  "[%s]", (unsigned long)count,
+                  mamaStatus_stringForStatus (status));
+        return;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        impl = (mamaSubscriptionImpl*)batch->mSubscs[i];
+        impl->mSubscBridge = batch->mBridges[i];
+    }
+}
+
+/*
+ * Callback used for activating a batch of subscriptions from the throttle
+ * queue. Each run takes one slot on the throttle and activates the next
+ * chunk, the action is queued again until the batch is exhausted. When the
+ * throttle is not in use the whole batch is activated at once.
+ */
+static void batchCreateAction (void *closure1, void *closure2)
+{
+    mamaSubscriptionBatch* batch    = (mamaSubscriptionBatch*)closure1;
+    mamaSubscriptionImpl*  impl     = NULL;
+    wombatThrottle         throttle = NULL;
+    mama_status            status   = MAMA_STATUS_OK;
+    size_t                 end      = 0;
+    size_t                 i        = 0;
+
+    throttle = mamaTransportImpl_getThrottle (batch->mTransport,
+                                              MAMA_THROTTLE_DEFAULT);
+
+    batch->mAction      = NULL;
+    batch->mDispatching = 1;
+
+    do
+    {
+        end = batch->mNext + batch->mChunkSize;
+        if (end > batch->mCount) end = batch->mCount;
+
+        mamaSubscriptionImpl_createBridgeBatch (batch, end);
+
+        /* Complete every member of the chunk before any onCreate callback
+         * runs, so user code never sees a bridge subscription created for a
+         * member that has not been activated yet.
+         */
+        for (i = batch->mNext; i < end; i++)
+        {
+            if (NULL != (impl = batch->mMembers[i]))
+            {
+                mama_log (MAMA_LOG_LEVEL_FINE,
+                          "mamaSubscription::setup() %s%s setup Marketdata "
+                          "subscription (%p)", userSymbolFormattedImpl, impl);
+                mamaSubscriptionImpl_initialiseMarketData (impl);
+            }
+        }
+
+        /* A callback may destroy a later member, which removes it from the
+         * batch, so each member is read again before it is notified.
+         */
+        for (i = batch->mNext; i < end; i++)
+        {
+            if (NULL != (impl = batch->mMembers[i]))
+            {
+                batch->mMembers[i] = NULL;
+                batch->mRemaining--;
+                impl->mBatch = NULL;
+                impl->mUserCallbacks.onCreate (impl, impl->mClosure);
+            }
+        }
+
+        batch->mNext = end;
+    }
+    while (batch->mNext < batch->mCount &&
+           (NULL == throttle || wombatThrottle_getRate (throttle) <= 0.0));
+
+    batch->mDispatching = 0;
+
+    if (0 == batch->mRemaining || batch->mNext >= batch->mCount)
+    {
+        mamaSubscriptionImpl_destroyBatch (batch);
+        return;
+    }
+
+    /* Go to the back of the queue so single subscriptions are not starved. */
+    if (MAMA_STATUS_OK!=(status=mamaTransport_throttleAction (
+                                  batch->mTransport,
+                                  MAMA_THROTTLE_DEFAULT,
+                                  batchCreateAction,
+                                  batch,
+                                  batch,
+                                  NULL,
+                                  0,
+                                  &batch->mAction)))
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "mamaSubscription_createBatch(): Failed to throttle the "
+                  "remaining %lu subscriptions. [%s]",
+                  (unsigned long)batch->mRemaining,
+                  mamaStatus_stringForStatus (status));
+
+        for (i = batch->mNext; i < batch->mCount; i++)
+        {
+            if (NULL != (impl = batch->mMembers[i]))
+            {
+                impl->mBatch = NULL;
+                mamaSubscriptionImpl_setState (impl, MAMA_SUBSCRIPTION_DEACTIVATED);
+            }
+        }
+        mamaSubscriptionImpl_destroyBatch (batch);
+    }
+}
+
+static void
+mamaSubscriptionImpl_removeFromBatch (mamaSubscriptionImpl* impl,
+                                      wombatThrottle        throttle)
+{
+    mamaSubscriptionBatch* batch = impl->mBatch;
+
+    batch->mMembers[impl->mBatchIndex] = NULL;
+    impl->mBatch = NULL;
+
+    /* While the action is running it cleans up the batch itself. */
+    if (0 == --batch->mRemaining && !batch->mDispatching)
+    {
+        if (NULL != batch->mAction)
+        {
+            wombatThrottle_removeAction (throttle, batch->mAction);
+        }
+        mamaSubscriptionImpl_destroyBatch (batch);
+    }
+}
+
 static mama_status
 mamaSubscription_create_ (
     mamaSubscription         subscription, 
@@ -338,12 +623,61 @@ mama_status
 mamaSubscription_allocate (
             mamaSubscription*         result)
 {
-    const char * propValue;
     mamaSubscriptionImpl* impl  = NULL;
 
+    if (!result) return MAMA_STATUS_NULL_ARG;
+
     impl = (mamaSubscriptionImpl*)calloc (1, sizeof (mamaSubscriptionImpl));
     if (!impl) return MAMA_STATUS_NOMEM;
 
+    mamaSubscriptionImpl_initialiseFields (impl);
+
+    *result = impl;
+    
+    
+    return MAMA_STATUS_OK;
+}
+
+mama_status
+mamaSubscription_allocateBatch (
+            mamaSubscription*         result,
+            size_t                    count)
+{
+    mamaSubscriptionBlock* block = NULL;
+    size_t                 i     = 0;
+
+    if (!result) return MAMA_STATUS_NULL_ARG;
+    if (0 == count) return MAMA_STATUS_INVALID_ARG;
+
+    block = (mamaSubscriptionBlock*)calloc (1, sizeof (mamaSubscriptionBlock));
+    if (!block) return MAMA_STATUS_NOMEM;
+
+    block->mImpls = (mamaSubscriptionImpl*)calloc (count,
+                                                   sizeof (mamaSubscriptionImpl));
+    if (!block->mImpls)
+    {
+        free (block);
+        return MAMA_STATUS_NOMEM;
+    }
+
+    wInterlocked_initialize (&block->mRefs);
+    wInterlocked_set ((int)count, &block->mRefs);
+
+    for (i = 0; i < count; i++)
+    {
+        mamaSubscriptionImpl_initialiseFields (&block->mImpls[i]);
+        block->mImpls[i].mBlock = block;
+        result[i] = &block->mImpls[i];
+    }
+
+    return MAMA_STATUS_OK;
+}
+
+static void
+mamaSubscriptionImpl_initialiseFields (mamaSubscriptionImpl* impl)
+{
+    const char * propValue;
+
     impl->mType                   = MAMA_SUBSC_TYPE_NORMAL;
     impl->mServiceLevel           = MAMA_SERVICE_LEVEL_REAL_TIME;
     impl->mServiceLevelOpt        = 0;
@@ -405,11 +739,6 @@ mamaSubscription_allocate (
 
     /* Set the initial state of the subscription now that the memory has been allocated. */    
     mamaSubscriptionImpl_setState(impl, MAMA_SUBSCRIPTION_ALLOCATED);
-
-    *result = impl;
-    
-    
-    return MAMA_STATUS_OK;
 }
 
 mama_status
@@ -720,6 +1049,170 @@ mamaSubscription_create (
         closure);
 }
 
+mama_status
+mamaSubscription_createBatch (
+    mamaSubscription*        subscriptions,
+    size_t                   count,
+    mamaQueue                queue,
+    const mamaMsgCallbacks*  callbacks,
+    mamaSource               source,
+    const char**             symbols,
+    void**                   closures)
+{
+    mamaSubscriptionBatch* batch      = NULL;
+    mamaSubscriptionImpl*  impl       = NULL;
+    mamaTransport          transport  = NULL;
+    wombatThrottle         throttle   = NULL;
+    const char*            propValue  = NULL;
+    mama_status            status     = MAMA_STATUS_OK;
+    size_t                 i          = 0;
+
+    if (!subscriptions || !source || !symbols) return MAMA_STATUS_NULL_ARG;
+    if (0 == count) return MAMA_STATUS_INVALID_ARG;
+
+    if (MAMA_STATUS_OK!=(status=mamaSource_getTransport (source, &transport)))
+        return status;
+    if (!transport) return MAMA_STATUS_INVALID_ARG;
+
+    batch = (mamaSubscriptionBatch*)calloc (1, sizeof (mamaSubscriptionBatch));
+    if (!batch) return MAMA_STATUS_NOMEM;
+
+    batch->mTransport = transport;
+    batch->mCount     = count;
+    batch->mChunkSize = DEFAULT_BATCH_CHUNK_SIZE;
+
+    propValue = mama_getProperty (BATCH_CHUNK_SIZE_PROPERTY);
+    if (propValue && atoi (propValue) > 0)
+    {
+        batch->mChunkSize = (size_t)atoi (propValue);
+    }
+    if (batch->mChunkSize > count) batch->mChunkSize = count;
+
+    batch->mMembers  = (mamaSubscriptionImpl**)calloc (count,
+                                            sizeof (mamaSubscriptionImpl*));
+    batch->mBridges  = (subscriptionBridge*)calloc (batch->mChunkSize,
+                                            sizeof (subscriptionBridge));
+    batch->mSubscs   = (mamaSubscription*)calloc (batch->mChunkSize,
+                                            sizeof (mamaSubscription));
+    batch->mSymbols  = (const char**)calloc (batch->mChunkSize,
+                                            sizeof (const char*));
+    batch->mClosures = (void**)calloc (batch->mChunkSize, sizeof (void*));
+
+    if (!batch->mMembers || !batch->mBridges || !batch->mSubscs ||
+        !batch->mSymbols || !batch->mClosures)
+    {
+        mamaSubscriptionImpl_destroyBatch (batch);
+        return MAMA_STATUS_NOMEM;
+    }
+
+    /* Set every member up before anything is queued, so a bad symbol fails
+     * the whole call and leaves the subscriptions as they were passed in.
+     */
+    for (i = 0; i < count; i++)
+    {
+        status = mamaSubscription_setup (subscriptions[i],
+                                         queue,
+                                         callbacks,
+                                         source,
+                                         symbols[i],
+                                         closures ? closures[i] : NULL);
+        if (MAMA_STATUS_OK != status)
+        {
+            mama_log (MAMA_LOG_LEVEL_ERROR,
+                      "mamaSubscription_createBatch(): Could not set up "
+                      "subscription %lu for %s [%s]", (unsigned long)i,
+                      symbols[i] ? symbols[i] : "",
+                      mamaStatus_stringForStatus (status));
+            break;
+        }
+    }
+
+    if (MAMA_STATUS_OK != status)
+    {
+        while (i-- > 0)
+        {
+            impl = (mamaSubscriptionImpl*)subscriptions[i];
+            wlock_lock (impl->mCreateDestroyLock);
+            mamaSubscription_cleanup (impl);
+            mamaSubscriptionImpl_setState (impl, MAMA_SUBSCRIPTION_DESTROYED);
+            wlock_unlock (impl->mCreateDestroyLock);
+        }
+        mamaSubscriptionImpl_destroyBatch (batch);
+        return status;
+    }
+
+    throttle = mamaTransportImpl_getThrottle (transport, MAMA_THROTTLE_DEFAULT);
+    if (throttle)
+    {
+        wombatThrottle_lock (throttle);
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        impl = (mamaSubscriptionImpl*)subscriptions[i];
+        wlock_lock (impl->mCreateDestroyLock);
+
+        /* We need to reset the context for each reuse of a subscription */
+        status = dqContext_initializeContext (&impl->mSubjectContext.mDqContext,
+                                              impl->mPreInitialCacheSize,
+                                              impl->mRecapRequest);
+        if (MAMA_STATUS_OK == status)
+        {
+            mamaSubscriptionImpl_setState (impl, MAMA_SUBSCRIPTION_ACTIVATING);
+            impl->mBatch       = batch;
+            impl->mBatchIndex  = i;
+            batch->mMembers[i] = impl;
+            batch->mRemaining++;
+        }
+        else
+        {
+            /* The subscription is left set up for the caller to activate. */
+            mama_log (MAMA_LOG_LEVEL_ERROR,
+                      "mamaSubscription_createBatch(): Failed to initialize "
+                      "DQ context for subscription %lu [%s]",
+                      (unsigned long)i, mamaStatus_stringForStatus (status));
+        }
+
+        wlock_unlock (impl->mCreateDestroyLock);
+    }
+
+    if (0 == batch->mRemaining)
+    {
+        mamaSubscriptionImpl_destroyBatch (batch);
+    }
+    else if (MAMA_STATUS_OK!=(status=mamaTransport_throttleAction (
+                                  transport,
+                                  MAMA_THROTTLE_DEFAULT,
+                                  batchCreateAction,
+                                  batch,
+                                  batch,
+                                  NULL,
+                                  0,
+                                  &batch->mAction)))
+    {
+        mama_log (MAMA_LOG_LEVEL_ERROR,
+                  "mamaSubscription_createBatch(): Failed to throttle "
+                  "activate. [%s]", mamaStatus_stringForStatus (status));
+
+        for (i = 0; i < count; i++)
+        {
+            if (NULL != (impl = batch->mMembers[i]))
+            {
+                impl->mBatch = NULL;
+                mamaSubscriptionImpl_setState (impl, MAMA_SUBSCRIPTION_SETUP);
+            }
+        }
+        mamaSubscriptionImpl_destroyBatch (batch);
+    }
+
+    if (throttle)
+    {
+        wombatThrottle_unlock (throttle);
+    }
+
+    return status;
+}
+
 mama_status
 mamaSubscription_createSnapshot (
     mamaSubscription         subscription, 
@@ -889,8 +1382,10 @@ mamaSubscription_initialize (mamaSubscription subscription)
               self->mSubscSymbol != NULL ? self->mSubscSymbol : "",
               self->mUserSymbol  != NULL ? self->mUserSymbol  : "");
     
+    /* A batch may already have had the bridge subscription created. */
     if (self->mSubscMsgType != MAMA_SUBSC_DDICT_SNAPSHOT &&
-        self->mSubscMsgType != MAMA_SUBSC_SNAPSHOT)
+        self->mSubscMsgType != MAMA_SUBSC_SNAPSHOT &&
+        self->mSubscBridge == NULL)
     {
         /*Delegate to the correct bridge implementation*/
             mamaMsgCallbacks    cb;
@@ -2171,8 +2666,7 @@ mamaSubscription_processMsg (mamaSubscription subscription, mamaMsg msg)
         if (self->mMsgQualFilter) /* we are discarding something */
         {
             mama_u16_t filter;
-            if (mamaMsg_getU16 (msg, MamaFieldMsgQual.mName,
-                        MamaFieldMsgQual.mFid, &filter) == MAMA_STATUS_OK)
+            if (mamaMsgImpl_getMsgQual (msg, &filter) == MAMA_STATUS_OK)
             {
                 if (self->mMsgQualFilter & filter)
                 {
@@ -2502,6 +2996,14 @@ mamaSubscription_getSubscriptionBridge (mamaSubscription subscription)
     return self->mSubscBridge;
 }
 
+void*
+mamaSubscription_getSubscHandle (mamaSubscription subscription)
+{
+    if (!self) return NULL;
+
+    return self->mSubscHandle;
+}
+
 wildCardType
 mamaSubscription_getWildCardType( mamaSubscription subscription)
 {
@@ -2618,7 +3120,14 @@ mama_status mamaSubscription_deactivate(mamaSubscription subscription)
             {      
                     /* The subscription is waiting on the throttle. */
                 case MAMA_SUBSCRIPTION_ACTIVATING:
-                     wombatThrottle_removeAction(throttle, impl->mAction);
+                     if (NULL != impl->mBatch)
+                     {
+                         mamaSubscriptionImpl_removeFromBatch(impl, throttle);
+                     }
+                     else
+                     {
+                         wombatThrottle_removeAction(throttle, impl->mAction);
+                     }
                      impl->mAction = NULL;
                      mamaSubscriptionImpl_setState(impl, MAMA_SUBSCRIPTION_DEACTIVATED);
                      ret = MAMA_STATUS_OK;
@@ -2630,6 +3139,12 @@ mama_status mamaSubscription_deactivate(mamaSubscription subscription)
 
                     /* Deactivate the subscription. */
                 case MAMA_SUBSCRIPTION_ACTIVATED:
+                    /* Activated by a batch but onCreate not yet invoked, it won't be now. */
+                    if (NULL != impl->mBatch)
+                    {
+                        mamaSubscriptionImpl_removeFromBatch(impl, throttle);
+                    }
+
                     /* Set the state to indicate that the subscription is in the process of being deactivated. */
                     mamaSubscriptionImpl_setState(impl, MAMA_SUBSCRIPTION_DEACTIVATING);
                     /* Deactivate the subscription, clean-up will be performed on the callback. */
@@ -3034,61 +3549,67 @@ mama_status mamaSubscriptionImpl_completeMarketDataInitialisation(mamaSubscripti
     /* Ensure the subscription is valid. */
     if(NULL != subscription)
     {
-        /* Obtain the impl. */
-        mamaSubscriptionImpl *impl = (mamaSubscriptionImpl *)subscription;
+        ret = mamaSubscriptionImpl_initialiseMarketData(self);
+
+        self->mUserCallbacks.onCreate (self, self->mClosure);    
+    }
     
-        /* It is possible that the subscription has been destroyed while the throttle thread is waiting at the
-         * mutex lock statement above. Therefore an additional check on the status must now be made, execution
-         * should only continue if the status is activating.
-         */
+    return ret;
+}
 
-        /* Acquire the mutex. */
-        wlock_lock(impl->mCreateDestroyLock);
-         
-        self->mAction = NULL;
-        
-        ret = MAMA_STATUS_OK;
-        if(MAMA_SUBSCRIPTION_ACTIVATING == wInterlocked_read(&impl->mState))
-        {
-            impl->mEntitleSubject[0] = '\0';
+mama_status mamaSubscriptionImpl_initialiseMarketData(mamaSubscriptionImpl *impl)
+{
+    /* Returns. */
+    mama_status ret = MAMA_STATUS_OK;
 
-            if (impl->mSubscSource != NULL && strlen (impl->mSubscSource) > 0 && 
-                impl->mSubscSymbol != NULL && strlen (impl->mSubscSymbol) > 0)
-            {
-                snprintf (impl->mEntitleSubject, WOMBAT_SUBJECT_MAX, "%s.%s", impl->mSubscSource, impl->mSubscSymbol);
-            }
-            else if (impl->mSubscSymbol != NULL && strlen (impl->mSubscSymbol) > 0)
-            {
-                snprintf (impl->mEntitleSubject, WOMBAT_SUBJECT_MAX, "%s", impl->mSubscSymbol);
-            }
+    /* It is possible that the subscription has been destroyed while the throttle thread is waiting at the
+     * mutex lock statement below. Therefore an additional check on the status must now be made, execution
+     * should only continue if the status is activating.
+     */
 
-            /* Add the subscription to the list of active subscriptions on the transport. This is only done if the
-             * subscription is receiving regular updates. The transport uses its list for actions like refreshing.
-             */            
-            if (impl->mSubscMsgType != MAMA_SUBSC_DDICT_SNAPSHOT &&
-                impl->mSubscMsgType != MAMA_SUBSC_SNAPSHOT)
-            {                
-                ret = mamaTransport_addSubscription (self->mTransport, self, &self->mSubscHandle);
-            }
+    /* Acquire the mutex. */
+    wlock_lock(impl->mCreateDestroyLock);
+     
+    impl->mAction = NULL;
+    
+    if(MAMA_SUBSCRIPTION_ACTIVATING == wInterlocked_read(&impl->mState))
+    {
+        impl->mEntitleSubject[0] = '\0';
 
-            if(MAMA_STATUS_OK == ret)
-            {
-                /* Complete the initialisation of the subscription. */               
-                mamaSubscription_initialize(impl);
-                
-                /* The subscription is now active. */
-                mamaSubscriptionImpl_setState(impl, MAMA_SUBSCRIPTION_ACTIVATED);                
-            }
+        if (impl->mSubscSource != NULL && strlen (impl->mSubscSource) > 0 && 
+            impl->mSubscSymbol != NULL && strlen (impl->mSubscSymbol) > 0)
+        {
+            snprintf (impl->mEntitleSubject, WOMBAT_SUBJECT_MAX, "%s.%s", impl->mSubscSource, impl->mSubscSymbol);
         }
-        else
+        else if (impl->mSubscSymbol != NULL && strlen (impl->mSubscSymbol) > 0)
         {
-            mama_log(MAMA_LOG_LEVEL_WARN, "Subscription %p came off throttle in state %s.", impl, mamaSubscription_stringForState(wInterlocked_read(&impl->mState)));
-        }    
-        /* Unlock the mutex. */
-        wlock_unlock(impl->mCreateDestroyLock);
-                
-        self->mUserCallbacks.onCreate (self, self->mClosure);    
+            snprintf (impl->mEntitleSubject, WOMBAT_SUBJECT_MAX, "%s", impl->mSubscSymbol);
+        }
+
+        /* Add the subscription to the list of active subscriptions on the transport. This is only done if the
+         * subscription is receiving regular updates. The transport uses its list for actions like refreshing.
+         */            
+        if (impl->mSubscMsgType != MAMA_SUBSC_DDICT_SNAPSHOT &&
+            impl->mSubscMsgType != MAMA_SUBSC_SNAPSHOT)
+        {                
+            ret = mamaTransport_addSubscription (impl->mTransport, impl, &impl->mSubscHandle);
+        }
+
+        if(MAMA_STATUS_OK == ret)
+        {
+            /* Complete the initialisation of the subscription. */               
+            mamaSubscription_initialize(impl);
+            
+            /* The subscription is now active. */
+            mamaSubscriptionImpl_setState(impl, MAMA_SUBSCRIPTION_ACTIVATED);                
+        }
     }
+    else
+    {
+        mama_log(MAMA_LOG_LEVEL_WARN, "Subscription %p came off throttle in state %s.", impl, mamaSubscription_stringForState(wInterlocked_read(&impl->mState)));
+    }    
+    /* Unlock the mutex. */
+    wlock_unlock(impl->mCreateDestroyLock);
     
     return ret;
 }
@@ -3187,8 +3708,21 @@ void mamaSubscriptionImpl_deallocate(mamaSubscriptionImpl *impl)
     /* Destroy the state. */
     wInterlocked_destroy(&impl->mState);
                     
-    /* Free the subscription impl. */
-    free(impl);
+    /* Free the subscription impl, or the block once all of it is unused. */
+    if(NULL != impl->mBlock)
+    {
+        mamaSubscriptionBlock *block = impl->mBlock;
+        if(0 == wInterlocked_decrement(&block->mRefs))
+        {
+            wInterlocked_destroy(&block->mRefs);
+            free(block->mImpls);
+            free(block);
+        }
+    }
+    else
+    {
+        free(impl);
+    }
 }
 
 void MAMACALLTYPE mamaSubscriptionImpl_onSubscriptionDestroyed(mamaSubscription subscription, void *closure)
@@ -210,6 +210,18 @@ extern subscriptionBridge
 mamaSubscription_getSubscriptionBridge(
     mamaSubscription subscription);
 
+/**
+ * This function returns the handle the transport tracks the subscription
+ * with, a SubscriptionInfo.
+ *
+ * @param[in] subscription The subscription.
+ *
+ * @return The handle, NULL if the subscription is not on a transport.
+ */
+extern void*
+mamaSubscription_getSubscHandle(
+    mamaSubscription subscription);
+
 /**
  * This function returns a flag indicating whether or not the subscription is expecting an initial to
  * be delivered.
@@ -23,10 +23,27 @@
 /* Includes. */
 /* *************************************************** */
 #include "list.h"
+#include "wombat/wtable.h"
 #include "mama/symbollist.h"
 #include "mama/symbollistmember.h"
 #include "mama/symbollisttypes.h"
 
+/* *************************************************** */
+/* Defines. */
+/* *************************************************** */
+
+/* The number of buckets the member index is created with. */
+#define SYMBOLLIST_INDEX_BUCKETS 256
+
+/* The index is rebuilt with more buckets once the average chain exceeds this. */
+#define SYMBOLLIST_INDEX_LOAD 2
+
+/* The factor by which the number of buckets grows on each rebuild. */
+#define SYMBOLLIST_INDEX_GROWTH 4
+
+/* Size of the (transport, source, symbol) keys used by the index. */
+#define SYMBOLLIST_KEY_LEN (MAMA_MAX_SYMBOL_LEN + MAMA_MAX_SOURCE_LEN + 32)
+
 /* *************************************************** */
 /* Structures. */
 /* *************************************************** */
@@ -45,7 +62,23 @@ typedef struct mamaSymbolList_
 
     /* This callback is invoked whenever members are removed from the symbol list. */
     removeSymbolCbType myRemoveCb;
-    
+
+    /* Invoked once for each batch added with mamaSymbolList_addMembers. */
+    addSymbolsCbType myAddBatchCb;
+
+    /* Invoked once for each batch removed with mamaSymbolList_removeMembersByRef. */
+    removeSymbolsCbType myRemoveBatchCb;
+
+    /* Index of the members keyed on transport, source and symbol. */
+    wtable_t myIndex;
+
+    /* The number of buckets in the index. */
+    unsigned long myIndexBuckets;
+
+    /* The number of members sharing a key with a member already in the index,
+     * these can only be found by walking the list. */
+    unsigned long myDuplicates;
+
 } mamaSymbolListImpl;
 
 /* *************************************************** */
@@ -64,6 +97,76 @@ typedef struct mamaSymbolList_
  */
 void mamaSymbolListImpl_removeMember(wList list, void *member, void *closure);
 
+/**
+ * This function builds the index key for a symbol, source and transport.
+ *
+ * @param[out] key Buffer of SYMBOLLIST_KEY_LEN bytes to receive the key.
+ * @param[in] symbol The symbol, may be NULL.
+ * @param[in] source The source, may be NULL.
+ * @param[in] transport The transport.
+ */
+void mamaSymbolListImpl_makeKey(char *key, const char *symbol, const char *source, mamaTransport transport);
+
+/**
+ * This function builds the index key for an existing member.
+ *
+ * @param[out] key Buffer of SYMBOLLIST_KEY_LEN bytes to receive the key.
+ * @param[in] member The symbol list member.
+ */
+void mamaSymbolListImpl_makeMemberKey(char *key, mamaSymbolListMember member);
+
+/**
+ * This function determines whether a member matches the symbol, source and
+ * transport supplied. Unlike the index key this compares the full strings.
+ *
+ * @param[in] member The symbol list member.
+ * @param[in] symbol The symbol.
+ * @param[in] source The source.
+ * @param[in] transport The transport.
+ *
+ * @return Non-zero if the member matches.
+ */
+int mamaSymbolListImpl_isMatch(mamaSymbolListMember member, const char *symbol, const char *source, mamaTransport transport);
+
+/**
+ * This function adds a member to the index, if a member with the same key is
+ * already indexed the new member is counted as a duplicate instead.
+ *
+ * @param[in] impl The symbol list impl.
+ * @param[in] member The symbol list member.
+ */
+void mamaSymbolListImpl_indexMember(mamaSymbolListImpl *impl, mamaSymbolListMember member);
+
+/**
+ * This function removes a member from the index. If the member was indexed
+ * and duplicates exist, the next member with the same key is indexed in its
+ * place.
+ *
+ * @param[in] impl The symbol list impl.
+ * @param[in] member The symbol list member, this must already have been
+ *                   removed from the list.
+ */
+void mamaSymbolListImpl_unindexMember(mamaSymbolListImpl *impl, mamaSymbolListMember member);
+
+/**
+ * This function rebuilds the index with more buckets once the number of
+ * members exceeds the load factor.
+ *
+ * @param[in] impl The symbol list impl.
+ */
+void mamaSymbolListImpl_growIndex(mamaSymbolListImpl *impl);
+
+/**
+ * wtable_for_each callback used by mamaSymbolListImpl_growIndex to copy each
+ * entry into the new index.
+ *
+ * @param[in] table The old index.
+ * @param[in] data The indexed member.
+ * @param[in] key The member's key.
+ * @param[in] closure The new index.
+ */
+void mamaSymbolListImpl_reindexMember(wtable_t table, void *data, const char *key, void *closure);
+
 /* *************************************************** */
 /* Public Functions. */
 /* *************************************************** */
@@ -77,8 +180,9 @@ mama_status mamaSymbolList_addMember(mamaSymbolList symbolList, mamaSymbolListMe
         /* Get the impl. */
         mamaSymbolListImpl *impl = (mamaSymbolListImpl *)symbolList;
 
-        /* Add the new member to the list. */        
+        /* Add the new member to the list and the index. */
         list_push_back (impl->myMembers, member);
+        mamaSymbolListImpl_indexMember(impl, member);
 
         /* Invoke the callback if it has been supplied. */
         if(NULL != impl->myAddCb)
@@ -93,6 +197,43 @@ mama_status mamaSymbolList_addMember(mamaSymbolList symbolList, mamaSymbolListMe
     return ret;
 }
 
+mama_status mamaSymbolList_addMembers(mamaSymbolList symbolList, mamaSymbolListMember *members, mama_size_t numMembers)
+{
+    /* Returns. */
+    mama_status ret = MAMA_STATUS_NULL_ARG;
+    if((NULL != symbolList) && (NULL != members))
+    {
+        /* Get the impl. */
+        mamaSymbolListImpl *impl = (mamaSymbolListImpl *)symbolList;
+        mama_size_t index = 0;
+
+        /* Add all the members before any callback is invoked. */
+        for(index = 0; index < numMembers; index++)
+        {
+            list_push_back (impl->myMembers, members[index]);
+            mamaSymbolListImpl_indexMember(impl, members[index]);
+        }
+
+        /* Invoke the batch callback once, otherwise fall back to the per member callback. */
+        if((NULL != impl->myAddBatchCb) && (numMembers > 0))
+        {
+            impl->myAddBatchCb(members, numMembers, impl->myClosure);
+        }
+        else if(NULL != impl->myAddCb)
+        {
+            for(index = 0; index < numMembers; index++)
+            {
+                impl->myAddCb(members[index], impl->myClosure);
+            }
+        }
+
+        /* Function succeeded. */
+        ret = MAMA_STATUS_OK;
+    }
+
+    return ret;
+}
+
 mama_status mamaSymbolList_allocate(mamaSymbolList *result) 
 {
     /* Returns. */
@@ -107,8 +248,28 @@ mama_status mamaSymbolList_allocate(mamaSymbolList *result)
             /* Create the list which will contain symbol list member structures. */
             impl->myMembers = list_create(mamaSymbolListMember_getSize());
 
-            /* Function succeeded. */
-            ret = MAMA_STATUS_OK;
+            /* Create the index used to find members without walking the list. */
+            impl->myIndexBuckets = SYMBOLLIST_INDEX_BUCKETS;
+            impl->myIndex = wtable_create("symbolListIndex", impl->myIndexBuckets);
+            if((NULL == impl->myMembers) || (NULL == impl->myIndex))
+            {
+                if(NULL != impl->myMembers)
+                {
+                    list_destroy(impl->myMembers, NULL, NULL);
+                }
+                if(NULL != impl->myIndex)
+                {
+                    wtable_destroy(impl->myIndex);
+                }
+                free(impl);
+                impl = NULL;
+            }
+
+            else
+            {
+                /* Function succeeded. */
+                ret = MAMA_STATUS_OK;
+            }
         }
 
         /* Return the impl. */
@@ -169,8 +330,10 @@ mama_status mamaSymbolList_deallocate(mamaSymbolList symbolList)
         ret = mamaSymbolList_clear(symbolList, 0);
         if(MAMA_STATUS_OK == ret)
         {
-            /* Destroy the member list. */
+            /* Destroy the member list and the index. */
             list_destroy(impl->myMembers, NULL, NULL);
+            wtable_clear(impl->myIndex);
+            wtable_destroy(impl->myIndex);
 
             /* Free the impl. */
             free(impl);
@@ -217,35 +380,33 @@ mama_status mamaSymbolList_findMember(const mamaSymbolList symbolList, const cha
         /* Get the impl. */
         mamaSymbolListImpl *impl = (mamaSymbolListImpl *)symbolList;
 
-        /* Create an iterator to traverse the list of members. */
+        /* Look the member up in the index. */
+        char key[SYMBOLLIST_KEY_LEN];
         mamaSymbolListMember tempMember = NULL;
-        wIterator iterator = list_create_iterator(impl->myMembers);
+        mamaSymbolListImpl_makeKey(key, symbol, source, transport);
+        tempMember = wtable_lookup(impl->myIndex, key);
 
-        /* Enumerate all members. */
-        ret = MAMA_STATUS_INVALID_ARG;
-        while (NULL != (tempMember = iterator_next(iterator)))
+        /* Keys are truncated so names longer than the maximum may share one,
+         * such members are only reachable by walking the list. */
+        if((NULL != tempMember) && (!mamaSymbolListImpl_isMatch(tempMember, symbol, source, transport)))
         {
-            /* Get details from the member. */
-            const char * tempSymbol = NULL;
-            const char * tempSource = NULL;
-            mamaTransport tempTport = NULL;
-            mamaSymbolListMember_getSymbol(tempMember, &tempSymbol);
-            mamaSymbolListMember_getSource(tempMember, &tempSource);
-            mamaSymbolListMember_getTransport(tempMember, &tempTport);
-            
-            /* Compare the member's names and transport. */
-            if((strncmp(source, tempSource, MAMA_MAX_SOURCE_LEN) == 0) && (transport == tempTport))
+            tempMember = NULL;
+            if(impl->myDuplicates > 0)
             {
-                /* Match, quit out. */
-                ret = MAMA_STATUS_OK;
-                break;
+                wIterator iterator = list_create_iterator(impl->myMembers);
+                while (NULL != (tempMember = iterator_next(iterator)))
+                {
+                    if(mamaSymbolListImpl_isMatch(tempMember, symbol, source, transport))
+                    {
+                        break;
+                    }
+                }
+                iterator_destroy(iterator);
             }
         }
 
-        /* Destroy the iterator. */
-        iterator_destroy(iterator);
-
         /* Return the member. */
+        ret = (NULL == tempMember) ? MAMA_STATUS_INVALID_ARG : MAMA_STATUS_OK;
         *member = tempMember;
     }
     
@@ -330,9 +491,6 @@ mama_status mamaSymbolList_removeMember(mamaSymbolList symbolList, const char *s
     mama_status ret = MAMA_STATUS_NULL_ARG;
     if((NULL != symbolList) && (NULL != member))
     {
-        /* Get the impl. */
-        mamaSymbolListImpl *impl = (mamaSymbolListImpl *)symbolList;
-
         /* To return the removed member. */
         mamaSymbolListMember localMember = NULL;
     
@@ -340,17 +498,8 @@ mama_status mamaSymbolList_removeMember(mamaSymbolList symbolList, const char *s
         ret = mamaSymbolList_findMember(symbolList, symbol, source, transport, &localMember);
         if(MAMA_STATUS_OK == ret)
         {
-            /* Remove the member from the list. */
-            list_remove_element(impl->myMembers, localMember);
-    
-            /* Invoke the callback if it has been installed. */
-            if(NULL != impl->myRemoveCb)
-            {
-                impl->myRemoveCb(localMember, impl->myClosure);
-            }
-
-            /* Free the member. */
-            ret = mamaSymbolListMember_deallocate(localMember);
+            /* Remove the member from the list and free it. */
+            ret = mamaSymbolList_removeMemberByRef(symbolList, localMember);
         }
 
         /* Return the member reference. */
@@ -369,8 +518,9 @@ mama_status mamaSymbolList_removeMemberByRef(mamaSymbolList symbolList, mamaSymb
         /* Get the impl. */
         mamaSymbolListImpl *impl = (mamaSymbolListImpl *)symbolList;
 
-        /* Remove the elemebt from the list. */
+        /* Remove the element from the list and the index. */
         list_remove_element (impl->myMembers, (void*)member);
+        mamaSymbolListImpl_unindexMember(impl, member);
 
         /* Invoke the remove callback if it has been supplied. */
         if(NULL != impl->myRemoveCb)
@@ -385,6 +535,51 @@ mama_status mamaSymbolList_removeMemberByRef(mamaSymbolList symbolList, mamaSymb
     return ret;
 }
 
+mama_status mamaSymbolList_removeMembersByRef(mamaSymbolList symbolList, mamaSymbolListMember *members, mama_size_t numMembers)
+{
+    /* Returns. */
+    mama_status ret = MAMA_STATUS_NULL_ARG;
+    if((NULL != symbolList) && (NULL != members))
+    {
+        /* Get the impl. */
+        mamaSymbolListImpl *impl = (mamaSymbolListImpl *)symbolList;
+        mama_size_t index = 0;
+
+        /* Remove all the members before any callback is invoked. */
+        for(index = 0; index < numMembers; index++)
+        {
+            list_remove_element (impl->myMembers, (void*)members[index]);
+            mamaSymbolListImpl_unindexMember(impl, members[index]);
+        }
+
+        /* Invoke the batch callback once, otherwise fall back to the per member callback. */
+        if((NULL != impl->myRemoveBatchCb) && (numMembers > 0))
+        {
+            impl->myRemoveBatchCb(members, numMembers, impl->myClosure);
+        }
+        else if(NULL != impl->myRemoveCb)
+        {
+            for(index = 0; index < numMembers; index++)
+            {
+                impl->myRemoveCb(members[index], impl->myClosure);
+            }
+        }
+
+        /* Deallocate all memory associated with the members. */
+        ret = MAMA_STATUS_OK;
+        for(index = 0; index < numMembers; index++)
+        {
+            mama_status status = mamaSymbolListMember_deallocate(members[index]);
+            if(MAMA_STATUS_OK == ret)
+            {
+                ret = status;
+            }
+        }
+    }
+
+    return ret;
+}
+
 mama_status mamaSymbolList_setAddSymbolHandler(mamaSymbolList symbolList, addSymbolCbType addCb)
 {
     /* Returns. */
@@ -404,6 +599,25 @@ mama_status mamaSymbolList_setAddSymbolHandler(mamaSymbolList symbolList, addSym
     return ret;
 }
 
+mama_status mamaSymbolList_setAddSymbolsHandler(mamaSymbolList symbolList, addSymbolsCbType addCb)
+{
+    /* Returns. */
+    mama_status ret = MAMA_STATUS_NULL_ARG;
+    if(NULL != symbolList)
+    {
+        /* Get the impl. */
+        mamaSymbolListImpl *impl = (mamaSymbolListImpl *)symbolList;
+
+        /* Save the callback. */
+        impl->myAddBatchCb = addCb;
+
+        /* Function succeeded. */
+        ret = MAMA_STATUS_OK;
+    }
+
+    return ret;
+}
+
 mama_status mamaSymbolList_setClosure(mamaSymbolList symbolList, void *closure)
 {
     /* Returns. */
@@ -441,12 +655,149 @@ mama_status mamaSymbolList_setRemoveSymbolHandler(mamaSymbolList symbolList, rem
     return ret;
 }
 
+mama_status mamaSymbolList_setRemoveSymbolsHandler(mamaSymbolList symbolList, removeSymbolsCbType removeCb)
+{
+    /* Returns. */
+    mama_status ret = MAMA_STATUS_NULL_ARG;
+    if(NULL != symbolList)
+    {
+        /* Get the impl. */
+        mamaSymbolListImpl *impl = (mamaSymbolListImpl *)symbolList;
+
+        /* Save the callback. */
+        impl->myRemoveBatchCb = removeCb;
+
+        /* Function succeeded. */
+        ret = MAMA_STATUS_OK;
+    }
+    return ret;
+}
+
 /* *************************************************** */
 /* Private Functions. */
 /* *************************************************** */
 
+void mamaSymbolListImpl_growIndex(mamaSymbolListImpl *impl)
+{
+    /* Create a larger table and move every entry across. */
+    unsigned long buckets = impl->myIndexBuckets * SYMBOLLIST_INDEX_GROWTH;
+    wtable_t index = wtable_create("symbolListIndex", buckets);
+    if(NULL != index)
+    {
+        wtable_for_each(impl->myIndex, mamaSymbolListImpl_reindexMember, index);
+        wtable_clear(impl->myIndex);
+        wtable_destroy(impl->myIndex);
+
+        impl->myIndex = index;
+        impl->myIndexBuckets = buckets;
+    }
+}
+
+void mamaSymbolListImpl_indexMember(mamaSymbolListImpl *impl, mamaSymbolListMember member)
+{
+    char key[SYMBOLLIST_KEY_LEN];
+    mamaSymbolListImpl_makeMemberKey(key, member);
+
+    /* Keep the first member added under a key, later ones are found by walking the list. */
+    if(NULL != wtable_lookup(impl->myIndex, key))
+    {
+        impl->myDuplicates++;
+        return;
+    }
+    wtable_insert(impl->myIndex, key, member);
+
+    /* Keep the chains short as the list grows. */
+    if(list_size(impl->myMembers) > (impl->myIndexBuckets * SYMBOLLIST_INDEX_LOAD))
+    {
+        mamaSymbolListImpl_growIndex(impl);
+    }
+}
+
+int mamaSymbolListImpl_isMatch(mamaSymbolListMember member, const char *symbol, const char *source, mamaTransport transport)
+{
+    /* Get details from the member. */
+    const char * tempSymbol = NULL;
+    const char * tempSource = NULL;
+    mamaTransport tempTport = NULL;
+    mamaSymbolListMember_getSymbol(member, &tempSymbol);
+    mamaSymbolListMember_getSource(member, &tempSource);
+    mamaSymbolListMember_getTransport(member, &tempTport);
+
+    /* Compare the member's names and transport. */
+    return (transport == tempTport) &&
+           (strcmp((NULL == symbol) ? "" : symbol, (NULL == tempSymbol) ? "" : tempSymbol) == 0) &&
+           (strcmp((NULL == source) ? "" : source, (NULL == tempSource) ? "" : tempSource) == 0);
+}
+
+void mamaSymbolListImpl_makeKey(char *key, const char *symbol, const char *source, mamaTransport transport)
+{
+    /* The transport pointer leads so keys on different transports never collide. */
+    snprintf(key, SYMBOLLIST_KEY_LEN, "%p|%.*s|%.*s",
+             (void*)transport,
+             MAMA_MAX_SOURCE_LEN, (NULL == source) ? "" : source,
+             MAMA_MAX_SYMBOL_LEN, (NULL == symbol) ? "" : symbol);
+}
+
+void mamaSymbolListImpl_makeMemberKey(char *key, mamaSymbolListMember member)
+{
+    /* Get details from the member. */
+    const char * symbol = NULL;
+    const char * source = NULL;
+    mamaTransport transport = NULL;
+    mamaSymbolListMember_getSymbol(member, &symbol);
+    mamaSymbolListMember_getSource(member, &source);
+    mamaSymbolListMember_getTransport(member, &transport);
+
+    mamaSymbolListImpl_makeKey(key, symbol, source, transport);
+}
+
+void mamaSymbolListImpl_reindexMember(wtable_t table, void *data, const char *key, void *closure)
+{
+    /* Insert the member into the new index. */
+    wtable_insert((wtable_t)closure, key, data);
+}
+
 void mamaSymbolListImpl_removeMember(wList list, void *member, void *closure)
 {
     /* Remove this member. */
     mamaSymbolList_removeMemberByRef((mamaSymbolList)closure, (mamaSymbolListMember)member);
 }
+
+void mamaSymbolListImpl_unindexMember(mamaSymbolListImpl *impl, mamaSymbolListMember member)
+{
+    char key[SYMBOLLIST_KEY_LEN];
+    mamaSymbolListMember indexed = NULL;
+    mamaSymbolListImpl_makeMemberKey(key, member);
+
+    indexed = wtable_lookup(impl->myIndex, key);
+    if(indexed != member)
+    {
+        /* This member was one of the duplicates. */
+        if((NULL != indexed) && (impl->myDuplicates > 0))
+        {
+            impl->myDuplicates--;
+        }
+        return;
+    }
+
+    wtable_remove(impl->myIndex, key);
+
+    /* Promote another member with the same key into the index. */
+    if(impl->myDuplicates > 0)
+    {
+        char tempKey[SYMBOLLIST_KEY_LEN];
+        mamaSymbolListMember tempMember = NULL;
+        wIterator iterator = list_create_iterator(impl->myMembers);
+        while (NULL != (tempMember = iterator_next(iterator)))
+        {
+            mamaSymbolListImpl_makeMemberKey(tempKey, tempMember);
+            if(strcmp(key, tempKey) == 0)
+            {
+                wtable_insert(impl->myIndex, key, tempMember);
+                impl->myDuplicates--;
+                break;
+            }
+        }
+        iterator_destroy(iterator);
+    }
+}
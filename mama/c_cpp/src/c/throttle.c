@@ -166,6 +166,13 @@ wombatThrottle_getRate (wombatThrottle throttle)
 }
 
 
+unsigned long
+wombatThrottle_getPending (wombatThrottle throttle)
+{
+    return list_size (self->mMsgQueue);
+}
+
+
 void
 wombatThrottle_setRate (wombatThrottle throttle, double rate)
 {
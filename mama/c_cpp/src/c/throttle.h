@@ -93,6 +93,15 @@ double
 wombatThrottle_getRate (wombatThrottle throttle );
 
 
+/**
+ * Return the number of tasks waiting in the throttle queue for dispatch.
+ *
+ * @return the number of queued tasks.
+ */
+unsigned long
+wombatThrottle_getPending (wombatThrottle throttle );
+
+
 /**
  * Dispatch a throttled task. If throtle is disabled (mRate == 0), the task
  * is run immediately. Otherwise, the task is placed on the queue and run in
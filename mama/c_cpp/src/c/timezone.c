@@ -28,15 +28,47 @@
 #include <wombat/wincompat.h>
 #include <time.h>
 #include <assert.h>
+#include <ctype.h>
+#include <stdlib.h>
+#include <mama/log.h>
 
 
 #define MAX_TZ_LEN  64
 
+/* Largest zoneinfo file we are prepared to read. */
+#define MAX_TZ_FILE_LEN        (256 * 1024)
+
+/* mamaDateTime holds unsigned 32 bit seconds, so rules need not be
+ * expanded beyond this year. */
+#define MAX_TZ_RULE_YEAR       2106
+
+#define SECONDS_IN_A_DAY       (24 * 60 * 60)
+
+/*
+ * The UTC offsets of a zone, loaded once from zoneinfo (or from a POSIX TZ
+ * rule) and never modified afterwards.  mOffsets[i] applies from
+ * mTransitions[i] up to the next transition; mInitialOffset applies before
+ * the first.  Tables are shared by every mamaTimeZone naming the same zone
+ * and live for the life of the process, so readers need no lock.
+ */
+typedef struct mamaTimeZoneTable_
+{
+    char                        mName[MAX_TZ_LEN];
+    mama_i64_t*                 mTransitions;
+    mama_i32_t*                 mOffsets;
+    size_t                      mNumTransitions;
+    mama_i32_t                  mInitialOffset;
+    struct mamaTimeZoneTable_*  mNext;
+} mamaTimeZoneTable;
+
 typedef struct mamaTimeZoneImpl_
 {
     char         mTz[MAX_TZ_LEN];
     mama_i32_t   mOffset;      /* seconds */
     long         mInstanceId;  /* unique identifier for object */
+    /* NULL when the zone could not be loaded and mOffset is kept up to
+     * date from the TZ environment variable instead. */
+    const mamaTimeZoneTable* volatile mTable;
 } mamaTimeZoneImpl;
 
 
@@ -87,6 +119,12 @@ static wthread_static_mutex_t sCheck_mutex  = WSTATIC_MUTEX_INITIALIZER;
 /* Mutex used when accessing the vector. */
 static wthread_static_mutex_t sVector_mutex = WSTATIC_MUTEX_INITIALIZER;
 
+/* Mutex used when loading a zone table; lookups do not take it. */
+static wthread_static_mutex_t sTable_mutex  = WSTATIC_MUTEX_INITIALIZER;
+
+/* Every zone table loaded so far. */
+static mamaTimeZoneTable*     sTables       = NULL;
+
 
 /*
 * Global function which maintains all the instances
@@ -114,6 +152,15 @@ static wList getTimeZones(void)
 static void  startThread(void);
 static void* updateTimeZones (void* ptr);
 
+static const mamaTimeZoneTable*
+getTable (const char* tzId);
+
+static mama_i32_t
+tableOffsetAt (const mamaTimeZoneTable* table, mama_i64_t utcSeconds);
+
+static mama_status
+checkFromEnvironment (mamaTimeZoneImpl* impl);
+
 
 mama_status
 mamaTimeZone_create (mamaTimeZone*  timeZone)
@@ -133,9 +180,8 @@ mamaTimeZone_create (mamaTimeZone*  timeZone)
     else
     {
         impl->mInstanceId = getNextId();
+        impl->mTable      = NULL;
         list_push_back (tzList, impl);
-        if (!sThreadStarted)
-            startThread();
 
         wthread_static_mutex_unlock (&sVector_mutex);
 
@@ -210,6 +256,7 @@ mamaTimeZone_copy (mamaTimeZone        timeZone,
         mamaTimeZoneImpl* implCopy = (mamaTimeZoneImpl*) timeZoneCopy;
         strcpy (impl->mTz, implCopy->mTz);
         impl->mOffset = implCopy->mOffset;
+        impl->mTable  = implCopy->mTable;
         return MAMA_STATUS_OK;
     }
 }
@@ -226,6 +273,8 @@ mamaTimeZone_set (mamaTimeZone   timeZone,
             mamaTimeZoneImpl* impl = (mamaTimeZoneImpl*)timeZone;
             snprintf (impl->mTz, (MAX_TZ_LEN - 1), "%s", tzId);
         }
+        ((mamaTimeZoneImpl*)timeZone)->mTable =
+            getTable (((mamaTimeZoneImpl*)timeZone)->mTz);
         status = mamaTimeZone_check(timeZone);
     }
     return status;
@@ -243,6 +292,7 @@ mamaTimeZone_clear (mamaTimeZone   timeZone)
         mamaTimeZoneImpl* impl = (mamaTimeZoneImpl*)timeZone;
         memset(impl->mTz, 0, MAX_TZ_LEN);
         impl->mOffset = 0;
+        impl->mTable  = NULL;
         return MAMA_STATUS_OK;
     }
 }
@@ -281,8 +331,67 @@ mamaTimeZone_getOffset (const mamaTimeZone  timeZone,
     }
     else
     {
-        mamaTimeZoneImpl* impl = (mamaTimeZoneImpl*)timeZone;
-        *result = impl->mOffset;
+        mamaTimeZoneImpl*        impl  = (mamaTimeZoneImpl*)timeZone;
+        const mamaTimeZoneTable* table = impl->mTable;
+        if (table)
+        {
+            *result = tableOffsetAt (table, (mama_i64_t) time (NULL));
+        }
+        else
+        {
+            *result = impl->mOffset;
+        }
+        return MAMA_STATUS_OK;
+    }
+}
+
+mama_status
+mamaTimeZone_getOffsetAt (const mamaTimeZone  timeZone,
+                          mama_i64_t          utcSeconds,
+                          mama_i32_t*         result)
+{
+    if (!timeZone || !result)
+    {
+        return MAMA_STATUS_INVALID_ARG;
+    }
+    else
+    {
+        mamaTimeZoneImpl*        impl  = (mamaTimeZoneImpl*)timeZone;
+        const mamaTimeZoneTable* table = impl->mTable;
+        *result = table ? tableOffsetAt (table, utcSeconds) : impl->mOffset;
+        return MAMA_STATUS_OK;
+    }
+}
+
+mama_status
+mamaTimeZone_getLocalOffsetAt (const mamaTimeZone  timeZone,
+                               mama_i64_t          localSeconds,
+                               mama_i32_t*         result)
+{
+    if (!timeZone || !result)
+    {
+        return MAMA_STATUS_INVALID_ARG;
+    }
+    else
+    {
+        mamaTimeZoneImpl*        impl  = (mamaTimeZoneImpl*)timeZone;
+        const mamaTimeZoneTable* table = impl->mTable;
+        if (table)
+        {
+            /* Guess from the offset at the same UTC instant, then correct
+             * once.  Times skipped by a transition keep the first guess. */
+            mama_i32_t guess  = tableOffsetAt (table, localSeconds);
+            mama_i32_t offset = tableOffsetAt (table, localSeconds - guess);
+            if (tableOffsetAt (table, localSeconds - offset) != offset)
+            {
+                offset = guess;
+            }
+            *result = offset;
+        }
+        else
+        {
+            *result = impl->mOffset;
+        }
         return MAMA_STATUS_OK;
     }
 }
@@ -296,7 +405,24 @@ mamaTimeZone_check (mamaTimeZone  timeZone)
     }
     else
     {
-        mamaTimeZoneImpl* impl = (mamaTimeZoneImpl*)timeZone;
+        mamaTimeZoneImpl*        impl  = (mamaTimeZoneImpl*)timeZone;
+        const mamaTimeZoneTable* table = impl->mTable;
+        if (table)
+        {
+            impl->mOffset = tableOffsetAt (table, (mama_i64_t) time (NULL));
+            return MAMA_STATUS_OK;
+        }
+        return checkFromEnvironment (impl);
+    }
+}
+
+/* Fallback for zones we could not load: switch TZ and ask the C library.
+ * This serialises callers and is unsafe for other threads reading TZ, so
+ * it is only used when there is no zoneinfo for the zone. */
+static mama_status
+checkFromEnvironment (mamaTimeZoneImpl* impl)
+{
+    {
         const char* tzSaved = NULL;
         time_t      tzClock;
         time_t      gmClock;
@@ -352,6 +478,11 @@ mamaTimeZone_check (mamaTimeZone  timeZone)
 
         impl->mOffset = difftime (gmClock, tzClock);
 
+        /* Zones in this mode need periodic rechecking for daylight
+         * savings changes. */
+        if (!sThreadStarted)
+            startThread();
+
         /* release the mutex on this method */
         wthread_static_mutex_unlock (&sCheck_mutex);
 
@@ -366,11 +497,7 @@ mamaTimeZone_setScanningInterval (mama_f64_t  seconds)
 }
 
 /* Utility file scoped method used to start the single instance
- * monitoring thread.
- *
- * NB! At the moment this is not thread safe.  However all instances
- * are currently being created on a single thread.  Revisit
- * implementation if this changes. */
+ * monitoring thread.  Called with sCheck_mutex held. */
 static void startThread(void)
 {
     /* start the thread scanning the vector of TimeZones. */
@@ -443,3 +570,540 @@ static void* updateTimeZones (void* ptr)
     /* The return value is not applicable. */
     return NULL;
 }
+
+
+/*=========================================================================
+  =                       Zone table construction                         =
+  =========================================================================*/
+
+/* A POSIX TZ rule, e.g. "EST5EDT,M3.2.0,M11.1.0". */
+typedef struct tzRule_
+{
+    mama_i32_t  mStdOffset;     /* seconds east of UTC */
+    mama_i32_t  mDstOffset;
+    int         mHasDst;
+    char        mStartType;     /* 'J', 'D' (zero based day) or 'M' */
+    int         mStart[3];
+    mama_i32_t  mStartTime;     /* local seconds after midnight */
+    char        mEndType;
+    int         mEnd[3];
+    mama_i32_t  mEndTime;
+} tzRule;
+
+/* Growable pair of transition and offset arrays. */
+typedef struct tzBuilder_
+{
+    mama_i64_t*  mTransitions;
+    mama_i32_t*  mOffsets;
+    size_t       mCount;
+    size_t       mCapacity;
+} tzBuilder;
+
+static const char* sZoneInfoDirs[] =
+{
+    "/usr/share/zoneinfo",
+    "/usr/lib/zoneinfo",
+    "/usr/share/lib/zoneinfo",
+    "/etc/zoneinfo",
+    NULL
+};
+
+static int
+isLeapYear (mama_i64_t year)
+{
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+/* Days since the Epoch of a proleptic Gregorian date (month 1-12). */
+static mama_i64_t
+daysFromCivil (mama_i64_t year, int month, int day)
+{
+    mama_i64_t era;
+    mama_i64_t yoe;
+    mama_i64_t doy;
+    mama_i64_t doe;
+
+    year -= month <= 2 ? 1 : 0;
+    era   = (year >= 0 ? year : year - 399) / 400;
+    yoe   = year - era * 400;
+    doy   = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    doe   = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+static mama_i64_t
+yearOfDays (mama_i64_t days)
+{
+    mama_i64_t era;
+    mama_i64_t doe;
+    mama_i64_t yoe;
+    mama_i64_t doy;
+
+    days += 719468;
+    era   = (days >= 0 ? days : days - 146096) / 146097;
+    doe   = days - era * 146097;
+    yoe   = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    doy   = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    return yoe + era * 400 + ((5 * doy + 2) / 153 >= 10 ? 1 : 0);
+}
+
+static int
+builderAdd (tzBuilder* builder, mama_i64_t when, mama_i32_t offset)
+{
+    if (builder->mCount == builder->mCapacity)
+    {
+        size_t      capacity    = builder->mCapacity ? builder->mCapacity * 2 : 64;
+        mama_i64_t* transitions = (mama_i64_t*) realloc (builder->mTransitions,
+                                        capacity * sizeof (mama_i64_t));
+        mama_i32_t* offsets;
+
+        if (!transitions)
+            return 0;
+        builder->mTransitions = transitions;
+
+        offsets = (mama_i32_t*) realloc (builder->mOffsets,
+                                         capacity * sizeof (mama_i32_t));
+        if (!offsets)
+            return 0;
+        builder->mOffsets  = offsets;
+        builder->mCapacity = capacity;
+    }
+    builder->mTransitions[builder->mCount] = when;
+    builder->mOffsets[builder->mCount]     = offset;
+    builder->mCount++;
+    return 1;
+}
+
+static const char*
+parseRuleName (const char* p)
+{
+    const char* start = p;
+    if ('<' == *p)
+    {
+        while (*p && '>' != *p)
+            p++;
+        return '>' == *p ? p + 1 : NULL;
+    }
+    while (isalpha ((unsigned char) *p))
+        p++;
+    return p - start >= 3 ? p : NULL;
+}
+
+/* [+|-]hh[:mm[:ss]], returned in seconds. */
+static const char*
+parseRuleTime (const char* p, mama_i32_t* result)
+{
+    int        sign  = 1;
+    mama_i32_t value = 0;
+    int        part  = 0;
+
+    if ('+' == *p || '-' == *p)
+    {
+        sign = '-' == *p ? -1 : 1;
+        p++;
+    }
+    if (!isdigit ((unsigned char) *p))
+        return NULL;
+    for (part = 0; part < 3; part++)
+    {
+        mama_i32_t field = 0;
+        while (isdigit ((unsigned char) *p))
+            field = field * 10 + (*p++ - '0');
+        value += field * (0 == part ? 3600 : (1 == part ? 60 : 1));
+        if (':' != *p || !isdigit ((unsigned char) p[1]))
+            break;
+        p++;
+    }
+    *result = sign * value;
+    return p;
+}
+
+static const char*
+parseRuleDate (const char* p, char* type, int date[3], mama_i32_t* time)
+{
+    int i;
+
+    date[0] = date[1] = date[2] = 0;
+    if ('M' == *p)
+    {
+        *type = 'M';
+        p++;
+        for (i = 0; i < 3; i++)
+        {
+            if (!isdigit ((unsigned char) *p))
+                return NULL;
+            while (isdigit ((unsigned char) *p))
+                date[i] = date[i] * 10 + (*p++ - '0');
+            if (i < 2 && '.' != *p++)
+                return NULL;
+        }
+    }
+    else
+    {
+        *type = 'D';
+        if ('J' == *p)
+        {
+            *type = 'J';
+            p++;
+        }
+        if (!isdigit ((unsigned char) *p))
+            return NULL;
+        while (isdigit ((unsigned char) *p))
+            date[0] = date[0] * 10 + (*p++ - '0');
+    }
+
+    *time = 2 * 3600;
+    if ('/' == *p)
+        p = parseRuleTime (p + 1, time);
+    return p;
+}
+
+/* Parse a POSIX TZ string.  Offsets in the string are west of UTC. */
+static int
+parseRule (const char* p, tzRule* rule)
+{
+    mama_i32_t west = 0;
+
+    memset (rule, 0, sizeof (tzRule));
+    if (!(p = parseRuleName (p)))
+        return 0;
+    if (!*p && (0 == strncmp (p - 3, "UTC", 3) || 0 == strncmp (p - 3, "GMT", 3)))
+        return 1;
+    if (!(p = parseRuleTime (p, &west)))
+        return 0;
+    rule->mStdOffset = -west;
+    rule->mDstOffset = rule->mStdOffset;
+    if (!*p)
+        return 1;
+
+    if (!(p = parseRuleName (p)))
+        return 0;
+    rule->mHasDst    = 1;
+    rule->mDstOffset = rule->mStdOffset + 3600;
+    if (*p && ',' != *p)
+    {
+        if (!(p = parseRuleTime (p, &west)))
+            return 0;
+        rule->mDstOffset = -west;
+    }
+
+    /* Without explicit dates use the current US rules, as the C library
+     * does. */
+    if (!*p)
+        p = ",M3.2.0,M11.1.0";
+    if (',' != *p++)
+        return 0;
+    if (!(p = parseRuleDate (p, &rule->mStartType, rule->mStart,
+                             &rule->mStartTime)))
+        return 0;
+    if (',' != *p++)
+        return 0;
+    if (!(p = parseRuleDate (p, &rule->mEndType, rule->mEnd, &rule->mEndTime)))
+        return 0;
+    return 1;
+}
+
+/* The local midnight, in days since the Epoch, of a rule date in a year. */
+static mama_i64_t
+ruleDay (mama_i64_t year, char type, const int date[3])
+{
+    mama_i64_t jan1 = daysFromCivil (year, 1, 1);
+    switch (type)
+    {
+    case 'J':
+        /* 1-365, never counting 29 February */
+        return jan1 + date[0] - 1 + (isLeapYear (year) && date[0] >= 60 ? 1 : 0);
+    case 'D':
+        return jan1 + date[0];
+    default:
+    {
+        /* Mm.w.d: day d (0 = Sunday) of week w (5 = last) of month m */
+        static const int monthDays[] = {31,28,31,30,31,30,31,31,30,31,30,31};
+        int        month  = date[0] < 1 || date[0] > 12 ? 1 : date[0];
+        mama_i64_t first  = daysFromCivil (year, month, 1);
+        int        wday   = (int) ((first + 4) % 7);
+        int        length = monthDays[month - 1] +
+                            (2 == month && isLeapYear (year) ? 1 : 0);
+        int        mday   = 1 + (date[2] - wday + 7) % 7 + (date[1] - 1) * 7;
+        while (mday > length)
+            mday -= 7;
+        return first + mday - 1;
+    }
+    }
+}
+
+/* Add the transitions of a rule for the years after a given time. */
+static int
+expandRule (const tzRule* rule, mama_i64_t after, tzBuilder* builder)
+{
+    mama_i64_t year = after < 0 ? 1970 : yearOfDays (after / SECONDS_IN_A_DAY);
+
+    if (!rule->mHasDst)
+        return 1;
+
+    for (; year <= MAX_TZ_RULE_YEAR; year++)
+    {
+        mama_i64_t start = ruleDay (year, rule->mStartType, rule->mStart) *
+                           SECONDS_IN_A_DAY + rule->mStartTime - rule->mStdOffset;
+        mama_i64_t end   = ruleDay (year, rule->mEndType, rule->mEnd) *
+                           SECONDS_IN_A_DAY + rule->mEndTime - rule->mDstOffset;
+        /* Southern hemisphere zones end daylight savings first */
+        mama_i64_t first       = start < end ? start : end;
+        mama_i64_t second      = start < end ? end : start;
+        mama_i32_t firstOffset = start < end ? rule->mDstOffset : rule->mStdOffset;
+        mama_i32_t secondOffset = start < end ? rule->mStdOffset : rule->mDstOffset;
+
+        if (first > after && !builderAdd (builder, first, firstOffset))
+            return 0;
+        if (second > after && !builderAdd (builder, second, secondOffset))
+            return 0;
+    }
+    return 1;
+}
+
+static mama_i64_t
+readBigEndian (const unsigned char* p, int bytes)
+{
+    mama_u64_t value = 0;
+    int        i;
+    for (i = 0; i < bytes; i++)
+        value = (value << 8) | p[i];
+    /* sign extend */
+    if (bytes < 8 && (p[0] & 0x80))
+        value |= ~(mama_u64_t)0 << (bytes * 8);
+    return (mama_i64_t) value;
+}
+
+/* Parse RFC 8536 (TZif) data, preferring the 64 bit section of version 2
+ * and later files, and expand its footer rule. */
+static int
+parseZoneData (const unsigned char* data,
+               size_t               len,
+               tzBuilder*           builder,
+               mama_i32_t*          initialOffset)
+{
+    const unsigned char* p       = data;
+    const unsigned char* end     = data + len;
+    int                  timeLen = 4;
+    size_t               isutcnt, isstdcnt, leapcnt, timecnt, typecnt, charcnt;
+    size_t               i;
+    const unsigned char* times;
+    const unsigned char* indices;
+    const unsigned char* types;
+    mama_i64_t           last    = -1;
+    tzRule               rule;
+
+    if (len < 44 || 0 != memcmp (p, "TZif", 4))
+        return 0;
+
+    for (;;)
+    {
+        isutcnt  = (size_t) readBigEndian (p + 20, 4);
+        isstdcnt = (size_t) readBigEndian (p + 24, 4);
+        leapcnt  = (size_t) readBigEndian (p + 28, 4);
+        timecnt  = (size_t) readBigEndian (p + 32, 4);
+        typecnt  = (size_t) readBigEndian (p + 36, 4);
+        charcnt  = (size_t) readBigEndian (p + 40, 4);
+
+        if (4 == timeLen && data[4] >= '2')
+        {
+            /* skip the version 1 data to the 64 bit header */
+            p += 44 + timecnt * 5 + typecnt * 6 + charcnt + leapcnt * 8 +
+                 isstdcnt + isutcnt;
+            if (p + 44 > end || 0 != memcmp (p, "TZif", 4))
+                return 0;
+            timeLen = 8;
+            continue;
+        }
+        break;
+    }
+
+    times   = p + 44;
+    indices = times + timecnt * timeLen;
+    types   = indices + timecnt;
+    if (0 == typecnt || types + typecnt * 6 > end)
+        return 0;
+
+    *initialOffset = (mama_i32_t) readBigEndian (types, 4);
+    for (i = 0; i < timecnt; i++)
+    {
+        size_t type = indices[i];
+        if (type >= typecnt)
+            return 0;
+        last = readBigEndian (times + i * timeLen, timeLen);
+        if (!builderAdd (builder, last,
+                         (mama_i32_t) readBigEndian (types + type * 6, 4)))
+            return 0;
+    }
+
+    /* The footer gives the rule for times after the last transition. */
+    p = types + typecnt * 6 + charcnt + leapcnt * (timeLen + 4) +
+        isstdcnt + isutcnt;
+    if (8 == timeLen && p < end && '\n' == *p)
+    {
+        char   footer[MAX_TZ_LEN];
+        size_t n = 0;
+        for (p++; p < end && '\n' != *p && n < sizeof (footer) - 1; p++)
+            footer[n++] = (char) *p;
+        footer[n] = '\0';
+        if (n && parseRule (footer, &rule))
+        {
+            if (0 == timecnt)
+                *initialOffset = rule.mStdOffset;
+            return expandRule (&rule, timecnt ? last : -1, builder);
+        }
+    }
+    return 1;
+}
+
+static unsigned char*
+readZoneFile (const char* path, size_t* len)
+{
+    FILE*          file = fopen (path, "rb");
+    unsigned char* data = NULL;
+    long           size = 0;
+
+    if (!file)
+        return NULL;
+
+    if (0 == fseek (file, 0, SEEK_END) &&
+        (size = ftell (file)) > 0 && size <= MAX_TZ_FILE_LEN &&
+        0 == fseek (file, 0, SEEK_SET))
+    {
+        data = (unsigned char*) malloc ((size_t) size);
+        if (data && fread (data, 1, (size_t) size, file) != (size_t) size)
+        {
+            free (data);
+            data = NULL;
+        }
+    }
+    fclose (file);
+    *len = (size_t) size;
+    return data;
+}
+
+/* Load a zone from zoneinfo, falling back to treating the identifier as a
+ * POSIX TZ rule.  An empty identifier is the local zone. */
+static mamaTimeZoneTable*
+loadTable (const char* tzId)
+{
+    char                path[256];
+    const char*         zone       = tzId;
+    unsigned char*      data       = NULL;
+    size_t              len        = 0;
+    tzBuilder           builder;
+    mama_i32_t          initial    = 0;
+    int                 loaded     = 0;
+    mamaTimeZoneTable*  table      = NULL;
+    tzRule              rule;
+
+    memset (&builder, 0, sizeof (builder));
+
+    if (!zone[0])
+    {
+        zone = environment_getVariable ("TZ");
+        if (!zone || !zone[0])
+            zone = "/etc/localtime";
+    }
+    if (':' == zone[0])
+        zone++;
+
+    if ('/' == zone[0])
+    {
+        data = readZoneFile (zone, &len);
+    }
+    else if (!strstr (zone, ".."))
+    {
+        const char* dir = environment_getVariable ("TZDIR");
+        int         i   = 0;
+        if (dir && dir[0])
+        {
+            snprintf (path, sizeof (path), "%s/%s", dir, zone);
+            data = readZoneFile (path, &len);
+        }
+        for (i = 0; !data && sZoneInfoDirs[i]; i++)
+        {
+            snprintf (path, sizeof (path), "%s/%s", sZoneInfoDirs[i], zone);
+            data = readZoneFile (path, &len);
+        }
+    }
+
+    if (data)
+    {
+        loaded = parseZoneData (data, len, &builder, &initial);
+        free (data);
+    }
+    else if (parseRule (zone, &rule))
+    {
+        initial = rule.mStdOffset;
+        loaded  = expandRule (&rule, -1, &builder);
+    }
+
+    if (loaded)
+    {
+        table = (mamaTimeZoneTable*) calloc (1, sizeof (mamaTimeZoneTable));
+    }
+    if (!table)
+    {
+        free (builder.mTransitions);
+        free (builder.mOffsets);
+        return NULL;
+    }
+
+    snprintf (table->mName, sizeof (table->mName), "%s", tzId);
+    table->mTransitions    = builder.mTransitions;
+    table->mOffsets        = builder.mOffsets;
+    table->mNumTransitions = builder.mCount;
+    table->mInitialOffset  = initial;
+    return table;
+}
+
+/* Return the shared table for a zone, loading it on first use. */
+static const mamaTimeZoneTable*
+getTable (const char* tzId)
+{
+    mamaTimeZoneTable* table = NULL;
+
+    wthread_static_mutex_lock (&sTable_mutex);
+
+    for (table = sTables; table; table = table->mNext)
+    {
+        if (0 == strcmp (table->mName, tzId))
+            break;
+    }
+    if (!table)
+    {
+        table = loadTable (tzId);
+        if (table)
+        {
+            table->mNext = sTables;
+            sTables      = table;
+        }
+        else
+        {
+            mama_log (MAMA_LOG_LEVEL_FINE,
+                      "mamaTimeZone: no zoneinfo for \"%s\"; "
+                      "using the TZ environment variable", tzId);
+        }
+    }
+
+    wthread_static_mutex_unlock (&sTable_mutex);
+    return table;
+}
+
+static mama_i32_t
+tableOffsetAt (const mamaTimeZoneTable* table, mama_i64_t utcSeconds)
+{
+    /* Find the first transition after the time */
+    size_t low  = 0;
+    size_t high = table->mNumTransitions;
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2;
+        if (table->mTransitions[mid] <= utcSeconds)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return 0 == low ? table->mInitialOffset : table->mOffsets[low - 1];
+}
@@ -42,6 +42,8 @@
 #include "mama/stat.h"
 #include "mama/statfields.h"
 #include "statsgeneratorinternal.h"
+#include "statscollectorinternal.h"
+#include "queueimpl.h"
 #include "mama/statscollector.h"
 #include "wombat/strutils.h"
 
@@ -243,6 +245,10 @@ void mamaTransportImpl_clearTransportWithListeners (transportImpl *impl);
 static void
 setPossiblyStaleForListeners (transportImpl* transport);
 
+static void
+mamaTransportImpl_pollLatencyCb (mamaStatsCollector statsCollector,
+                                 void*              closure);
+
 mama_status
 mamaTransport_allocate (mamaTransport* result)
 {
@@ -1132,6 +1138,13 @@ mamaTransport_initStats (mamaTransport transport)
         if (status != MAMA_STATUS_OK) return status;
     }
 
+    if (mamaStatsCollectorImpl_getLatencyHistograms (self->mStatsCollector))
+    {
+        mamaStatsCollector_setPollCallback (self->mStatsCollector,
+                                            mamaTransportImpl_pollLatencyCb,
+                                            transport);
+    }
+
     if (mamaInternal_getStatsGenerator ())
     {
         if (MAMA_STATUS_OK != (
@@ -1827,6 +1840,18 @@ mamaTransportImpl_preRecapCacheEnabled (mamaTransport transport)
     return 0;
 }
 
+void
+mamaTransportImpl_recapReceived (mamaTransport    transport,
+                                 mamaSubscription subscription)
+{
+    if (self && self->mRefreshTransport)
+    {
+        refreshTransport_recapReceived (
+            self->mRefreshTransport,
+            mamaSubscription_getSubscHandle (subscription));
+    }
+}
+
 /* Process an advisory message and invokes callbacks
  *                    on all listeners.
  * @param transport The transport.
@@ -2358,6 +2383,90 @@ mamaTransport_getNativeTransportNamingCtx (mamaTransport transport,
 }
 
 
+/* The distinct queues found while building the transport latency view. */
+struct latencyViewClosure
+{
+    mamaLatencyHistogram* histograms;
+    mamaQueue*            queues;
+    size_t                numQueues;
+    size_t                maxQueues;
+};
+
+static void
+latencyViewIterator (wList list, void* element, void* c)
+{
+    struct latencyViewClosure* closure = (struct latencyViewClosure*)c;
+    SubscriptionInfo*          subsc   = (SubscriptionInfo*)element;
+    mamaQueue                  queue   = NULL;
+    mamaLatencyHistogram*      from    = NULL;
+    size_t                     i       = 0;
+    int                        span    = 0;
+
+    mamaSubscription_getQueue (subsc->mSubscription, &queue);
+    if (!queue) return;
+
+    /* Many subscriptions share a queue, only merge it once */
+    for (i = 0; i < closure->numQueues; i++)
+    {
+        if (closure->queues[i] == queue) return;
+    }
+
+    if (closure->numQueues == closure->maxQueues)
+    {
+        size_t     newMax = closure->maxQueues ? closure->maxQueues * 2 : 8;
+        mamaQueue* queues = (mamaQueue*)realloc (closure->queues,
+                                                 newMax * sizeof (mamaQueue));
+        if (!queues) return;
+
+        closure->queues    = queues;
+        closure->maxQueues = newMax;
+    }
+    closure->queues[closure->numQueues++] = queue;
+
+    from = mamaStatsCollectorImpl_getLatencyHistograms (
+                mamaQueueImpl_getStatsCollector (queue));
+    if (!from) return;
+
+    for (span = 0; span < MAMA_LATENCY_SPAN_MAX; span++)
+        mamaLatencyHistogram_merge (closure->histograms[span], from[span]);
+}
+
+/* Rebuild the transport's latency histograms from the queues its
+ * subscriptions dispatch on, messages are only recorded per queue. */
+static void
+mamaTransportImpl_buildLatencyView (mamaTransport transport)
+{
+    struct latencyViewClosure closure;
+    int                       span;
+
+    memset (&closure, 0, sizeof (closure));
+    closure.histograms = mamaStatsCollectorImpl_getLatencyHistograms (
+                            self->mStatsCollector);
+    if (!closure.histograms) return;
+
+    for (span = 0; span < MAMA_LATENCY_SPAN_MAX; span++)
+        mamaLatencyHistogram_reset (closure.histograms[span]);
+
+    if (self->mRefreshTransport)
+    {
+        refreshTransport_iterateListeners (self->mRefreshTransport,
+                                           latencyViewIterator, &closure);
+    }
+    else
+    {
+        list_for_each (self->mListeners, latencyViewIterator, &closure);
+    }
+
+    free (closure.queues);
+}
+
+static void
+mamaTransportImpl_pollLatencyCb (mamaStatsCollector statsCollector,
+                                 void*              closure)
+{
+    mamaTransportImpl_buildLatencyView ((mamaTransport)closure);
+}
+
 mamaStatsCollector
 mamaTransport_getStatsCollector (mamaTransport transport)
 {
@@ -2365,6 +2474,21 @@ mamaTransport_getStatsCollector (mamaTransport transport)
     return self->mStatsCollector;
 }
 
+mama_status
+mamaTransport_getLatencyHistogram (mamaTransport         transport,
+                                   mamaLatencySpan       span,
+                                   mamaLatencyHistogram* histogram)
+{
+    if (!self) return MAMA_STATUS_NULL_ARG;
+    if (!self->mStatsCollector) return MAMA_STATUS_NOT_FOUND;
+
+    mamaTransportImpl_buildLatencyView (transport);
+
+    return mamaStatsCollector_getLatencyHistogram (self->mStatsCollector,
+                                                   span,
+                                                   histogram);
+}
+
 
 static void
 roundRobin (int         curTransportIndex,
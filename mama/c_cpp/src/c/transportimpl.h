@@ -29,6 +29,7 @@
 #include "bridge.h"
 #include "throttle.h"
 #include "list.h"
+#include "wombat/wInterlocked.h"
 
 #if defined(__cplusplus)
 extern "C" {
@@ -45,6 +46,12 @@ typedef struct SubscriptionInfo_
 
     time_t mNextRefreshTime;
     int    mIsInMainList;
+
+    /* The last stale recap round this subscription was recapped in. */
+    unsigned int mRecapRound;
+
+    /* Set while a recap requested by the refresh transport is awaited. */
+    wInterlockedInt mRecapPending;
 } SubscriptionInfo;
 
 typedef struct PublisherInfo_
@@ -307,6 +314,15 @@ mamaTransportImpl_forceClientDisconnect (mamaTransport   transport,
 extern mama_bool_t
 mamaTransportImpl_preRecapCacheEnabled (mamaTransport transport);
 
+/**
+ * Called for each recap received on the transport so that the refresh
+ * transport can pace stale recap requests against the rate at which the
+ * recaps it asked for are answered.
+ */
+extern void
+mamaTransportImpl_recapReceived (mamaTransport    transport,
+                                 mamaSubscription subscription);
+
 #if defined(__cplusplus)
 }
 #endif
@@ -0,0 +1,291 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+/**
+ * A group of queues which hands queues out according to a selection policy.
+ * The state lives in MamaPolicyQueueGroupImpl so that it can grow without
+ * changing the layout of the exported class.
+ */
+
+#include <map>
+#include <string>
+#include <vector>
+#include "mama/mamacpp.h"
+#include "mama/MamaPolicyQueueGroup.h"
+
+using std::map;
+using std::string;
+using std::vector;
+
+namespace Wombat
+{
+
+    struct MamaPolicyQueueGroupImpl
+    {
+        MamaPolicyQueueGroup::SelectionPolicy  mPolicy;
+        unsigned int                           mCallCount;
+        MamaQueue*                             mDefaultQueue;
+        vector<MamaQueue*>                     mQueues;
+        vector<MamaDispatcher*>                mDispatchers;
+        vector<unsigned int>                   mAssigned;
+
+        /* Symbol to queue index placements for POLICY_SYMBOL_AFFINE */
+        map<string, int>                       mPlacements;
+
+        int leastLoaded ();
+    };
+
+    /* FNV-1a hash of the symbol, the key for the consistent hash below. */
+    static uint64_t hashSymbol (const char* symbol)
+    {
+        uint64_t hash = 14695981039346656037ULL;
+        while (*symbol)
+        {
+            hash ^= (unsigned char)*symbol++;
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    /* Jump consistent hash (Lamping and Veach). */
+    static int jumpHash (uint64_t key, int buckets)
+    {
+        int64_t b = -1;
+        int64_t j = 0;
+        while (j < buckets)
+        {
+            b   = j;
+            key = key * 2862933555777941757ULL + 1;
+            j   = (int64_t)((b + 1) * ((double)(1LL << 31) /
+                                       (double)((key >> 33) + 1)));
+        }
+        return (int)b;
+    }
+
+    int MamaPolicyQueueGroupImpl::leastLoaded (void)
+    {
+        /* Start the scan where round robin would so that an idle group still
+         * spreads evenly, then prefer the shortest backlog and, among equal
+         * backlogs, the queue that has been handed out least. */
+        int    count       = (int)mQueues.size ();
+        int    best        = mCallCount++ % count;
+        size_t bestPending = mQueues[best]->getEventCount ();
+
+        for (int n = 1; n < count; n++)
+        {
+            int    i       = (best + n) % count;
+            size_t pending = mQueues[i]->getEventCount ();
+
+            if (pending < bestPending ||
+                (pending == bestPending && mAssigned[i] < mAssigned[best]))
+            {
+                best        = i;
+                bestPending = pending;
+            }
+        }
+
+        mAssigned[best]++;
+        return best;
+    }
+
+    MamaPolicyQueueGroup::~MamaPolicyQueueGroup (void)
+    {
+        for (size_t i = 0; i < mImpl->mQueues.size (); i++)
+        {
+            delete mImpl->mDispatchers[i];
+            delete mImpl->mQueues[i];
+        }
+
+        delete mImpl;
+    }
+
+    MamaPolicyQueueGroup::MamaPolicyQueueGroup (int              numberOfQueues,
+                                                mamaBridge       bridgeImpl,
+                                                SelectionPolicy  policy)
+        : mImpl (new MamaPolicyQueueGroupImpl)
+    {
+        mImpl->mPolicy    = policy;
+        mImpl->mCallCount = 0;
+
+        for (int i = 0; i < numberOfQueues; i++)
+        {
+            MamaQueue* queue = new MamaQueue;
+            queue->create (bridgeImpl);
+
+            MamaDispatcher* dispatcher = new MamaDispatcher;
+            dispatcher->create (queue);
+
+            mImpl->mQueues.push_back (queue);
+            mImpl->mDispatchers.push_back (dispatcher);
+            mImpl->mAssigned.push_back (0);
+        }
+
+        mImpl->mDefaultQueue = Mama::getDefaultEventQueue (bridgeImpl);
+    }
+
+    MamaQueue* MamaPolicyQueueGroup::getNextQueue (void)
+    {
+        if (mImpl->mQueues.empty ())
+        {
+            return mImpl->mDefaultQueue;
+        }
+
+        if (POLICY_ROUND_ROBIN == mImpl->mPolicy)
+        {
+            int index = mImpl->mCallCount++ % mImpl->mQueues.size ();
+            mImpl->mAssigned[index]++;
+            return mImpl->mQueues[index];
+        }
+
+        return mImpl->mQueues[mImpl->leastLoaded ()];
+    }
+
+    MamaQueue* MamaPolicyQueueGroup::getNextQueue (const char* symbol)
+    {
+        if (mImpl->mQueues.empty () || symbol == NULL)
+        {
+            return getNextQueue ();
+        }
+
+        switch (mImpl->mPolicy)
+        {
+        case POLICY_SYMBOL_HASH:
+        {
+            int index = getSymbolQueueIndex (symbol,
+                                             (int)mImpl->mQueues.size ());
+            mImpl->mAssigned[index]++;
+            return mImpl->mQueues[index];
+        }
+
+        case POLICY_SYMBOL_AFFINE:
+        {
+            map<string, int>::iterator it = mImpl->mPlacements.find (symbol);
+
+            if (it == mImpl->mPlacements.end ())
+            {
+                it = mImpl->mPlacements.insert (
+                        std::make_pair (string (symbol),
+                                        mImpl->leastLoaded ())).first;
+            }
+            return mImpl->mQueues[it->second];
+        }
+
+        default:
+            return getNextQueue ();
+        }
+    }
+
+    void MamaPolicyQueueGroup::rebalance (void)
+    {
+        if (POLICY_SYMBOL_AFFINE != mImpl->mPolicy || mImpl->mQueues.empty ())
+        {
+            return;
+        }
+
+        size_t         count   = mImpl->mQueues.size ();
+        vector<size_t> pending (count);
+        size_t         total   = 0;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            pending[i] = mImpl->mQueues[i]->getEventCount ();
+            total     += pending[i];
+        }
+
+        /* A queue is overloaded when it holds more than twice its share */
+        map<string, int>::iterator it = mImpl->mPlacements.begin ();
+        while (it != mImpl->mPlacements.end ())
+        {
+            int queue = it->second;
+            if (pending[queue] * count > total * 2)
+            {
+                mImpl->mAssigned[queue]--;
+                mImpl->mPlacements.erase (it++);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    MamaPolicyQueueGroup::SelectionPolicy
+    MamaPolicyQueueGroup::getSelectionPolicy (void)
+    {
+        return mImpl->mPolicy;
+    }
+
+    int MamaPolicyQueueGroup::getNumberOfQueues (void)
+    {
+        return (int)mImpl->mQueues.size ();
+    }
+
+    void MamaPolicyQueueGroup::stopDispatch (void)
+    {
+        for (size_t i = 0; i < mImpl->mDispatchers.size (); i++)
+        {
+            delete mImpl->mDispatchers[i];
+            mImpl->mDispatchers[i] = NULL;
+        }
+    }
+
+    void MamaPolicyQueueGroup::startDispatch (void)
+    {
+        for (size_t i = 0; i < mImpl->mDispatchers.size (); i++)
+        {
+            if (!mImpl->mDispatchers[i])
+            {
+                mImpl->mDispatchers[i] = new MamaDispatcher;
+                mImpl->mDispatchers[i]->create (mImpl->mQueues[i]);
+            }
+        }
+    }
+
+    void MamaPolicyQueueGroup::destroyWait (void)
+    {
+        // Stop dispatching to ensure that no more messages are being processed.
+        stopDispatch ();
+
+        for (size_t i = 0; i < mImpl->mQueues.size (); i++)
+        {
+            // This will block until the queue destroy has completed
+            mImpl->mQueues[i]->destroyWait ();
+            delete mImpl->mQueues[i];
+        }
+
+        mImpl->mQueues.clear ();
+        mImpl->mDispatchers.clear ();
+        mImpl->mAssigned.clear ();
+        mImpl->mPlacements.clear ();
+    }
+
+    int MamaPolicyQueueGroup::getSymbolQueueIndex (const char*  symbol,
+                                                   int          numberOfQueues)
+    {
+        if (symbol == NULL || numberOfQueues <= 0)
+        {
+            return 0;
+        }
+        return jumpHash (hashSymbol (symbol), numberOfQueues);
+    }
+
+} /* namespace Wombat */
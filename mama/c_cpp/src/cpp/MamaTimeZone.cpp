@@ -118,6 +118,13 @@ namespace Wombat
         return result;
     }
 
+    mama_i32_t MamaTimeZone::offsetAt (mama_i64_t  utcSeconds) const
+    {
+        mama_i32_t result = 0;
+        mamaTimeZone_getOffsetAt (myCimpl, utcSeconds, &result);
+        return result;
+    }
+
     void MamaTimeZone::check ()
     {
         mamaTimeZone_check (myCimpl);
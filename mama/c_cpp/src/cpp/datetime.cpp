@@ -30,30 +30,31 @@ namespace Wombat
 {
 
     MamaDateTime::MamaDateTime()
-        : mStrRep (NULL)
+        : mDateTime (mamaDateTime_initStorage (&mStorage))
+        , mStrRep   (NULL)
     {
-        mamaDateTime_clear (&mDateTime);
     }
 
     MamaDateTime::MamaDateTime (const MamaDateTime& copy)
-        : mStrRep (NULL)
+        : mDateTime (mamaDateTime_initStorage (&mStorage))
+        , mStrRep   (NULL)
     {
-        mamaDateTime_copy (&mDateTime,
-                           const_cast<const mamaDateTime>(&copy.mDateTime));
+        mamaDateTime_copy (mDateTime,
+                           const_cast<const mamaDateTime>(copy.mDateTime));
     }
 
     MamaDateTime::MamaDateTime (const char*          str,
                                 const MamaTimeZone*  tz)
-        : mStrRep (NULL)
+        : mDateTime (mamaDateTime_initStorage (&mStorage))
+        , mStrRep   (NULL)
     {
-        mamaDateTime_clear (&mDateTime);
         if (tz)
         {
-            mamaDateTime_setFromStringWithTz (&mDateTime, str, tz->getCValue());
+            mamaDateTime_setFromStringWithTz (mDateTime, str, tz->getCValue());
         }
         else
         {
-            mamaDateTime_setFromString (&mDateTime, str);
+            mamaDateTime_setFromString (mDateTime, str);
         }
     }
 
@@ -69,8 +70,8 @@ namespace Wombat
     {
         if (this != &rhs)
         {
-            mamaDateTime_copy (&mDateTime,
-                               const_cast<const mamaDateTime>(&rhs.mDateTime));
+            mamaDateTime_copy (mDateTime,
+                               const_cast<const mamaDateTime>(rhs.mDateTime));
         }
         return *this;
     }
@@ -78,45 +79,50 @@ namespace Wombat
     int MamaDateTime::compare (const MamaDateTime&  rhs) const
     {
         return mamaDateTime_compare (
-            const_cast<const mamaDateTime>(&mDateTime),
-            const_cast<const mamaDateTime>(&rhs.mDateTime));
+            const_cast<const mamaDateTime>(mDateTime),
+            const_cast<const mamaDateTime>(rhs.mDateTime));
     }
 
     void MamaDateTime::clear ()
     {
-        mamaDateTime_clear (&mDateTime);
+        mamaDateTime_clear (mDateTime);
     }
 
     void MamaDateTime::clearDate ()
     {
-        mamaDateTime_clearDate (&mDateTime);
+        mamaDateTime_clearDate (mDateTime);
     }
 
     void MamaDateTime::clearTime ()
     {
-        mamaDateTime_clearTime (&mDateTime);
+        mamaDateTime_clearTime (mDateTime);
     }
 
     void MamaDateTime::setEpochTimeF64 (double  seconds)
     {
-        mamaDateTime_setEpochTimeF64 (&mDateTime, seconds);
+        mamaDateTime_setEpochTimeF64 (mDateTime, seconds);
     }
 
     void MamaDateTime::setEpochTimeMilliseconds (mama_u64_t  milliseconds)
     {
-        mamaDateTime_setEpochTimeMilliseconds (&mDateTime, milliseconds);
+        mamaDateTime_setEpochTimeMilliseconds (mDateTime, milliseconds);
     }
 
     void MamaDateTime::setEpochTimeMicroseconds (mama_u64_t  microseconds)
     {
-        mamaDateTime_setEpochTimeMicroseconds (&mDateTime, microseconds);
+        mamaDateTime_setEpochTimeMicroseconds (mDateTime, microseconds);
+    }
+
+    void MamaDateTime::setEpochTimeNanoseconds (mama_u64_t  nanoseconds)
+    {
+        mamaDateTime_setEpochTimeNanoseconds (mDateTime, nanoseconds);
     }
 
     void MamaDateTime::setEpochTime (mama_u32_t             seconds,
                                      mama_u32_t             microseconds,
                                      mamaDateTimePrecision  precision)
     {
-        mamaDateTime_setEpochTime (&mDateTime, seconds, microseconds, precision);
+        mamaDateTime_setEpochTime (mDateTime, seconds, microseconds, precision);
     }
 
     void MamaDateTime::setWithHints (mama_u32_t             seconds,
@@ -124,13 +130,13 @@ namespace Wombat
                                      mamaDateTimePrecision  precision,
                                      mamaDateTimeHints      hints)
     {
-        mamaDateTime_setWithHints (&mDateTime, seconds, microseconds, precision,
+        mamaDateTime_setWithHints (mDateTime, seconds, microseconds, precision,
                                    hints);
     }
 
     void MamaDateTime::setPrecision (mamaDateTimePrecision  precision)
     {
-        mamaDateTime_setPrecision (&mDateTime, precision);
+        mamaDateTime_setPrecision (mDateTime, precision);
     }
 
     void MamaDateTime::setFromString (const char*           str,
@@ -138,11 +144,11 @@ namespace Wombat
     {
         if (tz)
         {
-            mamaDateTime_setFromStringWithTz (&mDateTime, str, tz->getCValue());
+            mamaDateTime_setFromStringWithTz (mDateTime, str, tz->getCValue());
         }
         else
         {
-            mamaDateTime_setFromString (&mDateTime, str);
+            mamaDateTime_setFromString (mDateTime, str);
         }
     }
 
@@ -152,23 +158,23 @@ namespace Wombat
     {
         if (tz)
         {
-            mamaDateTime_setFromStringBufferWithTz (&mDateTime, str, strLen,
+            mamaDateTime_setFromStringBufferWithTz (mDateTime, str, strLen,
                                                     tz->getCValue());
         }
         else
         {
-            mamaDateTime_setFromStringBuffer (&mDateTime, str, strLen);
+            mamaDateTime_setFromStringBuffer (mDateTime, str, strLen);
         }
     }
 
     void MamaDateTime::setToNow ()
     {
-        mamaDateTime_setToNow (&mDateTime);
+        mamaDateTime_setToNow (mDateTime);
     }
 
     void MamaDateTime::setToMidnightToday (const MamaTimeZone*  tz)
     {
-        mamaDateTime_setToMidnightToday (&mDateTime, 
+        mamaDateTime_setToMidnightToday (mDateTime, 
                                          tz == NULL ? NULL : tz->getCValue());
     }
 
@@ -185,13 +191,13 @@ namespace Wombat
         if (tz)
         {
             mamaDateTime_setWithPrecisionAndTz (
-                &mDateTime, year, month, day, hours, minutes, seconds,
+                mDateTime, year, month, day, hours, minutes, seconds,
                 microseconds, precision, tz->getCValue());
         }
         else
         {
             mamaDateTime_setWithPrecisionAndTz (
-                &mDateTime, year, month, day, hours, minutes, seconds,
+                mDateTime, year, month, day, hours, minutes, seconds,
                 microseconds, precision, NULL);
         }
     }
@@ -206,13 +212,13 @@ namespace Wombat
         if (tz)
         {
             mamaDateTime_setTimeWithPrecisionAndTz (
-                &mDateTime, hours, minutes, seconds, microseconds, precision,
+                mDateTime, hours, minutes, seconds, microseconds, precision,
                 tz->getCValue());
         }
         else
         {
             mamaDateTime_setTimeWithPrecisionAndTz (
-                &mDateTime, hours, minutes, seconds, microseconds, precision,
+                mDateTime, hours, minutes, seconds, microseconds, precision,
                 NULL);
         }
     }
@@ -221,41 +227,41 @@ namespace Wombat
                                 mama_u32_t   month,
                                 mama_u32_t   day)
     {
-        mamaDateTime_setDate (&mDateTime, year, month, day);
+        mamaDateTime_setDate (mDateTime, year, month, day);
     }
 
     void MamaDateTime::copyTime (const MamaDateTime&  copy)
     {
-        mamaDateTime_copyTime (&mDateTime,
-                               const_cast<const mamaDateTime>(&copy.mDateTime));
+        mamaDateTime_copyTime (mDateTime,
+                               const_cast<const mamaDateTime>(copy.mDateTime));
     }
 
     void MamaDateTime::copyDate (const MamaDateTime&  copy)
     {
-        mamaDateTime_copyDate (&mDateTime,
-                               const_cast<const mamaDateTime>(&copy.mDateTime));
+        mamaDateTime_copyDate (mDateTime,
+                               const_cast<const mamaDateTime>(copy.mDateTime));
     }
 
     void MamaDateTime::addSeconds (mama_f64_t  seconds)
     {
-        mamaDateTime_addSeconds (&mDateTime, seconds);
+        mamaDateTime_addSeconds (mDateTime, seconds);
     }
 
     void MamaDateTime::addSeconds (mama_i32_t  seconds)
     {
-        mamaDateTime_addWholeSeconds (&mDateTime, seconds);
+        mamaDateTime_addWholeSeconds (mDateTime, seconds);
     }
 
     void MamaDateTime::addMicroseconds (mama_i64_t  microseconds)
     {
-        mamaDateTime_addMicroseconds (&mDateTime, microseconds);
+        mamaDateTime_addMicroseconds (mDateTime, microseconds);
     }
 
     mama_u64_t MamaDateTime::getEpochTimeMicroseconds () const
     {
         mama_u64_t  result = 0;
         mamaDateTime_getEpochTimeMicroseconds (
-            const_cast<const mamaDateTime>(&mDateTime), &result);
+            const_cast<const mamaDateTime>(mDateTime), &result);
         return result;
     }
 
@@ -263,7 +269,23 @@ namespace Wombat
     {
         mama_u64_t  result = 0;
         mamaDateTime_getEpochTimeMicrosecondsWithTz (
-            const_cast<const mamaDateTime>(&mDateTime), &result, tz.getCValue());
+            const_cast<const mamaDateTime>(mDateTime), &result, tz.getCValue());
+        return result;
+    }
+
+    mama_u64_t MamaDateTime::getEpochTimeNanoseconds () const
+    {
+        mama_u64_t  result = 0;
+        mamaDateTime_getEpochTimeNanoseconds (
+            const_cast<const mamaDateTime>(mDateTime), &result);
+        return result;
+    }
+
+    mama_u64_t MamaDateTime::getEpochTimeNanoseconds (const MamaTimeZone& tz) const
+    {
+        mama_u64_t  result = 0;
+        mamaDateTime_getEpochTimeNanosecondsWithTz (
+            const_cast<const mamaDateTime>(mDateTime), &result, tz.getCValue());
         return result;
     }
 
@@ -271,7 +293,7 @@ namespace Wombat
     {
         mama_u64_t  result = 0;
         mamaDateTime_getEpochTimeMilliseconds (
-            const_cast<const mamaDateTime>(&mDateTime), &result);
+            const_cast<const mamaDateTime>(mDateTime), &result);
         return result;
     }
 
@@ -279,7 +301,7 @@ namespace Wombat
     {
         mama_u64_t  result = 0;
         mamaDateTime_getEpochTimeMillisecondsWithTz (
-            const_cast<const mamaDateTime>(&mDateTime), &result, tz.getCValue());
+            const_cast<const mamaDateTime>(mDateTime), &result, tz.getCValue());
         return result;
     }
 
@@ -287,7 +309,7 @@ namespace Wombat
     {
         mama_f64_t  result = 0;
         mamaDateTime_getEpochTimeSeconds (
-            const_cast<const mamaDateTime>(&mDateTime), &result);
+            const_cast<const mamaDateTime>(mDateTime), &result);
         return result;
     }
 
@@ -295,7 +317,7 @@ namespace Wombat
     {
         mama_f64_t  result = 0;
         mamaDateTime_getEpochTimeSecondsWithTz (
-            const_cast<const mamaDateTime>(&mDateTime), &result, tz.getCValue());
+            const_cast<const mamaDateTime>(mDateTime), &result, tz.getCValue());
         return result;
     }
 
@@ -303,54 +325,54 @@ namespace Wombat
     {
         mama_f64_t  result = 0;
         mamaDateTime_getEpochTimeSecondsWithCheck (
-            const_cast<const mamaDateTime>(&mDateTime), &result);
+            const_cast<const mamaDateTime>(mDateTime), &result);
         return result;
     }
 
     void MamaDateTime::getAsStructTimeVal (struct timeval&  result) const
     {
-        mamaDateTime_getStructTimeVal (const_cast<const mamaDateTime>(&mDateTime),
+        mamaDateTime_getStructTimeVal (const_cast<const mamaDateTime>(mDateTime),
                                        &result);
     }
 
     void MamaDateTime::getAsStructTimeVal (struct timeval&      result,
                                            const MamaTimeZone&  tz) const
     {
-        mamaDateTime_getStructTimeValWithTz (const_cast<const mamaDateTime>(&mDateTime),
+        mamaDateTime_getStructTimeValWithTz (const_cast<const mamaDateTime>(mDateTime),
                                              &result, tz.getCValue());
     }
 
     void MamaDateTime::getAsStructTm (struct tm&  result) const
     {
-        mamaDateTime_getStructTm (const_cast<const mamaDateTime>(&mDateTime),
+        mamaDateTime_getStructTm (const_cast<const mamaDateTime>(mDateTime),
                                   &result);
     }
 
     void MamaDateTime::getAsStructTm (struct tm&            result,
                                       const MamaTimeZone&  tz) const
     {
-        mamaDateTime_getStructTmWithTz (const_cast<const mamaDateTime>(&mDateTime),
+        mamaDateTime_getStructTmWithTz (const_cast<const mamaDateTime>(mDateTime),
                                         &result, tz.getCValue());
     }
 
     void MamaDateTime::getAsString (char*        result,
                                     mama_size_t  maxLen) const
     {
-        mamaDateTime_getAsString (const_cast<const mamaDateTime>(&mDateTime),
+        mamaDateTime_getAsString (const_cast<const mamaDateTime>(mDateTime),
                                   result, maxLen);
     }
 
     void MamaDateTime::getTimeAsString (char*        result,
                                         mama_size_t  maxLen) const
     {
-        mamaDateTime_getTimeAsString (const_cast<const mamaDateTime>(&mDateTime),
+        mamaDateTime_getTimeAsString (const_cast<const mamaDateTime>(mDateTime),
                                       result, maxLen);
     }
 
     void MamaDateTime::getDateAsString (char*        result,
                                         mama_size_t  maxLen) const
     {
-        mamaDateTime_getDateAsString (const_cast<const mamaDateTime>(&mDateTime),
+        mamaDateTime_getDateAsString (const_cast<const mamaDateTime>(mDateTime),
                                       result, maxLen);
     }
 
@@ -389,7 +411,7 @@ namespace Wombat
                                              const char*  format) const
     {
         mamaDateTime_getAsFormattedString (
-            const_cast<const mamaDateTime>(&mDateTime), result, maxLen, format);
+            const_cast<const mamaDateTime>(mDateTime), result, maxLen, format);
     }
 
     void MamaDateTime::getAsFormattedString (char*                result,
@@ -398,42 +420,42 @@ namespace Wombat
                                              const MamaTimeZone&  tz) const
     {
         mamaDateTime_getAsFormattedStringWithTz (
-            const_cast<const mamaDateTime>(&mDateTime),
+            const_cast<const mamaDateTime>(mDateTime),
             result, maxLen, format, tz.getCValue());
     }
 
     mama_u32_t MamaDateTime::getYear() const
     {
         mama_u32_t  result = 0;
-        mamaDateTime_getYear (const_cast<const mamaDateTime>(&mDateTime),&result);
+        mamaDateTime_getYear (const_cast<const mamaDateTime>(mDateTime),&result);
         return result;
     }
 
     mama_u32_t MamaDateTime::getMonth() const
     {
         mama_u32_t  result = 0;
-        mamaDateTime_getMonth(const_cast<const mamaDateTime>(&mDateTime), &result);
+        mamaDateTime_getMonth(const_cast<const mamaDateTime>(mDateTime), &result);
         return result;
     }
 
     mama_u32_t MamaDateTime::getDay() const
     {
         mama_u32_t  result = 0;
-        mamaDateTime_getDay (const_cast<const mamaDateTime>(&mDateTime), &result);
+        mamaDateTime_getDay (const_cast<const mamaDateTime>(mDateTime), &result);
         return result;
     }
 
     mama_u32_t MamaDateTime::getHour() const
     {
         mama_u32_t  result = 0;
-        mamaDateTime_getHour (const_cast<const mamaDateTime>(&mDateTime), &result);
+        mamaDateTime_getHour (const_cast<const mamaDateTime>(mDateTime), &result);
         return result;
     }
 
     mama_u32_t MamaDateTime::getMinute() const
     {
         mama_u32_t  result = 0;
-        mamaDateTime_getMinute (const_cast<const mamaDateTime>(&mDateTime),
+        mamaDateTime_getMinute (const_cast<const mamaDateTime>(mDateTime),
                                 &result);
         return result;
     }
@@ -441,7 +463,7 @@ namespace Wombat
     mama_u32_t MamaDateTime::getSecond() const
     {
         mama_u32_t  result = 0;
-        mamaDateTime_getSecond (const_cast<const mamaDateTime>(&mDateTime),
+        mamaDateTime_getSecond (const_cast<const mamaDateTime>(mDateTime),
                                 &result);
         return result;
     }
@@ -449,15 +471,23 @@ namespace Wombat
     mama_u32_t MamaDateTime::getMicrosecond() const
     {
         mama_u32_t  result = 0;
-        mamaDateTime_getMicrosecond (const_cast<const mamaDateTime>(&mDateTime),
+        mamaDateTime_getMicrosecond (const_cast<const mamaDateTime>(mDateTime),
                                      &result);
         return result;
     }
 
+    mama_u32_t MamaDateTime::getNanosecond() const
+    {
+        mama_u32_t  result = 0;
+        mamaDateTime_getNanosecond (const_cast<const mamaDateTime>(mDateTime),
+                                    &result);
+        return result;
+    }
+
     mamaDayOfWeek MamaDateTime::getDayOfWeek() const
     {
         mamaDayOfWeek  result = Sunday;
-        mamaDateTime_getDayOfWeek (const_cast<const mamaDateTime>(&mDateTime),
+        mamaDateTime_getDayOfWeek (const_cast<const mamaDateTime>(mDateTime),
                                    &result);
         return result;
     }
@@ -465,33 +495,33 @@ namespace Wombat
     bool MamaDateTime::operator== (const MamaDateTime& rhs) const
     {
         return (this == &rhs) ||
-            mamaDateTime_equal (const_cast<const mamaDateTime>(&mDateTime),
-                                const_cast<const mamaDateTime>(&rhs.mDateTime));
+            mamaDateTime_equal (const_cast<const mamaDateTime>(mDateTime),
+                                const_cast<const mamaDateTime>(rhs.mDateTime));
     }
 
     bool MamaDateTime::operator> (const MamaDateTime& rhs) const
     {
         return mamaDateTime_compare (
-            const_cast<const mamaDateTime>(&mDateTime),
-            const_cast<const mamaDateTime>(&rhs.mDateTime)) > 0;
+            const_cast<const mamaDateTime>(mDateTime),
+            const_cast<const mamaDateTime>(rhs.mDateTime)) > 0;
     }
 
     bool MamaDateTime::operator< (const MamaDateTime& rhs) const
     {
         return mamaDateTime_compare (
-            const_cast<const mamaDateTime>(&mDateTime),
-            const_cast<const mamaDateTime>(&rhs.mDateTime)) < 0;
+            const_cast<const mamaDateTime>(mDateTime),
+            const_cast<const mamaDateTime>(rhs.mDateTime)) < 0;
     }
 
     bool MamaDateTime::empty() const
     {
-        return mamaDateTime_empty (const_cast<const mamaDateTime>(&mDateTime));
+        return mamaDateTime_empty (const_cast<const mamaDateTime>(mDateTime));
     }
 
     bool MamaDateTime::hasTime() const
     {
         mama_bool_t  result = 0;
-        mamaDateTime_hasTime (const_cast<const mamaDateTime>(&mDateTime),
+        mamaDateTime_hasTime (const_cast<const mamaDateTime>(mDateTime),
                               &result);
         return (result);
     }
@@ -499,19 +529,19 @@ namespace Wombat
     bool MamaDateTime::hasDate() const
     {
         mama_bool_t  result = 0;
-        mamaDateTime_hasDate (const_cast<const mamaDateTime>(&mDateTime),
+        mamaDateTime_hasDate (const_cast<const mamaDateTime>(mDateTime),
                               &result);
         return (result);
     }
 
     mamaDateTime MamaDateTime::getCValue()
     {
-        return &mDateTime;
+        return mDateTime;
     }
 
     const mamaDateTime MamaDateTime::getCValue() const
     {
-        return const_cast<const mamaDateTime>(&mDateTime);
+        return const_cast<const mamaDateTime>(mDateTime);
     }
 
 } /* namespace  Wombat */
@@ -97,6 +97,8 @@ public:
                               mama_u64_t             millisecondsSinceEpoch);
     void          setEpochTimeMicroseconds (
                               mama_u64_t             microsecondsSinceEpoch);
+    void          setEpochTimeNanoseconds (
+                              mama_u64_t             nanosecondsSinceEpoch);
     void          setWithHints    (mama_u32_t             secondsSinceEpoch,
                                    mama_u32_t             microseconds,
                                    mamaDateTimePrecision  precision =
@@ -224,6 +226,22 @@ public:
 	 * @return The number of microseconds since the Epoch.
 	 */
     mama_u64_t    getEpochTimeMicroseconds (const MamaTimeZone&  tz) const;
+
+	/**
+	 * Get the date and time as nanoseconds since the Epoch, (using the UTC timezone).
+	 *
+	 * @return The number of nanoseconds since the Epoch.
+	 */
+    mama_u64_t    getEpochTimeNanoseconds () const;
+
+	/**
+	 * Get the date and time as nanoseconds since the Epoch in the supplied
+	 * time zone.
+	 *
+	 * @param[int] tz The timezone.
+	 * @return The number of nanoseconds since the Epoch.
+	 */
+    mama_u64_t    getEpochTimeNanoseconds (const MamaTimeZone&  tz) const;
     
     mama_u64_t    getEpochTimeMilliseconds () const;
     mama_u64_t    getEpochTimeMilliseconds (const MamaTimeZone&  tz) const;
@@ -282,6 +300,7 @@ public:
     mama_u32_t    getMinute      () const;
     mama_u32_t    getSecond      () const;
     mama_u32_t    getMicrosecond () const;
+    mama_u32_t    getNanosecond  () const;
     mamaDayOfWeek getDayOfWeek   () const;
 
     /**
@@ -298,8 +317,11 @@ public:
     const mamaDateTime  getCValue() const;
 
 private:
-    mama_u64_t      mDateTime;
-    mutable char*   mStrRep;
+    // Held inline rather than allocated, with room for nanoseconds.
+    // mDateTime always points at mStorage.
+    mamaDateTimeStorage mStorage;
+    mamaDateTime        mDateTime;
+    mutable char*       mStrRep;
 };
 
 } // namespace Wombat
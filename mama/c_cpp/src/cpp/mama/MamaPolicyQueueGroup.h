@@ -0,0 +1,147 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#ifndef MAMA_POLICY_QUEUE_GROUP_CPP_H__
+#define MAMA_POLICY_QUEUE_GROUP_CPP_H__
+
+namespace Wombat
+{
+
+    class MamaQueue;
+    struct MamaPolicyQueueGroupImpl;
+
+    /**
+     * A group of queues, each with its own dispatcher, which hands queues out
+     * according to a selection policy. Unlike MamaQueueGroup, which always
+     * hands queues out in a round robin, this group can take the load on each
+     * queue or the symbol being subscribed to into account.
+     */
+    class MAMACPPExpDLL MamaPolicyQueueGroup
+    {
+    public:
+        /**
+         * The policy used by getNextQueue to choose a queue.
+         */
+        enum SelectionPolicy
+        {
+            /** Hand out queues in turn, regardless of load. */
+            POLICY_ROUND_ROBIN,
+
+            /** Choose the queue with the fewest pending events, breaking
+             *  ties on the number of times each queue was handed out. */
+            POLICY_LEAST_LOADED,
+
+            /** Map each symbol to a fixed queue using a consistent hash, so
+             *  all updates for a symbol are dispatched in order on one queue
+             *  without any shared state. */
+            POLICY_SYMBOL_HASH,
+
+            /** Place each new symbol on the least loaded queue and keep it
+             *  there until rebalance() releases it. */
+            POLICY_SYMBOL_AFFINE
+        };
+
+        virtual ~MamaPolicyQueueGroup ();
+
+        /**
+         * If numberOfQueues == 0, getNextQueue returns the default queue for
+         * the bridge.
+         */
+        MamaPolicyQueueGroup (
+            int              numberOfQueues,
+            mamaBridge       bridgeImpl,
+            SelectionPolicy  policy);
+
+        /**
+         * Destroy all the queues. This blocks until all of the objects created
+         * on the queues have been destroyed, see MamaQueueGroup::destroyWait.
+         */
+        virtual void destroyWait ();
+
+        /**
+         * Return the next queue according to the policy. The symbol policies
+         * have no symbol to go on here and fall back to the least loaded
+         * queue.
+         */
+        virtual MamaQueue* getNextQueue ();
+
+        /**
+         * Return the queue to use for a subscription to the given symbol.
+         * With POLICY_SYMBOL_HASH and POLICY_SYMBOL_AFFINE the same symbol
+         * always returns the same queue, which preserves per-symbol ordering
+         * across subscriptions. Other policies ignore the symbol.
+         */
+        virtual MamaQueue* getNextQueue (const char* symbol);
+
+        /**
+         * Release the symbol placements held on queues whose backlog is more
+         * than twice the group average. Existing subscriptions are not
+         * moved; a subscription for a released symbol that is destroyed and
+         * created again is placed on the least loaded queue. Destroying the
+         * old subscription first is the safe point that keeps the symbol's
+         * updates in order. Only meaningful with POLICY_SYMBOL_AFFINE.
+         */
+        virtual void rebalance ();
+
+        /**
+         * Return the policy used by this queue group.
+         */
+        virtual SelectionPolicy getSelectionPolicy ();
+
+        /**
+         * Return the number of MamaQueues currently managed by this group.
+         */
+        virtual int getNumberOfQueues ();
+
+        /**
+         * Stop dispatching on queues in the group.
+         */
+        virtual void stopDispatch ();
+
+        /**
+         * Start dispatching on all queues in the group after a previous call
+         * to stopDispatch.
+         */
+        virtual void startDispatch ();
+
+        /**
+         * Return the index of the queue POLICY_SYMBOL_HASH uses for the
+         * symbol in a group of numberOfQueues queues. Growing a group from n
+         * to n + 1 queues only moves 1 / (n + 1) of the symbols.
+         */
+        static int getSymbolQueueIndex (
+            const char*  symbol,
+            int          numberOfQueues);
+
+    private:
+        MamaPolicyQueueGroupImpl* mImpl;
+
+        MamaPolicyQueueGroup (
+            const MamaPolicyQueueGroup&);
+
+        MamaPolicyQueueGroup& operator= (
+            const MamaPolicyQueueGroup&);
+    };
+
+} /* namespace Wombat */
+
+#endif // MAMA_POLICY_QUEUE_GROUP_CPP_H__
@@ -89,6 +89,10 @@ namespace Wombat
          * negative, depending upon the direction. */
         mama_i32_t offset () const;
 
+        /** Return the offset from UTC (in seconds) in effect at a time
+         * given in seconds since the Epoch (UTC). */
+        mama_i32_t offsetAt (mama_i64_t utcSeconds) const;
+
         /** Check (recalculate) the UTC offset in case it has changed due
          * to daylight savings adjustments. */
         void check();
@@ -29,6 +29,7 @@
 #include <mama/MamaBridgeCallback.h>
 #include <mama/MamaMsg.h>
 #include <mama/MamaQueueGroup.h>
+#include <mama/MamaPolicyQueueGroup.h>
 #include <mama/MamaBasicSubscription.h>
 #include <mama/MamaBasicSubscriptionCallback.h>
 #include <mama/MamaBasicWildCardSubscription.h>
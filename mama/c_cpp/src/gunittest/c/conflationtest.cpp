@@ -0,0 +1,342 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "MainUnitTestC.h"
+#include "mama/mama.h"
+#include "mama/conflation/manager.h"
+#include "mama/reservedfields.h"
+#include "conflation/manager_int.h"
+#include "wombat/wincompat.h"
+
+class MamaConflationTestC : public ::testing::Test
+{
+protected:
+    MamaConflationTestC();
+    virtual ~MamaConflationTestC();
+
+    virtual void SetUp();
+    virtual void TearDown ();
+
+    /* Create an update with a single U32 field, owned by the fixture */
+    mamaMsg createMsg (mama_fid_t  fid,
+                       mama_u32_t  value,
+                       mamaMsgType type = MAMA_MSG_TYPE_UPDATE);
+
+    mamaBridge              mBridge;
+    mamaConflationManager   mMgr;
+    std::vector<mamaMsg>    mMsgs;
+};
+
+MamaConflationTestC::MamaConflationTestC()
+    : mBridge (NULL)
+    , mMgr    (NULL)
+{
+    mama_loadBridge (&mBridge, getMiddleware ());
+    mama_open ();
+}
+
+MamaConflationTestC::~MamaConflationTestC()
+{
+    mama_close ();
+}
+
+void MamaConflationTestC::SetUp(void)
+{
+    ASSERT_EQ (MAMA_STATUS_OK, mamaConflationManager_allocate (&mMgr));
+    ASSERT_EQ (MAMA_STATUS_OK, mamaConflationManager_create (mMgr));
+}
+
+void MamaConflationTestC::TearDown(void)
+{
+    mamaConflationManager_destroy (mMgr);
+
+    /* Conflated messages are left with the caller, so the fixture owns
+     * every message whether or not it was queued. */
+    for (size_t i = 0; i < mMsgs.size (); ++i)
+    {
+        mamaMsg_destroy (mMsgs[i]);
+    }
+    mMsgs.clear ();
+}
+
+mamaMsg MamaConflationTestC::createMsg (mama_fid_t  fid,
+                                        mama_u32_t  value,
+                                        mamaMsgType type)
+{
+    mamaMsg msg = NULL;
+
+    mamaMsg_create (&msg);
+    mamaMsg_addI32 (msg, MamaFieldMsgType.mName, MamaFieldMsgType.mFid, type);
+    mamaMsg_addU32 (msg, NULL, fid, value);
+    mMsgs.push_back (msg);
+
+    return msg;
+}
+
+static mama_u32_t getField (mamaMsg msg, mama_fid_t fid)
+{
+    mama_u32_t value = 0;
+
+    if (MAMA_STATUS_OK != mamaMsg_getU32 (msg, NULL, fid, &value))
+        return 0;
+    return value;
+}
+
+/* Applications can only enqueue once the manager is installed. */
+TEST_F (MamaConflationTestC, EnqueueRequiresInstall)
+{
+    ASSERT_EQ (MAMA_STATUS_NOT_INSTALLED,
+               mamaConflationManager_enqueue (mMgr, createMsg (101, 1), "A"));
+}
+
+/* Without a policy every message is queued in order. */
+TEST_F (MamaConflationTestC, NoPolicyQueuesEveryMessage)
+{
+    mamaMsg     msg   = NULL;
+    const char* topic = NULL;
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaConflationManagerImpl_enqueue (mMgr,
+                                                  createMsg (101, 1), "A"));
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaConflationManagerImpl_enqueue (mMgr,
+                                                  createMsg (101, 2), "A"));
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaConflationManager_poll (mMgr, &msg, &topic));
+    ASSERT_EQ ((mama_u32_t)1, getField (msg, 101));
+    ASSERT_EQ (MAMA_STATUS_OK, mamaConflationManager_poll (mMgr, &msg, &topic));
+    ASSERT_EQ ((mama_u32_t)2, getField (msg, 101));
+    ASSERT_EQ (MAMA_STATUS_OK, mamaConflationManager_poll (mMgr, &msg, &topic));
+    ASSERT_TRUE (NULL == msg);
+}
+
+/* The last value replaces the queued message but keeps its place. */
+TEST_F (MamaConflationTestC, LastValueReplacesQueuedMessage)
+{
+    mamaMsg     msg   = NULL;
+    const char* topic = NULL;
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaConflationManager_setPolicy (
+                   mMgr, MAMA_CONFLATION_POLICY_LAST_VALUE));
+
+    mamaConflationManagerImpl_enqueue (mMgr, createMsg (101, 1), "A");
+    mamaConflationManagerImpl_enqueue (mMgr, createMsg (101, 1), "B");
+    mamaConflationManagerImpl_enqueue (mMgr, createMsg (102, 2), "A");
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaConflationManager_poll (mMgr, &msg, &topic));
+    ASSERT_STREQ ("A", topic);
+    ASSERT_EQ ((mama_u32_t)0, getField (msg, 101));
+    ASSERT_EQ ((mama_u32_t)2, getField (msg, 102));
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaConflationManager_poll (mMgr, &msg, &topic));
+    ASSERT_STREQ ("B", topic);
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaConflationManager_poll (mMgr, &msg, &topic));
+    ASSERT_TRUE (NULL == msg);
+}
+
+/* Merge keeps the fields of every update. */
+TEST_F (MamaConflationTestC, MergeFoldsFields)
+{
+    mamaMsg     msg   = NULL;
+    const char* topic = NULL;
+
+    mamaConflationManager_setPolicy (mMgr, MAMA_CONFLATION_POLICY_MERGE);
+
+    mamaConflationManagerImpl_enqueue (mMgr, createMsg (101, 1), "A");
+    mamaConflationManagerImpl_enqueue (mMgr, createMsg (102, 2), "A");
+    mamaConflationManagerImpl_enqueue (mMgr, createMsg (101, 3), "A");
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaConflationManager_poll (mMgr, &msg, &topic));
+    ASSERT_EQ ((mama_u32_t)3, getField (msg, 101));
+    ASSERT_EQ ((mama_u32_t)2, getField (msg, 102));
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaConflationManager_poll (mMgr, &msg, &topic));
+    ASSERT_TRUE (NULL == msg);
+}
+
+/* The merged update stands for every update folded into it. */
+TEST_F (MamaConflationTestC, MergeCountsConflatedUpdates)
+{
+    mamaMsg     msg   = NULL;
+    const char* topic = NULL;
+    mama_u16_t  count = 0;
+
+    mamaConflationManager_setPolicy (mMgr, MAMA_CONFLATION_POLICY_MERGE);
+
+    mamaConflationManagerImpl_enqueue (mMgr, createMsg (101, 1), "A");
+    mamaConflationManagerImpl_enqueue (mMgr, createMsg (101, 2), "A");
+    mamaConflationManagerImpl_enqueue (mMgr, createMsg (101, 3), "A");
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaConflationManager_poll (mMgr, &msg, &topic));
+    ASSERT_EQ ((mama_u32_t)3, getField (msg, 101));
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaMsg_getU16 (msg, MamaFieldConflateCount.mName,
+                               MamaFieldConflateCount.mFid, &count));
+    ASSERT_EQ ((mama_u16_t)3, count);
+}
+
+/* Anything but an update is delivered as it is, behind the pending update,
+ * and later updates start a new message. */
+TEST_F (MamaConflationTestC, NonUpdateIsNotConflated)
+{
+    mamaMsg     msg   = NULL;
+    mamaMsg     first = createMsg (101, 1);
+    mamaMsg     recap = createMsg (101, 2, MAMA_MSG_TYPE_RECAP);
+    const char* topic = NULL;
+
+    mamaConflationManager_setPolicy (mMgr, MAMA_CONFLATION_POLICY_MERGE);
+
+    mamaConflationManagerImpl_enqueue (mMgr, first, "A");
+    mamaConflationManagerImpl_enqueue (mMgr, recap, "A");
+    mamaConflationManagerImpl_enqueue (mMgr, createMsg (101, 3), "A");
+    mamaConflationManagerImpl_enqueue (mMgr, createMsg (101, 4), "A");
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaConflationManager_poll (mMgr, &msg, &topic));
+    ASSERT_EQ (first, msg);
+    ASSERT_EQ ((mama_u32_t)1, getField (msg, 101));
+    ASSERT_EQ (MAMA_STATUS_OK, mamaConflationManager_poll (mMgr, &msg, &topic));
+    ASSERT_EQ (recap, msg);
+    ASSERT_EQ ((mama_u32_t)2, getField (msg, 101));
+    ASSERT_EQ (MAMA_STATUS_OK, mamaConflationManager_poll (mMgr, &msg, &topic));
+    ASSERT_EQ ((mama_u32_t)4, getField (msg, 101));
+    ASSERT_EQ (MAMA_STATUS_OK, mamaConflationManager_poll (mMgr, &msg, &topic));
+    ASSERT_TRUE (NULL == msg);
+}
+
+/* A message which has been handed out never absorbs later updates. */
+TEST_F (MamaConflationTestC, DequeuedMessageIsNotUpdated)
+{
+    mamaMsg     msg   = NULL;
+    const char* topic = NULL;
+
+    mamaConflationManager_setPolicy (mMgr, MAMA_CONFLATION_POLICY_MERGE);
+
+    mamaConflationManagerImpl_enqueue (mMgr, createMsg (101, 1), "A");
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaConflationManager_dequeue (mMgr, &msg, &topic));
+
+    mamaConflationManagerImpl_enqueue (mMgr, createMsg (101, 2), "A");
+    ASSERT_EQ ((mama_u32_t)1, getField (msg, 101));
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaConflationManager_dequeue (mMgr, &msg, &topic));
+    ASSERT_EQ ((mama_u32_t)2, getField (msg, 101));
+}
+
+/* Changing the policy stops queued messages absorbing updates. */
+TEST_F (MamaConflationTestC, PolicyChangeClearsPending)
+{
+    mamaMsg              msg    = NULL;
+    mamaMsg              first  = createMsg (101, 1);
+    const char*          topic  = NULL;
+    mamaConflationPolicy policy = MAMA_CONFLATION_POLICY_NONE;
+
+    mamaConflationManager_setPolicy (mMgr, MAMA_CONFLATION_POLICY_MERGE);
+    mamaConflationManagerImpl_enqueue (mMgr, first, "A");
+
+    mamaConflationManager_setPolicy (mMgr, MAMA_CONFLATION_POLICY_NONE);
+    ASSERT_EQ (MAMA_STATUS_OK, mamaConflationManager_getPolicy (mMgr, &policy));
+    ASSERT_EQ (MAMA_CONFLATION_POLICY_NONE, policy);
+    mamaConflationManagerImpl_enqueue (mMgr, createMsg (101, 2), "A");
+
+    /* Back to merging: the first message was cleared, so nothing is folded
+     * into it even though it is still queued. */
+    mamaConflationManager_setPolicy (mMgr, MAMA_CONFLATION_POLICY_MERGE);
+    mamaConflationManagerImpl_enqueue (mMgr, createMsg (101, 3), "A");
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaConflationManager_poll (mMgr, &msg, &topic));
+    ASSERT_EQ (first, msg);
+    ASSERT_EQ ((mama_u32_t)1, getField (msg, 101));
+    ASSERT_EQ (MAMA_STATUS_OK, mamaConflationManager_poll (mMgr, &msg, &topic));
+    ASSERT_EQ ((mama_u32_t)2, getField (msg, 101));
+    ASSERT_EQ (MAMA_STATUS_OK, mamaConflationManager_poll (mMgr, &msg, &topic));
+    ASSERT_EQ ((mama_u32_t)3, getField (msg, 101));
+}
+
+struct ConflationProducer
+{
+    mamaConflationManager   mMgr;
+    std::vector<mamaMsg>    mMsgs;
+};
+
+static void* produceUpdates (void* closure)
+{
+    ConflationProducer* producer = (ConflationProducer*) closure;
+
+    for (size_t i = 0; i < producer->mMsgs.size (); ++i)
+    {
+        mamaConflationManagerImpl_enqueue (producer->mMgr,
+                                           producer->mMsgs[i],
+                                           i % 2 ? "A" : "B");
+    }
+    return NULL;
+}
+
+/* Dequeue races a producer; each message handed out keeps the value it had
+ * when it was dequeued, and values for a topic never go backwards. */
+TEST_F (MamaConflationTestC, DequeueRacesProducer)
+{
+    const mama_u32_t   updates = 20000;
+    ConflationProducer producer;
+    wthread_t          thread;
+    mama_u32_t         last[2] = { 0, 0 };
+    struct wtimespec   pause   = { 0, 1000 };
+
+    mamaConflationManager_setPolicy (mMgr, MAMA_CONFLATION_POLICY_LAST_VALUE);
+
+    producer.mMgr     = mMgr;
+    for (mama_u32_t i = 1; i <= updates; ++i)
+    {
+        producer.mMsgs.push_back (createMsg (101, i));
+    }
+
+    ASSERT_EQ (0, wthread_create (&thread, NULL, produceUpdates, &producer));
+
+    for (;;)
+    {
+        mamaMsg     msg   = NULL;
+        const char* topic = NULL;
+        mama_u32_t  value = 0;
+        int         side  = 0;
+
+        ASSERT_EQ (MAMA_STATUS_OK,
+                   mamaConflationManager_dequeue (mMgr, &msg, &topic));
+
+        value = getField (msg, 101);
+        side  = 'A' == topic[0] ? 0 : 1;
+        ASSERT_GT (value, last[side]);
+        last[side] = value;
+
+        /* Let the producer run, then check nothing was folded in */
+        wnanosleep (&pause, NULL);
+        ASSERT_EQ (value, getField (msg, 101));
+
+        /* The last update for each topic is always delivered */
+        if (last[0] == updates && last[1] == updates - 1)
+            break;
+    }
+
+    wthread_join (thread, NULL);
+}
@@ -0,0 +1,157 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+
+#include <gtest/gtest.h>
+#include "MainUnitTestC.h"
+#include "mama/mama.h"
+#include "mama/latency.h"
+
+class MamaLatencyTestC : public ::testing::Test
+{
+protected:
+    MamaLatencyTestC();
+    virtual ~MamaLatencyTestC();
+
+    virtual void SetUp();
+    virtual void TearDown ();
+
+    mamaLatencyHistogram mHistogram;
+};
+
+MamaLatencyTestC::MamaLatencyTestC()
+    : mHistogram (NULL)
+{
+}
+
+MamaLatencyTestC::~MamaLatencyTestC()
+{
+}
+
+void MamaLatencyTestC::SetUp(void)
+{
+    ASSERT_EQ (MAMA_STATUS_OK, mamaLatencyHistogram_create (&mHistogram));
+}
+
+void MamaLatencyTestC::TearDown(void)
+{
+    mamaLatencyHistogram_destroy (mHistogram);
+}
+
+TEST_F (MamaLatencyTestC, EmptyHistogram)
+{
+    mama_u64_t count = 1;
+    mama_u64_t value = 1;
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaLatencyHistogram_getCount (mHistogram, &count));
+    EXPECT_EQ (0u, count);
+    ASSERT_EQ (MAMA_STATUS_OK, mamaLatencyHistogram_getPercentile (mHistogram, 99.0, &value));
+    EXPECT_EQ (0u, value);
+}
+
+TEST_F (MamaLatencyTestC, SmallValuesAreExact)
+{
+    mama_u64_t value = 0;
+
+    for (mama_u64_t i = 1; i <= 50; i++)
+        mamaLatencyHistogram_record (mHistogram, i);
+
+    mamaLatencyHistogram_getPercentile (mHistogram, 50.0, &value);
+    EXPECT_EQ (25u, value);
+    mamaLatencyHistogram_getPercentile (mHistogram, 100.0, &value);
+    EXPECT_EQ (50u, value);
+}
+
+TEST_F (MamaLatencyTestC, PercentilesWithinPrecision)
+{
+    mama_u64_t value = 0;
+    mama_u64_t max   = 0;
+    mama_f64_t mean  = 0.0;
+
+    /* 1us to 10ms */
+    for (mama_u64_t i = 1; i <= 10000; i++)
+        mamaLatencyHistogram_record (mHistogram, i * 1000);
+
+    mamaLatencyHistogram_getPercentile (mHistogram, 50.0, &value);
+    EXPECT_NEAR (5000000.0, (double)value, 5000000.0 / 32);
+
+    mamaLatencyHistogram_getPercentile (mHistogram, 99.9, &value);
+    EXPECT_NEAR (9990000.0, (double)value, 9990000.0 / 32);
+
+    mamaLatencyHistogram_getMax (mHistogram, &max);
+    EXPECT_EQ (10000000u, max);
+
+    mamaLatencyHistogram_getMean (mHistogram, &mean);
+    EXPECT_DOUBLE_EQ (5000500.0, mean);
+}
+
+TEST_F (MamaLatencyTestC, HugeValuesClampToMax)
+{
+    mama_u64_t value = 0;
+
+    mamaLatencyHistogram_record (mHistogram, 1);
+    mamaLatencyHistogram_record (mHistogram, (mama_u64_t)1 << 62);
+
+    mamaLatencyHistogram_getPercentile (mHistogram, 100.0, &value);
+    EXPECT_EQ ((mama_u64_t)1 << 62, value);
+}
+
+TEST_F (MamaLatencyTestC, MergeAndReset)
+{
+    mamaLatencyHistogram other = NULL;
+    mama_u64_t           count = 0;
+    mama_u64_t           max   = 0;
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaLatencyHistogram_create (&other));
+    mamaLatencyHistogram_record (mHistogram, 100);
+    mamaLatencyHistogram_record (other, 200);
+    mamaLatencyHistogram_record (other, 300);
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaLatencyHistogram_merge (mHistogram, other));
+    mamaLatencyHistogram_getCount (mHistogram, &count);
+    mamaLatencyHistogram_getMax (mHistogram, &max);
+    EXPECT_EQ (3u, count);
+    EXPECT_EQ (300u, max);
+
+    mamaLatencyHistogram_reset (mHistogram);
+    mamaLatencyHistogram_getCount (mHistogram, &count);
+    EXPECT_EQ (0u, count);
+
+    mamaLatencyHistogram_destroy (other);
+}
+
+TEST_F (MamaLatencyTestC, InvalidArguments)
+{
+    mama_u64_t value = 0;
+
+    EXPECT_EQ (MAMA_STATUS_NULL_ARG, mamaLatencyHistogram_record (NULL, 1));
+    EXPECT_EQ (MAMA_STATUS_INVALID_ARG,
+               mamaLatencyHistogram_getPercentile (mHistogram, 101.0, &value));
+}
+
+TEST_F (MamaLatencyTestC, TimestampIsMonotonic)
+{
+    mama_u64_t first  = mamaLatency_getTimestamp ();
+    mama_u64_t second = mamaLatency_getTimestamp ();
+
+    EXPECT_LE (first, second);
+}
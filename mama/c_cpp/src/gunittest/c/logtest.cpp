@@ -0,0 +1,222 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#include <gtest/gtest.h>
+#include "MainUnitTestC.h"
+#include "mama/mama.h"
+#include "mama/log.h"
+#include "wombat/wincompat.h"
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+
+class MamaLogAsyncTestC : public ::testing::Test
+{
+protected:
+    MamaLogAsyncTestC();
+    virtual ~MamaLogAsyncTestC();
+
+    virtual void SetUp();
+    virtual void TearDown ();
+
+    /* Number of lines containing the given text. */
+    int countLines (const char* text);
+
+    /* Number of times the text appears, synchronous writes from other
+     * threads may share a line. */
+    int countMessages (const char* text);
+
+    FILE*        mFile;
+    MamaLogLevel mLevel;
+};
+
+MamaLogAsyncTestC::MamaLogAsyncTestC()
+    : mFile  (NULL)
+    , mLevel (MAMA_LOG_LEVEL_WARN)
+{
+}
+
+MamaLogAsyncTestC::~MamaLogAsyncTestC()
+{
+}
+
+void MamaLogAsyncTestC::SetUp(void)
+{
+    mLevel = mama_getLogLevel ();
+    mFile  = tmpfile ();
+    ASSERT_TRUE (mFile != NULL);
+    mama_enableLogging (mFile, MAMA_LOG_LEVEL_NORMAL);
+}
+
+void MamaLogAsyncTestC::TearDown(void)
+{
+    mama_logDisableAsync ();
+    mama_enableLogging (NULL, mLevel);
+    fclose (mFile);
+}
+
+int MamaLogAsyncTestC::countLines (const char* text)
+{
+    char line[1024];
+    int  count = 0;
+
+    rewind (mFile);
+    while (fgets (line, sizeof (line), mFile))
+    {
+        if (strstr (line, text))
+            ++count;
+    }
+    return count;
+}
+
+int MamaLogAsyncTestC::countMessages (const char* text)
+{
+    char        line[1024];
+    const char* found;
+    int         count = 0;
+
+    rewind (mFile);
+    while (fgets (line, sizeof (line), mFile))
+    {
+        for (found = strstr (line, text); found; found = strstr (found + 1, text))
+            ++count;
+    }
+    return count;
+}
+
+/* Messages queued before disabling are written by the time it returns. */
+TEST_F (MamaLogAsyncTestC, WritesQueuedMessages)
+{
+    mama_u64_t writtenBefore = 0;
+    mama_u64_t droppedBefore = 0;
+    mama_u64_t written       = 0;
+    mama_u64_t dropped       = 0;
+    int        i;
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mama_logGetAsyncStats (&writtenBefore, &droppedBefore));
+    ASSERT_EQ (MAMA_STATUS_OK, mama_logEnableAsync (64));
+    ASSERT_TRUE (mama_logIsAsync ());
+
+    for (i = 0; i < 10; ++i)
+    {
+        mama_log (MAMA_LOG_LEVEL_NORMAL, "async message %d", i);
+    }
+    mama_log (MAMA_LOG_LEVEL_FINE, "async filtered");
+
+    ASSERT_EQ (MAMA_STATUS_OK, mama_logDisableAsync ());
+    ASSERT_FALSE (mama_logIsAsync ());
+
+    ASSERT_EQ (MAMA_STATUS_OK, mama_logGetAsyncStats (&written, &dropped));
+    EXPECT_EQ (10u, (written - writtenBefore) + (dropped - droppedBefore));
+    EXPECT_EQ ((int)(written - writtenBefore), countLines ("async message"));
+    EXPECT_EQ (0, countLines ("async filtered"));
+}
+
+/* A full ring drops messages instead of blocking, and every message is
+ * accounted for. */
+TEST_F (MamaLogAsyncTestC, CountsDroppedMessages)
+{
+    mama_u64_t writtenBefore = 0;
+    mama_u64_t droppedBefore = 0;
+    mama_u64_t written       = 0;
+    mama_u64_t dropped       = 0;
+    int        i;
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mama_logGetAsyncStats (&writtenBefore, &droppedBefore));
+    ASSERT_EQ (MAMA_STATUS_OK, mama_logEnableAsync (4));
+
+    for (i = 0; i < 1000; ++i)
+    {
+        mama_log (MAMA_LOG_LEVEL_NORMAL, "burst message %d", i);
+    }
+
+    ASSERT_EQ (MAMA_STATUS_OK, mama_logDisableAsync ());
+    ASSERT_EQ (MAMA_STATUS_OK, mama_logGetAsyncStats (&written, &dropped));
+
+    EXPECT_EQ (1000u, (written - writtenBefore) + (dropped - droppedBefore));
+    EXPECT_EQ ((int)(written - writtenBefore), countLines ("burst message"));
+}
+
+static const int RACE_THREADS  = 4;
+static const int RACE_MESSAGES = 2000;
+
+static void* logRaceMessages (void* closure)
+{
+    int i;
+
+    for (i = 0; i < RACE_MESSAGES; ++i)
+    {
+        mama_log (MAMA_LOG_LEVEL_NORMAL, "race message %d", i);
+    }
+    return NULL;
+}
+
+/* Switching async logging off while other threads are logging loses
+ * nothing: each message is either written, or counted as dropped. */
+TEST_F (MamaLogAsyncTestC, DisableWhileLogging)
+{
+    wthread_t  threads[RACE_THREADS];
+    mama_u64_t writtenBefore = 0;
+    mama_u64_t droppedBefore = 0;
+    mama_u64_t written       = 0;
+    mama_u64_t dropped       = 0;
+    int        i;
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mama_logGetAsyncStats (&writtenBefore, &droppedBefore));
+    ASSERT_EQ (MAMA_STATUS_OK, mama_logEnableAsync (64));
+
+    for (i = 0; i < RACE_THREADS; ++i)
+    {
+        ASSERT_EQ (0, wthread_create (&threads[i], NULL, logRaceMessages, NULL));
+    }
+
+    ASSERT_EQ (MAMA_STATUS_OK, mama_logDisableAsync ());
+
+    for (i = 0; i < RACE_THREADS; ++i)
+    {
+        wthread_join (threads[i], NULL);
+    }
+
+    ASSERT_EQ (MAMA_STATUS_OK, mama_logGetAsyncStats (&written, &dropped));
+    EXPECT_EQ (RACE_THREADS * RACE_MESSAGES,
+               countMessages ("race message") + (int)(dropped - droppedBefore));
+}
+
+TEST_F (MamaLogAsyncTestC, SynchronousAfterDisable)
+{
+    ASSERT_EQ (MAMA_STATUS_OK, mama_logEnableAsync (0));
+    ASSERT_EQ (MAMA_STATUS_OK, mama_logDisableAsync ());
+
+    mama_log (MAMA_LOG_LEVEL_NORMAL, "sync message");
+    EXPECT_EQ (1, countLines ("sync message"));
+}
+
+TEST_F (MamaLogAsyncTestC, StatsNullArgs)
+{
+    mama_u64_t value = 0;
+
+    EXPECT_EQ (MAMA_STATUS_NULL_ARG, mama_logGetAsyncStats (NULL, &value));
+    EXPECT_EQ (MAMA_STATUS_NULL_ARG, mama_logGetAsyncStats (&value, NULL));
+}
@@ -365,7 +365,7 @@ TEST_F (MamaDateTimeTestC, TestSetToNow)
 TEST_F (MamaDateTimeTestC, TestSetToMidnightToday)
 {
     mamaDateTime t, nullTime = NULL;
-    mamaTimeZone z, nullTimeZone = NULL;
+    mamaTimeZone z = mamaTimeZone_utc(), nullTimeZone = NULL;
 
     EXPECT_EQ ( MAMA_STATUS_OK, mamaDateTime_create(&t) );
 
@@ -1476,3 +1476,196 @@ TEST_F (MamaDateTimeTestC, CompareDates)
     /* These must be the same */
     ASSERT_EQ (completeDateSeconds, timeSeconds);
 }
+
+/*  Description:     Set a date time from nanoseconds since the epoch and read
+ *                   it back, check the string shows all nine digits and that
+ *                   the microsecond accessors are unchanged.
+ *
+ *  Expected Result: The nanoseconds round trip.
+ */
+TEST_F (MamaDateTimeTestC, NanosecondRoundTrip)
+{
+    mamaDateTime t1            = NULL;
+    mama_u64_t   nanos         = 1372932201123456789ULL;
+    mama_u64_t   result        = 0;
+    mama_u32_t   nanosecond    = 0;
+    mama_u32_t   microsecond   = 0;
+    char         buf[56];
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaDateTime_create (&t1));
+    ASSERT_EQ (MAMA_STATUS_OK, mamaDateTime_setEpochTimeNanoseconds (t1, nanos));
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaDateTime_getEpochTimeNanoseconds (t1, &result));
+    EXPECT_EQ (nanos, result);
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaDateTime_getNanosecond (t1, &nanosecond));
+    EXPECT_EQ (123456789U, nanosecond);
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaDateTime_getMicrosecond (t1, &microsecond));
+    EXPECT_EQ (123456U, microsecond);
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaDateTime_getEpochTimeMicroseconds (t1, &result));
+    EXPECT_EQ (nanos / 1000, result);
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaDateTime_getAsString (t1, buf, sizeof (buf)));
+    EXPECT_STREQ ("2013-07-04 10:03:21.123456789", buf);
+
+    /* Setting microseconds drops the extra digits */
+    ASSERT_EQ (MAMA_STATUS_OK, mamaDateTime_setEpochTimeMicroseconds (t1, nanos / 1000));
+    ASSERT_EQ (MAMA_STATUS_OK, mamaDateTime_getEpochTimeNanoseconds (t1, &result));
+    EXPECT_EQ (nanos / 1000 * 1000, result);
+
+    EXPECT_EQ (MAMA_STATUS_OK, mamaDateTime_destroy (t1));
+}
+
+/*  Description:     Compare two date times which differ only below the
+ *                   microsecond, and copy one to the other.
+ *
+ *  Expected Result: They compare unequal until copied.
+ */
+TEST_F (MamaDateTimeTestC, NanosecondCompareAndCopy)
+{
+    mamaDateTime t1 = NULL;
+    mamaDateTime t2 = NULL;
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaDateTime_create (&t1));
+    ASSERT_EQ (MAMA_STATUS_OK, mamaDateTime_create (&t2));
+    ASSERT_EQ (MAMA_STATUS_OK, mamaDateTime_setEpochTimeNanoseconds (t1, 1000000001ULL));
+    ASSERT_EQ (MAMA_STATUS_OK, mamaDateTime_setEpochTimeNanoseconds (t2, 1000000002ULL));
+
+    EXPECT_EQ (0, mamaDateTime_equal (t1, t2));
+    EXPECT_GT (0, mamaDateTime_compare (t1, t2));
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaDateTime_copy (t1, t2));
+    EXPECT_EQ (1, mamaDateTime_equal (t1, t2));
+
+    EXPECT_EQ (MAMA_STATUS_OK, mamaDateTime_destroy (t1));
+    EXPECT_EQ (MAMA_STATUS_OK, mamaDateTime_destroy (t2));
+}
+
+/*  Description:     Check the calendar accessors against known dates,
+ *                   including a leap day and the end of a century.
+ *
+ *  Expected Result: The expected year, month, day and weekday.
+ */
+TEST_F (MamaDateTimeTestC, CalendarFields)
+{
+    mamaDateTime  t1    = NULL;
+    mama_u32_t    year  = 0;
+    mama_u32_t    month = 0;
+    mama_u32_t    day   = 0;
+    mama_u32_t    hour  = 0;
+    mamaDayOfWeek dow   = Sunday;
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaDateTime_create (&t1));
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaDateTime_setFromString (t1, "2000-02-29 23:59:59"));
+    mamaDateTime_getYear (t1, &year);
+    mamaDateTime_getMonth (t1, &month);
+    mamaDateTime_getDay (t1, &day);
+    mamaDateTime_getHour (t1, &hour);
+    mamaDateTime_getDayOfWeek (t1, &dow);
+    EXPECT_EQ (2000U, year);
+    EXPECT_EQ (2U, month);
+    EXPECT_EQ (29U, day);
+    EXPECT_EQ (23U, hour);
+    EXPECT_EQ (Tuesday, dow);
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaDateTime_setFromString (t1, "2099-12-31 00:00:00"));
+    mamaDateTime_getYear (t1, &year);
+    mamaDateTime_getMonth (t1, &month);
+    mamaDateTime_getDay (t1, &day);
+    EXPECT_EQ (2099U, year);
+    EXPECT_EQ (12U, month);
+    EXPECT_EQ (31U, day);
+
+    EXPECT_EQ (MAMA_STATUS_OK, mamaDateTime_destroy (t1));
+}
+
+/*  Description:     Convert times either side of a daylight savings change
+ *                   in a zone given as a POSIX TZ rule, which needs no
+ *                   zoneinfo.
+ *
+ *  Expected Result: The offset follows the time being converted, not the
+ *                   current time.
+ */
+TEST_F (MamaDateTimeTestC, TimeZoneOffsetFollowsDaylightSavings)
+{
+    mamaTimeZone tz       = NULL;
+    mamaDateTime t1       = NULL;
+    mama_i32_t   offset   = 0;
+    mama_u64_t   utcMicro = 0;
+    mama_u32_t   hour     = 0;
+    mama_u32_t   micros   = 0;
+    mama_u32_t   seconds  = 0;
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaTimeZone_createFromTz (&tz, "EST5EDT,M3.2.0,M11.1.0"));
+    ASSERT_EQ (MAMA_STATUS_OK, mamaDateTime_create (&t1));
+
+    /* 2013-01-15 12:00:00 UTC and 2013-07-15 12:00:00 UTC */
+    ASSERT_EQ (MAMA_STATUS_OK, mamaTimeZone_getOffsetAt (tz, 1358251200, &offset));
+    EXPECT_EQ (-5 * 3600, offset);
+    ASSERT_EQ (MAMA_STATUS_OK, mamaTimeZone_getOffsetAt (tz, 1373889600, &offset));
+    EXPECT_EQ (-4 * 3600, offset);
+
+    /* Local 2013-07-04 10:00 is 14:00 UTC */
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaDateTime_setFromStringWithTz (t1, "2013-07-04 10:00:00", tz));
+    ASSERT_EQ (MAMA_STATUS_OK, mamaDateTime_getHour (t1, &hour));
+    EXPECT_EQ (14U, hour);
+
+    /* And back again */
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaDateTime_getEpochTimeMicrosecondsWithTz (t1, &utcMicro, tz));
+    EXPECT_EQ (10U, (utcMicro / 1000000 % 86400) / 3600);
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaDateTime_getEpochTimeWithTz (t1, &seconds, &micros, NULL, tz));
+    EXPECT_EQ (10U, (seconds % 86400) / 3600);
+
+    /* Local 2013-12-04 10:00 is 15:00 UTC */
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaDateTime_setFromStringWithTz (t1, "2013-12-04 10:00:00", tz));
+    ASSERT_EQ (MAMA_STATUS_OK, mamaDateTime_getHour (t1, &hour));
+    EXPECT_EQ (15U, hour);
+
+    EXPECT_EQ (MAMA_STATUS_OK, mamaDateTime_destroy (t1));
+    EXPECT_EQ (MAMA_STATUS_OK, mamaTimeZone_destroy (tz));
+}
+
+/*  Description:     Parse the ISO layouts handled at fixed positions,
+ *                   including a 'T' separator and nine fractional digits,
+ *                   and format them back.
+ *
+ *  Expected Result: The strings round trip.
+ */
+TEST_F (MamaDateTimeTestC, IsoStringRoundTrip)
+{
+    mamaDateTime t1   = NULL;
+    mama_u64_t   nanos = 0;
+    char         buf[56];
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaDateTime_create (&t1));
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaDateTime_setFromString (t1, "2013-07-04T10:03:21.123456"));
+    ASSERT_EQ (MAMA_STATUS_OK, mamaDateTime_getAsString (t1, buf, sizeof (buf)));
+    EXPECT_STREQ ("2013-07-04 10:03:21.123456", buf);
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaDateTime_setFromString (t1, "2013-07-04 10:03:21.123456789"));
+    ASSERT_EQ (MAMA_STATUS_OK, mamaDateTime_getEpochTimeNanoseconds (t1, &nanos));
+    EXPECT_EQ (1372932201123456789ULL, nanos);
+    ASSERT_EQ (MAMA_STATUS_OK, mamaDateTime_getTimeAsString (t1, buf, sizeof (buf)));
+    EXPECT_STREQ ("10:03:21.123456789", buf);
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaDateTime_setFromString (t1, "2099-12-31"));
+    ASSERT_EQ (MAMA_STATUS_OK, mamaDateTime_getAsString (t1, buf, sizeof (buf)));
+    EXPECT_STREQ ("2099-12-31", buf);
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaDateTime_getAsFormattedString (t1, buf, sizeof (buf), "%F"));
+    EXPECT_STREQ ("2099-12-31", buf);
+
+    EXPECT_EQ (MAMA_STATUS_OK, mamaDateTime_destroy (t1));
+}
@@ -0,0 +1,178 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#include <gtest/gtest.h>
+#include "MainUnitTestC.h"
+#include "mama/mama.h"
+#include "mama/msgtype.h"
+#include "mama/msgstatus.h"
+#include "mama/reservedfields.h"
+#include "mama/msgqualifier.h"
+#include "msgimpl.h"
+
+class MsgHeaderTestsC : public ::testing::Test
+{
+protected:
+    MsgHeaderTestsC();
+    virtual ~MsgHeaderTestsC();
+
+    virtual void SetUp(void);
+    virtual void TearDown(void);
+
+    mamaMsg            mMsg;
+    mamaPayloadBridge  mPayloadBridge;
+};
+
+MsgHeaderTestsC::MsgHeaderTestsC()
+    : mMsg          (NULL)
+    , mPayloadBridge (NULL)
+{
+}
+
+MsgHeaderTestsC::~MsgHeaderTestsC()
+{
+}
+
+void
+MsgHeaderTestsC::SetUp(void)
+{
+    mama_loadPayloadBridge (&mPayloadBridge, getPayload());
+    mamaMsg_create (&mMsg);
+
+    mamaMsg_addI32 (mMsg, MamaFieldMsgType.mName, MamaFieldMsgType.mFid,
+                    MAMA_MSG_TYPE_RECAP);
+    mamaMsg_addI32 (mMsg, MamaFieldMsgStatus.mName, MamaFieldMsgStatus.mFid,
+                    MAMA_MSG_STATUS_STALE);
+    mamaMsg_addI64 (mMsg, MamaFieldSeqNum.mName, MamaFieldSeqNum.mFid, 42);
+    mamaMsg_addU64 (mMsg, MamaFieldSenderId.mName, MamaFieldSenderId.mFid, 7);
+    mamaMsg_addU16 (mMsg, MamaFieldMsgQual.mName, MamaFieldMsgQual.mFid,
+                    MAMA_MSG_QUAL_POSSIBLY_DUPLICATE);
+}
+
+void
+MsgHeaderTestsC::TearDown(void)
+{
+    mamaMsg_destroy (mMsg);
+}
+
+/* A received (not owned) message answers from the decoded header. */
+TEST_F (MsgHeaderTestsC, DecodedFieldsMatchPayload)
+{
+    mama_seqnum_t seqNum   = 0;
+    mama_u64_t    senderId = 0;
+    mama_u16_t    msgQual  = 0;
+
+    mamaMsgImpl_setMessageOwner (mMsg, 0);
+    ASSERT_EQ (MAMA_STATUS_OK, mamaMsgImpl_decodeHeader (mMsg));
+
+    EXPECT_EQ (MAMA_MSG_TYPE_RECAP, mamaMsgType_typeForMsg (mMsg));
+    EXPECT_EQ (MAMA_MSG_STATUS_STALE, mamaMsgImpl_getStatusFromMsg (mMsg));
+    ASSERT_EQ (MAMA_STATUS_OK, mamaMsg_getSeqNum (mMsg, &seqNum));
+    EXPECT_EQ (42u, seqNum);
+    ASSERT_EQ (MAMA_STATUS_OK, mamaMsgImpl_getSenderId (mMsg, &senderId));
+    EXPECT_EQ (7u, senderId);
+    ASSERT_EQ (MAMA_STATUS_OK, mamaMsgImpl_getMsgQual (mMsg, &msgQual));
+    EXPECT_EQ ((mama_u16_t) MAMA_MSG_QUAL_POSSIBLY_DUPLICATE, msgQual);
+
+    mamaMsgImpl_setMessageOwner (mMsg, 1);
+}
+
+/* Missing fields are reported the same way with or without the header. */
+TEST_F (MsgHeaderTestsC, MissingFieldsNotFound)
+{
+    mamaMsg       empty    = NULL;
+    mama_seqnum_t seqNum   = 1;
+    mama_u64_t    senderId = 1;
+    mama_u16_t    msgQual  = 1;
+
+    mamaMsg_create (&empty);
+    mamaMsgImpl_setMessageOwner (empty, 0);
+    ASSERT_EQ (MAMA_STATUS_OK, mamaMsgImpl_decodeHeader (empty));
+
+    EXPECT_EQ (MAMA_MSG_TYPE_UNKNOWN, mamaMsgType_typeForMsg (empty));
+    EXPECT_EQ (MAMA_MSG_STATUS_UNKNOWN, mamaMsgImpl_getStatusFromMsg (empty));
+    EXPECT_NE (MAMA_STATUS_OK, mamaMsg_getSeqNum (empty, &seqNum));
+    EXPECT_NE (MAMA_STATUS_OK, mamaMsgImpl_getSenderId (empty, &senderId));
+    EXPECT_NE (MAMA_STATUS_OK, mamaMsgImpl_getMsgQual (empty, &msgQual));
+
+    mamaMsgImpl_setMessageOwner (empty, 1);
+    mamaMsg_destroy (empty);
+}
+
+/* Any modification discards the decoded header, owned or not. */
+TEST_F (MsgHeaderTestsC, ModificationDiscardsHeader)
+{
+    mama_seqnum_t seqNum = 0;
+    mamaMsgField  field  = NULL;
+
+    mamaMsgImpl_setMessageOwner (mMsg, 0);
+    ASSERT_EQ (MAMA_STATUS_OK, mamaMsgImpl_decodeHeader (mMsg));
+    mamaMsgImpl_setMessageOwner (mMsg, 1);
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaMsg_updateI64 (mMsg, MamaFieldSeqNum.mName,
+                                  MamaFieldSeqNum.mFid, 43));
+    ASSERT_EQ (MAMA_STATUS_OK, mamaMsg_getSeqNum (mMsg, &seqNum));
+    EXPECT_EQ (43u, seqNum);
+
+    /* An owned message is decoded too. */
+    ASSERT_EQ (MAMA_STATUS_OK, mamaMsgImpl_decodeHeader (mMsg));
+    EXPECT_EQ (MAMA_MSG_TYPE_RECAP, mamaMsgType_typeForMsg (mMsg));
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaMsg_updateI32 (mMsg, MamaFieldMsgType.mName,
+                                  MamaFieldMsgType.mFid, MAMA_MSG_TYPE_UPDATE));
+    EXPECT_EQ (MAMA_MSG_TYPE_UPDATE, mamaMsgType_typeForMsg (mMsg));
+
+    /* Updating through a field discards it as well. */
+    ASSERT_EQ (MAMA_STATUS_OK, mamaMsgImpl_decodeHeader (mMsg));
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaMsg_getField (mMsg, MamaFieldMsgStatus.mName,
+                                 MamaFieldMsgStatus.mFid, &field));
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaMsgField_updateI32 (field, MAMA_MSG_STATUS_OK));
+    EXPECT_EQ (MAMA_MSG_STATUS_OK, mamaMsgImpl_getStatusFromMsg (mMsg));
+}
+
+/* A payload reading the header in one pass finds the same fields. */
+TEST_F (MsgHeaderTestsC, PayloadHeaderHook)
+{
+    mamaPayloadBridgeImpl* bridge  = (mamaPayloadBridgeImpl*) mPayloadBridge;
+    msgPayload             payload = NULL;
+    msgPayloadHeader       header;
+
+    if (NULL == bridge->msgPayloadGetHeader)
+    {
+        return;
+    }
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaMsgImpl_getPayload (mMsg, &payload));
+    ASSERT_EQ (MAMA_STATUS_OK, bridge->msgPayloadGetHeader (payload, &header));
+
+    EXPECT_EQ (MAMA_PAYLOAD_HEADER_TYPE | MAMA_PAYLOAD_HEADER_STATUS
+               | MAMA_PAYLOAD_HEADER_SEQNUM | MAMA_PAYLOAD_HEADER_SENDERID
+               | MAMA_PAYLOAD_HEADER_MSGQUAL, header.mPresent);
+    EXPECT_EQ (MAMA_MSG_TYPE_RECAP, header.mType);
+    EXPECT_EQ (MAMA_MSG_STATUS_STALE, header.mStatus);
+    EXPECT_EQ (42, header.mSeqNum);
+    EXPECT_EQ (7u, header.mSenderId);
+    EXPECT_EQ ((mama_u16_t) MAMA_MSG_QUAL_POSSIBLY_DUPLICATE, header.mMsgQual);
+}
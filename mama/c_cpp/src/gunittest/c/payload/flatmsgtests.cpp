@@ -0,0 +1,344 @@
+/*
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#include <gtest/gtest.h>
+#include "mama/mama.h"
+#include "MainUnitTestC.h"
+#include "payloadbridge.h"
+#include "msgimpl.h"
+#include "payload/flatmsg/flatcommon.h"
+#include <string.h>
+#include <vector>
+
+/*
+ * These tests are specific to the flat payload, as they build corrupt copies
+ * of its wire format, so the bridge is always loaded by name rather than
+ * taken from the command line.
+ */
+class FlatmsgPayloadTests : public ::testing::Test
+{
+protected:
+    FlatmsgPayloadTests(void);
+    virtual ~FlatmsgPayloadTests(void);
+
+    virtual void SetUp(void);
+    virtual void TearDown(void);
+
+    /* Encodes a message with one of each interesting field type in mWire */
+    void encode (void);
+
+    /* Offset of the field header with the fid given in mWire */
+    mama_u32_t fieldOffset (mama_fid_t fid);
+
+    /* Runs the wire buffer through createFromByteBuffer */
+    mama_status decode (mama_size_t length);
+
+    mamaPayloadBridge       mBridge;
+    msgPayload              mMsg;
+    msgPayload              mDecoded;
+
+    /* Held as u64 so that the encoded message is 8 byte aligned */
+    std::vector<mama_u64_t> mStorage;
+    mama_u8_t*              mWire;
+    mama_size_t             mWireSize;
+};
+
+FlatmsgPayloadTests::FlatmsgPayloadTests(void)
+    : mBridge (NULL)
+    , mMsg (NULL)
+    , mDecoded (NULL)
+    , mWire (NULL)
+    , mWireSize (0)
+{
+}
+
+FlatmsgPayloadTests::~FlatmsgPayloadTests(void)
+{
+}
+
+void FlatmsgPayloadTests::SetUp(void)
+{
+    ASSERT_EQ (MAMA_STATUS_OK, mama_loadPayloadBridge (&mBridge, "flatmsg"));
+    ASSERT_EQ (MAMA_STATUS_OK, mBridge->msgPayloadCreate (&mMsg));
+}
+
+void FlatmsgPayloadTests::TearDown(void)
+{
+    if (NULL != mDecoded)
+    {
+        mBridge->msgPayloadDestroy (mDecoded);
+    }
+    mBridge->msgPayloadDestroy (mMsg);
+}
+
+void FlatmsgPayloadTests::encode (void)
+{
+    const char* strings[]  = { "one", "two", "three" };
+    mamaMsg     sub        = NULL;
+    msgPayload  subPayload = NULL;
+    const void* buffer     = NULL;
+
+    ASSERT_EQ (MAMA_STATUS_OK, mBridge->msgPayloadAddI32 (mMsg, "int", 1, 42));
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mBridge->msgPayloadAddString (mMsg, "str", 2, "hello"));
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mBridge->msgPayloadAddVectorString (mMsg, NULL, 3, strings, 3));
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaMsg_createForPayloadBridge (&sub, mBridge));
+    ASSERT_EQ (MAMA_STATUS_OK, mamaMsg_addU32 (sub, NULL, 1, 7));
+    ASSERT_EQ (MAMA_STATUS_OK, mamaMsgImpl_getPayload (sub, &subPayload));
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mBridge->msgPayloadAddMsg (mMsg, NULL, 4, subPayload));
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mBridge->msgPayloadAddVectorMsg (mMsg, NULL, 5, &sub, 1));
+    mamaMsg_destroy (sub);
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mBridge->msgPayloadSerialize (mMsg, &buffer, &mWireSize));
+
+    /* One spare word so the buffer can also be offset to misalign it */
+    mStorage.assign (mWireSize / sizeof (mama_u64_t) + 2, 0);
+    mWire = (mama_u8_t*) &mStorage[0];
+    memcpy (mWire, buffer, mWireSize);
+}
+
+mama_u32_t FlatmsgPayloadTests::fieldOffset (mama_fid_t fid)
+{
+    flatmsgHeader*     header = (flatmsgHeader*) mWire;
+    flatmsgIndexEntry* index  = (flatmsgIndexEntry*) (mWire
+                                    + sizeof (flatmsgHeader) + header->mDataSize);
+
+    for (mama_u32_t i = 0; i < header->mNumFields; i++)
+    {
+        if (fid == index[i].mFid)
+        {
+            return (mama_u32_t) sizeof (flatmsgHeader) + index[i].mOffset;
+        }
+    }
+    return 0;
+}
+
+mama_status FlatmsgPayloadTests::decode (mama_size_t length)
+{
+    if (NULL != mDecoded)
+    {
+        mBridge->msgPayloadDestroy (mDecoded);
+        mDecoded = NULL;
+    }
+    return mBridge->msgPayloadCreateFromByteBuffer (&mDecoded, mBridge,
+                                                    mWire, length);
+}
+
+
+/* ************************************************************************* */
+/* Tests */
+/* ************************************************************************* */
+TEST_F(FlatmsgPayloadTests, AlignedBufferIsNotCopied)
+{
+    const void* buffer   = NULL;
+    mama_size_t size     = 0;
+    mama_i32_t  value    = 0;
+    msgPayload  sub      = NULL;
+    mama_u32_t  subValue = 0;
+
+    encode ();
+    ASSERT_EQ (MAMA_STATUS_OK, decode (mWireSize));
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mBridge->msgPayloadGetByteBuffer (mDecoded, &buffer, &size));
+    EXPECT_EQ ((const void*) mWire, buffer);
+    EXPECT_EQ (mWireSize, size);
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mBridge->msgPayloadGetI32 (mDecoded, NULL, 1, &value));
+    EXPECT_EQ (42, value);
+
+    /* Sub messages are views of their field */
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mBridge->msgPayloadGetMsg (mDecoded, NULL, 4, &sub));
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mBridge->msgPayloadGetByteBuffer (sub, &buffer, &size));
+    EXPECT_TRUE ((const mama_u8_t*) buffer > mWire
+                 && (const mama_u8_t*) buffer < mWire + mWireSize);
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mBridge->msgPayloadGetU32 (sub, NULL, 1, &subValue));
+    EXPECT_EQ (7u, subValue);
+}
+
+TEST_F(FlatmsgPayloadTests, UnalignedBufferIsCopied)
+{
+    const void* buffer = NULL;
+    mama_size_t size   = 0;
+    const char* str    = NULL;
+
+    encode ();
+    memmove (mWire + 1, mWire, mWireSize);
+    mWire += 1;
+
+    ASSERT_EQ (MAMA_STATUS_OK, decode (mWireSize));
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mBridge->msgPayloadGetByteBuffer (mDecoded, &buffer, &size));
+    EXPECT_NE ((const void*) mWire, buffer);
+    EXPECT_EQ (mWireSize, size);
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mBridge->msgPayloadGetString (mDecoded, NULL, 2, &str));
+    EXPECT_STREQ ("hello", str);
+}
+
+TEST_F(FlatmsgPayloadTests, UpdateDoesNotWriteToView)
+{
+    mama_i32_t value = 0;
+
+    encode ();
+    std::vector<mama_u8_t> original (mWire, mWire + mWireSize);
+
+    ASSERT_EQ (MAMA_STATUS_OK, decode (mWireSize));
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mBridge->msgPayloadUpdateI32 (mDecoded, NULL, 1, 99));
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mBridge->msgPayloadAddI32 (mDecoded, NULL, 6, 100));
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mBridge->msgPayloadGetI32 (mDecoded, NULL, 1, &value));
+    EXPECT_EQ (99, value);
+    EXPECT_EQ (0, memcmp (&original[0], mWire, mWireSize));
+}
+
+TEST_F(FlatmsgPayloadTests, TruncatedBufferRejected)
+{
+    encode ();
+
+    for (mama_size_t length = 1; length < mWireSize; length++)
+    {
+        EXPECT_NE (MAMA_STATUS_OK, decode (length)) << "length " << length;
+        EXPECT_EQ (NULL, mDecoded);
+    }
+}
+
+TEST_F(FlatmsgPayloadTests, FieldSizePastDataRejected)
+{
+    encode ();
+    flatmsgFieldHeader* hdr = (flatmsgFieldHeader*) (mWire + fieldOffset (1));
+    hdr->mSize = 0xFFFFFFF0;
+
+    EXPECT_EQ (MAMA_STATUS_INVALID_ARG, decode (mWireSize));
+}
+
+TEST_F(FlatmsgPayloadTests, UnterminatedNameRejected)
+{
+    encode ();
+    flatmsgFieldHeader* hdr = (flatmsgFieldHeader*) (mWire + fieldOffset (2));
+    ((char*) (hdr + 1))[hdr->mNameLength - 1] = 'x';
+
+    EXPECT_EQ (MAMA_STATUS_INVALID_ARG, decode (mWireSize));
+}
+
+TEST_F(FlatmsgPayloadTests, UnterminatedStringRejected)
+{
+    encode ();
+    flatmsgFieldHeader* hdr = (flatmsgFieldHeader*) (mWire + fieldOffset (2));
+    FLATMSG_FIELD_VALUE (hdr)[hdr->mSize - 1] = 'x';
+
+    EXPECT_EQ (MAMA_STATUS_INVALID_ARG, decode (mWireSize));
+}
+
+TEST_F(FlatmsgPayloadTests, VectorStringCountPastDataRejected)
+{
+    encode ();
+    flatmsgFieldHeader* hdr = (flatmsgFieldHeader*) (mWire + fieldOffset (3));
+    *(mama_u32_t*) FLATMSG_FIELD_VALUE (hdr) = 4;
+
+    EXPECT_EQ (MAMA_STATUS_INVALID_ARG, decode (mWireSize));
+}
+
+TEST_F(FlatmsgPayloadTests, VectorMsgLengthPastDataRejected)
+{
+    encode ();
+    flatmsgFieldHeader* hdr = (flatmsgFieldHeader*) (mWire + fieldOffset (5));
+    ((mama_u32_t*) FLATMSG_FIELD_VALUE (hdr))[2] = hdr->mSize;
+
+    EXPECT_EQ (MAMA_STATUS_INVALID_ARG, decode (mWireSize));
+}
+
+TEST_F(FlatmsgPayloadTests, UnknownTypeRejected)
+{
+    encode ();
+    flatmsgFieldHeader* hdr = (flatmsgFieldHeader*) (mWire + fieldOffset (1));
+    hdr->mType = 0xFF;
+
+    EXPECT_EQ (MAMA_STATUS_INVALID_ARG, decode (mWireSize));
+}
+
+TEST_F(FlatmsgPayloadTests, IndexOffsetPastDataRejected)
+{
+    encode ();
+    flatmsgHeader*     header = (flatmsgHeader*) mWire;
+    flatmsgIndexEntry* index  = (flatmsgIndexEntry*) (mWire
+                                    + sizeof (flatmsgHeader) + header->mDataSize);
+    index[0].mOffset = header->mDataSize;
+
+    EXPECT_EQ (MAMA_STATUS_INVALID_ARG, decode (mWireSize));
+}
+
+TEST_F(FlatmsgPayloadTests, IndexMismatchRejected)
+{
+    encode ();
+    flatmsgHeader*     header = (flatmsgHeader*) mWire;
+    flatmsgIndexEntry* index  = (flatmsgIndexEntry*) (mWire
+                                    + sizeof (flatmsgHeader) + header->mDataSize);
+    index[0].mOffset = index[1].mOffset;
+
+    EXPECT_EQ (MAMA_STATUS_INVALID_ARG, decode (mWireSize));
+}
+
+TEST_F(FlatmsgPayloadTests, FieldCountMismatchRejected)
+{
+    encode ();
+    flatmsgHeader* header = (flatmsgHeader*) mWire;
+    header->mNumFields--;
+
+    EXPECT_EQ (MAMA_STATUS_INVALID_ARG, decode (mWireSize));
+}
+
+TEST_F(FlatmsgPayloadTests, HugeFieldCountRejected)
+{
+    encode ();
+    flatmsgHeader* header = (flatmsgHeader*) mWire;
+    header->mNumFields = 0xFFFFFFFF;
+
+    EXPECT_EQ (MAMA_STATUS_INVALID_ARG, decode (mWireSize));
+}
+
+TEST_F(FlatmsgPayloadTests, CorruptSubMessageRejected)
+{
+    msgPayload sub = NULL;
+
+    encode ();
+    flatmsgFieldHeader* hdr = (flatmsgFieldHeader*) (mWire + fieldOffset (4));
+    ((flatmsgHeader*) FLATMSG_FIELD_VALUE (hdr))->mDataSize = 8;
+
+    /* Sub messages are only checked when they are decoded */
+    ASSERT_EQ (MAMA_STATUS_OK, decode (mWireSize));
+    EXPECT_EQ (MAMA_STATUS_INVALID_ARG,
+               mBridge->msgPayloadGetMsg (mDecoded, NULL, 4, &sub));
+}
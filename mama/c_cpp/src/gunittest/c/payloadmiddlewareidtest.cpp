@@ -58,6 +58,7 @@ MamaEnumTestsC::CreateTestData()
     payloadTestData.insert (MamaPayloadPair (MAMA_PAYLOAD_V5,         "V5"));
     payloadTestData.insert (MamaPayloadPair (MAMA_PAYLOAD_AVIS,       "AVIS"));
     payloadTestData.insert (MamaPayloadPair (MAMA_PAYLOAD_TICK42BLP,  "TICK42BLP"));
+    payloadTestData.insert (MamaPayloadPair (MAMA_PAYLOAD_FLAT,       "FLAT"));
     payloadTestData.insert (MamaPayloadPair (MAMA_PAYLOAD_FAST,       "FAST"));
     payloadTestData.insert (MamaPayloadPair (MAMA_PAYLOAD_RAI,        "rai"));
     payloadTestData.insert (MamaPayloadPair (MAMA_PAYLOAD_KWANTUM,    "KWANTUM"));
@@ -19,10 +19,16 @@
 
 
 #include <gtest/gtest.h>
+#include <vector>
+#include <cstdio>
+#include <cstring>
 #include "mama/mama.h"
 #include "mama/status.h"
 #include "MainUnitTestC.h"
 #include "mama/queue.h"
+#include "mama/publisher.h"
+#include "mama/subscription.h"
+#include "mama/source.h"
 
 class MamaQueueTestC : public ::testing::Test
 {
@@ -127,6 +133,91 @@ void MAMACALLTYPE onLowWatermark (mamaQueue queue, size_t size, void* closure)
 {
 }
 
+void MAMACALLTYPE onHighResidency (mamaQueue queue, mama_u64_t residency, void* closure)
+{
+    MamaQueueTestC* fixture = (MamaQueueTestC*)closure;
+    fixture->m_highWaterMarkOccurance++;
+}
+
+void MAMACALLTYPE onLowResidency (mamaQueue queue, mama_u64_t residency, void* closure)
+{
+    MamaQueueTestC* fixture = (MamaQueueTestC*)closure;
+    fixture->m_lowWaterMarkOccurance++;
+}
+
+/* An update as it was delivered to a conflating subscription */
+struct ConflatedUpdate
+{
+    mama_seqnum_t   mSeqNum;
+    mama_u16_t      mConflateCount;
+    mama_u32_t      mValue;
+    mama_u32_t      mFields;
+};
+
+struct ConflationClosure
+{
+    mama_u32_t                      mUpdates;
+    int                             mGaps;
+    std::vector<ConflatedUpdate>    mDelivered;
+};
+
+void MAMACALLTYPE onConflatedMsg (mamaSubscription subscription,
+                                  mamaMsg          msg,
+                                  void*            closure,
+                                  void*            itemClosure)
+{
+    ConflationClosure* conflation = (ConflationClosure*)closure;
+    ConflatedUpdate    update     = { 0, 1, 0, 0 };
+    mama_u32_t         value      = 0;
+
+    mamaMsg_getSeqNum (msg, &update.mSeqNum);
+    if (MAMA_STATUS_OK != mamaMsg_getU16 (msg,
+                                          MamaFieldConflateCount.mName,
+                                          MamaFieldConflateCount.mFid,
+                                          &update.mConflateCount))
+    {
+        update.mConflateCount = 1;
+    }
+    mamaMsg_getU32 (msg, NULL, 101, &update.mValue);
+
+    /* Each update adds a field of its own as well as changing field 101 */
+    for (mama_u32_t i = 1; i <= conflation->mUpdates; i++)
+    {
+        if (MAMA_STATUS_OK == mamaMsg_getU32 (msg, NULL, 200 + i, &value))
+            update.mFields++;
+    }
+
+    conflation->mDelivered.push_back (update);
+}
+
+void MAMACALLTYPE onConflatedGap (mamaSubscription subscription, void* closure)
+{
+    ConflationClosure* conflation = (ConflationClosure*)closure;
+    conflation->mGaps++;
+}
+
+static mama_status publishUpdate (mamaPublisher publisher, mama_u32_t seqNum)
+{
+    mamaMsg     msg    = NULL;
+    mama_status status = mamaMsg_create (&msg);
+
+    if (MAMA_STATUS_OK != status)
+        return status;
+
+    mamaMsg_addI32 (msg, MamaFieldMsgType.mName, MamaFieldMsgType.mFid,
+                    MAMA_MSG_TYPE_UPDATE);
+    mamaMsg_addI32 (msg, MamaFieldMsgStatus.mName, MamaFieldMsgStatus.mFid,
+                    MAMA_MSG_STATUS_OK);
+    mamaMsg_addI64 (msg, MamaFieldSeqNum.mName, MamaFieldSeqNum.mFid, seqNum);
+    mamaMsg_addU32 (msg, NULL, 101, seqNum);
+    mamaMsg_addU32 (msg, NULL, 200 + seqNum, seqNum);
+
+    status = mamaPublisher_send (publisher, msg);
+    mamaMsg_destroy (msg);
+
+    return status;
+}
+
 /* ************************************************************************* */
 /* Test Functions */
 /* ************************************************************************* */
@@ -373,6 +464,217 @@ TEST_F (MamaQueueTestC, MonitorWatermarks)
                mamaQueue_destroy (queue));
 }
 
+/*  Description:   conflation on the high watermark is enabled on the queue of
+ *                 a market data subscription. Once dispatching finds the
+ *                 queue at its high watermark, the updates published after
+ *                 it are merged into a single update carrying the latest
+ *                 fields and a conflate count covering them all, so the
+ *                 sequence number check sees no gap.
+ *
+ *  Expected Result: MAMA_STATUS_OK
+ */
+TEST_F (MamaQueueTestC, ConflateOnHighWatermark)
+{
+    const mama_u32_t  updates      = 10;
+    mamaQueue         queue        = NULL;
+    mamaTransport     pubTransport = NULL;
+    mamaTransport     subTransport = NULL;
+    mamaSource        source       = NULL;
+    mamaSubscription  subscription = NULL;
+    mamaPublisher     publisher    = NULL;
+    mama_seqnum_t     lastSeqNum   = 0;
+    int               conflating   = 0;
+    int               merged       = 0;
+    char              pubName[32];
+    char              subName[32];
+    mamaMsgCallbacks  callbacks;
+    ConflationClosure closure;
+
+    closure.mUpdates = updates;
+    closure.mGaps    = 0;
+
+    memset (&callbacks, 0, sizeof (callbacks));
+    callbacks.onMsg = onConflatedMsg;
+    callbacks.onGap = onConflatedGap;
+
+    snprintf (pubName, sizeof (pubName), "pub_%s", getMiddleware ());
+    snprintf (subName, sizeof (subName), "sub_%s", getMiddleware ());
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaTransport_allocate (&pubTransport));
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaTransport_create (pubTransport, pubName, mBridge));
+    ASSERT_EQ (MAMA_STATUS_OK, mamaTransport_allocate (&subTransport));
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaTransport_create (subTransport, subName, mBridge));
+
+    /* Create the subscription straight away rather than on a throttle
+     * timer on the default queue, which is not dispatched here */
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaTransport_setOutboundThrottle (subTransport,
+                                                  MAMA_THROTTLE_DEFAULT,
+                                                  0.0));
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaQueue_create (&queue, mBridge));
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaQueue_setHighWatermark (queue, 2));
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaQueue_setLowWatermark (queue, 1));
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaQueue_setConflateOnHighWatermark (queue, 1));
+
+    mamaSource_create (&source);
+    mamaSource_setId (source, "TestSource");
+    mamaSource_setTransport (source, subTransport);
+    mamaSource_setSymbolNamespace (source, "TestSource");
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaSubscription_allocate (&subscription));
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaSubscription_setRequiresInitial (subscription, 0));
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaSubscription_create (subscription,
+                                        queue,
+                                        &callbacks,
+                                        source,
+                                        "CONFLATE_SYMBOL",
+                                        &closure));
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaPublisher_create (&publisher,
+                                     pubTransport,
+                                     "CONFLATE_SYMBOL",
+                                     "TestSource",
+                                     NULL));
+
+    /* Give the subscription time to reach the publisher */
+    sleep (1);
+
+    /* Fill the queue past the high watermark, which the next dispatch
+     * notices before delivering the first update */
+    for (mama_u32_t x = 1; x <= 3; x++)
+    {
+        ASSERT_EQ (MAMA_STATUS_OK, publishUpdate (publisher, x));
+    }
+    sleep (1);
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaQueue_timedDispatch (queue, m_timeout));
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaQueue_isConflating (queue, &conflating));
+    ASSERT_EQ (1, conflating);
+
+    for (mama_u32_t x = 4; x <= updates; x++)
+    {
+        ASSERT_EQ (MAMA_STATUS_OK, publishUpdate (publisher, x));
+    }
+    sleep (1);
+
+    for (mama_u32_t x = 0; x < updates; x++)
+    {
+        if (!closure.mDelivered.empty () &&
+            updates == closure.mDelivered.back ().mSeqNum)
+        {
+            break;
+        }
+        ASSERT_EQ (MAMA_STATUS_OK,
+                   mamaQueue_timedDispatch (queue, m_timeout));
+    }
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaQueue_isConflating (queue, &conflating));
+    ASSERT_EQ (0, conflating);
+
+    /* Every update is accounted for, and the latest is delivered */
+    ASSERT_FALSE (closure.mDelivered.empty ());
+    ASSERT_LT (closure.mDelivered.size (), (size_t)updates);
+    ASSERT_EQ (updates, closure.mDelivered.back ().mSeqNum);
+    ASSERT_EQ (updates, closure.mDelivered.back ().mValue);
+
+    for (size_t x = 0; x < closure.mDelivered.size (); x++)
+    {
+        const ConflatedUpdate& update = closure.mDelivered[x];
+
+        ASSERT_EQ (lastSeqNum + update.mConflateCount, update.mSeqNum);
+        ASSERT_EQ (update.mSeqNum, update.mValue);
+        ASSERT_EQ ((mama_u32_t)update.mConflateCount, update.mFields);
+
+        if (update.mConflateCount > 1)
+            merged++;
+        lastSeqNum = update.mSeqNum;
+    }
+    ASSERT_EQ (1, merged);
+    ASSERT_EQ (0, closure.mGaps);
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaPublisher_destroy (publisher));
+    ASSERT_EQ (MAMA_STATUS_OK, mamaSubscription_destroy (subscription));
+    ASSERT_EQ (MAMA_STATUS_OK, mamaSubscription_deallocate (subscription));
+    mamaSource_destroy (source);
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaQueue_destroyTimedWait (queue, m_timeout));
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaTransport_destroy (pubTransport));
+    ASSERT_EQ (MAMA_STATUS_OK, mamaTransport_destroy (subTransport));
+}
+
+/*  Description:   a high residency watermark is set and events are left on
+ *                 the queue for longer than it before dispatching, which
+ *                 should invoke the high residency callback once.
+ *
+ *  Expected Result: MAMA_STATUS_OK
+ */
+TEST_F (MamaQueueTestC, MonitorResidency)
+{
+    mamaQueue  queue     = NULL;
+    mama_u64_t residency = 0;
+    m_numEvents          = 20;
+    m_eventCounter       = 0;
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaQueue_create (&queue, mBridge));
+
+    mamaQueueResidencyCallbacks residencyCallbacks;
+    residencyCallbacks.onQueueHighResidency = onHighResidency;
+    residencyCallbacks.onQueueLowResidency  = onLowResidency;
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaQueue_setResidencyCallbacks (queue, &residencyCallbacks, m_this));
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaQueue_setHighResidencyWatermark (queue, 1000));
+
+    ASSERT_EQ (MAMA_STATUS_INVALID_ARG,
+               mamaQueue_setLowResidencyWatermark (queue, 1000));
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaQueue_setLowResidencyWatermark (queue, 500));
+
+    for (int x=0; x<m_numEvents; x++)
+    {
+        ASSERT_EQ (MAMA_STATUS_OK,
+                   mamaQueue_enqueueEvent (queue, onEvent, m_this));
+    }
+
+    sleep (1);
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaQueue_dispatch (queue));
+
+    ASSERT_EQ (1, m_highWaterMarkOccurance);
+    ASSERT_EQ (0, m_lowWaterMarkOccurance);
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaQueue_getResidency (queue, &residency));
+    ASSERT_LT ((mama_u64_t)1000, residency);
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaQueue_destroy (queue));
+}
+
 /*  Description:   multiple queues created and an equal amount of events enqueued on each. 
  *                 mamaDispatchers are created to begin dispatching each queue's events on 
  *                 a separate thread each. Dispatchers and queues are destroyed once events
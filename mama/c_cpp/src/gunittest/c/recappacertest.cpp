@@ -0,0 +1,259 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+
+#include <gtest/gtest.h>
+#include "MainUnitTestC.h"
+#include "mama/mama.h"
+#include "recappacer.h"
+
+#define MIN_RATE        10.0
+#define MAX_RATE        1000.0
+#define BURST           100.0
+#define MAX_OUTSTANDING 20
+#define HIGH_WATERMARK  50
+
+class MamaRecapPacerTestC : public ::testing::Test
+{
+protected:
+    MamaRecapPacerTestC();
+    virtual ~MamaRecapPacerTestC();
+
+    virtual void SetUp();
+    virtual void TearDown ();
+
+    /* Request a recap for each of the first count subscriptions */
+    void request (int count);
+
+    /* Answer the recaps of the first count subscriptions */
+    int reply (int count);
+
+    recapPacer      mPacer;
+    wInterlockedInt mPending[100];
+};
+
+MamaRecapPacerTestC::MamaRecapPacerTestC()
+{
+}
+
+MamaRecapPacerTestC::~MamaRecapPacerTestC()
+{
+}
+
+void MamaRecapPacerTestC::SetUp(void)
+{
+    recapPacer_init (&mPacer, MIN_RATE, MAX_RATE, BURST,
+                     MAX_OUTSTANDING, HIGH_WATERMARK);
+
+    for (int i = 0; i < 100; i++)
+    {
+        wInterlocked_initialize (&mPending[i]);
+        wInterlocked_set (0, &mPending[i]);
+    }
+}
+
+void MamaRecapPacerTestC::TearDown(void)
+{
+    for (int i = 0; i < 100; i++)
+        wInterlocked_destroy (&mPending[i]);
+
+    recapPacer_destroy (&mPacer);
+}
+
+void MamaRecapPacerTestC::request (int count)
+{
+    for (int i = 0; i < count; i++)
+        recapPacer_requested (&mPacer, &mPending[i]);
+}
+
+int MamaRecapPacerTestC::reply (int count)
+{
+    int solicited = 0;
+
+    for (int i = 0; i < count; i++)
+        solicited += recapPacer_replied (&mPacer, &mPending[i]);
+
+    return solicited;
+}
+
+TEST_F (MamaRecapPacerTestC, StartsAtMaxRateWithFullBucket)
+{
+    EXPECT_DOUBLE_EQ (MAX_RATE, mPacer.mRate);
+    EXPECT_EQ ((unsigned long)BURST, recapPacer_getBudget (&mPacer, 0));
+}
+
+TEST_F (MamaRecapPacerTestC, MinRateClampedToMaxRate)
+{
+    recapPacer_destroy (&mPacer);
+    recapPacer_init (&mPacer, 500.0, 100.0, BURST,
+                     MAX_OUTSTANDING, HIGH_WATERMARK);
+
+    EXPECT_DOUBLE_EQ (100.0, mPacer.mMinRate);
+    EXPECT_DOUBLE_EQ (100.0, mPacer.mRate);
+}
+
+TEST_F (MamaRecapPacerTestC, UnsolicitedRecapsAreNotCounted)
+{
+    EXPECT_EQ (0, reply (10));
+    EXPECT_EQ (0, wInterlocked_read (&mPacer.mReplies));
+
+    recapPacer_update (&mPacer, 0, 1.0);
+    EXPECT_DOUBLE_EQ (0.0, mPacer.mReplyRate);
+}
+
+TEST_F (MamaRecapPacerTestC, SolicitedRecapCountedOnce)
+{
+    request (1);
+    EXPECT_EQ (1, wInterlocked_read (&mPacer.mOutstanding));
+
+    EXPECT_EQ (1, reply (1));
+    EXPECT_EQ (0, reply (1));
+    EXPECT_EQ (1, wInterlocked_read (&mPacer.mReplies));
+    EXPECT_EQ (0, wInterlocked_read (&mPacer.mOutstanding));
+}
+
+TEST_F (MamaRecapPacerTestC, RepeatedRequestOutstandingOnce)
+{
+    request (5);
+    request (5);
+
+    EXPECT_EQ (5, wInterlocked_read (&mPacer.mOutstanding));
+    EXPECT_EQ (5, reply (5));
+    EXPECT_EQ (0, wInterlocked_read (&mPacer.mOutstanding));
+}
+
+TEST_F (MamaRecapPacerTestC, CancelReleasesOutstanding)
+{
+    request (3);
+    recapPacer_cancel (&mPacer, &mPending[0]);
+    recapPacer_cancel (&mPacer, &mPending[0]);
+
+    EXPECT_EQ (2, wInterlocked_read (&mPacer.mOutstanding));
+
+    /* A recap arriving after the cancel is no longer solicited */
+    EXPECT_EQ (2, reply (3));
+    EXPECT_EQ (0, wInterlocked_read (&mPacer.mOutstanding));
+}
+
+TEST_F (MamaRecapPacerTestC, ReplyRateMeasuredOverElapsed)
+{
+    request (50);
+    reply (50);
+
+    recapPacer_update (&mPacer, 0, 0.5);
+
+    /* 100/s weighted into a rate that started at zero */
+    EXPECT_DOUBLE_EQ (20.0, mPacer.mReplyRate);
+
+    /* Nothing new since, so the rate decays */
+    recapPacer_update (&mPacer, 0, 0.5);
+    EXPECT_DOUBLE_EQ (16.0, mPacer.mReplyRate);
+}
+
+TEST_F (MamaRecapPacerTestC, BacksOffWhenRecapsGoUnanswered)
+{
+    request (MAX_OUTSTANDING + 1);
+
+    EXPECT_NE (0, recapPacer_update (&mPacer, 0, 0.1));
+    EXPECT_DOUBLE_EQ (MAX_RATE / 2, mPacer.mRate);
+
+    /* Answering them lets the rate grow again */
+    reply (MAX_OUTSTANDING + 1);
+    EXPECT_EQ (0, recapPacer_update (&mPacer, 0, 0.1));
+    EXPECT_LT (MAX_RATE / 2, mPacer.mRate);
+}
+
+TEST_F (MamaRecapPacerTestC, BacksOffWhenQueueDeep)
+{
+    EXPECT_NE (0, recapPacer_update (&mPacer, HIGH_WATERMARK + 1, 0.1));
+    EXPECT_DOUBLE_EQ (MAX_RATE / 2, mPacer.mRate);
+
+    for (int i = 0; i < 20; i++)
+        recapPacer_update (&mPacer, HIGH_WATERMARK + 1, 0.1);
+
+    EXPECT_DOUBLE_EQ (MIN_RATE, mPacer.mRate);
+}
+
+TEST_F (MamaRecapPacerTestC, HoldsRateBetweenWatermarks)
+{
+    mPacer.mRate = 100.0;
+
+    EXPECT_EQ (0, recapPacer_update (&mPacer, HIGH_WATERMARK / 2 + 1, 0.1));
+    EXPECT_DOUBLE_EQ (100.0, mPacer.mRate);
+}
+
+TEST_F (MamaRecapPacerTestC, GrowthFollowsReplyRate)
+{
+    mPacer.mRate = MIN_RATE;
+
+    /* With no replies the rate grows by the minimum step */
+    recapPacer_update (&mPacer, 0, 1.0);
+    EXPECT_DOUBLE_EQ (2 * MIN_RATE, mPacer.mRate);
+
+    /* 500 replies/s smooths to 100/s, growing the rate by 20 */
+    request (50);
+    reply (50);
+    recapPacer_update (&mPacer, 0, 0.1);
+    EXPECT_DOUBLE_EQ (2 * MIN_RATE + 20.0, mPacer.mRate);
+
+    for (int i = 0; i < 1000; i++)
+        recapPacer_update (&mPacer, 0, 0.1);
+
+    EXPECT_DOUBLE_EQ (MAX_RATE, mPacer.mRate);
+}
+
+TEST_F (MamaRecapPacerTestC, RefillsForElapsedUpToBurst)
+{
+    recapPacer_consume (&mPacer, (unsigned long)BURST);
+    EXPECT_EQ (0u, recapPacer_getBudget (&mPacer, 0));
+
+    /* Held between the watermarks, so the rate stays at 100/s */
+    mPacer.mRate = 100.0;
+    recapPacer_update (&mPacer, HIGH_WATERMARK / 2, 0.25);
+    EXPECT_EQ (25u, recapPacer_getBudget (&mPacer, 0));
+
+    recapPacer_update (&mPacer, HIGH_WATERMARK / 2, 10.0);
+    EXPECT_EQ ((unsigned long)BURST, recapPacer_getBudget (&mPacer, 0));
+}
+
+TEST_F (MamaRecapPacerTestC, BudgetLessQueueDepth)
+{
+    EXPECT_EQ ((unsigned long)BURST - 40, recapPacer_getBudget (&mPacer, 40));
+    EXPECT_EQ (0u, recapPacer_getBudget (&mPacer, (unsigned long)BURST));
+    EXPECT_EQ (0u, recapPacer_getBudget (&mPacer, 1000));
+}
+
+TEST_F (MamaRecapPacerTestC, ConsumeNeverOverdraws)
+{
+    recapPacer_consume (&mPacer, 1000);
+
+    EXPECT_DOUBLE_EQ (0.0, mPacer.mTokens);
+    EXPECT_EQ (0u, recapPacer_getBudget (&mPacer, 0));
+}
+
+TEST_F (MamaRecapPacerTestC, IgnoresEmptyInterval)
+{
+    request (MAX_OUTSTANDING + 1);
+
+    EXPECT_EQ (0, recapPacer_update (&mPacer, 0, 0.0));
+    EXPECT_DOUBLE_EQ (MAX_RATE, mPacer.mRate);
+}
@@ -0,0 +1,238 @@
+/*
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#include <gtest/gtest.h>
+#include "mama/mama.h"
+#include "MainUnitTestC.h"
+#include "bridge/shm/ring.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+class ShmRingTests : public ::testing::Test
+{
+protected:
+    ShmRingTests(void);
+    virtual ~ShmRingTests(void);
+
+    virtual void SetUp(void);
+    virtual void TearDown(void);
+
+    /* Whether the shared memory object for the ring still exists */
+    bool exists (void);
+
+    /* Claims, fills and commits a frame holding the value given */
+    void publish (shmRing* ring, uint32_t value);
+
+    char        mName[64];
+    shmRing*    mRing;
+};
+
+ShmRingTests::ShmRingTests(void)
+    : mRing (NULL)
+{
+}
+
+ShmRingTests::~ShmRingTests(void)
+{
+}
+
+void ShmRingTests::SetUp(void)
+{
+    /* Unique per process so concurrent test runs do not share rings */
+    snprintf (mName, sizeof (mName), "/mama_shm_ringtest_%d", (int) getpid ());
+    shm_unlink (mName);
+}
+
+void ShmRingTests::TearDown(void)
+{
+    if (NULL != mRing)
+    {
+        shmRing_close (mRing);
+    }
+    shm_unlink (mName);
+}
+
+bool ShmRingTests::exists (void)
+{
+    int fd = shm_open (mName, O_RDONLY, 0);
+
+    if (-1 == fd)
+    {
+        return false;
+    }
+    close (fd);
+    return true;
+}
+
+void ShmRingTests::publish (shmRing* ring, uint32_t value)
+{
+    uint64_t sequence = 0;
+    void*    buffer   = NULL;
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               shmRing_claim (ring, sizeof (value), &sequence, &buffer));
+    memcpy (buffer, &value, sizeof (value));
+    shmRing_commit (ring, sequence);
+}
+
+
+/* ************************************************************************* */
+/* Tests */
+/* ************************************************************************* */
+TEST_F(ShmRingTests, PublishAndRead)
+{
+    const void* frame  = NULL;
+    uint32_t    length = 0;
+    uint64_t    lost   = 0;
+    uint64_t    cursor = 0;
+    uint32_t    value  = 0;
+
+    ASSERT_EQ (MAMA_STATUS_OK, shmRing_open (&mRing, mName, 8, 64));
+    cursor = shmRing_getNextSequence (mRing);
+
+    EXPECT_EQ (SHM_RING_READ_EMPTY,
+               shmRing_peek (mRing, &cursor, &frame, &length, &lost));
+
+    publish (mRing, 42);
+
+    ASSERT_EQ (SHM_RING_READ_OK,
+               shmRing_peek (mRing, &cursor, &frame, &length, &lost));
+    ASSERT_EQ (sizeof (value), length);
+    memcpy (&value, frame, sizeof (value));
+    EXPECT_EQ (SHM_RING_READ_OK, shmRing_release (mRing, &cursor));
+    EXPECT_EQ (42u, value);
+
+    EXPECT_EQ (SHM_RING_READ_EMPTY,
+               shmRing_peek (mRing, &cursor, &frame, &length, &lost));
+}
+
+TEST_F(ShmRingTests, FrameTooLargeRejected)
+{
+    uint64_t sequence = 0;
+    void*    buffer   = NULL;
+
+    ASSERT_EQ (MAMA_STATUS_OK, shmRing_open (&mRing, mName, 8, 64));
+
+    EXPECT_EQ (MAMA_STATUS_INVALID_ARG,
+               shmRing_claim (mRing, shmRing_getMaxFrameSize (mRing) + 1,
+                              &sequence, &buffer));
+}
+
+TEST_F(ShmRingTests, LappedReaderLosesFrames)
+{
+    const void* frame  = NULL;
+    uint32_t    length = 0;
+    uint64_t    lost   = 0;
+    uint64_t    cursor = 0;
+    uint32_t    value  = 0;
+    uint32_t    i      = 0;
+
+    ASSERT_EQ (MAMA_STATUS_OK, shmRing_open (&mRing, mName, 8, 64));
+    cursor = shmRing_getNextSequence (mRing);
+
+    for (i = 0; i < 20; i++)
+    {
+        publish (mRing, i);
+    }
+
+    /* The reader skips to the head as everything behind it is overwritten */
+    ASSERT_EQ (SHM_RING_READ_OVERRUN,
+               shmRing_peek (mRing, &cursor, &frame, &length, &lost));
+    EXPECT_EQ (20u, lost);
+    EXPECT_EQ (SHM_RING_READ_EMPTY,
+               shmRing_peek (mRing, &cursor, &frame, &length, &lost));
+
+    publish (mRing, 99);
+
+    ASSERT_EQ (SHM_RING_READ_OK,
+               shmRing_peek (mRing, &cursor, &frame, &length, &lost));
+    memcpy (&value, frame, sizeof (value));
+    EXPECT_EQ (SHM_RING_READ_OK, shmRing_release (mRing, &cursor));
+    EXPECT_EQ (99u, value);
+}
+
+TEST_F(ShmRingTests, SecondOpenSharesRing)
+{
+    shmRing*    other  = NULL;
+    const void* frame  = NULL;
+    uint32_t    length = 0;
+    uint64_t    lost   = 0;
+    uint64_t    cursor = 0;
+    uint32_t    value  = 0;
+
+    ASSERT_EQ (MAMA_STATUS_OK, shmRing_open (&mRing, mName, 8, 64));
+
+    /* The existing geometry wins over the one requested */
+    ASSERT_EQ (MAMA_STATUS_OK, shmRing_open (&other, mName, 32, 128));
+    EXPECT_EQ (shmRing_getMaxFrameSize (mRing),
+               shmRing_getMaxFrameSize (other));
+
+    cursor = shmRing_getNextSequence (other);
+    publish (mRing, 7);
+
+    ASSERT_EQ (SHM_RING_READ_OK,
+               shmRing_peek (other, &cursor, &frame, &length, &lost));
+    memcpy (&value, frame, sizeof (value));
+    EXPECT_EQ (SHM_RING_READ_OK, shmRing_release (other, &cursor));
+    EXPECT_EQ (7u, value);
+
+    EXPECT_EQ (MAMA_STATUS_OK, shmRing_close (other));
+}
+
+TEST_F(ShmRingTests, LastCloseUnlinks)
+{
+    shmRing* other = NULL;
+
+    ASSERT_EQ (MAMA_STATUS_OK, shmRing_open (&mRing, mName, 8, 64));
+    ASSERT_EQ (MAMA_STATUS_OK, shmRing_open (&other, mName, 8, 64));
+    EXPECT_TRUE (exists ());
+
+    EXPECT_EQ (MAMA_STATUS_OK, shmRing_close (other));
+    EXPECT_TRUE (exists ());
+
+    EXPECT_EQ (MAMA_STATUS_OK, shmRing_close (mRing));
+    mRing = NULL;
+    EXPECT_FALSE (exists ());
+}
+
+TEST_F(ShmRingTests, ReopenAfterUnlinkCreatesNewRing)
+{
+    ASSERT_EQ (MAMA_STATUS_OK, shmRing_open (&mRing, mName, 8, 64));
+    publish (mRing, 1);
+    EXPECT_EQ (1u, shmRing_getNextSequence (mRing));
+
+    EXPECT_EQ (MAMA_STATUS_OK, shmRing_close (mRing));
+    mRing = NULL;
+
+    ASSERT_EQ (MAMA_STATUS_OK, shmRing_open (&mRing, mName, 8, 64));
+    EXPECT_EQ (0u, shmRing_getNextSequence (mRing));
+}
+
+TEST_F(ShmRingTests, OpenNullArgs)
+{
+    EXPECT_EQ (MAMA_STATUS_NULL_ARG, shmRing_open (NULL, mName, 8, 64));
+    EXPECT_EQ (MAMA_STATUS_NULL_ARG, shmRing_open (&mRing, NULL, 8, 64));
+    EXPECT_EQ (MAMA_STATUS_NULL_ARG, shmRing_close (NULL));
+}
@@ -0,0 +1,177 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#include <gtest/gtest.h>
+#include "MainUnitTestC.h"
+#include "mama/mama.h"
+#include "mama/stat.h"
+#include "statinternal.h"
+#include "wombat/wincompat.h"
+
+class MamaStatTestC : public ::testing::Test
+{
+protected:
+    MamaStatTestC();
+    virtual ~MamaStatTestC();
+
+    virtual void SetUp();
+    virtual void TearDown ();
+
+    mamaStat mStat;
+};
+
+MamaStatTestC::MamaStatTestC()
+    : mStat (NULL)
+{
+}
+
+MamaStatTestC::~MamaStatTestC()
+{
+}
+
+void MamaStatTestC::SetUp(void)
+{
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaStat_create (&mStat, NULL, MAMA_STAT_SHARDED,
+                                "Sharded", MAMA_STAT_TYPE_NUM_MESSAGES));
+}
+
+void MamaStatTestC::TearDown(void)
+{
+    mamaStat_destroy (mStat);
+    mamaStat_setShardLockable (0);
+}
+
+static const int STAT_THREADS    = 8;
+static const int STAT_INCREMENTS = 20000;
+
+static void* incrementStat (void* closure)
+{
+    mamaStat stat = (mamaStat) closure;
+    int      i;
+
+    for (i = 0; i < STAT_INCREMENTS; ++i)
+    {
+        mamaStat_increment (stat);
+    }
+    return NULL;
+}
+
+/* Updates from one thread are folded in when the stat is read. */
+TEST_F (MamaStatTestC, ShardedValuesCollectedOnRead)
+{
+    mama_i32_t interval = 0;
+    mama_u32_t max      = 0;
+    mama_u32_t total    = 0;
+
+    mamaStat_increment (mStat);
+    mamaStat_increment (mStat);
+    mamaStat_add       (mStat, 5);
+    mamaStat_decrement (mStat);
+    mamaStat_subtract  (mStat, 2);
+
+    EXPECT_EQ (4, mamaStat_getIntervalValue (mStat));
+    EXPECT_EQ (4, mamaStat_getTotalValue (mStat));
+    EXPECT_EQ (4, mamaStat_getMaxValue (mStat));
+
+    mamaStat_getStats (mStat, &interval, &max, &total);
+    EXPECT_EQ (4,  interval);
+    EXPECT_EQ (4u, max);
+    EXPECT_EQ (4u, total);
+}
+
+/* Every thread's updates are counted, whichever shard they land in. */
+TEST_F (MamaStatTestC, ShardedAggregatesAcrossThreads)
+{
+    wthread_t threads[STAT_THREADS];
+    int       i;
+
+    for (i = 0; i < STAT_THREADS; ++i)
+    {
+        ASSERT_EQ (0, wthread_create (&threads[i], NULL, incrementStat, mStat));
+    }
+
+    /* Reading while threads update must not lose anything. */
+    for (i = 0; i < 100; ++i)
+    {
+        mamaStat_getTotalValue (mStat);
+    }
+
+    for (i = 0; i < STAT_THREADS; ++i)
+    {
+        wthread_join (threads[i], NULL);
+    }
+
+    EXPECT_EQ (STAT_THREADS * STAT_INCREMENTS, mamaStat_getTotalValue (mStat));
+    EXPECT_EQ (STAT_THREADS * STAT_INCREMENTS, mamaStat_getIntervalValue (mStat));
+    EXPECT_EQ (STAT_THREADS * STAT_INCREMENTS, mamaStat_getMaxValue (mStat));
+}
+
+/* A reset starts a new interval but keeps the total and the maximum. */
+TEST_F (MamaStatTestC, ShardedResetStartsNewInterval)
+{
+    mamaStat_add (mStat, 5);
+    ASSERT_EQ (MAMA_STATUS_OK, mamaStat_reset (mStat));
+
+    mamaStat_add (mStat, 3);
+
+    EXPECT_EQ (3, mamaStat_getIntervalValue (mStat));
+    EXPECT_EQ (8, mamaStat_getTotalValue (mStat));
+    EXPECT_EQ (5, mamaStat_getMaxValue (mStat));
+}
+
+/* Setting the interval value keeps updates made before it. */
+TEST_F (MamaStatTestC, ShardedSetIntervalValue)
+{
+    mamaStat_add (mStat, 5);
+    ASSERT_EQ (MAMA_STATUS_OK, mamaStat_setIntervalValue (mStat, 1));
+
+    mamaStat_increment (mStat);
+
+    EXPECT_EQ (2, mamaStat_getIntervalValue (mStat));
+    EXPECT_EQ (6, mamaStat_getTotalValue (mStat));
+}
+
+/* Lockable stats are sharded when asked, and count the same way. */
+TEST_F (MamaStatTestC, LockableStatsCanBeSharded)
+{
+    mamaStat  lockable = NULL;
+    wthread_t threads[STAT_THREADS];
+    int       i;
+
+    mamaStat_setShardLockable (1);
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaStat_create (&lockable, NULL, MAMA_STAT_LOCKABLE,
+                                "Lockable", MAMA_STAT_TYPE_NUM_MESSAGES));
+
+    for (i = 0; i < STAT_THREADS; ++i)
+    {
+        ASSERT_EQ (0, wthread_create (&threads[i], NULL, incrementStat, lockable));
+    }
+    for (i = 0; i < STAT_THREADS; ++i)
+    {
+        wthread_join (threads[i], NULL);
+    }
+
+    EXPECT_EQ (STAT_THREADS * STAT_INCREMENTS, mamaStat_getTotalValue (lockable));
+    mamaStat_destroy (lockable);
+}
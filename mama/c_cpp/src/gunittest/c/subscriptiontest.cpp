@@ -193,3 +193,93 @@ TEST_F (MamaSubscriptionTest, SubscriptionCreateDestroy)
         ASSERT_EQ (MAMA_STATUS_OK, mamaSubscription_deallocate (subscription));
     }
 }
+
+/*  Description:     Allocate a block of subscriptions, create them together
+ *                   against a test source, then destroy and deallocate each.
+ *
+ *  Expected Result: MAMA_STATUS_OK
+ */
+TEST_F (MamaSubscriptionTest, SubscriptionCreateBatchDestroy)
+{
+    const size_t     count = 10;
+    mamaSubscription subscriptions[count];
+    const char*      symbols[count];
+    void*            closures[count];
+    char             names[count][16];
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaSubscription_allocateBatch (subscriptions, count));
+
+    for (size_t i = 0; i < count; i++)
+    {
+        snprintf (names[i], sizeof (names[i]), "TEST_SYMBOL%u", (unsigned)i);
+        symbols[i]  = names[i];
+        closures[i] = m_this;
+    }
+
+    /* Get the default queue */
+    mama_getDefaultEventQueue (mBridge, &m_defaultQueue);
+
+    /* create a test source */
+    mamaSource testSource = NULL;
+    mamaSource_create (&testSource);
+    mamaSource_setId (testSource, "TestSource");
+    mamaSource_setTransport (testSource, m_transport);
+    mamaSource_setSymbolNamespace (testSource, "WOMBAT");
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaSubscription_createBatch (subscriptions,
+                                             count,
+                                             m_defaultQueue,
+                                             &simpleCallback,
+                                             testSource,
+                                             symbols,
+                                             closures));
+
+    for (size_t i = 0; i < count; i++)
+    {
+        ASSERT_EQ (MAMA_STATUS_OK, mamaSubscription_destroy (subscriptions[i]));
+        ASSERT_EQ (MAMA_STATUS_OK,
+                   mamaSubscription_deallocate (subscriptions[i]));
+    }
+
+    mamaSource_destroy (testSource);
+}
+
+/*  Description:     Pass invalid arguments to the batch functions.
+ *
+ *  Expected Result: MAMA_STATUS_NULL_ARG and MAMA_STATUS_INVALID_ARG
+ */
+TEST_F (MamaSubscriptionTest, SubscriptionCreateBatchInvalidArgs)
+{
+    mamaSubscription subscriptions[1];
+    const char*      symbols[1]   = { "TEST_SYMBOL" };
+
+    ASSERT_EQ (MAMA_STATUS_NULL_ARG,
+               mamaSubscription_allocateBatch (NULL, 1));
+    ASSERT_EQ (MAMA_STATUS_INVALID_ARG,
+               mamaSubscription_allocateBatch (subscriptions, 0));
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaSubscription_allocateBatch (subscriptions, 1));
+
+    mamaSource testSource = NULL;
+    mamaSource_create (&testSource);
+    mamaSource_setTransport (testSource, m_transport);
+
+    ASSERT_EQ (MAMA_STATUS_NULL_ARG,
+               mamaSubscription_createBatch (subscriptions, 1, m_defaultQueue,
+                                             &simpleCallback, NULL, symbols,
+                                             NULL));
+    ASSERT_EQ (MAMA_STATUS_NULL_ARG,
+               mamaSubscription_createBatch (subscriptions, 1, m_defaultQueue,
+                                             &simpleCallback, testSource,
+                                             NULL, NULL));
+    ASSERT_EQ (MAMA_STATUS_INVALID_ARG,
+               mamaSubscription_createBatch (subscriptions, 0, m_defaultQueue,
+                                             &simpleCallback, testSource,
+                                             symbols, NULL));
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaSubscription_deallocate (subscriptions[0]));
+    mamaSource_destroy (testSource);
+}
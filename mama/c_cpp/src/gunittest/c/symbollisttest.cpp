@@ -0,0 +1,259 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+/*  Description: These tests check member lookup and the batch add and
+ *               remove functions of mamaSymbolList.
+ */
+
+#include <gtest/gtest.h>
+#include "mama/mama.h"
+#include "mama/status.h"
+#include "mama/symbollist.h"
+#include "mama/symbollistmember.h"
+#include "MainUnitTestC.h"
+#include <cstdio>
+
+
+class MamaSymbolListTestC : public ::testing::Test
+{
+protected:
+
+    MamaSymbolListTestC(void);
+    virtual ~MamaSymbolListTestC(void);
+
+    virtual void SetUp(void);
+    virtual void TearDown(void);
+
+    mamaSymbolListMember createMember (const char*    symbol,
+                                       const char*    source,
+                                       mamaTransport  transport);
+
+public:
+    mamaSymbolList  mList;
+    int             mAdded;
+    int             mRemoved;
+    int             mBatches;
+};
+
+MamaSymbolListTestC::MamaSymbolListTestC(void)
+    : mList    (NULL)
+    , mAdded   (0)
+    , mRemoved (0)
+    , mBatches (0)
+{
+}
+
+MamaSymbolListTestC::~MamaSymbolListTestC(void)
+{
+}
+
+void MamaSymbolListTestC::SetUp(void)
+{
+    ASSERT_EQ (MAMA_STATUS_OK, mamaSymbolList_allocate (&mList));
+    mamaSymbolList_setClosure (mList, this);
+}
+
+void MamaSymbolListTestC::TearDown(void)
+{
+    mamaSymbolList_clear (mList, 1);
+    mamaSymbolList_deallocate (mList);
+}
+
+mamaSymbolListMember MamaSymbolListTestC::createMember (const char*    symbol,
+                                                       const char*    source,
+                                                       mamaTransport  transport)
+{
+    mamaSymbolListMember member = NULL;
+    mamaSymbolListMember_allocate      (mList, &member);
+    mamaSymbolListMember_setSymbol     (member, symbol);
+    mamaSymbolListMember_setSource     (member, source);
+    mamaSymbolListMember_setTransport  (member, transport);
+    return member;
+}
+
+static mama_status MAMACALLTYPE onAddSymbol (mamaSymbolListMember  symbol,
+                                             void*                 closure)
+{
+    ((MamaSymbolListTestC*)closure)->mAdded++;
+    return MAMA_STATUS_OK;
+}
+
+static mama_status MAMACALLTYPE onAddSymbols (mamaSymbolListMember* symbols,
+                                              mama_size_t           numSymbols,
+                                              void*                 closure)
+{
+    ((MamaSymbolListTestC*)closure)->mAdded += (int)numSymbols;
+    ((MamaSymbolListTestC*)closure)->mBatches++;
+    return MAMA_STATUS_OK;
+}
+
+static mama_status MAMACALLTYPE onRemoveSymbols (mamaSymbolListMember* symbols,
+                                                 mama_size_t           numSymbols,
+                                                 void*                 closure)
+{
+    ((MamaSymbolListTestC*)closure)->mRemoved += (int)numSymbols;
+    ((MamaSymbolListTestC*)closure)->mBatches++;
+    return MAMA_STATUS_OK;
+}
+
+/* ************************************************************************* */
+/* Tests */
+/* ************************************************************************* */
+
+/*  Description:     Members with the same source and transport are told apart
+ *                   by their symbol, and by transport for the same names.
+ *
+ *  Expected Result: MAMA_STATUS_OK for members present,
+ *                   MAMA_STATUS_INVALID_ARG otherwise.
+ */
+TEST_F (MamaSymbolListTestC, FindMember)
+{
+    mamaTransport        tport1 = (mamaTransport)NOT_NULL;
+    mamaTransport        tport2 = (mamaTransport)&mList;
+    mamaSymbolListMember ibm    = createMember ("IBM", "SRC", tport1);
+    mamaSymbolListMember msft   = createMember ("MSFT", "SRC", tport1);
+    mamaSymbolListMember result = NULL;
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaSymbolList_addMember (mList, ibm));
+    ASSERT_EQ (MAMA_STATUS_OK, mamaSymbolList_addMember (mList, msft));
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaSymbolList_findMember (mList, "MSFT", "SRC", tport1, &result));
+    ASSERT_EQ (msft, result);
+
+    ASSERT_EQ (MAMA_STATUS_INVALID_ARG,
+               mamaSymbolList_findMember (mList, "MSFT", "SRC", tport2, &result));
+    ASSERT_EQ (NULL, result);
+
+    ASSERT_EQ (MAMA_STATUS_INVALID_ARG,
+               mamaSymbolList_findMember (mList, "MSFT", "OTHER", tport1, &result));
+}
+
+/*  Description:     A second member with the same key is found once the first
+ *                   has been removed.
+ *
+ *  Expected Result: MAMA_STATUS_OK
+ */
+TEST_F (MamaSymbolListTestC, DuplicateMember)
+{
+    mamaTransport        tport  = (mamaTransport)NOT_NULL;
+    mamaSymbolListMember first  = createMember ("IBM", "SRC", tport);
+    mamaSymbolListMember second = createMember ("IBM", "SRC", tport);
+    mamaSymbolListMember result = NULL;
+
+    mamaSymbolList_addMember (mList, first);
+    mamaSymbolList_addMember (mList, second);
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaSymbolList_removeMember (mList, "IBM", "SRC", tport, &result));
+    ASSERT_EQ (first, result);
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaSymbolList_findMember (mList, "IBM", "SRC", tport, &result));
+    ASSERT_EQ (second, result);
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaSymbolList_removeMemberByRef (mList, second));
+    ASSERT_EQ (MAMA_STATUS_INVALID_ARG,
+               mamaSymbolList_findMember (mList, "IBM", "SRC", tport, &result));
+}
+
+/*  Description:     Add and remove batches of members, the batch handlers are
+ *                   invoked once per batch and lookups work as the index grows.
+ *
+ *  Expected Result: MAMA_STATUS_OK
+ */
+TEST_F (MamaSymbolListTestC, AddRemoveMembers)
+{
+    const int               numMembers = 10000;
+    mamaTransport           tport      = (mamaTransport)NOT_NULL;
+    mamaSymbolListMember*   members    = new mamaSymbolListMember[numMembers];
+    mamaSymbolListMember    result     = NULL;
+    unsigned long           size       = 0;
+    char                    symbol[32];
+
+    for (int i = 0; i < numMembers; i++)
+    {
+        snprintf (symbol, sizeof (symbol), "SYM%d", i);
+        members[i] = createMember (symbol, "SRC", tport);
+    }
+
+    mamaSymbolList_setAddSymbolsHandler    (mList, onAddSymbols);
+    mamaSymbolList_setRemoveSymbolsHandler (mList, onRemoveSymbols);
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaSymbolList_addMembers (mList, members, numMembers));
+    ASSERT_EQ (numMembers, mAdded);
+    ASSERT_EQ (1, mBatches);
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaSymbolList_findMember (mList, "SYM9999", "SRC", tport, &result));
+    ASSERT_EQ (members[9999], result);
+
+    ASSERT_EQ (MAMA_STATUS_OK,
+               mamaSymbolList_removeMembersByRef (mList, members, numMembers / 2));
+    ASSERT_EQ (numMembers / 2, mRemoved);
+    ASSERT_EQ (2, mBatches);
+
+    ASSERT_EQ (MAMA_STATUS_INVALID_ARG,
+               mamaSymbolList_findMember (mList, "SYM0", "SRC", tport, &result));
+
+    mamaSymbolList_getSize (mList, &size);
+    ASSERT_EQ ((unsigned long)(numMembers / 2), size);
+
+    delete [] members;
+}
+
+/*  Description:     Without a batch handler the per member handler is invoked
+ *                   for each member of the batch.
+ *
+ *  Expected Result: The add handler is invoked for every member.
+ */
+TEST_F (MamaSymbolListTestC, AddMembersPerMemberHandler)
+{
+    mamaTransport        tport = (mamaTransport)NOT_NULL;
+    mamaSymbolListMember members[3];
+
+    members[0] = createMember ("A", "SRC", tport);
+    members[1] = createMember ("B", "SRC", tport);
+    members[2] = createMember ("C", "SRC", tport);
+
+    mamaSymbolList_setAddSymbolHandler (mList, onAddSymbol);
+
+    ASSERT_EQ (MAMA_STATUS_OK, mamaSymbolList_addMembers (mList, members, 3));
+    ASSERT_EQ (3, mAdded);
+    ASSERT_EQ (0, mBatches);
+}
+
+/*  Description:     Bulk functions reject NULL arguments.
+ *
+ *  Expected Result: MAMA_STATUS_NULL_ARG
+ */
+TEST_F (MamaSymbolListTestC, BatchNullArgs)
+{
+    mamaSymbolListMember member = NULL;
+
+    ASSERT_EQ (MAMA_STATUS_NULL_ARG, mamaSymbolList_addMembers (NULL, &member, 1));
+    ASSERT_EQ (MAMA_STATUS_NULL_ARG, mamaSymbolList_addMembers (mList, NULL, 1));
+    ASSERT_EQ (MAMA_STATUS_NULL_ARG,
+               mamaSymbolList_removeMembersByRef (NULL, &member, 1));
+    ASSERT_EQ (MAMA_STATUS_NULL_ARG,
+               mamaSymbolList_removeMembersByRef (mList, NULL, 1));
+}
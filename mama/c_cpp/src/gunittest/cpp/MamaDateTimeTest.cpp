@@ -147,3 +147,35 @@ TEST_F(MamaDateTimeTest, SetDateTimezoneCheck)
     ASSERT_EQ(dt1.getEpochTimeMicroseconds(), dt2.getEpochTimeMicroseconds());
 }
 
+
+TEST_F(MamaDateTimeTest, NanosecondsSurviveCopy)
+{
+    MamaDateTime dt1;
+    dt1.setEpochTimeNanoseconds(1440288000123456789ULL);
+    ASSERT_EQ(1440288000123456789ULL, dt1.getEpochTimeNanoseconds());
+    ASSERT_EQ(123456789u, dt1.getNanosecond());
+
+    MamaDateTime dt2(dt1);
+    ASSERT_EQ(1440288000123456789ULL, dt2.getEpochTimeNanoseconds());
+
+    MamaDateTime dt3;
+    dt3 = dt1;
+    ASSERT_EQ(1440288000123456789ULL, dt3.getEpochTimeNanoseconds());
+    ASSERT_TRUE(dt1 == dt3);
+}
+
+TEST_F(MamaDateTimeTest, CopiesHaveOwnStorage)
+{
+    // The storage is held inline, so clearing the original leaves copies.
+    MamaDateTime dt1;
+    dt1.setEpochTimeNanoseconds(1000000123ULL);
+
+    MamaDateTime dt2(dt1);
+    MamaDateTime dt3;
+    dt3 = dt1;
+    dt1.clear();
+
+    ASSERT_EQ(1000000123ULL, dt2.getEpochTimeNanoseconds());
+    ASSERT_EQ(1000000123ULL, dt3.getEpochTimeNanoseconds());
+    ASSERT_NE(dt1.getCValue(), dt2.getCValue());
+}
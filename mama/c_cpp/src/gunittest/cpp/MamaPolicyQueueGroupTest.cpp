@@ -0,0 +1,197 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+/* ************************************************************************* */
+/* Includes */
+/* ************************************************************************* */
+#include "MamaPolicyQueueGroupTest.h"
+#include <cstdio>
+#include <set>
+
+/* ************************************************************************* */
+/* Construction and Destruction */
+/* ************************************************************************* */
+
+MamaPolicyQueueGroupTest::MamaPolicyQueueGroupTest(void)
+    : m_bridge (NULL)
+{
+}
+
+MamaPolicyQueueGroupTest::~MamaPolicyQueueGroupTest(void)
+{
+}
+
+/* ************************************************************************* */
+/* Setup and Teardown */
+/* ************************************************************************* */
+
+void MamaPolicyQueueGroupTest::SetUp(void)
+{
+    m_bridge = Mama::loadBridge(getMiddleware());
+    Mama::open();
+}
+
+void MamaPolicyQueueGroupTest::TearDown(void)
+{
+    Mama::close();
+}
+
+/* ************************************************************************* */
+/* Tests */
+/* ************************************************************************* */
+
+TEST_F(MamaPolicyQueueGroupTest, SymbolQueueIndexInRangeAndStable)
+{
+    char symbol[16];
+
+    for (int i = 0; i < 1000; i++)
+    {
+        snprintf(symbol, sizeof(symbol), "SYM%d", i);
+
+        int index = MamaPolicyQueueGroup::getSymbolQueueIndex(symbol, 7);
+        ASSERT_GE(index, 0);
+        ASSERT_LT(index, 7);
+        ASSERT_EQ(index, MamaPolicyQueueGroup::getSymbolQueueIndex(symbol, 7));
+    }
+}
+
+TEST_F(MamaPolicyQueueGroupTest, SymbolQueueIndexOnlyMovesToNewQueue)
+{
+    char symbol[16];
+    int  moved = 0;
+
+    // Growing from 4 to 5 queues may only move symbols onto the new queue
+    for (int i = 0; i < 1000; i++)
+    {
+        snprintf(symbol, sizeof(symbol), "SYM%d", i);
+
+        int before = MamaPolicyQueueGroup::getSymbolQueueIndex(symbol, 4);
+        int after  = MamaPolicyQueueGroup::getSymbolQueueIndex(symbol, 5);
+
+        if (before != after)
+        {
+            ASSERT_EQ(4, after);
+            moved++;
+        }
+    }
+
+    // About a fifth of the symbols move
+    ASSERT_GT(moved, 100);
+    ASSERT_LT(moved, 300);
+}
+
+TEST_F(MamaPolicyQueueGroupTest, NoQueuesReturnsDefaultQueue)
+{
+    MamaPolicyQueueGroup group(0, m_bridge,
+                               MamaPolicyQueueGroup::POLICY_SYMBOL_HASH);
+
+    ASSERT_EQ(0, group.getNumberOfQueues());
+    ASSERT_EQ(Mama::getDefaultEventQueue(m_bridge), group.getNextQueue());
+    ASSERT_EQ(Mama::getDefaultEventQueue(m_bridge), group.getNextQueue("A"));
+}
+
+TEST_F(MamaPolicyQueueGroupTest, RoundRobinCyclesQueues)
+{
+    MamaPolicyQueueGroup group(3, m_bridge,
+                               MamaPolicyQueueGroup::POLICY_ROUND_ROBIN);
+
+    MamaQueue* first  = group.getNextQueue();
+    MamaQueue* second = group.getNextQueue();
+    MamaQueue* third  = group.getNextQueue();
+
+    ASSERT_NE(first, second);
+    ASSERT_NE(second, third);
+    ASSERT_NE(first, third);
+    ASSERT_EQ(first, group.getNextQueue("A"));
+
+    group.destroyWait();
+}
+
+TEST_F(MamaPolicyQueueGroupTest, LeastLoadedSpreadsIdleQueues)
+{
+    MamaPolicyQueueGroup group(4, m_bridge,
+                               MamaPolicyQueueGroup::POLICY_LEAST_LOADED);
+    std::set<MamaQueue*> queues;
+
+    // With no backlog every queue is handed out before any is reused
+    for (int i = 0; i < 4; i++)
+    {
+        queues.insert(group.getNextQueue());
+    }
+    ASSERT_EQ(4u, queues.size());
+
+    group.destroyWait();
+}
+
+TEST_F(MamaPolicyQueueGroupTest, SymbolHashKeepsSymbolOnItsQueue)
+{
+    MamaPolicyQueueGroup group(4, m_bridge,
+                               MamaPolicyQueueGroup::POLICY_SYMBOL_HASH);
+
+    MamaQueue* queue = group.getNextQueue("IBM");
+    for (int i = 0; i < 10; i++)
+    {
+        ASSERT_EQ(queue, group.getNextQueue("IBM"));
+    }
+
+    // Symbols which hash to the same index share a queue
+    char symbol[16];
+    int  target = MamaPolicyQueueGroup::getSymbolQueueIndex("IBM", 4);
+    for (int i = 0; i < 100; i++)
+    {
+        snprintf(symbol, sizeof(symbol), "SYM%d", i);
+        if (MamaPolicyQueueGroup::getSymbolQueueIndex(symbol, 4) == target)
+        {
+            ASSERT_EQ(queue, group.getNextQueue(symbol));
+        }
+        else
+        {
+            ASSERT_NE(queue, group.getNextQueue(symbol));
+        }
+    }
+
+    group.destroyWait();
+}
+
+TEST_F(MamaPolicyQueueGroupTest, SymbolAffineKeepsPlacement)
+{
+    MamaPolicyQueueGroup group(3, m_bridge,
+                               MamaPolicyQueueGroup::POLICY_SYMBOL_AFFINE);
+    std::set<MamaQueue*> queues;
+
+    MamaQueue* a = group.getNextQueue("A");
+    MamaQueue* b = group.getNextQueue("B");
+    MamaQueue* c = group.getNextQueue("C");
+
+    queues.insert(a);
+    queues.insert(b);
+    queues.insert(c);
+    ASSERT_EQ(3u, queues.size());
+
+    // Idle queues are never overloaded, so rebalance keeps the placements
+    group.rebalance();
+
+    ASSERT_EQ(a, group.getNextQueue("A"));
+    ASSERT_EQ(b, group.getNextQueue("B"));
+    ASSERT_EQ(c, group.getNextQueue("C"));
+
+    group.destroyWait();
+}
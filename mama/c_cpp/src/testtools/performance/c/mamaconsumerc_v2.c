@@ -204,6 +204,8 @@ static symbol*              gSymbolList         = NULL;
 
 static int                  gTransportCallbacks = 0;
 static int                  gThreads            = 1;
+static const char*          gQueuePolicy        = "rr";
+static size_t*              gQueueAssigned      = NULL;
 static int                  gBasicSub           = 1;
 static int                  gRequiresInitial    = 1;
 static int                  gStatsOnTimers      = 0;
@@ -307,6 +309,7 @@ static const char *     gUsageString[] =
 "    [-t X]                 Output interval for stats; default is every 1 sec.",
 "    [-tc]                  Register transport callbacks.",
 "    [-threads X]           Number of event queue threads to use in addition to the default queue; default is 1 additional queue.",
+"    [-queuepolicy policy]  How subscriptions are spread across -threads queues: rr (round robin), load (fewest pending events) or hash (by symbol); default is rr.",
 "    [-throttle X]          Throttles subscriptions at a rate of X per second.",
 "    [-total]               Calculates the min, average and max total latency.",
 "    [-tport name]          The transport parameters to be used from mama.properties.",
@@ -339,6 +342,8 @@ static void parseSymbols (void);
 
 static void subscribeToSymbols (void);
 
+static size_t selectQueue (size_t index, const char* topic);
+
 static void subscriptionOnCreate
 (   mamaSubscription        subscription,
     void*                   closure
@@ -1273,6 +1278,7 @@ static void consumerShutdown (void)
             MAMA_CHECK (mamaQueue_destroyWait (gQueues[i]));
         }
         free (gQueues);
+        free (gQueueAssigned);
     }
     if (gDisplayQueue != NULL)
     {
@@ -1508,6 +1514,7 @@ static void initializeMama (const char*     middleware)
     if (gThreads > 0)
     {
         gQueues      = (mamaQueue*) calloc (gThreads, sizeof (mamaQueue));
+        gQueueAssigned = (size_t*) calloc (gThreads, sizeof (size_t));
         gDispatchers = (mamaDispatcher*) calloc (gThreads,
                                                  sizeof (mamaDispatcher));
 
@@ -1591,6 +1598,72 @@ static void findSourceInList
     }
 }
 
+/*
+ * Jump consistent hash (Lamping and Veach) of the FNV-1a hash of the topic.
+ * This is the mapping MamaPolicyQueueGroup::POLICY_SYMBOL_HASH uses, so a
+ * symbol lands on the same queue index here as it does in the C++ API, and
+ * changing -threads from n to n + 1 only moves 1 / (n + 1) of the symbols.
+ */
+static size_t hashQueue (const char* topic, int buckets)
+{
+    uint64_t key = 14695981039346656037ULL;
+    int64_t  b   = -1;
+    int64_t  j   = 0;
+
+    while (*topic)
+    {
+        key ^= (unsigned char)*topic++;
+        key *= 1099511628211ULL;
+    }
+
+    while (j < buckets)
+    {
+        b   = j;
+        key = key * 2862933555777941757ULL + 1;
+        j   = (int64_t)((b + 1) * ((double)(1LL << 31) /
+                                   (double)((key >> 33) + 1)));
+    }
+    return (size_t)b;
+}
+
+/*
+ * Choose the queue for a symbol according to -queuepolicy. "load" prefers the
+ * queue with the fewest pending events, then the one with fewest symbols;
+ * "hash" keeps a symbol on the same queue from run to run.
+ */
+static size_t selectQueue (size_t index, const char* topic)
+{
+    size_t best = index % gThreads;
+
+    if (strcmp (gQueuePolicy, "hash") == 0)
+    {
+        best = hashQueue (topic, gThreads);
+    }
+    else if (strcmp (gQueuePolicy, "load") == 0)
+    {
+        size_t bestPending = 0;
+        size_t q           = 0;
+
+        mamaQueue_getEventCount (gQueues[best], &bestPending);
+        for (q = 0; q < (size_t)gThreads; ++q)
+        {
+            size_t pending = 0;
+            mamaQueue_getEventCount (gQueues[q], &pending);
+
+            if (pending < bestPending ||
+                (pending == bestPending &&
+                 gQueueAssigned[q] < gQueueAssigned[best]))
+            {
+                best        = q;
+                bestPending = pending;
+            }
+        }
+    }
+
+    gQueueAssigned[best]++;
+    return best;
+}
+
 static void subscribeToSymbols (void)
 {
     unsigned nsecSleep = gThrottle != -1 ? 1000000000 / gThrottle : 0;
@@ -1634,9 +1707,9 @@ static void subscribeToSymbols (void)
         else
             callbacks.onMsg         = onMsg;
 
-        /* If there is more than one queue round robin accross them */
+        /* If there is more than one queue spread the symbols accross them */
         localQueue = gQueues ==
-            NULL ? gDefaultQueue : gQueues[i % gThreads];
+            NULL ? gDefaultQueue : gQueues[selectQueue (i, gSymbolList[i].mTopic)];
 
         if (i == gMaxSubscriptions-1)
         {
@@ -1710,6 +1783,15 @@ static void subscribeToSymbols (void)
         }
     }
 
+    if (gQueues != NULL && gThreads > 1)
+    {
+        for (i = 0; i < (size_t)gThreads; ++i)
+        {
+            fprintf (gFilep, "Queue %lu: %lu symbols (%s)\n",
+                     (unsigned long) i, (unsigned long) gQueueAssigned[i],
+                     gQueuePolicy);
+        }
+    }
 }
 
 static void subscriptionOnDestroy
@@ -2901,6 +2983,11 @@ static void parseCommandLine
                 gThreads = atoi (argv[i + 1]);
                 i += 2;
             }
+            else if (strcmp (argv[i], "-queuepolicy") == 0)
+            {
+                gQueuePolicy = argv[i + 1];
+                i += 2;
+            }
             else if (strcmp (argv[i], "-start-stats") == 0)
             {
                 gStartLogging = atoi (argv[i + 1]);
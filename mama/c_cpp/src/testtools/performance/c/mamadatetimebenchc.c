@@ -0,0 +1,212 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+/*
+ * Microbenchmark of mamaDateTime string formatting and parsing against the
+ * C library calls they used to be built on (gmtime_r()/strftime() and
+ * strtoul()/timegm()).  Needs no middleware.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "mama/mama.h"
+
+#define DEFAULT_ITERATIONS      1000000
+#define NUM_TIMES               1024
+
+static const char *         gUsageString[] =
+{
+"mamadatetimebenchc",
+"Usage: mamadatetimebenchc [OPTIONS]",
+"Times mamaDateTime formatting and parsing against gmtime_r/strftime and",
+"strtoul/timegm, in nanoseconds per call.",
+"",
+"OPTIONS",
+"      [-h|-?|--help]  Show this help message.",
+"      [-n count]      Number of calls per benchmark; default is 1000000.",
+NULL
+};
+
+static mama_u32_t           gSeconds[NUM_TIMES];
+static mama_u32_t           gMicros[NUM_TIMES];
+static char                 gStrings[NUM_TIMES][32];
+
+/* Defeats the optimiser */
+static volatile unsigned    gSink = 0;
+
+static void usage (int exitStatus)
+{
+    int i = 0;
+    while (NULL != gUsageString[i])
+    {
+        printf ("%s\n", gUsageString[i++]);
+    }
+    exit (exitStatus);
+}
+
+static double nowNanos (void)
+{
+    struct timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void report (const char* name, double start, double end, long count)
+{
+    printf ("%-36s %10.1f ns/call\n", name, (end - start) / count);
+}
+
+/* The formatting mamaDateTime_getAsString() used to do */
+static void libcAsString (mama_u32_t seconds, mama_u32_t micros, char* buf,
+                          size_t len)
+{
+    time_t    clock = seconds;
+    struct tm tmValue;
+    size_t    used;
+
+    gmtime_r (&clock, &tmValue);
+    used = strftime (buf, len, "%Y-%m-%d %H:%M:%S", &tmValue);
+    snprintf (buf + used, len - used, ".%06u", micros);
+}
+
+/* The parsing mamaDateTime_setFromString() used to do */
+static time_t libcFromString (const char* str, mama_u32_t* micros)
+{
+    struct tm   tmValue;
+    const char* colon = strchr (str, ':');
+    const char* dot   = strchr (str, '.');
+
+    memset (&tmValue, 0, sizeof (tmValue));
+    tmValue.tm_year = strtoul (str, NULL, 10) - 1900;
+    tmValue.tm_mon  = strtoul (strchr (str, '-') + 1, NULL, 10) - 1;
+    tmValue.tm_mday = strtoul (strrchr (str, '-') + 1, NULL, 10);
+    tmValue.tm_hour = strtoul (colon - 2, NULL, 10);
+    tmValue.tm_min  = strtoul (colon + 1, NULL, 10);
+    tmValue.tm_sec  = strtoul (strchr (colon + 1, ':') + 1, NULL, 10);
+    *micros         = dot ? strtoul (dot + 1, NULL, 10) : 0;
+    return timegm (&tmValue);
+}
+
+int main (int argc, const char** argv)
+{
+    mamaDateTime    dateTime = NULL;
+    long            count    = DEFAULT_ITERATIONS;
+    char            buf[64];
+    double          start;
+    long            i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (0 == strcmp (argv[i], "-n") && i + 1 < argc)
+        {
+            count = atol (argv[++i]);
+        }
+        else
+        {
+            usage (strcmp (argv[i], "-h") && strcmp (argv[i], "-?") &&
+                   strcmp (argv[i], "--help") ? 1 : 0);
+        }
+    }
+
+    /* Timestamps from a trading day, as a tick capture would see them */
+    srand (1);
+    for (i = 0; i < NUM_TIMES; i++)
+    {
+        gSeconds[i] = 1372917600 + i * 31 + rand () % 31;
+        gMicros[i]  = rand () % 1000000;
+        libcAsString (gSeconds[i], gMicros[i], gStrings[i], sizeof (gStrings[i]));
+    }
+
+    if (MAMA_STATUS_OK != mamaDateTime_create (&dateTime))
+    {
+        fprintf (stderr, "Could not create date time\n");
+        return 1;
+    }
+
+    start = nowNanos ();
+    for (i = 0; i < count; i++)
+    {
+        libcAsString (gSeconds[i % NUM_TIMES], gMicros[i % NUM_TIMES],
+                      buf, sizeof (buf));
+        gSink += buf[20];
+    }
+    report ("gmtime_r + strftime", start, nowNanos (), count);
+
+    start = nowNanos ();
+    for (i = 0; i < count; i++)
+    {
+        mamaDateTime_setEpochTime (dateTime, gSeconds[i % NUM_TIMES],
+                                   gMicros[i % NUM_TIMES],
+                                   MAMA_DATE_TIME_PREC_MICROSECONDS);
+        mamaDateTime_getAsString (dateTime, buf, sizeof (buf));
+        gSink += buf[20];
+    }
+    report ("mamaDateTime_getAsString", start, nowNanos (), count);
+
+    start = nowNanos ();
+    for (i = 0; i < count; i++)
+    {
+        mamaDateTime_setEpochTime (dateTime, gSeconds[i % NUM_TIMES],
+                                   gMicros[i % NUM_TIMES],
+                                   MAMA_DATE_TIME_PREC_MICROSECONDS);
+        mamaDateTime_getTimeAsString (dateTime, buf, sizeof (buf));
+        gSink += buf[10];
+    }
+    report ("mamaDateTime_getTimeAsString", start, nowNanos (), count);
+
+    start = nowNanos ();
+    for (i = 0; i < count; i++)
+    {
+        mamaDateTime_setEpochTime (dateTime, gSeconds[i % NUM_TIMES],
+                                   gMicros[i % NUM_TIMES],
+                                   MAMA_DATE_TIME_PREC_MICROSECONDS);
+        mamaDateTime_getAsFormattedString (dateTime, buf, sizeof (buf),
+                                           "%F %T%.");
+        gSink += buf[20];
+    }
+    report ("mamaDateTime_getAsFormattedString", start, nowNanos (), count);
+
+    start = nowNanos ();
+    for (i = 0; i < count; i++)
+    {
+        mama_u32_t micros = 0;
+        gSink += (unsigned) libcFromString (gStrings[i % NUM_TIMES], &micros);
+        gSink += micros;
+    }
+    report ("strtoul + timegm", start, nowNanos (), count);
+
+    start = nowNanos ();
+    for (i = 0; i < count; i++)
+    {
+        mama_u32_t seconds = 0;
+        mamaDateTime_setFromString (dateTime, gStrings[i % NUM_TIMES]);
+        mamaDateTime_getEpochTime (dateTime, &seconds, &seconds, NULL);
+        gSink += seconds;
+    }
+    report ("mamaDateTime_setFromString", start, nowNanos (), count);
+
+    mamaDateTime_destroy (dateTime);
+    return 0;
+}
@@ -0,0 +1,176 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+/*
+ * Microbenchmark of field access through a payload bridge: adding, getting
+ * and iterating fids on a message of typical size. Needs no middleware.
+ * The first line times formatting the fid keys alone, which is what the
+ * avis payload used to do on every access.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "mama/mama.h"
+
+#define DEFAULT_ITERATIONS      1000000
+#define DEFAULT_FIELDS          40
+#define FIRST_FID               100
+
+static const char *         gUsageString[] =
+{
+"mamapayloadbenchc",
+"Usage: mamapayloadbenchc [OPTIONS]",
+"Times adding, getting and iterating fields by fid through a payload bridge,",
+"in nanoseconds per message.",
+"",
+"OPTIONS",
+"      [-h|-?|--help]  Show this help message.",
+"      [-n count]      Number of messages per benchmark; default is 1000000.",
+"      [-f fields]     Number of fields per message; default is 40.",
+"      [-p payload]    The payload bridge to load; default is avismsg.",
+NULL
+};
+
+/* Defeats the optimiser */
+static volatile unsigned    gSink = 0;
+
+static void usage (int exitStatus)
+{
+    int i = 0;
+    while (NULL != gUsageString[i])
+    {
+        printf ("%s\n", gUsageString[i++]);
+    }
+    exit (exitStatus);
+}
+
+static double nowNanos (void)
+{
+    struct timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void report (const char* name, double start, double end, long count)
+{
+    printf ("%-36s %10.1f ns/msg\n", name, (end - start) / count);
+}
+
+int main (int argc, const char** argv)
+{
+    mamaPayloadBridge   payloadBridge   = NULL;
+    mamaMsg             msg             = NULL;
+    mamaMsgIterator     iterator        = NULL;
+    const char*         payloadName     = "avismsg";
+    long                count           = DEFAULT_ITERATIONS;
+    int                 numFields       = DEFAULT_FIELDS;
+    char                key[16];
+    double              start;
+    long                i;
+    int                 f;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (0 == strcmp (argv[i], "-n") && i + 1 < argc)
+        {
+            count = atol (argv[++i]);
+        }
+        else if (0 == strcmp (argv[i], "-f") && i + 1 < argc)
+        {
+            numFields = atoi (argv[++i]);
+        }
+        else if (0 == strcmp (argv[i], "-p") && i + 1 < argc)
+        {
+            payloadName = argv[++i];
+        }
+        else
+        {
+            usage (strcmp (argv[i], "-h") && strcmp (argv[i], "-?") &&
+                   strcmp (argv[i], "--help") ? 1 : 0);
+        }
+    }
+
+    if (MAMA_STATUS_OK != mama_loadPayloadBridge (&payloadBridge, payloadName)
+        || MAMA_STATUS_OK != mamaMsg_createForPayloadBridge (&msg,
+                                                             payloadBridge)
+        || MAMA_STATUS_OK != mamaMsgIterator_create (&iterator, NULL))
+    {
+        fprintf (stderr, "Could not load payload %s\n", payloadName);
+        return 1;
+    }
+
+    start = nowNanos ();
+    for (i = 0; i < count; i++)
+    {
+        for (f = 0; f < numFields; f++)
+        {
+            snprintf (key, sizeof (key), "%d", FIRST_FID + f);
+            gSink += key[0];
+        }
+    }
+    report ("snprintf fid keys", start, nowNanos (), count);
+
+    start = nowNanos ();
+    for (i = 0; i < count; i++)
+    {
+        mamaMsg_clear (msg);
+        for (f = 0; f < numFields; f++)
+        {
+            mamaMsg_addI32 (msg, NULL, FIRST_FID + f, (mama_i32_t) i);
+        }
+    }
+    report ("add fields", start, nowNanos (), count);
+
+    start = nowNanos ();
+    for (i = 0; i < count; i++)
+    {
+        for (f = 0; f < numFields; f++)
+        {
+            mama_i32_t value = 0;
+            mamaMsg_getI32 (msg, NULL, FIRST_FID + f, &value);
+            gSink += value;
+        }
+    }
+    report ("get fields", start, nowNanos (), count);
+
+    start = nowNanos ();
+    for (i = 0; i < count; i++)
+    {
+        mamaMsgIterator_associate (iterator, msg);
+        while (mamaMsgIterator_hasNext (iterator))
+        {
+            mama_fid_t   fid   = 0;
+            mamaMsgField field = mamaMsgIterator_next (iterator);
+
+            mamaMsgField_getFid (field, &fid);
+            gSink += fid;
+        }
+    }
+    report ("iterate fields", start, nowNanos (), count);
+
+    mamaMsgIterator_destroy (iterator);
+    mamaMsg_destroy (msg);
+    return 0;
+}
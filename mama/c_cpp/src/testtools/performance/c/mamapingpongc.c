@@ -26,6 +26,7 @@
 #include <signal.h>
 #include <math.h>
 #include <pthread.h>
+#include <sched.h>
 
 #include "mama/mama.h"
 #include "mama/queue.h"
@@ -54,6 +55,8 @@
 #define MAMA_MSG_MAX_FIELD_SIZE UINT16_MAX
 #define DEFAULT_MAX_MSG_SIZE    1048576 /* 1MB */
 #define DEFAULT_MIN_SIZE        (2*sizeof(uint64_t))  /* 1MB */
+#define QUEUE_NAME              "PingPong"
+#define PROPERTY_NAME_SIZE      64
 
 enum syncState {
     SYNC_INIT   = 0,
@@ -109,6 +112,17 @@ pthread_cond_t              gPendingDestroyCond;
 static int                  gSubscDestroyed     = 0;
 
 static double               gCpuFreq;
+static const char*          gSpin               = NULL;
+static const char*          gCpu                = NULL;
+static uint32_t             gWakeupSamples      = 1000;
+static uint32_t             gWakeupGap          = 50;
+
+typedef struct {
+    uint8_t         mRdtsc;
+    uint64_t        mEnqueued;
+    int64_t         mLatency;
+    volatile int    mDone;
+} wakeupSample;
 
 static const char *         gUsageString[] =
 {
@@ -123,6 +137,7 @@ static const char *         gUsageString[] =
 "OPTIONS",
 "      [-a]            Run all message sizes from minimum to maximum.",
 "      [-app appName]  The application name; default is mamapingpong.",
+"      [-cpu list]     Pin the dispatch thread to the CPUs in list, e.g. 2 or 2,3; sets mama.queue.PingPong.cpu.",
 "      [-h|-?|--help]  Show this help messgae.",
 "      [-i interval]   Output latency statistics every interval messages per message size.",
 "      [-l length]     Minimum message size in bytes; default is 8.",
@@ -131,10 +146,13 @@ static const char *         gUsageString[] =
 "      [-rdtsc]        Use CPU Time Stamp Counter for latency calculation.",
 "      [-S namespace]  Symbol name space for the data",
 "      [-sd]           Calculates standard deviation per message size.",
+"      [-spin usecs]   Busy poll the queue for usecs before blocking; sets mama.queue.PingPong.spin.",
 "      [-r]            Mark instance as responder; default is requester.",
 "      [-tport name]   The transport to be used from mama.properties.",
 "      [-x length]     Maximum message size in bytes; default is 1048576 (1MB).",
 "      [-v]            Increase verbosity. Can be passed multiple times.",
+"      [-wakeup count] Number of queue wakeup latency samples taken by the requester before starting; default is 1000, 0 disables.",
+"      [-wakeupgap usecs] Idle time between wakeup samples; default is 50.",
 NULL
 };
 
@@ -261,6 +279,12 @@ static void createPublisher
 
 static void displayResults(pingPongEventCtx* eventCtx);
 
+static void measureWakeupLatency
+(
+    mamaQueue           queue,
+    uint8_t             readTsc
+);
+
 static void displayMessageStats
 (
     message* pMsg
@@ -346,6 +370,9 @@ int main (int argc, const char** argv)
             exit (EXIT_FAILURE);
 
         initMessages (eventCtx.mMsgs, eventCtx.mNumMsgs, size, maxSize);
+
+        if (gWakeupSamples)
+            measureWakeupLatency (gPingPongCtx.mQueue, eventCtx.mRdtsc);
     }
 
     subscribeToSymbol (subscribeSymbol,
@@ -491,6 +518,69 @@ static void publishMessage
     seqNum++;
 }
 
+static void wakeupCallback
+(
+    mamaQueue   queue,
+    void*       closure
+)
+{
+    wakeupSample* sample = (wakeupSample*) closure;
+
+    sample->mLatency = (int64_t) (getNanoSecs (sample->mRdtsc) -
+                                  sample->mEnqueued);
+    sample->mDone    = 1;
+}
+
+/*
+ * Time single events from enqueue to dispatch, leaving the queue idle for
+ * gWakeupGap microseconds before each one. A blocking dispatcher has gone to
+ * sleep by then and pays the wakeup, a spinning dispatcher whose spin interval
+ * covers the gap does not, so comparing runs with and without -spin reports
+ * the wakeup cost directly.
+ */
+static void measureWakeupLatency
+(
+    mamaQueue           queue,
+    uint8_t             readTsc
+)
+{
+    wakeupSample    sample;
+    int64_t         minLatency  = INT64_MAX;
+    int64_t         maxLatency  = 0;
+    double          total       = 0.0;
+    uint32_t        i           = 0;
+
+    memset (&sample, 0, sizeof sample);
+    sample.mRdtsc = readTsc;
+
+    for (i = 0; i < gWakeupSamples; i++)
+    {
+        usleep (gWakeupGap);
+
+        sample.mDone     = 0;
+        sample.mEnqueued = getNanoSecs (readTsc);
+        MAMA_CHECK (mamaQueue_enqueueEvent (queue, wakeupCallback, &sample));
+
+        while (!sample.mDone)
+            sched_yield ();
+
+        if (sample.mLatency < minLatency)
+            minLatency = sample.mLatency;
+        if (sample.mLatency > maxLatency)
+            maxLatency = sample.mLatency;
+        total += sample.mLatency;
+    }
+
+    printf ("Queue wakeup latency [usec] (%s%s, gap %" PRIu32 "usec): "
+            "min %.2f avg %.2f max %.2f\n",
+            gSpin ? "spin " : "blocking",
+            gSpin ? gSpin   : "",
+            gWakeupGap,
+            (double)minLatency / 1000.0,
+            total / gWakeupSamples / 1000.0,
+            (double)maxLatency / 1000.0);
+}
+
 static void pingpongShutdown (pingPongCtx* ppCtx, pingPongEventCtx* eventCtx)
 {
     pthread_mutexattr_t    attr;
@@ -558,7 +648,8 @@ initializeMama (const char*     middleware,
                 mamaTransport*  pubTransport,
                 void*           closure)
 {
-    char queueNameBuff[24] = "Queue PingPong";
+    char queueNameBuff[24]                  = QUEUE_NAME;
+    char propertyName[PROPERTY_NAME_SIZE];
 
     if (gAppName)
     {
@@ -576,6 +667,21 @@ initializeMama (const char*     middleware,
 
     MAMA_CHECK (mamaQueue_create (queue, *bridge));
     MAMA_CHECK (mamaQueue_setQueueName (*queue, queueNameBuff));
+
+    /* Dispatcher placement is read from the properties at create time */
+    if (gSpin)
+    {
+        snprintf (propertyName, sizeof (propertyName),
+                  "mama.queue.%s.spin", queueNameBuff);
+        mama_setProperty (propertyName, gSpin);
+    }
+    if (gCpu)
+    {
+        snprintf (propertyName, sizeof (propertyName),
+                  "mama.queue.%s.cpu", queueNameBuff);
+        mama_setProperty (propertyName, gCpu);
+    }
+
     MAMA_CHECK (mamaDispatcher_create (dispatcher , *queue));
 }
 
@@ -1051,6 +1157,26 @@ static void parseCommandLine
                 *stopCount = atoi (argv[i + 1]);
                 i += 2;
             }
+            else if (strcmp (argv[i], "-spin") == 0)
+            {
+                gSpin = argv[i + 1];
+                i += 2;
+            }
+            else if (strcmp (argv[i], "-cpu") == 0)
+            {
+                gCpu = argv[i + 1];
+                i += 2;
+            }
+            else if (strcmp (argv[i], "-wakeup") == 0)
+            {
+                gWakeupSamples = atoi (argv[i + 1]);
+                i += 2;
+            }
+            else if (strcmp (argv[i], "-wakeupgap") == 0)
+            {
+                gWakeupGap = atoi (argv[i + 1]);
+                i += 2;
+            }
             else if(strcmp("-tport", argv[i]) == 0)
             {
                 *tport = argv[i+1];
@@ -0,0 +1,348 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+/*
+ * Measures how long a start of day subscription storm takes: the time for
+ * all subscriptions to be created and for all of their initials to arrive,
+ * either with one mamaSubscription_create call per symbol or with
+ * mamaSubscription_createBatch. A symbol counts as done once its initial
+ * arrives or its subscription reports an error, such as a timeout.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "mama/mama.h"
+#include "mama/source.h"
+
+#define DEFAULT_COUNT           10000
+#define DEFAULT_TIMEOUT         60
+#define SYMBOL_SIZE             64
+
+static const char *         gUsageString[] =
+{
+"mamasubscbatchc",
+"Usage: mamasubscbatchc [OPTIONS]",
+"Times creating many subscriptions and receiving all of their initials,",
+"creating them one at a time or as a single batch.",
+"",
+"EXAMPLE COMMANDLINES:",
+"mamasubscbatchc -m wmw -tport sub -S WOMBAT -s SYM -n 100000",
+"mamasubscbatchc -m wmw -tport sub -S WOMBAT -s SYM -n 100000 -batch",
+"",
+"OPTIONS",
+"      [-h|-?|--help]  Show this help message.",
+"      [-batch]        Create the subscriptions with mamaSubscription_createBatch.",
+"      [-m middleware] The middleware to use; default is wmw.",
+"      [-n count]      Number of subscriptions; default is 10000.",
+"      [-S source]     The source name; default is WOMBAT.",
+"      [-s prefix]     Symbols are the prefix followed by 0 to count - 1; default is SYM.",
+"      [-t seconds]    Give up waiting for initials after this long; default is 60.",
+"      [-tport name]   The transport to subscribe on.",
+NULL
+};
+
+static pthread_mutex_t      gLock               = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t       gDoneCond           = PTHREAD_COND_INITIALIZER;
+static long                 gCount              = DEFAULT_COUNT;
+static long                 gCreated            = 0;
+static long                 gInitials           = 0;
+static long                 gErrors             = 0;
+static double               gCreatedTime        = 0.0;
+static double               gDoneTime           = 0.0;
+static unsigned char*       gDone               = NULL;
+
+static void usage (int exitStatus)
+{
+    int i = 0;
+    while (NULL != gUsageString[i])
+    {
+        printf ("%s\n", gUsageString[i++]);
+    }
+    exit (exitStatus);
+}
+
+static double nowNanos (void)
+{
+    struct timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* Marks a symbol done, once per symbol. Called with gLock held. */
+static void markDone (long index)
+{
+    if (index < 0 || index >= gCount || gDone[index]) return;
+
+    gDone[index] = 1;
+    if (gInitials + gErrors == gCount)
+    {
+        gDoneTime = nowNanos ();
+        pthread_cond_signal (&gDoneCond);
+    }
+}
+
+static void MAMACALLTYPE
+subscriptionOnCreate (mamaSubscription subscription, void* closure)
+{
+    pthread_mutex_lock (&gLock);
+    if (++gCreated == gCount)
+    {
+        gCreatedTime = nowNanos ();
+    }
+    pthread_mutex_unlock (&gLock);
+}
+
+static void MAMACALLTYPE
+subscriptionOnError (mamaSubscription subscription,
+                     mama_status      status,
+                     void*            platformError,
+                     const char*      subject,
+                     void*            closure)
+{
+    long index = (long)(size_t)closure;
+
+    pthread_mutex_lock (&gLock);
+    if (index >= 0 && index < gCount && !gDone[index])
+    {
+        gErrors++;
+        markDone (index);
+    }
+    pthread_mutex_unlock (&gLock);
+}
+
+static void MAMACALLTYPE
+subscriptionOnMsg (mamaSubscription subscription,
+                   mamaMsg          msg,
+                   void*            closure,
+                   void*            itemClosure)
+{
+    long index = (long)(size_t)closure;
+
+    if (MAMA_MSG_TYPE_INITIAL != mamaMsgType_typeForMsg (msg)) return;
+
+    pthread_mutex_lock (&gLock);
+    if (index >= 0 && index < gCount && !gDone[index])
+    {
+        gInitials++;
+        markDone (index);
+    }
+    pthread_mutex_unlock (&gLock);
+}
+
+static void MAMACALLTYPE
+startCb (mama_status status)
+{
+}
+
+static void check (mama_status status, const char* what)
+{
+    if (MAMA_STATUS_OK != status)
+    {
+        fprintf (stderr, "%s failed: %s\n", what,
+                 mamaStatus_stringForStatus (status));
+        exit (1);
+    }
+}
+
+int main (int argc, const char** argv)
+{
+    mamaBridge          bridge          = NULL;
+    mamaTransport       transport       = NULL;
+    mamaSource          source          = NULL;
+    mamaQueue           queue           = NULL;
+    mamaSubscription*   subscriptions   = NULL;
+    const char**        symbols         = NULL;
+    void**              closures        = NULL;
+    char*               symbolStore     = NULL;
+    mamaMsgCallbacks    callbacks;
+    const char*         middleware      = "wmw";
+    const char*         tportName       = NULL;
+    const char*         sourceName      = "WOMBAT";
+    const char*         prefix          = "SYM";
+    int                 useBatch        = 0;
+    int                 timeout         = DEFAULT_TIMEOUT;
+    struct timespec     deadline;
+    double              start;
+    double              created;
+    long                i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (0 == strcmp (argv[i], "-batch"))
+        {
+            useBatch = 1;
+        }
+        else if (0 == strcmp (argv[i], "-m") && i + 1 < argc)
+        {
+            middleware = argv[++i];
+        }
+        else if (0 == strcmp (argv[i], "-n") && i + 1 < argc)
+        {
+            gCount = atol (argv[++i]);
+        }
+        else if (0 == strcmp (argv[i], "-S") && i + 1 < argc)
+        {
+            sourceName = argv[++i];
+        }
+        else if (0 == strcmp (argv[i], "-s") && i + 1 < argc)
+        {
+            prefix = argv[++i];
+        }
+        else if (0 == strcmp (argv[i], "-t") && i + 1 < argc)
+        {
+            timeout = atoi (argv[++i]);
+        }
+        else if (0 == strcmp (argv[i], "-tport") && i + 1 < argc)
+        {
+            tportName = argv[++i];
+        }
+        else
+        {
+            usage (strcmp (argv[i], "-h") && strcmp (argv[i], "-?") &&
+                   strcmp (argv[i], "--help") ? 1 : 0);
+        }
+    }
+
+    if (gCount <= 0) usage (1);
+
+    subscriptions = (mamaSubscription*)calloc (gCount, sizeof (mamaSubscription));
+    symbols       = (const char**)calloc (gCount, sizeof (const char*));
+    closures      = (void**)calloc (gCount, sizeof (void*));
+    symbolStore   = (char*)calloc (gCount, SYMBOL_SIZE);
+    gDone         = (unsigned char*)calloc (gCount, 1);
+    if (!subscriptions || !symbols || !closures || !symbolStore || !gDone)
+    {
+        fprintf (stderr, "Could not allocate %ld subscriptions\n", gCount);
+        return 1;
+    }
+
+    for (i = 0; i < gCount; i++)
+    {
+        snprintf (symbolStore + i * SYMBOL_SIZE, SYMBOL_SIZE, "%s%ld", prefix, i);
+        symbols[i]  = symbolStore + i * SYMBOL_SIZE;
+        closures[i] = (void*)(size_t)i;
+    }
+
+    memset (&callbacks, 0, sizeof (callbacks));
+    callbacks.onCreate = subscriptionOnCreate;
+    callbacks.onError  = subscriptionOnError;
+    callbacks.onMsg    = subscriptionOnMsg;
+
+    check (mama_loadBridge (&bridge, middleware), "mama_loadBridge");
+    check (mama_open (), "mama_open");
+    check (mamaTransport_allocate (&transport), "mamaTransport_allocate");
+    check (mamaTransport_create (transport, tportName, bridge),
+           "mamaTransport_create");
+    check (mamaSource_create (&source), "mamaSource_create");
+    check (mamaSource_setId (source, sourceName), "mamaSource_setId");
+    check (mamaSource_setSymbolNamespace (source, sourceName),
+           "mamaSource_setSymbolNamespace");
+    check (mamaSource_setTransport (source, transport),
+           "mamaSource_setTransport");
+    check (mama_getDefaultEventQueue (bridge, &queue),
+           "mama_getDefaultEventQueue");
+    check (mama_startBackground (bridge, startCb), "mama_startBackground");
+
+    start = nowNanos ();
+    if (useBatch)
+    {
+        check (mamaSubscription_allocateBatch (subscriptions, gCount),
+               "mamaSubscription_allocateBatch");
+        check (mamaSubscription_createBatch (subscriptions, gCount, queue,
+                                             &callbacks, source, symbols,
+                                             closures),
+               "mamaSubscription_createBatch");
+    }
+    else
+    {
+        for (i = 0; i < gCount; i++)
+        {
+            check (mamaSubscription_allocate (&subscriptions[i]),
+                   "mamaSubscription_allocate");
+            check (mamaSubscription_create (subscriptions[i], queue,
+                                            &callbacks, source, symbols[i],
+                                            closures[i]),
+                   "mamaSubscription_create");
+        }
+    }
+    created = nowNanos ();
+
+    clock_gettime (CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout;
+
+    pthread_mutex_lock (&gLock);
+    while (gInitials + gErrors < gCount)
+    {
+        if (0 != pthread_cond_timedwait (&gDoneCond, &gLock, &deadline)) break;
+    }
+    pthread_mutex_unlock (&gLock);
+
+    printf ("%-28s %s\n", "mode", useBatch ? "batch" : "single");
+    printf ("%-28s %ld\n", "subscriptions", gCount);
+    printf ("%-28s %10.3f ms\n", "create calls",
+            (created - start) / 1e6);
+    if (gCreated == gCount)
+    {
+        printf ("%-28s %10.3f ms\n", "all onCreate",
+                (gCreatedTime - start) / 1e6);
+    }
+    else
+    {
+        printf ("%-28s %ld of %ld\n", "onCreate", gCreated, gCount);
+    }
+    if (gInitials + gErrors == gCount)
+    {
+        printf ("%-28s %10.3f ms\n", "all initials",
+                (gDoneTime - start) / 1e6);
+    }
+    else
+    {
+        printf ("%-28s timed out after %d s\n", "all initials", timeout);
+    }
+    printf ("%-28s %ld\n", "initials", gInitials);
+    printf ("%-28s %ld\n", "errors", gErrors);
+
+    for (i = 0; i < gCount; i++)
+    {
+        if (subscriptions[i])
+        {
+            mamaSubscription_destroy (subscriptions[i]);
+            mamaSubscription_deallocate (subscriptions[i]);
+        }
+    }
+
+    mama_stop (bridge);
+    mamaSource_destroy (source);
+    mamaTransport_destroy (transport);
+    mama_close ();
+
+    free (gDone);
+    free (symbolStore);
+    free (closures);
+    free ((void*)symbols);
+    free (subscriptions);
+    return 0;
+}
@@ -52,6 +52,11 @@ namespace Wombat
         /// </summary>
         MAMA_PAYLOAD_TICK42BLP = 'B',
 
+        /// <summary>
+        /// Flat Message
+        /// </summary>
+        MAMA_PAYLOAD_FLAT = 'C',
+
         /// <summary>
         /// FAST Message
         /// </summary>
@@ -28,6 +28,7 @@
 *******************************************************************************/
 #include <assert.h>
 #include <limits.h>
+#include <string.h>
 
 #include "mamajniutils.h"
 #include "mamajni/com_wombat_mama_MamaMsg.h"
@@ -103,6 +104,31 @@ mama_status populateCMessageArray(mamaMsg *cArray, JNIEnv *env, jobjectArray jav
 * MACROS
 *******************************************************************************/
 
+/*
+ Layout of each slot in the direct buffer populated by _getFields. Must be
+ kept in step with the constants in MamaMsgView.java. Strings and opaques
+ are copied into the area following the slot table, the slot value holds
+ the byte offset of the data.
+*/
+#define FIELDS_SLOT_SIZE            24
+#define FIELDS_SLOT_FID             0
+#define FIELDS_SLOT_TYPE            4
+#define FIELDS_SLOT_FLAGS           6
+#define FIELDS_SLOT_LENGTH          8
+#define FIELDS_SLOT_VALUE           16
+
+#define FIELDS_TYPE_ABSENT          -1
+#define FIELDS_FLAG_NOT_DECODED     0x100
+
+/*Slots are not guaranteed to be aligned so always copy through memcpy*/
+#define FieldsSlotPut(SLOT, OFFSET, CTYPE, VALUE)                           \
+do                                                                          \
+{                                                                           \
+    CTYPE fieldsSlotValue = (CTYPE)(VALUE);                                 \
+    memcpy ((SLOT) + (OFFSET), &fieldsSlotValue, sizeof (CTYPE));           \
+}                                                                           \
+while(0)
+
 /*Used for adding all scalar vector types*/
 #define ExpandAddOrUpdateScalarVector(JTYPE, FTYPE, CFUNC, CTYPE, OPERATION) \
  do                                                                        \
@@ -553,6 +579,259 @@ JNIEXPORT jbyteArray JNICALL Java_com_wombat_mama_MamaMsg_getByteBuffer(JNIEnv*
     return ret;
 }
 
+/*
+ * Class:     com_wombat_mama_MamaMsg
+ * Method:    _getFields
+ * Signature: (Ljava/nio/ByteBuffer;I)I
+ */
+JNIEXPORT jint JNICALL Java_com_wombat_mama_MamaMsg__1getFields
+  (JNIEnv* env, jobject this, jobject buffer, jint numFids)
+{
+    jlong           msgPointer  =   0;
+    mamaMsg         msg         =   NULL;
+    mamaMsgField    field       =   NULL;
+    mamaPrice       price       =   NULL;
+    mamaDateTime    dateTime    =   NULL;
+    char*           base        =   NULL;
+    jlong           capacity    =   0;
+    jlong           used        =   0;
+    jint            i           =   0;
+
+    msgPointer = (*env)->GetLongField(env,this,messagePointerFieldId_g);
+    MAMA_THROW_NULL_PARAMETER_RETURN_VALUE(msgPointer,
+		"Null parameter, MamaMsg may have already been destroyed.", 0);
+    msg = CAST_JLONG_TO_POINTER(mamaMsg,msgPointer);
+
+    base     = (char*)(*env)->GetDirectBufferAddress(env,buffer);
+    capacity = (*env)->GetDirectBufferCapacity(env,buffer);
+    if (NULL == base || capacity < (jlong)numFids * FIELDS_SLOT_SIZE)
+    {
+        utils_throwWombatException(env,
+            "getFields(): buffer is not direct or too small for the fids.");
+        return 0;
+    }
+
+    /* Variable length data is appended after the slot table. */
+    used = (jlong)numFids * FIELDS_SLOT_SIZE;
+
+    for (i = 0; i < numFids; i++)
+    {
+        char*           slot        =   base + (size_t)i * FIELDS_SLOT_SIZE;
+        mama_i32_t      fid         =   0;
+        mamaFieldType   type        =   MAMA_FIELD_TYPE_UNKNOWN;
+        mama_u16_t      flags       =   0;
+        mama_i64_t      longValue   =   0;
+        double          doubleValue =   0.0;
+        int             isDouble    =   0;
+        const void*     data        =   NULL;
+        mama_size_t     dataLen     =   0;
+        mama_status     status      =   MAMA_STATUS_OK;
+
+        memcpy (&fid, slot + FIELDS_SLOT_FID, sizeof (fid));
+
+        if (MAMA_STATUS_OK != mamaMsg_getField (msg, NULL, (mama_fid_t)fid,
+                                                &field) ||
+            MAMA_STATUS_OK != mamaMsgField_getType (field, &type))
+        {
+            FieldsSlotPut (slot, FIELDS_SLOT_TYPE, mama_i16_t,
+                           FIELDS_TYPE_ABSENT);
+            FieldsSlotPut (slot, FIELDS_SLOT_FLAGS, mama_u16_t, 0);
+            FieldsSlotPut (slot, FIELDS_SLOT_LENGTH, mama_i32_t, 0);
+            FieldsSlotPut (slot, FIELDS_SLOT_VALUE, mama_i64_t, 0);
+            continue;
+        }
+
+        switch (type)
+        {
+            case MAMA_FIELD_TYPE_BOOL:
+            {
+                mama_bool_t v = 0;
+                status = mamaMsgField_getBool (field, &v);
+                longValue = v;
+                break;
+            }
+            case MAMA_FIELD_TYPE_CHAR:
+            {
+                char v = 0;
+                status = mamaMsgField_getChar (field, &v);
+                longValue = v;
+                break;
+            }
+            case MAMA_FIELD_TYPE_I8:
+            {
+                mama_i8_t v = 0;
+                status = mamaMsgField_getI8 (field, &v);
+                longValue = v;
+                break;
+            }
+            case MAMA_FIELD_TYPE_U8:
+            {
+                mama_u8_t v = 0;
+                status = mamaMsgField_getU8 (field, &v);
+                longValue = v;
+                break;
+            }
+            case MAMA_FIELD_TYPE_I16:
+            {
+                mama_i16_t v = 0;
+                status = mamaMsgField_getI16 (field, &v);
+                longValue = v;
+                break;
+            }
+            case MAMA_FIELD_TYPE_U16:
+            {
+                mama_u16_t v = 0;
+                status = mamaMsgField_getU16 (field, &v);
+                longValue = v;
+                break;
+            }
+            case MAMA_FIELD_TYPE_I32:
+            {
+                mama_i32_t v = 0;
+                status = mamaMsgField_getI32 (field, &v);
+                longValue = v;
+                break;
+            }
+            case MAMA_FIELD_TYPE_U32:
+            {
+                mama_u32_t v = 0;
+                status = mamaMsgField_getU32 (field, &v);
+                longValue = v;
+                break;
+            }
+            case MAMA_FIELD_TYPE_I64:
+            {
+                status = mamaMsgField_getI64 (field, &longValue);
+                break;
+            }
+            case MAMA_FIELD_TYPE_U64:
+            {
+                /* Java has no unsigned long, the bit pattern is preserved. */
+                mama_u64_t v = 0;
+                status = mamaMsgField_getU64 (field, &v);
+                longValue = (mama_i64_t)v;
+                break;
+            }
+            case MAMA_FIELD_TYPE_F32:
+            {
+                mama_f32_t v = 0;
+                status = mamaMsgField_getF32 (field, &v);
+                doubleValue = v;
+                isDouble = 1;
+                break;
+            }
+            case MAMA_FIELD_TYPE_F64:
+            {
+                status = mamaMsgField_getF64 (field, &doubleValue);
+                isDouble = 1;
+                break;
+            }
+            case MAMA_FIELD_TYPE_PRICE:
+            {
+                mamaPriceHints hints = 0;
+                if (NULL == price)
+                {
+                    status = mamaPrice_create (&price);
+                }
+                if (MAMA_STATUS_OK == status)
+                    status = mamaMsgField_getPrice (field, price);
+                if (MAMA_STATUS_OK == status)
+                    status = mamaPrice_getValue (price, &doubleValue);
+                if (MAMA_STATUS_OK == status)
+                    status = mamaPrice_getHints (price, &hints);
+                flags = hints;
+                isDouble = 1;
+                break;
+            }
+            case MAMA_FIELD_TYPE_TIME:
+            {
+                mama_u64_t micros = 0;
+                if (NULL == dateTime)
+                {
+                    status = mamaDateTime_create (&dateTime);
+                }
+                if (MAMA_STATUS_OK == status)
+                    status = mamaMsgField_getDateTime (field, dateTime);
+                if (MAMA_STATUS_OK == status)
+                    status = mamaDateTime_getEpochTimeMicroseconds (dateTime,
+                                                                    &micros);
+                longValue = (mama_i64_t)micros;
+                break;
+            }
+            case MAMA_FIELD_TYPE_STRING:
+            {
+                const char* v = NULL;
+                status = mamaMsgField_getString (field, &v);
+                if (MAMA_STATUS_OK == status && NULL != v)
+                {
+                    data    = v;
+                    dataLen = strlen (v);
+                }
+                break;
+            }
+            case MAMA_FIELD_TYPE_OPAQUE:
+            {
+                status = mamaMsgField_getOpaque (field, &data, &dataLen);
+                break;
+            }
+            default:
+                /* Sub-messages and vectors use the per field accessors. */
+                status = MAMA_STATUS_NOT_IMPLEMENTED;
+                break;
+        }
+
+        if (MAMA_STATUS_OK != status)
+        {
+            flags     = FIELDS_FLAG_NOT_DECODED;
+            longValue = 0;
+            isDouble  = 0;
+            data      = NULL;
+            dataLen   = 0;
+        }
+
+        FieldsSlotPut (slot, FIELDS_SLOT_TYPE, mama_i16_t, type);
+        FieldsSlotPut (slot, FIELDS_SLOT_FLAGS, mama_u16_t, flags);
+        FieldsSlotPut (slot, FIELDS_SLOT_LENGTH, mama_i32_t, dataLen);
+
+        if (isDouble)
+        {
+            FieldsSlotPut (slot, FIELDS_SLOT_VALUE, double, doubleValue);
+        }
+        else if (MAMA_FIELD_TYPE_STRING == type ||
+                 MAMA_FIELD_TYPE_OPAQUE == type)
+        {
+            /*
+             Keep counting once the buffer is full so the caller learns the
+             size required in a single pass.
+            */
+            if (used + (jlong)dataLen <= capacity && dataLen > 0)
+            {
+                memcpy (base + used, data, dataLen);
+            }
+            FieldsSlotPut (slot, FIELDS_SLOT_VALUE, mama_i64_t, used);
+            used += dataLen;
+        }
+        else
+        {
+            FieldsSlotPut (slot, FIELDS_SLOT_VALUE, mama_i64_t, longValue);
+        }
+    }
+
+    if (NULL != price)
+        mamaPrice_destroy (price);
+    if (NULL != dateTime)
+        mamaDateTime_destroy (dateTime);
+
+    if (used > INT_MAX)
+    {
+        utils_throwWombatException(env,
+            "getFields(): field data exceeds the maximum buffer size.");
+        return 0;
+    }
+
+    return (jint)used;
+}
+
 /*
  * Class:     com_wombat_mama_MamaMsg
  * Method:    getNumFields
@@ -875,7 +875,35 @@ public class MamaMsg
 	}
 	
 	private native void _setNewBuffer(byte[] byteArray);
-   
+
+    /**
+      * Decode every fid requested by the view into its direct buffer using
+      * a single native call. This avoids a JNI transition and, for strings,
+      * an object allocation per field which the individual getters incur.
+      * The view's buffer is grown if the string and opaque data do not fit.
+      *
+      * @param view The view describing the fids to decode
+      *
+      * @exception WombatException will be thrown if the view is null
+      */
+    public void getFields (MamaMsgView view)
+    {
+        if (null == view)
+        {
+            throw new WombatException("getFields(): view was null.");
+        }
+
+        int required = _getFields (view.getBuffer(), view.getNumFids());
+        if (required > view.getBuffer().capacity())
+        {
+            view.grow (required);
+            required = _getFields (view.getBuffer(), view.getNumFids());
+        }
+        view.setLimit (required);
+    }
+
+    private native int _getFields (ByteBuffer buffer, int numFids);
+
     /**
       * Returns a Opaque value from the underlying message.
       *
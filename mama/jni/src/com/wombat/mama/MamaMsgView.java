@@ -0,0 +1,392 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+package com.wombat.mama;
+
+import com.wombat.common.WombatException;
+import java.io.UnsupportedEncodingException;
+import java.nio.*;
+
+/**
+ * A reusable flyweight over a direct ByteBuffer populated by
+ * {@link MamaMsg#getFields(MamaMsgView)}. The fids of interest are supplied
+ * once on construction; each call to getFields then decodes all of them from
+ * a message in a single native call and the accessors below read the values
+ * straight out of the buffer by index.
+ * <p/>
+ * Integer, boolean and char fields are widened to a long, F32 and F64 fields
+ * to a double. Prices are available as a double with their hints through
+ * {@link #getPriceHints(int)} and date times as microseconds since the epoch.
+ * Sub-messages and vectors are reported with their type but are not decoded,
+ * see {@link #isDecoded(int)}, and should be read with the MamaMsg getters.
+ * <p/>
+ * The view is only valid until the next call to getFields and, like MamaMsg,
+ * must not be shared between threads.
+ */
+public class MamaMsgView
+{
+    /* ************************************************** */
+    /* Buffer Layout, must match mamamsgjni.c. */
+    /* ************************************************** */
+    static final int SLOT_SIZE      = 24;
+    static final int SLOT_FID       = 0;
+    static final int SLOT_TYPE      = 4;
+    static final int SLOT_FLAGS     = 6;
+    static final int SLOT_LENGTH    = 8;
+    static final int SLOT_VALUE     = 16;
+
+    /** The type reported for a fid which is not present in the message. */
+    public static final short TYPE_ABSENT       = -1;
+
+    private static final int FLAG_NOT_DECODED   = 0x100;
+    private static final int FLAG_HINTS_MASK    = 0xff;
+
+    /* Initial space per fid for string and opaque data. */
+    private static final int DEFAULT_DATA_PER_FID = 32;
+
+    /* ************************************************** */
+    /* Private Member Variables. */
+    /* ************************************************** */
+    private final int[] myFids;
+    private ByteBuffer  myBuffer;
+    private int         myLimit   = 0;
+    private byte[]      myScratch = new byte[64];
+
+    /* ************************************************** */
+    /* Construction. */
+    /* ************************************************** */
+
+    /**
+     * Create a view for the fids supplied.
+     *
+     * @param fids The fids to decode, in the order they will be indexed
+     */
+    public MamaMsgView (int[] fids)
+    {
+        this (fids, fids == null ? 0 : fids.length * DEFAULT_DATA_PER_FID);
+    }
+
+    /**
+     * Create a view for the fids supplied.
+     *
+     * @param fids The fids to decode, in the order they will be indexed
+     * @param dataCapacity The initial number of bytes reserved for string
+     *                     and opaque data, the buffer grows on demand
+     *
+     * @exception WombatException will be thrown if fids is null
+     */
+    public MamaMsgView (int[] fids, int dataCapacity)
+    {
+        if (null == fids)
+        {
+            throw new WombatException("MamaMsgView(): fids was null.");
+        }
+        myFids = (int[]) fids.clone ();
+        allocate (myFids.length * SLOT_SIZE + Math.max (dataCapacity, 0));
+    }
+
+    /* ************************************************** */
+    /* Public Functions. */
+    /* ************************************************** */
+
+    /**
+     * @return The number of fids in the view
+     */
+    public int getNumFids ()
+    {
+        return myFids.length;
+    }
+
+    /**
+     * @param index The index of the fid in the view
+     * @return The fid at the index
+     */
+    public int getFid (int index)
+    {
+        return myFids[index];
+    }
+
+    /**
+     * Find the index of a fid, this is a linear scan so callers reading
+     * many fields should cache the result.
+     *
+     * @param fid The fid to look up
+     * @return The index of the fid or -1 if it is not part of the view
+     */
+    public int indexOf (int fid)
+    {
+        for (int i = 0; i < myFids.length; i++)
+        {
+            if (myFids[i] == fid)
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * @param index The index of the fid in the view
+     * @return true if the field was present in the last message decoded
+     */
+    public boolean isPresent (int index)
+    {
+        return getType (index) != TYPE_ABSENT;
+    }
+
+    /**
+     * @param index The index of the fid in the view
+     * @return false if the field is present but its value could not be
+     *         decoded into the view, as is the case for sub-messages and
+     *         vectors
+     */
+    public boolean isDecoded (int index)
+    {
+        return isPresent (index)
+            && (myBuffer.getShort (slot (index) + SLOT_FLAGS)
+                & FLAG_NOT_DECODED) == 0;
+    }
+
+    /**
+     * @param index The index of the fid in the view
+     * @return The MamaFieldDescriptor type of the field or TYPE_ABSENT
+     */
+    public short getType (int index)
+    {
+        return myBuffer.getShort (slot (index) + SLOT_TYPE);
+    }
+
+    /**
+     * Returns any integer, boolean, char or date time field as a long.
+     *
+     * @param index The index of the fid in the view
+     * @return The field value, 0 if the field is absent
+     */
+    public long getLong (int index)
+    {
+        return myBuffer.getLong (slot (index) + SLOT_VALUE);
+    }
+
+    /**
+     * @param index The index of the fid in the view
+     * @return The field value truncated to an int
+     */
+    public int getInt (int index)
+    {
+        return (int) getLong (index);
+    }
+
+    /**
+     * @param index The index of the fid in the view
+     * @return The field value truncated to a short
+     */
+    public short getShort (int index)
+    {
+        return (short) getLong (index);
+    }
+
+    /**
+     * @param index The index of the fid in the view
+     * @return true if the field value is non zero
+     */
+    public boolean getBoolean (int index)
+    {
+        return getLong (index) != 0;
+    }
+
+    /**
+     * @param index The index of the fid in the view
+     * @return The field value as a char
+     */
+    public char getChar (int index)
+    {
+        return (char) getLong (index);
+    }
+
+    /**
+     * Returns a F32, F64 or price field as a double.
+     *
+     * @param index The index of the fid in the view
+     * @return The field value, 0 if the field is absent
+     */
+    public double getDouble (int index)
+    {
+        return myBuffer.getDouble (slot (index) + SLOT_VALUE);
+    }
+
+    /**
+     * @param index The index of the fid in the view
+     * @return The field value as a float
+     */
+    public float getFloat (int index)
+    {
+        return (float) getDouble (index);
+    }
+
+    /**
+     * @param index The index of the fid in the view
+     * @return The MamaPrice hints of a price field
+     */
+    public short getPriceHints (int index)
+    {
+        return (short) (myBuffer.getShort (slot (index) + SLOT_FLAGS)
+                        & FLAG_HINTS_MASK);
+    }
+
+    /**
+     * @param index The index of the fid in the view
+     * @return The microseconds since the epoch of a date time field
+     */
+    public long getDateTimeMicroseconds (int index)
+    {
+        return getLong (index);
+    }
+
+    /**
+     * @param index The index of the fid in the view
+     * @return The number of bytes held by a string or opaque field
+     */
+    public int getLength (int index)
+    {
+        return myBuffer.getInt (slot (index) + SLOT_LENGTH);
+    }
+
+    /**
+     * Copy the bytes of a string or opaque field without allocating.
+     *
+     * @param index The index of the fid in the view
+     * @param dest The array to copy into
+     * @param offset The offset in dest at which to start copying
+     * @return The number of bytes copied, or the negative number of bytes
+     *         required if dest is too small
+     */
+    public int getBytes (int index, byte[] dest, int offset)
+    {
+        int length = getLength (index);
+        if (dest.length - offset < length)
+        {
+            return -length;
+        }
+        copyData (index, dest, offset, length);
+        return length;
+    }
+
+    /**
+     * Returns an opaque field as a new byte array.
+     *
+     * @param index The index of the fid in the view
+     * @return The field data, null if the field is absent
+     */
+    public byte[] getOpaque (int index)
+    {
+        if (!isDecoded (index))
+        {
+            return null;
+        }
+        byte[] result = new byte[getLength (index)];
+        copyData (index, result, 0, result.length);
+        return result;
+    }
+
+    /**
+     * Returns a string field, decoding the UTF-8 data held in the buffer.
+     *
+     * @param index The index of the fid in the view
+     * @return The field value, null if the field is absent
+     */
+    public String getString (int index)
+    {
+        if (!isDecoded (index))
+        {
+            return null;
+        }
+        int length = getLength (index);
+        if (myScratch.length < length)
+        {
+            myScratch = new byte[Math.max (length, myScratch.length * 2)];
+        }
+        copyData (index, myScratch, 0, length);
+        try
+        {
+            return new String (myScratch, 0, length, "UTF-8");
+        }
+        catch (UnsupportedEncodingException e)
+        {
+            throw new WombatException ("getString(): " + e.getMessage ());
+        }
+    }
+
+    /* ************************************************** */
+    /* Package Functions used by MamaMsg. */
+    /* ************************************************** */
+
+    ByteBuffer getBuffer ()
+    {
+        return myBuffer;
+    }
+
+    void grow (int required)
+    {
+        allocate (Math.max (required, myBuffer.capacity () * 2));
+    }
+
+    void setLimit (int limit)
+    {
+        myLimit = limit;
+    }
+
+    /* ************************************************** */
+    /* Private Functions. */
+    /* ************************************************** */
+
+    private void allocate (int capacity)
+    {
+        myBuffer = ByteBuffer.allocateDirect (capacity);
+        myBuffer.order (ByteOrder.nativeOrder ());
+        for (int i = 0; i < myFids.length; i++)
+        {
+            myBuffer.putInt (slot (i) + SLOT_FID, myFids[i]);
+            myBuffer.putShort (slot (i) + SLOT_TYPE, TYPE_ABSENT);
+        }
+    }
+
+    private int slot (int index)
+    {
+        if (index < 0 || index >= myFids.length)
+        {
+            throw new IndexOutOfBoundsException ("MamaMsgView index " + index);
+        }
+        return index * SLOT_SIZE;
+    }
+
+    private void copyData (int index, byte[] dest, int offset, int length)
+    {
+        int start = (int) myBuffer.getLong (slot (index) + SLOT_VALUE);
+        if (start + length > myLimit)
+        {
+            throw new IndexOutOfBoundsException ("MamaMsgView data truncated");
+        }
+        for (int i = 0; i < length; i++)
+        {
+            dest[offset + i] = myBuffer.get (start + i);
+        }
+    }
+}
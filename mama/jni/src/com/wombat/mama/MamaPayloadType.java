@@ -35,6 +35,8 @@ public class MamaPayloadType
     public static final char MAMA_PAYLOAD_AVIS          =   'A';
     /** Tick42 BLP Message */
     public static final char MAMA_PAYLOAD_TICK42BLP     =   'B';
+    /** Flat Message */
+    public static final char MAMA_PAYLOAD_FLAT          =   'C';
     /** FAST Message */
     public static final char MAMA_PAYLOAD_FAST          =   'F';
     /** RAI Message */
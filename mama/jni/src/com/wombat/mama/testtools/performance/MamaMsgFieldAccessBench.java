@@ -0,0 +1,301 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+package com.wombat.mama.testtools.performance;
+
+import com.wombat.mama.*;
+
+/**
+ * Micro benchmark comparing the per field MamaMsg getters with the bulk
+ * MamaMsg.getFields / MamaMsgView path.
+ *
+ * It follows the JMH approach without depending on it: each mode is run
+ * for a number of warmup iterations whose results are discarded, then for
+ * a number of measured iterations reported as mean and standard deviation
+ * of nanoseconds per message. Values read are folded into a sink which is
+ * printed at the end so the JIT cannot eliminate the reads.
+ *
+ * It accepts the following command line arguments:
+ *      [-m middleware]    The middleware whose payload is used. Default
+ *                         value is "wmw".
+ *      [-fields n]        The number of fields read per message, the types
+ *                         cycle through I32, F64, STRING and PRICE.
+ *                         Default value is 30.
+ *      [-ops n]           The number of messages read per iteration.
+ *                         Default value is 100000.
+ *      [-warmup n]        The number of warmup iterations. Default 5.
+ *      [-iterations n]    The number of measured iterations. Default 10.
+ *
+ */
+public class MamaMsgFieldAccessBench
+{
+    private static String   myMiddleware    = "wmw";
+    private static int      myNumFields     = 30;
+    private static int      myOps           = 100000;
+    private static int      myWarmup        = 5;
+    private static int      myIterations    = 10;
+
+    private static final int TYPE_I32    = 0;
+    private static final int TYPE_F64    = 1;
+    private static final int TYPE_STRING = 2;
+    private static final int TYPE_PRICE  = 3;
+
+    private static long     mySink          = 0;
+
+    private interface Mode
+    {
+        String getName ();
+        void readAll (MamaMsg msg, int[] fids);
+    }
+
+    private static class PerFieldMode implements Mode
+    {
+        public String getName ()
+        {
+            return "per-field";
+        }
+
+        public void readAll (MamaMsg msg, int[] fids)
+        {
+            for (int i = 0; i < fids.length; i++)
+            {
+                switch (i % 4)
+                {
+                    case TYPE_I32:
+                        mySink += msg.getI32 (null, fids[i]);
+                        break;
+                    case TYPE_F64:
+                        mySink += (long) msg.getF64 (null, fids[i]);
+                        break;
+                    case TYPE_STRING:
+                        mySink += msg.getString (null, fids[i]).length ();
+                        break;
+                    case TYPE_PRICE:
+                        mySink += (long) msg.getPrice (null, fids[i])
+                                                .getValue ();
+                        break;
+                }
+            }
+        }
+    }
+
+    private static class ViewMode implements Mode
+    {
+        private final boolean myDecodeStrings;
+        private MamaMsgView   myView = null;
+        private byte[]        myBytes = new byte[256];
+
+        ViewMode (boolean decodeStrings)
+        {
+            myDecodeStrings = decodeStrings;
+        }
+
+        public String getName ()
+        {
+            return myDecodeStrings ? "view" : "view-bytes";
+        }
+
+        public void readAll (MamaMsg msg, int[] fids)
+        {
+            if (null == myView)
+            {
+                myView = new MamaMsgView (fids);
+            }
+            msg.getFields (myView);
+            for (int i = 0; i < fids.length; i++)
+            {
+                switch (i % 4)
+                {
+                    case TYPE_I32:
+                        mySink += myView.getInt (i);
+                        break;
+                    case TYPE_F64:
+                    case TYPE_PRICE:
+                        mySink += (long) myView.getDouble (i);
+                        break;
+                    case TYPE_STRING:
+                        if (myDecodeStrings)
+                        {
+                            mySink += myView.getString (i).length ();
+                        }
+                        else
+                        {
+                            mySink += myView.getBytes (i, myBytes, 0);
+                        }
+                        break;
+                }
+            }
+        }
+    }
+
+    public static void main (String[] args)
+    {
+        parseCommandLine (args);
+
+        try
+        {
+            Mama.loadBridge (myMiddleware);
+            Mama.open ();
+
+            int[]   fids = new int[myNumFields];
+            MamaMsg msg  = createMessage (fids);
+
+            Mode[] modes = { new PerFieldMode (),
+                             new ViewMode (true),
+                             new ViewMode (false) };
+
+            for (int m = 0; m < modes.length; m++)
+            {
+                run (modes[m], msg, fids);
+            }
+
+            System.out.println ("sink: " + mySink);
+
+            msg.destroy ();
+            Mama.close ();
+        }
+        catch (Exception e)
+        {
+            e.printStackTrace ();
+            System.exit (1);
+        }
+    }
+
+    private static MamaMsg createMessage (int[] fids)
+    {
+        MamaMsg   msg   = new MamaMsg ();
+        MamaPrice price = new MamaPrice (101.25);
+
+        for (int i = 0; i < fids.length; i++)
+        {
+            fids[i] = 100 + i;
+            switch (i % 4)
+            {
+                case TYPE_I32:
+                    msg.addI32 (null, fids[i], i);
+                    break;
+                case TYPE_F64:
+                    msg.addF64 (null, fids[i], i * 1.5);
+                    break;
+                case TYPE_STRING:
+                    msg.addString (null, fids[i], "SYMBOL." + i);
+                    break;
+                case TYPE_PRICE:
+                    msg.addPrice (null, fids[i], price);
+                    break;
+            }
+        }
+        return msg;
+    }
+
+    private static void run (Mode mode, MamaMsg msg, int[] fids)
+    {
+        double[] results = new double[myIterations];
+
+        for (int i = 0; i < myWarmup; i++)
+        {
+            iteration (mode, msg, fids);
+            System.out.println ("# Warmup Iteration " + (i + 1) + ": "
+                    + mode.getName ());
+        }
+
+        for (int i = 0; i < myIterations; i++)
+        {
+            results[i] = iteration (mode, msg, fids);
+            System.out.println ("Iteration " + (i + 1) + ": "
+                    + String.format ("%.1f ns/op", results[i]));
+        }
+
+        double mean = 0;
+        for (int i = 0; i < results.length; i++)
+        {
+            mean += results[i];
+        }
+        mean /= results.length;
+
+        double variance = 0;
+        for (int i = 0; i < results.length; i++)
+        {
+            variance += (results[i] - mean) * (results[i] - mean);
+        }
+        double stdDev = results.length > 1
+                      ? Math.sqrt (variance / (results.length - 1)) : 0;
+
+        System.out.println (String.format (
+                "Result %-12s %d fields: %12.1f +- %.1f ns/op",
+                mode.getName (), fids.length, mean, stdDev));
+    }
+
+    private static double iteration (Mode mode, MamaMsg msg, int[] fids)
+    {
+        long start = System.nanoTime ();
+        for (int op = 0; op < myOps; op++)
+        {
+            mode.readAll (msg, fids);
+        }
+        return (double) (System.nanoTime () - start) / myOps;
+    }
+
+    private static void parseCommandLine (String[] args)
+    {
+        for (int i = 0; i < args.length; )
+        {
+            String arg = args[i];
+
+            if ("-m".equals (arg))
+            {
+                myMiddleware = args[i+1];
+                i += 2;
+            }
+            else if ("-fields".equals (arg))
+            {
+                myNumFields = Integer.parseInt (args[i+1]);
+                i += 2;
+            }
+            else if ("-ops".equals (arg))
+            {
+                myOps = Integer.parseInt (args[i+1]);
+                i += 2;
+            }
+            else if ("-warmup".equals (arg))
+            {
+                myWarmup = Integer.parseInt (args[i+1]);
+                i += 2;
+            }
+            else if ("-iterations".equals (arg))
+            {
+                myIterations = Integer.parseInt (args[i+1]);
+                i += 2;
+            }
+            else
+            {
+                i++;
+            }
+        }
+        System.out.println (
+            "Starting MamaMsg field access benchmark with:\n" +
+            "   middleware:         " + myMiddleware + "\n" +
+            "   fields:             " + myNumFields  + "\n" +
+            "   ops:                " + myOps        + "\n" +
+            "   warmup:             " + myWarmup     + "\n" +
+            "   iterations:         " + myIterations + "\n");
+    }
+}
@@ -51,6 +51,7 @@ public class Main
         suite.addTestSuite(MamaInboxCallbacks.class);     
         suite.addTestSuite(MamaMsgAddArrayMsgWithLength.class); 
         suite.addTestSuite(MamaMsgGetByteBuffer.class);     
+        suite.addTestSuite(MamaMsgGetFields.class);
         suite.addTestSuite(MamaMsgGetStringAsCharBuffer.class); 
         suite.addTestSuite(MamaMsgTryMethods.class); 
         suite.addTestSuite(MamaMsgVectorFields.class); 
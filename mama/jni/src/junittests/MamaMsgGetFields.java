@@ -0,0 +1,162 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+package com.wombat.mama.junittests;
+
+import junit.framework.TestCase;
+import com.wombat.mama.*;
+import com.wombat.common.*;
+
+/**
+ *
+ * This class will test the MamaMsg.getFields() method and MamaMsgView.
+ */
+public class MamaMsgGetFields extends TestCase
+{
+    /* ****************************************************** */
+    /* Protected Member Variables. */
+    /* ****************************************************** */
+
+    // The bridge
+    MamaBridge mBridge;
+
+    // The message under test.
+    MamaMsg mMessage;
+
+    // A string long enough to force the view to grow its buffer
+    String mLongString;
+
+    /* ****************************************************** */
+    /* Protected Functions. */
+    /* ****************************************************** */
+
+    @Override
+    protected void setUp()
+    {
+         // Load the bridge
+        mBridge = Mama.loadBridge(Main.GetBridgeName());
+        Mama.open();
+
+        StringBuilder builder = new StringBuilder();
+        for (int i = 0; i < 100; i++)
+        {
+            builder.append("ABCDEFGHIJ");
+        }
+        mLongString = builder.toString();
+
+        // Create the message and add some data to it
+        mMessage = new MamaMsg();
+        mMessage.addI32(null, 1, -42);
+        mMessage.addF64(null, 2, 3.25);
+        mMessage.addString(null, 3, "IBM");
+        mMessage.addBoolean(null, 4, true);
+        mMessage.addU64(null, 5, 1234567890123L);
+        mMessage.addPrice(null, 6, new MamaPrice(99.5));
+        mMessage.addString(null, 7, mLongString);
+    }
+
+    @Override
+    protected void tearDown()
+    {
+        // Destroy the message
+        mMessage.destroy();
+        mMessage = null;
+
+        Mama.close();
+    }
+
+    /* ****************************************************** */
+    /* Test Functions. */
+    /* ****************************************************** */
+
+    public void testNullView()
+    {
+        try
+        {
+            mMessage.getFields(null);
+            fail();
+        }
+
+        catch(WombatException e)
+        {
+        }
+    }
+
+    public void testScalarFields()
+    {
+        MamaMsgView view = new MamaMsgView(new int[] {1, 2, 4, 5, 6});
+
+        mMessage.getFields(view);
+
+        assertEquals(MamaFieldDescriptor.I32, view.getType(0));
+        assertEquals(-42, view.getInt(0));
+        assertEquals(3.25, view.getDouble(1), 0.0);
+        assertTrue(view.getBoolean(2));
+        assertEquals(1234567890123L, view.getLong(3));
+        assertEquals(MamaFieldDescriptor.PRICE, view.getType(4));
+        assertEquals(99.5, view.getDouble(4), 0.0);
+    }
+
+    public void testStringFields()
+    {
+        // No room reserved for data so the long string forces a resize
+        MamaMsgView view = new MamaMsgView(new int[] {3, 7}, 0);
+
+        mMessage.getFields(view);
+
+        assertEquals("IBM", view.getString(0));
+        assertEquals(mLongString, view.getString(1));
+
+        byte[] bytes = new byte[3];
+        assertEquals(3, view.getBytes(0, bytes, 0));
+        assertEquals(-mLongString.length(), view.getBytes(1, bytes, 0));
+    }
+
+    public void testMissingField()
+    {
+        MamaMsgView view = new MamaMsgView(new int[] {1, 99});
+
+        mMessage.getFields(view);
+
+        assertTrue(view.isPresent(0));
+        assertFalse(view.isPresent(1));
+        assertEquals(MamaMsgView.TYPE_ABSENT, view.getType(1));
+        assertNull(view.getString(1));
+        assertEquals(1, view.indexOf(99));
+        assertEquals(-1, view.indexOf(1000));
+    }
+
+    public void testReuseAcrossMessages()
+    {
+        MamaMsgView view = new MamaMsgView(new int[] {1, 3});
+        MamaMsg     other = new MamaMsg();
+        other.addI32(null, 1, 7);
+
+        mMessage.getFields(view);
+        assertEquals("IBM", view.getString(1));
+
+        other.getFields(view);
+        assertEquals(7, view.getInt(0));
+        assertFalse(view.isPresent(1));
+
+        other.destroy();
+    }
+}
@@ -49,6 +49,7 @@ namespace Wombat
         void addCondition (MamdaQuery* query1);
         bool getXML       (char *restr);
         int  getDepth     ();
+        MamdaQuery** getConditions ();
 
         vector <MamdaQuery*> mConditions;
     };
@@ -84,6 +85,7 @@ namespace Wombat
         
         bool getXML     (char* restr);
         int  getDepth   ();
+        const char** getStrings ();
 
         condType        mType;
         bool            bVal;
@@ -129,6 +131,11 @@ namespace Wombat
     {
         return mInfoImpl.getSubscriptionInfo ();
     }
+
+    bool MamdaQuery::accept (MamdaQueryVisitor& visitor)
+    {
+        return false;
+    }
       
       
     void MamdaQuery::QueryInfoImpl::setSubscriptionInfo (MamdaSubscription* subscInfo)
@@ -167,6 +174,12 @@ namespace Wombat
         return mImpl.getDepth();
     }
 
+    bool MamdaOrQuery::accept (MamdaQueryVisitor& visitor)
+    {
+        return visitor.visitOr (mImpl.getConditions(),
+                                mImpl.mConditions.size());
+    }
+
     MamdaAndQuery::MamdaAndQuery (MamdaQuery* query1, MamdaQuery* query2)
         : mImpl(*new QueryImpl())
     {
@@ -195,6 +208,12 @@ namespace Wombat
         return mImpl.getDepth();
     }
 
+    bool MamdaAndQuery::accept (MamdaQueryVisitor& visitor)
+    {
+        return visitor.visitAnd (mImpl.getConditions(),
+                                 mImpl.mConditions.size());
+    }
+
     MamdaEqualsQuery::MamdaEqualsQuery (const char* field, const char* val)
         : mImpl(*new CondImpl())
     {
@@ -236,6 +255,16 @@ namespace Wombat
         return mImpl.getDepth();
     }
 
+    bool MamdaEqualsQuery::accept (MamdaQueryVisitor& visitor)
+    {
+        if (mImpl.mType != COND_TYPE_CHAR)
+            return false;
+
+        return visitor.visitEquals (mImpl.fieldName,
+                                    mImpl.getStrings(),
+                                    mImpl.mStrings.size());
+    }
+
     bool MamdaEqualsQuery::addItem (const char* item)
     {
         return mImpl.addString (item);
@@ -270,6 +299,11 @@ namespace Wombat
         return mImpl.getDepth();
     }
 
+    bool MamdaDateQuery::accept (MamdaQueryVisitor& visitor)
+    {
+        return visitor.visitDate (mImpl.startDate, mImpl.endDate);
+    }
+
     MamdaContainsAllQuery::MamdaContainsAllQuery (const char* field, const char * item)
         : mImpl(*new CondImpl())
     {
@@ -320,6 +354,16 @@ namespace Wombat
         return mImpl.getDepth();
     }
 
+    bool MamdaContainsAllQuery::accept (MamdaQueryVisitor& visitor)
+    {
+        if (mImpl.mType != COND_TYPE_CHAR)
+            return false;
+
+        return visitor.visitContainsAll (mImpl.fieldName,
+                                         mImpl.getStrings(),
+                                         mImpl.mStrings.size());
+    }
+
     MamdaContainsQuery::MamdaContainsQuery (const char *field, const char * item)
         : mImpl(*new CondImpl())
     {
@@ -369,6 +413,16 @@ namespace Wombat
         return mImpl.getDepth();
     }
 
+    bool MamdaContainsQuery::accept (MamdaQueryVisitor& visitor)
+    {
+        if (mImpl.mType != COND_TYPE_CHAR)
+            return false;
+
+        return visitor.visitContains (mImpl.fieldName,
+                                      mImpl.getStrings(),
+                                      mImpl.mStrings.size());
+    }
+
     MamdaQuery::QueryImpl::QueryImpl ()
     {
     }
@@ -403,6 +457,16 @@ namespace Wombat
         return level;
     }
 
+    MamdaQuery** MamdaQuery::QueryImpl::getConditions ()
+    {
+        return mConditions.empty() ? NULL : &mConditions[0];
+    }
+
+    const char** MamdaQuery::CondImpl::getStrings ()
+    {
+        return mStrings.empty() ? NULL : (const char**) &mStrings[0];
+    }
+
     void MamdaQuery::CondImpl::setField (const char* name)
     {
         fieldName = strdup(name);
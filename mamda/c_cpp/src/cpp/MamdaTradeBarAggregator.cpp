@@ -0,0 +1,752 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#include <mamda/MamdaTradeBarAggregator.h>
+#include <mamda/MamdaTradeBarHandler.h>
+#include <mamda/MamdaTradeListener.h>
+#include <mamda/MamdaTradeReport.h>
+#include <mamda/MamdaTradeCorrection.h>
+#include <mamda/MamdaTradeCancelOrError.h>
+#include <mamda/MamdaSubscription.h>
+#include <mama/mamacpp.h>
+
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+using std::deque;
+using std::map;
+using std::string;
+using std::vector;
+
+namespace Wombat
+{
+
+    /*
+     * A retained trade, kept so that corrections and cancels can be
+     * matched to it and its bar patched.
+     */
+    struct TradeBarTrade
+    {
+        mama_seqnum_t    mSeqNum;
+        mama_u64_t       mBarStart;
+        mama_u64_t       mTime;
+        double           mPrice;
+        mama_quantity_t  mVolume;
+        bool             mLive;
+    };
+
+    /*
+     * Per-security state.  The bars and trades themselves live in the
+     * aggregator's contiguous arrays, at symbolIndex * numBars and
+     * symbolIndex * numTrades respectively.
+     */
+    struct TradeBarSymbol
+    {
+        string           mSymbol;
+        mama_u32_t       mBarHead;      /* slot of the current bar */
+        mama_u32_t       mBarCount;
+        mama_u32_t       mTradeHead;    /* next slot to be written */
+        mama_u32_t       mTradeCount;
+        bool             mEvicted;      /* any live trade evicted yet */
+        mama_u64_t       mEvictedUpTo;  /* latest bar start of those */
+        bool             mCurrentClosed;
+    };
+
+    typedef deque<MamdaTradeBarHandler*>                HandlerList;
+    typedef map<const MamdaTradeListener*, mama_u32_t>  ListenerIndexMap;
+
+    struct MamdaTradeBarAggregator::MamdaTradeBarAggregatorImpl
+    {
+        MamdaTradeBarAggregatorImpl (MamdaTradeBarAggregator&  self,
+                                     mama_f64_t                intervalSeconds,
+                                     mama_u32_t                numBars,
+                                     mama_u32_t                numTrades);
+
+        mama_u32_t      addSymbol      (const char*       symbol);
+        mama_u32_t      lookupSymbol   (MamdaSubscription*         subscription,
+                                        const MamdaTradeListener&  listener);
+
+        mama_u64_t      getTradeTime   (const MamdaBasicEvent&     event) const;
+
+        MamdaTradeBar*  getBar         (mama_u32_t        symbolIndex,
+                                        mama_u32_t        age);
+
+        MamdaTradeBar*  findBar        (mama_u32_t        symbolIndex,
+                                        mama_u64_t        barStart,
+                                        bool&             closed);
+
+        TradeBarTrade*  findTrade      (mama_u32_t        symbolIndex,
+                                        mama_seqnum_t     seqNum);
+
+        void            addTrade       (mama_u32_t        symbolIndex,
+                                        mama_u64_t        time,
+                                        mama_seqnum_t     seqNum,
+                                        double            price,
+                                        mama_quantity_t   volume);
+
+        bool            amendTrade     (mama_u32_t        symbolIndex,
+                                        mama_seqnum_t     origSeqNum,
+                                        bool              cancel,
+                                        double            price,
+                                        mama_quantity_t   volume);
+
+        void            recordTrade    (mama_u32_t        symbolIndex,
+                                        mama_u64_t        barStart,
+                                        mama_u64_t        time,
+                                        mama_seqnum_t     seqNum,
+                                        double            price,
+                                        mama_quantity_t   volume);
+
+        void            rebuildBar     (mama_u32_t        symbolIndex,
+                                        MamdaTradeBar&    bar);
+
+        void            closeBars      (mama_u64_t        time);
+
+        void            invokeCloseHandlers      (mama_u32_t            symbolIndex,
+                                                  const MamdaTradeBar&  bar);
+
+        void            invokeCorrectionHandlers (mama_u32_t            symbolIndex,
+                                                  const MamdaTradeBar&  bar);
+
+        static void     startBar       (MamdaTradeBar&    bar,
+                                        mama_u64_t        barStart,
+                                        mama_u64_t        interval);
+
+        static void     applyTrade     (MamdaTradeBar&    bar,
+                                        mama_u64_t        time,
+                                        double            price,
+                                        mama_quantity_t   volume);
+
+        MamdaTradeBarAggregator&  mSelf;
+        mama_u64_t                mInterval;
+        mama_u32_t                mNumBars;
+        mama_u32_t                mNumTrades;
+        MamdaTradeBarTimeSource   mTimeSource;
+
+        vector<TradeBarSymbol>    mSymbols;
+        vector<MamdaTradeBar>     mBars;
+        vector<TradeBarTrade>     mTrades;
+
+        HandlerList               mHandlers;
+        ListenerIndexMap          mListenerIndex;
+        const MamdaTradeListener* mLastListener;
+        mama_u32_t                mLastIndex;
+
+        mama_u64_t                mLateTradeCount;
+        mama_u64_t                mUnmatchedCount;
+    };
+
+
+    MamdaTradeBarAggregator::MamdaTradeBarAggregator (
+        mama_f64_t  intervalSeconds,
+        mama_u32_t  numBars,
+        mama_u32_t  numTrades)
+        : mImpl (*new MamdaTradeBarAggregatorImpl (*this,
+                                                   intervalSeconds,
+                                                   numBars,
+                                                   numTrades))
+    {
+    }
+
+    MamdaTradeBarAggregator::~MamdaTradeBarAggregator ()
+    {
+        delete &mImpl;
+    }
+
+    void MamdaTradeBarAggregator::addHandler (MamdaTradeBarHandler*  handler)
+    {
+        mImpl.mHandlers.push_back (handler);
+    }
+
+    void MamdaTradeBarAggregator::setTimeSource (
+        MamdaTradeBarTimeSource  timeSource)
+    {
+        mImpl.mTimeSource = timeSource;
+    }
+
+    mama_u64_t MamdaTradeBarAggregator::getInterval () const
+    {
+        return mImpl.mInterval;
+    }
+
+    mama_u32_t MamdaTradeBarAggregator::addSymbol (const char*  symbol)
+    {
+        return mImpl.addSymbol (symbol);
+    }
+
+    mama_u32_t MamdaTradeBarAggregator::getSymbolCount () const
+    {
+        return (mama_u32_t) mImpl.mSymbols.size ();
+    }
+
+    const char* MamdaTradeBarAggregator::getSymbol (
+        mama_u32_t  symbolIndex) const
+    {
+        if (symbolIndex >= mImpl.mSymbols.size ())
+            return NULL;
+
+        return mImpl.mSymbols[symbolIndex].mSymbol.c_str ();
+    }
+
+    const MamdaTradeBar* MamdaTradeBarAggregator::getBar (
+        mama_u32_t  symbolIndex,
+        mama_u32_t  age) const
+    {
+        return mImpl.getBar (symbolIndex, age);
+    }
+
+    void MamdaTradeBarAggregator::addTrade (
+        mama_u32_t       symbolIndex,
+        mama_u64_t       time,
+        mama_seqnum_t    seqNum,
+        double           price,
+        mama_quantity_t  volume)
+    {
+        if (symbolIndex < mImpl.mSymbols.size ())
+            mImpl.addTrade (symbolIndex, time, seqNum, price, volume);
+    }
+
+    bool MamdaTradeBarAggregator::cancelTrade (
+        mama_u32_t     symbolIndex,
+        mama_seqnum_t  origSeqNum)
+    {
+        if (symbolIndex >= mImpl.mSymbols.size ())
+            return false;
+
+        return mImpl.amendTrade (symbolIndex, origSeqNum, true, 0.0, 0);
+    }
+
+    bool MamdaTradeBarAggregator::correctTrade (
+        mama_u32_t       symbolIndex,
+        mama_seqnum_t    origSeqNum,
+        double           price,
+        mama_quantity_t  volume)
+    {
+        if (symbolIndex >= mImpl.mSymbols.size ())
+            return false;
+
+        return mImpl.amendTrade (symbolIndex, origSeqNum, false, price, volume);
+    }
+
+    void MamdaTradeBarAggregator::closeBars (mama_u64_t  time)
+    {
+        mImpl.closeBars (time);
+    }
+
+    mama_u64_t MamdaTradeBarAggregator::getLateTradeCount () const
+    {
+        return mImpl.mLateTradeCount;
+    }
+
+    mama_u64_t MamdaTradeBarAggregator::getUnmatchedCount () const
+    {
+        return mImpl.mUnmatchedCount;
+    }
+
+    void MamdaTradeBarAggregator::onTradeRecap (
+        MamdaSubscription*              subscription,
+        MamdaTradeListener&             listener,
+        const MamaMsg&                  msg,
+        const MamdaTradeRecap&          recap)
+    {
+    }
+
+    void MamdaTradeBarAggregator::onTradeReport (
+        MamdaSubscription*              subscription,
+        MamdaTradeListener&             listener,
+        const MamaMsg&                  msg,
+        const MamdaTradeReport&         event,
+        const MamdaTradeRecap&          recap)
+    {
+        mImpl.addTrade (mImpl.lookupSymbol (subscription, listener),
+                        mImpl.getTradeTime (event),
+                        event.getEventSeqNum (),
+                        event.getTradePrice ().getValue (),
+                        event.getTradeVolume ());
+    }
+
+    void MamdaTradeBarAggregator::onTradeGap (
+        MamdaSubscription*              subscription,
+        MamdaTradeListener&             listener,
+        const MamaMsg&                  msg,
+        const MamdaTradeGap&            event,
+        const MamdaTradeRecap&          recap)
+    {
+    }
+
+    void MamdaTradeBarAggregator::onTradeCancelOrError (
+        MamdaSubscription*              subscription,
+        MamdaTradeListener&             listener,
+        const MamaMsg&                  msg,
+        const MamdaTradeCancelOrError&  event,
+        const MamdaTradeRecap&          recap)
+    {
+        mImpl.amendTrade (mImpl.lookupSymbol (subscription, listener),
+                          event.getOrigSeqNum (),
+                          true,
+                          0.0,
+                          0);
+    }
+
+    void MamdaTradeBarAggregator::onTradeCorrection (
+        MamdaSubscription*              subscription,
+        MamdaTradeListener&             listener,
+        const MamaMsg&                  msg,
+        const MamdaTradeCorrection&     event,
+        const MamdaTradeRecap&          recap)
+    {
+        mImpl.amendTrade (mImpl.lookupSymbol (subscription, listener),
+                          event.getOrigSeqNum (),
+                          false,
+                          event.getCorrPrice ().getValue (),
+                          event.getCorrVolume ());
+    }
+
+    void MamdaTradeBarAggregator::onTradeClosing (
+        MamdaSubscription*              subscription,
+        MamdaTradeListener&             listener,
+        const MamaMsg&                  msg,
+        const MamdaTradeClosing&        event,
+        const MamdaTradeRecap&          recap)
+    {
+    }
+
+    void MamdaTradeBarAggregator::onTradeOutOfSequence (
+        MamdaSubscription*              subscription,
+        MamdaTradeListener&             listener,
+        const MamaMsg&                  msg,
+        const MamdaTradeOutOfSequence&  event,
+        const MamdaTradeRecap&          recap)
+    {
+    }
+
+    void MamdaTradeBarAggregator::onTradePossiblyDuplicate (
+        MamdaSubscription*                  subscription,
+        MamdaTradeListener&                 listener,
+        const MamaMsg&                      msg,
+        const MamdaTradePossiblyDuplicate&  event,
+        const MamdaTradeRecap&              recap)
+    {
+    }
+
+
+    MamdaTradeBarAggregator::MamdaTradeBarAggregatorImpl::MamdaTradeBarAggregatorImpl (
+        MamdaTradeBarAggregator&  self,
+        mama_f64_t                intervalSeconds,
+        mama_u32_t                numBars,
+        mama_u32_t                numTrades)
+        : mSelf            (self)
+        , mInterval        ((mama_u64_t) (intervalSeconds * 1000000.0 + 0.5))
+        , mNumBars         (numBars   > 0 ? numBars   : 1)
+        , mNumTrades       (numTrades > 0 ? numTrades : 1)
+        , mTimeSource      (MAMDA_TRADE_BAR_EVENT_TIME)
+        , mLastListener    (NULL)
+        , mLastIndex       (0)
+        , mLateTradeCount  (0)
+        , mUnmatchedCount  (0)
+    {
+        if (mInterval == 0)
+            mInterval = 1;
+    }
+
+    mama_u32_t MamdaTradeBarAggregator::MamdaTradeBarAggregatorImpl::addSymbol (
+        const char*  symbol)
+    {
+        mama_u32_t symbolIndex = (mama_u32_t) mSymbols.size ();
+
+        TradeBarSymbol state;
+        state.mSymbol        = symbol ? symbol : "";
+        state.mBarHead       = 0;
+        state.mBarCount      = 0;
+        state.mTradeHead     = 0;
+        state.mTradeCount    = 0;
+        state.mEvicted       = false;
+        state.mEvictedUpTo   = 0;
+        state.mCurrentClosed = false;
+        mSymbols.push_back (state);
+
+        mBars.resize   (mSymbols.size () * mNumBars);
+        mTrades.resize (mSymbols.size () * mNumTrades);
+
+        mama_log (MAMA_LOG_LEVEL_FINE,
+                  "MamdaTradeBarAggregator: added %s as symbol index %u",
+                  state.mSymbol.c_str (), symbolIndex);
+
+        return symbolIndex;
+    }
+
+    mama_u32_t MamdaTradeBarAggregator::MamdaTradeBarAggregatorImpl::lookupSymbol (
+        MamdaSubscription*         subscription,
+        const MamdaTradeListener&  listener)
+    {
+        /* Updates for one security tend to arrive in bursts. */
+        if (&listener == mLastListener)
+            return mLastIndex;
+
+        ListenerIndexMap::iterator found = mListenerIndex.find (&listener);
+        if (found == mListenerIndex.end ())
+        {
+            mama_u32_t symbolIndex =
+                addSymbol (subscription ? subscription->getSymbol () : NULL);
+            found = mListenerIndex.insert (
+                ListenerIndexMap::value_type (&listener, symbolIndex)).first;
+        }
+
+        mLastListener = &listener;
+        mLastIndex    = found->second;
+        return mLastIndex;
+    }
+
+    mama_u64_t MamdaTradeBarAggregator::MamdaTradeBarAggregatorImpl::getTradeTime (
+        const MamdaBasicEvent&  event) const
+    {
+        mama_u64_t eventTime = event.getEventTime ().getEpochTimeMicroseconds ();
+        mama_u64_t srcTime   = event.getSrcTime   ().getEpochTimeMicroseconds ();
+
+        /* Fall back to the other time if the preferred one is not sent. */
+        if (mTimeSource == MAMDA_TRADE_BAR_SRC_TIME)
+            return srcTime ? srcTime : eventTime;
+
+        return eventTime ? eventTime : srcTime;
+    }
+
+    MamdaTradeBar* MamdaTradeBarAggregator::MamdaTradeBarAggregatorImpl::getBar (
+        mama_u32_t  symbolIndex,
+        mama_u32_t  age)
+    {
+        if (symbolIndex >= mSymbols.size ())
+            return NULL;
+
+        const TradeBarSymbol& state = mSymbols[symbolIndex];
+        if (age >= state.mBarCount)
+            return NULL;
+
+        mama_u32_t slot = (state.mBarHead + mNumBars - age) % mNumBars;
+        return &mBars[symbolIndex * mNumBars + slot];
+    }
+
+    MamdaTradeBar* MamdaTradeBarAggregator::MamdaTradeBarAggregatorImpl::findBar (
+        mama_u32_t  symbolIndex,
+        mama_u64_t  barStart,
+        bool&       closed)
+    {
+        const TradeBarSymbol& state = mSymbols[symbolIndex];
+
+        for (mama_u32_t age = 0; age < state.mBarCount; ++age)
+        {
+            MamdaTradeBar* bar = getBar (symbolIndex, age);
+            if (bar->mStartTime == barStart)
+            {
+                closed = age > 0 || state.mCurrentClosed;
+                return bar;
+            }
+            if (bar->mStartTime < barStart)
+                break;
+        }
+        return NULL;
+    }
+
+    TradeBarTrade* MamdaTradeBarAggregator::MamdaTradeBarAggregatorImpl::findTrade (
+        mama_u32_t     symbolIndex,
+        mama_seqnum_t  seqNum)
+    {
+        const TradeBarSymbol& state  = mSymbols[symbolIndex];
+        TradeBarTrade*        trades = &mTrades[symbolIndex * mNumTrades];
+
+        /* Amendments usually refer to recent trades: search newest first. */
+        mama_u32_t slot = state.mTradeHead;
+        for (mama_u32_t i = 0; i < state.mTradeCount; ++i)
+        {
+            slot = (slot + mNumTrades - 1) % mNumTrades;
+            if (trades[slot].mLive && trades[slot].mSeqNum == seqNum)
+                return &trades[slot];
+        }
+        return NULL;
+    }
+
+    void MamdaTradeBarAggregator::MamdaTradeBarAggregatorImpl::addTrade (
+        mama_u32_t       symbolIndex,
+        mama_u64_t       time,
+        mama_seqnum_t    seqNum,
+        double           price,
+        mama_quantity_t  volume)
+    {
+        TradeBarSymbol& state    = mSymbols[symbolIndex];
+        mama_u64_t      barStart = time - time % mInterval;
+        MamdaTradeBar*  current  = getBar (symbolIndex, 0);
+
+        if (!current || barStart > current->mStartTime)
+        {
+            /* Roll over to a new bar, reporting the one it replaces. */
+            if (current && !state.mCurrentClosed)
+                invokeCloseHandlers (symbolIndex, *current);
+
+            state.mBarHead = (state.mBarHead + 1) % mNumBars;
+            if (state.mBarCount < mNumBars)
+                ++state.mBarCount;
+            state.mCurrentClosed = false;
+
+            current = getBar (symbolIndex, 0);
+            startBar   (*current, barStart, mInterval);
+            applyTrade (*current, time, price, volume);
+        }
+        else if (barStart == current->mStartTime)
+        {
+            applyTrade (*current, time, price, volume);
+        }
+        else
+        {
+            /* A late trade: patch the earlier bar if it is retained. */
+            bool           closed = false;
+            MamdaTradeBar* bar    = findBar (symbolIndex, barStart, closed);
+            if (!bar)
+            {
+                ++mLateTradeCount;
+                return;
+            }
+
+            applyTrade (*bar, time, price, volume);
+            if (closed)
+                invokeCorrectionHandlers (symbolIndex, *bar);
+        }
+
+        recordTrade (symbolIndex, barStart, time, seqNum, price, volume);
+    }
+
+    bool MamdaTradeBarAggregator::MamdaTradeBarAggregatorImpl::amendTrade (
+        mama_u32_t       symbolIndex,
+        mama_seqnum_t    origSeqNum,
+        bool             cancel,
+        double           price,
+        mama_quantity_t  volume)
+    {
+        TradeBarTrade* trade = findTrade (symbolIndex, origSeqNum);
+        if (!trade)
+        {
+            ++mUnmatchedCount;
+            return false;
+        }
+
+        bool           closed = false;
+        MamdaTradeBar* bar    = findBar (symbolIndex, trade->mBarStart, closed);
+        if (!bar)
+        {
+            /* The trade's bar has already been dropped. */
+            trade->mLive = false;
+            ++mUnmatchedCount;
+            return false;
+        }
+
+        double          oldPrice  = trade->mPrice;
+        mama_quantity_t oldVolume = trade->mVolume;
+
+        if (cancel)
+        {
+            trade->mLive = false;
+        }
+        else
+        {
+            trade->mPrice  = price;
+            trade->mVolume = volume;
+        }
+
+        const TradeBarSymbol& state = mSymbols[symbolIndex];
+        if (!state.mEvicted || bar->mStartTime > state.mEvictedUpTo)
+        {
+            /* Every trade of the bar is retained: rebuild it exactly. */
+            rebuildBar (symbolIndex, *bar);
+        }
+        else
+        {
+            /* Only the totals can be patched exactly; high and low may
+             * only widen, and open and close are left alone. */
+            bar->mVolume   -= oldVolume;
+            bar->mNotional -= oldPrice * oldVolume;
+            if (cancel)
+            {
+                if (bar->mTradeCount > 0)
+                    --bar->mTradeCount;
+            }
+            else
+            {
+                bar->mVolume   += volume;
+                bar->mNotional += price * volume;
+                if (price > bar->mHigh) bar->mHigh = price;
+                if (price < bar->mLow)  bar->mLow  = price;
+            }
+        }
+
+        if (closed)
+            invokeCorrectionHandlers (symbolIndex, *bar);
+
+        return true;
+    }
+
+    void MamdaTradeBarAggregator::MamdaTradeBarAggregatorImpl::recordTrade (
+        mama_u32_t       symbolIndex,
+        mama_u64_t       barStart,
+        mama_u64_t       time,
+        mama_seqnum_t    seqNum,
+        double           price,
+        mama_quantity_t  volume)
+    {
+        TradeBarSymbol& state = mSymbols[symbolIndex];
+        TradeBarTrade&  trade = mTrades[symbolIndex * mNumTrades + state.mTradeHead];
+
+        if (state.mTradeCount == mNumTrades && trade.mLive)
+        {
+            if (!state.mEvicted || trade.mBarStart > state.mEvictedUpTo)
+                state.mEvictedUpTo = trade.mBarStart;
+            state.mEvicted = true;
+        }
+
+        trade.mSeqNum   = seqNum;
+        trade.mBarStart = barStart;
+        trade.mTime     = time;
+        trade.mPrice    = price;
+        trade.mVolume   = volume;
+        trade.mLive     = true;
+
+        state.mTradeHead = (state.mTradeHead + 1) % mNumTrades;
+        if (state.mTradeCount < mNumTrades)
+            ++state.mTradeCount;
+    }
+
+    void MamdaTradeBarAggregator::MamdaTradeBarAggregatorImpl::rebuildBar (
+        mama_u32_t      symbolIndex,
+        MamdaTradeBar&  bar)
+    {
+        const TradeBarSymbol& state  = mSymbols[symbolIndex];
+        const TradeBarTrade*  trades = &mTrades[symbolIndex * mNumTrades];
+
+        startBar (bar, bar.mStartTime, mInterval);
+
+        /* Replay the bar's live trades, oldest first. */
+        mama_u32_t slot = (state.mTradeHead + mNumTrades - state.mTradeCount)
+                          % mNumTrades;
+        for (mama_u32_t i = 0; i < state.mTradeCount; ++i)
+        {
+            const TradeBarTrade& trade = trades[slot];
+            if (trade.mLive && trade.mBarStart == bar.mStartTime)
+                applyTrade (bar, trade.mTime, trade.mPrice, trade.mVolume);
+            slot = (slot + 1) % mNumTrades;
+        }
+    }
+
+    void MamdaTradeBarAggregator::MamdaTradeBarAggregatorImpl::closeBars (
+        mama_u64_t  time)
+    {
+        for (mama_u32_t i = 0; i < mSymbols.size (); ++i)
+        {
+            TradeBarSymbol& state = mSymbols[i];
+            if (state.mBarCount == 0 || state.mCurrentClosed)
+                continue;
+
+            MamdaTradeBar* current = getBar (i, 0);
+            if (current->mEndTime <= time)
+            {
+                state.mCurrentClosed = true;
+                invokeCloseHandlers (i, *current);
+            }
+        }
+    }
+
+    void MamdaTradeBarAggregator::MamdaTradeBarAggregatorImpl::invokeCloseHandlers (
+        mama_u32_t            symbolIndex,
+        const MamdaTradeBar&  bar)
+    {
+        const char* symbol = mSymbols[symbolIndex].mSymbol.c_str ();
+
+        for (HandlerList::iterator i = mHandlers.begin (); i != mHandlers.end (); ++i)
+        {
+            (*i)->onTradeBarClose (mSelf, symbolIndex, symbol, bar);
+        }
+    }
+
+    void MamdaTradeBarAggregator::MamdaTradeBarAggregatorImpl::invokeCorrectionHandlers (
+        mama_u32_t            symbolIndex,
+        const MamdaTradeBar&  bar)
+    {
+        const char* symbol = mSymbols[symbolIndex].mSymbol.c_str ();
+
+        for (HandlerList::iterator i = mHandlers.begin (); i != mHandlers.end (); ++i)
+        {
+            (*i)->onTradeBarCorrection (mSelf, symbolIndex, symbol, bar);
+        }
+    }
+
+    void MamdaTradeBarAggregator::MamdaTradeBarAggregatorImpl::startBar (
+        MamdaTradeBar&  bar,
+        mama_u64_t      barStart,
+        mama_u64_t      interval)
+    {
+        bar.mStartTime  = barStart;
+        bar.mEndTime    = barStart + interval;
+        bar.mOpenTime   = 0;
+        bar.mCloseTime  = 0;
+        bar.mOpen       = 0.0;
+        bar.mHigh       = 0.0;
+        bar.mLow        = 0.0;
+        bar.mClose      = 0.0;
+        bar.mVolume     = 0;
+        bar.mNotional   = 0.0;
+        bar.mTradeCount = 0;
+    }
+
+    void MamdaTradeBarAggregator::MamdaTradeBarAggregatorImpl::applyTrade (
+        MamdaTradeBar&   bar,
+        mama_u64_t       time,
+        double           price,
+        mama_quantity_t  volume)
+    {
+        if (bar.mTradeCount == 0)
+        {
+            bar.mOpen     = bar.mHigh = bar.mLow = bar.mClose = price;
+            bar.mOpenTime = bar.mCloseTime = time;
+        }
+        else
+        {
+            if (price > bar.mHigh) bar.mHigh = price;
+            if (price < bar.mLow)  bar.mLow  = price;
+
+            /* Trades may arrive out of order: the open and close belong
+             * to the earliest and latest trades by time, not arrival. */
+            if (time < bar.mOpenTime)
+            {
+                bar.mOpen     = price;
+                bar.mOpenTime = time;
+            }
+            if (time >= bar.mCloseTime)
+            {
+                bar.mClose     = price;
+                bar.mCloseTime = time;
+            }
+        }
+
+        bar.mVolume   += volume;
+        bar.mNotional += price * volume;
+        ++bar.mTradeCount;
+    }
+
+} // namespace
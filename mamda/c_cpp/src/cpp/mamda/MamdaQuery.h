@@ -23,6 +23,7 @@
 #define MamdaUtilsH
 
 #include <mamda/MamdaConfig.h>
+#include <stddef.h>
 
 namespace Wombat
 {
@@ -30,6 +31,7 @@ namespace Wombat
     class MamdaNewsQueryHandler;
     class MamaDateTime;
     class MamdaSubscription;
+    class MamdaQueryVisitor;
 
     class MAMDAExpDLL MamdaQuery
     {
@@ -40,6 +42,14 @@ namespace Wombat
         bool         getQuery (char *&result);
         virtual int  getDepth () = 0;
 
+        /**
+         * Pass the structure of the query to a visitor, e.g. to evaluate
+         * it locally.  Returns false if the query (or part of it) cannot
+         * be expressed to a visitor, in which case it can only be
+         * evaluated by the publisher.
+         */
+        virtual bool accept   (MamdaQueryVisitor& visitor);
+
         struct QueryImpl;
         struct CondImpl;
         struct QueryInfoImpl;
@@ -62,6 +72,7 @@ namespace Wombat
         
         bool getXML   (char*       result);
         int  getDepth ();
+        bool accept   (MamdaQueryVisitor& visitor);
         void addQuery (MamdaQuery* query1);
         
     private:
@@ -76,6 +87,7 @@ namespace Wombat
         
         bool getXML   (char*       result);
         int  getDepth ();
+        bool accept   (MamdaQueryVisitor& visitor);
         void addQuery (MamdaQuery* query1);
             
     private:
@@ -98,6 +110,7 @@ namespace Wombat
 
         bool getXML      (char*       result);
         int  getDepth    ();
+        bool accept      (MamdaQueryVisitor& visitor);
 
     private:
         CondImpl&  mImpl;
@@ -112,6 +125,7 @@ namespace Wombat
 
         bool getXML    (char *result);
         int  getDepth  ();
+        bool accept    (MamdaQueryVisitor& visitor);
         
     private:
         CondImpl&  mImpl;
@@ -131,6 +145,7 @@ namespace Wombat
 
         bool getXML           (char* result);
         int  getDepth         ();
+        bool accept           (MamdaQueryVisitor& visitor);
 
     private:
         CondImpl&  mImpl;
@@ -151,11 +166,49 @@ namespace Wombat
 
         bool getXML        (char* result);
         int  getDepth      ();
+        bool accept        (MamdaQueryVisitor& visitor);
         
     private:
         CondImpl&  mImpl;
     };
 
+
+    /**
+     * MamdaQueryVisitor is an interface for walking the structure of a
+     * MamdaQuery (see MamdaQuery::accept()).  Only string-valued
+     * conditions are passed to visitors; each method returns whether the
+     * visit succeeded.
+     */
+    class MAMDAExpDLL MamdaQueryVisitor
+    {
+    public:
+        virtual ~MamdaQueryVisitor () {}
+
+        virtual bool visitOr          (MamdaQuery**  queries,
+                                       size_t        numQueries) = 0;
+
+        virtual bool visitAnd         (MamdaQuery**  queries,
+                                       size_t        numQueries) = 0;
+
+        virtual bool visitEquals      (const char*   field,
+                                       const char**  values,
+                                       size_t        numValues) = 0;
+
+        virtual bool visitContains    (const char*   field,
+                                       const char**  values,
+                                       size_t        numValues) = 0;
+
+        virtual bool visitContainsAll (const char*   field,
+                                       const char**  values,
+                                       size_t        numValues) = 0;
+
+        /**
+         * Visit a date range; times are milliseconds since the epoch.
+         */
+        virtual bool visitDate        (double        start,
+                                       double        end) = 0;
+    };
+
 } //namespace
 
 #endif
@@ -0,0 +1,88 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#ifndef MamdaTradeBarH
+#define MamdaTradeBarH
+
+#include <mamda/MamdaConfig.h>
+#include <mama/mamacpp.h>
+
+namespace Wombat
+{
+
+    /**
+     * Enumeration for the time used to assign trades to bars.
+     */
+    enum MamdaTradeBarTimeSource
+    {
+        MAMDA_TRADE_BAR_EVENT_TIME = 0,   /**< The trade's event time. */
+        MAMDA_TRADE_BAR_SRC_TIME   = 1    /**< The exchange (source) time. */
+    };
+
+    /**
+     * MamdaTradeBar holds the open/high/low/close, volume and VWAP
+     * state of one interval of trades for one security, as maintained
+     * by MamdaTradeBarAggregator.  Times are in microseconds since the
+     * epoch (or since midnight, if the feed provides times without
+     * dates).
+     */
+    struct MAMDAExpDLL MamdaTradeBar
+    {
+        /** Start of the interval (inclusive). */
+        mama_u64_t       mStartTime;
+
+        /** End of the interval (exclusive). */
+        mama_u64_t       mEndTime;
+
+        /** Time of the trade which set the open. */
+        mama_u64_t       mOpenTime;
+
+        /** Time of the trade which set the close. */
+        mama_u64_t       mCloseTime;
+
+        double           mOpen;
+        double           mHigh;
+        double           mLow;
+        double           mClose;
+
+        /** Total volume traded in the interval. */
+        mama_quantity_t  mVolume;
+
+        /** Sum of price * volume, for the VWAP. */
+        double           mNotional;
+
+        /** Number of trades in the interval. */
+        mama_u32_t       mTradeCount;
+
+        /**
+         * Return the volume weighted average price of the interval, or
+         * zero if there is no volume.
+         */
+        double getVwap () const
+        {
+            return (mVolume > 0) ? mNotional / mVolume : 0.0;
+        }
+    };
+
+} // namespace
+
+#endif // MamdaTradeBarH
@@ -0,0 +1,249 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#ifndef MamdaTradeBarAggregatorH
+#define MamdaTradeBarAggregatorH
+
+#include <mamda/MamdaConfig.h>
+#include <mamda/MamdaTradeBar.h>
+#include <mamda/MamdaTradeHandler.h>
+#include <mama/mamacpp.h>
+
+namespace Wombat
+{
+
+    class MamdaTradeBarHandler;
+
+    /**
+     * MamdaTradeBarAggregator builds fixed-interval OHLC/volume/VWAP bars
+     * incrementally from the trades decoded by MamdaTradeListener.  It is
+     * a MamdaTradeHandler, so it is simply added to the trade listener of
+     * each security of interest; one aggregator may be shared by many
+     * securities.  Per-security bars and trade history are kept in
+     * contiguous arrays, indexed by the security's symbol index.
+     *
+     * Trades are assigned to intervals by their event time (or, if
+     * configured, their exchange time).  Trade corrections and
+     * cancels/errors are matched to the original trade by sequence
+     * number and patch the affected bar in place.  Only the most recent
+     * numBars bars and numTrades trades of each security are retained;
+     * amendments to older trades cannot be applied and are counted as
+     * unmatched.
+     *
+     * The aggregator can also be driven directly (e.g. from recorded
+     * data) via addSymbol(), addTrade(), cancelTrade() and
+     * correctTrade().
+     */
+    class MAMDAExpDLL MamdaTradeBarAggregator : public MamdaTradeHandler
+    {
+    public:
+
+        /**
+         * Constructor.
+         *
+         * @param intervalSeconds The bar interval.
+         * @param numBars         The number of bars retained per security.
+         * @param numTrades       The number of trades retained per
+         * security for applying corrections and cancels.
+         */
+        MamdaTradeBarAggregator (mama_f64_t  intervalSeconds,
+                                 mama_u32_t  numBars   = 16,
+                                 mama_u32_t  numTrades = 1024);
+
+        virtual ~MamdaTradeBarAggregator ();
+
+        /**
+         * Add a handler to be notified of completed and amended bars.
+         *
+         * @param handler The handler to add.
+         */
+        void addHandler (MamdaTradeBarHandler*  handler);
+
+        /**
+         * Set the time used to assign trades to bars.  The default is
+         * the event time.
+         *
+         * @param timeSource The time source.
+         */
+        void setTimeSource (MamdaTradeBarTimeSource  timeSource);
+
+        /**
+         * Return the bar interval in microseconds.
+         */
+        mama_u64_t getInterval () const;
+
+        /**
+         * Add a security and return its symbol index.  Securities seen
+         * via a MamdaTradeListener are added automatically.
+         *
+         * @param symbol The security symbol.
+         * @return The symbol index.
+         */
+        mama_u32_t addSymbol (const char*  symbol);
+
+        /**
+         * Return the number of securities in the aggregator.
+         */
+        mama_u32_t getSymbolCount () const;
+
+        /**
+         * Return the symbol for a symbol index.
+         */
+        const char* getSymbol (mama_u32_t  symbolIndex) const;
+
+        /**
+         * Return a bar for a security: age zero is the current (most
+         * recent) bar, age one the bar before it, and so on.  Returns
+         * NULL if no such bar is retained.  The pointer is valid until
+         * the next security is added.
+         *
+         * @param symbolIndex The symbol index.
+         * @param age         The age of the bar.
+         */
+        const MamdaTradeBar* getBar (mama_u32_t  symbolIndex,
+                                     mama_u32_t  age = 0) const;
+
+        /**
+         * Apply a trade.
+         *
+         * @param symbolIndex The symbol index.
+         * @param time        The trade time in microseconds.
+         * @param seqNum      The trade's sequence number, used to match
+         * later corrections and cancels.
+         * @param price       The trade price.
+         * @param volume      The trade volume.
+         */
+        void addTrade (mama_u32_t       symbolIndex,
+                       mama_u64_t       time,
+                       mama_seqnum_t    seqNum,
+                       double           price,
+                       mama_quantity_t  volume);
+
+        /**
+         * Remove a previously applied trade from its bar.
+         *
+         * @param symbolIndex The symbol index.
+         * @param origSeqNum  The sequence number of the original trade.
+         * @return Whether the original trade was found.
+         */
+        bool cancelTrade (mama_u32_t     symbolIndex,
+                          mama_seqnum_t  origSeqNum);
+
+        /**
+         * Replace the price and volume of a previously applied trade.
+         *
+         * @param symbolIndex The symbol index.
+         * @param origSeqNum  The sequence number of the original trade.
+         * @param price       The corrected price.
+         * @param volume      The corrected volume.
+         * @return Whether the original trade was found.
+         */
+        bool correctTrade (mama_u32_t       symbolIndex,
+                           mama_seqnum_t    origSeqNum,
+                           double           price,
+                           mama_quantity_t  volume);
+
+        /**
+         * Close (and report) the current bar of every security whose
+         * interval ended at or before the given time.  Useful for
+         * closing bars of quiet securities, e.g. from a timer.
+         *
+         * @param time The current time in microseconds.
+         */
+        void closeBars (mama_u64_t  time);
+
+        /**
+         * Return the number of trades which arrived too late to be
+         * assigned to a retained bar.
+         */
+        mama_u64_t getLateTradeCount () const;
+
+        /**
+         * Return the number of corrections and cancels whose original
+         * trade was not retained.
+         */
+        mama_u64_t getUnmatchedCount () const;
+
+        // MamdaTradeHandler implementation.
+        void onTradeRecap (
+            MamdaSubscription*              subscription,
+            MamdaTradeListener&             listener,
+            const MamaMsg&                  msg,
+            const MamdaTradeRecap&          recap);
+
+        void onTradeReport (
+            MamdaSubscription*              subscription,
+            MamdaTradeListener&             listener,
+            const MamaMsg&                  msg,
+            const MamdaTradeReport&         event,
+            const MamdaTradeRecap&          recap);
+
+        void onTradeGap (
+            MamdaSubscription*              subscription,
+            MamdaTradeListener&             listener,
+            const MamaMsg&                  msg,
+            const MamdaTradeGap&            event,
+            const MamdaTradeRecap&          recap);
+
+        void onTradeCancelOrError (
+            MamdaSubscription*              subscription,
+            MamdaTradeListener&             listener,
+            const MamaMsg&                  msg,
+            const MamdaTradeCancelOrError&  event,
+            const MamdaTradeRecap&          recap);
+
+        void onTradeCorrection (
+            MamdaSubscription*              subscription,
+            MamdaTradeListener&             listener,
+            const MamaMsg&                  msg,
+            const MamdaTradeCorrection&     event,
+            const MamdaTradeRecap&          recap);
+
+        void onTradeClosing (
+            MamdaSubscription*              subscription,
+            MamdaTradeListener&             listener,
+            const MamaMsg&                  msg,
+            const MamdaTradeClosing&        event,
+            const MamdaTradeRecap&          recap);
+
+        void onTradeOutOfSequence (
+            MamdaSubscription*              subscription,
+            MamdaTradeListener&             listener,
+            const MamaMsg&                  msg,
+            const MamdaTradeOutOfSequence&  event,
+            const MamdaTradeRecap&          recap);
+
+        void onTradePossiblyDuplicate (
+            MamdaSubscription*                  subscription,
+            MamdaTradeListener&                 listener,
+            const MamaMsg&                      msg,
+            const MamdaTradePossiblyDuplicate&  event,
+            const MamdaTradeRecap&              recap);
+
+    private:
+        struct MamdaTradeBarAggregatorImpl;
+        MamdaTradeBarAggregatorImpl& mImpl;
+    };
+
+} // namespace
+
+#endif // MamdaTradeBarAggregatorH
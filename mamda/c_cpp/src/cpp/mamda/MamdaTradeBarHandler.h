@@ -0,0 +1,79 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#ifndef MamdaTradeBarHandlerH
+#define MamdaTradeBarHandlerH
+
+#include <mamda/MamdaConfig.h>
+#include <mamda/MamdaTradeBar.h>
+
+namespace Wombat
+{
+
+    class MamdaTradeBarAggregator;
+
+    /**
+     * MamdaTradeBarHandler is an interface for applications that want
+     * to be notified of completed (and subsequently amended) trade bars
+     * from a MamdaTradeBarAggregator.
+     */
+    class MAMDAExpDLL MamdaTradeBarHandler
+    {
+    public:
+
+        /**
+         * Method invoked when a bar is complete, either because a trade
+         * arrived for a later interval or because
+         * MamdaTradeBarAggregator::closeBars() was called.
+         *
+         * @param aggregator  The aggregator which maintains the bar.
+         * @param symbolIndex The aggregator's index for the security.
+         * @param symbol      The security symbol.
+         * @param bar         The completed bar.
+         */
+        virtual void onTradeBarClose (
+            MamdaTradeBarAggregator&  aggregator,
+            mama_u32_t                symbolIndex,
+            const char*               symbol,
+            const MamdaTradeBar&      bar) = 0;
+
+        /**
+         * Method invoked when a completed bar has been patched by a
+         * late trade, a trade correction or a trade cancel/error.
+         *
+         * @param aggregator  The aggregator which maintains the bar.
+         * @param symbolIndex The aggregator's index for the security.
+         * @param symbol      The security symbol.
+         * @param bar         The amended bar.
+         */
+        virtual void onTradeBarCorrection (
+            MamdaTradeBarAggregator&  aggregator,
+            mama_u32_t                symbolIndex,
+            const char*               symbol,
+            const MamdaTradeBar&      bar) = 0;
+
+        virtual ~MamdaTradeBarHandler() {};
+    };
+
+} // namespace
+
+#endif // MamdaTradeBarHandlerH
@@ -0,0 +1,451 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#include "MamdaNewsHeadlineIndex.h"
+#include <algorithm>
+#include <iterator>
+#include <ctype.h>
+#include <string.h>
+
+using std::deque;
+using std::string;
+using std::vector;
+
+namespace Wombat
+{
+
+    typedef void (MamdaNewsHeadline::*ListGetter) (const char**&  values,
+                                                   mama_size_t&   numValues) const;
+
+    typedef const char* (MamdaNewsHeadline::*ScalarGetter) () const;
+
+    struct ListField
+    {
+        const char*   mName;
+        ListGetter    mGetter;
+    };
+
+    struct ScalarField
+    {
+        const char*   mName;
+        ScalarGetter  mGetter;
+    };
+
+    static const ListField gListFields[] =
+    {
+        { "wNewsNativeCodes",   &MamdaNewsHeadline::getNativeCodes },
+        { "wNewsNativeSymbols", &MamdaNewsHeadline::getNativeRelatedSymbols },
+        { "wNewsIndustries",    &MamdaNewsHeadline::getIndustries },
+        { "wNewsMarketSectors", &MamdaNewsHeadline::getMarketSectors },
+        { "wNewsRegions",       &MamdaNewsHeadline::getRegions },
+        { "wNewsCountries",     &MamdaNewsHeadline::getCountries },
+        { "wNewsProducts",      &MamdaNewsHeadline::getProducts },
+        { "wNewsTopics",        &MamdaNewsHeadline::getTopics },
+        { "wNewsMiscCodes",     &MamdaNewsHeadline::getMiscCodes },
+        { "wNewsSymbols",       &MamdaNewsHeadline::getRelatedSymbols }
+    };
+
+    static const ScalarField gScalarFields[] =
+    {
+        { "wNewsHeadlineId",    &MamdaNewsHeadline::getHeadlineId },
+        { "wNewsStoryId",       &MamdaNewsHeadline::getNewsStoryId },
+        { "wNewsOrigStoryId",   &MamdaNewsHeadline::getNewsOrigStoryId },
+        { "wNewsSourceId",      &MamdaNewsHeadline::getNewsSourceId },
+        { "wNewsOrigSourceId",  &MamdaNewsHeadline::getNewsOrigSourceId },
+        { "wNewsLangId",        &MamdaNewsHeadline::getLanguageId }
+    };
+
+    static const char* const HEADLINE_FIELD = "wNewsHeadline";
+
+    static const size_t NUM_LIST_FIELDS =
+        sizeof (gListFields) / sizeof (gListFields[0]);
+
+    static const size_t NUM_SCALAR_FIELDS =
+        sizeof (gScalarFields) / sizeof (gScalarFields[0]);
+
+    static bool isIndexedField (const char* field)
+    {
+        if (!field)
+            return false;
+
+        for (size_t i = 0; i < NUM_LIST_FIELDS; ++i)
+            if (0 == strcmp (field, gListFields[i].mName))
+                return true;
+
+        for (size_t i = 0; i < NUM_SCALAR_FIELDS; ++i)
+            if (0 == strcmp (field, gScalarFields[i].mName))
+                return true;
+
+        return false;
+    }
+
+    static bool isSearchableField (const char* field)
+    {
+        return isIndexedField (field) ||
+               (field && 0 == strcmp (field, HEADLINE_FIELD));
+    }
+
+    static string makeTerm (const char* field, const char* value)
+    {
+        string term (field);
+        term += '\001';
+        term += value;
+        return term;
+    }
+
+    /* Split text into lower case alphanumeric words. */
+    static void splitWords (const char* text, vector<string>& words)
+    {
+        string word;
+        for (const char* p = text; p && *p; ++p)
+        {
+            if (isalnum ((unsigned char) *p))
+            {
+                word += (char) tolower ((unsigned char) *p);
+            }
+            else if (!word.empty())
+            {
+                words.push_back (word);
+                word.clear();
+            }
+        }
+        if (!word.empty())
+            words.push_back (word);
+    }
+
+    static void intersect (vector<mama_u64_t>& result, const vector<mama_u64_t>& rhs)
+    {
+        vector<mama_u64_t> out;
+        std::set_intersection (result.begin(), result.end(),
+                               rhs.begin(), rhs.end(),
+                               std::back_inserter (out));
+        result.swap (out);
+    }
+
+    static void unite (vector<mama_u64_t>& result, const vector<mama_u64_t>& rhs)
+    {
+        vector<mama_u64_t> out;
+        std::set_union (result.begin(), result.end(),
+                        rhs.begin(), rhs.end(),
+                        std::back_inserter (out));
+        result.swap (out);
+    }
+
+
+    MamdaNewsHeadlineIndex::MamdaNewsHeadlineIndex ()
+        : mMaxHeadlines   (0)
+        , mNextSeq        (0)
+        , mCoverageStart  (0)
+        , mCovered        (false)
+        , mResultComplete (false)
+    {
+    }
+
+    MamdaNewsHeadlineIndex::~MamdaNewsHeadlineIndex ()
+    {
+        clear();
+    }
+
+    void MamdaNewsHeadlineIndex::setMaxHeadlines (mama_u32_t  maxHeadlines)
+    {
+        mMaxHeadlines = maxHeadlines;
+        while (mEntries.size() > mMaxHeadlines)
+            evictOldest();
+    }
+
+    mama_u32_t MamdaNewsHeadlineIndex::size () const
+    {
+        return (mama_u32_t) mEntries.size();
+    }
+
+    mama_u64_t MamdaNewsHeadlineIndex::getCoverageStart () const
+    {
+        return mCovered ? mCoverageStart : 0;
+    }
+
+    void MamdaNewsHeadlineIndex::add (
+        const MamaMsg&            msg,
+        const MamdaNewsHeadline&  headline)
+    {
+        if (mMaxHeadlines == 0)
+            return;
+
+        while (mEntries.size() >= mMaxHeadlines)
+            evictOldest();
+
+        Entry* entry = new Entry (msg, headline);
+        entry->mSeq  = mNextSeq++;
+        entry->mTime = headline.getEventTime().getEpochTimeMilliseconds();
+
+        // Nothing from before the first headline seen is held.
+        if (!mCovered)
+        {
+            mCoverageStart = entry->mTime;
+            mCovered       = true;
+        }
+
+        vector<string>& terms = entry->mTerms;
+
+        for (size_t i = 0; i < NUM_LIST_FIELDS; ++i)
+        {
+            const char** values    = NULL;
+            mama_size_t  numValues = 0;
+            (headline.*gListFields[i].mGetter) (values, numValues);
+
+            for (mama_size_t j = 0; j < numValues; ++j)
+                if (values[j])
+                    terms.push_back (makeTerm (gListFields[i].mName, values[j]));
+        }
+
+        for (size_t i = 0; i < NUM_SCALAR_FIELDS; ++i)
+        {
+            const char* value = (headline.*gScalarFields[i].mGetter) ();
+            if (value && *value)
+                terms.push_back (makeTerm (gScalarFields[i].mName, value));
+        }
+
+        vector<string> words;
+        splitWords (headline.getHeadlineText(), words);
+        for (size_t i = 0; i < words.size(); ++i)
+            terms.push_back (makeTerm (HEADLINE_FIELD, words[i].c_str()));
+
+        // A term is posted once per headline, even if repeated.
+        std::sort (terms.begin(), terms.end());
+        terms.erase (std::unique (terms.begin(), terms.end()), terms.end());
+
+        for (size_t i = 0; i < terms.size(); ++i)
+            mPostings[terms[i]].push_back (entry->mSeq);
+
+        mEntries.push_back (entry);
+    }
+
+    void MamdaNewsHeadlineIndex::clear ()
+    {
+        while (!mEntries.empty())
+        {
+            delete mEntries.front();
+            mEntries.pop_front();
+        }
+        mPostings.clear();
+        mCovered = false;
+    }
+
+    void MamdaNewsHeadlineIndex::evictOldest ()
+    {
+        Entry* entry = mEntries.front();
+        mEntries.pop_front();
+
+        // The window no longer covers anything up to the evicted headline.
+        if (entry->mTime >= mCoverageStart)
+            mCoverageStart = entry->mTime + 1;
+
+        // Posting lists are in arrival order, so the oldest is at the front.
+        for (size_t i = 0; i < entry->mTerms.size(); ++i)
+        {
+            PostingMap::iterator found = mPostings.find (entry->mTerms[i]);
+            if (found == mPostings.end())
+                continue;
+
+            deque<mama_u64_t>& postings = found->second;
+            if (!postings.empty() && postings.front() == entry->mSeq)
+                postings.pop_front();
+            if (postings.empty())
+                mPostings.erase (found);
+        }
+        delete entry;
+    }
+
+    bool MamdaNewsHeadlineIndex::evaluate (
+        MamdaQuery&  query,
+        Results&     results)
+    {
+        results.clear();
+        mResult.clear();
+        mResultComplete = false;
+
+        if (!query.accept (*this) || !mResultComplete)
+            return false;
+
+        if (mEntries.empty())
+            return true;
+
+        mama_u64_t first = mEntries.front()->mSeq;
+        for (size_t i = 0; i < mResult.size(); ++i)
+            results.push_back (mEntries[(size_t) (mResult[i] - first)]);
+
+        return true;
+    }
+
+    void MamdaNewsHeadlineIndex::lookup (
+        const char*  field,
+        const char*  value,
+        SeqList&     result)
+    {
+        result.clear();
+
+        if (0 == strcmp (field, HEADLINE_FIELD))
+        {
+            // All of the words of the value must appear in the headline.
+            vector<string> words;
+            splitWords (value, words);
+            for (size_t i = 0; i < words.size(); ++i)
+            {
+                SeqList wordResult;
+                getPostings (makeTerm (HEADLINE_FIELD, words[i].c_str()),
+                             wordResult);
+                if (i == 0)
+                    result.swap (wordResult);
+                else
+                    intersect (result, wordResult);
+            }
+        }
+        else
+        {
+            getPostings (makeTerm (field, value), result);
+        }
+    }
+
+    void MamdaNewsHeadlineIndex::getPostings (
+        const string&  term,
+        SeqList&       result) const
+    {
+        PostingMap::const_iterator found = mPostings.find (term);
+        if (found != mPostings.end())
+            result.assign (found->second.begin(), found->second.end());
+        else
+            result.clear();
+    }
+
+    bool MamdaNewsHeadlineIndex::visitOr (
+        MamdaQuery**  queries,
+        size_t        numQueries)
+    {
+        // A union is complete only if every branch is.
+        SeqList result;
+        bool    complete = true;
+        for (size_t i = 0; i < numQueries; ++i)
+        {
+            if (!queries[i]->accept (*this))
+                return false;
+            unite (result, mResult);
+            complete = complete && mResultComplete;
+        }
+        mResult.swap (result);
+        mResultComplete = complete;
+        return true;
+    }
+
+    bool MamdaNewsHeadlineIndex::visitAnd (
+        MamdaQuery**  queries,
+        size_t        numQueries)
+    {
+        // An intersection is complete if any branch is.
+        SeqList result;
+        bool    complete = false;
+        for (size_t i = 0; i < numQueries; ++i)
+        {
+            if (!queries[i]->accept (*this))
+                return false;
+            if (i == 0)
+                result.swap (mResult);
+            else
+                intersect (result, mResult);
+            complete = complete || mResultComplete;
+        }
+        mResult.swap (result);
+        mResultComplete = complete;
+        return true;
+    }
+
+    bool MamdaNewsHeadlineIndex::visitEquals (
+        const char*   field,
+        const char**  values,
+        size_t        numValues)
+    {
+        // For list fields, equality means membership of the list.
+        if (!isIndexedField (field))
+            return false;
+
+        return visitContains (field, values, numValues);
+    }
+
+    bool MamdaNewsHeadlineIndex::visitContains (
+        const char*   field,
+        const char**  values,
+        size_t        numValues)
+    {
+        if (!isSearchableField (field))
+            return false;
+
+        SeqList result;
+        SeqList valueResult;
+        for (size_t i = 0; i < numValues; ++i)
+        {
+            lookup (field, values[i], valueResult);
+            unite (result, valueResult);
+        }
+        mResult.swap (result);
+        mResultComplete = false;
+        return true;
+    }
+
+    bool MamdaNewsHeadlineIndex::visitContainsAll (
+        const char*   field,
+        const char**  values,
+        size_t        numValues)
+    {
+        if (!isSearchableField (field))
+            return false;
+
+        SeqList result;
+        SeqList valueResult;
+        for (size_t i = 0; i < numValues; ++i)
+        {
+            lookup (field, values[i], valueResult);
+            if (i == 0)
+                result.swap (valueResult);
+            else
+                intersect (result, valueResult);
+        }
+        mResult.swap (result);
+        mResultComplete = false;
+        return true;
+    }
+
+    bool MamdaNewsHeadlineIndex::visitDate (
+        double  start,
+        double  end)
+    {
+        mResult.clear();
+        for (size_t i = 0; i < mEntries.size(); ++i)
+        {
+            const Entry* entry = mEntries[i];
+            if (entry->mTime >= start && entry->mTime <= end)
+                mResult.push_back (entry->mSeq);
+        }
+
+        // Headlines in the range may have been evicted, or never seen.
+        mResultComplete = mCovered && start >= (double) mCoverageStart;
+        return true;
+    }
+
+} // namespace
@@ -0,0 +1,138 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#ifndef MamdaNewsHeadlineIndexH
+#define MamdaNewsHeadlineIndexH
+
+#include <mamda/MamdaOptionalConfig.h>
+#include <mamda/MamdaNewsHeadline.h>
+#include <mamda/MamdaQuery.h>
+#include <mama/mamacpp.h>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Wombat
+{
+
+    /*
+     * MamdaNewsHeadlineIndex keeps the most recent broadcast headlines
+     * together with an inverted index over their codes, symbols, ids
+     * and headline words, so that MamdaQuery conditions over those
+     * fields can be evaluated locally.  Fields are named as in the data
+     * dictionary (e.g. "wNewsSymbols"); headline words ("wNewsHeadline")
+     * are matched case-insensitively, everything else exactly.
+     *
+     * The index only holds a bounded window of headlines, so a query is
+     * answered locally only if it is restricted to a date range that the
+     * window covers; anything else must go to the server.
+     */
+    class MamdaNewsHeadlineIndex : public MamdaQueryVisitor
+    {
+    public:
+        struct Entry
+        {
+            mama_u64_t                 mSeq;
+            MamaMsg                    mMsg;
+            MamdaNewsHeadline          mHeadline;
+            std::vector<std::string>   mTerms;
+            mama_u64_t                 mTime;
+
+            Entry (const MamaMsg& msg, const MamdaNewsHeadline& headline)
+                : mSeq (0), mMsg (msg), mHeadline (headline), mTime (0) {}
+        };
+
+        typedef std::vector<const Entry*>  Results;
+
+        MamdaNewsHeadlineIndex ();
+        virtual ~MamdaNewsHeadlineIndex ();
+
+        void        setMaxHeadlines (mama_u32_t  maxHeadlines);
+        mama_u32_t  getMaxHeadlines () const { return mMaxHeadlines; }
+        mama_u32_t  size            () const;
+
+        /*
+         * The event time (epoch milliseconds) from which every headline
+         * seen is still held; zero if nothing is covered yet.
+         */
+        mama_u64_t  getCoverageStart () const;
+
+        void        add             (const MamaMsg&            msg,
+                                     const MamdaNewsHeadline&  headline);
+        void        clear           ();
+
+        /*
+         * Evaluate a query against the indexed headlines.  Returns false
+         * if the query cannot be evaluated locally, or if it may match
+         * headlines outside the window; otherwise results holds the
+         * matching headlines, oldest first.
+         */
+        bool        evaluate        (MamdaQuery&  query,
+                                     Results&     results);
+
+        // MamdaQueryVisitor implementation.
+        bool visitOr          (MamdaQuery**  queries,
+                               size_t        numQueries);
+
+        bool visitAnd         (MamdaQuery**  queries,
+                               size_t        numQueries);
+
+        bool visitEquals      (const char*   field,
+                               const char**  values,
+                               size_t        numValues);
+
+        bool visitContains    (const char*   field,
+                               const char**  values,
+                               size_t        numValues);
+
+        bool visitContainsAll (const char*   field,
+                               const char**  values,
+                               size_t        numValues);
+
+        bool visitDate        (double        start,
+                               double        end);
+
+    private:
+        typedef std::vector<mama_u64_t>                   SeqList;
+        typedef std::map<std::string, std::deque<mama_u64_t> >  PostingMap;
+
+        void        evictOldest     ();
+        void        lookup          (const char*   field,
+                                     const char*   value,
+                                     SeqList&      result);
+        void        getPostings     (const std::string&  term,
+                                     SeqList&            result) const;
+
+        std::deque<Entry*>  mEntries;
+        PostingMap          mPostings;
+        mama_u32_t          mMaxHeadlines;
+        mama_u64_t          mNextSeq;
+        mama_u64_t          mCoverageStart;
+        bool                mCovered;
+        SeqList             mResult;
+        bool                mResultComplete;
+    };
+
+} // namespace
+
+#endif // MamdaNewsHeadlineIndexH
@@ -25,19 +25,55 @@
 #include <mamda/MamdaMsgListener.h>
 #include <mamda/MamdaSubscription.h>
 #include <mamda/MamdaQuery.h>
+#include <mamda/MamdaLock.h>
 #include <mama/MamaReservedFields.h>
 #include <mama/MamaTimerCallback.h>
 #include <mama/MamaTimer.h>
+#include <mama/MamaQueueEventCallback.h>
+#include "MamdaNewsHeadlineIndex.h"
 #include <deque>
+#include <list>
+#include <map>
 #include <string>
+#include <utility>
 #include <assert.h>
 
 using std::string;
 using std::deque;
+using std::list;
+using std::map;
+using std::pair;
 
 namespace Wombat
 {
 
+    class StoryRequestHandler;
+
+    /*
+     * Stories are identified by their source and story ID.
+     */
+    typedef pair<MamaSource*, string>  StoryKey;
+
+    struct CachedStory
+    {
+        CachedStory (const MamaMsg&  msg)
+            : mMsg (msg), mBytes (0) {}
+
+        MamaMsg                   mMsg;
+        MamdaNewsStory            mStory;
+        mama_size_t               mBytes;
+        list<StoryKey>::iterator  mLruPos;
+    };
+
+    /*
+     * Requests are only shared between callers on the same queue, as
+     * the story is delivered from the queue of the request.
+     */
+    typedef pair<MamaQueue*, StoryKey>  InflightKey;
+
+    typedef map<StoryKey, CachedStory*>             StoryCache;
+    typedef map<InflightKey, StoryRequestHandler*>  InflightStoryMap;
+
     class MamdaNewsManager::MamdaNewsManagerImpl
     {
     public:
@@ -115,6 +151,55 @@ namespace Wombat
             const MamaMsg&            msg,
             MamdaNewsStoryHandler*    replyHandler);
 
+        void decodeStory (
+            const MamaMsg&            msg,
+            MamdaNewsStory&           story);
+
+        void deliverStory (
+            MamdaNewsStoryHandler*    handler,
+            const MamaMsg&            msg,
+            const MamdaNewsStory&     story,
+            void*                     closure);
+
+        void setStoryCacheSize (
+            mama_u32_t                maxStories,
+            mama_size_t               maxBytes);
+
+        // Called with the story lock held.
+        const CachedStory* findCachedStory (
+            const StoryKey&           key);
+
+        void cacheStory (
+            const StoryKey&           key,
+            const MamaMsg&            msg,
+            const MamdaNewsStory&     story);
+
+        // Called with the story lock held.
+        void evictStory (
+            StoryCache::iterator      entry);
+
+        void trimStoryCache ();
+
+        void invalidateStory (
+            MamaSource*               source,
+            const MamdaNewsHeadline&  headline);
+
+        void indexHeadline (
+            const MamaMsg&            msg,
+            const MamdaNewsHeadline&  headline);
+
+        void setHeadlineIndexSize (
+            mama_u32_t                maxHeadlines);
+
+        void clearHeadlineIndex ();
+
+        bool executeLocalQuery (
+            MamaQueue*                queue,
+            MamaSource*               source,
+            MamdaQuery*               newsQuery,
+            MamdaNewsQueryHandler*    handler,
+            void*                     closure);
+
         void onError (
             MamdaSubscription*        subscription,
             MamdaErrorSeverity        severity,
@@ -138,6 +223,29 @@ namespace Wombat
         string*         mXmlString;
         MamaMsg*        mMessage;
         int             timeoutValue;
+
+        // Story cache (most recently used at the front), requests in
+        // progress, the headline index and their counters, which may be
+        // used from the queues of any of the subscriptions.
+        MamdaLock                          mStoryLock;
+        inline void acquireLock ()
+            { ACQUIRE_WLOCK(mStoryLock); }
+        inline void releaseLock ()
+            { RELEASE_WLOCK(mStoryLock); }
+
+        StoryCache                         mStoryCache;
+        list<StoryKey>                     mStoryLru;
+        mama_u32_t                         mMaxCachedStories;
+        mama_size_t                        mMaxCachedBytes;
+        mama_size_t                        mCachedBytes;
+        InflightStoryMap                   mInflightStories;
+
+        MamdaNewsHeadlineIndex             mHeadlineIndex;
+
+        mama_u32_t                         mStoryCacheHitCount;
+        mama_u32_t                         mStoryFetchCount;
+        mama_u32_t                         mCoalescedStoryCount;
+        mama_u32_t                         mLocalQueryCount;
         
         void removeSubscription (MamdaSubscription* subscription);
         
@@ -167,6 +275,9 @@ namespace Wombat
                 
                 mHeadline.setSubscriptionInfo (subscription);
 
+                mImpl.invalidateStory (subscription->getSource(), mHeadline);
+                mImpl.indexHeadline (msg, mHeadline);
+
                 deque<MamdaNewsHeadlineHandler*>::iterator end = mImpl.mHeadlineHandlers.end();
                 deque<MamdaNewsHeadlineHandler*>::iterator iter;
 
@@ -203,6 +314,10 @@ namespace Wombat
             MamdaSubscription*        subscription,
             mamaQuality               quality)
         { 
+            // Headlines may have been missed, so the window has a gap.
+            if (quality != MAMA_QUALITY_OK)
+                mImpl.clearHeadlineIndex ();
+
             mImpl.onQuality (subscription, quality); 
         }
 
@@ -267,6 +382,227 @@ namespace Wombat
         MamdaNewsStoryHandler*                   mHandler;
     };
 
+    class StoryRequestHandler : public MamdaMsgListener
+                              , public MamdaErrorListener
+                              , public MamdaQualityListener
+    {
+    public:
+        StoryRequestHandler (
+            MamdaNewsManager::MamdaNewsManagerImpl&  impl,
+            MamaQueue*                               queue,
+            const StoryKey&                          key)
+            : mImpl  (impl)
+            , mQueue (queue)
+            , mKey   (key)
+        {}
+
+        virtual ~StoryRequestHandler () {}
+
+        void addWaiter (
+            MamdaNewsStoryHandler*    handler,
+            void*                     closure)
+        {
+            mWaiters.push_back (Waiter (handler, closure));
+        }
+
+        void onMsg (
+            MamdaSubscription*        subscription,
+            const MamaMsg&            msg,
+            short                     msgType)
+        {
+            try
+            {
+                MamdaNewsStory  story;
+                mImpl.decodeStory (msg, story);
+                story.setSubscInfo (subscription->getQueue(),
+                                    subscription->getSource());
+
+                // Detach first, so that handlers may request it again.
+                detach();
+
+                if (story.getStatus() == MamdaNewsStory::FULL_STORY)
+                    mImpl.cacheStory (mKey, msg, story);
+
+                for (size_t i = 0; i < mWaiters.size(); ++i)
+                {
+                    mImpl.deliverStory (mWaiters[i].first,
+                                        msg,
+                                        story,
+                                        mWaiters[i].second);
+                }
+            }
+            catch (MamaStatus& e)
+            {
+                mama_log (MAMA_LOG_LEVEL_NORMAL,
+                          "caught MamaStatus exception: %s", 
+                          e.toString());
+            }
+
+            // This was a request for a single story, so we can delete the
+            // subscription.
+            delete subscription;
+            delete this;
+        }
+
+        void onError (
+            MamdaSubscription*        subscription,
+            MamdaErrorSeverity        severity,
+            MamdaErrorCode            code,
+            const char*               errorStr)
+        { 
+            // Let later requests for the story try again.
+            detach();
+
+            mImpl.onError (subscription, 
+                           severity, 
+                           code, 
+                           errorStr); 
+        }
+
+        void onQuality (
+            MamdaSubscription*        subscription,
+            mamaQuality               quality)
+        { 
+            mImpl.onQuality (subscription, quality); 
+        }
+
+    private:
+        typedef pair<MamdaNewsStoryHandler*, void*>  Waiter;
+
+        void detach ()
+        {
+            mImpl.acquireLock();
+            InflightStoryMap::iterator found =
+                mImpl.mInflightStories.find (InflightKey (mQueue, mKey));
+            if (found != mImpl.mInflightStories.end() && found->second == this)
+                mImpl.mInflightStories.erase (found);
+            mImpl.releaseLock();
+        }
+
+        MamdaNewsManager::MamdaNewsManagerImpl&  mImpl;
+        MamaQueue*                               mQueue;
+        StoryKey                                 mKey;
+        deque<Waiter>                            mWaiters;
+    };
+
+
+    class CachedStoryEvent : public MamaQueueEventCallback
+    {
+    public:
+        CachedStoryEvent (
+            MamdaNewsManager::MamdaNewsManagerImpl&  impl,
+            const CachedStory&                       cached,
+            MamdaNewsStoryHandler*                   handler,
+            void*                                    closure)
+            : mImpl    (impl)
+            , mMsg     (cached.mMsg)
+            , mStory   (cached.mStory)
+            , mHandler (handler)
+            , mClosure (closure)
+        {}
+
+        virtual ~CachedStoryEvent () {}
+
+        void onEvent (
+            MamaQueue&                queue,
+            void*                     closure)
+        {
+            mImpl.deliverStory (mHandler, mMsg, mStory, mClosure);
+            delete this;
+        }
+
+    private:
+        MamdaNewsManager::MamdaNewsManagerImpl&  mImpl;
+        MamaMsg                                  mMsg;
+        MamdaNewsStory                           mStory;
+        MamdaNewsStoryHandler*                   mHandler;
+        void*                                    mClosure;
+    };
+
+
+    class LocalQueryEvent : public MamaQueueEventCallback
+    {
+    public:
+        LocalQueryEvent (
+            MamdaNewsManager::MamdaNewsManagerImpl&  impl,
+            MamdaNewsQueryHandler*                   handler,
+            MamaQueue*                               queue,
+            MamaSource*                              source,
+            MamdaQuery*                              query,
+            void*                                    closure)
+            : mImpl    (impl)
+            , mHandler (handler)
+            , mQueue   (queue)
+            , mSource  (source)
+            , mQuery   (query)
+            , mClosure (closure)
+        {}
+
+        virtual ~LocalQueryEvent ()
+        {
+            for (size_t i = 0; i < mMsgs.size(); ++i)
+                delete mMsgs[i];
+        }
+
+        void addResult (const MamdaNewsHeadlineIndex::Entry&  entry)
+        {
+            mMsgs.push_back (new MamaMsg (entry.mMsg));
+            mHeadlines.push_back (entry.mHeadline);
+        }
+
+        void onEvent (
+            MamaQueue&                queue,
+            void*                     closure)
+        {
+            for (size_t i = 0; i < mMsgs.size(); ++i)
+            {
+                mHeadlines[i].setSubscInfo (mQueue, mSource);
+                mHandler->onNewsQueryHeadline (mImpl.mManager,
+                                               *mMsgs[i],
+                                               mHeadlines[i],
+                                               *mQuery,
+                                               mClosure);
+            }
+
+            mHandler->onNewsQueryComplete (mImpl.mManager,
+                                           *mQuery,
+                                           mClosure);
+            delete this;
+        }
+
+    private:
+        MamdaNewsManager::MamdaNewsManagerImpl&  mImpl;
+        MamdaNewsQueryHandler*                   mHandler;
+        MamaQueue*                               mQueue;
+        MamaSource*                              mSource;
+        MamdaQuery*                              mQuery;
+        void*                                    mClosure;
+        deque<MamaMsg*>                          mMsgs;
+        deque<MamdaNewsHeadline>                 mHeadlines;
+    };
+
+    /*
+     * Locally answered requests are still delivered from the queue, as
+     * they would be from the publisher.
+     */
+    static void enqueueLocalEvent (
+        MamaQueue*               queue,
+        MamaQueueEventCallback*  event)
+    {
+        try
+        {
+            queue->enqueueEvent (event, NULL);
+        }
+        catch (MamaStatus& e)
+        {
+            mama_log (MAMA_LOG_LEVEL_FINE,
+                      "MamdaNewsManager: could not enqueue event (%s); "
+                      "delivering immediately",
+                      e.toString());
+            event->onEvent (*queue, NULL);
+        }
+    }
+
     #define QUERY_TYPE_FLD_FID		    4001
     #define QUERY_TYPE_FLD_NAME	        "NewsQueryType"
     #define QUERY_FLD_FID   			4002		
@@ -655,12 +991,65 @@ namespace Wombat
         mImpl.clearQuerySources ();
     }
 
+    void MamdaNewsManager::setStoryCacheSize (
+        mama_u32_t   maxStories,
+        mama_size_t  maxBytes)
+    {
+        mImpl.setStoryCacheSize (maxStories, maxBytes);
+    }
+
+    void MamdaNewsManager::setHeadlineIndexSize (
+        mama_u32_t   maxHeadlines)
+    {
+        mImpl.setHeadlineIndexSize (maxHeadlines);
+    }
+
+    mama_u32_t MamdaNewsManager::getStoryCacheHitCount () const
+    {
+        mImpl.acquireLock();
+        mama_u32_t count = mImpl.mStoryCacheHitCount;
+        mImpl.releaseLock();
+        return count;
+    }
+
+    mama_u32_t MamdaNewsManager::getStoryFetchCount () const
+    {
+        mImpl.acquireLock();
+        mama_u32_t count = mImpl.mStoryFetchCount;
+        mImpl.releaseLock();
+        return count;
+    }
+
+    mama_u32_t MamdaNewsManager::getCoalescedStoryRequestCount () const
+    {
+        mImpl.acquireLock();
+        mama_u32_t count = mImpl.mCoalescedStoryCount;
+        mImpl.releaseLock();
+        return count;
+    }
+
+    mama_u32_t MamdaNewsManager::getLocalQueryCount () const
+    {
+        mImpl.acquireLock();
+        mama_u32_t count = mImpl.mLocalQueryCount;
+        mImpl.releaseLock();
+        return count;
+    }
+
     MamdaNewsManager::MamdaNewsManagerImpl::MamdaNewsManagerImpl (
         MamdaNewsManager&  manager)
         : mManager (manager),
 	    mPublisher (NULL),
 	    mXmlString (NULL),
-	    mMessage   (NULL)
+	    mMessage   (NULL),
+        mStoryLock           (MamdaLock::EXCLUSIVE, "MamdaNewsManager(stories)"),
+        mMaxCachedStories    (0),
+        mMaxCachedBytes      (0),
+        mCachedBytes         (0),
+        mStoryCacheHitCount  (0),
+        mStoryFetchCount     (0),
+        mCoalescedStoryCount (0),
+        mLocalQueryCount     (0)
     {
         const char * timeoutString = Mama::getProperty ("mama.properties.server.timeout");
         if( timeoutString == NULL )
@@ -674,6 +1063,11 @@ namespace Wombat
     {
         clearBroadcastHeadlineSources ();
         clearBroadcastStorySources ();
+
+        acquireLock();
+        while (!mStoryCache.empty())
+            evictStory (mStoryCache.begin());
+        releaseLock();
     }
 
     void MamdaNewsManager::MamdaNewsManagerImpl::requestStory (
@@ -703,14 +1097,53 @@ namespace Wombat
                   "MamdaNewsManager: got request for story ID: %s",
                   storyId);
 
-        MamdaSubscription*  storySubsc    = new MamdaSubscription;
-        StoryMsgHandler* aStoryMsgHandler = new StoryMsgHandler (*this, handler);
+        StoryKey     key (source, storyId ? storyId : "");
+        InflightKey  inflightKey (queue, key);
+
+        acquireLock();
 
-        storySubsc->addMsgListener     (aStoryMsgHandler);
-        storySubsc->addErrorListener   (aStoryMsgHandler);
-        storySubsc->addQualityListener (aStoryMsgHandler);
+        const CachedStory* cached = queue ? findCachedStory (key) : NULL;
+        if (cached)
+        {
+            ++mStoryCacheHitCount;
+            CachedStoryEvent* event = new CachedStoryEvent (*this,
+                                                            *cached,
+                                                            handler,
+                                                            closure);
+            releaseLock();
+
+            enqueueLocalEvent (queue, event);
+            return;
+        }
+
+        // Share a single request between everyone waiting for the story
+        // on this queue.
+        InflightStoryMap::iterator inflight = mInflightStories.find (inflightKey);
+        if (inflight != mInflightStories.end())
+        {
+            ++mCoalescedStoryCount;
+            inflight->second->addWaiter (handler, closure);
+            releaseLock();
+            return;
+        }
+
+        MamdaSubscription*    storySubsc    = new MamdaSubscription;
+        StoryRequestHandler*  aStoryRequest = new StoryRequestHandler (*this,
+                                                                       queue,
+                                                                       key);
+
+        aStoryRequest->addWaiter (handler, closure);
+
+        storySubsc->addMsgListener     (aStoryRequest);
+        storySubsc->addErrorListener   (aStoryRequest);
+        storySubsc->addQualityListener (aStoryRequest);
         storySubsc->setMdDataType      (MAMA_MD_DATA_TYPE_NEWS_STORY);
 
+        mInflightStories[inflightKey] = aStoryRequest;
+        ++mStoryFetchCount;
+
+        releaseLock();
+
         storySubsc->create (queue, 
                             source, 
                             storyId, 
@@ -727,6 +1160,12 @@ namespace Wombat
     {
         mama_log (MAMA_LOG_LEVEL_FINE,
                   "MamdaNewsManager: got query");
+
+        if ((queryType == QUERY_TYPE_HISTORICAL) &&
+            executeLocalQuery (queue, source, newsQuery, handler, closure))
+        {
+            return;
+        }
         
         if (!mPublisher)
         {
@@ -1164,6 +1603,40 @@ namespace Wombat
         MamdaSubscription*      subscription,
         const MamaMsg&          msg,
         MamdaNewsStoryHandler*  replyHandler)
+    {
+        mama_log (MAMA_LOG_LEVEL_FINE, "MamdaNewsManager: received news story");
+
+        MamdaNewsStory  story;
+        decodeStory (msg, story);
+
+        story.setSubscInfo (subscription->getQueue(), subscription->getSource());
+
+        // Keep any cached copy of a broadcast story up to date.
+        if (story.getStatus() == MamdaNewsStory::FULL_STORY)
+        {
+            StoryKey  key (subscription->getSource(), story.getNewsStoryId());
+
+            acquireLock();
+            if (mStoryCache.find (key) != mStoryCache.end())
+                cacheStory (key, msg, story);
+            releaseLock();
+        }
+
+        deliverStory (replyHandler, msg, story, subscription->getClosure());
+
+        if (replyHandler)
+        {
+            // This was a request for a single story, so we can delete the
+            // subscription.
+            delete subscription;
+        }
+
+        mama_log (MAMA_LOG_LEVEL_FINE, "MamdaNewsManager: finished news story");
+    }
+
+    void MamdaNewsManager::MamdaNewsManagerImpl::decodeStory (
+        const MamaMsg&          msg,
+        MamdaNewsStory&         story)
     {
         /*
          * NOTE: fields which are enums can be pubished as integers if feedhandler
@@ -1182,8 +1655,6 @@ namespace Wombat
         const char* statusStr           = "";
         MamdaNewsStory::Status status   = MamdaNewsStory::UNKNOWN;
 
-        mama_log (MAMA_LOG_LEVEL_FINE, "MamdaNewsManager: received news story");
-
         msg.tryString       (MamdaNewsFields::STORY_TEXT,      storyText);
         msg.tryString       (MamdaNewsFields::STORY_ID,        storyId);
         msg.tryU16          (MamdaNewsFields::REVISION_NUM,    revNum);
@@ -1258,8 +1729,6 @@ namespace Wombat
         msg.tryDateTime     (MamdaNewsFields::ORIG_STORY_TIME, storyOrigTime);
         msg.tryVectorString (MamdaNewsFields::STORY_HEADLINES, headlines, numHeadlines);
 
-        MamdaNewsStory  story;
-
         story.setStory (storyText, 
                         storyId, 
                         revNum,
@@ -1269,52 +1738,207 @@ namespace Wombat
                         headlines, 
                         numHeadlines);
 
-        story.setSubscInfo (subscription->getQueue(), subscription->getSource());
+    }
 
-        if (replyHandler)
+    void MamdaNewsManager::MamdaNewsManagerImpl::deliverStory (
+        MamdaNewsStoryHandler*  handler,
+        const MamaMsg&          msg,
+        const MamdaNewsStory&   story,
+        void*                   closure)
+    {
+        if (handler)
         {
-            replyHandler->onNewsStory (mManager, 
-                                       msg, 
-                                       story,
-                                       subscription->getClosure());
+            handler->onNewsStory (mManager, 
+                                  msg, 
+                                  story,
+                                  closure);
+            return;
         }
-        else
+
+        deque<MamdaNewsStoryHandler*>::iterator end = mStoryHandlers.end();
+        deque<MamdaNewsStoryHandler*>::iterator iter;
+
+        for (iter = mStoryHandlers.begin(); iter != end; ++iter)
         {
-            deque<MamdaNewsStoryHandler*>::iterator end = mStoryHandlers.end();
-            deque<MamdaNewsStoryHandler*>::iterator iter;
+            (*iter)->onNewsStory (mManager, 
+                                  msg, 
+                                  story,
+                                  closure);
+        }
+    }
 
-            for (iter = mStoryHandlers.begin(); iter != end; ++iter)
-            {
-                MamdaNewsStoryHandler*  handler = *iter;
-                handler->onNewsStory (mManager, 
-                                      msg, 
-                                      story,
-                                      subscription->getClosure());
-            }
+    void MamdaNewsManager::MamdaNewsManagerImpl::setStoryCacheSize (
+        mama_u32_t   maxStories,
+        mama_size_t  maxBytes)
+    {
+        acquireLock();
+        mMaxCachedStories = maxStories;
+        mMaxCachedBytes   = maxBytes;
+        trimStoryCache ();
+        releaseLock();
+    }
+
+    const CachedStory* MamdaNewsManager::MamdaNewsManagerImpl::findCachedStory (
+        const StoryKey&  key)
+    {
+        StoryCache::iterator found = mStoryCache.find (key);
+        if (found == mStoryCache.end())
+            return NULL;
+
+        CachedStory* cached = found->second;
+        mStoryLru.splice (mStoryLru.begin(), mStoryLru, cached->mLruPos);
+        return cached;
+    }
+
+    void MamdaNewsManager::MamdaNewsManagerImpl::cacheStory (
+        const StoryKey&         key,
+        const MamaMsg&          msg,
+        const MamdaNewsStory&   story)
+    {
+        acquireLock();
+        if (mMaxCachedStories == 0)
+        {
+            releaseLock();
+            return;
         }
 
-        switch (status)
+        StoryCache::iterator found = mStoryCache.find (key);
+        if (found != mStoryCache.end())
+            evictStory (found);
+
+        CachedStory* cached = new CachedStory (msg);
+        cached->mStory      = story;
+
+        const char* text = story.getNewsStoryText();
+        cached->mBytes   = text ? strlen (text) : 0;
+
+        mStoryLru.push_front (key);
+        cached->mLruPos  = mStoryLru.begin();
+        mStoryCache[key] = cached;
+        mCachedBytes    += cached->mBytes;
+
+        trimStoryCache ();
+        releaseLock();
+    }
+
+    void MamdaNewsManager::MamdaNewsManagerImpl::evictStory (
+        StoryCache::iterator  entry)
+    {
+        CachedStory* cached = entry->second;
+
+        mCachedBytes -= cached->mBytes;
+        mStoryLru.erase (cached->mLruPos);
+        mStoryCache.erase (entry);
+        delete cached;
+    }
+
+    void MamdaNewsManager::MamdaNewsManagerImpl::trimStoryCache ()
+    {
+        while (!mStoryLru.empty() &&
+               ((mStoryCache.size() > mMaxCachedStories) ||
+                (mMaxCachedBytes && mCachedBytes > mMaxCachedBytes)))
         {
-            case MamdaNewsStory::NO_STORY:
-            case MamdaNewsStory::FULL_STORY:
-            case MamdaNewsStory::DELAYED_STORY:
-            case MamdaNewsStory::NOT_FOUND:
-            case MamdaNewsStory::DELETED:
-            case MamdaNewsStory::EXPIRED:
-            case MamdaNewsStory::UNKNOWN:
-                break;
-            case MamdaNewsStory::FETCHING_STORY:
-                break;
+            evictStory (mStoryCache.find (mStoryLru.back()));
         }
+    }
 
-        if (replyHandler)
+    void MamdaNewsManager::MamdaNewsManagerImpl::invalidateStory (
+        MamaSource*               source,
+        const MamdaNewsHeadline&  headline)
+    {
+        if (!headline.getNewsStoryId())
+            return;
+
+        acquireLock();
+
+        StoryCache::iterator found = 
+            mStoryCache.find (StoryKey (source, headline.getNewsStoryId()));
+
+        if (found == mStoryCache.end())
         {
-            // This was a request for a single story, so we can delete the
-            // subscription.
-            delete subscription;
+            releaseLock();
+            return;
         }
 
-        mama_log (MAMA_LOG_LEVEL_FINE, "MamdaNewsManager: finished news story");
+        if (headline.getNewsStoryRevNumber() > 
+            found->second->mStory.getNewsStoryRevNumber())
+        {
+            mama_log (MAMA_LOG_LEVEL_FINE,
+                      "MamdaNewsManager: story %s revised; dropping cached copy",
+                      headline.getNewsStoryId());
+            evictStory (found);
+        }
+        releaseLock();
+    }
+
+    void MamdaNewsManager::MamdaNewsManagerImpl::indexHeadline (
+        const MamaMsg&            msg,
+        const MamdaNewsHeadline&  headline)
+    {
+        const char* text = headline.getHeadlineText();
+        if (!text || !*text)
+            return;
+
+        acquireLock();
+        if (mHeadlineIndex.getMaxHeadlines() != 0)
+            mHeadlineIndex.add (msg, headline);
+        releaseLock();
+    }
+
+    void MamdaNewsManager::MamdaNewsManagerImpl::setHeadlineIndexSize (
+        mama_u32_t  maxHeadlines)
+    {
+        acquireLock();
+        mHeadlineIndex.setMaxHeadlines (maxHeadlines);
+        releaseLock();
+    }
+
+    void MamdaNewsManager::MamdaNewsManagerImpl::clearHeadlineIndex ()
+    {
+        acquireLock();
+        mHeadlineIndex.clear();
+        releaseLock();
+    }
+
+    bool MamdaNewsManager::MamdaNewsManagerImpl::executeLocalQuery (
+        MamaQueue*                queue,
+        MamaSource*               source,
+        MamdaQuery*               newsQuery,
+        MamdaNewsQueryHandler*    handler,
+        void*                     closure)
+    {
+        if (!queue || !handler)
+            return false;
+
+        acquireLock();
+
+        MamdaNewsHeadlineIndex::Results  results;
+        if (mHeadlineIndex.size() == 0 ||
+            !mHeadlineIndex.evaluate (*newsQuery, results))
+        {
+            releaseLock();
+            return false;
+        }
+
+        mama_log (MAMA_LOG_LEVEL_FINE,
+                  "MamdaNewsManager: answered query locally (%lu headlines)",
+                  (unsigned long) results.size());
+
+        // Copy the results while the index cannot change under us.
+        LocalQueryEvent* event = new LocalQueryEvent (*this,
+                                                      handler,
+                                                      queue,
+                                                      source,
+                                                      newsQuery,
+                                                      closure);
+        for (size_t i = 0; i < results.size(); ++i)
+            event->addResult (*results[i]);
+
+        ++mLocalQueryCount;
+        releaseLock();
+
+        enqueueLocalEvent (queue, event);
+        return true;
     }
 
     void MamdaNewsManager::MamdaNewsManagerImpl::onQuality (
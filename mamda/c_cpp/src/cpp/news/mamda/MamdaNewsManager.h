@@ -167,6 +167,59 @@ namespace Wombat
                                    double                    secondsLater,
                                    void*                     closure);
 
+        /**
+         * Enable caching of the most recently requested full stories.
+         * Requests for cached stories are answered without contacting the
+         * publisher; the least recently used stories are evicted once
+         * either limit is reached.  A headline announcing a newer
+         * revision of a cached story evicts it.  Caching is disabled by
+         * default (maxStories of zero).
+         *
+         * Regardless of caching, concurrent requests for the same story
+         * share a single request to the publisher.
+         *
+         * @param maxStories The maximum number of cached stories.
+         * @param maxBytes   The maximum total size of the cached story
+         * text, or zero for no limit.
+         */
+        void    setStoryCacheSize (mama_u32_t  maxStories,
+                                   mama_size_t maxBytes = 0);
+
+        /**
+         * Index the most recent broadcast headlines so that historical
+         * queries can be answered locally.  When enabled, a historical
+         * query whose conditions are all string conditions on indexed
+         * fields (codes, symbols, ids and headline words, named as in the
+         * data dictionary) and date ranges is evaluated against the
+         * indexed headlines only, without contacting the publisher.
+         * Other queries are sent to the publisher as before.  Indexing
+         * is disabled by default (maxHeadlines of zero).
+         *
+         * @param maxHeadlines The number of recent headlines to index.
+         */
+        void    setHeadlineIndexSize (mama_u32_t  maxHeadlines);
+
+        /**
+         * @return The number of story requests answered from the cache.
+         */
+        mama_u32_t  getStoryCacheHitCount () const;
+
+        /**
+         * @return The number of story requests sent to the publisher.
+         */
+        mama_u32_t  getStoryFetchCount () const;
+
+        /**
+         * @return The number of story requests which joined a request
+         * already in progress for the same story.
+         */
+        mama_u32_t  getCoalescedStoryRequestCount () const;
+
+        /**
+         * @return The number of queries answered from the headline index.
+         */
+        mama_u32_t  getLocalQueryCount () const;
+
         struct MamdaNewsManagerImpl;
         MamdaNewsManagerImpl& mImpl;
     };
@@ -38,6 +38,7 @@
 #endif
 
 #include <float.h>
+#include <algorithm>
 #include <set>
 #include <string>
 #include <cstring>
@@ -45,6 +46,8 @@
 
 using std::set;
 using std::string;
+using std::lower_bound;
+using std::upper_bound;
 using std::cout;
 using std::endl;
 using std::strcmp;
@@ -124,6 +127,20 @@ namespace Wombat
             int                               rangeLength,
             MamdaOptionAtTheMoneyCompareType  compareType);
 
+        bool getStrikeIndexWithinPercent (
+            size_t&                           lowIndex,
+            size_t&                           highIndex,
+            double                            percentage,
+            MamdaOptionAtTheMoneyCompareType  compareType);
+
+        bool getStrikeIndexWithinRangeSize (
+            size_t&                           lowIndex,
+            size_t&                           highIndex,
+            int                               rangeLength,
+            MamdaOptionAtTheMoneyCompareType  compareType);
+
+        void addStrikePrice (double  strikePrice);
+
         bool getIsPriceWithinPercentOfMoney (
             double                            price,
             double                            percentage,
@@ -134,7 +151,7 @@ namespace Wombat
         string                        mSymbol;
         ContractSet                   mCallOptions;
         ContractSet                   mPutOptions;
-        StrikeSet                     mStrikePrices;
+        StrikeIndex                   mStrikePrices;
         const MamdaQuoteListener*     mQuoteListener;
         const MamdaTradeListener*     mTradeListener;
         MamdaOptionExpirationDateSet  mExpirationSet;
@@ -226,6 +243,51 @@ namespace Wombat
         mImpl.getStrikesWithinRangeSize (strikeSet, rangeLength, compareType);
     }
 
+    bool MamdaOptionChain::getStrikeBoundsWithinPercent (
+        double&                           lowStrike,
+        double&                           highStrike,
+        double                            percentage,
+        MamdaOptionAtTheMoneyCompareType  compareType)
+    {
+        size_t lowIndex  = 0;
+        size_t highIndex = 0;
+
+        if (!mImpl.getStrikeIndexWithinPercent (lowIndex, highIndex,
+                                                percentage, compareType))
+        {
+            return false;
+        }
+
+        lowStrike  = mImpl.mStrikePrices[lowIndex];
+        highStrike = mImpl.mStrikePrices[highIndex];
+        return true;
+    }
+
+    bool MamdaOptionChain::getStrikeBoundsWithinRangeSize (
+        double&                           lowStrike,
+        double&                           highStrike,
+        int                               rangeLength,
+        MamdaOptionAtTheMoneyCompareType  compareType)
+    {
+        size_t lowIndex  = 0;
+        size_t highIndex = 0;
+
+        if (!mImpl.getStrikeIndexWithinRangeSize (lowIndex, highIndex,
+                                                  rangeLength, compareType))
+        {
+            return false;
+        }
+
+        lowStrike  = mImpl.mStrikePrices[lowIndex];
+        highStrike = mImpl.mStrikePrices[highIndex];
+        return true;
+    }
+
+    const StrikeIndex& MamdaOptionChain::getStrikeIndex () const
+    {
+        return mImpl.mStrikePrices;
+    }
+
     bool MamdaOptionChain::getIsPriceWithinPercentOfMoney (
         double                            price,
         double                            percentage,
@@ -458,9 +520,7 @@ namespace Wombat
 	            if ((foundStrikeSet == expireStrikes->end()) && gotExpireDate) 
 	            {
 		            strikeSet = new MamdaOptionStrikeSet (expireDate, strikePrice);
-		            expireStrikes->
-		                insert (MamdaOptionExpirationStrikes::value_type(
-						                 strikePrice, strikeSet));
+		            expireStrikes->addStrikeSet (strikePrice, strikeSet);
 	            }
 	            else
 	            {
@@ -496,7 +556,7 @@ namespace Wombat
 
 	        if (contract->gotStrikePrice())
 	        {
-	            mStrikePrices.insert(strikePrice);
+	            addStrikePrice (strikePrice);
 	        }
         }
     }
@@ -543,146 +603,158 @@ namespace Wombat
         return (((1.0 - percentage) <= price) || (price <= (1.0 + percentage)));
     }
 
-    void MamdaOptionChain::MamdaOptionChainImpl::getStrikesWithinPercent (
-        StrikeSet&                        strikeSet,
+    void MamdaOptionChain::MamdaOptionChainImpl::addStrikePrice (
+        double  strikePrice)
+    {
+        // Keep the index sorted and unique.  Inserting mid-vector is a
+        // memmove, which is cheap next to the range queries it buys us.
+        StrikeIndex::iterator found = lower_bound (mStrikePrices.begin(),
+                                                   mStrikePrices.end(),
+                                                   strikePrice);
+
+        if ((found == mStrikePrices.end()) || (*found != strikePrice))
+        {
+            mStrikePrices.insert (found, strikePrice);
+        }
+    }
+
+    bool MamdaOptionChain::MamdaOptionChainImpl::getStrikeIndexWithinPercent (
+        size_t&                           lowIndex,
+        size_t&                           highIndex,
         double                            percentage,
         MamdaOptionAtTheMoneyCompareType  compareType)
     {
-        mama_log (MAMA_LOG_LEVEL_FINE,
-                  "getStrikesWithinPercent: looking for strikes within %g",
-                  percentage);
-
-        strikeSet.clear();
         percentage /= 100.0;
 
         if (percentage <= 0.0)
-            return;
+            return false;
 
         double atTheMoney  = getAtTheMoney(compareType);
 
         if (atTheMoney == 0.0)
-            return;
+            return false;
 
         double lowPercent  = atTheMoney * (1.0 - percentage);
         double highPercent = atTheMoney * (1.0 + percentage);
 
-        StrikeSet::const_iterator i   = mStrikePrices.lower_bound (lowPercent);
-        StrikeSet::const_iterator end = mStrikePrices.upper_bound (highPercent);
+        StrikeIndex::const_iterator begin = mStrikePrices.begin();
+        StrikeIndex::const_iterator end   = mStrikePrices.end();
+        StrikeIndex::const_iterator low   =
+            lower_bound (begin, end, lowPercent);
+        StrikeIndex::const_iterator high  =
+            upper_bound (low, end, highPercent);
 
-        while (i != end)
-        {
-            strikeSet.insert(*i);
-            i++;
-        }
+        if (low == high)
+            return false;
+
+        lowIndex  = low - begin;
+        highIndex = (high - begin) - 1;
+        return true;
     }
 
-    void MamdaOptionChain::MamdaOptionChainImpl::getStrikesWithinRangeSize (
-        StrikeSet&                        strikeSet,
+    bool MamdaOptionChain::MamdaOptionChainImpl::getStrikeIndexWithinRangeSize (
+        size_t&                           lowIndex,
+        size_t&                           highIndex,
         int                               rangeLength,
         MamdaOptionAtTheMoneyCompareType  compareType)
     {
-        mama_log (MAMA_LOG_LEVEL_FINE,
-                  "getStrikesWithinRangeSize: looking for strikes for range length: %d",
-                  rangeLength);
-
-        strikeSet.clear();
+        if (rangeLength <= 0)
+            return false;
 
-        if (rangeLength <= 0.0)
-            return;
+        if (mStrikePrices.empty())
+            return false;
 
         double atTheMoney  = getAtTheMoney(compareType);
 
         if (atTheMoney == 0.0)
-            return;
+            return false;
 
         mama_log (MAMA_LOG_LEVEL_FINE,
                   "getStrikesWithinRangeSize: at-the-money: %g",
                   atTheMoney);
 
-        int    countToMoney     = 0;
-        int    countFromMoney   = 0;
-        double halfRangeLength  = rangeLength / 2.0;
-        double lowerBound       = DBL_MIN;
-        double upperBound       = DBL_MAX;
+        // The number of strikes that are less than the "money" is simply
+        // the position of the first strike at or above it.
+        size_t numStrikes     = mStrikePrices.size();
+        size_t countToMoney   = lower_bound (mStrikePrices.begin(),
+                                             mStrikePrices.end(),
+                                             atTheMoney) - mStrikePrices.begin();
 
-        // First loop determines the upper bound and count the number
-        // of strikes that are less than the "money".
-        StrikeSet::const_iterator strikeIter = mStrikePrices.begin();
-        StrikeSet::const_iterator strikeEnd  = mStrikePrices.end();
+        // Take half the range (rounded up) at or above the money...
+        size_t countFromMoney = (rangeLength + 1) / 2;
 
-        for (; strikeIter != strikeEnd; ++strikeIter)
+        if (countFromMoney > numStrikes - countToMoney)
         {
-            double strikePrice = *strikeIter;
-
-            if (strikePrice < atTheMoney)
-            {
-                // We're still less than the "money", so keep counting up.
-                countToMoney++;
-            }
-            else
-            {
-                // Check the upper bound. Take a price that is
-                // slightly higher than this strike price because we
-                // want to include it (Set.subSet excludes the
-                // toElement).
-                countFromMoney++;
-                upperBound = strikePrice + 0.00001;
-
-                if (countFromMoney >= halfRangeLength)
-                {
-                    // We've passed the upper end of the range
-                    break;
-                }
-            }
+            countFromMoney = numStrikes - countToMoney;
         }
-        mama_log (MAMA_LOG_LEVEL_FINE,
-                  "getStrikesWithinRangeSize: upperBound: %g",
-                  upperBound);
 
-        // Second loop determines the lower bound.
-        int targetCount = countToMoney - (rangeLength - countFromMoney);
-        strikeIter = mStrikePrices.begin();
+        highIndex = (countFromMoney == 0) ? numStrikes - 1
+                                          : countToMoney + countFromMoney - 1;
 
-        for (; strikeIter != strikeEnd; ++strikeIter)
-        {
-            double strikePrice = *strikeIter;
-            if (targetCount > 0)
-            {
-                // We have not yet hit the lowerBound.
-                targetCount--;
-            }
-            else
-            {
-                lowerBound = strikePrice;
-                break;
-            }
-        }
+        // ...and whatever remains of the range below it.
+        size_t countBelowMoney = rangeLength - countFromMoney;
 
-        StrikeSet::const_iterator i   = mStrikePrices.lower_bound(lowerBound);
-        StrikeSet::const_iterator end = mStrikePrices.upper_bound(upperBound);
-
-        while (i != end)
-        {
-            strikeSet.insert(*i);
-            ++i;
-        }
+        lowIndex = (countToMoney > countBelowMoney)
+                   ? countToMoney - countBelowMoney
+                   : 0;
 
-        if (strikeSet.empty())
+        if (lowIndex > highIndex)
         {
             mama_log (MAMA_LOG_LEVEL_FINER,
                       "getStrikesWithinRangeSize: empty range!");
+            return false;
         }
-        else
+
+        mama_log (MAMA_LOG_LEVEL_FINER,
+                  "getStrikesWithinRangeSize: "
+                  "lowerBound=%f atTheMoney=%f upperBound=%f",
+                  mStrikePrices[lowIndex],
+                  atTheMoney,
+                  mStrikePrices[highIndex]);
+        return true;
+    }
+
+    void MamdaOptionChain::MamdaOptionChainImpl::getStrikesWithinPercent (
+        StrikeSet&                        strikeSet,
+        double                            percentage,
+        MamdaOptionAtTheMoneyCompareType  compareType)
+    {
+        mama_log (MAMA_LOG_LEVEL_FINE,
+                  "getStrikesWithinPercent: looking for strikes within %g",
+                  percentage);
+
+        strikeSet.clear();
+
+        size_t lowIndex  = 0;
+        size_t highIndex = 0;
+
+        if (getStrikeIndexWithinPercent (lowIndex, highIndex,
+                                         percentage, compareType))
         {
-            lowerBound = *strikeSet.begin();
-            upperBound = *strikeSet.rbegin();
+            strikeSet.insert (mStrikePrices.begin() + lowIndex,
+                              mStrikePrices.begin() + highIndex + 1);
+        }
+    }
 
-            mama_log (MAMA_LOG_LEVEL_FINER,
-                      "getStrikesWithinRangeSize: "
-                      "lowerBound=%f atTheMoney=%f upperBound=%f",
-                      lowerBound, 
-                      atTheMoney, 
-                      upperBound);
+    void MamdaOptionChain::MamdaOptionChainImpl::getStrikesWithinRangeSize (
+        StrikeSet&                        strikeSet,
+        int                               rangeLength,
+        MamdaOptionAtTheMoneyCompareType  compareType)
+    {
+        mama_log (MAMA_LOG_LEVEL_FINE,
+                  "getStrikesWithinRangeSize: looking for strikes for range length: %d",
+                  rangeLength);
+
+        strikeSet.clear();
+
+        size_t lowIndex  = 0;
+        size_t highIndex = 0;
+
+        if (getStrikeIndexWithinRangeSize (lowIndex, highIndex,
+                                           rangeLength, compareType))
+        {
+            strikeSet.insert (mStrikePrices.begin() + lowIndex,
+                              mStrikePrices.begin() + highIndex + 1);
         }
     }
 
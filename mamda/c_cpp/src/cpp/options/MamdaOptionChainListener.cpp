@@ -22,6 +22,7 @@
 #include <mamda/MamdaOptionChainListener.h>
 #include <mamda/MamdaOptionChainHandler.h>
 #include <mamda/MamdaOptionChain.h>
+#include <mamda/MamdaOptionChainSnapshot.h>
 #include <mamda/MamdaOptionContract.h>
 #include <mamda/MamdaOptionFields.h>
 #include <mamda/MamdaMsgListener.h>
@@ -121,6 +122,7 @@ namespace Wombat
         MamdaOptionChain*                 mChain;
         bool                              mOwnChain;
         vector<MamdaOptionChainHandler*>  mHandlers;
+        vector<MamdaOptionChainSnapshot*> mSnapshots;
         string                            mSymbol;
         string                            mPartId;
         MamaDateTime                      mSrcTime;
@@ -187,6 +189,12 @@ namespace Wombat
         mImpl.mHandlers.push_back(handler);
     }
 
+    void MamdaOptionChainListener::addSnapshot (
+        MamdaOptionChainSnapshot*  snapshot)
+    {
+        mImpl.mSnapshots.push_back(snapshot);
+    }
+
     MamdaOptionChain& MamdaOptionChainListener::getOptionChain ()
     {
         assert(mImpl.mChain!=NULL);
@@ -449,6 +457,11 @@ namespace Wombat
                     handleTradeMsg (contract, subscription, msg, msgType);
                     break;
             }
+
+            for (size_t i = 0; i < mSnapshots.size(); ++i)
+            {
+                mSnapshots[i]->markDirty (contract);
+            }
         }
         catch (MamdaDataException& e)
         {
@@ -0,0 +1,318 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#include <mamda/MamdaOptionChainSnapshot.h>
+#include <mamda/MamdaOptionChain.h>
+#include <mamda/MamdaOptionChainView.h>
+#include <mamda/MamdaOptionContract.h>
+#include <mamda/MamdaOptionContractSet.h>
+#include <mamda/MamdaOptionExpirationDateSet.h>
+#include <mamda/MamdaOptionExpirationStrikes.h>
+#include <mamda/MamdaOptionStrikeSet.h>
+#include <mamda/MamdaQuoteRecap.h>
+#include <mamda/MamdaTradeRecap.h>
+#include <map>
+#include <vector>
+
+using std::map;
+using std::vector;
+
+namespace Wombat
+{
+
+    typedef map<const MamdaOptionContract*, size_t>  ContractRowMap;
+
+    struct MamdaOptionChainSnapshot::MamdaOptionChainSnapshotImpl
+    {
+        void clear      ();
+
+        void addRow     (const MamdaOptionContract*     contract);
+
+        void addContractSet (const MamdaOptionContractSet*  contractSet);
+
+        void readRow    (size_t                         row);
+
+        // Row lookup and dirty tracking.
+        ContractRowMap                      mRows;
+        vector<size_t>                      mDirtyRows;
+        vector<char>                        mDirtyFlags;
+
+        // The columns.
+        vector<const MamdaOptionContract*>  mContracts;
+        vector<double>                      mStrikePrices;
+        vector<double>                      mExpireTimes;
+        vector<char>                        mPutCalls;
+        vector<double>                      mBidPrices;
+        vector<double>                      mAskPrices;
+        vector<double>                      mLastPrices;
+        vector<mama_quantity_t>             mBidSizes;
+        vector<mama_quantity_t>             mAskSizes;
+        vector<mama_quantity_t>             mLastVolumes;
+    };
+
+    template <typename T>
+    static inline const T* columnData (const vector<T>&  column)
+    {
+        return column.empty() ? NULL : &column[0];
+    }
+
+    MamdaOptionChainSnapshot::MamdaOptionChainSnapshot ()
+        : mImpl (*new MamdaOptionChainSnapshotImpl)
+    {
+    }
+
+    MamdaOptionChainSnapshot::~MamdaOptionChainSnapshot ()
+    {
+        delete &mImpl;
+    }
+
+    void MamdaOptionChainSnapshot::populate (
+        const MamdaOptionChain&  chain)
+    {
+        mImpl.clear();
+
+        MamdaOptionChain::const_iterator callIter = chain.callIterator();
+        while (callIter.hasNext())
+        {
+            mImpl.addRow (callIter.next());
+        }
+
+        MamdaOptionChain::const_iterator putIter = chain.putIterator();
+        while (putIter.hasNext())
+        {
+            mImpl.addRow (putIter.next());
+        }
+    }
+
+    void MamdaOptionChainSnapshot::populate (
+        const MamdaOptionChainView&  view)
+    {
+        mImpl.clear();
+
+        const MamdaOptionExpirationDateSet& dateSet = view.getExpireDateSet();
+
+        MamdaOptionExpirationDateSet::const_iterator expireIter = dateSet.begin();
+        MamdaOptionExpirationDateSet::const_iterator expireEnd  = dateSet.end();
+
+        for (; expireIter != expireEnd; ++expireIter)
+        {
+            const MamdaOptionExpirationStrikes* strikes = expireIter->second;
+
+            MamdaOptionExpirationStrikes::const_iterator strikeIter = strikes->begin();
+            MamdaOptionExpirationStrikes::const_iterator strikeEnd  = strikes->end();
+
+            for (; strikeIter != strikeEnd; ++strikeIter)
+            {
+                const MamdaOptionStrikeSet* strikeSet = strikeIter->second;
+
+                mImpl.addContractSet (strikeSet->getCallSet());
+                mImpl.addContractSet (strikeSet->getPutSet());
+            }
+        }
+    }
+
+    void MamdaOptionChainSnapshot::markDirty (
+        const MamdaOptionContract&  contract)
+    {
+        ContractRowMap::const_iterator found = mImpl.mRows.find (&contract);
+
+        if (found == mImpl.mRows.end())
+            return;
+
+        size_t row = found->second;
+
+        if (!mImpl.mDirtyFlags[row])
+        {
+            mImpl.mDirtyFlags[row] = 1;
+            mImpl.mDirtyRows.push_back (row);
+        }
+    }
+
+    size_t MamdaOptionChainSnapshot::refresh ()
+    {
+        size_t numDirty = mImpl.mDirtyRows.size();
+
+        for (size_t i = 0; i < numDirty; ++i)
+        {
+            size_t row = mImpl.mDirtyRows[i];
+
+            mImpl.readRow (row);
+            mImpl.mDirtyFlags[row] = 0;
+        }
+
+        mImpl.mDirtyRows.clear();
+        return numDirty;
+    }
+
+    size_t MamdaOptionChainSnapshot::size () const
+    {
+        return mImpl.mContracts.size();
+    }
+
+    size_t MamdaOptionChainSnapshot::getDirtyCount () const
+    {
+        return mImpl.mDirtyRows.size();
+    }
+
+    long MamdaOptionChainSnapshot::findRow (
+        const MamdaOptionContract&  contract) const
+    {
+        ContractRowMap::const_iterator found = mImpl.mRows.find (&contract);
+
+        if (found == mImpl.mRows.end())
+            return -1;
+
+        return (long)found->second;
+    }
+
+    const MamdaOptionContract* const* MamdaOptionChainSnapshot::getContracts () const
+    {
+        return columnData (mImpl.mContracts);
+    }
+
+    const double* MamdaOptionChainSnapshot::getStrikePrices () const
+    {
+        return columnData (mImpl.mStrikePrices);
+    }
+
+    const double* MamdaOptionChainSnapshot::getExpireTimes () const
+    {
+        return columnData (mImpl.mExpireTimes);
+    }
+
+    const char* MamdaOptionChainSnapshot::getPutCalls () const
+    {
+        return columnData (mImpl.mPutCalls);
+    }
+
+    const double* MamdaOptionChainSnapshot::getBidPrices () const
+    {
+        return columnData (mImpl.mBidPrices);
+    }
+
+    const double* MamdaOptionChainSnapshot::getAskPrices () const
+    {
+        return columnData (mImpl.mAskPrices);
+    }
+
+    const double* MamdaOptionChainSnapshot::getLastPrices () const
+    {
+        return columnData (mImpl.mLastPrices);
+    }
+
+    const mama_quantity_t* MamdaOptionChainSnapshot::getBidSizes () const
+    {
+        return columnData (mImpl.mBidSizes);
+    }
+
+    const mama_quantity_t* MamdaOptionChainSnapshot::getAskSizes () const
+    {
+        return columnData (mImpl.mAskSizes);
+    }
+
+    const mama_quantity_t* MamdaOptionChainSnapshot::getLastVolumes () const
+    {
+        return columnData (mImpl.mLastVolumes);
+    }
+
+    void MamdaOptionChainSnapshot::MamdaOptionChainSnapshotImpl::clear ()
+    {
+        // Keep the column capacity: a chain is usually re-populated at a
+        // similar size.
+        mRows.clear();
+        mDirtyRows.clear();
+        mDirtyFlags.clear();
+        mContracts.clear();
+        mStrikePrices.clear();
+        mExpireTimes.clear();
+        mPutCalls.clear();
+        mBidPrices.clear();
+        mAskPrices.clear();
+        mLastPrices.clear();
+        mBidSizes.clear();
+        mAskSizes.clear();
+        mLastVolumes.clear();
+    }
+
+    void MamdaOptionChainSnapshot::MamdaOptionChainSnapshotImpl::addContractSet (
+        const MamdaOptionContractSet*  contractSet)
+    {
+        if (contractSet == NULL)
+            return;
+
+        addRow (contractSet->getBboContract());
+        addRow (contractSet->getWombatBboContract());
+
+        MamdaOptionContractSet::const_iterator iter = contractSet->begin();
+        MamdaOptionContractSet::const_iterator end  = contractSet->end();
+
+        for (; iter != end; ++iter)
+        {
+            addRow (iter->second);
+        }
+    }
+
+    void MamdaOptionChainSnapshot::MamdaOptionChainSnapshotImpl::addRow (
+        const MamdaOptionContract*  contract)
+    {
+        if (contract == NULL)
+            return;
+
+        size_t row = mContracts.size();
+
+        if (!mRows.insert (ContractRowMap::value_type (contract, row)).second)
+            return;
+
+        mContracts.push_back    (contract);
+        mDirtyFlags.push_back   (0);
+        mStrikePrices.push_back (0.0);
+        mExpireTimes.push_back  (0.0);
+        mPutCalls.push_back     (MAMDA_PUT_CALL_UNKNOWN);
+        mBidPrices.push_back    (0.0);
+        mAskPrices.push_back    (0.0);
+        mLastPrices.push_back   (0.0);
+        mBidSizes.push_back     (0);
+        mAskSizes.push_back     (0);
+        mLastVolumes.push_back  (0);
+
+        readRow (row);
+    }
+
+    void MamdaOptionChainSnapshot::MamdaOptionChainSnapshotImpl::readRow (
+        size_t  row)
+    {
+        const MamdaOptionContract* contract = mContracts[row];
+        const MamdaQuoteRecap&     quote    = contract->getQuoteInfo();
+        const MamdaTradeRecap&     trade    = contract->getTradeInfo();
+
+        mStrikePrices[row] = contract->getStrikePrice();
+        mExpireTimes[row]  = contract->getExpireDate().getEpochTimeSeconds();
+        mPutCalls[row]     = (char)contract->getPutCall();
+        mBidPrices[row]    = quote.getBidPrice().getValue();
+        mAskPrices[row]    = quote.getAskPrice().getValue();
+        mBidSizes[row]     = quote.getBidSize();
+        mAskSizes[row]     = quote.getAskSize();
+        mLastPrices[row]   = trade.getLastPrice().getValue();
+        mLastVolumes[row]  = trade.getLastVolume();
+    }
+
+} // namespace
@@ -20,6 +20,7 @@
  */
 
 #include <mamda/MamdaOptionChainView.h>
+#include <mamda/MamdaOptionChainViewRangeHandler.h>
 #include <mamda/MamdaOptionChain.h>
 #include <mamda/MamdaOptionContract.h>
 #include <mamda/MamdaOptionExpirationDateSet.h>
@@ -36,6 +37,11 @@
 #endif
 
 #include <float.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+using std::vector;
 
 namespace Wombat
 {
@@ -52,6 +58,15 @@ namespace Wombat
 
         void resetRange ();
 
+        void checkUnderlying   ();
+
+        void updateStrikes     ();
+
+        bool getStrikeBounds   (double&              lowStrike,
+                                double&              highStrike);
+
+        void addContract       (const MamdaOptionContract&  contract);
+
         void filterExpirations (MamdaOptionExpirationDateSet&        result,
                                 const MamdaOptionExpirationDateSet&  initialSet);
 
@@ -64,8 +79,8 @@ namespace Wombat
         class UnderlyingQuoteHandler : public MamdaQuoteHandler
         {
         public:
-            UnderlyingQuoteHandler (MamdaOptionChain& chain)
-                : mChain (chain)
+            UnderlyingQuoteHandler (MamdaOptionChainViewImpl& impl)
+                : mImpl (impl)
             {
             }
 
@@ -77,6 +92,8 @@ namespace Wombat
                 const MamaMsg&          msg,
                 const MamdaQuoteRecap&  recap)
             {
+                if (mImpl.mAtTheMoneyType != MAMDA_AT_THE_MONEY_COMPARE_LAST_TRADE)
+                    mImpl.checkUnderlying();
             }
 
             void onQuoteUpdate (
@@ -86,6 +103,8 @@ namespace Wombat
                 const MamdaQuoteUpdate& quote,
                 const MamdaQuoteRecap&  recap)
             {
+                if (mImpl.mAtTheMoneyType != MAMDA_AT_THE_MONEY_COMPARE_LAST_TRADE)
+                    mImpl.checkUnderlying();
             }
 
             void onQuoteGap (
@@ -125,14 +144,14 @@ namespace Wombat
             }
 
         private:
-            MamdaOptionChain&  mChain;
+            MamdaOptionChainViewImpl&  mImpl;
         };
 
         class UnderlyingTradeHandler : public MamdaTradeHandler
         {
         public:
-            UnderlyingTradeHandler (MamdaOptionChain& chain)
-                : mChain (chain)
+            UnderlyingTradeHandler (MamdaOptionChainViewImpl& impl)
+                : mImpl (impl)
             {
             }
 
@@ -142,6 +161,8 @@ namespace Wombat
                 const MamaMsg&          msg,
                 const MamdaTradeRecap&  recap)
             {
+                if (mImpl.mAtTheMoneyType == MAMDA_AT_THE_MONEY_COMPARE_LAST_TRADE)
+                    mImpl.checkUnderlying();
             }
 
             void onTradeReport (
@@ -151,6 +172,8 @@ namespace Wombat
                 const MamdaTradeReport& trade,
                 const MamdaTradeRecap&  recap)
             {
+                if (mImpl.mAtTheMoneyType == MAMDA_AT_THE_MONEY_COMPARE_LAST_TRADE)
+                    mImpl.checkUnderlying();
             }
 
             void onTradeGap (
@@ -208,7 +231,7 @@ namespace Wombat
             }
 
         private:
-            MamdaOptionChain&  mChain;
+            MamdaOptionChainViewImpl&  mImpl;
         };
 
         MamdaOptionChainView&         mView;
@@ -226,6 +249,9 @@ namespace Wombat
         MamaDateTime                  mHighExpireDate;
         double                        mLowStrike;
         double                        mHighStrike;
+        double                        mLastAtTheMoney;
+
+        vector<MamdaOptionChainViewRangeHandler*>  mRangeHandlers;
 
         // The following "underlying" handlers are used if/when we need to
         // check the strike range.  Which, if either, are active depends
@@ -301,6 +327,22 @@ namespace Wombat
         mImpl.resetRange();
     }
 
+    void MamdaOptionChainView::addRangeHandler (
+        MamdaOptionChainViewRangeHandler*  handler)
+    {
+        mImpl.mRangeHandlers.push_back (handler);
+    }
+
+    MamdaQuoteHandler* MamdaOptionChainView::getUnderlyingQuoteHandler ()
+    {
+        return &mImpl.mQuoteHandler;
+    }
+
+    MamdaTradeHandler* MamdaOptionChainView::getUnderlyingTradeHandler ()
+    {
+        return &mImpl.mTradeHandler;
+    }
+
     bool MamdaOptionChainView::isVisible (
         const MamdaOptionContract&  contract) const
     {
@@ -328,7 +370,7 @@ namespace Wombat
         MamdaOptionContract&       contract,
         MamdaOptionChain&          chain)
     {
-        mImpl.resetRange();
+        mImpl.addContract (contract);
     }
 
     void MamdaOptionChainView::onOptionSeriesUpdate (
@@ -363,8 +405,9 @@ namespace Wombat
         , mJitterMargin     (DEFAULT_JITTER_MARGIN)
         , mLowStrike        (0.0)
         , mHighStrike       (0.0)
-        , mQuoteHandler     (chain)
-        , mTradeHandler     (chain)
+        , mLastAtTheMoney   (0.0)
+        , mQuoteHandler     (*this)
+        , mTradeHandler     (*this)
     {
     }
 
@@ -439,79 +482,223 @@ namespace Wombat
     void MamdaOptionChainView::MamdaOptionChainViewImpl::filterStrikes (
         MamdaOptionExpirationDateSet&  dateSet)
     {
-        mLowStrike  = DBL_MIN;
-        mHighStrike = DBL_MAX;
+        mLowStrike      = DBL_MIN;
+        mHighStrike     = DBL_MAX;
+        mLastAtTheMoney = mChain.getAtTheMoney (mAtTheMoneyType);
 
         // First calculate the high/low strikes
-        StrikeSet strikeSet;
-        if (mStrikeMargin > 0.0)
+        double lowStrike  = 0.0;
+        double highStrike = 0.0;
+
+        if (!getStrikeBounds (lowStrike, highStrike))
         {
-            mChain.getStrikesWithinPercent (strikeSet, 
-                                            mStrikeMargin,
-                                            mAtTheMoneyType);
+            mama_log (MAMA_LOG_LEVEL_FINE,
+                      "filterStrikes: no strikes or underlying (yet?)");
+            return;
         }
-        if (strikeSet.empty())
+
+        mama_log (MAMA_LOG_LEVEL_FINE,
+                  "filterStrikes: got strikes in range: %g - %g",
+                  lowStrike, highStrike);
+
+        mLowStrike  = lowStrike;
+        mHighStrike = highStrike;
+
+        MamdaOptionExpirationDateSet::iterator expireEnd  = dateSet.end();
+        MamdaOptionExpirationDateSet::iterator expireIter = dateSet.begin();
+
+        while (expireIter != expireEnd)
         {
-            if (mNumExpirations > 0)
-            {
-                mChain.getStrikesWithinRangeSize (strikeSet, 
-                                                  mNumStrikes,
-                                                  mAtTheMoneyType);
-            }
+            // Filter the strike prices for one expiration date
+            MamdaOptionExpirationStrikes* expireStrikes = expireIter->second;
+            expireStrikes->trimStrikes (mLowStrike, mHighStrike);
+            ++expireIter;
         }
+    }
 
-        if (strikeSet.empty())
+    bool MamdaOptionChainView::MamdaOptionChainViewImpl::getStrikeBounds (
+        double&  lowStrike,
+        double&  highStrike)
+    {
+        bool found = false;
+
+        if (mStrikeMargin > 0.0)
         {
-            mama_log (MAMA_LOG_LEVEL_FINE,
-                      "filterStrikes: no strikes or underlying (yet?)");
+            found = mChain.getStrikeBoundsWithinPercent (lowStrike,
+                                                         highStrike,
+                                                         mStrikeMargin,
+                                                         mAtTheMoneyType);
+        }
+        if (!found && (mNumStrikes > 0))
+        {
+            found = mChain.getStrikeBoundsWithinRangeSize (lowStrike,
+                                                           highStrike,
+                                                           mNumStrikes,
+                                                           mAtTheMoneyType);
+        }
+        return found;
+    }
+
+    void MamdaOptionChainView::MamdaOptionChainViewImpl::checkUnderlying ()
+    {
+        if ((mStrikeMargin <= 0.0) && (mNumStrikes <= 0))
             return;
+
+        double atTheMoney = mChain.getAtTheMoney (mAtTheMoneyType);
+
+        if (atTheMoney == 0.0)
+            return;
+
+        // Allow the underlying to fluctuate within the jitter margin of
+        // the price at which the range was last set.
+        if (mLastAtTheMoney != 0.0)
+        {
+            double jitter = mLastAtTheMoney * mJitterMargin / 100.0;
+
+            if (fabs (atTheMoney - mLastAtTheMoney) <= jitter)
+                return;
         }
-        else
+
+        updateStrikes ();
+    }
+
+    void MamdaOptionChainView::MamdaOptionChainViewImpl::updateStrikes ()
+    {
+        double lowStrike  = DBL_MIN;
+        double highStrike = DBL_MAX;
+
+        mLastAtTheMoney = mChain.getAtTheMoney (mAtTheMoneyType);
+
+        if (!getStrikeBounds (lowStrike, highStrike))
         {
-            if (gMamaLogLevel >= MAMA_LOG_LEVEL_FINE)
+            lowStrike  = DBL_MIN;
+            highStrike = DBL_MAX;
+        }
+
+        // Walk only the strikes in the old and new windows of each
+        // expiration, using the chain's sorted strike index for the new
+        // window, rather than refiltering the whole chain.
+        const MamdaOptionExpirationDateSet& allExpirations =
+            mChain.getAllExpirations();
+
+        StrikeSet added;
+        StrikeSet removed;
+
+        MamdaOptionExpirationDateSet::iterator expireEnd  = mExpirationDateSet.end();
+        MamdaOptionExpirationDateSet::iterator expireIter = mExpirationDateSet.begin();
+
+        for (; expireIter != expireEnd; ++expireIter)
+        {
+            MamdaOptionExpirationStrikes* viewStrikes = expireIter->second;
+
+            MamdaOptionExpirationDateSet::const_iterator found =
+                allExpirations.find (expireIter->first);
+
+            if (found == allExpirations.end())
+                continue;
+
+            const MamdaOptionExpirationStrikes* chainStrikes = found->second;
+            const StrikeIndex& viewIndex = viewStrikes->getStrikeIndex();
+
+            // Strikes leaving the window.
+            StrikeIndex::const_iterator i =
+                std::lower_bound (viewIndex.begin(), viewIndex.end(), lowStrike);
+            removed.insert (viewIndex.begin(), i);
+
+            i = std::upper_bound (viewIndex.begin(), viewIndex.end(), highStrike);
+            removed.insert (i, viewIndex.end());
+
+            viewStrikes->trimStrikes (lowStrike, highStrike);
+
+            // Strikes entering the window.
+            const StrikeIndex& chainIndex = chainStrikes->getStrikeIndex();
+
+            StrikeIndex::const_iterator chainIter =
+                std::lower_bound (chainIndex.begin(), chainIndex.end(), lowStrike);
+            StrikeIndex::const_iterator chainEnd  =
+                std::upper_bound (chainIter, chainIndex.end(), highStrike);
+
+            for (; chainIter != chainEnd; ++chainIter)
             {
-                char strikeSetStr[256];
-                int  offset = 0;
-                StrikeSet::const_iterator i;
+                double strikePrice = *chainIter;
 
-                for (i = strikeSet.begin(); i != strikeSet.end(); ++i)
+                if (viewStrikes->find (strikePrice) == viewStrikes->end())
                 {
-                    snprintf (strikeSetStr+offset, 256-offset, "%g ", *i);
-                    offset = strlen(strikeSetStr);
+                    viewStrikes->addStrikeSet (
+                        strikePrice, chainStrikes->find (strikePrice)->second);
+                    added.insert (strikePrice);
                 }
-
-                mama_log (MAMA_LOG_LEVEL_FINE,
-                          "filterStrikes: got %d strikes in range: %s",
-                          strikeSet.size(), strikeSetStr);
             }
         }
 
-        mLowStrike  = *strikeSet.begin();
-        mHighStrike = *strikeSet.rbegin();
+        mLowStrike  = lowStrike;
+        mHighStrike = highStrike;
 
-        MamdaOptionExpirationDateSet::iterator expireEnd  = dateSet.end();
-        MamdaOptionExpirationDateSet::iterator expireIter = dateSet.begin();
+        if (added.empty() && removed.empty())
+            return;
 
-        while (expireIter != expireEnd)
+        mama_log (MAMA_LOG_LEVEL_FINE,
+                  "updateStrikes: range now %g - %g (%d added, %d removed)",
+                  mLowStrike, mHighStrike,
+                  (int)added.size(), (int)removed.size());
+
+        for (size_t h = 0; h < mRangeHandlers.size(); ++h)
         {
-            // Filter the strike prices for one expiration date
-            MamdaOptionExpirationStrikes* expireStrikes = expireIter->second;
-            expireStrikes->trimStrikes (strikeSet);
-            ++expireIter;
+            MamdaOptionChainViewRangeHandler* handler = mRangeHandlers[h];
+
+            handler->onOptionViewStrikeRangeReset (mView, mLowStrike, mHighStrike);
+
+            if (!removed.empty())
+                handler->onOptionViewStrikesRemoved (mView, removed);
+            if (!added.empty())
+                handler->onOptionViewStrikesAdded (mView, added);
+        }
+    }
+
+    void MamdaOptionChainView::MamdaOptionChainViewImpl::addContract (
+        const MamdaOptionContract&  contract)
+    {
+        if (!contract.gotExpireDate() || !contract.gotStrikePrice())
+            return;
+
+        const MamaDateTime& expireDate = contract.getExpireDate();
+
+        if (mExpirationDateSet.find (expireDate) != mExpirationDateSet.end())
+        {
+            // Known expiration: the new strike (if any) may shift the
+            // strike window, so update incrementally.
+            updateStrikes ();
+        }
+        else if (expirationInRange (expireDate))
+        {
+            // A new expiration may displace an existing one.
+            resetRange ();
         }
     }
 
     bool MamdaOptionChainView::MamdaOptionChainViewImpl::strikeInRange (
         double  strikePrice) const
     {
-        // To be completed.
-        return true;
+        return ((mLowStrike <= strikePrice) && (strikePrice <= mHighStrike));
     }
 
     bool MamdaOptionChainView::MamdaOptionChainViewImpl::expirationInRange (
         const MamaDateTime&  expirationDate) const
     {
-        // To be completed.
+        if (mExpirationDays > 0)
+        {
+            MamaDateTime futureDate;
+            futureDate.setToNow();
+            futureDate.addSeconds (mExpirationDays * 24 * 60 * 60);
+            return (expirationDate.compare (futureDate) <= 0);
+        }
+        else if (mNumExpirations > 0)
+        {
+            if ((int)mExpirationDateSet.size() < mNumExpirations)
+                return true;
+
+            return (expirationDate.compare (mHighExpireDate) <= 0);
+        }
         return true;
     }
 
@@ -20,6 +20,7 @@
  */
 
 #include <mamda/MamdaOptionExpirationStrikes.h>
+#include <algorithm>
 
 namespace Wombat
 {
@@ -31,6 +32,7 @@ namespace Wombat
     MamdaOptionExpirationStrikes::MamdaOptionExpirationStrikes (
         const MamdaOptionExpirationStrikes&  copy)
         : std::map<double, MamdaOptionStrikeSet*>(copy)
+        , mStrikeIndex (copy.mStrikeIndex)
     {
         
     }
@@ -44,13 +46,56 @@ namespace Wombat
         if (strikeSet.empty())
         {
             clear();
+            mStrikeIndex.clear();
+            return;
         }
 
-        double lowStrike  = *strikeSet.begin();
-        double highStrike = *strikeSet.rbegin();
+        trimStrikes (*strikeSet.begin(), *strikeSet.rbegin());
+    }
 
+    void MamdaOptionExpirationStrikes::trimStrikes (
+        double  lowStrike,
+        double  highStrike)
+    {
         erase (begin(), lower_bound(lowStrike));
         erase (upper_bound(highStrike), end());
+
+        mStrikeIndex.erase (std::upper_bound (mStrikeIndex.begin(),
+                                              mStrikeIndex.end(),
+                                              highStrike),
+                            mStrikeIndex.end());
+        mStrikeIndex.erase (mStrikeIndex.begin(),
+                            std::lower_bound (mStrikeIndex.begin(),
+                                              mStrikeIndex.end(),
+                                              lowStrike));
+    }
+
+    void MamdaOptionExpirationStrikes::addStrikeSet (
+        double                 strikePrice,
+        MamdaOptionStrikeSet*  strikeSet)
+    {
+        if (insert (value_type (strikePrice, strikeSet)).second)
+        {
+            mStrikeIndex.insert (std::lower_bound (mStrikeIndex.begin(),
+                                                   mStrikeIndex.end(),
+                                                   strikePrice),
+                                 strikePrice);
+        }
+    }
+
+    void MamdaOptionExpirationStrikes::removeStrikeSet (double strikePrice)
+    {
+        if (erase (strikePrice) > 0)
+        {
+            mStrikeIndex.erase (std::lower_bound (mStrikeIndex.begin(),
+                                                  mStrikeIndex.end(),
+                                                  strikePrice));
+        }
+    }
+
+    const StrikeIndex& MamdaOptionExpirationStrikes::getStrikeIndex () const
+    {
+        return mStrikeIndex;
     }
 
 } // namespace
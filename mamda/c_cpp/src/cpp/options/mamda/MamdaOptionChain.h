@@ -25,6 +25,7 @@
 #include <mamda/MamdaOptionalConfig.h>
 #include <mamda/MamdaOptionAtTheMoneyCompareType.h>
 #include <set>
+#include <vector>
 
 using std::set;
 
@@ -38,6 +39,12 @@ namespace Wombat
 
     typedef set<double>   StrikeSet;
 
+    /**
+     * A sorted, contiguous index of unique strike prices which supports
+     * binary-search range queries.
+     */
+    typedef std::vector<double>  StrikeIndex;
+
     /**
      * MamdaOptionChain is a specialized class to represent market data
      * option chains.  The class has capabilities to store the current
@@ -167,6 +174,38 @@ namespace Wombat
             int                               rangeLength,
             MamdaOptionAtTheMoneyCompareType  compareType);
 
+        /**
+         * Determine the lowest and highest strike prices that are
+         * included in a given percentage range of the underlying price.
+         * This is the allocation-free equivalent of
+         * getStrikesWithinPercent() and is answered by binary search on
+         * the strike index.  Returns false if there are no strikes within
+         * the percentage range.
+         */
+        bool getStrikeBoundsWithinPercent (
+            double&                           lowStrike,
+            double&                           highStrike,
+            double                            percentage,
+            MamdaOptionAtTheMoneyCompareType  compareType);
+
+        /**
+         * Determine the lowest and highest strike prices that are
+         * included in a given fixed size range of strikes surrounding the
+         * underlying price.  This is the allocation-free equivalent of
+         * getStrikesWithinRangeSize() and is answered by binary search on
+         * the strike index.  Returns false if the range is empty.
+         */
+        bool getStrikeBoundsWithinRangeSize (
+            double&                           lowStrike,
+            double&                           highStrike,
+            int                               rangeLength,
+            MamdaOptionAtTheMoneyCompareType  compareType);
+
+        /**
+         * Return the sorted index of all strike prices in the chain.
+         */
+        const StrikeIndex&  getStrikeIndex () const;
+
         /**
          * Determine whether some price (e.g. a strike price) is within a
          * given percentage range of the underlying (at the money) price.
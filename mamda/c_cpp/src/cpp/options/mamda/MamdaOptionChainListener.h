@@ -32,6 +32,7 @@ namespace Wombat
 
 class MamdaOptionChain;
 class MamdaOptionChainHandler;
+class MamdaOptionChainSnapshot;
 
 /**
  * MamdaOptionChainListener is a class that specializes in handling
@@ -93,6 +94,15 @@ public:
      */
     void addHandler (MamdaOptionChainHandler* handler);
 
+    /**
+     * Add a columnar snapshot of the chain to be kept up to date.  Each
+     * contract update received by the listener marks the contract dirty
+     * in the snapshot, ready for MamdaOptionChainSnapshot::refresh().
+     *
+     * @param snapshot The snapshot to mark dirty on contract updates.
+     */
+    void addSnapshot (MamdaOptionChainSnapshot* snapshot);
+
     /**
      * Return the option chain associated with this listener.
      *
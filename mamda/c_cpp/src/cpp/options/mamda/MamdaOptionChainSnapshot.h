@@ -0,0 +1,170 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#ifndef MamdaOptionChainSnapshotH
+#define MamdaOptionChainSnapshotH
+
+#include <mamda/MamdaOptionalConfig.h>
+#include <mama/mamacpp.h>
+#include <stddef.h>
+
+namespace Wombat
+{
+
+    class MamdaOptionChain;
+    class MamdaOptionChainView;
+    class MamdaOptionContract;
+
+    /**
+     * MamdaOptionChainSnapshot is a columnar (structure-of-arrays) copy
+     * of the pricing inputs for every contract in an option chain, or in
+     * a view of an option chain.  Each column is a contiguous array
+     * indexed by row, so that whole-chain calculations (e.g. revaluing
+     * the chain) can be run over plain arrays without virtual calls or
+     * pointer chasing per contract.
+     *
+     * The snapshot is built in one pass by populate().  Thereafter it can
+     * be kept current incrementally: contracts are marked dirty (either
+     * explicitly via markDirty() or automatically by a
+     * MamdaOptionChainListener to which the snapshot has been added) and
+     * refresh() re-reads only the dirty rows.  Contracts created after
+     * populate() are not included until populate() is called again.
+     */
+    class MAMDAOPTExpDLL MamdaOptionChainSnapshot
+    {
+        /** No copying. */
+        MamdaOptionChainSnapshot (const MamdaOptionChainSnapshot&);
+
+        /** No assignment. */
+        MamdaOptionChainSnapshot& operator= (const MamdaOptionChainSnapshot&);
+
+    public:
+        MamdaOptionChainSnapshot ();
+
+        ~MamdaOptionChainSnapshot ();
+
+        /**
+         * Rebuild the snapshot from all call and put contracts in the
+         * chain.
+         *
+         * @param chain The option chain to snapshot.
+         */
+        void populate (const MamdaOptionChain&  chain);
+
+        /**
+         * Rebuild the snapshot from all contracts visible in the view.
+         *
+         * @param view The option chain view to snapshot.
+         */
+        void populate (const MamdaOptionChainView&  view);
+
+        /**
+         * Mark a contract as having changed since the last populate() or
+         * refresh().  Contracts not in the snapshot are ignored.
+         *
+         * @param contract The contract which has changed.
+         */
+        void markDirty (const MamdaOptionContract&  contract);
+
+        /**
+         * Re-read the rows of all dirty contracts and clear the dirty
+         * set.
+         *
+         * @return The number of rows refreshed.
+         */
+        size_t refresh ();
+
+        /**
+         * Return the number of rows (contracts) in the snapshot.
+         */
+        size_t size () const;
+
+        /**
+         * Return the number of rows awaiting refresh().
+         */
+        size_t getDirtyCount () const;
+
+        /**
+         * Return the row for the given contract, or -1 if the contract is
+         * not in the snapshot.
+         */
+        long findRow (const MamdaOptionContract&  contract) const;
+
+        /**
+         * Return the contract in each row.
+         */
+        const MamdaOptionContract* const*  getContracts () const;
+
+        /**
+         * Return the strike price of each row.
+         */
+        const double*           getStrikePrices () const;
+
+        /**
+         * Return the expiration date of each row, in seconds since the
+         * epoch.
+         */
+        const double*           getExpireTimes () const;
+
+        /**
+         * Return the put/call indicator (MamdaOptionPutCall) of each row.
+         */
+        const char*             getPutCalls () const;
+
+        /**
+         * Return the bid price of each row.
+         */
+        const double*           getBidPrices () const;
+
+        /**
+         * Return the ask price of each row.
+         */
+        const double*           getAskPrices () const;
+
+        /**
+         * Return the last trade price of each row.
+         */
+        const double*           getLastPrices () const;
+
+        /**
+         * Return the bid size of each row.
+         */
+        const mama_quantity_t*  getBidSizes () const;
+
+        /**
+         * Return the ask size of each row.
+         */
+        const mama_quantity_t*  getAskSizes () const;
+
+        /**
+         * Return the last trade volume of each row.
+         */
+        const mama_quantity_t*  getLastVolumes () const;
+
+    private:
+        struct MamdaOptionChainSnapshotImpl;
+        MamdaOptionChainSnapshotImpl& mImpl;
+    };
+
+} // namespace
+
+#endif // MamdaOptionChainSnapshotH
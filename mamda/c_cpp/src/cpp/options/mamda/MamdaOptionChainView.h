@@ -30,6 +30,10 @@
 namespace Wombat
 {
 
+    class MamdaOptionChainViewRangeHandler;
+    class MamdaQuoteHandler;
+    class MamdaTradeHandler;
+
     /**
      * A class that represents a "view" of a subset of an option chain.
      * The view can be restricted to a percentage or number of strike
@@ -41,6 +45,15 @@ namespace Wombat
      * price hovers right on the edge of a range boundary, the class also
      * provides a "jitter margin" as some percentage of the underlying
      * price (default is 0.5%).
+     *
+     * Once the range is established, moves of the underlying beyond the
+     * jitter margin update the view incrementally: only the strike
+     * prices entering or leaving the range are added to or removed from
+     * the view, and only those changes are reported to any registered
+     * MamdaOptionChainViewRangeHandler.  The view learns of underlying
+     * moves via the handlers returned by getUnderlyingQuoteHandler() and
+     * getUnderlyingTradeHandler(), which should be added to the
+     * listeners for the underlying security.
      */
     class MAMDAOPTExpDLL MamdaOptionChainView : public MamdaOptionChainHandler
     {
@@ -128,6 +141,32 @@ namespace Wombat
          */
         void setJitterMargin (double  percentMargin);
 
+        /**
+         * Add a handler to be notified when the range of strike prices in
+         * the view changes.
+         *
+         * @param handler The handler to be notified of range changes.
+         */
+        void addRangeHandler (MamdaOptionChainViewRangeHandler*  handler);
+
+        /**
+         * Return a quote handler which keeps the strike range up to date
+         * as the underlying quote moves.  It should be added to the
+         * MamdaQuoteListener for the underlying security.
+         *
+         * @return The underlying quote handler.
+         */
+        MamdaQuoteHandler*  getUnderlyingQuoteHandler ();
+
+        /**
+         * Return a trade handler which keeps the strike range up to date
+         * as the underlying last trade moves.  It should be added to the
+         * MamdaTradeListener for the underlying security.
+         *
+         * @return The underlying trade handler.
+         */
+        MamdaTradeHandler*  getUnderlyingTradeHandler ();
+
         /**
          * Return whether an option contract falls within this view's
          * parameters.
@@ -23,6 +23,7 @@
 #define MamdaOptionChainViewRangeHandlerH
 
 #include <mamda/MamdaOptionalConfig.h>
+#include <mamda/MamdaOptionChain.h>
 
 namespace Wombat
 {
@@ -34,6 +35,7 @@ namespace Wombat
      */
     class MAMDAOPTExpDLL MamdaOptionChainViewRangeHandler
     {
+    public:
         /**
          * Action to take when the strike price range is reset to a new
          * range.
@@ -42,10 +44,32 @@ namespace Wombat
          * @param lowStrike     The low strike price in the range.
          * @param highStrike    The high strike price in the range.
          */
-        void onOptionViewStrikeRangeReset (
-            MamdaOptionChainView  view,
-            double                lowStrike,
-            double                highStrike) = 0;
+        virtual void onOptionViewStrikeRangeReset (
+            MamdaOptionChainView&  view,
+            double                 lowStrike,
+            double                 highStrike) = 0;
+
+        /**
+         * Action to take when strike prices enter the view.  Only the
+         * strikes which were not previously visible are reported.
+         *
+         * @param view          The option chain view in which the range changed.
+         * @param strikes       The strike prices which entered the view.
+         */
+        virtual void onOptionViewStrikesAdded (
+            MamdaOptionChainView&  view,
+            const StrikeSet&       strikes) {}
+
+        /**
+         * Action to take when strike prices leave the view.  Only the
+         * strikes which were previously visible are reported.
+         *
+         * @param view          The option chain view in which the range changed.
+         * @param strikes       The strike prices which left the view.
+         */
+        virtual void onOptionViewStrikesRemoved (
+            MamdaOptionChainView&  view,
+            const StrikeSet&       strikes) {}
             
         virtual ~MamdaOptionChainViewRangeHandler() {};
     };
@@ -38,13 +38,41 @@ namespace Wombat
      * expiration date.  Each strike price of which contains a set of
      * option contracts, each of which contains exchange-specific
      * contracts.  To access a contract set for a given strike price, use
-     * the get method (inherited from TreeMap).
+     * the find method.
+     *
+     * Alongside the map, a sorted contiguous index of the strike prices
+     * is maintained for binary-search range queries.  Only the read
+     * access of the underlying map is exposed; strike sets are added and
+     * removed via addStrikeSet(), removeStrikeSet() and trimStrikes() so
+     * that the index cannot fall out of step with the map.
      */
     class MAMDAOPTExpDLL MamdaOptionExpirationStrikes 
-        : public std::map <double, MamdaOptionStrikeSet*>
+        : private std::map <double, MamdaOptionStrikeSet*>
     {
+        typedef std::map <double, MamdaOptionStrikeSet*>  StrikeMap;
 
     public:
+        typedef StrikeMap::key_type                key_type;
+        typedef StrikeMap::mapped_type             mapped_type;
+        typedef StrikeMap::value_type              value_type;
+        typedef StrikeMap::size_type               size_type;
+        typedef StrikeMap::iterator                iterator;
+        typedef StrikeMap::const_iterator          const_iterator;
+        typedef StrikeMap::reverse_iterator        reverse_iterator;
+        typedef StrikeMap::const_reverse_iterator  const_reverse_iterator;
+
+        using StrikeMap::begin;
+        using StrikeMap::end;
+        using StrikeMap::rbegin;
+        using StrikeMap::rend;
+        using StrikeMap::size;
+        using StrikeMap::empty;
+        using StrikeMap::find;
+        using StrikeMap::count;
+        using StrikeMap::lower_bound;
+        using StrikeMap::upper_bound;
+        using StrikeMap::equal_range;
+
         MamdaOptionExpirationStrikes ();
         MamdaOptionExpirationStrikes (const MamdaOptionExpirationStrikes&  copy);
 
@@ -57,6 +85,43 @@ namespace Wombat
          */
         void trimStrikes (const StrikeSet&  strikeSet);
 
+        /**
+         * Trim the current set of strike prices to those within the given
+         * (inclusive) range.
+         *
+         * @param lowStrike  The lowest strike price to keep.
+         * @param highStrike The highest strike price to keep.
+         */
+        void trimStrikes (double  lowStrike,
+                          double  highStrike);
+
+        /**
+         * Add a strike set for the given strike price, if not already
+         * present.
+         *
+         * @param strikePrice The strike price.
+         * @param strikeSet   The strike set at that strike price.
+         */
+        void addStrikeSet (double                 strikePrice,
+                           MamdaOptionStrikeSet*  strikeSet);
+
+        /**
+         * Remove the strike set for the given strike price, if present.
+         * The strike set itself is not deleted.
+         *
+         * @param strikePrice The strike price.
+         */
+        void removeStrikeSet (double  strikePrice);
+
+        /**
+         * Return the sorted index of strike prices at this expiration.
+         *
+         * @return The strike index.
+         */
+        const StrikeIndex&  getStrikeIndex () const;
+
+    private:
+        StrikeIndex  mStrikeIndex;
     };
 
 } // namespace
@@ -20,20 +20,68 @@
  */
 
 #include <mamda/MamdaOrderBookChecker.h>
+#include <mamda/MamdaOrderBookCheckerPool.h>
 #include <mamda/MamdaOrderBook.h>
 #include <mamda/MamdaOrderBookHandler.h>
 #include <mamda/MamdaSubscription.h>
 #include <mama/mamacpp.h>
+#include <wombat/port.h>
+#include <deque>
+#include <vector>
 #include <iostream>
 #include <stdio.h>
 #include <stdlib.h>
 
 using std::cout;
+using std::deque;
+using std::vector;
 
 namespace Wombat
 {
 
 
+    /*
+     * A check queued to a MamdaOrderBookCheckerPool: snapshots of the
+     * real-time book and the book it is compared with.  Jobs are owned
+     * and recycled by their checker, so the books' storage is reused.
+     */
+    struct BookCheckJob
+    {
+        BookCheckJob (MamdaOrderBookChecker::MamdaOrderBookCheckerImpl&  owner)
+            : mOwner     (owner)
+            , mCheckType (MAMDA_BOOK_CHECK_TYPE_APPLY_DELTA) {}
+
+        MamdaOrderBookChecker::MamdaOrderBookCheckerImpl&  mOwner;
+        MamdaOrderBookCheckType                            mCheckType;
+        MamdaOrderBook                                     mRealTimeBook;
+        MamdaOrderBook                                     mCheckBook;
+    };
+
+    typedef deque<BookCheckJob*>  BookCheckJobList;
+
+    struct MamdaOrderBookCheckerPool::MamdaOrderBookCheckerPoolImpl
+    {
+        MamdaOrderBookCheckerPoolImpl (mama_u32_t  numThreads,
+                                       mama_u32_t  maxPending);
+        ~MamdaOrderBookCheckerPoolImpl ();
+
+        bool          enqueue      (BookCheckJob*  job);
+
+        mama_u32_t    removeJobs   (MamdaOrderBookChecker::MamdaOrderBookCheckerImpl&  owner);
+
+        void          run          ();
+
+        static void*  workerThread (void*  closure);
+
+        wthread_mutex_t      mLock;
+        wsem_t               mJobsAvailable;
+        BookCheckJobList     mJobs;
+        vector<wthread_t>    mThreads;
+        mama_u32_t           mMaxPending;
+        mama_u64_t           mDroppedCount;
+        bool                 mStopping;
+    };
+
     class RealTimeChecker : public MamdaOrderBookHandler
     {
     public:
@@ -155,6 +203,24 @@ namespace Wombat
 
         void          checkSnapShotNow ();
 
+        bool          sampleDelta      ();
+
+        void          checkDelta       (const MamaMsg*           msg,
+                                        bool                     sampled);
+
+        void          checkSnapShot    (const MamaMsg*           msg,
+                                        const MamdaOrderBook&    snappedBook);
+
+        bool          queueCheck       (MamdaOrderBookCheckType  checkType,
+                                        const MamdaOrderBook&    checkBook);
+
+        void          compareBooks     (MamdaOrderBookCheckType  checkType,
+                                        const MamaMsg*           msg,
+                                        const MamdaOrderBook&    realTimeBook,
+                                        const MamdaOrderBook&    checkBook);
+
+        void          runJob           (BookCheckJob&            job);
+
         MamdaOrderBookCheckerHandler*  mHandler;
         const MamdaSubscription*       mRealTimeSubsc;
         const MamdaOrderBook*          mRealTimeBook;
@@ -172,9 +238,39 @@ namespace Wombat
         mama_u32_t                     mSuccessCount;
         mama_u32_t                     mInconclusiveCount;
         mama_u32_t                     mFailureCount;
+        mama_u32_t                     mSkippedCount;
         mama_seqnum_t                  mLiveSeqNum;
+
+        // Sampling policy, applied on the dispatch thread.
+        mama_u32_t                     mSampleRate;
+        mama_u32_t                     mSampleCount;
+        mama_f64_t                     mMaxDispatchFraction;
+        mama_u64_t                     mWindowStart;
+        mama_u64_t                     mWindowCost;
+
+        // Asynchronous checking.  mJobLock guards the counters above as
+        // well as the job state below.
+        MamdaOrderBookCheckerPool*     mPool;
+        wthread_mutex_t                mJobLock;
+        BookCheckJobList               mFreeJobs;
+        mama_u32_t                     mOutstanding;
+        bool                           mDestroying;
+        wsem_t                         mDrained;
     };
 
+    /*
+     * The length of the window over which the dispatch time budget is
+     * applied.
+     */
+    static const mama_u64_t CHECK_BUDGET_WINDOW = 1000000;
+
+    static mama_u64_t getCheckTime ()
+    {
+        struct timeval now;
+        gettimeofday (&now, NULL);
+        return (mama_u64_t) now.tv_sec * 1000000 + now.tv_usec;
+    }
+
     MamdaOrderBookChecker::MamdaOrderBookChecker (
         MamaQueue*                     queue,
         MamdaOrderBookCheckerHandler*  handler,
@@ -223,6 +319,29 @@ namespace Wombat
         return mImpl.mFailureCount;
     }
 
+    void MamdaOrderBookChecker::setCheckerPool (MamdaOrderBookCheckerPool*  pool)
+    {
+        mImpl.mPool = pool;
+    }
+
+    void MamdaOrderBookChecker::setSampleRate (mama_u32_t  sampleRate)
+    {
+        mImpl.mSampleRate  = sampleRate > 0 ? sampleRate : 1;
+        mImpl.mSampleCount = 0;
+    }
+
+    void MamdaOrderBookChecker::setMaxDispatchFraction (mama_f64_t  fraction)
+    {
+        mImpl.mMaxDispatchFraction = fraction;
+        mImpl.mWindowStart         = 0;
+        mImpl.mWindowCost          = 0;
+    }
+
+    mama_u32_t MamdaOrderBookChecker::getSkippedCount() const
+    {
+        return mImpl.mSkippedCount;
+    }
+
     MamdaOrderBookChecker::MamdaOrderBookCheckerImpl::MamdaOrderBookCheckerImpl (
         MamaQueue*                     queue,
         MamdaOrderBookCheckerHandler*  handler,
@@ -238,7 +357,16 @@ namespace Wombat
         , mSuccessCount         (0)
         , mInconclusiveCount    (0)
         , mFailureCount         (0)
+        , mSkippedCount         (0)
         , mLiveSeqNum           (0)
+        , mSampleRate           (1)
+        , mSampleCount          (0)
+        , mMaxDispatchFraction  (0.0)
+        , mWindowStart          (0)
+        , mWindowCost           (0)
+        , mPool                 (NULL)
+        , mOutstanding          (0)
+        , mDestroying           (false)
     {
         MamdaOrderBook*    aBook = new MamdaOrderBook;
         MamdaSubscription* aSub  = new MamdaSubscription;
@@ -269,7 +397,16 @@ namespace Wombat
         , mSuccessCount     (0)
         , mInconclusiveCount(0)
         , mFailureCount     (0)
+        , mSkippedCount     (0)
         , mLiveSeqNum       (0)
+        , mSampleRate       (1)
+        , mSampleCount      (0)
+        , mMaxDispatchFraction (0.0)
+        , mWindowStart      (0)
+        , mWindowCost       (0)
+        , mPool             (NULL)
+        , mOutstanding      (0)
+        , mDestroying       (false)
     {
         mAggDeltaBook.copy (realTimeBook);
         init();
@@ -277,6 +414,27 @@ namespace Wombat
 
     MamdaOrderBookChecker::MamdaOrderBookCheckerImpl::~MamdaOrderBookCheckerImpl()
     {
+        // Wait for any of our checks still running on the pool.
+        wthread_mutex_lock (&mJobLock);
+        if (mPool)
+        {
+            mOutstanding -= mPool->mImpl.removeJobs (*this);
+        }
+        bool wait = mOutstanding > 0;
+        mDestroying = true;
+        wthread_mutex_unlock (&mJobLock);
+
+        if (wait)
+            wsem_wait (&mDrained);
+
+        while (!mFreeJobs.empty())
+        {
+            delete mFreeJobs.front();
+            mFreeJobs.pop_front();
+        }
+        wsem_destroy (&mDrained);
+        wthread_mutex_destroy (&mJobLock);
+
         if (mRealTimeObjsAreLocal)
         {
             delete mRealTimeSubsc;
@@ -287,6 +445,9 @@ namespace Wombat
 
     void MamdaOrderBookChecker::MamdaOrderBookCheckerImpl::init()
     {
+        wthread_mutex_init (&mJobLock, NULL);
+        wsem_init (&mDrained, 0, 0);
+
         mRealTimeListener->addHandler (&mRealTimeHandler);
         mSnapShotListener.addHandler  (&mSnapShotHandler);
         mSnapShotSubsc.addMsgListener (&mSnapShotListener);
@@ -337,49 +498,181 @@ namespace Wombat
                                 mRealTimeSubsc->getSymbol());
     }
 
-    void RealTimeChecker::onBookRecap (
-        MamdaSubscription*                 subscription,
-        MamdaOrderBookListener&            listener,
-        const MamaMsg*                     msg,
-        const MamdaOrderBookComplexDelta*  delta,
-        const MamdaOrderBookRecap&         recap,
-        const MamdaOrderBook&              book)
+    bool MamdaOrderBookChecker::MamdaOrderBookCheckerImpl::sampleDelta()
     {
-        mama_log (MAMA_LOG_LEVEL_FINE,
-                  "MamdaOrderBookChecker: received book recap for symbol %s (seq#: %d)",
-                  subscription->getSymbol(), subscription->getSeqNum()); 
-        mImpl.mAggDeltaBook.copy (book);
+        if (++mSampleCount < mSampleRate)
+            return false;
+        mSampleCount = 0;
+
+        if (mMaxDispatchFraction <= 0.0)
+            return true;
 
+        mama_u64_t now = getCheckTime();
+        if (now - mWindowStart >= CHECK_BUDGET_WINDOW)
+        {
+            mWindowStart = now;
+            mWindowCost  = 0;
+        }
+
+        if (mWindowCost >= mMaxDispatchFraction * CHECK_BUDGET_WINDOW)
+        {
+            wthread_mutex_lock (&mJobLock);
+            mSkippedCount++;
+            wthread_mutex_unlock (&mJobLock);
+            return false;
+        }
+        return true;
+    }
+
+    void MamdaOrderBookChecker::MamdaOrderBookCheckerImpl::checkDelta (
+        const MamaMsg*  msg,
+        bool            sampled)
+    {
+        if (!sampled && !sampleDelta())
+            return;
+
+        mama_u64_t start = mMaxDispatchFraction > 0.0 ? getCheckTime() : 0;
+
+        if (mPool)
+        {
+            queueCheck (MAMDA_BOOK_CHECK_TYPE_APPLY_DELTA, mAggDeltaBook);
+        }
+        else
+        {
+            compareBooks (MAMDA_BOOK_CHECK_TYPE_APPLY_DELTA, msg,
+                          *mRealTimeBook, mAggDeltaBook);
+        }
+
+        if (start)
+            mWindowCost += getCheckTime() - start;
+    }
+
+    void MamdaOrderBookChecker::MamdaOrderBookCheckerImpl::checkSnapShot (
+        const MamaMsg*         msg,
+        const MamdaOrderBook&  snappedBook)
+    {
+        if (mPool)
+        {
+            queueCheck (MAMDA_BOOK_CHECK_TYPE_SNAPSHOT, snappedBook);
+        }
+        else
+        {
+            compareBooks (MAMDA_BOOK_CHECK_TYPE_SNAPSHOT, msg,
+                          *mRealTimeBook, snappedBook);
+        }
+    }
+
+    bool MamdaOrderBookChecker::MamdaOrderBookCheckerImpl::queueCheck (
+        MamdaOrderBookCheckType  checkType,
+        const MamdaOrderBook&    checkBook)
+    {
+        BookCheckJob* job = NULL;
+
+        wthread_mutex_lock (&mJobLock);
+        if (!mFreeJobs.empty())
+        {
+            job = mFreeJobs.front();
+            mFreeJobs.pop_front();
+        }
+        wthread_mutex_unlock (&mJobLock);
+
+        if (!job)
+            job = new BookCheckJob (*this);
+
+        // Snapshot both books; the real-time book keeps changing.
+        job->mCheckType = checkType;
+        job->mRealTimeBook.copy (*mRealTimeBook);
+        job->mCheckBook.copy (checkBook);
+
+        wthread_mutex_lock (&mJobLock);
+        mOutstanding++;
+        wthread_mutex_unlock (&mJobLock);
+
+        if (mPool->mImpl.enqueue (job))
+            return true;
+
+        wthread_mutex_lock (&mJobLock);
+        mOutstanding--;
+        mSkippedCount++;
+        mFreeJobs.push_back (job);
+        wthread_mutex_unlock (&mJobLock);
+        return false;
+    }
+
+    void MamdaOrderBookChecker::MamdaOrderBookCheckerImpl::compareBooks (
+        MamdaOrderBookCheckType  checkType,
+        const MamaMsg*           msg,
+        const MamdaOrderBook&    realTimeBook,
+        const MamdaOrderBook&    checkBook)
+    {
         try
         {
-            mImpl.mAggDeltaBook.assertEqual (*mImpl.mRealTimeBook);
+            checkBook.assertEqual (realTimeBook);
 
             // Successful result
-            mImpl.mSuccessCount++;
-            if (mImpl.mHandler)
-                mImpl.mHandler->onSuccess (
-                    MAMDA_BOOK_CHECK_TYPE_APPLY_DELTA);
+            wthread_mutex_lock (&mJobLock);
+            mSuccessCount++;
+            wthread_mutex_unlock (&mJobLock);
+            if (mHandler)
+                mHandler->onSuccess (checkType);
         }
         catch (MamdaOrderBookException& e)
         {
             // Failure
-            mImpl.mFailureCount++;
-            if (mImpl.mHandler)
-                mImpl.mHandler->onFailure(
-                    MAMDA_BOOK_CHECK_TYPE_APPLY_DELTA,
-                    e.what(), msg, 
-                    *mImpl.mRealTimeBook, mImpl.mAggDeltaBook);
+            wthread_mutex_lock (&mJobLock);
+            mFailureCount++;
+            wthread_mutex_unlock (&mJobLock);
+            if (mHandler)
+                mHandler->onFailure (checkType, e.what(), msg,
+                                     realTimeBook, checkBook);
             if (gMamaLogLevel >= MAMA_LOG_LEVEL_FINE)
             {
-                std::cout << "Failed delta book check: current book: \n";
-                mImpl.mRealTimeBook->dump(cout);
-                std::cout << "Failed delta book check: aggregate delta book: \n";
-                mImpl.mAggDeltaBook.dump(cout);
+                const char* checkName =
+                    checkType == MAMDA_BOOK_CHECK_TYPE_SNAPSHOT ? "" : "delta ";
+                std::cout << "Failed " << checkName << "book check: current book: \n";
+                realTimeBook.dump(cout);
+                if (checkType == MAMDA_BOOK_CHECK_TYPE_SNAPSHOT)
+                    std::cout << "Failed book check: snapped book: \n";
+                else
+                    std::cout << "Failed delta book check: aggregate delta book: \n";
+                checkBook.dump(cout);
                 std::cout << "\n";
             }
         }
     }
 
+    void MamdaOrderBookChecker::MamdaOrderBookCheckerImpl::runJob (
+        BookCheckJob&  job)
+    {
+        // Called on a pool thread.
+        compareBooks (job.mCheckType, NULL, job.mRealTimeBook, job.mCheckBook);
+
+        wthread_mutex_lock (&mJobLock);
+        mFreeJobs.push_back (&job);
+        bool drained = --mOutstanding == 0 && mDestroying;
+        wthread_mutex_unlock (&mJobLock);
+
+        if (drained)
+            wsem_post (&mDrained);
+    }
+
+    void RealTimeChecker::onBookRecap (
+        MamdaSubscription*                 subscription,
+        MamdaOrderBookListener&            listener,
+        const MamaMsg*                     msg,
+        const MamdaOrderBookComplexDelta*  delta,
+        const MamdaOrderBookRecap&         recap,
+        const MamdaOrderBook&              book)
+    {
+        mama_log (MAMA_LOG_LEVEL_FINE,
+                  "MamdaOrderBookChecker: received book recap for symbol %s (seq#: %d)",
+                  subscription->getSymbol(), subscription->getSeqNum()); 
+        mImpl.mAggDeltaBook.copy (book);
+
+        // Recaps are always checked.
+        mImpl.checkDelta (msg, true);
+    }
+
     void RealTimeChecker::onBookDelta (
         MamdaSubscription*                subscription,
         MamdaOrderBookListener&           listener,
@@ -391,35 +684,7 @@ namespace Wombat
                   "MamdaOrderBookChecker: received book delta for symbol %s (seq#: %d)",
                   subscription->getSymbol(), subscription->getSeqNum()); 
         mImpl.mAggDeltaBook.apply (delta);
-
-        try
-        {
-            mImpl.mAggDeltaBook.assertEqual (*mImpl.mRealTimeBook);
-
-            // Successful result
-            mImpl.mSuccessCount++;
-            if (mImpl.mHandler)
-                mImpl.mHandler->onSuccess(
-                    MAMDA_BOOK_CHECK_TYPE_APPLY_DELTA);
-        }
-        catch (MamdaOrderBookException& e)
-        {
-            // Failure
-            mImpl.mFailureCount++;
-            if (mImpl.mHandler)
-                mImpl.mHandler->onFailure(
-                    MAMDA_BOOK_CHECK_TYPE_APPLY_DELTA,
-                    e.what(), msg,
-                    *mImpl.mRealTimeBook, mImpl.mAggDeltaBook);
-            if (gMamaLogLevel >= MAMA_LOG_LEVEL_FINE)
-            {
-                std::cout << "Failed delta book check: current book: \n";
-                mImpl.mRealTimeBook->dump(cout);
-                std::cout << "Failed delta book check: aggregate delta book: \n";
-                mImpl.mAggDeltaBook.dump(cout);
-                std::cout << "\n";
-            }
-        }
+        mImpl.checkDelta (msg, false);
     }
 
     void RealTimeChecker::onBookComplexDelta (
@@ -433,35 +698,7 @@ namespace Wombat
                   "MamdaOrderBookChecker: received complex book delta for symbol %s (seq#: %d)",
                   subscription->getSymbol(), subscription->getSeqNum()); 
         mImpl.mAggDeltaBook.apply (delta);
-
-        try
-        {
-            mImpl.mAggDeltaBook.assertEqual (*mImpl.mRealTimeBook);
-
-            // Successful result
-            mImpl.mSuccessCount++;
-            if (mImpl.mHandler)
-                mImpl.mHandler->onSuccess(
-                    MAMDA_BOOK_CHECK_TYPE_APPLY_DELTA);
-        }
-        catch (MamdaOrderBookException& e)
-        {
-            // Failure
-            mImpl.mFailureCount++;
-            if (mImpl.mHandler)
-                mImpl.mHandler->onFailure(
-                    MAMDA_BOOK_CHECK_TYPE_APPLY_DELTA,
-                    e.what(), msg,
-                    *mImpl.mRealTimeBook, mImpl.mAggDeltaBook);
-            if (gMamaLogLevel >= MAMA_LOG_LEVEL_FINE)
-            {
-                std::cout << "Failed complex delta book check: current book: \n";
-                mImpl.mRealTimeBook->dump(cout);
-                std::cout << "Failed delta book check: aggregate delta book: \n";
-                mImpl.mAggDeltaBook.dump(cout);
-                std::cout << "\n";
-            }
-        }
+        mImpl.checkDelta (msg, false);
     }
 
     void RealTimeChecker::onBookClear (
@@ -475,35 +712,7 @@ namespace Wombat
                   "MamdaOrderBookChecker: received book clear for symbol %s (seq#: %d)",
                   subscription->getSymbol(), subscription->getSeqNum()); 
         mImpl.mAggDeltaBook.clear();
-
-        try
-        {
-            mImpl.mAggDeltaBook.assertEqual (*mImpl.mRealTimeBook);
-
-            // Successful result
-            mImpl.mSuccessCount++;
-            if (mImpl.mHandler)
-                mImpl.mHandler->onSuccess(
-                    MAMDA_BOOK_CHECK_TYPE_APPLY_DELTA);
-        }
-        catch (MamdaOrderBookException& e)
-        {
-            // Failure
-            mImpl.mFailureCount++;
-            if (mImpl.mHandler)
-                mImpl.mHandler->onFailure(
-                    MAMDA_BOOK_CHECK_TYPE_APPLY_DELTA,
-                    e.what(), msg,
-                    *mImpl.mRealTimeBook, mImpl.mAggDeltaBook);
-            if (gMamaLogLevel >= MAMA_LOG_LEVEL_FINE)
-            {
-                std::cout << "Failed delta book check: current book: \n";
-                mImpl.mRealTimeBook->dump(cout);
-                std::cout << "Failed delta book check: aggregate delta book: \n";
-                mImpl.mAggDeltaBook.dump(cout);
-                std::cout << "\n";
-            }
-        }
+        mImpl.checkDelta (msg, false);
     }
 
     void RealTimeChecker::onBookGap (
@@ -536,7 +745,9 @@ namespace Wombat
         if (snappedSeqNum != realTimeSeqNum)
         {
             // Inconclusive result because the sequence numbers were different.
+            wthread_mutex_lock (&mImpl.mJobLock);
             mImpl.mInconclusiveCount++;
+            wthread_mutex_unlock (&mImpl.mJobLock);
             if (mImpl.mHandler)
             {
                 char msg[256];
@@ -548,35 +759,149 @@ namespace Wombat
         }
         else
         {
-            try
+            mImpl.checkSnapShot (msg, snappedBook);
+        }
+    }
+
+    MamdaOrderBookCheckerPool::MamdaOrderBookCheckerPool (
+        mama_u32_t  numThreads,
+        mama_u32_t  maxPending)
+        : mImpl (*new MamdaOrderBookCheckerPoolImpl (numThreads, maxPending))
+    {
+    }
+
+    MamdaOrderBookCheckerPool::~MamdaOrderBookCheckerPool ()
+    {
+        delete &mImpl;
+    }
+
+    mama_u32_t MamdaOrderBookCheckerPool::getPendingCount () const
+    {
+        wthread_mutex_lock (&mImpl.mLock);
+        mama_u32_t pending = (mama_u32_t) mImpl.mJobs.size();
+        wthread_mutex_unlock (&mImpl.mLock);
+        return pending;
+    }
+
+    mama_u64_t MamdaOrderBookCheckerPool::getDroppedCount () const
+    {
+        return mImpl.mDroppedCount;
+    }
+
+    MamdaOrderBookCheckerPool::MamdaOrderBookCheckerPoolImpl::MamdaOrderBookCheckerPoolImpl (
+        mama_u32_t  numThreads,
+        mama_u32_t  maxPending)
+        : mMaxPending   (maxPending)
+        , mDroppedCount (0)
+        , mStopping     (false)
+    {
+        wthread_mutex_init (&mLock, NULL);
+        wsem_init (&mJobsAvailable, 0, 0);
+
+        if (numThreads == 0)
+            numThreads = 1;
+
+        for (mama_u32_t i = 0; i < numThreads; ++i)
+        {
+            wthread_t thread;
+            if (0 != wthread_create (&thread, NULL, workerThread, this))
             {
-                snappedBook.assertEqual(*mImpl.mRealTimeBook);
+                mama_log (MAMA_LOG_LEVEL_ERROR,
+                          "MamdaOrderBookCheckerPool: failed to create "
+                          "worker thread");
+                break;
+            }
+            mThreads.push_back (thread);
+        }
+    }
+
+    MamdaOrderBookCheckerPool::MamdaOrderBookCheckerPoolImpl::~MamdaOrderBookCheckerPoolImpl ()
+    {
+        wthread_mutex_lock (&mLock);
+        mStopping = true;
+        wthread_mutex_unlock (&mLock);
+
+        for (size_t i = 0; i < mThreads.size(); ++i)
+            wsem_post (&mJobsAvailable);
 
-                // Successful result
-                mImpl.mSuccessCount++;
-                if (mImpl.mHandler)
-                    mImpl.mHandler->onSuccess(
-                        MAMDA_BOOK_CHECK_TYPE_SNAPSHOT);
+        for (size_t i = 0; i < mThreads.size(); ++i)
+            wthread_join (mThreads[i], NULL);
+
+        wsem_destroy (&mJobsAvailable);
+        wthread_mutex_destroy (&mLock);
+    }
+
+    bool MamdaOrderBookCheckerPool::MamdaOrderBookCheckerPoolImpl::enqueue (
+        BookCheckJob*  job)
+    {
+        wthread_mutex_lock (&mLock);
+        if (mStopping || mThreads.empty() || mJobs.size() >= mMaxPending)
+        {
+            mDroppedCount++;
+            wthread_mutex_unlock (&mLock);
+            return false;
+        }
+        mJobs.push_back (job);
+        wthread_mutex_unlock (&mLock);
+
+        wsem_post (&mJobsAvailable);
+        return true;
+    }
+
+    mama_u32_t MamdaOrderBookCheckerPool::MamdaOrderBookCheckerPoolImpl::removeJobs (
+        MamdaOrderBookChecker::MamdaOrderBookCheckerImpl&  owner)
+    {
+        mama_u32_t removed = 0;
+
+        wthread_mutex_lock (&mLock);
+        BookCheckJobList::iterator i = mJobs.begin();
+        while (i != mJobs.end())
+        {
+            if (&(*i)->mOwner == &owner)
+            {
+                owner.mFreeJobs.push_back (*i);
+                i = mJobs.erase (i);
+                removed++;
             }
-            catch (MamdaOrderBookException& e)
+            else
             {
-                // Failure
-                mImpl.mFailureCount++;
-                if (mImpl.mHandler)
-                    mImpl.mHandler->onFailure(
-                        MAMDA_BOOK_CHECK_TYPE_SNAPSHOT,
-                        e.what(), msg,
-                        *mImpl.mRealTimeBook, snappedBook);
-                if (gMamaLogLevel >= MAMA_LOG_LEVEL_FINE)
-                {
-                    std::cout << "Failed book check: current book: \n";
-                    mImpl.mRealTimeBook->dump(cout);
-                    std::cout << "Failed book check: snapped book: \n";
-                    snappedBook.dump(cout);
-                    std::cout << "\n";
-                }
+                ++i;
             }
         }
+        wthread_mutex_unlock (&mLock);
+
+        return removed;
+    }
+
+    void MamdaOrderBookCheckerPool::MamdaOrderBookCheckerPoolImpl::run ()
+    {
+        while (true)
+        {
+            wsem_wait (&mJobsAvailable);
+
+            wthread_mutex_lock (&mLock);
+            if (mJobs.empty())
+            {
+                // Either a stop request or a job removed by its checker.
+                bool stopping = mStopping;
+                wthread_mutex_unlock (&mLock);
+                if (stopping)
+                    return;
+                continue;
+            }
+            BookCheckJob* job = mJobs.front();
+            mJobs.pop_front();
+            wthread_mutex_unlock (&mLock);
+
+            job->mOwner.runJob (*job);
+        }
+    }
+
+    void* MamdaOrderBookCheckerPool::MamdaOrderBookCheckerPoolImpl::workerThread (
+        void*  closure)
+    {
+        static_cast<MamdaOrderBookCheckerPoolImpl*>(closure)->run();
+        return NULL;
     }
 
 } // namespace
@@ -31,6 +31,7 @@ namespace Wombat
 {
 
     class MamdaOrderBook;
+    class MamdaOrderBookCheckerPool;
     class MamdaOrderBookListener;
     class MamdaOrderSource;
 
@@ -48,6 +49,12 @@ namespace Wombat
      * provides an interval representing the frequency of the snapshot
      * checks.  The first check will take place at some random point in
      * time between zero and the interval.
+     *
+     * By default every real-time update is checked on the dispatch
+     * thread.  For production use, the checks can be sampled
+     * (setSampleRate()), bounded to a fraction of dispatch time
+     * (setMaxDispatchFraction()) and moved to background threads
+     * (setCheckerPool()).
      */
 
     class MAMDAOPTExpDLL MamdaOrderBookChecker
@@ -121,6 +128,45 @@ namespace Wombat
          */
         mama_u32_t getFailureCount() const;
 
+        /**
+         * Run comparisons on the given pool's worker threads.  Sampled
+         * checks then only take a snapshot of the books involved on the
+         * dispatch thread, and the handler is invoked from a worker
+         * thread (with a NULL message for failed delta checks).  Passing
+         * NULL reverts to checking on the dispatch thread.
+         *
+         * @param pool The checker pool, which must outlive this checker.
+         */
+        void setCheckerPool (MamdaOrderBookCheckerPool*  pool);
+
+        /**
+         * Check only one in every sampleRate real-time updates.  The
+         * aggregated delta book is still maintained for every update.
+         * The default is 1 (check every update).
+         *
+         * @param sampleRate The sampling rate.
+         */
+        void setSampleRate (mama_u32_t  sampleRate);
+
+        /**
+         * Bound the time spent checking real-time updates on the dispatch
+         * thread to the given fraction of each second (e.g. 0.01 for 1%).
+         * Sampled checks over the budget are skipped.  The default of
+         * zero means no limit.
+         *
+         * @param fraction The fraction of dispatch time.
+         */
+        void setMaxDispatchFraction (mama_f64_t  fraction);
+
+        /**
+         * Return the number of sampled checks which were skipped, because
+         * the dispatch time budget was exhausted or the checker pool was
+         * full.
+         *
+         * @return The number of skipped checks.
+         */
+        mama_u32_t getSkippedCount() const;
+
         struct MamdaOrderBookCheckerImpl;
 
     private:
@@ -0,0 +1,88 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#ifndef MamdaOrderBookCheckerPoolH
+#define MamdaOrderBookCheckerPoolH
+
+#include <mamda/MamdaOptionalConfig.h>
+#include <mamda/MamdaOrderBookChecker.h>
+#include <mama/mamacpp.h>
+
+namespace Wombat
+{
+
+    /**
+     * MamdaOrderBookCheckerPool is a pool of background threads on which
+     * MamdaOrderBookChecker instances can run their book comparisons,
+     * rather than on the dispatch thread of the real-time book.  One pool
+     * is typically shared by all the checkers of an application.
+     *
+     * Checks are queued to the pool as snapshots of the books involved,
+     * so the real-time book may continue to change while they run.  If
+     * more than maxPending checks are queued, further checks are dropped
+     * (and counted) rather than letting the backlog grow.
+     *
+     * All checkers using a pool must be destroyed before the pool.
+     *
+     * @see MamdaOrderBookChecker#setCheckerPool()
+     */
+    class MAMDAOPTExpDLL MamdaOrderBookCheckerPool
+    {
+        MamdaOrderBookCheckerPool (const MamdaOrderBookCheckerPool&);
+        MamdaOrderBookCheckerPool& operator= (const MamdaOrderBookCheckerPool&);
+
+    public:
+        /**
+         * Constructor.  The worker threads are started immediately.
+         *
+         * @param numThreads The number of worker threads.
+         * @param maxPending The maximum number of queued checks.
+         */
+        MamdaOrderBookCheckerPool (mama_u32_t  numThreads = 1,
+                                   mama_u32_t  maxPending = 1024);
+
+        /**
+         * Destructor.  Completes any queued checks and stops the worker
+         * threads.
+         */
+        ~MamdaOrderBookCheckerPool ();
+
+        /**
+         * @return The number of checks currently queued.
+         */
+        mama_u32_t getPendingCount () const;
+
+        /**
+         * @return The number of checks dropped because the queue was full.
+         */
+        mama_u64_t getDroppedCount () const;
+
+        struct MamdaOrderBookCheckerPoolImpl;
+
+    private:
+        friend struct MamdaOrderBookChecker::MamdaOrderBookCheckerImpl;
+        MamdaOrderBookCheckerPoolImpl& mImpl;
+    };
+
+} // namespace
+
+#endif // MamdaOrderBookCheckerPoolH
@@ -626,6 +626,14 @@ int main (int argc, const char** argv)
             aBaseTradeListener->addHandler (aBaseTicker);
             aBaseQuoteListener->addHandler (aBaseTicker);
             aFundamentalListener->addHandler (aBaseTicker);
+
+            // Let the view track the underlying so that its strike
+            // range follows the money.
+            aBaseTradeListener->addHandler (
+                anOptionView->getUnderlyingTradeHandler ());
+            aBaseQuoteListener->addHandler (
+                anOptionView->getUnderlyingQuoteHandler ());
+
             aBaseSubscription->addMsgListener (aBaseQuoteListener);
             aBaseSubscription->addMsgListener (aBaseTradeListener);
             aBaseSubscription->addMsgListener (aFundamentalListener);
@@ -0,0 +1,168 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "MamdaNewsHeadlineIndex.h"
+#include <mamda/MamdaNewsHeadline.h>
+#include <mamda/MamdaQuery.h>
+#include <mama/MamaDateTime.h>
+#include <mama/MamaMsg.h>
+
+using namespace Wombat;
+
+class MamdaNewsHeadlineIndexTest : public ::testing::Test
+{
+protected:
+    MamdaNewsHeadlineIndexTest () {}
+    virtual ~MamdaNewsHeadlineIndexTest () {}
+
+    virtual void SetUp()
+    {
+        mMsg.create();
+        mIndex.setMaxHeadlines (3);
+    }
+
+    virtual void TearDown()
+    {
+        mIndex.clear();
+    }
+
+    void addHeadline (const char*  text,
+                      const char*  symbol,
+                      mama_u64_t   timeMillis)
+    {
+        MamaDateTime  eventTime;
+        eventTime.setEpochTimeMilliseconds (timeMillis);
+
+        const char*        symbols[] = { symbol };
+        MamdaNewsHeadline  headline;
+        headline.setHeadlineText    (text);
+        headline.setRelatedSymbols  (symbols, 1);
+        headline.setEventTime       (eventTime);
+
+        mIndex.add (mMsg, headline);
+    }
+
+    bool evaluateDates (mama_u64_t  start,
+                        mama_u64_t  end)
+    {
+        MamdaNewsHeadlineIndex::Results  results;
+        MamaDateTime  startTime;
+        MamaDateTime  endTime;
+        startTime.setEpochTimeMilliseconds (start);
+        endTime.setEpochTimeMilliseconds   (end);
+
+        MamdaDateQuery  query (startTime, endTime);
+        return mIndex.evaluate (query, results);
+    }
+
+    MamdaNewsHeadlineIndex  mIndex;
+    MamaMsg                 mMsg;
+};
+
+TEST_F (MamdaNewsHeadlineIndexTest, DateRangeInWindowIsLocal)
+{
+    addHeadline ("IBM beats estimates", "IBM",  1000);
+    addHeadline ("MSFT misses",         "MSFT", 2000);
+
+    MamdaNewsHeadlineIndex::Results  results;
+    MamaDateTime  startTime;
+    MamaDateTime  endTime;
+    startTime.setEpochTimeMilliseconds (1500);
+    endTime.setEpochTimeMilliseconds   (2500);
+
+    MamdaDateQuery  query (startTime, endTime);
+    ASSERT_TRUE (mIndex.evaluate (query, results));
+    ASSERT_EQ   (1U, results.size());
+    EXPECT_EQ   (2000U, results[0]->mTime);
+    EXPECT_EQ   (1000U, mIndex.getCoverageStart());
+}
+
+TEST_F (MamdaNewsHeadlineIndexTest, UnboundedQueryGoesRemote)
+{
+    addHeadline ("IBM beats estimates", "IBM", 1000);
+
+    // Older IBM headlines may exist that were never seen.
+    MamdaNewsHeadlineIndex::Results  results;
+    MamdaEqualsQuery  query ("wNewsSymbols", "IBM");
+    EXPECT_FALSE (mIndex.evaluate (query, results));
+}
+
+TEST_F (MamdaNewsHeadlineIndexTest, DateRangeBeforeWindowGoesRemote)
+{
+    addHeadline ("IBM beats estimates", "IBM", 1000);
+
+    EXPECT_FALSE (evaluateDates (500, 1500));
+    EXPECT_TRUE  (evaluateDates (1000, 1500));
+}
+
+TEST_F (MamdaNewsHeadlineIndexTest, EvictionShrinksCoverage)
+{
+    addHeadline ("first",  "IBM", 1000);
+    addHeadline ("second", "IBM", 2000);
+    addHeadline ("third",  "IBM", 3000);
+    addHeadline ("fourth", "IBM", 4000);
+
+    EXPECT_EQ    (3U, mIndex.size());
+    EXPECT_EQ    (1001U, mIndex.getCoverageStart());
+    EXPECT_FALSE (evaluateDates (1000, 5000));
+    EXPECT_TRUE  (evaluateDates (1001, 5000));
+}
+
+TEST_F (MamdaNewsHeadlineIndexTest, AndNeedsOneCoveredBranch)
+{
+    addHeadline ("IBM beats estimates", "IBM",  1000);
+    addHeadline ("MSFT misses",         "MSFT", 2000);
+
+    MamaDateTime  startTime;
+    MamaDateTime  endTime;
+    startTime.setEpochTimeMilliseconds (1000);
+    endTime.setEpochTimeMilliseconds   (3000);
+
+    MamdaNewsHeadlineIndex::Results  results;
+    MamdaEqualsQuery  symbolQuery ("wNewsSymbols", "MSFT");
+    MamdaDateQuery    dateQuery   (startTime, endTime);
+
+    MamdaAndQuery  andQuery (&symbolQuery, &dateQuery);
+    ASSERT_TRUE (mIndex.evaluate (andQuery, results));
+    ASSERT_EQ   (1U, results.size());
+    EXPECT_EQ   (2000U, results[0]->mTime);
+
+    // Either branch of a union may match outside the window.
+    MamdaOrQuery  orQuery (&symbolQuery, &dateQuery);
+    EXPECT_FALSE (mIndex.evaluate (orQuery, results));
+}
+
+TEST_F (MamdaNewsHeadlineIndexTest, ClearDropsCoverage)
+{
+    addHeadline ("IBM beats estimates", "IBM", 1000);
+    mIndex.clear();
+
+    EXPECT_EQ    (0U, mIndex.getCoverageStart());
+    EXPECT_FALSE (evaluateDates (1000, 2000));
+
+    // Coverage starts again from the next headline.
+    addHeadline ("IBM raises guidance", "IBM", 5000);
+    EXPECT_FALSE (evaluateDates (1000, 6000));
+    EXPECT_TRUE  (evaluateDates (5000, 6000));
+}
@@ -0,0 +1,173 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <mamda/MamdaOptionChain.h>
+#include <mamda/MamdaOptionChainSnapshot.h>
+#include <mamda/MamdaOptionContract.h>
+#include <mama/MamaDateTime.h>
+
+#include <vector>
+
+using namespace std;
+using namespace Wombat;
+
+class MamdaOptionChainSnapshotTest : public ::testing::Test
+{
+protected:
+    MamdaOptionChainSnapshotTest () : mChain ("TEST") {}
+    virtual ~MamdaOptionChainSnapshotTest () {}
+
+    virtual void SetUp()
+    {
+        mExpireDate.setDate (2013, 1, 19);
+
+        mCall10 = addContract ("TEST A10", 10.0, MAMDA_PUT_CALL_CALL);
+        mCall20 = addContract ("TEST A20", 20.0, MAMDA_PUT_CALL_CALL);
+        mPut10  = addContract ("TEST M10", 10.0, MAMDA_PUT_CALL_PUT);
+        mPut20  = addContract ("TEST M20", 20.0, MAMDA_PUT_CALL_PUT);
+    }
+
+    virtual void TearDown()
+    {
+        for (size_t i = 0; i < mContracts.size(); ++i)
+        {
+            delete mContracts[i];
+        }
+        mContracts.clear();
+    }
+
+    MamdaOptionContract* addContract (const char*         symbol,
+                                      double              strikePrice,
+                                      MamdaOptionPutCall  putCall)
+    {
+        MamdaOptionContract* contract = new MamdaOptionContract (
+            symbol, "A", mExpireDate, strikePrice, putCall);
+
+        mContracts.push_back (contract);
+        mChain.addContract (symbol, contract);
+        return contract;
+    }
+
+    MamaDateTime                    mExpireDate;
+    MamdaOptionChain                mChain;
+    vector<MamdaOptionContract*>    mContracts;
+    MamdaOptionContract*            mCall10;
+    MamdaOptionContract*            mCall20;
+    MamdaOptionContract*            mPut10;
+    MamdaOptionContract*            mPut20;
+};
+
+TEST_F (MamdaOptionChainSnapshotTest, EmptySnapshot)
+{
+    MamdaOptionChainSnapshot snapshot;
+
+    EXPECT_EQ (0U, snapshot.size());
+    EXPECT_EQ (0U, snapshot.getDirtyCount());
+    EXPECT_TRUE (snapshot.getStrikePrices() == NULL);
+    EXPECT_EQ (-1, snapshot.findRow (*mCall10));
+}
+
+TEST_F (MamdaOptionChainSnapshotTest, PopulateFromChain)
+{
+    MamdaOptionChainSnapshot snapshot;
+    snapshot.populate (mChain);
+
+    ASSERT_EQ (4U, snapshot.size());
+
+    const MamdaOptionContract* const* contracts = snapshot.getContracts();
+    const double*  strikes  = snapshot.getStrikePrices();
+    const char*    putCalls = snapshot.getPutCalls();
+    const double*  expires  = snapshot.getExpireTimes();
+
+    for (size_t i = 0; i < mContracts.size(); ++i)
+    {
+        long row = snapshot.findRow (*mContracts[i]);
+        ASSERT_GE (row, 0);
+
+        EXPECT_EQ (mContracts[i], contracts[row]);
+        EXPECT_EQ (mContracts[i]->getStrikePrice(), strikes[row]);
+        EXPECT_EQ ((char)mContracts[i]->getPutCall(), putCalls[row]);
+        EXPECT_EQ (mExpireDate.getEpochTimeSeconds(), expires[row]);
+    }
+}
+
+TEST_F (MamdaOptionChainSnapshotTest, RepopulateReplacesRows)
+{
+    MamdaOptionChainSnapshot snapshot;
+    snapshot.populate (mChain);
+    snapshot.markDirty (*mCall10);
+
+    snapshot.populate (mChain);
+
+    EXPECT_EQ (4U, snapshot.size());
+    EXPECT_EQ (0U, snapshot.getDirtyCount());
+}
+
+TEST_F (MamdaOptionChainSnapshotTest, MarkDirtyCountsEachRowOnce)
+{
+    MamdaOptionChainSnapshot snapshot;
+    snapshot.populate (mChain);
+
+    snapshot.markDirty (*mCall10);
+    snapshot.markDirty (*mCall10);
+    snapshot.markDirty (*mPut20);
+
+    EXPECT_EQ (2U, snapshot.getDirtyCount());
+}
+
+TEST_F (MamdaOptionChainSnapshotTest, MarkDirtyIgnoresUnknownContract)
+{
+    MamdaOptionChainSnapshot snapshot;
+    snapshot.populate (mChain);
+
+    MamdaOptionContract other ("OTHER A10", "A", mExpireDate, 10.0,
+                               MAMDA_PUT_CALL_CALL);
+    snapshot.markDirty (other);
+
+    EXPECT_EQ (0U, snapshot.getDirtyCount());
+    EXPECT_EQ (-1, snapshot.findRow (other));
+}
+
+TEST_F (MamdaOptionChainSnapshotTest, RefreshRereadsOnlyDirtyRows)
+{
+    MamdaOptionChainSnapshot snapshot;
+    snapshot.populate (mChain);
+
+    long callRow = snapshot.findRow (*mCall10);
+    long putRow  = snapshot.findRow (*mPut10);
+
+    mCall10->setStrikePrice (11.0);
+    mPut10->setStrikePrice  (12.0);
+
+    snapshot.markDirty (*mCall10);
+
+    EXPECT_EQ (1U, snapshot.refresh());
+    EXPECT_EQ (0U, snapshot.getDirtyCount());
+    EXPECT_EQ (11.0, snapshot.getStrikePrices()[callRow]);
+
+    // The put was not marked dirty, so its row still holds the old value.
+    EXPECT_EQ (10.0, snapshot.getStrikePrices()[putRow]);
+
+    EXPECT_EQ (0U, snapshot.refresh());
+}
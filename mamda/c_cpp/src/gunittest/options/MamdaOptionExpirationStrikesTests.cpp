@@ -0,0 +1,173 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <mamda/MamdaOptionExpirationStrikes.h>
+#include <mamda/MamdaOptionStrikeSet.h>
+#include <mama/MamaDateTime.h>
+
+#include <vector>
+
+using namespace std;
+using namespace Wombat;
+
+class MamdaOptionExpirationStrikesTest : public ::testing::Test
+{
+protected:
+    MamdaOptionExpirationStrikesTest () {}
+    virtual ~MamdaOptionExpirationStrikesTest () {}
+
+    virtual void SetUp()
+    {
+        mExpireDate.setDate (2013, 1, 19);
+    }
+
+    virtual void TearDown()
+    {
+        for (size_t i = 0; i < mStrikeSets.size(); ++i)
+        {
+            delete mStrikeSets[i];
+        }
+        mStrikeSets.clear();
+    }
+
+    MamdaOptionStrikeSet* newStrikeSet (double strikePrice)
+    {
+        MamdaOptionStrikeSet* strikeSet =
+            new MamdaOptionStrikeSet (mExpireDate, strikePrice);
+        mStrikeSets.push_back (strikeSet);
+        return strikeSet;
+    }
+
+    void add (double strikePrice)
+    {
+        mStrikes.addStrikeSet (strikePrice, newStrikeSet (strikePrice));
+    }
+
+    /* The index must hold exactly the keys of the map, in order. */
+    void expectIndexInSync (const MamdaOptionExpirationStrikes& strikes)
+    {
+        const StrikeIndex& index = strikes.getStrikeIndex();
+        ASSERT_EQ (strikes.size(), index.size());
+
+        size_t i = 0;
+        MamdaOptionExpirationStrikes::const_iterator iter = strikes.begin();
+        for (; iter != strikes.end(); ++iter, ++i)
+        {
+            EXPECT_EQ (iter->first, index[i]);
+        }
+    }
+
+    MamaDateTime                    mExpireDate;
+    MamdaOptionExpirationStrikes    mStrikes;
+    vector<MamdaOptionStrikeSet*>   mStrikeSets;
+};
+
+TEST_F (MamdaOptionExpirationStrikesTest, AddKeepsIndexSorted)
+{
+    add (30.0);
+    add (10.0);
+    add (20.0);
+    add (25.0);
+
+    expectIndexInSync (mStrikes);
+    EXPECT_EQ (10.0, mStrikes.getStrikeIndex().front());
+    EXPECT_EQ (30.0, mStrikes.getStrikeIndex().back());
+}
+
+TEST_F (MamdaOptionExpirationStrikesTest, DuplicateAddIsIgnored)
+{
+    MamdaOptionStrikeSet* first = newStrikeSet (10.0);
+    mStrikes.addStrikeSet (10.0, first);
+    mStrikes.addStrikeSet (10.0, newStrikeSet (10.0));
+
+    EXPECT_EQ (1U, mStrikes.size());
+    EXPECT_EQ (first, mStrikes.find (10.0)->second);
+    expectIndexInSync (mStrikes);
+}
+
+TEST_F (MamdaOptionExpirationStrikesTest, RemoveKeepsIndexInSync)
+{
+    add (10.0);
+    add (20.0);
+    add (30.0);
+
+    mStrikes.removeStrikeSet (20.0);
+    expectIndexInSync (mStrikes);
+    EXPECT_TRUE (mStrikes.find (20.0) == mStrikes.end());
+
+    // Removing an absent strike must leave both untouched.
+    mStrikes.removeStrikeSet (15.0);
+    EXPECT_EQ (2U, mStrikes.size());
+    expectIndexInSync (mStrikes);
+}
+
+TEST_F (MamdaOptionExpirationStrikesTest, TrimToRange)
+{
+    for (int i = 1; i <= 10; ++i)
+    {
+        add (i * 5.0);
+    }
+
+    mStrikes.trimStrikes (12.5, 35.0);
+
+    expectIndexInSync (mStrikes);
+    ASSERT_EQ (5U, mStrikes.size());
+    EXPECT_EQ (15.0, mStrikes.getStrikeIndex().front());
+    EXPECT_EQ (35.0, mStrikes.getStrikeIndex().back());
+}
+
+TEST_F (MamdaOptionExpirationStrikesTest, TrimToStrikeSet)
+{
+    add (10.0);
+    add (20.0);
+    add (30.0);
+    add (40.0);
+
+    StrikeSet keep;
+    keep.insert (20.0);
+    keep.insert (30.0);
+    mStrikes.trimStrikes (keep);
+
+    expectIndexInSync (mStrikes);
+    EXPECT_EQ (2U, mStrikes.size());
+
+    mStrikes.trimStrikes (StrikeSet());
+    EXPECT_TRUE (mStrikes.empty());
+    EXPECT_TRUE (mStrikes.getStrikeIndex().empty());
+}
+
+TEST_F (MamdaOptionExpirationStrikesTest, CopyCopiesIndex)
+{
+    add (10.0);
+    add (20.0);
+
+    MamdaOptionExpirationStrikes copy (mStrikes);
+    expectIndexInSync (copy);
+
+    // The copy is independent of the original.
+    mStrikes.removeStrikeSet (10.0);
+    EXPECT_EQ (2U, copy.size());
+    expectIndexInSync (copy);
+    expectIndexInSync (mStrikes);
+}
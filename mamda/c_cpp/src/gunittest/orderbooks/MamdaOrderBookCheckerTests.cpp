@@ -0,0 +1,294 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+#include <gtest/gtest.h>
+#include <mama/mamacpp.h>
+#include <mamda/MamdaSubscription.h>
+#include <mamda/MamdaOrderBook.h>
+#include <mamda/MamdaOrderBookClear.h>
+#include <mamda/MamdaOrderBookChecker.h>
+#include <mamda/MamdaOrderBookCheckerHandler.h>
+#include <mamda/MamdaOrderBookCheckerPool.h>
+#include <mamda/MamdaOrderBookHandler.h>
+#include <mamda/MamdaOrderBookListener.h>
+#include <wombat/port.h>
+
+using namespace Wombat;
+
+/*
+ * Captures the real-time handler which the checker registers, so that
+ * book events can be delivered to the checker without a live
+ * subscription.
+ */
+class CapturingBookListener : public MamdaOrderBookListener
+{
+public:
+    CapturingBookListener (MamdaOrderBook*  book)
+        : MamdaOrderBookListener (book)
+        , mHandler (NULL) {}
+
+    virtual void addHandler (MamdaOrderBookHandler*  handler)
+    {
+        mHandler = handler;
+        MamdaOrderBookListener::addHandler (handler);
+    }
+
+    MamdaOrderBookHandler*  mHandler;
+};
+
+class TestBookClear : public MamdaOrderBookClear
+{
+public:
+    TestBookClear (const MamdaOrderBook&  book) : mBook (book) {}
+
+    const MamdaOrderBook*  getOrderBook () const { return &mBook; }
+
+    const char*  getSymbol () const { return "TEST"; }
+    const char*  getPartId () const { return ""; }
+    mama_seqnum_t  getEventSeqNum () const { return 0; }
+    const MamaDateTime&  getEventTime () const { return mTime; }
+    const MamaDateTime&  getSrcTime () const { return mTime; }
+    const MamaDateTime&  getActivityTime () const { return mTime; }
+    const MamaDateTime&  getLineTime () const { return mTime; }
+    const MamaDateTime&  getSendTime () const { return mTime; }
+    const MamaMsgQual&  getMsgQual () const { return mMsgQual; }
+
+    MamdaFieldState  getSymbolFieldState () const { return NOT_INITIALISED; }
+    MamdaFieldState  getPartIdFieldState () const { return NOT_INITIALISED; }
+    MamdaFieldState  getEventSeqNumFieldState () const { return NOT_INITIALISED; }
+    MamdaFieldState  getEventTimeFieldState () const { return NOT_INITIALISED; }
+    MamdaFieldState  getSrcTimeFieldState () const { return NOT_INITIALISED; }
+    MamdaFieldState  getActivityTimeFieldState () const { return NOT_INITIALISED; }
+    MamdaFieldState  getLineTimeFieldState () const { return NOT_INITIALISED; }
+    MamdaFieldState  getSendTimeFieldState () const { return NOT_INITIALISED; }
+    MamdaFieldState  getMsgQualFieldState () const { return NOT_INITIALISED; }
+
+private:
+    const MamdaOrderBook&  mBook;
+    MamaDateTime           mTime;
+    MamaMsgQual            mMsgQual;
+};
+
+/*
+ * Counts results, which may arrive on checker pool threads.  If
+ * blockFirst is set the first result blocks until release() is called,
+ * holding up the pool's worker.
+ */
+class CountingCheckerHandler : public MamdaOrderBookCheckerHandler
+{
+public:
+    CountingCheckerHandler (bool  blockFirst = false)
+        : mSuccesses   (0)
+        , mFailures    (0)
+        , mBlockFirst  (blockFirst)
+    {
+        wthread_mutex_init (&mLock, NULL);
+        wsem_init (&mEntered, 0, 0);
+        wsem_init (&mRelease, 0, 0);
+        wsem_init (&mResults, 0, 0);
+    }
+
+    virtual ~CountingCheckerHandler ()
+    {
+        wsem_destroy (&mResults);
+        wsem_destroy (&mRelease);
+        wsem_destroy (&mEntered);
+        wthread_mutex_destroy (&mLock);
+    }
+
+    void onSuccess (MamdaOrderBookCheckType  checkType)
+    {
+        wthread_mutex_lock (&mLock);
+        mSuccesses++;
+        bool block  = mBlockFirst;
+        mBlockFirst = false;
+        wthread_mutex_unlock (&mLock);
+
+        if (block)
+        {
+            wsem_post (&mEntered);
+            wsem_wait (&mRelease);
+        }
+        wsem_post (&mResults);
+    }
+
+    void onInconclusive (MamdaOrderBookCheckType  checkType,
+                         const char*              reason)
+    {
+    }
+
+    void onFailure (MamdaOrderBookCheckType  checkType,
+                    const char*              reason,
+                    const MamaMsg*           msg,
+                    const MamdaOrderBook&    realTimeBook,
+                    const MamdaOrderBook&    checkBook)
+    {
+        wthread_mutex_lock (&mLock);
+        mFailures++;
+        wthread_mutex_unlock (&mLock);
+        wsem_post (&mResults);
+    }
+
+    void waitUntilBlocked () { wsem_wait (&mEntered); }
+    void release ()          { wsem_post (&mRelease); }
+
+    void waitForResults (int  count)
+    {
+        for (int i = 0; i < count; ++i)
+            wsem_wait (&mResults);
+    }
+
+    int              mSuccesses;
+    int              mFailures;
+
+private:
+    bool             mBlockFirst;
+    wthread_mutex_t  mLock;
+    wsem_t           mEntered;
+    wsem_t           mRelease;
+    wsem_t           mResults;
+};
+
+class MamdaOrderBookCheckerTest : public ::testing::Test
+{
+protected:
+    MamdaOrderBookCheckerTest ()
+        : mListener (&mBook)
+        , mClear    (mBook) {}
+
+    virtual ~MamdaOrderBookCheckerTest () {}
+
+    MamdaOrderBookChecker* createChecker (CountingCheckerHandler*  handler)
+    {
+        // A zero interval means no snapshot timer is created.
+        MamdaOrderBookChecker* checker = new MamdaOrderBookChecker (
+            mBook, mSubscription, mListener, handler, 0.0);
+
+        EXPECT_TRUE (mListener.mHandler != NULL);
+        return checker;
+    }
+
+    /* Deliver a book clear, which resets the checker's delta book. */
+    void sendClears (int  count)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            mListener.mHandler->onBookClear (&mSubscription, mListener,
+                                             NULL, mClear, mBook);
+        }
+    }
+
+    MamdaOrderBook          mBook;
+    MamdaSubscription       mSubscription;
+    CapturingBookListener   mListener;
+    TestBookClear           mClear;
+};
+
+TEST_F (MamdaOrderBookCheckerTest, ChecksEveryUpdateByDefault)
+{
+    CountingCheckerHandler handler;
+    MamdaOrderBookChecker* checker = createChecker (&handler);
+
+    sendClears (5);
+
+    EXPECT_EQ (5U, checker->getSuccessCount());
+    EXPECT_EQ (0U, checker->getFailureCount());
+    EXPECT_EQ (5, handler.mSuccesses);
+
+    delete checker;
+}
+
+TEST_F (MamdaOrderBookCheckerTest, SampleRateChecksOneInN)
+{
+    CountingCheckerHandler handler;
+    MamdaOrderBookChecker* checker = createChecker (&handler);
+
+    checker->setSampleRate (4);
+    sendClears (10);
+
+    EXPECT_EQ (2U, checker->getSuccessCount());
+    EXPECT_EQ (0U, checker->getSkippedCount());
+
+    // A rate of zero is treated as checking every update.
+    checker->setSampleRate (0);
+    sendClears (3);
+    EXPECT_EQ (5U, checker->getSuccessCount());
+
+    delete checker;
+}
+
+TEST_F (MamdaOrderBookCheckerTest, DetectsMismatch)
+{
+    CountingCheckerHandler handler;
+    MamdaOrderBookChecker* checker = createChecker (&handler);
+
+    // The real-time book now differs from the cleared delta book.
+    mBook.findOrCreateLevel (100.0, MamdaOrderBookPriceLevel::MAMDA_BOOK_SIDE_BID);
+    sendClears (1);
+
+    EXPECT_EQ (0U, checker->getSuccessCount());
+    EXPECT_EQ (1U, checker->getFailureCount());
+    EXPECT_EQ (1, handler.mFailures);
+
+    delete checker;
+}
+
+TEST_F (MamdaOrderBookCheckerTest, ChecksOnPool)
+{
+    CountingCheckerHandler handler;
+    MamdaOrderBookCheckerPool pool (2);
+    MamdaOrderBookChecker* checker = createChecker (&handler);
+
+    checker->setCheckerPool (&pool);
+    sendClears (20);
+    handler.waitForResults (20);
+
+    EXPECT_EQ (20U, checker->getSuccessCount());
+    EXPECT_EQ (20, handler.mSuccesses);
+    delete checker;
+
+    EXPECT_EQ (0U, pool.getDroppedCount());
+}
+
+TEST_F (MamdaOrderBookCheckerTest, FullPoolSkipsChecks)
+{
+    CountingCheckerHandler handler (true);
+    MamdaOrderBookCheckerPool pool (1, 2);
+    MamdaOrderBookChecker* checker = createChecker (&handler);
+
+    checker->setCheckerPool (&pool);
+
+    // Hold the only worker in the first check.
+    sendClears (1);
+    handler.waitUntilBlocked();
+
+    // Two more fit in the queue, the rest are dropped.
+    sendClears (5);
+    EXPECT_EQ (2U, pool.getPendingCount());
+    EXPECT_EQ (3U, pool.getDroppedCount());
+    EXPECT_EQ (3U, checker->getSkippedCount());
+
+    handler.release();
+    handler.waitForResults (3);
+
+    EXPECT_EQ (3U, checker->getSuccessCount());
+    delete checker;
+}
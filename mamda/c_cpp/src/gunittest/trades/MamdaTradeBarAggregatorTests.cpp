@@ -0,0 +1,335 @@
+/* $Id$
+ *
+ * OpenMAMA: The open middleware agnostic messaging API
+ * Copyright (C) 2011 NYSE Technologies, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <mamda/MamdaTradeFields.h>
+#include <mamda/MamdaCommonFields.h>
+#include <mamda/MamdaSubscription.h>
+#include <mamda/MamdaTradeListener.h>
+#include <mamda/MamdaTradeBar.h>
+#include <mamda/MamdaTradeBarAggregator.h>
+#include <mamda/MamdaTradeBarHandler.h>
+#include <mama/MamaDictionary.h>
+#include <mama/mamacpp.h>
+#include <mama/MamaMsg.h>
+
+#include "common/MamdaUnitTestUtils.h"
+#include "common/CpuTestGenerator.h"
+
+#include <stdio.h>
+#include <vector>
+#include <iostream>
+
+using namespace std;
+using namespace Wombat;
+
+static const mama_u64_t ONE_SECOND = 1000000;
+
+class TestBarHandler : public MamdaTradeBarHandler
+{
+public:
+    TestBarHandler () : mCorrections (0) {}
+    virtual ~TestBarHandler () {}
+
+    void onTradeBarClose (
+        MamdaTradeBarAggregator&  aggregator,
+        mama_u32_t                symbolIndex,
+        const char*               symbol,
+        const MamdaTradeBar&      bar)
+    {
+        mClosed.push_back (bar);
+    }
+
+    void onTradeBarCorrection (
+        MamdaTradeBarAggregator&  aggregator,
+        mama_u32_t                symbolIndex,
+        const char*               symbol,
+        const MamdaTradeBar&      bar)
+    {
+        mCorrected = bar;
+        ++mCorrections;
+    }
+
+    vector<MamdaTradeBar>   mClosed;
+    MamdaTradeBar           mCorrected;
+    int                     mCorrections;
+};
+
+class MamdaTradeBarAggregatorTest : public ::testing::Test
+{
+protected:
+    MamdaTradeBarAggregatorTest ()
+        : mAggregator (60.0, 4, 8)
+    {}
+
+    virtual ~MamdaTradeBarAggregatorTest () {}
+
+    virtual void SetUp()
+    {
+        mAggregator.addHandler (&mHandler);
+        mIbm  = mAggregator.addSymbol ("IBM");
+        mOrcl = mAggregator.addSymbol ("ORCL");
+    }
+
+    virtual void TearDown() {}
+
+    MamdaTradeBarAggregator mAggregator;
+    TestBarHandler          mHandler;
+    mama_u32_t              mIbm;
+    mama_u32_t              mOrcl;
+};
+
+TEST_F (MamdaTradeBarAggregatorTest, BuildsBars)
+{
+    mAggregator.addTrade (mIbm, 0,              1, 10.0, 100);
+    mAggregator.addTrade (mIbm, 10 * ONE_SECOND, 2, 12.0, 100);
+    mAggregator.addTrade (mIbm, 20 * ONE_SECOND, 3,  9.0, 200);
+    mAggregator.addTrade (mIbm, 30 * ONE_SECOND, 4, 11.0, 100);
+
+    const MamdaTradeBar* bar = mAggregator.getBar (mIbm);
+    ASSERT_TRUE (bar != NULL);
+    EXPECT_EQ (0U, bar->mStartTime);
+    EXPECT_EQ (60 * ONE_SECOND, bar->mEndTime);
+    EXPECT_DOUBLE_EQ (10.0, bar->mOpen);
+    EXPECT_DOUBLE_EQ (12.0, bar->mHigh);
+    EXPECT_DOUBLE_EQ ( 9.0, bar->mLow);
+    EXPECT_DOUBLE_EQ (11.0, bar->mClose);
+    EXPECT_DOUBLE_EQ (500, bar->mVolume);
+    EXPECT_DOUBLE_EQ (10.2, bar->getVwap ());
+    EXPECT_EQ (4U, bar->mTradeCount);
+
+    // Securities are independent.
+    EXPECT_TRUE (mAggregator.getBar (mOrcl) == NULL);
+    EXPECT_EQ (0U, mHandler.mClosed.size ());
+}
+
+TEST_F (MamdaTradeBarAggregatorTest, RollsOverBars)
+{
+    mAggregator.addTrade (mIbm, 5 * ONE_SECOND,   1, 10.0, 100);
+    mAggregator.addTrade (mIbm, 65 * ONE_SECOND,  2, 11.0, 100);
+
+    ASSERT_EQ (1U, mHandler.mClosed.size ());
+    EXPECT_DOUBLE_EQ (10.0, mHandler.mClosed[0].mClose);
+    EXPECT_EQ (60 * ONE_SECOND, mAggregator.getBar (mIbm)->mStartTime);
+    EXPECT_EQ (0U, mAggregator.getBar (mIbm, 1)->mStartTime);
+
+    // Quiet securities are closed explicitly.
+    mAggregator.closeBars (119 * ONE_SECOND);
+    EXPECT_EQ (1U, mHandler.mClosed.size ());
+    mAggregator.closeBars (120 * ONE_SECOND);
+    ASSERT_EQ (2U, mHandler.mClosed.size ());
+    EXPECT_DOUBLE_EQ (11.0, mHandler.mClosed[1].mClose);
+
+    // Only numBars bars are retained.
+    for (mama_u32_t i = 2; i < 10; ++i)
+        mAggregator.addTrade (mIbm, i * 60 * ONE_SECOND, i + 1, 10.0, 100);
+    EXPECT_TRUE (mAggregator.getBar (mIbm, 3) != NULL);
+    EXPECT_TRUE (mAggregator.getBar (mIbm, 4) == NULL);
+}
+
+TEST_F (MamdaTradeBarAggregatorTest, CancelRebuildsBar)
+{
+    mAggregator.addTrade (mIbm, 0,               1, 10.0, 100);
+    mAggregator.addTrade (mIbm, 10 * ONE_SECOND, 2, 12.0, 100);
+    mAggregator.addTrade (mIbm, 20 * ONE_SECOND, 3, 11.0, 100);
+
+    EXPECT_TRUE (mAggregator.cancelTrade (mIbm, 2));
+    const MamdaTradeBar* bar = mAggregator.getBar (mIbm);
+    EXPECT_DOUBLE_EQ (11.0, bar->mHigh);
+    EXPECT_DOUBLE_EQ (200, bar->mVolume);
+    EXPECT_EQ (2U, bar->mTradeCount);
+
+    // The open bar is not reported as corrected.
+    EXPECT_EQ (0, mHandler.mCorrections);
+
+    // Cancelling again does not match.
+    EXPECT_FALSE (mAggregator.cancelTrade (mIbm, 2));
+    EXPECT_EQ (1U, mAggregator.getUnmatchedCount ());
+}
+
+TEST_F (MamdaTradeBarAggregatorTest, CorrectionPatchesClosedBar)
+{
+    mAggregator.addTrade (mIbm, 0,               1, 10.0, 100);
+    mAggregator.addTrade (mIbm, 10 * ONE_SECOND, 2, 12.0, 100);
+    mAggregator.addTrade (mIbm, 70 * ONE_SECOND, 3, 11.0, 100);
+
+    EXPECT_TRUE (mAggregator.correctTrade (mIbm, 2, 9.0, 300));
+    ASSERT_EQ (1, mHandler.mCorrections);
+    EXPECT_EQ (0U, mHandler.mCorrected.mStartTime);
+    EXPECT_DOUBLE_EQ (10.0, mHandler.mCorrected.mHigh);
+    EXPECT_DOUBLE_EQ ( 9.0, mHandler.mCorrected.mLow);
+    EXPECT_DOUBLE_EQ ( 9.0, mHandler.mCorrected.mClose);
+    EXPECT_DOUBLE_EQ (400, mHandler.mCorrected.mVolume);
+
+    // Late trades patch their earlier bar too.
+    mAggregator.addTrade (mIbm, 30 * ONE_SECOND, 4, 13.0, 100);
+    EXPECT_EQ (2, mHandler.mCorrections);
+    EXPECT_DOUBLE_EQ (13.0, mHandler.mCorrected.mHigh);
+    EXPECT_EQ (3U, mHandler.mCorrected.mTradeCount);
+}
+
+TEST_F (MamdaTradeBarAggregatorTest, OutOfOrderTradesKeepOpenAndClose)
+{
+    mAggregator.addTrade (mIbm, 20 * ONE_SECOND, 1, 10.0, 100);
+    mAggregator.addTrade (mIbm, 40 * ONE_SECOND, 2, 11.0, 100);
+
+    // Arrives last, but traded between the two.
+    mAggregator.addTrade (mIbm, 30 * ONE_SECOND, 3, 12.0, 100);
+
+    const MamdaTradeBar* bar = mAggregator.getBar (mIbm);
+    EXPECT_DOUBLE_EQ (11.0, bar->mClose);
+    EXPECT_EQ (40 * ONE_SECOND, bar->mCloseTime);
+    EXPECT_DOUBLE_EQ (12.0, bar->mHigh);
+
+    // Traded before the first trade received: becomes the open.
+    mAggregator.addTrade (mIbm, 5 * ONE_SECOND, 4, 9.0, 100);
+    EXPECT_DOUBLE_EQ (9.0, bar->mOpen);
+    EXPECT_EQ (5 * ONE_SECOND, bar->mOpenTime);
+    EXPECT_DOUBLE_EQ (11.0, bar->mClose);
+
+    // Same rules when the bar is rebuilt.
+    EXPECT_TRUE (mAggregator.cancelTrade (mIbm, 2));
+    EXPECT_DOUBLE_EQ (9.0, bar->mOpen);
+    EXPECT_DOUBLE_EQ (12.0, bar->mClose);
+    EXPECT_EQ (30 * ONE_SECOND, bar->mCloseTime);
+
+    // A late trade into a closed bar does not move its close either.
+    mAggregator.addTrade (mIbm, 70 * ONE_SECOND, 5, 13.0, 100);
+    mAggregator.addTrade (mIbm, 25 * ONE_SECOND, 6, 14.0, 100);
+    ASSERT_EQ (1, mHandler.mCorrections);
+    EXPECT_DOUBLE_EQ (12.0, mHandler.mCorrected.mClose);
+    EXPECT_DOUBLE_EQ (14.0, mHandler.mCorrected.mHigh);
+}
+
+TEST_F (MamdaTradeBarAggregatorTest, EvictedTradesAreUnmatched)
+{
+    // Eight trades are retained per security.
+    for (mama_u32_t i = 0; i < 10; ++i)
+        mAggregator.addTrade (mIbm, i * ONE_SECOND, i, 10.0 + i, 100);
+
+    EXPECT_FALSE (mAggregator.cancelTrade (mIbm, 0));
+    EXPECT_EQ (1U, mAggregator.getUnmatchedCount ());
+
+    // The bar is then patched rather than rebuilt: totals stay exact.
+    EXPECT_TRUE (mAggregator.cancelTrade (mIbm, 9));
+    const MamdaTradeBar* bar = mAggregator.getBar (mIbm);
+    EXPECT_DOUBLE_EQ (900, bar->mVolume);
+    EXPECT_EQ (9U, bar->mTradeCount);
+    EXPECT_DOUBLE_EQ (10.0, bar->mOpen);
+
+    // Trades older than any retained bar are counted as late.
+    for (mama_u32_t i = 1; i < 6; ++i)
+        mAggregator.addTrade (mOrcl, i * 60 * ONE_SECOND, i, 20.0, 100);
+    mAggregator.addTrade (mOrcl, 0, 100, 20.0, 100);
+    EXPECT_EQ (1U, mAggregator.getLateTradeCount ());
+}
+
+
+class MamdaTradeBarAggregatorPerfTest : public ::testing::Test
+{
+protected:
+    MamdaTradeBarAggregatorPerfTest () {}
+    virtual ~MamdaTradeBarAggregatorPerfTest () {}
+
+    virtual void SetUp()
+    {
+        try
+        {
+            mamaBridge bridge;
+            bridge = Mama::loadBridge("wmw");
+            Mama::open();
+
+            mDictionary = new MamaDictionary;
+            mDictionary->populateFromFile("dictionary.txt");
+            MamdaCommonFields::reset();
+            MamdaCommonFields::setDictionary (*mDictionary);
+            MamdaTradeFields::reset();
+            MamdaTradeFields::setDictionary (*mDictionary);
+        }
+        catch (MamaStatus status)
+        {
+            FAIL() << "Failed to setup Mamda: "
+                   << status.toString() << endl;
+            return;
+        }
+    }
+
+    virtual void TearDown()
+    {
+        if (mDictionary)
+        {
+            delete mDictionary;
+            mDictionary = NULL;
+        }
+    }
+
+    MamaDictionary*         mDictionary;
+};
+
+/*
+ * Drives a synthetic tape of trade reports for many securities through
+ * their MamdaTradeListeners into one shared aggregator.
+ */
+TEST_F(MamdaTradeBarAggregatorPerfTest, AggregateTradeReports)
+{
+    const int ITERATIONS  = 100000;
+    const int NUM_SYMBOLS = 100;
+
+    MamdaTradeBarAggregator aggregator (60.0);
+
+    vector<MamdaSubscription*>  subscriptions;
+    vector<MamdaTradeListener*> listeners;
+    for (int i = 0; i < NUM_SYMBOLS; ++i)
+    {
+        MamdaSubscription*  subscription = new MamdaSubscription;
+        MamdaTradeListener* listener     = new MamdaTradeListener;
+        listener->addHandler (&aggregator);
+        subscription->addMsgListener (listener);
+        subscriptions.push_back (subscription);
+        listeners.push_back (listener);
+    }
+
+    MamaDateTime date;
+    date.setToNow();
+
+    MamaMsg msg;
+    msg.create();
+    SetTradeReportFields (msg, date);
+
+    int seqNum = 0;
+    START_RECORDING_CPU(ITERATIONS);
+        int symbol = seqNum % NUM_SYMBOLS;
+        msg.updateI32 ("wTradeSeqNum", 483, seqNum / NUM_SYMBOLS + 1);
+        msg.updateF64 ("wTradePrice",  481, 144.0 + (seqNum % 7) * 0.01);
+        listeners[symbol]->onMsg (subscriptions[symbol], msg, MAMA_MSG_TYPE_TRADE);
+        seqNum++;
+    STOP_RECORDING_CPU ();
+
+    EXPECT_EQ ((mama_u32_t) NUM_SYMBOLS, aggregator.getSymbolCount ());
+
+    for (int i = 0; i < NUM_SYMBOLS; ++i)
+    {
+        delete listeners[i];
+        delete subscriptions[i];
+    }
+}
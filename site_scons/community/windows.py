@@ -45,6 +45,12 @@ class Windows:
                       'Libevent home must be specified'
                 Exit(1)
 
+        if 'loopback' in optsEnv['middleware']:
+            if not optsEnv.has_key('libevent_home'):
+                print 'ERROR: In order to build the loopback bridge, '\
+                      'Libevent home must be specified'
+                Exit(1)
+
         if optsEnv['with_unittest'] == True:
             if not optsEnv.has_key('gtest_home'):
                 print 'ERROR: GTest Home must be specified'